@@ -39,6 +39,10 @@ LutAddresser::LutAddresser()
     m_blockBits(0),
     m_blockSize(),
     m_bpeLog2(0),
+    m_microTileWidth(0),
+    m_microTileHeight(0),
+    m_microChunkCount(0),
+    m_microChunks(),
     m_bit(),
     m_lutData()
 {
@@ -65,6 +69,7 @@ void LutAddresser::Init(
 
     InitSwizzleProps();
     InitLuts();
+    InitMicroTile();
 }
 
 /**
@@ -187,6 +192,77 @@ void LutAddresser::InitLuts()
     }
 }
 
+/**
+****************************************************************************************************
+*   LutAddresser::InitMicroTile
+*
+*   @brief
+*       Precomputes the layout of a 256B micro-tile so aligned regions can be copied a whole
+*       micro-tile at a time.
+****************************************************************************************************
+*/
+void LutAddresser::InitMicroTile()
+{
+    UINT_32 xBits = 0;
+    UINT_32 yBits = 0;
+
+    m_microTileWidth  = 0;
+    m_microTileHeight = 0;
+    m_microChunkCount = 0;
+
+    if ((m_sLutMask != 0) || (m_blockBits < MicroTileBytesLog2))
+    {
+        return;
+    }
+
+    // Every address bit within the micro-tile must come from exactly one x or y bit.
+    for (UINT_32 i = m_bpeLog2; i < MicroTileBytesLog2; i++)
+    {
+        const auto& curBit = m_bit[i];
+        if ((curBit.value == 0) || (curBit.z != 0) || (curBit.s != 0))
+        {
+            return;
+        }
+        if ((curBit.y == 0) && IsPow2(static_cast<UINT_32>(curBit.x)))
+        {
+            xBits |= curBit.x;
+        }
+        else if ((curBit.x == 0) && IsPow2(static_cast<UINT_32>(curBit.y)))
+        {
+            yBits |= curBit.y;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    // ...and those must be the low x and y bits.
+    if ((IsPow2(xBits + 1) == false) || (IsPow2(yBits + 1) == false))
+    {
+        return;
+    }
+
+    const UINT_32 chunkWidth = Min(m_maxExpandX, 4u);
+    m_microTileWidth  = xBits + 1;
+    m_microTileHeight = yBits + 1;
+    ADDR_ASSERT((m_microTileWidth % chunkWidth) == 0);
+
+    // The equation is linear in each channel, so the XOR offset of a pixel within an aligned micro-tile is the
+    // same for every micro-tile. Higher address bits fed by low x/y bits are handled the same way.
+    for (UINT_32 y = 0; y < m_microTileHeight; y++)
+    {
+        for (UINT_32 x = 0; x < m_microTileWidth; x += chunkWidth)
+        {
+            LutMicroChunk* pChunk = &m_microChunks[m_microChunkCount++];
+            pChunk->offsetXor = GetAddressX(x) ^ GetAddressY(y);
+            pChunk->x         = static_cast<UINT_8>(x);
+            pChunk->y         = static_cast<UINT_8>(y);
+        }
+    }
+    ADDR_ASSERT(m_microChunkCount <= MaxMicroChunks);
+}
+
 /**
 ****************************************************************************************************
 *   LutAddresser::EvalEquation
@@ -269,14 +345,14 @@ UINT_32 LutAddresser::EvalEquation(
 
 /**
 ****************************************************************************************************
-*   Copy2DSliceUnaligned
+*   CopyRowsUnaligned
 *
 *   @brief
-*       Copies an arbitrary 2D pixel region to or from a surface.
+*       Copies an arbitrary 2D pixel region to or from a surface, one row at a time.
 ****************************************************************************************************
 */
 template <int BPELog2, int ExpandX, bool ImgIsDest>
-void Copy2DSliceUnaligned(
+void CopyRowsUnaligned(
     void*               pImgBlockSliceStart, // Block corresponding to beginning of slice
     void*               pBuf,                // Pointer to data starting from the copy origin.
     size_t              bufStrideY,          // Stride of each row in pBuf
@@ -360,6 +436,127 @@ void Copy2DSliceUnaligned(
     }
 }
 
+/**
+****************************************************************************************************
+*   CopyMicroTiles
+*
+*   @brief
+*       Copies a region made of whole micro-tiles to or from a surface. Each micro-tile needs a single
+*       LUT lookup, and the runs within it are fixed-size copies that compile down to vector moves.
+****************************************************************************************************
+*/
+template <int BPELog2, int ExpandX, bool ImgIsDest>
+void CopyMicroTiles(
+    void*               pImgBlockSliceStart, // Block corresponding to beginning of slice
+    void*               pBuf,                // Pointer to data starting from the copy origin.
+    size_t              bufStrideY,          // Stride of each row in pBuf
+    UINT_32             imageBlocksY,        // Width of the image slice, in blocks.
+    ADDR_COORD2D        origin,              // Absolute origin, in elements, micro-tile aligned
+    ADDR_EXTENT2D       extent,              // Size to copy, in elements, micro-tile aligned
+    UINT_32             sliceXor,            // Includes pipeBankXor and z XOR
+    const LutAddresser& addresser)
+{
+    constexpr UINT_32  PixBytes   = (1 << BPELog2);
+    constexpr UINT_32  ChunkBytes = PixBytes * ExpandX;
+
+    const UINT_32        microW     = addresser.GetMicroTileWidth();
+    const UINT_32        microH     = addresser.GetMicroTileHeight();
+    const UINT_32        chunkCount = addresser.GetMicroChunkCount();
+    const LutMicroChunk* pChunks    = addresser.GetMicroChunks();
+    ADDR_ASSERT((chunkCount * ChunkBytes) == (1u << LutAddresser::MicroTileBytesLog2));
+
+    for (UINT_32 y = origin.y; y < (origin.y + extent.height); y += microH)
+    {
+        UINT_32 yBlk = (y >> addresser.GetBlockYBits()) * imageBlocksY;
+        UINT_32 rowXor = sliceXor ^ addresser.GetAddressY(y);
+        void*   pBufRow = VoidPtrInc(pBuf, (y - origin.y) * bufStrideY);
+
+        for (UINT_32 x = origin.x; x < (origin.x + extent.width); x += microW)
+        {
+            UINT_32 blk = (yBlk + (x >> addresser.GetBlockXBits()));
+            void* pImgBlock = VoidPtrInc(pImgBlockSliceStart, blk << addresser.GetBlockBits());
+            UINT_32 tileXor = rowXor ^ addresser.GetAddressX(x);
+            void* pBufTile = VoidPtrInc(pBufRow, (x - origin.x) * PixBytes);
+
+            for (UINT_32 c = 0; c < chunkCount; c++)
+            {
+                void* pPix = VoidPtrInc(pImgBlock, tileXor ^ pChunks[c].offsetXor);
+                void* pMem = VoidPtrInc(pBufTile, (pChunks[c].y * bufStrideY) + (pChunks[c].x * PixBytes));
+                if (ImgIsDest)
+                {
+                    memcpy(pPix, pMem, ChunkBytes);
+                }
+                else
+                {
+                    memcpy(pMem, pPix, ChunkBytes);
+                }
+            }
+        }
+    }
+}
+
+/**
+****************************************************************************************************
+*   Copy2DSliceUnaligned
+*
+*   @brief
+*       Copies an arbitrary 2D pixel region to or from a surface. The part of the region covering whole
+*       micro-tiles is copied tile by tile, the edges row by row.
+****************************************************************************************************
+*/
+template <int BPELog2, int ExpandX, bool ImgIsDest>
+void Copy2DSliceUnaligned(
+    void*               pImgBlockSliceStart, // Block corresponding to beginning of slice
+    void*               pBuf,                // Pointer to data starting from the copy origin.
+    size_t              bufStrideY,          // Stride of each row in pBuf
+    UINT_32             imageBlocksY,        // Width of the image slice, in blocks.
+    ADDR_COORD2D        origin,              // Absolute origin, in elements
+    ADDR_EXTENT2D       extent,              // Size to copy, in elements
+    UINT_32             sliceXor,            // Includes pipeBankXor and z XOR
+    const LutAddresser& addresser)
+{
+    constexpr UINT_32  PixBytes = (1 << BPELog2);
+
+    const UINT_32 microW = addresser.GetMicroTileWidth();
+    const UINT_32 microH = addresser.GetMicroTileHeight();
+
+    const UINT_32 xEnd = origin.x + extent.width;
+    const UINT_32 yEnd = origin.y + extent.height;
+    const UINT_32 xTileStart = (microW != 0) ? PowTwoAlign(origin.x, microW) : 0;
+    const UINT_32 xTileEnd   = (microW != 0) ? PowTwoAlignDown(xEnd, microW) : 0;
+    const UINT_32 yTileStart = (microH != 0) ? PowTwoAlign(origin.y, microH) : 0;
+    const UINT_32 yTileEnd   = (microH != 0) ? PowTwoAlignDown(yEnd, microH) : 0;
+
+    if ((xTileStart >= xTileEnd) || (yTileStart >= yTileEnd))
+    {
+        CopyRowsUnaligned<BPELog2, ExpandX, ImgIsDest>(pImgBlockSliceStart, pBuf, bufStrideY, imageBlocksY,
+                                                       origin, extent, sliceXor, addresser);
+        return;
+    }
+
+    // Copies the sub-rectangle [x0, x1) x [y0, y1) with the given function.
+    auto copyRect = [&](UnalignedCopyMemImgFunc pfnCopy, UINT_32 x0, UINT_32 x1, UINT_32 y0, UINT_32 y1)
+    {
+        if ((x0 < x1) && (y0 < y1))
+        {
+            void* pSubBuf = VoidPtrInc(pBuf, ((y0 - origin.y) * bufStrideY) + ((x0 - origin.x) * PixBytes));
+            ADDR_COORD2D  subOrigin = { x0, y0 };
+            ADDR_EXTENT2D subExtent = { x1 - x0, y1 - y0 };
+            pfnCopy(pImgBlockSliceStart, pSubBuf, bufStrideY, imageBlocksY, subOrigin, subExtent, sliceXor,
+                    addresser);
+        }
+    };
+
+    const UnalignedCopyMemImgFunc pfnRows  = CopyRowsUnaligned<BPELog2, ExpandX, ImgIsDest>;
+    const UnalignedCopyMemImgFunc pfnTiles = CopyMicroTiles<BPELog2, ExpandX, ImgIsDest>;
+
+    copyRect(pfnRows,  origin.x,   xEnd,       origin.y,   yTileStart);
+    copyRect(pfnRows,  origin.x,   xTileStart, yTileStart, yTileEnd);
+    copyRect(pfnTiles, xTileStart, xTileEnd,   yTileStart, yTileEnd);
+    copyRect(pfnRows,  xTileEnd,   xEnd,       yTileStart, yTileEnd);
+    copyRect(pfnRows,  origin.x,   xEnd,       yTileEnd,   yEnd);
+}
+
 /**
 ****************************************************************************************************
 *   LutAddresser::GetCopyMemImgFunc
@@ -32,6 +32,15 @@ typedef void (*UnalignedCopyMemImgFunc)(
     UINT_32             sliceXor,             // Includes pipeBankXor and z XOR
     const LutAddresser& addresser);
 
+// One run of ExpandX pixels within a 256B micro-tile: its XOR offset from the start of the tile and its position
+// within the tile.
+struct LutMicroChunk
+{
+    UINT_32 offsetXor;
+    UINT_8  x;
+    UINT_8  y;
+};
+
 // This class calculates and holds up to four lookup tables (x/y/z/s) which can be used to cheaply calculate the
 // position of a pixel within a block at the cost of some precomputation and memory usage.
 //
@@ -41,6 +50,8 @@ class LutAddresser
 {
 public:
     constexpr static UINT_32 MaxLutSize = 2100; // Sized to fit the largest non-VAR LUT size
+    constexpr static UINT_32 MicroTileBytesLog2 = 8;
+    constexpr static UINT_32 MaxMicroChunks = 1 << MicroTileBytesLog2;
 
     LutAddresser();
 
@@ -70,6 +81,13 @@ public:
     UINT_32  GetAddressZ(UINT_32  z) const { return m_pZLut[z & m_zLutMask];}
     UINT_32  GetAddressS(UINT_32  s) const { return m_pSLut[s & m_sLutMask];}
 
+    // Size of the 256B micro-tile in elements, or 0 if the low address bits are not made of x and y bits only.
+    UINT_32  GetMicroTileWidth() const { return m_microTileWidth; }
+    UINT_32  GetMicroTileHeight() const { return m_microTileHeight; }
+    // Runs of pixels making up a micro-tile, in memory order of the linear side.
+    UINT_32  GetMicroChunkCount() const { return m_microChunkCount; }
+    const LutMicroChunk* GetMicroChunks() const { return m_microChunks; }
+
     // Get a function that can copy a single 2D slice of an image with this swizzle.
     UnalignedCopyMemImgFunc GetCopyMemImgFunc() const;
     UnalignedCopyMemImgFunc GetCopyImgMemFunc() const;
@@ -78,6 +96,8 @@ private:
     void InitSwizzleProps();
     // Fills a LUT for each channel.
     void InitLuts();
+    // Finds the micro-tile shape and precomputes where each run of pixels within it lives.
+    void InitMicroTile();
     // Evaluate coordinate without LUTs
     UINT_32 EvalEquation(UINT_32 x, UINT_32 y, UINT_32 z, UINT_32 s);
 
@@ -107,6 +127,14 @@ private:
     // BPE for this equation.
     UINT_32  m_bpeLog2;
 
+    // Micro-tile size in elements, 0 if whole micro-tiles can't be copied with a fixed pattern.
+    UINT_32  m_microTileWidth;
+    UINT_32  m_microTileHeight;
+
+    // Offsets of each ExpandX-wide run of pixels within a micro-tile.
+    UINT_32        m_microChunkCount;
+    LutMicroChunk  m_microChunks[MaxMicroChunks];
+
     // The full equation
     ADDR_BIT_SETTING m_bit[ADDR_MAX_EQUATION_BIT];
 
@@ -15,6 +15,10 @@
  *    sort filename | uniq -c | sort -n > rolls_sorted.txt
  *
  *    Then try to reduce the most frequent context rolls.
+ *
+ * Each IB is followed by a summary with the number of draws and context rolls, the number of
+ * rolls that only rewrote registers with their current values (red registers), which could be
+ * avoided entirely, and how many rolls each register was part of.
  */
 
 #include "ac_debug.h"
@@ -47,6 +51,7 @@ struct ac_context_roll_ctx {
    bool context_busy;
 
    unsigned num_busy_contexts;
+   unsigned num_draws;
    struct util_dynarray rolls;
 
    const struct radeon_info *info;
@@ -283,6 +288,7 @@ static void ac_ib_gather_context_rolls(struct ac_context_roll_ctx *ctx, uint32_t
       case PKT3_DISPATCH_MESH_DIRECT:
       case PKT3_DISPATCH_MESH_INDIRECT_MULTI:
       case PKT3_DISPATCH_TASKMESH_GFX:
+         ctx->num_draws++;
          ctx->context_busy = true;
          break;
 
@@ -304,6 +310,63 @@ static void ac_ib_gather_context_rolls(struct ac_context_roll_ctx *ctx, uint32_t
    }
 }
 
+struct ac_context_reg_rolls {
+   unsigned reg;
+   unsigned num_rolls;
+};
+
+static int ac_compare_reg_rolls(const void *a, const void *b)
+{
+   const struct ac_context_reg_rolls *ra = a, *rb = b;
+
+   if (ra->num_rolls != rb->num_rolls)
+      return ra->num_rolls < rb->num_rolls ? 1 : -1;
+   return ra->reg < rb->reg ? -1 : ra->reg > rb->reg;
+}
+
+static void ac_print_context_roll_summary(FILE *f, struct ac_context_roll_ctx *ctx)
+{
+   struct ac_context_reg_rolls reg_rolls[1024];
+   unsigned num_rolls = util_dynarray_num_elements(&ctx->rolls, struct ac_context_reg_state *);
+   unsigned num_redundant = 0;
+
+   for (unsigned i = 0; i < ARRAY_SIZE(reg_rolls); i++) {
+      reg_rolls[i].reg = i;
+      reg_rolls[i].num_rolls = 0;
+   }
+
+   util_dynarray_foreach(&ctx->rolls, struct ac_context_reg_state *, iter) {
+      struct ac_context_reg_state *state = *iter;
+      bool redundant = !state->deltas.acquire_mem;
+
+      unsigned i;
+      BITSET_FOREACH_SET(i, state->deltas.changed, 1024) {
+         reg_rolls[i].num_rolls++;
+         redundant &= !state->deltas.changed_masks[i];
+      }
+
+      num_redundant += redundant;
+   }
+
+   fprintf(f, "Summary: %u draws, %u context rolls, %u redundant\n", ctx->num_draws, num_rolls,
+           num_redundant);
+
+   qsort(reg_rolls, ARRAY_SIZE(reg_rolls), sizeof(reg_rolls[0]), ac_compare_reg_rolls);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(reg_rolls) && reg_rolls[i].num_rolls; i++) {
+      unsigned reg_offset = SI_CONTEXT_REG_OFFSET + reg_rolls[i].reg * 4;
+      const struct si_reg *reg = ac_find_register(ctx->info->gfx_level, ctx->info->family,
+                                                  reg_offset);
+
+      if (!reg)
+         fprintf(f, "   0x%X: %u\n", reg_offset, reg_rolls[i].num_rolls);
+      else
+         fprintf(f, "   %s: %u\n", sid_strings + reg->name_offset, reg_rolls[i].num_rolls);
+   }
+
+   fprintf(f, "\n");
+}
+
 void ac_gather_context_rolls(FILE *f, uint32_t **ibs, uint32_t *ib_dw_sizes, unsigned num_ibs,
                              struct hash_table *annotations, const struct radeon_info *info)
 {
@@ -359,6 +422,8 @@ void ac_gather_context_rolls(FILE *f, uint32_t **ibs, uint32_t *ib_dw_sizes, uns
       }
    }
 
+   ac_print_context_roll_summary(f, &ctx);
+
    /* Free. */
    FREE(ctx.cur);
    util_dynarray_foreach(&ctx.rolls, struct ac_context_reg_state *, iter) {
@@ -20,6 +20,7 @@
 #include "util/format/u_format.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
+#include "util/u_parallel.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -4827,12 +4828,90 @@ ac_surface_copy_mem_surface(struct ac_addrlib *addrlib, const struct radeon_info
    }
 }
 
+/* Large copies are split into bands of rows of at least this many bytes,
+ * which are copied in parallel.
+ */
+#define AC_SURFACE_COPY_PARALLEL_MIN_BYTES (1024 * 1024)
+
+/* Bands start at multiples of this many rows, so that they don't split the
+ * 256B micro-tiles addrlib copies at once (16 rows at most, for 8bpp).
+ */
+#define AC_SURFACE_COPY_BAND_ROWS 16
+
+struct ac_surface_copy_job {
+   struct ac_addrlib *addrlib;
+   const struct radeon_info *info;
+   const struct radeon_surf *surf;
+   const struct ac_surf_info *surf_info;
+   const struct ac_surface_copy_region *region;
+   bool surface_is_dst;
+   uint32_t first_row;
+   uint32_t failed;
+};
+
+static void
+ac_surface_copy_band(void *data, unsigned start, unsigned count)
+{
+   struct ac_surface_copy_job *job = data;
+   const struct ac_surface_copy_region *region = job->region;
+   const uint32_t y_end = region->offset.y + region->extent.height;
+   const uint32_t y0 = MAX2(region->offset.y, job->first_row + start * AC_SURFACE_COPY_BAND_ROWS);
+   const uint32_t y1 = MIN2(y_end, job->first_row + (start + count) * AC_SURFACE_COPY_BAND_ROWS);
+
+   struct ac_surface_copy_region band = *region;
+   band.host_ptr = (const uint8_t *)region->host_ptr +
+                   (uint64_t)(y0 - region->offset.y) * region->mem_row_pitch;
+   band.offset.y = y0;
+   band.extent.height = y1 - y0;
+
+   if (!ac_surface_copy_mem_surface(job->addrlib, job->info, job->surf, job->surf_info, &band,
+                                    job->surface_is_dst))
+      p_atomic_set(&job->failed, 1);
+}
+
+static bool
+ac_surface_copy_mem_surface_parallel(struct ac_addrlib *addrlib, const struct radeon_info *info,
+                                     const struct radeon_surf *surf,
+                                     const struct ac_surf_info *surf_info,
+                                     const struct ac_surface_copy_region *surf_copy_region,
+                                     bool surface_is_dst)
+{
+   const uint32_t y_start = surf_copy_region->offset.y;
+   const uint32_t y_end = y_start + surf_copy_region->extent.height;
+   const uint32_t layers = surf->u.gfx9.resource_type == RADEON_RESOURCE_3D ?
+                           surf_copy_region->extent.depth :
+                           surf_copy_region->num_layers;
+   const uint64_t band_bytes = (uint64_t)surf_copy_region->extent.width * surf->bpe *
+                               AC_SURFACE_COPY_BAND_ROWS * MAX2(layers, 1);
+
+   struct ac_surface_copy_job job = {
+      .addrlib = addrlib,
+      .info = info,
+      .surf = surf,
+      .surf_info = surf_info,
+      .region = surf_copy_region,
+      .surface_is_dst = surface_is_dst,
+      .first_row = ROUND_DOWN_TO(y_start, AC_SURFACE_COPY_BAND_ROWS),
+   };
+   const unsigned bands = DIV_ROUND_UP(y_end - job.first_row, AC_SURFACE_COPY_BAND_ROWS);
+   const unsigned min_bands = DIV_ROUND_UP(AC_SURFACE_COPY_PARALLEL_MIN_BYTES, MAX2(band_bytes, 1));
+
+   if (bands < 2 * min_bands)
+      return ac_surface_copy_mem_surface(addrlib, info, surf, surf_info, surf_copy_region,
+                                         surface_is_dst);
+
+   util_parallel_for(bands, min_bands, ac_surface_copy_band, &job);
+
+   return !job.failed;
+}
+
 bool
 ac_surface_copy_mem_to_surface(struct ac_addrlib *addrlib, const struct radeon_info *info,
                                const struct radeon_surf *surf, const struct ac_surf_info *surf_info,
                                const struct ac_surface_copy_region *surf_copy_region)
 {
-   return ac_surface_copy_mem_surface(addrlib, info, surf, surf_info, surf_copy_region, true);
+   return ac_surface_copy_mem_surface_parallel(addrlib, info, surf, surf_info, surf_copy_region,
+                                               true);
 }
 
 bool
@@ -4840,7 +4919,8 @@ ac_surface_copy_surface_to_mem(struct ac_addrlib *addrlib, const struct radeon_i
                                const struct radeon_surf *surf, const struct ac_surf_info *surf_info,
                                const struct ac_surface_copy_region *surf_copy_region)
 {
-   return ac_surface_copy_mem_surface(addrlib, info, surf, surf_info, surf_copy_region, false);
+   return ac_surface_copy_mem_surface_parallel(addrlib, info, surf, surf_info, surf_copy_region,
+                                               false);
 }
 
 void ac_surface_print_info(FILE *out, const struct radeon_info *info,
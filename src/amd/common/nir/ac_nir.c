@@ -107,6 +107,7 @@ void ac_nir_set_options(struct radeon_info *info, bool use_llvm,
    options->discard_is_demote = true;
    options->optimize_sample_mask_in = true;
    options->optimize_load_front_face_fsign = true;
+   options->skip_unchanged_algebraic = true;
    options->io_options = nir_io_has_flexible_input_interpolation_except_flat |
                          (info->gfx_level >= GFX8 ? nir_io_16bit_input_output_support : 0) |
                          nir_io_prefer_scalar_fs_inputs |
@@ -9,6 +9,7 @@
 
 #include "common/sid.h"
 
+#include <bitset>
 #include <map>
 #include <stack>
 #include <vector>
@@ -958,8 +959,71 @@ check_clause_raw(std::bitset<512>& regs_written, Instruction* instr)
    return true;
 }
 
+/* Registers accessed and counters incremented by the blocks of a loop. */
+struct loop_info {
+   std::bitset<512> regs_read;
+   std::bitset<512> regs_written;
+   uint32_t counters = 0;
+};
+
+loop_info
+gather_loop_info(Program* program, const target_info* info, unsigned preheader)
+{
+   loop_info loop;
+   wait_ctx ctx(program, info);
+
+   for (unsigned i = preheader + 1; i < program->blocks.size(); i++) {
+      Block& block = program->blocks[i];
+      if (block.loop_nest_depth <= program->blocks[preheader].loop_nest_depth)
+         break;
+
+      for (aco_ptr<Instruction>& instr : block.instructions) {
+         for (const Operand& op : instr->operands) {
+            if (op.isConstant() || op.isUndefined())
+               continue;
+            for (unsigned j = 0; j < op.size(); j++)
+               loop.regs_read.set(op.physReg().reg() + j);
+         }
+         for (const Definition& def : instr->definitions) {
+            for (unsigned j = 0; j < def.size(); j++)
+               loop.regs_written.set(def.physReg().reg() + j);
+         }
+
+         gen(instr.get(), ctx);
+         ctx.gpr_map.clear();
+      }
+   }
+
+   loop.counters = ctx.nonzero;
+   return loop;
+}
+
+/* Waits which are needed inside a loop for instructions issued before it are
+ * emitted in the preheader instead. At the use, the joined context can't tell
+ * the first iteration from later ones, so the wait would also be done for
+ * instructions of the previous iteration issued in the meantime. This is
+ * only done for counters which the loop increments, otherwise waiting in the
+ * loop is cheap.
+ */
+void
+hoist_loop_waits(wait_ctx& ctx, const loop_info& loop, wait_imm& imm)
+{
+   for (std::pair<const PhysReg, wait_entry>& e : ctx.gpr_map) {
+      wait_entry& entry = e.second;
+      unsigned reg = e.first.reg();
+
+      if (!(entry.counters & loop.counters))
+         continue;
+      if (!loop.regs_written[reg] && !(entry.wait_on_read && loop.regs_read[reg]))
+         continue;
+
+      u_foreach_bit (i, entry.counters & loop.counters)
+         imm[i] = std::min(imm[i], entry.imm[i]);
+   }
+}
+
 void
-handle_block(Program* program, Block& block, wait_ctx& ctx)
+handle_block(Program* program, Block& block, wait_ctx& ctx, const loop_info* loop)
 {
    std::vector<aco_ptr<Instruction>> new_instructions;
 
@@ -975,6 +1039,9 @@ handle_block(Program* program, Block& block, wait_ctx& ctx)
       if (instr->opcode == aco_opcode::s_waitcnt_depctr)
          queued_depctr = parse_depctr_wait(instr.get());
 
+      if (loop && instr->isBranch())
+         hoist_loop_waits(ctx, *loop, queued_imm);
+
       memory_sync_info sync_info = get_sync_info(instr.get());
       kill(queued_imm, queued_depctr, instr.get(), ctx, sync_info);
 
@@ -1059,6 +1126,12 @@ insert_waitcnt(Program* program)
    std::stack<unsigned, std::vector<unsigned>> loop_header_indices;
    unsigned loop_progress = 0;
 
+   std::map<unsigned, loop_info> loops;
+   for (Block& block : program->blocks) {
+      if (block.kind & block_kind_loop_preheader)
+         loops.emplace(block.index, gather_loop_info(program, &info, block.index));
+   }
+
    if (program->pending_lds_access) {
       update_barriers(in_ctx[0], info.get_counters_for_event(event_lds), event_lds, NULL,
                       memory_sync_info(storage_shared));
@@ -1125,7 +1198,8 @@ insert_waitcnt(Program* program)
       loop_progress = std::max<unsigned>(loop_progress, current.loop_nest_depth);
       done[current.index] = true;
 
-      handle_block(program, current, ctx);
+      auto loop = loops.find(current.index);
+      handle_block(program, current, ctx, loop != loops.end() ? &loop->second : NULL);
 
       out_ctx[current.index] = std::move(ctx);
    }
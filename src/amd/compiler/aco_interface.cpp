@@ -123,7 +123,7 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    if ((debug_flags & DEBUG_LIVE_INFO) && options->dump_ir)
       aco_print_program(program.get(), stderr, print_live_vars | print_kill);
 
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED))
+   if (!options->optimisations_disabled && !options->fast_compile && !(debug_flags & DEBUG_NO_SCHED))
       schedule_program(program.get());
    validate(program.get());
 
@@ -140,7 +140,7 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    validate(program.get());
 
    /* Optimization */
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_OPT)) {
+   if (!options->optimisations_disabled && !options->fast_compile && !(debug_flags & DEBUG_NO_OPT)) {
       optimize_postRA(program.get());
       validate(program.get());
    }
@@ -153,11 +153,11 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    lower_branches(program.get());
    validate(program.get());
 
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED_VOPD))
+   if (!options->optimisations_disabled && !options->fast_compile && !(debug_flags & DEBUG_NO_SCHED_VOPD))
       schedule_vopd(program.get());
 
    /* Schedule hardware instructions for ILP */
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED_ILP))
+   if (!options->optimisations_disabled && !options->fast_compile && !(debug_flags & DEBUG_NO_SCHED_ILP))
       schedule_ilp(program.get());
 
    disable_wqm(program.get());
@@ -176,7 +176,8 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    if (program->gfx_level >= GFX11)
       combine_delay_alu(program.get());
 
-   if (program->collect_statistics || (debug_flags & DEBUG_PERF_INFO))
+   if (program->collect_statistics || program->collect_block_statistics ||
+       (debug_flags & DEBUG_PERF_INFO))
       collect_preasm_stats(program.get());
 
    return llvm_ir;
@@ -239,6 +240,7 @@ aco_compile_shader(const struct aco_compiler_options* options, const struct aco_
    std::unique_ptr<Program> program{new Program};
 
    program->collect_statistics = options->record_stats;
+   program->collect_block_statistics = options->dump_block_stats;
    memset(&program->statistics, 0, sizeof(program->statistics));
 
    program->debug.func = options->debug.func;
@@ -261,6 +263,9 @@ aco_compile_shader(const struct aco_compiler_options* options, const struct aco_
    if (program->collect_statistics)
       collect_postasm_stats(program.get(), code);
 
+   if (program->collect_block_statistics)
+      dump_block_stats(program.get(), exec_size, stderr);
+
    std::string disasm;
    if (options->record_asm)
       disasm = get_disasm_string(program.get(), options->family, code, exec_size);
@@ -2156,6 +2156,15 @@ struct Block {
    Block() : index(0) {}
 };
 
+/* Cycle estimate of a block, collected by collect_preasm_stats(). */
+struct block_statistics {
+   unsigned cycles;
+   /* Estimated number of executions per shader invocation. */
+   double frequency;
+   /* Indices into Program::debug_info of the block's p_debug_info. */
+   std::vector<uint32_t> debug_info;
+};
+
 /*
  * Shader stages as provided in Vulkan by the application. Contrast this to HWStage.
  */
@@ -2322,6 +2331,9 @@ public:
    bool collect_statistics = false;
    amd_stats statistics;
 
+   bool collect_block_statistics = false;
+   std::vector<block_statistics> block_stats;
+
    float_mode next_fp_mode;
    unsigned next_loop_depth = 0;
    unsigned next_divergent_if_logical_depth = 0;
@@ -2473,6 +2485,7 @@ bool validate_live_vars(Program* program);
 void collect_presched_stats(Program* program);
 void collect_preasm_stats(Program* program);
 void collect_postasm_stats(Program* program, const std::vector<uint32_t>& code);
+void dump_block_stats(Program* program, unsigned exec_size, FILE* output);
 
 struct Instruction_cycle_info {
    /* Latency until the result is ready (if not needing a waitcnt) */
@@ -81,8 +81,10 @@ namespace {
 struct live_ctx {
    monotonic_buffer_resource m;
    Program* program;
-   int32_t worklist;
-   uint32_t handled_once;
+   /* index of the block and the phi (if any) which define each temporary */
+   std::vector<uint32_t> def_block;
+   std::vector<Instruction*> phi_defs;
+   std::vector<uint32_t> stack;
 };
 
 bool
@@ -139,7 +141,7 @@ compute_live_out(live_ctx& ctx, Block* block)
    }
 
    /* Handle phi operands */
-   if (block->linear_succs.size() == 1 && block->linear_succs[0] >= ctx.handled_once) {
+   if (block->linear_succs.size() == 1) {
       Block& succ = ctx.program->blocks[block->linear_succs[0]];
       auto it = std::find(succ.linear_preds.begin(), succ.linear_preds.end(), block->index);
       unsigned op_idx = std::distance(succ.linear_preds.begin(), it);
@@ -152,7 +154,7 @@ compute_live_out(live_ctx& ctx, Block* block)
             live.insert(phi->operands[op_idx].tempId());
       }
    }
-   if (block->logical_succs.size() == 1 && block->logical_succs[0] >= ctx.handled_once) {
+   if (block->logical_succs.size() == 1) {
       Block& succ = ctx.program->blocks[block->logical_succs[0]];
       auto it = std::find(succ.logical_preds.begin(), succ.logical_preds.end(), block->index);
       unsigned op_idx = std::distance(succ.logical_preds.begin(), it);
@@ -503,14 +505,7 @@ process_live_temps_per_block(live_ctx& ctx, Block* block)
       Definition& definition = insn->definitions[0];
       ctx.program->needs_vcc |= definition.isFixed() && definition.physReg() == vcc;
       const size_t n = live.erase(definition.tempId());
-      if (n && (definition.isKill() || ctx.handled_once > block->index)) {
-         Block::edge_vec& preds =
-            insn->opcode == aco_opcode::p_phi ? block->logical_preds : block->linear_preds;
-         for (unsigned i = 0; i < preds.size(); i++) {
-            if (insn->operands[i].isTemp())
-               ctx.worklist = std::max<int>(ctx.worklist, preds[i]);
-         }
-      }
+      assert(definition.isKill() == !n);
       definition.setKill(!n);
    }
 
@@ -530,26 +525,145 @@ process_live_temps_per_block(live_ctx& ctx, Block* block)
       }
    }
 
-   if (ctx.program->live.live_in[block->index].insert(live)) {
-      if (block->linear_preds.size()) {
-         assert(block->logical_preds.empty() ||
-                block->logical_preds.back() <= block->linear_preds.back());
-         ctx.worklist = std::max<int>(ctx.worklist, block->linear_preds.back());
-      } else {
-         ASSERTED bool is_valid = validate_ir(ctx.program);
-         assert(!is_valid);
-      }
+   if (block->linear_preds.empty() && !live.empty()) {
+      ASSERTED bool is_valid = validate_ir(ctx.program);
+      assert(!is_valid);
    }
 
    block->live_in_demand = new_demand;
    block->register_demand.update(block->live_in_demand);
    ctx.program->max_reg_demand.update(block->register_demand);
    ctx.program->max_call_spills.update(block->call_spills);
-   ctx.handled_once = std::min(ctx.handled_once, block->index);
 
    assert(!block->linear_preds.empty() || (new_demand == RegisterDemand() && live.empty()));
 }
 
+/* Marks the temporary live-in at the given block and all blocks on the paths from its
+ * definition to it.
+ */
+void
+mark_live_in(live_ctx& ctx, uint32_t block_idx, uint32_t id)
+{
+   const uint32_t def_block = ctx.def_block[id];
+   const bool is_linear = ctx.program->temp_rc[id].is_linear();
+   IDSet* live_in = ctx.program->live.live_in.data();
+
+   ctx.stack.push_back(block_idx);
+   while (!ctx.stack.empty()) {
+      uint32_t idx = ctx.stack.back();
+      ctx.stack.pop_back();
+
+      if (idx == def_block || !live_in[idx].insert(id).second)
+         continue;
+
+      Block& block = ctx.program->blocks[idx];
+      Block::edge_vec& preds = is_linear ? block.linear_preds : block.logical_preds;
+      ctx.stack.insert(ctx.stack.end(), preds.begin(), preds.end());
+   }
+}
+
+void
+mark_phi_live(live_ctx& ctx, std::vector<Instruction*>& worklist, const Operand& op)
+{
+   if (!op.isTemp())
+      return;
+
+   Instruction* phi = ctx.phi_defs[op.tempId()];
+   if (phi && phi->definitions[0].isKill()) {
+      phi->definitions[0].setKill(false);
+      worklist.push_back(phi);
+   }
+}
+
+/* A phi is live if its result is used by a non-phi instruction or by a live phi. The kill flag
+ * of the definition is set for all others, so that their operands aren't considered live.
+ */
+void
+compute_live_phis(live_ctx& ctx)
+{
+   std::vector<Instruction*> worklist;
+
+   for (Block& block : ctx.program->blocks) {
+      for (aco_ptr<Instruction>& instr : block.instructions) {
+         if (!is_phi(instr))
+            continue;
+
+         if (instr->definitions[0].isTemp())
+            instr->definitions[0].setKill(true);
+         else
+            worklist.push_back(instr.get());
+      }
+   }
+
+   for (Block& block : ctx.program->blocks) {
+      for (aco_ptr<Instruction>& instr : block.instructions) {
+         if (is_phi(instr))
+            continue;
+
+         for (const Operand& op : instr->operands)
+            mark_phi_live(ctx, worklist, op);
+      }
+   }
+
+   while (!worklist.empty()) {
+      Instruction* phi = worklist.back();
+      worklist.pop_back();
+
+      for (const Operand& op : phi->operands)
+         mark_phi_live(ctx, worklist, op);
+   }
+}
+
+/* Computes the live-in sets of all blocks by walking up the CFG from each use until the
+ * definition or a block where the temporary is already known to be live-in. Temporaries with
+ * a linear register class walk the linear CFG, all others the logical CFG. This visits each
+ * block of a temporary's live range only once, so no fixed-point iteration over loops is
+ * necessary.
+ */
+void
+compute_live_in(live_ctx& ctx)
+{
+   Program* program = ctx.program;
+
+   ctx.def_block.assign(program->peekAllocationId(), UINT32_MAX);
+   ctx.phi_defs.assign(program->peekAllocationId(), nullptr);
+   for (Block& block : program->blocks) {
+      for (aco_ptr<Instruction>& instr : block.instructions) {
+         for (const Definition& def : instr->definitions) {
+            if (!def.isTemp())
+               continue;
+            ctx.def_block[def.tempId()] = block.index;
+            if (is_phi(instr))
+               ctx.phi_defs[def.tempId()] = instr.get();
+         }
+      }
+   }
+
+   compute_live_phis(ctx);
+
+   for (Block& block : program->blocks) {
+      for (aco_ptr<Instruction>& instr : block.instructions) {
+         if (is_phi(instr)) {
+            /* Phi operands are live at the end of the corresponding predecessor. */
+            if (instr->definitions[0].isKill())
+               continue;
+
+            Block::edge_vec& preds =
+               instr->opcode == aco_opcode::p_phi ? block.logical_preds : block.linear_preds;
+            for (unsigned i = 0; i < instr->operands.size(); i++) {
+               if (instr->operands[i].isTemp())
+                  mark_live_in(ctx, preds[i], instr->operands[i].tempId());
+            }
+         } else {
+            for (const Operand& op : instr->operands) {
+               if (op.isTemp())
+                  mark_live_in(ctx, block.index, op.tempId());
+            }
+         }
+      }
+   }
+}
+
 unsigned
 calc_waves_per_workgroup(Program* program)
 {
@@ -716,14 +830,16 @@ live_var_analysis(Program* program)
 
    live_ctx ctx;
    ctx.program = program;
-   ctx.worklist = program->blocks.size() - 1;
-   ctx.handled_once = program->blocks.size();
 
    /* this implementation assumes that the block idx corresponds to the block's position in
     * program->blocks vector */
-   while (ctx.worklist >= 0) {
-      process_live_temps_per_block(ctx, &program->blocks[ctx.worklist--]);
-   }
+   compute_live_in(ctx);
+
+   /* With the live-in sets known, each block only needs to be processed once to compute the
+    * kill flags and register demand.
+    */
+   for (int idx = program->blocks.size() - 1; idx >= 0; idx--)
+      process_live_temps_per_block(ctx, &program->blocks[idx]);
 
    program->max_reg_demand.update(program->fixed_reg_demand);
 
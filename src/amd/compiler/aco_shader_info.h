@@ -147,9 +147,15 @@ struct aco_compiler_options {
    bool record_asm;
    bool record_ir;
    bool record_stats;
+   /* Print per-block cycle estimates as JSON to stderr. */
+   bool dump_block_stats;
    bool has_ls_vgpr_init_bug;
    bool load_grid_size_from_user_sgpr;
    bool optimisations_disabled;
+   /* Skip the expensive scheduling and post-RA passes. Meant for binaries
+    * that are replaced by a fully optimized compile later on.
+    */
+   bool fast_compile;
    uint8_t enable_mrt_output_nan_fixup;
    bool wgp_mode;
    bool is_opengl;
@@ -178,6 +184,7 @@ enum aco_statistic {
    aco_statistic_vmem,
    aco_statistic_smem,
    aco_statistic_vopd,
+   aco_statistic_waterfalls,
    aco_num_statistics
 };
 
@@ -43,6 +43,10 @@ template <> struct hash<aco::Temp> {
  * As we decrement the number of remaining uses, the average use distances
  * give an approximation of the next-use distances while being computationally
  * and memory-wise less expensive.
+ *
+ * The use distances are further divided by the estimated execution frequency
+ * of the uses, so that variables used inside of loops are less likely to be
+ * spilled than variables which are only used outside of them.
  */
 
 namespace aco {
@@ -62,9 +66,23 @@ struct loop_info {
 struct use_info {
    uint32_t num_uses = 0;
    uint32_t last_use = 0;
-   float score() { return static_cast<float>(last_use) / static_cast<float>(num_uses); }
+   /* Average estimated execution frequency of the blocks containing the uses. */
+   float frequency = 1.0;
+   float score()
+   {
+      return static_cast<float>(last_use) / (static_cast<float>(num_uses) * frequency);
+   }
 };
 
+/* Estimates how often a block is executed relative to the top level,
+ * assuming that every loop runs for 8 iterations.
+ */
+float
+block_frequency(const Block& block)
+{
+   return static_cast<float>(1u << (3 * MIN2(block.loop_nest_depth, 8u)));
+}
+
 struct spill_ctx {
    RegisterDemand target_pressure;
    Program* program;
@@ -169,16 +187,20 @@ struct spill_ctx {
 };
 
 /**
- * Gathers information about the number of uses and point of last use
- * per SSA value.
+ * Gathers information about the number of uses, point of last use and
+ * frequency of the uses per SSA value.
  *
  * Phi definitions are added to live-ins.
  */
 void
 gather_ssa_use_info(spill_ctx& ctx)
 {
+   /* Sum of the frequencies and number of uses, without the artificial uses. */
+   std::vector<std::pair<float, uint32_t>> frequency_sum(ctx.ssa_infos.size());
+
    unsigned instruction_idx = 0;
    for (Block& block : ctx.program->blocks) {
+      const float frequency = block_frequency(block);
       for (int i = block.instructions.size() - 1; i >= 0; i--) {
          aco_ptr<Instruction>& instr = block.instructions[i];
          for (const Operand& op : instr->operands) {
@@ -186,6 +208,8 @@ gather_ssa_use_info(spill_ctx& ctx)
                use_info& info = ctx.ssa_infos[op.tempId()];
                info.num_uses++;
                info.last_use = std::max(info.last_use, instruction_idx + i);
+               frequency_sum[op.tempId()].first += frequency;
+               frequency_sum[op.tempId()].second++;
             }
          }
       }
@@ -202,6 +226,11 @@ gather_ssa_use_info(spill_ctx& ctx)
 
       instruction_idx += block.instructions.size();
    }
+
+   for (unsigned t = 0; t < ctx.ssa_infos.size(); t++) {
+      if (frequency_sum[t].second)
+         ctx.ssa_infos[t].frequency = frequency_sum[t].first / frequency_sum[t].second;
+   }
 }
 
 bool
@@ -590,6 +590,9 @@ collect_preasm_stats(Program* program)
          blocks[0].reg_available[def.physReg().reg() + i] = vmem_latency;
    }
 
+   if (program->collect_block_statistics)
+      program->block_stats.resize(program->blocks.size());
+
    for (Block& block : program->blocks) {
       BlockCycleEstimator& block_est = blocks[block.index];
       for (unsigned pred : block.linear_preds)
@@ -605,6 +608,16 @@ collect_preasm_stats(Program* program)
       latency += block_est.cur_cycle * iter;
       for (unsigned i = 0; i < (unsigned)BlockCycleEstimator::resource_count; i++)
          usage[i] += block_est.res_usage[i] * iter;
+
+      if (program->collect_block_statistics) {
+         block_statistics& stats = program->block_stats[block.index];
+         stats.cycles = block_est.cur_cycle;
+         stats.frequency = iter;
+         for (aco_ptr<Instruction>& instr : block.instructions) {
+            if (instr->opcode == aco_opcode::p_debug_info)
+               stats.debug_info.push_back(instr->operands[0].constantValue());
+         }
+      }
    }
 
    /* This likely exaggerates the effectiveness of parallelism because it
@@ -656,6 +669,65 @@ collect_postasm_stats(Program* program, const std::vector<uint32_t>& code)
    program->statistics.hash = util_hash_crc32(code.data(), code.size() * 4);
 }
 
+static void
+print_json_string(FILE* output, const char* str)
+{
+   fputc('"', output);
+   for (; *str; str++) {
+      if (*str == '"' || *str == '\\')
+         fprintf(output, "\\%c", *str);
+      else if ((unsigned char)*str < 0x20)
+         fprintf(output, "\\u%04x", *str);
+      else
+         fputc(*str, output);
+   }
+   fputc('"', output);
+}
+
+/* Prints the block estimates of collect_preasm_stats() as a JSON object. The
+ * code offsets and sizes of the blocks are in bytes, so that they can be
+ * matched with PC samples.
+ */
+void
+dump_block_stats(Program* program, unsigned exec_size, FILE* output)
+{
+   /* The assembler might have inserted blocks, so sort by offset to get the sizes. */
+   std::vector<unsigned> offsets;
+   for (Block& block : program->blocks)
+      offsets.push_back(block.offset * 4);
+   offsets.push_back(exec_size);
+   std::sort(offsets.begin(), offsets.end());
+
+   fprintf(output, "{\"wave_size\": %u, \"num_waves\": %u, ", program->wave_size,
+           program->num_waves);
+   fprintf(output, "\"latency\": %u, \"inv_throughput\": %u, \"blocks\": [",
+           program->statistics.latency, program->statistics.invthroughput);
+
+   for (unsigned i = 0; i < program->block_stats.size(); i++) {
+      const Block& block = program->blocks[i];
+      const block_statistics& stats = program->block_stats[i];
+      unsigned offset = block.offset * 4;
+      auto next = std::upper_bound(offsets.begin(), offsets.end(), offset);
+      unsigned size = next != offsets.end() ? *next - offset : 0;
+
+      fprintf(output, "%s\n  {\"index\": %u, \"offset\": %u, \"size\": %u, ", i ? "," : "",
+              block.index, offset, size);
+      fprintf(output, "\"loop_depth\": %u, \"cycles\": %u, \"frequency\": %f, \"src_locs\": [",
+              block.loop_nest_depth, stats.cycles, stats.frequency);
+
+      for (unsigned j = 0; j < stats.debug_info.size(); j++) {
+         const ac_shader_debug_info& info = program->debug_info[stats.debug_info[j]];
+         fprintf(output, "%s{\"file\": ", j ? ", " : "");
+         print_json_string(output, info.src_loc.file ? info.src_loc.file : "");
+         fprintf(output, ", \"line\": %u, \"column\": %u, \"spirv_offset\": %u}",
+                 info.src_loc.line, info.src_loc.column, info.src_loc.spirv_offset);
+      }
+      fprintf(output, "]}");
+   }
+
+   fprintf(output, "\n]}\n");
+}
+
 Instruction_cycle_info
 get_cycle_info(const Program& program, const Instruction& instr)
 {
@@ -981,10 +981,35 @@ visit_block(isel_context* ctx, nir_block* block)
    }
 }
 
+/* Matches the loops emitted by nir_lower_non_uniform_access():
+ * loop { x = read_first_invocation(..); if (..) { ..; break; } }
+ */
+bool
+is_waterfall_loop(nir_loop* loop)
+{
+   nir_block* header = nir_loop_first_block(loop);
+   nir_cf_node* next = nir_cf_node_next(&header->cf_node);
+   if (!next || next->type != nir_cf_node_if)
+      return false;
+
+   if (!nir_block_ends_in_break(nir_if_last_then_block(nir_cf_node_as_if(next))))
+      return false;
+
+   nir_foreach_instr (instr, header) {
+      if (instr->type == nir_instr_type_intrinsic &&
+          nir_instr_as_intrinsic(instr)->intrinsic == nir_intrinsic_read_first_invocation)
+         return true;
+   }
+   return false;
+}
+
 void
 visit_loop(isel_context* ctx, nir_loop* loop)
 {
    assert(!nir_loop_has_continue_construct(loop));
+   if (ctx->program->collect_statistics && is_waterfall_loop(loop))
+      ctx->program->statistics.waterfalls++;
+
    loop_context lc;
    begin_loop(ctx, &lc);
    ctx->cf_info.parent_loop.has_divergent_break =
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "helpers.h"
+
+#include "util/os_time.h"
+
+using namespace aco;
+
+/* These tests measure how long the backend takes for a large shader. They only check that all
+ * passes ran, the timings can be seen with "aco_tests --no-check compile_time.".
+ */
+
+static void
+emit_alu_chain(unsigned count)
+{
+   /* Keep a few values live at once, like a typical unrolled shader. */
+   Temp value[8];
+   for (unsigned i = 0; i < 8; i++)
+      value[i] = bld.copy(bld.def(v1), Operand::c32(i + 1));
+
+   for (unsigned i = 0; i < count; i++) {
+      Temp a = value[i % 8];
+      Temp b = value[(i + 3) % 8];
+      Temp mul = bld.vop2(aco_opcode::v_mul_f32, bld.def(v1), a, b);
+      Temp add = bld.vop2(aco_opcode::v_add_f32, bld.def(v1), mul, inputs[0]);
+      Temp s = bld.sop2(aco_opcode::s_add_u32, bld.def(s1), bld.def(s1, scc), inputs[1],
+                        Operand::c32(i));
+      value[i % 8] = bld.vop3(aco_opcode::v_fma_f32, bld.def(v1), add, b, s);
+   }
+
+   for (unsigned i = 0; i < 8; i++)
+      writeout(i, value[i]);
+}
+
+#define TIME_PASS(pass)                                                                            \
+   do {                                                                                            \
+      int64_t start = os_time_get_nano();                                                          \
+      pass(program.get());                                                                         \
+      fprintf(output, "%s: %" PRId64 " us\n", #pass, (os_time_get_nano() - start) / 1000);        \
+   } while (0)
+
+BEGIN_TEST(compile_time.alu_chain)
+   if (!setup_cs("v1 s1", GFX11))
+      return;
+
+   int64_t start = os_time_get_nano();
+   emit_alu_chain(20000);
+   finish_program(program.get(), true, true);
+   fprintf(output, "build: %" PRId64 " us\n", (os_time_get_nano() - start) / 1000);
+
+   //! build: # us
+   //! value_numbering: # us
+   //! optimize: # us
+   //! insert_exec_mask: # us
+   //! live_var_analysis: # us
+   //! spill: # us
+   //! schedule_program: # us
+   //! register_allocation: # us
+   //! optimize_postRA: # us
+   //! ssa_elimination: # us
+   //! lower_to_hw_instr: # us
+   //! schedule_ilp: # us
+   //! insert_waitcnt: # us
+   //! insert_NOPs: # us
+   //! total: # us
+   TIME_PASS(value_numbering);
+   TIME_PASS(optimize);
+   TIME_PASS(insert_exec_mask);
+   TIME_PASS(live_var_analysis);
+   TIME_PASS(spill);
+   TIME_PASS(schedule_program);
+   TIME_PASS(register_allocation);
+   TIME_PASS(optimize_postRA);
+   TIME_PASS(ssa_elimination);
+   TIME_PASS(lower_to_hw_instr);
+   TIME_PASS(schedule_ilp);
+   TIME_PASS(insert_waitcnt);
+   TIME_PASS(insert_NOPs);
+   fprintf(output, "total: %" PRId64 " us\n", (os_time_get_nano() - start) / 1000);
+END_TEST
+
+BEGIN_TEST(compile_time.create_instruction)
+   if (!setup_cs("v1", GFX11))
+      return;
+
+   //! create_instruction: # us
+   int64_t start = os_time_get_nano();
+   for (unsigned i = 0; i < 200000; i++)
+      create_instruction(aco_opcode::v_add_f32, Format::VOP2, 2, 1);
+   fprintf(output, "create_instruction: %" PRId64 " us\n", (os_time_get_nano() - start) / 1000);
+
+   //! insert: # us
+   start = os_time_get_nano();
+   for (unsigned i = 0; i < 200000; i++)
+      bld.vop2(aco_opcode::v_add_f32, bld.def(v1), inputs[0], inputs[0]);
+   fprintf(output, "insert: %" PRId64 " us\n", (os_time_get_nano() - start) / 1000);
+END_TEST
@@ -903,6 +903,69 @@ BEGIN_TEST(insert_waitcnt.divergent_branch.no_skip)
    }
 END_TEST
 
+BEGIN_TEST(insert_waitcnt.loop.hoist)
+   for (amd_gfx_level gfx : {GFX10_3, GFX12}) {
+      if (!setup_cs(NULL, gfx))
+         continue;
+
+      Definition def_v4(PhysReg(260), v1);
+      Definition def_v5(PhysReg(261), v1);
+      Definition def_v6(PhysReg(262), v1);
+      Operand op_v0(PhysReg(256), v1);
+      Operand desc_s4(PhysReg(0), s4);
+
+      program->blocks.reserve(3);
+      Block* preheader = &program->blocks.back();
+      Block* header = program->create_and_insert_block();
+      Block* exit = program->create_and_insert_block();
+
+      bld.reset(preheader);
+      preheader->kind |= block_kind_loop_preheader;
+      header->kind |= block_kind_loop_header;
+      header->loop_nest_depth = 1;
+      header->linear_preds.push_back(preheader->index);
+      header->linear_preds.push_back(header->index);
+      header->logical_preds.push_back(preheader->index);
+      header->logical_preds.push_back(header->index);
+      exit->kind |= block_kind_loop_exit | block_kind_top_level;
+      exit->linear_preds.push_back(header->index);
+      exit->logical_preds.push_back(header->index);
+
+      /* The wait for v4 is done before the loop, so that it doesn't have to wait for the load of
+       * the previous iteration. v6 is only used after the loop.
+       */
+      //>> v1: %0:v[4] = buffer_load_dword %0:s[0-3], %0:v[0], 0
+      //! v1: %0:v[6] = buffer_load_dword %0:s[0-3], %0:v[0], 0
+      //~gfx10_3! s_waitcnt vmcnt(1)
+      //~gfx12! s_wait_loadcnt imm:1
+      //! p_branch BB1
+      bld.mubuf(aco_opcode::buffer_load_dword, def_v4, desc_s4, op_v0, Operand::zero(), 0, false);
+      bld.mubuf(aco_opcode::buffer_load_dword, def_v6, desc_s4, op_v0, Operand::zero(), 0, false);
+      bld.branch(aco_opcode::p_branch, header->index);
+
+      //! BB1
+      //! /* logical preds: BB0, BB1, / linear preds: BB0, BB1, / kind: loop-header, */
+      //! p_unit_test 1
+      //! p_unit_test %0:v[4]
+      //~gfx12! s_wait_loadcnt imm:0
+      //! v1: %0:v[5] = buffer_load_dword %0:s[0-3], %0:v[0], 0
+      bld.reset(header);
+      bld.pseudo(aco_opcode::p_unit_test, Operand::c32(1));
+      bld.pseudo(aco_opcode::p_unit_test, Operand(PhysReg(260), v1));
+      bld.mubuf(aco_opcode::buffer_load_dword, def_v5, desc_s4, op_v0, Operand::zero(), 0, false);
+      bld.branch(aco_opcode::p_cbranch_z, header->index, exit->index);
+
+      //>> p_unit_test 2
+      //~gfx10_3! s_waitcnt vmcnt(1)
+      //! p_unit_test %0:v[6]
+      bld.reset(exit);
+      bld.pseudo(aco_opcode::p_unit_test, Operand::c32(2));
+      bld.pseudo(aco_opcode::p_unit_test, Operand(PhysReg(262), v1));
+
+      finish_waitcnt_test();
+   }
+END_TEST
+
 BEGIN_TEST(insert_waitcnt.flat.wait_zero)
    for (amd_gfx_level gfx : {GFX9, GFX10}) {
       if (!setup_cs(NULL, gfx))
@@ -304,6 +304,52 @@ BEGIN_TEST(regalloc.branch_def_phis_at_branch_block)
    finish_ra_test(ra_test_policy());
 END_TEST
 
+BEGIN_TEST(regalloc.loop.live_through)
+   //>> p_startpgm
+   if (!setup_cs("", GFX10))
+      return;
+
+   program->blocks[0].kind &= ~block_kind_top_level;
+
+   //! s1: %x:s[#x_reg] = p_unit_test
+   Temp x = bld.pseudo(aco_opcode::p_unit_test, bld.def(s1));
+   bld.branch(aco_opcode::p_branch);
+
+   //>> BB1
+   //! /* logical preds: / linear preds: BB0, BB2, / kind: loop-header, */
+   bld.reset(program->create_and_insert_block());
+   program->blocks[1].linear_preds.push_back(0);
+   program->blocks[1].linear_preds.push_back(2);
+   program->blocks[1].kind |= block_kind_loop_header;
+
+   /* Only used by itself, so it's dead and doesn't need a register. */
+   Temp dead = bld.tmp(s1);
+   bld.pseudo(aco_opcode::p_linear_phi, Definition(dead), Operand::c32(0u), Operand(dead));
+
+   bld.branch(aco_opcode::p_cbranch_z, Operand(scc, s1));
+
+   /* %x is only live here because of the back-edge. */
+   //>> BB2
+   bld.reset(program->create_and_insert_block());
+   program->blocks[2].linear_preds.push_back(1);
+
+   //>> s1: %y:s[#y_reg] = p_unit_test
+   //; success = x_reg != y_reg
+   bld.pseudo(aco_opcode::p_unit_test, bld.def(s1));
+   bld.branch(aco_opcode::p_branch);
+
+   //>> BB3
+   //! /* logical preds: / linear preds: BB1, / kind: uniform, top-level, loop-exit, */
+   bld.reset(program->create_and_insert_block());
+   program->blocks[3].linear_preds.push_back(1);
+   program->blocks[3].kind |= block_kind_loop_exit | block_kind_top_level;
+
+   //! p_unit_test %x:s[#x_reg]
+   bld.pseudo(aco_opcode::p_unit_test, x);
+
+   finish_ra_test(ra_test_policy());
+END_TEST
+
 BEGIN_TEST(regalloc.vintrp_fp16)
    //>> v1: %in0:v[0], s1: %in1:s[0], v1: %in2:v[1] = p_startpgm
    if (!setup_cs("v1 s1 v1", GFX10))
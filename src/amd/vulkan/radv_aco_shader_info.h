@@ -113,6 +113,7 @@ radv_aco_convert_opts(struct aco_compiler_options *aco_info, const struct radv_n
    ASSIGN_FIELD(record_asm);
    ASSIGN_FIELD(record_ir);
    ASSIGN_FIELD(record_stats);
+   ASSIGN_FIELD(dump_block_stats);
    ASSIGN_FIELD(enable_mrt_output_nan_fixup);
    ASSIGN_FIELD(wgp_mode);
    ASSIGN_FIELD(debug.func);
@@ -121,6 +122,7 @@ radv_aco_convert_opts(struct aco_compiler_options *aco_info, const struct radv_n
    aco_info->is_opengl = false;
    aco_info->load_grid_size_from_user_sgpr = radv_args->load_grid_size_from_user_sgpr;
    aco_info->optimisations_disabled = stage_key->optimisations_disabled;
+   aco_info->fast_compile = stage_key->fast_compile;
    aco_info->gfx_level = radv->info->gfx_level;
    aco_info->family = radv->info->family;
    aco_info->address32_hi = radv->info->address32_hi;
@@ -15,6 +15,7 @@
 enum {
    RADV_DEBUG_NO_FAST_CLEARS = 1ull << 0,
    RADV_DEBUG_NO_DCC = 1ull << 1,
+   RADV_DEBUG_DUMP_BLOCK_STATS = 1ull << 2,
    RADV_DEBUG_NO_CACHE = 1ull << 3,
    RADV_DEBUG_DUMP_SHADER_STATS = 1ull << 4,
    RADV_DEBUG_NO_HIZ = 1ull << 5,
@@ -75,6 +76,7 @@ enum {
    RADV_DEBUG_DUMP_IBS = 1ull << 60,
    RADV_DEBUG_VM = 1ull << 61,
    RADV_DEBUG_NO_SMEM_MITIGATION = 1ull << 62,
+   RADV_DEBUG_NO_FAST_COMPILE = 1ull << 63,
    RADV_DEBUG_DUMP_SHADERS = RADV_DEBUG_DUMP_VS | RADV_DEBUG_DUMP_TCS | RADV_DEBUG_DUMP_TES | RADV_DEBUG_DUMP_GS |
                              RADV_DEBUG_DUMP_PS | RADV_DEBUG_DUMP_TASK | RADV_DEBUG_DUMP_MESH | RADV_DEBUG_DUMP_CS |
                              RADV_DEBUG_DUMP_NIR | RADV_DEBUG_DUMP_ASM | RADV_DEBUG_DUMP_BACKEND_IR,
@@ -100,6 +102,8 @@ enum {
    RADV_PERFTEST_HIC = 1u << 16,
    RADV_PERFTEST_SPARSE = 1u << 17,
    RADV_PERFTEST_RT_CPS = 1u << 18,
+   RADV_PERFTEST_PARALLEL_STAGES = 1u << 19,
+   RADV_PERFTEST_NO_DMA_SHADERS = 1u << 20,
 };
 
 enum {
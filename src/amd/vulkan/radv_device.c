@@ -57,6 +57,7 @@ typedef void *drmDevicePtr;
 #include "util/os_time.h"
 #include "util/timespec.h"
 #include "util/u_atomic.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_process.h"
 #include "vulkan/vk_icd.h"
 #include "git_sha1.h"
@@ -109,6 +110,30 @@ radv_GetMemoryHostPointerPropertiesEXT(VkDevice _device, VkExternalMemoryHandleT
    }
 }
 
+static bool
+radv_shader_dma_upload_enabled(const struct radv_physical_device *pdev)
+{
+   const struct radv_instance *instance = radv_physical_device_instance(pdev);
+
+   /* SDMA buffer copy is only implemented for GFX7+. */
+   if (pdev->info.gfx_level < GFX7 || pdev->info.sdma_ip_version == SDMA_UNKNOWN ||
+       !pdev->info.ip[AMD_IP_SDMA].num_queues)
+      return false;
+
+   if (instance->perftest_flags & RADV_PERFTEST_DMA_SHADERS)
+      return true;
+
+   if (instance->perftest_flags & RADV_PERFTEST_NO_DMA_SHADERS)
+      return false;
+
+   /* Without resizable BAR, the CPU-visible VRAM window is small and shared with everything else
+    * the application maps. Large pipelines (eg. RT) then either spill their shader arenas to GTT or
+    * compete for the window, so upload shaders with SDMA to invisible VRAM instead. The copies are
+    * fenced by the shader upload semaphore which submissions wait on before first use.
+    */
+   return pdev->info.has_dedicated_vram && !pdev->info.all_vram_visible;
+}
+
 static VkResult
 radv_device_init_border_color(struct radv_device *device)
 {
@@ -1133,6 +1158,9 @@ radv_destroy_device(struct radv_device *device, const VkAllocationCallbacks *pAl
    simple_mtx_destroy(&device->pso_cache_stats_mtx);
    simple_mtx_destroy(&device->blit_queue_mtx);
 
+   if (util_queue_is_initialized(&device->shader_compile_queue))
+      util_queue_destroy(&device->shader_compile_queue);
+
    radv_destroy_shader_arenas(device);
    if (device->capture_replay_arena_vas)
       _mesa_hash_table_u64_destroy(device->capture_replay_arena_vas);
@@ -1195,6 +1223,15 @@ radv_CreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *pCr
 
    radv_init_shader_arenas(device);
 
+   if (instance->perftest_flags & RADV_PERFTEST_PARALLEL_STAGES) {
+      /* The application thread compiles one of the stages itself. */
+      const unsigned num_threads = CLAMP(util_get_cpu_caps()->nr_cpus - 1, 1, 4);
+
+      if (!util_queue_init(&device->shader_compile_queue, "radv_shader", 16, num_threads,
+                           UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL))
+         fprintf(stderr, "radv: Failed to create the shader compile queue.\n");
+   }
+
    /* Initialize the per-device cache key. */
    radv_device_init_cache_key(device);
 
@@ -1322,9 +1359,7 @@ radv_CreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *pCr
    }
    device->private_sdma_queue = VK_NULL_HANDLE;
 
-   device->shader_use_invisible_vram = (instance->perftest_flags & RADV_PERFTEST_DMA_SHADERS) &&
-                                       /* SDMA buffer copy is only implemented for GFX7+. */
-                                       pdev->info.gfx_level >= GFX7;
+   device->shader_use_invisible_vram = radv_shader_dma_upload_enabled(pdev);
    result = radv_init_shader_upload_queue(device);
    if (result != VK_SUCCESS)
       goto fail;
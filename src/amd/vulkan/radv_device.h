@@ -17,6 +17,7 @@
 
 #include "util/bitset.h"
 #include "util/mesa-blake3.h"
+#include "util/u_queue.h"
 
 #include "radv_debug_nir.h"
 #include "radv_pipeline.h"
@@ -331,6 +332,9 @@ struct radv_device {
    simple_mtx_t blit_queue_mtx;
 
    struct radv_address_binding_tracker *addr_binding_tracker;
+
+   /* Compiles the stages of graphics pipelines in parallel (RADV_PERFTEST=parallelstages). */
+   struct util_queue shader_compile_queue;
 };
 
 VK_DEFINE_HANDLE_CASTS(radv_device, vk.base, VkDevice, VK_OBJECT_TYPE_DEVICE)
@@ -847,6 +847,43 @@ dgc_load_ies_va(struct dgc_cmdbuf *cs, nir_def *stream_addr)
    return nir_iadd(b, load_param64(b, ies_addr), nir_u2u64(b, ies_offset));
 }
 
+/**
+ * State deltas
+ *
+ * Sequences are executed in order and user SGPRs persist between them, so state that comes
+ * from the same token data as the previous sequence doesn't need to be emitted again. This
+ * can't be done with IES because the next shader might use different user SGPRs.
+ */
+static bool
+dgc_can_skip_unchanged_state(const struct radv_indirect_command_layout *layout)
+{
+   return !(layout->vk.dgc_info & BITFIELD_BIT(MESA_VK_DGC_IES));
+}
+
+static nir_def *
+dgc_stream_matches_prev(struct dgc_cmdbuf *cs, nir_def *stream_addr, nir_def *sequence_id, uint32_t offset,
+                        uint32_t size)
+{
+   const struct radv_indirect_command_layout *layout = cs->layout;
+   nir_builder *b = cs->b;
+
+   nir_def *is_first = nir_ieq_imm(b, sequence_id, 0);
+
+   /* Compare the first sequence against itself to avoid reading before the stream. */
+   nir_def *prev_addr = nir_bcsel(b, is_first, stream_addr, nir_iadd_imm(b, stream_addr, -(int64_t)layout->vk.stride));
+
+   nir_def *matches = nir_inot(b, is_first);
+   for (uint32_t i = 0; i < size; i += 4) {
+      nir_def *cur =
+         nir_load_global(b, 1, 32, nir_iadd_imm(b, stream_addr, offset + i), .access = ACCESS_NON_WRITEABLE);
+      nir_def *prev =
+         nir_load_global(b, 1, 32, nir_iadd_imm(b, prev_addr, offset + i), .access = ACCESS_NON_WRITEABLE);
+      matches = nir_iand(b, matches, nir_ieq(b, cur, prev));
+   }
+
+   return matches;
+}
+
 static nir_def *
 dgc_load_shader_metadata(struct dgc_cmdbuf *cs, uint32_t bitsize, uint32_t field_offset)
 {
@@ -1835,26 +1872,60 @@ dgc_emit_push_constant_for_stage(struct dgc_cmdbuf *cs, nir_def *stream_addr, ni
    nir_pop_if(b, NULL);
 }
 
+static nir_def *
+dgc_push_constant_unchanged(struct dgc_cmdbuf *cs, nir_def *stream_addr, nir_def *sequence_id)
+{
+   const struct radv_indirect_command_layout *layout = cs->layout;
+   nir_builder *b = cs->b;
+
+   /* The sequence index is different for every sequence. */
+   if (!dgc_can_skip_unchanged_state(layout) || (layout->push_constant_mask & layout->sequence_index_mask))
+      return nir_imm_false(b);
+
+   nir_def *unchanged = nir_imm_true(b);
+   u_foreach_bit64 (i, layout->push_constant_mask) {
+      nir_def *matches =
+         dgc_stream_matches_prev(cs, stream_addr, sequence_id, layout->push_constant_offsets[i], 4);
+      unchanged = nir_iand(b, unchanged, matches);
+   }
+
+   return unchanged;
+}
+
 static void
 dgc_emit_push_constant(struct dgc_cmdbuf *cs, nir_def *stream_addr, nir_def *sequence_id, VkShaderStageFlags stages)
 {
    const struct dgc_pc_params params = dgc_get_pc_params(cs);
    nir_builder *b = cs->b;
 
-   nir_def *push_constant_stages = dgc_get_push_constant_stages(cs);
-   radv_foreach_stage (s, stages) {
-      nir_push_if(b, nir_test_mask(b, push_constant_stages, mesa_to_vk_shader_stage(s)));
+   nir_def *const_copy = dgc_push_constant_needs_copy(cs);
+
+   nir_push_if(b, dgc_push_constant_unchanged(cs, stream_addr, sequence_id));
+   {
+      /* The user SGPRs still point to the push constants uploaded by a previous sequence, only
+       * keep the upload layout of this sequence identical.
+       */
+      nir_def *pc_size =
+         nir_bcsel(b, const_copy, nir_imul_imm(b, load_param8(b, push_constant_size), 4), nir_imm_int(b, 0));
+      nir_store_var(b, cs->upload_offset, nir_iadd(b, nir_load_var(b, cs->upload_offset), pc_size), 0x1);
+   }
+   nir_push_else(b, NULL);
+   {
+      nir_def *push_constant_stages = dgc_get_push_constant_stages(cs);
+      radv_foreach_stage (s, stages) {
+         nir_push_if(b, nir_test_mask(b, push_constant_stages, mesa_to_vk_shader_stage(s)));
+         {
+            dgc_emit_push_constant_for_stage(cs, stream_addr, sequence_id, &params, s);
+         }
+         nir_pop_if(b, NULL);
+      }
+
+      nir_push_if(b, const_copy);
       {
-         dgc_emit_push_constant_for_stage(cs, stream_addr, sequence_id, &params, s);
+         dgc_alloc_push_constant(cs, stream_addr, sequence_id, &params);
       }
       nir_pop_if(b, NULL);
    }
-
-   nir_def *const_copy = dgc_push_constant_needs_copy(cs);
-   nir_push_if(b, const_copy);
-   {
-      dgc_alloc_push_constant(cs, stream_addr, sequence_id, &params);
-   }
    nir_pop_if(b, NULL);
 }
 
@@ -1989,14 +2060,12 @@ dgc_write_vertex_descriptor(struct dgc_cmdbuf *cs, const struct dgc_vbo_info *vb
 }
 
 static void
-dgc_emit_vertex_buffer(struct dgc_cmdbuf *cs, nir_def *stream_addr)
+dgc_emit_vertex_buffer_descriptors(struct dgc_cmdbuf *cs, nir_def *stream_addr, nir_def *vb_desc_usage_mask,
+                                   nir_def *vbo_cnt)
 {
    const struct radv_indirect_command_layout *layout = cs->layout;
    nir_builder *b = cs->b;
 
-   nir_def *vb_desc_usage_mask = load_param32(b, vb_desc_usage_mask);
-   nir_def *vbo_cnt = nir_bit_count(b, vb_desc_usage_mask);
-
    nir_push_if(b, nir_ine_imm(b, vbo_cnt, 0));
    {
       dgc_cs_begin(cs);
@@ -2085,6 +2154,46 @@ dgc_emit_vertex_buffer(struct dgc_cmdbuf *cs, nir_def *stream_addr)
    nir_pop_loop(b, NULL);
 }
 
+static nir_def *
+dgc_vertex_buffer_unchanged(struct dgc_cmdbuf *cs, nir_def *stream_addr, nir_def *sequence_id)
+{
+   const struct radv_indirect_command_layout *layout = cs->layout;
+   nir_builder *b = cs->b;
+
+   if (!dgc_can_skip_unchanged_state(layout))
+      return nir_imm_false(b);
+
+   nir_def *unchanged = nir_imm_true(b);
+   for (uint32_t i = 0; i < layout->vk.n_vb_layouts; i++) {
+      unchanged = nir_iand(b, unchanged,
+                           dgc_stream_matches_prev(cs, stream_addr, sequence_id, layout->vk.vb_layouts[i].src_offset_B,
+                                                   sizeof(VkBindVertexBufferIndirectCommandEXT)));
+   }
+
+   return unchanged;
+}
+
+static void
+dgc_emit_vertex_buffer(struct dgc_cmdbuf *cs, nir_def *stream_addr, nir_def *sequence_id)
+{
+   nir_builder *b = cs->b;
+
+   nir_def *vb_desc_usage_mask = load_param32(b, vb_desc_usage_mask);
+   nir_def *vbo_cnt = nir_bit_count(b, vb_desc_usage_mask);
+
+   nir_push_if(b, dgc_vertex_buffer_unchanged(cs, stream_addr, sequence_id));
+   {
+      /* Keep using the descriptors uploaded by a previous sequence. */
+      nir_store_var(b, cs->upload_offset, nir_iadd(b, nir_load_var(b, cs->upload_offset), nir_imul_imm(b, vbo_cnt, 16)),
+                    0x1);
+   }
+   nir_push_else(b, NULL);
+   {
+      dgc_emit_vertex_buffer_descriptors(cs, stream_addr, vb_desc_usage_mask, vbo_cnt);
+   }
+   nir_pop_if(b, NULL);
+}
+
 /**
  * Compute dispatch
  */
@@ -2751,7 +2860,7 @@ dgc_emit_one_sequence_main(struct dgc_cmdbuf *cs, nir_def *sequence_id, nir_def
    } else {
       /* Graphics */
       if (layout->vk.dgc_info & BITFIELD_BIT(MESA_VK_DGC_VB)) {
-         dgc_emit_vertex_buffer(cs, stream_addr);
+         dgc_emit_vertex_buffer(cs, stream_addr, sequence_id);
       }
 
       if (layout->vk.dgc_info & BITFIELD_BIT(MESA_VK_DGC_DRAW_INDEXED)) {
@@ -82,6 +82,7 @@ static const struct debug_control radv_debug_options[] = {
    {"nir", RADV_DEBUG_DUMP_NIR},
    {"asm", RADV_DEBUG_DUMP_ASM},
    {"ir", RADV_DEBUG_DUMP_BACKEND_IR},
+   {"blockstats", RADV_DEBUG_DUMP_BLOCK_STATS},
    {"pso_history", RADV_DEBUG_PSO_HISTORY},
    {"bvh4", RADV_DEBUG_BVH4},
    {"novideo", RADV_DEBUG_NO_VIDEO},
@@ -91,6 +92,7 @@ static const struct debug_control radv_debug_options[] = {
    {"dumpibs", RADV_DEBUG_DUMP_IBS},
    {"vm", RADV_DEBUG_VM},
    {"nosmemmitigation", RADV_DEBUG_NO_SMEM_MITIGATION},
+   {"nofastcompile", RADV_DEBUG_NO_FAST_COMPILE},
    {NULL, 0},
 };
 
@@ -125,6 +127,8 @@ static const struct debug_control radv_perftest_options[] = {
    {"hic", RADV_PERFTEST_HIC},
    {"sparse", RADV_PERFTEST_SPARSE},
    {"rtcps", RADV_PERFTEST_RT_CPS},
+   {"parallelstages", RADV_PERFTEST_PARALLEL_STAGES},
+   {"nodmashaders", RADV_PERFTEST_NO_DMA_SHADERS},
    {NULL, 0},
 };
 
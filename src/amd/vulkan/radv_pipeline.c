@@ -325,6 +325,7 @@ radv_postprocess_nir(struct radv_device *device, const struct radv_graphics_stat
             .types = lower_non_uniform_access_types,
             .callback = &non_uniform_access_callback,
             .callback_data = NULL,
+            .uniform_fast_path = !stage->key.optimisations_disabled,
          };
          NIR_PASS(_, stage->nir, nir_lower_non_uniform_access, &options);
       }
@@ -2127,6 +2127,8 @@ radv_generate_graphics_pipeline_key(const struct radv_device *device, const VkGr
                                     const struct vk_graphics_pipeline_state *state,
                                     VkGraphicsPipelineLibraryFlagBitsEXT lib_flags)
 {
+   const struct radv_physical_device *pdev = radv_device_physical(device);
+   const struct radv_instance *instance = radv_physical_device_instance(pdev);
    VkPipelineCreateFlags2 create_flags = vk_graphics_pipeline_create_flags(pCreateInfo);
    struct radv_graphics_pipeline_key key = {0};
    uint32_t custom_blend_mode = 0;
@@ -2145,6 +2147,15 @@ radv_generate_graphics_pipeline_key(const struct radv_device *device, const VkGr
 
       key.stage_info[s] = radv_pipeline_get_shader_key(device, stage, create_flags, pCreateInfo->pNext);
 
+      /* The binaries of libraries that retain LTO info are only used by fast-linked pipelines,
+       * which the application is expected to replace with LTO pipelines later. Compile them
+       * quickly, the LTO pipelines clear this again when they import the retained shaders.
+       */
+      if ((create_flags & VK_PIPELINE_CREATE_2_LIBRARY_BIT_KHR) &&
+          (create_flags & VK_PIPELINE_CREATE_2_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT) &&
+          !(instance->debug_flags & RADV_DEBUG_NO_FAST_COMPILE))
+         key.stage_info[s].fast_compile = true;
+
       if (s == MESA_SHADER_MESH && (state->shader_stages & VK_SHADER_STAGE_TASK_BIT_EXT))
          key.stage_info[s].has_task_shader = true;
    }
@@ -2448,6 +2459,33 @@ radv_create_gs_copy_shader(struct radv_device *device, struct vk_pipeline_cache
    return copy_shader;
 }
 
+struct radv_shader_compile_job {
+   struct radv_device *device;
+   struct radv_shader_stage *stage;
+   nir_shader *nir_shaders[2];
+   unsigned shader_count;
+   const struct radv_graphics_state_key *gfx_state;
+   bool keep_executable_info;
+   bool keep_statistic_info;
+   bool dump_shader;
+
+   struct radv_shader_binary *binary;
+   int64_t duration;
+   struct util_queue_fence fence;
+};
+
+static void
+radv_shader_compile_job_run(void *data, void *gdata, int thread_index)
+{
+   struct radv_shader_compile_job *job = data;
+   int64_t start = os_time_get_nano();
+
+   job->binary = radv_shader_nir_to_asm(job->device, job->stage, job->nir_shaders, job->shader_count, job->gfx_state,
+                                        job->keep_executable_info, job->keep_statistic_info);
+
+   job->duration = os_time_get_nano() - start;
+}
+
 static void
 radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_cache *cache,
                                  struct radv_shader_stage *stages, const struct radv_graphics_state_key *gfx_state,
@@ -2458,13 +2496,22 @@ radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_
 {
    const struct radv_physical_device *pdev = radv_device_physical(device);
    struct radv_instance *instance = radv_physical_device_instance(pdev);
+   struct radv_shader_compile_job jobs[MESA_VULKAN_SHADER_STAGES];
+   unsigned num_jobs = 0;
 
    for (int s = MESA_VULKAN_SHADER_STAGES - 1; s >= 0; s--) {
       if (!(active_nir_stages & (1 << s)))
          continue;
 
-      nir_shader *nir_shaders[2] = {stages[s].nir, NULL};
-      unsigned shader_count = 1;
+      struct radv_shader_compile_job *job = &jobs[num_jobs++];
+      memset(job, 0, sizeof(*job));
+      job->device = device;
+      job->stage = &stages[s];
+      job->nir_shaders[0] = stages[s].nir;
+      job->shader_count = 1;
+      job->gfx_state = gfx_state;
+      job->keep_executable_info = keep_executable_info;
+      job->keep_statistic_info = keep_statistic_info;
 
       /* On GFX9+, TES is merged with GS and VS is merged with TCS or GS. */
       if (pdev->info.gfx_level >= GFX9 &&
@@ -2479,16 +2526,52 @@ radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_
             pre_stage = MESA_SHADER_VERTEX;
          }
 
-         nir_shaders[0] = stages[pre_stage].nir;
-         nir_shaders[1] = stages[s].nir;
-         shader_count = 2;
+         job->nir_shaders[0] = stages[pre_stage].nir;
+         job->nir_shaders[1] = stages[s].nir;
+         job->shader_count = 2;
       }
 
-      int64_t stage_start = os_time_get_nano();
+      for (unsigned i = 0; i < job->shader_count; ++i)
+         job->dump_shader |= radv_can_dump_shader(device, job->nir_shaders[i]);
 
-      bool dump_shader = false;
-      for (unsigned i = 0; i < shader_count; ++i)
-         dump_shader |= radv_can_dump_shader(device, nir_shaders[i]);
+      active_nir_stages &= ~(1 << job->nir_shaders[0]->info.stage);
+      if (job->nir_shaders[1])
+         active_nir_stages &= ~(1 << job->nir_shaders[1]->info.stage);
+   }
+
+   /* Once the NIR is linked, the stages are independent and the backend can compile them
+    * concurrently. Dumped shaders are compiled sequentially to keep their output together.
+    */
+   bool parallel = num_jobs > 1 && util_queue_is_initialized(&device->shader_compile_queue);
+   for (unsigned i = 0; i < num_jobs; i++) {
+      parallel &= !jobs[i].dump_shader &&
+                  !radv_use_llvm_for_stage(pdev, jobs[i].nir_shaders[jobs[i].shader_count - 1]->info.stage);
+   }
+
+   if (parallel) {
+      for (unsigned i = 1; i < num_jobs; i++) {
+         util_queue_fence_init(&jobs[i].fence);
+         util_queue_add_job(&device->shader_compile_queue, &jobs[i], &jobs[i].fence, radv_shader_compile_job_run,
+                            NULL, 0);
+      }
+
+      radv_shader_compile_job_run(&jobs[0], NULL, 0);
+
+      for (unsigned i = 1; i < num_jobs; i++) {
+         util_queue_fence_wait(&jobs[i].fence);
+         util_queue_fence_destroy(&jobs[i].fence);
+      }
+   }
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      struct radv_shader_compile_job *job = &jobs[i];
+      nir_shader *const *nir_shaders = job->nir_shaders;
+      const unsigned shader_count = job->shader_count;
+      const bool dump_shader = job->dump_shader;
+      const int s = job->stage - stages;
+
+      /* The backend compilation time of parallel jobs still counts for each stage. */
+      int64_t stage_start = os_time_get_nano() - (parallel ? job->duration : 0);
 
       bool dump_nir = dump_shader && (instance->debug_flags & RADV_DEBUG_DUMP_NIR);
 
@@ -2501,8 +2584,9 @@ radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_
          }
       }
 
-      binaries[s] = radv_shader_nir_to_asm(device, &stages[s], nir_shaders, shader_count, gfx_state,
-                                           keep_executable_info, keep_statistic_info);
+      if (!parallel)
+         radv_shader_compile_job_run(job, NULL, 0);
+      binaries[s] = job->binary;
 
       /* Dump NIR after nir_to_asm, because ACO modifies it. */
       char *nir_string = NULL;
@@ -2526,10 +2610,6 @@ radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_
       }
 
       stages[s].feedback.duration += os_time_get_nano() - stage_start;
-
-      active_nir_stages &= ~(1 << nir_shaders[0]->info.stage);
-      if (nir_shaders[1])
-         active_nir_stages &= ~(1 << nir_shaders[1]->info.stage);
    }
 }
 
@@ -2621,6 +2701,12 @@ radv_pipeline_load_retained_shaders(const struct radv_device *device, const VkGr
 
       radv_pipeline_import_retained_shaders(device, gfx_pipeline_lib, stages);
    }
+
+   /* Link-time optimized pipelines are the final variants, use all optimizations. */
+   if (create_flags & VK_PIPELINE_CREATE_2_LINK_TIME_OPTIMIZATION_BIT_EXT) {
+      for (uint32_t s = 0; s < MESA_VULKAN_SHADER_STAGES; s++)
+         stages[s].key.fast_compile = false;
+   }
 }
 
 static unsigned
@@ -93,7 +93,10 @@ struct radv_shader_stage_key {
    /* Whether the shader is used with indirect pipeline binds. */
    uint8_t indirect_bindable : 1;
 
-   uint32_t reserved : 17;
+   /* Whether the shader is only used until a fully optimized variant replaces it. */
+   uint8_t fast_compile : 1;
+
+   uint32_t reserved : 16;
 };
 
 struct radv_ps_epilog_key {
@@ -193,6 +196,7 @@ struct radv_nir_compiler_options {
    bool record_asm;
    bool record_ir;
    bool record_stats;
+   bool dump_block_stats;
    bool check_ir;
    uint8_t enable_mrt_output_nan_fixup;
    bool wgp_mode;
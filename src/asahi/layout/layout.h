@@ -388,6 +388,22 @@ void ail_tile(void *_tiled, void *_linear,
               unsigned linear_pitch_B, unsigned sx_px, unsigned sy_px,
               unsigned width_px, unsigned height_px);
 
+/*
+ * Like ail_detile/ail_tile, but large copies are split across up to
+ * max_threads threads, including the calling thread.
+ */
+void ail_detile_threaded(void *_tiled, void *_linear,
+                         const struct ail_layout *tiled_layout, unsigned level,
+                         unsigned linear_pitch_B, unsigned sx_px,
+                         unsigned sy_px, unsigned width_px, unsigned height_px,
+                         unsigned max_threads);
+
+void ail_tile_threaded(void *_tiled, void *_linear,
+                       const struct ail_layout *tiled_layout, unsigned level,
+                       unsigned linear_pitch_B, unsigned sx_px, unsigned sy_px,
+                       unsigned width_px, unsigned height_px,
+                       unsigned max_threads);
+
 /* Define aliases for the subset formats that are accessible in the ISA. These
  * subsets disregard component mapping and number of components. This
  * constitutes ABI with the compiler.
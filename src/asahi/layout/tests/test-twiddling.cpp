@@ -8,6 +8,7 @@
 #include "layout.h"
 
 #include "util/format/u_format.h"
+#include "util/os_time.h"
 #include <gtest/gtest.h>
 
 /*
@@ -255,3 +256,122 @@ TEST(Twiddling, PartialASTC)
    test_ldst(50, 40, 5, 4, 10, 8, 512, PIPE_FORMAT_ASTC_5x4);
    test_ldst(50, 50, 5, 5, 10, 10, 512, PIPE_FORMAT_ASTC_5x5);
 }
+
+/*
+ * Threaded copies must match the single threaded ones byte for byte. Use a
+ * region large enough to actually be split, with unaligned edges.
+ */
+static void
+test_threaded(unsigned width, unsigned height, unsigned rx, unsigned ry,
+              unsigned rw, unsigned rh, enum pipe_format format)
+{
+   unsigned linear_stride = util_format_get_stride(format, rw);
+   unsigned size_B = util_format_get_nblocksy(format, rh) * linear_stride;
+   struct ail_layout layout = {
+      .width_px = width,
+      .height_px = height,
+      .depth_px = 1,
+      .sample_count_sa = 1,
+      .levels = 1,
+      .tiling = AIL_TILING_GPU,
+      .format = format,
+   };
+
+   ail_make_miptree(&layout);
+
+   uint8_t *linear = (uint8_t *)malloc(size_B);
+   uint8_t *tiled = (uint8_t *)calloc(1, layout.size_B);
+   uint8_t *tiled_ref = (uint8_t *)calloc(1, layout.size_B);
+   uint8_t *detiled = (uint8_t *)calloc(1, size_B);
+
+   for (unsigned i = 0; i < size_B; ++i) {
+      linear[i] = (i * 7 + i / 251) & 0xFF;
+   }
+
+   ail_tile(tiled_ref, linear, &layout, 0, linear_stride, rx, ry, rw, rh);
+   ail_tile_threaded(tiled, linear, &layout, 0, linear_stride, rx, ry, rw, rh,
+                     4);
+   EXPECT_EQ(memcmp(tiled_ref, tiled, layout.size_B), 0);
+
+   ail_detile_threaded(tiled, detiled, &layout, 0, linear_stride, rx, ry, rw,
+                       rh, 4);
+   EXPECT_EQ(memcmp(linear, detiled, size_B), 0);
+
+   free(detiled);
+   free(tiled_ref);
+   free(tiled);
+   free(linear);
+}
+
+TEST(Twiddling, Threaded)
+{
+   test_threaded(2051, 2047, 3, 5, 2045, 2037, PIPE_FORMAT_R8_UNORM);
+   test_threaded(2051, 2047, 3, 5, 2045, 2037, PIPE_FORMAT_R8G8B8A8_UNORM);
+   test_threaded(2051, 2047, 3, 5, 2045, 2037, PIPE_FORMAT_R32G32B32A32_UINT);
+   test_threaded(2048, 2048, 0, 0, 2048, 2048, PIPE_FORMAT_ETC2_RGB8);
+}
+
+/*
+ * Throughput of the tiling routines, not run by default. Use
+ * --gtest_also_run_disabled_tests --gtest_filter=*Throughput to run it.
+ */
+static void
+bench(enum pipe_format format, unsigned size, unsigned threads)
+{
+   const unsigned iterations = 10;
+   unsigned bpp = util_format_get_blocksize(format);
+   unsigned linear_stride = size * bpp;
+   struct ail_layout layout = {
+      .width_px = size,
+      .height_px = size,
+      .depth_px = 1,
+      .sample_count_sa = 1,
+      .levels = 1,
+      .tiling = AIL_TILING_GPU,
+      .format = format,
+   };
+
+   ail_make_miptree(&layout);
+
+   uint8_t *linear = (uint8_t *)calloc(size, linear_stride);
+   uint8_t *tiled = (uint8_t *)calloc(1, layout.size_B);
+   double mb = (double)size * linear_stride / (1024 * 1024);
+
+   for (unsigned store = 0; store < 2; ++store) {
+      int64_t start = os_time_get_nano();
+
+      for (unsigned i = 0; i < iterations; ++i) {
+         if (store) {
+            ail_tile_threaded(tiled, linear, &layout, 0, linear_stride, 0, 0,
+                              size, size, threads);
+         } else {
+            ail_detile_threaded(tiled, linear, &layout, 0, linear_stride, 0,
+                                0, size, size, threads);
+         }
+      }
+
+      double secs = (os_time_get_nano() - start) / 1e9;
+      printf("%-20s %2u B %-7s %2u threads: %8.1f MB/s\n",
+             util_format_short_name(format), bpp, store ? "tile" : "detile",
+             threads, mb * iterations / secs);
+   }
+
+   free(tiled);
+   free(linear);
+}
+
+TEST(Twiddling, DISABLED_Throughput)
+{
+   const enum pipe_format formats[] = {
+      PIPE_FORMAT_R8_UNORM,
+      PIPE_FORMAT_R8G8_UNORM,
+      PIPE_FORMAT_R8G8B8A8_UNORM,
+      PIPE_FORMAT_R16G16B16A16_UNORM,
+      PIPE_FORMAT_R32G32B32A32_UINT,
+   };
+
+   for (unsigned i = 0; i < ARRAY_SIZE(formats); ++i) {
+      bench(formats[i], 4096, 1);
+      bench(formats[i], 4096, 4);
+   }
+}
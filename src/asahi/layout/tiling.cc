@@ -9,9 +9,16 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "c11/threads.h"
+#include "util/detect_arch.h"
 #include "util/macros.h"
 #include "layout.h"
 
+#if DETECT_ARCH_AARCH64
+#include <arm_neon.h>
+#endif
+
 /* Z-order with rectangular (NxN or 2NxN) tiles, at most 128x128:
  *
  * 	[y6][x6][y5][x5][y4][x4]y3][x3][y2][x2][y1][x1][y0][x0]
@@ -56,18 +63,13 @@ ail_space_mask(unsigned x)
 }
 
 template <typename T, bool is_store>
-void
+static void
 memcpy_small(void *_tiled, void *_linear, const struct ail_layout *tiled_layout,
-             unsigned level, unsigned linear_pitch_B, unsigned sx_px,
-             unsigned sy_px, unsigned swidth_px, unsigned sheight_px)
+             unsigned level, unsigned linear_pitch_B, unsigned sx_el,
+             unsigned sy_el, unsigned swidth_el, unsigned sheight_el)
 {
-   enum pipe_format format = tiled_layout->format;
    unsigned linear_pitch_el = linear_pitch_B / sizeof(T);
    unsigned stride_el = tiled_layout->stride_el[level];
-   unsigned sx_el = util_format_get_nblocksx(format, sx_px);
-   unsigned sy_el = util_format_get_nblocksy(format, sy_px);
-   unsigned swidth_el = util_format_get_nblocksx(format, swidth_px);
-   unsigned sheight_el = util_format_get_nblocksy(format, sheight_px);
    unsigned sx_end_el = sx_el + swidth_el;
    unsigned sy_end_el = sy_el + sheight_el;
 
@@ -113,27 +115,260 @@ memcpy_small(void *_tiled, void *_linear, const struct ail_layout *tiled_layout,
    }
 }
 
+/*
+ * The low 2 bits of X and Y select an element within an aligned 4x4 block,
+ * which is therefore contiguous in the tiled image, as long as the tile is at
+ * least 4x4. Each row of the block is made of two pairs of adjacent elements:
+ *
+ * 	row 0: 0 1 4 5
+ * 	row 1: 2 3 6 7
+ * 	row 2: 8 9 c d
+ * 	row 3: a b e f
+ *
+ * so the block can be moved with a handful of wide loads and stores, and
+ * NEON's de-interleaving loads split it into rows directly.
+ */
+template <typename T, bool is_store>
+static inline void
+copy_block(T *tiled, T *linear, unsigned linear_pitch_el)
+{
+   for (unsigned r = 0; r < 4; ++r) {
+      T *tiled_row = tiled + ((r & 1) << 1) + ((r >> 1) << 3);
+      T *linear_row = linear + r * linear_pitch_el;
+
+      if (is_store) {
+         memcpy(tiled_row, linear_row, 2 * sizeof(T));
+         memcpy(tiled_row + 4, linear_row + 2, 2 * sizeof(T));
+      } else {
+         memcpy(linear_row, tiled_row, 2 * sizeof(T));
+         memcpy(linear_row + 2, tiled_row + 4, 2 * sizeof(T));
+      }
+   }
+}
+
+#if DETECT_ARCH_AARCH64
+template <>
+inline void
+copy_block<uint8_t, false>(uint8_t *tiled, uint8_t *linear,
+                           unsigned linear_pitch_el)
+{
+   /* Pairs of texels are u16: even pairs are rows 0 and 2, odd pairs rows 1
+    * and 3.
+    */
+   uint16x4x2_t pairs = vld2_u16((const uint16_t *)tiled);
+   uint32x2_t even = vreinterpret_u32_u16(pairs.val[0]);
+   uint32x2_t odd = vreinterpret_u32_u16(pairs.val[1]);
+
+   vst1_lane_u32((uint32_t *)(linear + 0 * linear_pitch_el), even, 0);
+   vst1_lane_u32((uint32_t *)(linear + 1 * linear_pitch_el), odd, 0);
+   vst1_lane_u32((uint32_t *)(linear + 2 * linear_pitch_el), even, 1);
+   vst1_lane_u32((uint32_t *)(linear + 3 * linear_pitch_el), odd, 1);
+}
+
+template <>
+inline void
+copy_block<uint8_t, true>(uint8_t *tiled, uint8_t *linear,
+                          unsigned linear_pitch_el)
+{
+   uint32x2_t even = vdup_n_u32(0), odd = vdup_n_u32(0);
+
+   even = vld1_lane_u32((const uint32_t *)(linear + 0 * linear_pitch_el), even, 0);
+   odd = vld1_lane_u32((const uint32_t *)(linear + 1 * linear_pitch_el), odd, 0);
+   even = vld1_lane_u32((const uint32_t *)(linear + 2 * linear_pitch_el), even, 1);
+   odd = vld1_lane_u32((const uint32_t *)(linear + 3 * linear_pitch_el), odd, 1);
+
+   uint16x4x2_t pairs = {{vreinterpret_u16_u32(even), vreinterpret_u16_u32(odd)}};
+   vst2_u16((uint16_t *)tiled, pairs);
+}
+
+template <>
+inline void
+copy_block<uint16_t, false>(uint16_t *tiled, uint16_t *linear,
+                            unsigned linear_pitch_el)
+{
+   uint32x4x2_t pairs = vld2q_u32((const uint32_t *)tiled);
+
+   vst1_u32((uint32_t *)(linear + 0 * linear_pitch_el),
+            vget_low_u32(pairs.val[0]));
+   vst1_u32((uint32_t *)(linear + 1 * linear_pitch_el),
+            vget_low_u32(pairs.val[1]));
+   vst1_u32((uint32_t *)(linear + 2 * linear_pitch_el),
+            vget_high_u32(pairs.val[0]));
+   vst1_u32((uint32_t *)(linear + 3 * linear_pitch_el),
+            vget_high_u32(pairs.val[1]));
+}
+
+template <>
+inline void
+copy_block<uint16_t, true>(uint16_t *tiled, uint16_t *linear,
+                           unsigned linear_pitch_el)
+{
+   uint32x4x2_t pairs = {{
+      vcombine_u32(vld1_u32((const uint32_t *)(linear + 0 * linear_pitch_el)),
+                   vld1_u32((const uint32_t *)(linear + 2 * linear_pitch_el))),
+      vcombine_u32(vld1_u32((const uint32_t *)(linear + 1 * linear_pitch_el)),
+                   vld1_u32((const uint32_t *)(linear + 3 * linear_pitch_el))),
+   }};
+
+   vst2q_u32((uint32_t *)tiled, pairs);
+}
+
+template <>
+inline void
+copy_block<uint32_t, false>(uint32_t *tiled, uint32_t *linear,
+                            unsigned linear_pitch_el)
+{
+   uint64x2x2_t top = vld2q_u64((const uint64_t *)tiled);
+   uint64x2x2_t bottom = vld2q_u64((const uint64_t *)(tiled + 8));
+
+   vst1q_u64((uint64_t *)(linear + 0 * linear_pitch_el), top.val[0]);
+   vst1q_u64((uint64_t *)(linear + 1 * linear_pitch_el), top.val[1]);
+   vst1q_u64((uint64_t *)(linear + 2 * linear_pitch_el), bottom.val[0]);
+   vst1q_u64((uint64_t *)(linear + 3 * linear_pitch_el), bottom.val[1]);
+}
+
+template <>
+inline void
+copy_block<uint32_t, true>(uint32_t *tiled, uint32_t *linear,
+                           unsigned linear_pitch_el)
+{
+   uint64x2x2_t top = {{
+      vld1q_u64((const uint64_t *)(linear + 0 * linear_pitch_el)),
+      vld1q_u64((const uint64_t *)(linear + 1 * linear_pitch_el)),
+   }};
+   uint64x2x2_t bottom = {{
+      vld1q_u64((const uint64_t *)(linear + 2 * linear_pitch_el)),
+      vld1q_u64((const uint64_t *)(linear + 3 * linear_pitch_el)),
+   }};
+
+   vst2q_u64((uint64_t *)tiled, top);
+   vst2q_u64((uint64_t *)(tiled + 8), bottom);
+}
+#endif
+
+/*
+ * Copy a region whose origin and size are multiples of 4 elements, one 4x4
+ * block at a time.
+ */
+template <typename T, bool is_store>
+static void
+memcpy_blocks(void *_tiled, void *_linear,
+              const struct ail_layout *tiled_layout, unsigned level,
+              unsigned linear_pitch_B, unsigned sx_el, unsigned sy_el,
+              unsigned swidth_el, unsigned sheight_el)
+{
+   unsigned linear_pitch_el = linear_pitch_B / sizeof(T);
+   unsigned stride_el = tiled_layout->stride_el[level];
+   unsigned sx_end_el = sx_el + swidth_el;
+   unsigned sy_end_el = sy_el + sheight_el;
+
+   struct ail_tile tile_size = tiled_layout->tilesize_el[level];
+   unsigned tile_area_el = tile_size.width_el * tile_size.height_el;
+   unsigned tiles_per_row = DIV_ROUND_UP(stride_el, tile_size.width_el);
+   unsigned x_offs_start_el =
+      ail_space_bits(MOD_POT(sx_el, tile_size.width_el));
+   unsigned space_mask_x = ail_space_mask(tile_size.width_el);
+   unsigned log2_tile_width_el = util_logbase2(tile_size.width_el);
+   unsigned log2_tile_height_el = util_logbase2(tile_size.height_el);
+
+   T *linear = (T *)_linear;
+   T *tiled = (T *)_tiled;
+
+   for (unsigned y_el = sy_el; y_el < sy_end_el; y_el += 4) {
+      unsigned y_tile = (y_el >> log2_tile_height_el) * tiles_per_row;
+      unsigned y_offs_el =
+         ail_space_bits(MOD_POT(y_el, tile_size.height_el)) << 1;
+      unsigned x_offs_el = x_offs_start_el;
+
+      T *linear_block = linear;
+
+      for (unsigned x_el = sx_el; x_el < sx_end_el; x_el += 4) {
+         unsigned tile_idx = (y_tile + (x_el >> log2_tile_width_el));
+         unsigned tile_offset_el = tile_idx * tile_area_el;
+
+         copy_block<T, is_store>(&tiled[tile_offset_el + y_offs_el + x_offs_el],
+                                 linear_block, linear_pitch_el);
+         linear_block += 4;
+
+         /* Same increment as in memcpy_small, but by 4 elements: the bottom
+          * two X bits are always 0, so fill the holes and add bit 2 of X.
+          */
+         x_offs_el = (x_offs_el + ~space_mask_x + 16) & space_mask_x;
+      }
+
+      linear += 4 * linear_pitch_el;
+   }
+}
+
+template <typename T, bool is_store>
+static void
+memcpy_region(void *_tiled, void *_linear,
+              const struct ail_layout *tiled_layout, unsigned level,
+              unsigned linear_pitch_B, unsigned sx_el, unsigned sy_el,
+              unsigned swidth_el, unsigned sheight_el)
+{
+   struct ail_tile tile_size = tiled_layout->tilesize_el[level];
+   unsigned sx_end_el = sx_el + swidth_el;
+   unsigned sy_end_el = sy_el + sheight_el;
+   unsigned ax_el = ALIGN_POT(sx_el, 4), ax_end_el = ROUND_DOWN_TO(sx_end_el, 4);
+   unsigned ay_el = ALIGN_POT(sy_el, 4), ay_end_el = ROUND_DOWN_TO(sy_end_el, 4);
+
+   if (tile_size.width_el < 4 || tile_size.height_el < 4 ||
+       ax_el >= ax_end_el || ay_el >= ay_end_el) {
+      memcpy_small<T, is_store>(_tiled, _linear, tiled_layout, level,
+                                linear_pitch_B, sx_el, sy_el, swidth_el,
+                                sheight_el);
+      return;
+   }
+
+   uint8_t *linear = (uint8_t *)_linear;
+   uint8_t *linear_ay = linear + (ay_el - sy_el) * linear_pitch_B;
+
+   /* Unaligned rows at the top and bottom, then unaligned columns on either
+    * side of the aligned interior.
+    */
+   memcpy_small<T, is_store>(_tiled, linear, tiled_layout, level,
+                             linear_pitch_B, sx_el, sy_el, swidth_el,
+                             ay_el - sy_el);
+   memcpy_small<T, is_store>(_tiled,
+                             linear + (ay_end_el - sy_el) * linear_pitch_B,
+                             tiled_layout, level, linear_pitch_B, sx_el,
+                             ay_end_el, swidth_el, sy_end_el - ay_end_el);
+   memcpy_small<T, is_store>(_tiled, linear_ay, tiled_layout, level,
+                             linear_pitch_B, sx_el, ay_el, ax_el - sx_el,
+                             ay_end_el - ay_el);
+   memcpy_small<T, is_store>(_tiled,
+                             linear_ay + (ax_end_el - sx_el) * sizeof(T),
+                             tiled_layout, level, linear_pitch_B, ax_end_el,
+                             ay_el, sx_end_el - ax_end_el, ay_end_el - ay_el);
+
+   memcpy_blocks<T, is_store>(_tiled,
+                              linear_ay + (ax_el - sx_el) * sizeof(T),
+                              tiled_layout, level, linear_pitch_B, ax_el,
+                              ay_el, ax_end_el - ax_el, ay_end_el - ay_el);
+}
+
 #define TILED_UNALIGNED_TYPES(blocksize_B, store)                              \
    if (blocksize_B == 1) {                                                     \
-      memcpy_small<uint8_t, store>(_tiled, _linear, tiled_layout, level,       \
-                                   linear_pitch_B, sx_px, sy_px, swidth_px,    \
-                                   sheight_px);                                \
+      memcpy_region<uint8_t, store>(_tiled, _linear, tiled_layout, level,      \
+                                    linear_pitch_B, sx_el, sy_el, swidth_el,   \
+                                    sheight_el);                               \
    } else if (blocksize_B == 2) {                                              \
-      memcpy_small<uint16_t, store>(_tiled, _linear, tiled_layout, level,      \
-                                    linear_pitch_B, sx_px, sy_px, swidth_px,   \
-                                    sheight_px);                               \
+      memcpy_region<uint16_t, store>(_tiled, _linear, tiled_layout, level,     \
+                                     linear_pitch_B, sx_el, sy_el, swidth_el,  \
+                                     sheight_el);                              \
    } else if (blocksize_B == 4) {                                              \
-      memcpy_small<uint32_t, store>(_tiled, _linear, tiled_layout, level,      \
-                                    linear_pitch_B, sx_px, sy_px, swidth_px,   \
-                                    sheight_px);                               \
+      memcpy_region<uint32_t, store>(_tiled, _linear, tiled_layout, level,     \
+                                     linear_pitch_B, sx_el, sy_el, swidth_el,  \
+                                     sheight_el);                              \
    } else if (blocksize_B == 8) {                                              \
-      memcpy_small<uint64_t, store>(_tiled, _linear, tiled_layout, level,      \
-                                    linear_pitch_B, sx_px, sy_px, swidth_px,   \
-                                    sheight_px);                               \
+      memcpy_region<uint64_t, store>(_tiled, _linear, tiled_layout, level,     \
+                                     linear_pitch_B, sx_el, sy_el, swidth_el,  \
+                                     sheight_el);                              \
    } else if (blocksize_B == 16) {                                             \
-      memcpy_small<ail_uint128_t, store>(_tiled, _linear, tiled_layout, level, \
-                                         linear_pitch_B, sx_px, sy_px,         \
-                                         swidth_px, sheight_px);               \
+      memcpy_region<ail_uint128_t, store>(_tiled, _linear, tiled_layout,       \
+                                          level, linear_pitch_B, sx_el, sy_el, \
+                                          swidth_el, sheight_el);              \
    } else {                                                                    \
       UNREACHABLE("Invalid block size");                                       \
    }
@@ -146,6 +381,11 @@ ail_detile(void *_tiled, void *_linear, const struct ail_layout *tiled_layout,
    unsigned width_px = u_minify(tiled_layout->width_px, level);
    unsigned height_px = u_minify(tiled_layout->height_px, level);
    unsigned blocksize_B = util_format_get_blocksize(tiled_layout->format);
+   enum pipe_format format = tiled_layout->format;
+   unsigned sx_el = util_format_get_nblocksx(format, sx_px);
+   unsigned sy_el = util_format_get_nblocksy(format, sy_px);
+   unsigned swidth_el = util_format_get_nblocksx(format, swidth_px);
+   unsigned sheight_el = util_format_get_nblocksy(format, sheight_px);
 
    assert(level < tiled_layout->levels && "Mip level out of bounds");
    assert(ail_is_level_twiddled_uncompressed(tiled_layout, level) &&
@@ -164,6 +404,11 @@ ail_tile(void *_tiled, void *_linear, const struct ail_layout *tiled_layout,
    unsigned width_px = u_minify(tiled_layout->width_px, level);
    unsigned height_px = u_minify(tiled_layout->height_px, level);
    unsigned blocksize_B = ail_get_blocksize_B(tiled_layout);
+   enum pipe_format format = tiled_layout->format;
+   unsigned sx_el = util_format_get_nblocksx(format, sx_px);
+   unsigned sy_el = util_format_get_nblocksy(format, sy_px);
+   unsigned swidth_el = util_format_get_nblocksx(format, swidth_px);
+   unsigned sheight_el = util_format_get_nblocksy(format, sheight_px);
 
    assert(level < tiled_layout->levels && "Mip level out of bounds");
    assert(ail_is_level_twiddled_uncompressed(tiled_layout, level) &&
@@ -173,3 +418,143 @@ ail_tile(void *_tiled, void *_linear, const struct ail_layout *tiled_layout,
 
    TILED_UNALIGNED_TYPES(blocksize_B, true);
 }
+
+/* Large copies are split into bands of whole tile rows, one per thread. Below
+ * this size per thread the thread creation overhead outweighs the gain.
+ */
+#define TILING_THREAD_MIN_SIZE_B (1024 * 1024)
+#define TILING_MAX_THREADS 8
+
+struct tiling_band {
+   bool is_store;
+   void *tiled;
+   uint8_t *linear;
+   const struct ail_layout *tiled_layout;
+   unsigned level;
+   unsigned linear_pitch_B;
+   unsigned sx_px, sy_px;
+   unsigned swidth_px, sheight_px;
+};
+
+static int
+tiling_band_run(void *data)
+{
+   const struct tiling_band *band = (const struct tiling_band *)data;
+
+   if (band->is_store) {
+      ail_tile(band->tiled, band->linear, band->tiled_layout, band->level,
+               band->linear_pitch_B, band->sx_px, band->sy_px,
+               band->swidth_px, band->sheight_px);
+   } else {
+      ail_detile(band->tiled, band->linear, band->tiled_layout, band->level,
+                 band->linear_pitch_B, band->sx_px, band->sy_px,
+                 band->swidth_px, band->sheight_px);
+   }
+
+   return 0;
+}
+
+static void
+tiling_threaded(const struct tiling_band *copy, unsigned max_threads)
+{
+   const struct ail_layout *layout = copy->tiled_layout;
+   unsigned blockheight_px = util_format_get_blockheight(layout->format);
+   unsigned row_height_px =
+      layout->tilesize_el[copy->level].height_el * blockheight_px;
+   unsigned sy_end_px = copy->sy_px + copy->sheight_px;
+   unsigned first_row = copy->sy_px / row_height_px;
+   unsigned rows = DIV_ROUND_UP(sy_end_px, row_height_px) - first_row;
+   uint64_t size_B = (uint64_t)copy->sheight_px / blockheight_px *
+                     util_format_get_stride(layout->format, copy->swidth_px);
+
+   unsigned num_threads = MIN2(max_threads, TILING_MAX_THREADS);
+   num_threads = MIN2(num_threads, size_B / TILING_THREAD_MIN_SIZE_B);
+   num_threads = MIN2(num_threads, rows);
+
+   if (num_threads <= 1) {
+      tiling_band_run((void *)copy);
+      return;
+   }
+
+   struct tiling_band bands[TILING_MAX_THREADS];
+   thrd_t threads[TILING_MAX_THREADS];
+   bool spawned[TILING_MAX_THREADS] = {};
+
+   unsigned y_px = copy->sy_px;
+   for (unsigned i = 0; i < num_threads; i++) {
+      unsigned band_end_px =
+         i == num_threads - 1
+            ? sy_end_px
+            : (first_row + rows * (i + 1) / num_threads) * row_height_px;
+
+      bands[i] = *copy;
+      bands[i].sy_px = y_px;
+      bands[i].sheight_px = band_end_px - y_px;
+      bands[i].linear = copy->linear + ((y_px - copy->sy_px) / blockheight_px) *
+                                          copy->linear_pitch_B;
+      y_px = band_end_px;
+   }
+
+   /* The calling thread takes the first band. If a thread can't be created,
+    * its band is copied inline instead.
+    */
+   for (unsigned i = 1; i < num_threads; i++) {
+      spawned[i] =
+         thrd_create(&threads[i], tiling_band_run, &bands[i]) == thrd_success;
+   }
+
+   tiling_band_run(&bands[0]);
+
+   for (unsigned i = 1; i < num_threads; i++) {
+      if (spawned[i])
+         thrd_join(threads[i], NULL);
+      else
+         tiling_band_run(&bands[i]);
+   }
+}
+
+void
+ail_detile_threaded(void *_tiled, void *_linear,
+                    const struct ail_layout *tiled_layout, unsigned level,
+                    unsigned linear_pitch_B, unsigned sx_px, unsigned sy_px,
+                    unsigned swidth_px, unsigned sheight_px,
+                    unsigned max_threads)
+{
+   const struct tiling_band copy = {
+      .is_store = false,
+      .tiled = _tiled,
+      .linear = (uint8_t *)_linear,
+      .tiled_layout = tiled_layout,
+      .level = level,
+      .linear_pitch_B = linear_pitch_B,
+      .sx_px = sx_px,
+      .sy_px = sy_px,
+      .swidth_px = swidth_px,
+      .sheight_px = sheight_px,
+   };
+
+   tiling_threaded(&copy, max_threads);
+}
+
+void
+ail_tile_threaded(void *_tiled, void *_linear,
+                  const struct ail_layout *tiled_layout, unsigned level,
+                  unsigned linear_pitch_B, unsigned sx_px, unsigned sy_px,
+                  unsigned swidth_px, unsigned sheight_px,
+                  unsigned max_threads)
+{
+   const struct tiling_band copy = {
+      .is_store = true,
+      .tiled = _tiled,
+      .linear = (uint8_t *)_linear,
+      .tiled_layout = tiled_layout,
+      .level = level,
+      .linear_pitch_B = linear_pitch_B,
+      .sx_px = sx_px,
+      .sy_px = sy_px,
+      .swidth_px = swidth_px,
+      .sheight_px = sheight_px,
+   };
+
+   tiling_threaded(&copy, max_threads);
+}
@@ -61,6 +61,12 @@ hk_device_init_meta(struct hk_device *dev)
    if (result != VK_SUCCESS)
       return result;
 
+   result = vk_meta_device_init_pipeline_cache(&dev->vk, &dev->meta);
+   if (result != VK_SUCCESS) {
+      vk_meta_device_finish(&dev->vk, &dev->meta);
+      return result;
+   }
+
    dev->meta.use_gs_for_layer = false;
    dev->meta.use_stencil_export = true;
    dev->meta.use_rect_list_pipeline = true;
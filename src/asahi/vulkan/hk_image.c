@@ -11,6 +11,7 @@
 #include "util/format/u_format.h"
 #include "util/format/u_formats.h"
 #include "util/macros.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_math.h"
 #include "vulkan/vulkan_core.h"
 
@@ -1454,8 +1455,9 @@ hk_copy_memory_to_image(struct hk_device *device, struct hk_image *dst_image,
                    src + src_pitch * y, extent.width * blocksize_B);
          }
       } else {
-         ail_tile(dst, (void *)src, layout, level, src_pitch, offset.x,
-                  offset.y, extent.width, extent.height);
+         ail_tile_threaded(dst, (void *)src, layout, level, src_pitch,
+                           offset.x, offset.y, extent.width, extent.height,
+                           util_get_cpu_caps()->nr_cpus);
       }
    }
 }
@@ -1536,8 +1538,10 @@ hk_copy_image_to_memory(struct hk_device *device, struct hk_image *src_image,
                    extent.width * blocksize_B);
          }
       } else {
-         ail_detile((void *)src, dst, layout, info->imageSubresource.mipLevel,
-                    dst_pitch, offset.x, offset.y, extent.width, extent.height);
+         ail_detile_threaded((void *)src, dst, layout,
+                             info->imageSubresource.mipLevel, dst_pitch,
+                             offset.x, offset.y, extent.width, extent.height,
+                             util_get_cpu_caps()->nr_cpus);
       }
    }
 }
@@ -765,6 +765,14 @@ struct v3d_compile {
         bool disable_general_tmu_sched;
         bool has_general_tmu_load;
 
+        /* Maximum number of temps live at the same time and number of
+         * registers available to hold them, as seen by the last register
+         * allocation attempt before any spilling. Used to skip compile
+         * strategies that can't reduce register pressure enough.
+         */
+        uint32_t max_reg_pressure;
+        uint32_t reg_pressure_limit;
+
         /* Minimum number of threads we are willing to use to register allocate
          * a shader with the current compilation strategy. This only prevents
          * us from lowering the thread count to register allocate successfully,
@@ -2054,6 +2054,20 @@ skip_compile_strategy(struct v3d_compile *c, uint32_t idx)
            return false;
    }
 
+   /* Most strategies only trim register pressure a little. If the previous
+    * attempt needed more than twice the registers we have, don't waste a
+    * full compile on them and move on to lowering the thread count, or
+    * after that to keeping the compile we have. Lowering the thread count
+    * and disabling loop unrolling can reduce pressure by any amount, so we
+    * don't skip those.
+    */
+   if (idx != 3 && idx != 6 && idx != 9 &&
+       (c->threads == 4 ||
+        c->compilation_result == V3D_COMPILATION_SUCCEEDED) &&
+       c->max_reg_pressure > 2 * c->reg_pressure_limit) {
+           return true;
+   }
+
    switch (idx) {
    /* General TMU sched.: skip if we didn't emit any TMU loads */
    case 1:
@@ -1386,6 +1386,42 @@ flag_program_end_nodes(struct v3d_compile *c)
         }
 }
 
+/**
+ * Computes the maximum number of temps that are live at the same time. Since
+ * temps interfere if their live intervals overlap, this is the minimum
+ * number of registers needed to allocate the program without spilling.
+ */
+static uint32_t
+compute_max_reg_pressure(struct v3d_compile *c)
+{
+        int32_t max_ip = 0;
+        for (uint32_t i = 0; i < c->num_temps; i++) {
+                if (c->temp_start[i] <= c->temp_end[i])
+                        max_ip = MAX2(max_ip, c->temp_end[i]);
+        }
+
+        int32_t *delta = rzalloc_array(c, int32_t, max_ip + 1);
+        if (!delta)
+                return 0;
+
+        for (uint32_t i = 0; i < c->num_temps; i++) {
+                if (c->temp_start[i] >= c->temp_end[i])
+                        continue;
+                delta[c->temp_start[i]]++;
+                delta[c->temp_end[i]]--;
+        }
+
+        int32_t live = 0;
+        uint32_t max_live = 0;
+        for (int32_t ip = 0; ip <= max_ip; ip++) {
+                live += delta[ip];
+                max_live = MAX2(max_live, live);
+        }
+
+        ralloc_free(delta);
+        return max_live;
+}
+
 /**
  * Returns a mapping from QFILE_TEMP indices to struct qpu_regs.
  *
@@ -1434,6 +1470,10 @@ v3d_register_allocate(struct v3d_compile *c)
         if (c->thread_index >= 1)
                 c->thread_index--;
 
+        c->max_reg_pressure = compute_max_reg_pressure(c);
+        c->reg_pressure_limit = (PHYS_COUNT >> c->thread_index) +
+                                (c->devinfo->has_accumulators ? ACC_COUNT : 0);
+
         c->g = ra_alloc_interference_graph(c->compiler->regs, num_ra_nodes);
         ra_set_select_reg_callback(c->g, v3d_ra_select_callback, &callback_data);
 
@@ -53,6 +53,8 @@ bo_dump_stats(struct v3dv_device *device)
    mesa_logi("  BOs size:        %dkb\n", device->bo_size / 1024);
    mesa_logi("  BOs cached:      %d\n", cache->cache_count);
    mesa_logi("  BOs cached size: %dkb\n", cache->cache_size / 1024);
+   mesa_logi("  Cache hits:      %d (%d still mapped)\n",
+             cache->hit_count, cache->mapped_hit_count);
 
    if (!list_is_empty(&cache->time_list)) {
       struct v3dv_bo *first = list_first_entry(&cache->time_list,
@@ -118,6 +120,10 @@ bo_from_cache(struct v3dv_device *device, uint32_t size, const char *name)
       bo_remove_from_cache(cache, bo);
       bo->name = name;
       p_atomic_set(&bo->refcnt, 1);
+
+      cache->hit_count++;
+      if (bo->map)
+         cache->mapped_hit_count++;
    }
    mtx_unlock(&cache->lock);
    return bo;
@@ -131,7 +137,10 @@ bo_free(struct v3dv_device *device,
       return true;
 
    assert(p_atomic_read(&bo->refcnt) == 0);
-   assert(bo->map == NULL);
+
+   /* BOs in the cache keep their mapping, see v3dv_bo_free() */
+   if (bo->map)
+      v3dv_bo_unmap(device, bo);
 
    if (!bo->is_import) {
       device->bo_count--;
@@ -416,6 +425,8 @@ v3dv_bo_cache_init(struct v3dv_device *device)
    device->bo_cache.max_cache_size *= 1024 * 1024;
    device->bo_cache.cache_count = 0;
    device->bo_cache.cache_size = 0;
+   device->bo_cache.hit_count = 0;
+   device->bo_cache.mapped_hit_count = 0;
    mtx_unlock(&device->bo_cache.lock);
 }
 
@@ -472,13 +483,18 @@ v3dv_bo_free(struct v3dv_device *device,
    if (!p_atomic_dec_zero(&bo->refcnt))
       return true;
 
-   if (bo->map)
-      v3dv_bo_unmap(device, bo);
-
    struct timespec time;
    struct v3dv_bo_cache *cache = &device->bo_cache;
    uint32_t page_index = bo->size / 4096 - 1;
 
+   /* Most of the BOs that go through the cache are CL BOs, which are always
+    * mapped in full right after allocation, so keep full mappings around
+    * for the next user instead of paying for the map ioctl and mmap again.
+    * Partial mappings are dropped, since v3dv_bo_map() would not grow them.
+    */
+   if (bo->map && (!bo->private || bo->map_size != bo->size))
+      v3dv_bo_unmap(device, bo);
+
    if (bo->private &&
        bo->size > cache->max_cache_size - cache->cache_size) {
       clock_gettime(CLOCK_MONOTONIC, &time);
@@ -445,7 +445,7 @@ job_compute_frame_tiling(struct v3dv_job *job,
 }
 
 bool
-v3dv_job_allocate_tile_state(struct v3dv_job *job)
+v3dv_job_allocate_tile_state(struct v3dv_job *job, bool bcl_complete)
 {
    struct v3dv_frame_tiling *tiling = &job->frame_tiling;
    const uint32_t layers =
@@ -470,8 +470,19 @@ v3dv_job_allocate_tile_state(struct v3dv_job *job)
    /* For performance, allocate some extra initial memory after the PTB's
     * minimal allocations, so that we hopefully don't have to block the
     * GPU on the kernel handling an OOM signal.
+    *
+    * If we have recorded the full binning list we know how many vertices
+    * the PTB will see, so small jobs (meta operations, UI passes) don't
+    * need the full amount. Undersizing only costs an OOM round trip.
     */
-   tile_alloc_size += 512 * 1024;
+   uint32_t extra_size = 512 * 1024;
+   if (bcl_complete && !job->suspending &&
+       job->binned_vertex_count != UINT32_MAX) {
+      const uint64_t vertex_size =
+         align64((uint64_t)job->binned_vertex_count * 16, 4096);
+      extra_size = CLAMP(vertex_size, 64 * 1024, extra_size);
+   }
+   tile_alloc_size += extra_size;
 
    job->tile_alloc = v3dv_bo_alloc(job->device, tile_alloc_size,
                                    "tile_alloc", true);
@@ -528,7 +539,7 @@ v3dv_job_start_frame(struct v3dv_job *job,
     * the job and have made a decision about double-buffer.
     */
    if (allocate_tile_state_now) {
-      if (!v3dv_job_allocate_tile_state(job))
+      if (!v3dv_job_allocate_tile_state(job, false))
          return;
    }
 
@@ -582,7 +593,7 @@ cmd_buffer_end_render_pass_frame(struct v3dv_cmd_buffer *cmd_buffer)
        * not and the job's frame tiling represents that decision so we can
        * allocate the tile state, which we need to do before we emit the RCL.
        */
-      v3dv_job_allocate_tile_state(job);
+      v3dv_job_allocate_tile_state(job, true);
 
       v3d_X((&cmd_buffer->device->devinfo), cmd_buffer_emit_render_pass_rcl)(cmd_buffer);
    }
@@ -3083,6 +3094,14 @@ v3dv_cmd_buffer_emit_pre_draw(struct v3dv_cmd_buffer *cmd_buffer,
    /* We disable double-buffer mode if indirect draws are used because in that
     * case we don't know the vertex count.
     */
+   if (indirect ||
+       pipeline->shared_data->variants[BROADCOM_SHADER_GEOMETRY_BIN]) {
+      job->binned_vertex_count = UINT32_MAX;
+   } else if (job->binned_vertex_count != UINT32_MAX) {
+      job->binned_vertex_count =
+         MIN2((uint64_t)job->binned_vertex_count + vertex_count, UINT32_MAX);
+   }
+
    if (indirect) {
       job->can_use_double_buffer = false;
    } else if (job->can_use_double_buffer) {
@@ -520,6 +520,10 @@ struct v3dv_device {
       uint32_t cache_size;
       uint32_t cache_count;
       uint32_t max_cache_size;
+
+      /* Only reported when dumping BO stats */
+      uint32_t hit_count;
+      uint32_t mapped_hit_count;
    } bo_cache;
 
    uint32_t bo_size;
@@ -1178,6 +1182,12 @@ struct v3dv_job {
     */
    struct v3d_double_buffer_score double_buffer_score;
 
+   /* Number of vertices binned by the job, saturated to UINT32_MAX if we
+    * can't know it (indirect draws, geometry shaders). Used to size the
+    * initial tile alloc memory.
+    */
+   uint32_t binned_vertex_count;
+
    /* We only need to allocate tile state for all layers if the binner
     * writes primitives to layers other than the first. This can only be
     * done using layered rendering (writing gl_Layer from a geometry shader),
@@ -1332,7 +1342,7 @@ void v3dv_cmd_buffer_emit_pre_draw(struct v3dv_cmd_buffer *cmd_buffer,
                                    bool indexed, bool indirect,
                                    uint32_t vertex_count);
 
-bool v3dv_job_allocate_tile_state(struct v3dv_job *job);
+bool v3dv_job_allocate_tile_state(struct v3dv_job *job, bool bcl_complete);
 
 void
 v3dv_setup_dynamic_framebuffer(struct v3dv_cmd_buffer *cmd_buffer,
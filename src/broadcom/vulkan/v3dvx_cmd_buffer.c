@@ -2259,6 +2259,9 @@ v3dX(cmd_buffer_execute_inside_pass)(struct v3dv_cmd_buffer *primary,
                primary_job->double_buffer_score.render +=
                   secondary_job->double_buffer_score.render;
             }
+            primary_job->binned_vertex_count =
+               MIN2((uint64_t)primary_job->binned_vertex_count +
+                    secondary_job->binned_vertex_count, UINT32_MAX);
             primary_job->tmu_dirty_rcl |= secondary_job->tmu_dirty_rcl;
          } else {
             /* This is a regular job (CPU or GPU), so just finish the current
@@ -1162,6 +1162,7 @@ public:
 
    void initialize();
    void release();
+   bool initialized() const { return mem_ctx != NULL; }
    ir_function_signature *find(_mesa_glsl_parse_state *state,
                                const char *name, ir_exec_list *actual_parameters);
 
@@ -1641,10 +1642,11 @@ builtin_builder::~builtin_builder()
 {
    simple_mtx_lock(&builtins_lock);
 
-   ralloc_free(mem_ctx);
-   mem_ctx = NULL;
-   linalloc = NULL;
-   symbols = NULL;
+   /* The library outlives its last user, see
+    * _mesa_glsl_builtin_functions_decref().
+    */
+   if (mem_ctx != NULL)
+      release();
 
    simple_mtx_unlock(&builtins_lock);
 }
@@ -9639,17 +9641,35 @@ extern "C" void
 _mesa_glsl_builtin_functions_init_or_ref()
 {
    simple_mtx_lock(&builtins_lock);
-   if (builtin_users++ == 0)
-      builtins.initialize();
+   builtin_users++;
+   builtins.initialize();
    simple_mtx_unlock(&builtins_lock);
 }
 
+/**
+ * Drops a reference to the built-in library. The library itself is kept when
+ * the last reference goes away, because building it is a large part of the
+ * first compile in a context, and applications which create and destroy
+ * contexts would otherwise build it again for every one of them. It is only
+ * freed by _mesa_glsl_release_builtin_functions() or at exit.
+ */
 extern "C" void
 _mesa_glsl_builtin_functions_decref()
 {
    simple_mtx_lock(&builtins_lock);
    assert(builtin_users != 0);
-   if (--builtin_users == 0)
+   builtin_users--;
+   simple_mtx_unlock(&builtins_lock);
+}
+
+/**
+ * Frees the built-in library if nobody references it anymore.
+ */
+extern "C" void
+_mesa_glsl_release_builtin_functions()
+{
+   simple_mtx_lock(&builtins_lock);
+   if (builtin_users == 0 && builtins.initialized())
       builtins.release();
    simple_mtx_unlock(&builtins_lock);
 }
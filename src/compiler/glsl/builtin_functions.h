@@ -36,6 +36,9 @@ _mesa_glsl_builtin_functions_init_or_ref();
 void
 _mesa_glsl_builtin_functions_decref(void);
 
+void
+_mesa_glsl_release_builtin_functions(void);
+
 #ifdef __cplusplus
 
 } /* extern "C" */
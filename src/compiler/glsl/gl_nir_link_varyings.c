@@ -4059,6 +4059,12 @@ check_against_output_limit(struct gl_shader_program *prog,
    return true;
 }
 
+static void
+opt_linked_shader(struct gl_linked_shader *shader, void *data)
+{
+   gl_nir_opts(shader->Program->nir);
+}
+
 static bool
 link_varyings(const struct pipe_screen *screen,
               struct gl_shader_program *prog, unsigned first,
@@ -4171,8 +4177,8 @@ link_varyings(const struct pipe_screen *screen,
       }
    }
 
-   for (unsigned i = 0; i < num_shaders; i++)
-      gl_nir_opts(linked_shader[i]->Program->nir);
+   gl_nir_foreach_linked_shader_parallel(linked_shader, num_shaders,
+                                         opt_linked_shader, NULL);
 
    if (num_shaders > 1) {
       for (int i = num_shaders - 2; i >= 0; i--) {
@@ -34,6 +34,9 @@
 #include "main/context.h"
 #include "main/shaderobj.h"
 #include "util/glheader.h"
+#include "util/u_call_once.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_queue.h"
 #include "util/u_range_remap.h"
 #include "util/perf/cpu_trace.h"
 #include "pipe/p_screen.h"
@@ -129,6 +132,87 @@ gl_nir_opts(nir_shader *nir)
    NIR_PASS(_, nir, nir_lower_var_copies);
 }
 
+/* Programs with fewer stages are linked serially, the synchronization costs
+ * more than it saves.
+ */
+#define MIN_PARALLEL_STAGES 3
+
+static struct util_queue link_queue;
+static bool link_queue_initialized;
+static util_once_flag link_queue_once = UTIL_ONCE_FLAG_INIT;
+
+static void
+init_link_queue(void)
+{
+   unsigned num_threads =
+      CLAMP(util_get_cpu_caps()->nr_cpus, 1, MESA_SHADER_MESH_STAGES - 1);
+
+   link_queue_initialized =
+      util_queue_init(&link_queue, "gl_link", MESA_SHADER_MESH_STAGES,
+                      num_threads, UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL);
+}
+
+struct stage_job {
+   struct gl_linked_shader *shader;
+   gl_nir_stage_cb cb;
+   void *data;
+   struct util_queue_fence fence;
+};
+
+static void
+run_stage_job(void *_job, void *gdata, int thread_index)
+{
+   struct stage_job *job = _job;
+   job->cb(job->shader, job->data);
+}
+
+/**
+ * Calls \p cb for all \p num_shaders linked shaders, with the shaders of
+ * programs with many stages being processed on different threads.
+ *
+ * \p cb may only modify the linked shader it's given and its NIR. Anything
+ * shared by the whole program, e.g. the info log, must only be read, and
+ * errors must be reported after this returns.
+ */
+void
+gl_nir_foreach_linked_shader_parallel(struct gl_linked_shader **linked_shader,
+                                      unsigned num_shaders,
+                                      gl_nir_stage_cb cb, void *data)
+{
+   if (num_shaders >= MIN_PARALLEL_STAGES)
+      util_call_once(&link_queue_once, init_link_queue);
+
+   if (num_shaders < MIN_PARALLEL_STAGES || !link_queue_initialized) {
+      for (unsigned i = 0; i < num_shaders; i++)
+         cb(linked_shader[i], data);
+      return;
+   }
+
+   struct stage_job jobs[MESA_SHADER_MESH_STAGES];
+   assert(num_shaders <= ARRAY_SIZE(jobs));
+
+   for (unsigned i = 0; i < num_shaders; i++) {
+      jobs[i].shader = linked_shader[i];
+      jobs[i].cb = cb;
+      jobs[i].data = data;
+      util_queue_fence_init(&jobs[i].fence);
+
+      /* The first stage is handled by this thread. */
+      if (i > 0) {
+         util_queue_add_job(&link_queue, &jobs[i], &jobs[i].fence,
+                            run_stage_job, NULL, 0);
+      }
+   }
+
+   run_stage_job(&jobs[0], NULL, 0);
+
+   for (unsigned i = 0; i < num_shaders; i++) {
+      if (i > 0)
+         util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+}
+
 static void
 replace_tex_src(nir_tex_src *dst, nir_tex_src_type src_type, nir_def *src_def,
                 nir_instr *src_parent)
@@ -1368,6 +1452,46 @@ preprocess_shader(const struct pipe_screen *screen,
    NIR_PASS(_, nir, nir_opt_constant_folding);
 }
 
+struct prelink_stage_data {
+   const struct pipe_screen *screen;
+   const struct gl_constants *consts;
+   const struct gl_extensions *exts;
+   struct gl_shader_program *shader_program;
+};
+
+static void
+prelink_lower_stage(struct gl_linked_shader *shader, void *_data)
+{
+   const struct prelink_stage_data *data = _data;
+   const struct gl_constants *consts = data->consts;
+   const struct gl_extensions *exts = data->exts;
+   struct gl_shader_program *shader_program = data->shader_program;
+   const nir_shader_compiler_options *options =
+      data->screen->nir_options[shader->Stage];
+   struct gl_program *prog = shader->Program;
+
+   /* NIR drivers that support tess shaders and compact arrays need to use
+    * GLSLTessLevelsAsInputs / pipe_caps.glsl_tess_levels_as_inputs. The NIR
+    * linker doesn't support linking these as compat arrays of sysvals.
+    */
+   assert(consts->GLSLTessLevelsAsInputs || !options->compact_arrays ||
+          !exts->ARB_tessellation_shader);
+
+   /* ES 3.0+ vertex shaders may still have dead varyings but its now safe
+    * to remove them as validation is now done according to the spec.
+    */
+   if (shader_program->IsES && shader_program->GLSL_Version >= 300 &&
+       shader->Stage == MESA_SHADER_VERTEX)
+      remove_dead_varyings_pre_linking(prog->nir);
+
+   preprocess_shader(data->screen, consts, exts, prog, shader_program,
+                     shader->Stage);
+
+   if (options->lower_to_scalar) {
+      NIR_PASS(_, prog->nir, nir_lower_load_const_to_scalar);
+   }
+}
+
 static bool
 prelink_lowering(const struct pipe_screen *screen,
                  const struct gl_constants *consts,
@@ -1375,38 +1499,24 @@ prelink_lowering(const struct pipe_screen *screen,
                  struct gl_shader_program *shader_program,
                  struct gl_linked_shader **linked_shader, unsigned num_shaders)
 {
-   for (unsigned i = 0; i < num_shaders; i++) {
-      struct gl_linked_shader *shader = linked_shader[i];
-      const nir_shader_compiler_options *options = screen->nir_options[shader->Stage];
-      struct gl_program *prog = shader->Program;
-
-      /* NIR drivers that support tess shaders and compact arrays need to use
-      * GLSLTessLevelsAsInputs / pipe_caps.glsl_tess_levels_as_inputs. The NIR
-      * linker doesn't support linking these as compat arrays of sysvals.
-      */
-      assert(consts->GLSLTessLevelsAsInputs || !options->compact_arrays ||
-             !exts->ARB_tessellation_shader);
-
-
-      /* ES 3.0+ vertex shaders may still have dead varyings but its now safe
-       * to remove them as validation is now done according to the spec.
-       */
-      if (shader_program->IsES && shader_program->GLSL_Version >= 300 &&
-          i == MESA_SHADER_VERTEX)
-         remove_dead_varyings_pre_linking(prog->nir);
+   struct prelink_stage_data data = {
+      .screen = screen,
+      .consts = consts,
+      .exts = exts,
+      .shader_program = shader_program,
+   };
+   gl_nir_foreach_linked_shader_parallel(linked_shader, num_shaders,
+                                         prelink_lower_stage, &data);
 
-      preprocess_shader(screen, consts, exts, prog, shader_program, shader->Stage);
+   for (unsigned i = 0; i < num_shaders; i++) {
+      nir_shader *nir = linked_shader[i]->Program->nir;
 
-      if (prog->nir->info.shared_size > consts->MaxComputeSharedMemorySize) {
+      if (nir->info.shared_size > consts->MaxComputeSharedMemorySize) {
          linker_error(shader_program, "Too much shared memory used (%u/%u)\n",
-                      prog->nir->info.shared_size,
+                      nir->info.shared_size,
                       consts->MaxComputeSharedMemorySize);
          return false;
       }
-
-      if (options->lower_to_scalar) {
-         NIR_PASS(_, shader->Program->nir, nir_lower_load_const_to_scalar);
-      }
    }
 
    lower_patch_vertices_in(shader_program);
@@ -60,6 +60,12 @@ struct gl_nir_linker_options {
 
 void gl_nir_opts(nir_shader *nir);
 
+typedef void (*gl_nir_stage_cb)(struct gl_linked_shader *shader, void *data);
+
+void gl_nir_foreach_linked_shader_parallel(struct gl_linked_shader **linked_shader,
+                                           unsigned num_shaders,
+                                           gl_nir_stage_cb cb, void *data);
+
 void gl_nir_detect_recursion_linked(struct gl_shader_program *prog,
                                     nir_shader *shader);
 
@@ -33,12 +33,15 @@
 #include "util/u_atomic.h" /* for p_atomic_cmpxchg */
 #include "util/ralloc.h"
 #include "util/disk_cache.h"
+#include "util/hash_table.h"
 #include "util/log.h"
 #include "util/mesa-blake3.h"
 #include "ast.h"
 #include "glsl_parser_extras.h"
 #include "glsl_parser.h"
 #include "glsl_to_nir.h"
+#include "nir.h"
+#include "nir_serialize.h"
 #include "ir_optimization.h"
 #include "builtin_functions.h"
 #include "pipe/p_screen.h"
@@ -74,7 +77,14 @@ _mesa_glsl_parse_state::_mesa_glsl_parse_state(struct gl_context *_ctx,
    this->translation_unit.make_empty();
    this->symbols = new(mem_ctx) glsl_symbol_table;
 
-   this->linalloc = linear_context(this);
+   /* The AST and the IR are all allocated from this context and are dropped
+    * at once with the parse state after glsl_to_nir. Let the context reuse
+    * the buffers of the previous compile on this thread instead of
+    * malloc'ing new ones for every shader.
+    */
+   linear_opts lin_opts = {};
+   lin_opts.arena = true;
+   this->linalloc = linear_context_with_opts(this, &lin_opts);
 
    this->info_log = ralloc_strdup(mem_ctx, "");
    this->error = false;
@@ -2285,8 +2295,16 @@ opt_shader(const struct pipe_screen *screen,
     * and reduce later work if the same shader is linked multiple times.
     *
     * Run it just once, since NIR will do the real optimization.
+    *
+    * GLSL ES shaders can skip it entirely to reduce compile latency (e.g.
+    * for WebGL), only keeping the passes the rest of the pipeline relies on.
     */
-   do_common_optimization(shader->ir, false, shader->Stage, screen);
+   if (shader->IsES && consts->GLSLESSkipIROptimizations) {
+      do_lower_jumps(shader->ir, true, !screen->shader_caps[shader->Stage].cont_supported);
+      propagate_invariance(shader->ir);
+   } else {
+      do_common_optimization(shader->ir, false, shader->Stage, screen);
+   }
 
    validate_ir_tree(shader->ir);
 
@@ -2371,72 +2389,191 @@ can_skip_compile(struct gl_context *ctx, struct gl_shader *shader,
    return false;
 }
 
+/* Upper bound for the serialized NIR kept by the compile cache of a
+ * context.  The cache is simply emptied when it's reached.
+ */
+#define GLSL_COMPILE_CACHE_MAX_SIZE (16 * 1024 * 1024)
+
+/**
+ * Cache of successfully compiled shaders, keyed by the stage and the
+ * preprocessed source.  Applications often compile the same shader, or
+ * shaders which only differ in comments, whitespace or unused macros, many
+ * times.  On a hit, parsing, ast_to_hir, the GLSL IR optimizations and
+ * glsl_to_nir are all skipped.  It's per context, because the result of the
+ * compile depends on the API, version and extensions of the context.
+ */
+struct glsl_compile_cache {
+   struct hash_table *entries;
+   size_t size;
+};
+
+struct glsl_compile_cache_entry {
+   blake3_hash key;
+
+   /* The fields of gl_shader set by the compile, see copy_compiled_state(). */
+   struct gl_shader state;
+
+   /* Info log written after preprocessing, i.e. by the parser and compiler. */
+   char *info_log;
+
+   void *nir;
+   size_t nir_size;
+};
+
+static uint32_t
+compile_cache_hash(const void *key)
+{
+   return *(const uint32_t *)key;
+}
+
+static bool
+compile_cache_equal(const void *a, const void *b)
+{
+   return memcmp(a, b, sizeof(blake3_hash)) == 0;
+}
+
 static void
-log_compile_skip(struct gl_context *ctx, struct gl_shader *shader)
+copy_compiled_state(struct gl_shader *dst, const struct gl_shader *src)
+{
+   dst->Version = src->Version;
+   dst->IsES = src->IsES;
+   dst->has_implicit_conversions = src->has_implicit_conversions;
+   dst->has_implicit_int_to_uint_conversion =
+      src->has_implicit_int_to_uint_conversion;
+   dst->KHR_shader_subgroup_basic_enable = src->KHR_shader_subgroup_basic_enable;
+   dst->BlendSupport = src->BlendSupport;
+   dst->EarlyFragmentTests = src->EarlyFragmentTests;
+   dst->ARB_fragment_coord_conventions_enable =
+      src->ARB_fragment_coord_conventions_enable;
+   dst->redeclares_gl_fragcoord = src->redeclares_gl_fragcoord;
+   dst->uses_gl_fragcoord = src->uses_gl_fragcoord;
+   dst->PostDepthCoverage = src->PostDepthCoverage;
+   dst->PixelInterlockOrdered = src->PixelInterlockOrdered;
+   dst->PixelInterlockUnordered = src->PixelInterlockUnordered;
+   dst->SampleInterlockOrdered = src->SampleInterlockOrdered;
+   dst->SampleInterlockUnordered = src->SampleInterlockUnordered;
+   dst->InnerCoverage = src->InnerCoverage;
+   dst->origin_upper_left = src->origin_upper_left;
+   dst->pixel_center_integer = src->pixel_center_integer;
+   dst->bindless_sampler = src->bindless_sampler;
+   dst->bindless_image = src->bindless_image;
+   dst->bound_sampler = src->bound_sampler;
+   dst->bound_image = src->bound_image;
+   dst->redeclares_gl_layer = src->redeclares_gl_layer;
+   dst->layer_viewport_relative = src->layer_viewport_relative;
+   memcpy(dst->TransformFeedbackBufferStride,
+          src->TransformFeedbackBufferStride,
+          sizeof(dst->TransformFeedbackBufferStride));
+   dst->view_mask = src->view_mask;
+   dst->info = src->info;
+}
+
+static void
+compile_cache_key(mesa_shader_stage stage, const char *source,
+                  blake3_hash key)
 {
-   if (ctx->_Shader->Flags & GLSL_DUMP) {
-      _mesa_log("No GLSL IR for shader %d (shader may be from cache)\n",
-                shader->Name);
-   }
+   struct mesa_blake3 ctx;
+   _mesa_blake3_init(&ctx);
+   _mesa_blake3_update(&ctx, &stage, sizeof(stage));
+   _mesa_blake3_update(&ctx, source, strlen(source));
+   _mesa_blake3_final(&ctx, key);
 }
 
-void
-_mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
-                          FILE *dump_ir_file, bool dump_ast, bool dump_hir,
-                          bool force_recompile)
+static struct glsl_compile_cache_entry *
+compile_cache_search(struct gl_context *ctx, const blake3_hash key)
 {
-   const char *source;
-   const uint8_t *source_blake3;
+   if (!ctx->GLSLCompileCache)
+      return NULL;
 
-   if (force_recompile && shader->FallbackSource) {
-      source = shader->FallbackSource;
-      source_blake3 = shader->fallback_source_blake3;
-   } else {
-      source = shader->Source;
-      source_blake3 = shader->source_blake3;
+   struct hash_entry *entry =
+      _mesa_hash_table_search(ctx->GLSLCompileCache->entries, key);
+   return entry ? (struct glsl_compile_cache_entry *)entry->data : NULL;
+}
+
+static void
+compile_cache_add(struct gl_context *ctx, const blake3_hash key,
+                  const struct gl_shader *shader, const char *info_log)
+{
+   struct glsl_compile_cache *cache = ctx->GLSLCompileCache;
+   if (!cache) {
+      cache = rzalloc(NULL, struct glsl_compile_cache);
+      cache->entries = _mesa_hash_table_create(cache, compile_cache_hash,
+                                               compile_cache_equal);
+      ctx->GLSLCompileCache = cache;
    }
 
-   /* Note this will be true for shaders the have #include inside comments
-    * however that should be rare enough not to worry about.
-    */
-   bool source_has_shader_include =
-      strstr(source, "#include") == NULL ? false : true;
+   struct blob blob;
+   blob_init(&blob);
+   nir_serialize(&blob, shader->nir, false);
 
-   /* If there was no shader include we can check the shader cache and skip
-    * compilation before we run the preprocessor. We never skip compiling
-    * shaders that use ARB_shading_language_include because we would need to
-    * keep duplicate copies of the shader include source tree and paths.
-    */
-   if (!source_has_shader_include &&
-       can_skip_compile(ctx, shader, source, source_blake3, force_recompile,
-                        false)) {
-      log_compile_skip(ctx, shader);
+   if (blob.out_of_memory ||
+       blob.size > GLSL_COMPILE_CACHE_MAX_SIZE) {
+      blob_finish(&blob);
       return;
    }
 
-    struct _mesa_glsl_parse_state *state =
-      new(shader) _mesa_glsl_parse_state(ctx, shader->Stage, shader);
+   if (cache->size + blob.size > GLSL_COMPILE_CACHE_MAX_SIZE) {
+      hash_table_foreach(cache->entries, entry)
+         ralloc_free(entry->data);
+      _mesa_hash_table_clear(cache->entries, NULL);
+      cache->size = 0;
+   }
 
-   if (ctx->Const.GenerateTemporaryNames)
-      (void) p_atomic_cmpxchg(&ir_variable::temporaries_allocate_names,
-                              false, true);
+   struct glsl_compile_cache_entry *entry =
+      rzalloc(cache, struct glsl_compile_cache_entry);
+   memcpy(entry->key, key, sizeof(entry->key));
+   copy_compiled_state(&entry->state, shader);
+   entry->info_log = ralloc_strdup(entry, info_log);
+   entry->nir = ralloc_memdup(entry, blob.data, blob.size);
+   entry->nir_size = blob.size;
+   blob_finish(&blob);
 
-   if (!source_has_shader_include || !force_recompile) {
-      state->error = glcpp_preprocess(state, &source, &state->info_log,
-                                      add_builtin_defines, state, ctx);
-   }
+   _mesa_hash_table_insert(cache->entries, entry->key, entry);
+   cache->size += entry->nir_size;
+}
 
-   /* Now that we have run the preprocessor we can check the shader cache and
-    * skip compilation if possible for those shaders that contained a shader
-    * include.
+static nir_shader *
+compile_cache_load_nir(struct gl_context *ctx, struct gl_shader *shader,
+                       const struct glsl_compile_cache_entry *entry,
+                       const uint8_t *source_blake3)
+{
+   struct blob_reader reader;
+   blob_reader_init(&reader, entry->nir, entry->nir_size);
+   nir_shader *nir =
+      nir_deserialize(NULL, ctx->screen->nir_options[shader->Stage], &reader);
+
+   /* The function holding the global instructions is named after the
+    * source, give it the name glsl_to_nir would have picked for this one.
     */
-   if (source_has_shader_include &&
-       can_skip_compile(ctx, shader, source, source_blake3, force_recompile,
-                        true)) {
-      log_compile_skip(ctx, shader);
-      return;
+   nir_foreach_function(func, nir) {
+      if (func->is_tmp_globals_wrapper) {
+         char blake_as_str[BLAKE3_OUT_LEN * 2 + 1];
+         _mesa_blake3_format(blake_as_str, source_blake3);
+
+         char name[45];
+         snprintf(name, sizeof(name), "%s_%s", "gl_mesa_tmp", blake_as_str);
+         func->name = ralloc_strdup(func, name);
+      }
    }
 
+   return nir;
+}
+
+extern "C" void
+_mesa_glsl_free_compile_cache(struct gl_context *ctx)
+{
+   ralloc_free(ctx->GLSLCompileCache);
+   ctx->GLSLCompileCache = NULL;
+}
+
+/**
+ * Parses the preprocessed source and turns it into optimized GLSL IR.
+ */
+static void
+compile_preprocessed(struct gl_context *ctx, struct gl_shader *shader,
+                     struct _mesa_glsl_parse_state *state, const char *source,
+                     bool dump_ast, bool dump_hir)
+{
    if (!state->error) {
      _mesa_glsl_lexer_ctor(state, source);
      _mesa_glsl_parse(state);
@@ -2494,6 +2631,101 @@ _mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
       opt_shader(ctx->screen, &ctx->Const, &ctx->Extensions, shader,
                  state->linalloc);
    }
+}
+
+static void
+log_compile_skip(struct gl_context *ctx, struct gl_shader *shader)
+{
+   if (ctx->_Shader->Flags & GLSL_DUMP) {
+      _mesa_log("No GLSL IR for shader %d (shader may be from cache)\n",
+                shader->Name);
+   }
+}
+
+void
+_mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
+                          FILE *dump_ir_file, bool dump_ast, bool dump_hir,
+                          bool force_recompile)
+{
+   const char *source;
+   const uint8_t *source_blake3;
+
+   if (force_recompile && shader->FallbackSource) {
+      source = shader->FallbackSource;
+      source_blake3 = shader->fallback_source_blake3;
+   } else {
+      source = shader->Source;
+      source_blake3 = shader->source_blake3;
+   }
+
+   /* Note this will be true for shaders the have #include inside comments
+    * however that should be rare enough not to worry about.
+    */
+   bool source_has_shader_include =
+      strstr(source, "#include") == NULL ? false : true;
+
+   /* If there was no shader include we can check the shader cache and skip
+    * compilation before we run the preprocessor. We never skip compiling
+    * shaders that use ARB_shading_language_include because we would need to
+    * keep duplicate copies of the shader include source tree and paths.
+    */
+   if (!source_has_shader_include &&
+       can_skip_compile(ctx, shader, source, source_blake3, force_recompile,
+                        false)) {
+      log_compile_skip(ctx, shader);
+      return;
+   }
+
+    struct _mesa_glsl_parse_state *state =
+      new(shader) _mesa_glsl_parse_state(ctx, shader->Stage, shader);
+
+   if (ctx->Const.GenerateTemporaryNames)
+      (void) p_atomic_cmpxchg(&ir_variable::temporaries_allocate_names,
+                              false, true);
+
+   if (!source_has_shader_include || !force_recompile) {
+      state->error = glcpp_preprocess(state, &source, &state->info_log,
+                                      add_builtin_defines, state, ctx);
+   }
+
+   /* Now that we have run the preprocessor we can check the shader cache and
+    * skip compilation if possible for those shaders that contained a shader
+    * include.
+    */
+   if (source_has_shader_include &&
+       can_skip_compile(ctx, shader, source, source_blake3, force_recompile,
+                        true)) {
+      log_compile_skip(ctx, shader);
+      return;
+   }
+
+   /* The compile cache is only used when nothing needs the GLSL IR. */
+   const bool use_cache = !state->error && !dump_ast && !dump_hir &&
+      !dump_ir_file && !(ctx->_Shader && ctx->_Shader->Flags & GLSL_DUMP);
+   const size_t preprocess_info_log_len = strlen(state->info_log);
+   struct glsl_compile_cache_entry *cached = NULL;
+   blake3_hash cache_key;
+   if (use_cache) {
+      compile_cache_key(shader->Stage, source, cache_key);
+      cached = compile_cache_search(ctx, cache_key);
+   }
+
+   if (cached) {
+      ralloc_free(shader->ir);
+      ralloc_free(shader->nir);
+      shader->nir = NULL;
+      shader->ir = NULL;
+
+      if (shader->InfoLog)
+         ralloc_free(shader->InfoLog);
+
+      copy_compiled_state(shader, &cached->state);
+      shader->CompileStatus = COMPILE_SUCCESS;
+      shader->InfoLog = state->info_log;
+      ralloc_strcat(&shader->InfoLog, cached->info_log);
+   } else {
+      compile_preprocessed(ctx, shader, state, source, dump_ast, dump_hir);
+   }
 
    if (!force_recompile) {
       free((void *)shader->FallbackSource);
@@ -2534,8 +2766,19 @@ _mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
    if (shader->CompileStatus == COMPILE_SUCCESS) {
       memcpy(shader->compiled_source_blake3, source_blake3, BLAKE3_OUT_LEN);
 
-      shader->nir = glsl_to_nir(shader, ctx->screen->nir_options[shader->Stage],
-                                source_blake3);
+      if (cached) {
+         shader->nir = compile_cache_load_nir(ctx, shader, cached,
+                                              source_blake3);
+      } else {
+         shader->nir = glsl_to_nir(shader,
+                                   ctx->screen->nir_options[shader->Stage],
+                                   source_blake3);
+
+         if (use_cache) {
+            compile_cache_add(ctx, cache_key, shader,
+                              shader->InfoLog + preprocess_info_log_len);
+         }
+      }
    }
 
    delete state->symbols;
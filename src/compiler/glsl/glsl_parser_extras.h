@@ -1134,6 +1134,9 @@ _mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
                           FILE *dump_ir_file, bool dump_ast, bool dump_hir,
                           bool force_recompile);
 
+extern void
+_mesa_glsl_free_compile_cache(struct gl_context *ctx);
+
 typedef void (*glcpp_extension_iterator)(
               struct _mesa_glsl_parse_state *state,
               void (*add_builtin_define)(struct glcpp_parser *, const char *, int),
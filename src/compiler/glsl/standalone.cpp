@@ -460,7 +460,9 @@ standalone_compiler_cleanup(struct gl_shader_program *whole_program,
                             struct gl_context *ctx)
 {
    standalone_destroy_shader_program(whole_program);
+   _mesa_glsl_free_compile_cache(ctx);
 
    free(ctx->screen);
    _mesa_glsl_builtin_functions_decref();
+   _mesa_glsl_release_builtin_functions();
 }
@@ -53,6 +53,8 @@ static const struct debug_named_value nir_debug_control[] = {
      "Validate even if a pass does not make progress and test that it properly preserves most types of metadata. This can be very slow" },
    { "progress_validation", NIR_DEBUG_PROGRESS_VALIDATION,
      "Validate that a shader is unmodified if a pass does not report progress" },
+   { "incremental_validation", NIR_DEBUG_INCREMENTAL_VALIDATION,
+     "Only validate functions which changed since they were last validated, with a full validation every 16 validations" },
    { "invalidate_metadata", NIR_DEBUG_INVALIDATE_METADATA,
      "Invalidate metadata before passes to try to find passes which don't require metadata that they use. This overrides NIR_DEBUG=extended_validation somewhat" },
    { "tgsi", NIR_DEBUG_TGSI,
@@ -97,6 +99,10 @@ static const struct debug_named_value nir_debug_control[] = {
      "Print pass_flags for every instruction when pass_flags are non-zero" },
    { "print_struct_decls", NIR_DEBUG_PRINT_STRUCT_DECLS,
      "Print information about members of struct types used by variables" },
+   { "profile_passes", NIR_DEBUG_PROFILE_PASSES,
+     "Print the number of calls, progress and time of every pass at exit" },
+   { "schedule_stats", NIR_DEBUG_SCHEDULE_STATS,
+     "Print the maximum register pressure before and after nir_schedule" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -693,6 +699,7 @@ nir_function_impl_create_bare(nir_shader *shader)
    impl->ssa_alloc = 0;
    impl->num_blocks = 0;
    impl->valid_metadata = nir_metadata_none;
+   impl->num_algebraic_no_progress = 0;
    impl->structured = true;
    range_minimum_query_table_init(&impl->dom_lca_info.table);
    impl->dom_lca_info.block_from_idx = NULL;
@@ -721,10 +728,27 @@ nir_function_impl_create(nir_function *function)
    return impl;
 }
 
+/* While nir_shader_impls_parallel() runs passes on several functions at once,
+ * allocations parented to the shader itself have to be serialized.
+ */
+static void *
+shader_zalloc_size(nir_shader *shader, size_t size)
+{
+   if (unlikely(shader->parallel_lock))
+      simple_mtx_lock(shader->parallel_lock);
+
+   void *ptr = rzalloc_size(shader, size);
+
+   if (unlikely(shader->parallel_lock))
+      simple_mtx_unlock(shader->parallel_lock);
+
+   return ptr;
+}
+
 nir_block *
 nir_block_create(nir_shader *shader)
 {
-   nir_block *block = rzalloc(shader, nir_block);
+   nir_block *block = shader_zalloc_size(shader, sizeof(nir_block));
 
    cf_init(&block->cf_node, nir_cf_node_block);
 
@@ -747,7 +771,7 @@ src_init(nir_src *src)
 nir_if *
 nir_if_create(nir_shader *shader)
 {
-   nir_if *if_stmt = ralloc(shader, nir_if);
+   nir_if *if_stmt = shader_zalloc_size(shader, sizeof(nir_if));
 
    if_stmt->control = nir_selection_control_none;
 
@@ -770,7 +794,7 @@ nir_if_create(nir_shader *shader)
 nir_loop *
 nir_loop_create(nir_shader *shader)
 {
-   nir_loop *loop = rzalloc(shader, nir_loop);
+   nir_loop *loop = shader_zalloc_size(shader, sizeof(nir_loop));
 
    cf_init(&loop->cf_node, nir_cf_node_loop);
    /* Assume that loops are divergent until proven otherwise */
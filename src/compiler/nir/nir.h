@@ -43,6 +43,7 @@
 #include "util/ralloc.h"
 #include "util/range_minimum_query.h"
 #include "util/set.h"
+#include "util/simple_mtx.h"
 #include "util/sparse_bitset.h"
 #include "util/u_math.h"
 #include "nir_defines.h"
@@ -95,6 +96,9 @@ extern bool nir_debug_print_shader[MESA_SHADER_KERNEL + 1];
 #define NIR_DEBUG_INVALIDATE_METADATA    (1u << 23)
 #define NIR_DEBUG_PRINT_STRUCT_DECLS     (1u << 24)
 #define NIR_DEBUG_PROGRESS_VALIDATION    (1u << 25)
+#define NIR_DEBUG_PROFILE_PASSES         (1u << 26)
+#define NIR_DEBUG_SCHEDULE_STATS         (1u << 27)
+#define NIR_DEBUG_INCREMENTAL_VALIDATION (1u << 28)
 
 #define NIR_DEBUG_PRINT (NIR_DEBUG_PRINT_VS |  \
                          NIR_DEBUG_PRINT_TCS | \
@@ -3595,6 +3599,28 @@ typedef enum {
     */
    nir_metadata_dominance_lca = 0x80,
 
+   /** Indicates that nir_function_impl::algebraic_no_progress is valid
+    *
+    * This lists the algebraic passes which ran on the impl without making
+    * progress.  Running one of them again cannot make progress either, so
+    * nir_algebraic_impl() skips them if
+    * nir_shader_compiler_options::skip_unchanged_algebraic is set.
+    *
+    * Only nir_algebraic_impl() sets this.  A pass can only preserve this
+    * metadata type if it doesn't change the shader at all.
+    */
+   nir_metadata_algebraic = 0x100,
+
+   /** Indicates that the impl passed nir_validate_shader()
+    *
+    * Only nir_validate_shader() sets this, with
+    * NIR_DEBUG=incremental_validation.  Impls with this flag are skipped by
+    * all but every few full validations.  Like nir_metadata_algebraic, a pass
+    * can only preserve this metadata type if it doesn't change the impl at
+    * all.
+    */
+   nir_metadata_validated = 0x200,
+
    /** All control flow metadata
     *
     * This includes all metadata preserved by a pass that preserves control flow
@@ -3659,6 +3685,13 @@ typedef struct nir_function_impl {
    nir_metadata valid_metadata;
    nir_variable_mode loop_analysis_indirect_mask;
    bool loop_analysis_force_unroll_sampler_indirect;
+
+   /** Algebraic passes without progress, see nir_metadata_algebraic */
+   struct {
+      const void *table;
+      bool *condition_flags;
+   } algebraic_no_progress[4];
+   unsigned num_algebraic_no_progress;
 } nir_function_impl;
 
 #define nir_foreach_function_temp_variable(var, impl) \
@@ -3926,6 +3959,12 @@ typedef uint8_t (*nir_vectorize_cb)(const nir_instr *, const void *);
 typedef struct nir_shader {
    gc_ctx *gctx;
 
+   /**
+    * Only set while nir_shader_impls_parallel() is running, protects
+    * allocations parented to the shader.
+    */
+   simple_mtx_t *parallel_lock;
+
    /** list of uniforms (nir_variable) */
    struct exec_list variables;
 
@@ -4831,6 +4870,8 @@ void nir_metadata_check_validation_flag(nir_shader *shader);
 void nir_metadata_require_most(nir_shader *shader);
 struct blob nir_validate_progress_setup(nir_shader *shader);
 void nir_validate_progress_finish(nir_shader *shader, struct blob *setup_blob, bool progress, const char *when);
+int64_t nir_pass_profile_start(void);
+void nir_pass_profile_end(const char *pass, int64_t start, bool progress);
 
 static inline bool
 should_skip_nir(const char *name)
@@ -4901,6 +4942,18 @@ nir_validate_progress_finish(nir_shader *shader, struct blob *setup_blob, bool p
    (void)progress;
    (void)when;
 }
+static inline int64_t
+nir_pass_profile_start(void)
+{
+   return 0;
+}
+static inline void
+nir_pass_profile_end(const char *pass, int64_t start, bool progress)
+{
+   (void)pass;
+   (void)start;
+   (void)progress;
+}
 static inline bool
 should_skip_nir(UNUSED const char *pass_name)
 {
@@ -4942,7 +4995,11 @@ should_print_nir(UNUSED nir_shader *shader)
       printf("%s\n", #pass);                                                             \
    static const char *when = "after " #pass " in " __FILE__ ":" NIR_STRINGIZE(__LINE__); \
    struct blob blob_before = nir_validate_progress_setup(nir);                           \
-   if (pass(nir, ##__VA_ARGS__)) {                                                       \
+   int64_t _pass_start = NIR_DEBUG(PROFILE_PASSES) ? nir_pass_profile_start() : 0;       \
+   bool _pass_progress = pass(nir, ##__VA_ARGS__);                                       \
+   if (NIR_DEBUG(PROFILE_PASSES))                                                        \
+      nir_pass_profile_end(#pass, _pass_start, _pass_progress);                          \
+   if (_pass_progress) {                                                                 \
       nir_validate_shader(nir, when);                                                    \
       UNUSED bool _;                                                                     \
       progress = true;                                                                   \
@@ -6100,6 +6157,10 @@ typedef struct nir_lower_non_uniform_access_options {
    nir_lower_non_uniform_src_access_callback tex_src_callback;
    nir_lower_non_uniform_access_callback callback;
    void *callback_data;
+   /* Check whether the handles are uniform across the subgroup first and
+    * only fall back to the loop when they are not.
+    */
+   bool uniform_fast_path;
 } nir_lower_non_uniform_access_options;
 
 bool nir_has_non_uniform_access(nir_shader *shader, enum nir_lower_non_uniform_access_type types);
@@ -6406,6 +6467,7 @@ typedef struct nir_opt_access_options {
 } nir_opt_access_options;
 
 bool nir_opt_access(nir_shader *shader, const nir_opt_access_options *options);
+bool nir_opt_algebraic_impl(nir_function_impl *impl);
 bool nir_opt_algebraic(nir_shader *shader);
 bool nir_opt_algebraic_before_ffma(nir_shader *shader);
 bool nir_opt_algebraic_before_lower_int64(nir_shader *shader);
@@ -6439,8 +6501,10 @@ bool nir_opt_copy_prop(nir_shader *shader);
 
 bool nir_opt_copy_prop_vars(nir_shader *shader);
 
+bool nir_opt_cse_impl(nir_function_impl *impl);
 bool nir_opt_cse(nir_shader *shader);
 
+bool nir_opt_dce_impl(nir_function_impl *impl);
 bool nir_opt_dce(nir_shader *shader);
 
 bool nir_opt_dead_cf(nir_shader *shader);
@@ -6592,6 +6656,8 @@ bool nir_remove_single_src_phis_block(nir_block *block);
 
 bool nir_opt_phi_precision(nir_shader *shader);
 
+bool nir_opt_pre(nir_shader *shader, bool loads);
+
 bool nir_opt_phi_to_bool(nir_shader *shader);
 
 bool nir_opt_shrink_stores(nir_shader *shader, bool shrink_image_store);
@@ -6640,6 +6706,13 @@ typedef struct nir_opt_load_skip_helpers_options {
 bool nir_opt_load_skip_helpers(nir_shader *shader, nir_opt_load_skip_helpers_options *options);
 
 void nir_sweep(nir_shader *shader);
+void nir_compact_instrs(nir_shader *shader);
+
+typedef bool (*nir_impl_pass_cb)(nir_function_impl *impl, void *data);
+
+bool nir_shader_impls_parallel(nir_shader *shader, nir_impl_pass_cb pass,
+                               void *data);
+bool nir_opt_functions_parallel(nir_shader *shader);
 
 nir_intrinsic_op nir_intrinsic_from_system_value(gl_system_value val);
 gl_system_value nir_system_value_from_intrinsic(nir_intrinsic_op intrin);
@@ -1233,17 +1233,26 @@ static const nir_algebraic_table ${pass_name}_table = {
    .values = ${pass_name}_values,
    .expression_cond = ${ pass_name + "_expression_cond" if expression_cond else "NULL" },
    .variable_cond = ${ pass_name + "_variable_cond" if variable_cond else "NULL" },
+   .num_conditions = ${len(condition_list)},
 };
 
 bool
-${pass_name}(
-   nir_shader *shader
+${pass_name}_impl(
+   nir_function_impl *impl
+% for type, name in params:
+   , ${type} ${name}
+% endfor
+);
+
+bool
+${pass_name}_impl(
+   nir_function_impl *impl
 % for type, name in params:
    , ${type} ${name}
 % endfor
 ) {
-   bool progress = false;
    bool condition_flags[${len(condition_list)}];
+   const nir_shader *shader = impl->function->shader;
    const nir_shader_compiler_options *options = shader->options;
    const shader_info *info = &shader->info;
    (void) options;
@@ -1254,8 +1263,24 @@ ${pass_name}(
    condition_flags[${index}] = ${condition};
    % endfor
 
+   return nir_algebraic_impl(impl, condition_flags, &${pass_name}_table);
+}
+
+bool
+${pass_name}(
+   nir_shader *shader
+% for type, name in params:
+   , ${type} ${name}
+% endfor
+) {
+   bool progress = false;
+
    nir_foreach_function_impl(impl, shader) {
-     progress |= nir_algebraic_impl(impl, condition_flags, &${pass_name}_table);
+     progress |= ${pass_name}_impl(impl
+% for type, name in params:
+        , ${name}
+% endfor
+     );
    }
 
    return progress;
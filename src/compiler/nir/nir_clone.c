@@ -880,7 +880,7 @@ nir_shader_clone(void *mem_ctx, const nir_shader *s)
  * will be freed.
  *
  * This should only be used by test code which needs to swap out shaders with
- * a cloned or deserialized version.
+ * a cloned or deserialized version, and by nir_compact_instrs().
  */
 void
 nir_shader_replace(nir_shader *dst, nir_shader *src)
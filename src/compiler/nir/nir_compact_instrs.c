@@ -0,0 +1,36 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir.h"
+
+/**
+ * \file nir_compact_instrs.c
+ *
+ * Instructions are allocated one by one from the shader's gc_ctx, which
+ * hands out objects from per-size slabs. After many passes have inserted and
+ * removed instructions, the instructions of a block end up scattered
+ * over many partially used slabs and every step of nir_foreach_instr() is
+ * likely to be a cache miss.
+ *
+ * nir_compact_instrs() re-packs the shader by cloning it into a fresh gc_ctx
+ * and moving the clone back into the original nir_shader. The clone
+ * allocates blocks, instructions and their defs in program order, so that
+ * the instructions of each block end up next to each other in memory, in the
+ * order in which linear walks visit them. Instructions of different sizes are
+ * still kept in different slabs, the order within each slab is what matters.
+ *
+ * Like nir_sweep(), this also frees all memory that is no longer reachable
+ * from the shader. Unlike nir_sweep(), every pointer into the shader except
+ * the nir_shader itself is invalidated and all metadata is lost, so this
+ * should only be called between passes, e.g. after large lowering passes
+ * that create or delete a lot of instructions.
+ */
+
+void
+nir_compact_instrs(nir_shader *shader)
+{
+   nir_shader *clone = nir_shader_clone(ralloc_parent(shader), shader);
+   nir_shader_replace(shader, clone);
+}
@@ -353,8 +353,38 @@ struct lower_link_state {
    struct hash_table *shader_var_remap;
    const nir_shader *link_shader;
    unsigned printf_index_offset;
+
+   /* Name to nir_function maps of both shaders, so that linking doesn't
+    * search the whole function list of a large library like libclc for every
+    * call site.
+    */
+   struct hash_table *shader_funcs;
+   struct hash_table *link_funcs;
 };
 
+static struct hash_table *
+index_functions(void *mem_ctx, const nir_shader *shader)
+{
+   struct hash_table *funcs = _mesa_string_hash_table_create(mem_ctx);
+
+   /* Keep the first function of a name, like
+    * nir_shader_get_function_for_name().
+    */
+   nir_foreach_function(func, shader) {
+      if (func->name && !_mesa_hash_table_search(funcs, func->name))
+         _mesa_hash_table_insert(funcs, func->name, func);
+   }
+
+   return funcs;
+}
+
+static nir_function *
+lookup_function(struct hash_table *funcs, const char *name)
+{
+   struct hash_entry *entry = _mesa_hash_table_search(funcs, name);
+   return entry ? entry->data : NULL;
+}
+
 static bool
 lower_calls_vars_instr(struct nir_builder *b,
                        nir_instr *instr,
@@ -387,16 +417,19 @@ lower_calls_vars_instr(struct nir_builder *b,
       if (!ncall->callee->name)
          return false;
 
-      nir_function *func = nir_shader_get_function_for_name(b->shader, ncall->callee->name);
+      nir_function *func = lookup_function(state->shader_funcs, ncall->callee->name);
       if (func) {
          ncall->callee = func;
          break;
       }
 
       nir_function *new_func;
-      new_func = nir_shader_get_function_for_name(state->link_shader, ncall->callee->name);
-      if (new_func)
+      new_func = lookup_function(state->link_funcs, ncall->callee->name);
+      if (new_func) {
          ncall->callee = nir_function_clone(b->shader, new_func);
+         _mesa_hash_table_insert(state->shader_funcs, ncall->callee->name,
+                                 ncall->callee);
+      }
       break;
    }
    case nir_instr_type_intrinsic: {
@@ -454,7 +487,7 @@ function_link_pass(struct nir_builder *b,
    if (call->callee->impl)
       return false;
 
-   func = nir_shader_get_function_for_name(state->link_shader, call->callee->name);
+   func = lookup_function(state->link_funcs, call->callee->name);
    if (!func || !func->impl) {
       return false;
    }
@@ -471,15 +504,26 @@ nir_link_shader_functions(nir_shader *shader,
    struct hash_table *copy_vars = _mesa_pointer_hash_table_create(ra_ctx);
    bool progress = false, overall_progress = false;
 
+   struct set *visited = _mesa_pointer_set_create(ra_ctx);
+
    struct lower_link_state state = {
       .shader_var_remap = copy_vars,
       .link_shader = link_shader,
       .printf_index_offset = shader->printf_info_count,
+      .shader_funcs = index_functions(ra_ctx, shader),
+      .link_funcs = index_functions(ra_ctx, link_shader),
    };
    /* do progress passes inside the pass */
    do {
       progress = false;
       nir_foreach_function_impl(impl, shader) {
+         /* Linking only gives an impl to functions without one, so an impl
+          * that was already walked can't have anything left to link.
+          */
+         if (_mesa_set_search(visited, impl))
+            continue;
+         _mesa_set_add(visited, impl);
+
          bool this_progress = nir_function_instructions_pass(impl,
                                                              function_link_pass,
                                                              nir_metadata_none,
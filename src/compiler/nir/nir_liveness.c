@@ -46,7 +46,7 @@ struct live_defs_state {
    /* Used in propagate_across_edge() */
    struct u_sparse_bitset tmp_live;
 
-   nir_block_worklist worklist;
+   nir_block_priority_worklist worklist;
 };
 
 /* Initialize the liveness data to zero and add the given block to the
@@ -58,7 +58,7 @@ init_liveness_block(nir_block *block,
 {
    u_sparse_bitset_init(&block->live_in, state->num_bits, state->mem_ctx);
    u_sparse_bitset_init(&block->live_out, state->num_bits, state->mem_ctx);
-   nir_block_worklist_push_head(&state->worklist, block);
+   nir_block_priority_worklist_push(&state->worklist, block);
 }
 
 static bool
@@ -126,7 +126,7 @@ nir_live_defs_impl(nir_function_impl *impl)
       .mem_ctx = impl,
    };
 
-   nir_block_worklist_init(&state.worklist, impl->num_blocks, NULL);
+   nir_block_priority_worklist_init(&state.worklist, impl->num_blocks, NULL);
 
    /* Allocate live_in and live_out sets and add all of the blocks to the
     * worklist.
@@ -138,15 +138,16 @@ nir_live_defs_impl(nir_function_impl *impl)
    /* We're now ready to work through the worklist and update the liveness
     * sets of each of the blocks.  By the time we get to this point, every
     * block in the function implementation has been pushed onto the
-    * worklist in reverse order.  As long as we keep the worklist
-    * up-to-date as we go, everything will get covered.
+    * worklist.  As long as we keep the worklist up-to-date as we go,
+    * everything will get covered.
     */
-   while (!nir_block_worklist_is_empty(&state.worklist)) {
-      /* We pop them off in the reverse order we pushed them on.  This way
-       * the first walk of the instructions is backwards so we only walk
-       * once in the case of no control flow.
+   while (!nir_block_priority_worklist_is_empty(&state.worklist)) {
+      /* Always pop the block with the highest index.  Liveness flows
+       * backwards, so this way every block is processed after all of its
+       * successors except those reached through a loop's back edge, and
+       * the first walk is enough in the case of no loops.
        */
-      nir_block *block = nir_block_worklist_pop_head(&state.worklist);
+      nir_block *block = nir_block_priority_worklist_pop_last(&state.worklist);
 
       u_sparse_bitset_dup(&block->live_in, &block->live_out);
 
@@ -174,11 +175,11 @@ nir_live_defs_impl(nir_function_impl *impl)
       set_foreach(&block->predecessors, entry) {
          nir_block *pred = (nir_block *)entry->key;
          if (propagate_across_edge(pred, block, &state))
-            nir_block_worklist_push_tail(&state.worklist, pred);
+            nir_block_priority_worklist_push(&state.worklist, pred);
       }
    }
 
-   nir_block_worklist_fini(&state.worklist);
+   nir_block_priority_worklist_fini(&state.worklist);
 }
 
 /** Return the live set at a cursor
@@ -133,6 +133,81 @@ nu_handle_rewrite(nir_builder *b, struct nu_handle *h, nir_src *src)
    }
 }
 
+/* Returns the source of clone which corresponds to src of the original. */
+static nir_src *
+nu_clone_src(nir_instr *orig, nir_instr *clone, nir_src *src)
+{
+   if (orig->type == nir_instr_type_tex) {
+      unsigned i = (nir_tex_src *)src - nir_instr_as_tex(orig)->src;
+      return &nir_instr_as_tex(clone)->src[i].src;
+   } else {
+      unsigned i = src - nir_instr_as_intrinsic(orig)->src;
+      return &nir_instr_as_intrinsic(clone)->src[i];
+   }
+}
+
+/* Emits a copy of the accesses which uses the first invocation's handles, to
+ * be taken when they are the same for the whole subgroup.
+ */
+static nir_if *
+nu_emit_uniform_path(const nir_lower_non_uniform_access_options *options,
+                     nir_builder *b, const struct nu_handle_key *key,
+                     struct nu_handle_data *data, nir_src *first_src,
+                     struct util_dynarray *clones)
+{
+   nir_def *all_equal_first = NULL;
+   for (uint32_t i = 0; i < key->handle_count; i++) {
+      if (i && data->handles[i].handle == data->handles[0].handle) {
+         data->handles[i].first = data->handles[0].first;
+         continue;
+      }
+
+      nir_def *equal_first = nu_handle_compare(options, b, &data->handles[i], first_src);
+      if (i == 0)
+         all_equal_first = equal_first;
+      else
+         all_equal_first = nir_iand(b, all_equal_first, equal_first);
+   }
+
+   nir_if *nif = nir_push_if(b, nir_vote_all(b, 1, all_equal_first));
+
+   util_dynarray_foreach(&data->srcs, struct nu_handle_src, src) {
+      nir_instr *instr = nir_src_parent_instr(src->srcs[0]);
+      nir_instr *clone = nir_instr_clone(b->shader, instr);
+      nir_builder_instr_insert(b, clone);
+
+      b->cursor = nir_before_instr(clone);
+      for (uint32_t i = 0; i < key->handle_count; i++)
+         nu_handle_rewrite(b, &data->handles[i], nu_clone_src(instr, clone, src->srcs[i]));
+      b->cursor = nir_after_instr(clone);
+      util_dynarray_append(clones, clone);
+   }
+
+   nir_push_else(b, nif);
+   return nif;
+}
+
+/* Merges the results of the uniform path and the loop after the if. */
+static void
+nu_merge_uniform_path(nir_builder *b, struct nu_handle_data *data,
+                      struct util_dynarray *clones)
+{
+   nir_instr **clone = util_dynarray_begin(clones);
+
+   util_dynarray_foreach(&data->srcs, struct nu_handle_src, src) {
+      nir_def *def = nir_instr_def(nir_src_parent_instr(src->srcs[0]));
+      nir_def *clone_def = nir_instr_def(*clone++);
+      if (!def)
+         continue;
+
+      nir_def *phi = nir_if_phi(b, clone_def, def);
+      nir_foreach_use_including_if_safe(use, def) {
+         if (nir_src_is_if(use) || nir_src_parent_instr(use) != nir_def_instr(phi))
+            nir_src_rewrite(use, phi);
+      }
+   }
+}
+
 static bool
 get_first_use(nir_def *def, void *state)
 {
@@ -444,9 +519,26 @@ nir_lower_non_uniform_access_impl(nir_function_impl *impl,
       const struct nu_handle_key *key = entry->key;
       struct nu_handle_data data = *(struct nu_handle_data *)entry->data;
 
-      nir_src *first_src = util_dynarray_top_ptr(&data.srcs, struct nu_handle_src)->srcs[0];
+      struct nu_handle_src *last = util_dynarray_top_ptr(&data.srcs, struct nu_handle_src);
+      nir_src *first_src = last->srcs[0];
       b.cursor = nir_after_instr(nir_src_parent_instr(first_src));
 
+      struct util_dynarray clones;
+      util_dynarray_init(&clones, state.accesses);
+
+      nir_if *uniform_if = NULL;
+      if (options->uniform_fast_path) {
+         /* The handle may be the result of an access lowered earlier, which
+          * has been replaced by a phi since.
+          */
+         for (uint32_t i = 0; i < key->handle_count; i++) {
+            ASSERTED bool valid = nu_handle_init(&data.handles[i], last->srcs[i]);
+            assert(valid);
+         }
+
+         uniform_if = nu_emit_uniform_path(options, &b, key, &data, first_src, &clones);
+      }
+
       nir_push_loop(&b);
 
       nir_def *all_equal_first = NULL;
@@ -478,6 +570,11 @@ nir_lower_non_uniform_access_impl(nir_function_impl *impl,
 
       nir_pop_if(&b, NULL);
       nir_pop_loop(&b, NULL);
+
+      if (uniform_if) {
+         nir_pop_if(&b, uniform_if);
+         nu_merge_uniform_path(&b, &data, &clones);
+      }
    }
 
    _mesa_hash_table_destroy(state.accesses, NULL);
@@ -507,6 +604,16 @@ nir_lower_non_uniform_access_impl(nir_function_impl *impl,
  * break in the loop, the block containing the instruction dominates the end
  * of the loop.  Therefore, it's safe to move the instruction into the loop
  * without fixing up SSA in any way.
+ *
+ * With uniform_fast_path, the loop is only entered when the handles actually
+ * differ across the subgroup:
+ *
+ * if (allInvocationsARB(readFirstInvocationARB(texture) == texture)) {
+ *    res1 = texture(readFirstInvocationARB(texture), sampler, ...);
+ * } else {
+ *    loop { ... }
+ * }
+ * res = phi(res1, res);
  */
 bool
 nir_lower_non_uniform_access(nir_shader *shader,
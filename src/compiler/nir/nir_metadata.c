@@ -192,6 +192,11 @@ nir_metadata_require_most(nir_shader *shader)
       /* We don't know if divergence analysis supports this shader. */
       md &= ~nir_metadata_divergence;
 
+      /* These can only be computed by running the algebraic passes or
+       * nir_validate_shader().
+       */
+      md &= ~(nir_metadata_algebraic | nir_metadata_validated);
+
       if (!impl->structured) {
          /* These don't support unstructured control flow. */
          md &= ~nir_metadata_instr_index;
@@ -76,7 +76,7 @@ dominates(const nir_instr *old_instr, const nir_instr *new_instr)
    return nir_block_dominates(old_instr->block, new_instr->block);
 }
 
-static bool
+bool
 nir_opt_cse_impl(nir_function_impl *impl)
 {
    struct set instr_set;
@@ -54,7 +54,7 @@ visit_block(nir_block *block, nir_block *preheader)
 }
 
 static bool
-should_optimize_loop(nir_loop *loop)
+should_optimize_loop(nir_loop *loop, const nir_shader_compiler_options *options)
 {
    /* Ignore loops without back-edge */
    if (nir_loop_first_block(loop)->predecessors.entries == 1)
@@ -76,11 +76,20 @@ should_optimize_loop(nir_loop *loop)
          return false;
    }
 
+   /* Hoisting extends live ranges over the whole loop, let the backend decide
+    * whether that is worth it.
+    */
+   if (options->loop_transform_cost &&
+       options->loop_transform_cost(loop, nir_loop_transform_licm,
+                                    options->cb_data) >= 0)
+      return false;
+
    return true;
 }
 
 static bool
-visit_cf_list(struct exec_list *list, nir_block *preheader, nir_block *exit)
+visit_cf_list(struct exec_list *list, nir_block *preheader, nir_block *exit,
+              const nir_shader_compiler_options *options)
 {
    bool progress = false;
 
@@ -101,17 +110,18 @@ visit_cf_list(struct exec_list *list, nir_block *preheader, nir_block *exit)
       }
       case nir_cf_node_if: {
          nir_if *nif = nir_cf_node_as_if(node);
-         progress |= visit_cf_list(&nif->then_list, preheader, exit);
-         progress |= visit_cf_list(&nif->else_list, preheader, exit);
+         progress |= visit_cf_list(&nif->then_list, preheader, exit, options);
+         progress |= visit_cf_list(&nif->else_list, preheader, exit, options);
          break;
       }
       case nir_cf_node_loop: {
          nir_loop *loop = nir_cf_node_as_loop(node);
-         bool opt = should_optimize_loop(loop);
+         bool opt = should_optimize_loop(loop, options);
          nir_block *inner_preheader = opt ? nir_cf_node_cf_tree_prev(node) : preheader;
          nir_block *inner_exit = opt ? nir_cf_node_cf_tree_next(node) : exit;
-         progress |= visit_cf_list(&loop->body, inner_preheader, inner_exit);
-         progress |= visit_cf_list(&loop->continue_list, inner_preheader, inner_exit);
+         progress |= visit_cf_list(&loop->body, inner_preheader, inner_exit, options);
+         progress |= visit_cf_list(&loop->continue_list, inner_preheader, inner_exit,
+                                   options);
          break;
       }
       case nir_cf_node_function:
@@ -131,7 +141,7 @@ nir_opt_licm(nir_shader *shader)
       nir_metadata_require(impl, nir_metadata_block_index |
                                     nir_metadata_dominance);
 
-      bool impl_progress = visit_cf_list(&impl->body, NULL, NULL);
+      bool impl_progress = visit_cf_list(&impl->body, NULL, NULL, shader->options);
       progress |= nir_progress(impl_progress, impl,
                                nir_metadata_block_index | nir_metadata_dominance);
    }
@@ -914,6 +914,11 @@ check_unrolling_restrictions(nir_shader *shader, nir_loop *loop)
    if (li->force_unroll && !li->guessed_trip_count && trip_count <= max_iter)
       return true;
 
+   if (shader->options->loop_transform_cost) {
+      return shader->options->loop_transform_cost(loop, nir_loop_transform_unroll,
+                                                  shader->options->cb_data) < 0;
+   }
+
    unsigned cost_limit = max_iter * LOOP_UNROLL_LIMIT;
    unsigned cost = li->instr_cost * trip_count;
 
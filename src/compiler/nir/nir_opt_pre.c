@@ -0,0 +1,241 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/u_dynarray.h"
+#include "nir.h"
+#include "nir_builder.h"
+#include "nir_instr_set.h"
+
+/**
+ * \file nir_opt_pre.c
+ *
+ * Partial redundancy elimination around if statements.
+ *
+ * nir_opt_cse only removes an instruction if an equal one dominates it, so
+ * it misses these patterns:
+ *
+ *    if (c) {                         if (c) {
+ *       a = load_ubo(0, x)               a = load_ubo(0, x)
+ *    } else {                         }
+ *       b = load_ubo(0, x)            c = load_ubo(0, x)
+ *    }
+ *
+ * On the left, the value is computed on both paths, so it is hoisted above
+ * the if. On the right, it's computed twice when c is true. The pass inserts
+ * a copy at the end of the else branch and replaces the second computation
+ * with a phi. Neither transformation makes any path through the if longer.
+ *
+ * Only instructions whose sources are all defined before the if are
+ * considered, and only if they are executed unconditionally within their
+ * branch. This is enough to catch the redundant loads which survive
+ * nir_opt_cse and nir_opt_gcm in practice. Loads are only moved if
+ * nir_intrinsic_can_reorder() allows it, so load_ssbo and load_global need
+ * ACCESS_CAN_REORDER, e.g. from nir_opt_access.
+ */
+
+static bool
+can_move_load(nir_intrinsic_instr *intr)
+{
+   switch (intr->intrinsic) {
+   case nir_intrinsic_load_ubo:
+   case nir_intrinsic_load_ubo_vec4:
+   case nir_intrinsic_load_ssbo:
+   case nir_intrinsic_load_global:
+   case nir_intrinsic_load_global_constant:
+   case nir_intrinsic_load_push_constant:
+   case nir_intrinsic_load_uniform:
+   case nir_intrinsic_load_constant:
+      return nir_intrinsic_can_reorder(intr);
+   default:
+      return false;
+   }
+}
+
+static bool
+src_defined_before(nir_src *src, void *pre)
+{
+   return nir_block_dominates(nir_def_block(src->ssa), pre);
+}
+
+static bool
+is_candidate(nir_instr *instr, nir_block *pre, bool loads)
+{
+   switch (instr->type) {
+   case nir_instr_type_alu:
+      break;
+   case nir_instr_type_intrinsic:
+      if (!loads || !can_move_load(nir_instr_as_intrinsic(instr)))
+         return false;
+      break;
+   default:
+      return false;
+   }
+
+   return nir_foreach_src(instr, src_defined_before, pre);
+}
+
+/* Collects the candidates which are executed whenever the branch ending in
+ * "end" is taken.
+ */
+static void
+add_branch_candidates(struct set *set, struct util_dynarray *list,
+                      struct exec_list *branch, nir_block *end,
+                      nir_block *pre, bool loads)
+{
+   foreach_list_typed(nir_cf_node, node, node, branch) {
+      nir_foreach_block_in_cf_node(block, node) {
+         if (!nir_block_dominates(block, end))
+            continue;
+
+         nir_foreach_instr(instr, block) {
+            if (!is_candidate(instr, pre, loads))
+               continue;
+
+            bool found = false;
+            _mesa_set_search_or_add(set, instr, &found);
+            if (!found && list)
+               util_dynarray_append(list, instr);
+         }
+      }
+   }
+}
+
+static nir_instr *
+find_equal(struct set *set, nir_instr *instr)
+{
+   struct set_entry *entry = _mesa_set_search(set, instr);
+   return entry ? (nir_instr *)entry->key : NULL;
+}
+
+/* Replaces "old" with "instr", which computes the same value. */
+static void
+replace_with(nir_instr *old, nir_instr *instr)
+{
+   if (instr->type == nir_instr_type_alu)
+      nir_instr_as_alu(instr)->fp_math_ctrl |= nir_instr_as_alu(old)->fp_math_ctrl;
+
+   nir_def_rewrite_uses(nir_instr_def(old), nir_instr_def(instr));
+   nir_instr_remove(old);
+}
+
+static bool
+opt_pre_if(nir_builder *b, nir_if *nif, bool loads)
+{
+   nir_block *pre = nir_cf_node_as_block(nir_cf_node_prev(&nif->cf_node));
+   nir_block *after = nir_cf_node_as_block(nir_cf_node_next(&nif->cf_node));
+   nir_block *then_end = nir_if_last_then_block(nif);
+   nir_block *else_end = nir_if_last_else_block(nif);
+
+   /* Both branches need to flow into the block after the if. */
+   if (nir_block_ends_in_jump(then_end) || nir_block_ends_in_jump(else_end))
+      return false;
+
+   bool progress = false;
+
+   struct set then_set, else_set;
+   nir_instr_set_init(&then_set, NULL);
+   nir_instr_set_init(&else_set, NULL);
+
+   struct util_dynarray then_list;
+   util_dynarray_init(&then_list, NULL);
+
+   add_branch_candidates(&then_set, &then_list, &nif->then_list, then_end,
+                         pre, loads);
+   add_branch_candidates(&else_set, NULL, &nif->else_list, else_end,
+                         pre, loads);
+
+   /* Hoist what both branches compute. */
+   util_dynarray_foreach(&then_list, nir_instr *, instr_ptr) {
+      nir_instr *instr = *instr_ptr;
+      nir_instr *match = find_equal(&else_set, instr);
+      if (!match)
+         continue;
+
+      nir_instr_set_remove(&then_set, instr);
+      nir_instr_set_remove(&else_set, match);
+
+      nir_instr_remove(instr);
+      nir_instr_insert(nir_after_block_before_jump(pre), instr);
+      replace_with(match, instr);
+      progress = true;
+   }
+
+   /* Make what one branch computes available after the if. */
+   nir_foreach_instr_safe(instr, after) {
+      if (instr->type == nir_instr_type_phi || !is_candidate(instr, pre, loads))
+         continue;
+
+      nir_instr *then_instr = find_equal(&then_set, instr);
+      nir_instr *else_instr = find_equal(&else_set, instr);
+      if (!then_instr && !else_instr)
+         continue;
+
+      /* Both can't exist anymore, they would have been hoisted. */
+      assert(!then_instr || !else_instr);
+
+      if (then_instr) {
+         else_instr = nir_instr_clone(b->shader, instr);
+         nir_instr_insert(nir_after_block_before_jump(else_end), else_instr);
+         _mesa_set_add(&else_set, else_instr);
+      } else {
+         then_instr = nir_instr_clone(b->shader, instr);
+         nir_instr_insert(nir_after_block_before_jump(then_end), then_instr);
+         _mesa_set_add(&then_set, then_instr);
+      }
+
+      nir_def *def = nir_instr_def(instr);
+      nir_phi_instr *phi = nir_phi_instr_create(b->shader);
+      nir_def_init(&phi->instr, &phi->def, def->num_components, def->bit_size);
+      nir_phi_instr_add_src(phi, then_end, nir_instr_def(then_instr));
+      nir_phi_instr_add_src(phi, else_end, nir_instr_def(else_instr));
+      nir_instr_insert(nir_after_phis(after), &phi->instr);
+
+      nir_def_rewrite_uses(def, &phi->def);
+      nir_instr_remove(instr);
+      progress = true;
+   }
+
+   util_dynarray_fini(&then_list);
+   nir_instr_set_fini(&then_set);
+   nir_instr_set_fini(&else_set);
+
+   return progress;
+}
+
+static bool
+opt_pre_impl(nir_function_impl *impl, bool loads)
+{
+   bool progress = false;
+
+   nir_metadata_require(impl, nir_metadata_dominance);
+
+   nir_builder b = nir_builder_create(impl);
+
+   /* Inner ifs come first, so that what they hoist can be hoisted further by
+    * the outer ones.
+    */
+   nir_foreach_block(block, impl) {
+      nir_cf_node *prev = nir_cf_node_prev(&block->cf_node);
+      if (prev && prev->type == nir_cf_node_if)
+         progress |= opt_pre_if(&b, nir_cf_node_as_if(prev), loads);
+   }
+
+   return nir_progress(progress, impl, nir_metadata_control_flow);
+}
+
+/**
+ * \param loads   Also move reorderable loads, not only ALU instructions.
+ */
+bool
+nir_opt_pre(nir_shader *shader, bool loads)
+{
+   bool progress = false;
+
+   nir_foreach_function_impl(impl, shader) {
+      progress |= opt_pre_impl(impl, loads);
+   }
+
+   return progress;
+}
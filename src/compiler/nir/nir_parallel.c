@@ -0,0 +1,168 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/u_call_once.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_queue.h"
+#include "nir.h"
+
+/**
+ * \file nir_parallel.c
+ *
+ * Runs function-local passes on all function implementations of a shader at
+ * once, using a thread pool shared by all shaders. This is mostly useful for
+ * OpenCL kernels, which may contain hundreds of functions that are never
+ * inlined.
+ *
+ * A pass run this way may only touch the nir_function_impl it's given. It may
+ * create, rewrite and free instructions and control flow in that impl and
+ * require or invalidate its metadata, which is all kept per impl. It must not
+ * look at other functions or modify anything that is shared by the whole
+ * shader, like variables, shader_info or the constant data. While the passes
+ * run, the shader's gc_ctx is made thread-safe and the few ralloc allocations
+ * parented to the shader itself take nir_shader::parallel_lock.
+ */
+
+#define MAX_THREADS 8
+
+/* Below this, the synchronization costs more than it saves. */
+#define MIN_PARALLEL_IMPLS 4
+
+static struct util_queue nir_queue;
+static bool nir_queue_initialized;
+static util_once_flag nir_queue_once = UTIL_ONCE_FLAG_INIT;
+
+static void
+init_queue(void)
+{
+   unsigned num_threads = CLAMP(util_get_cpu_caps()->nr_cpus, 1, MAX_THREADS);
+
+   nir_queue_initialized =
+      util_queue_init(&nir_queue, "nir", 64, num_threads,
+                      UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL);
+}
+
+struct impl_job {
+   nir_function_impl *impl;
+   nir_impl_pass_cb pass;
+   void *data;
+   bool progress;
+   struct util_queue_fence fence;
+};
+
+static void
+run_impl_job(void *_job, void *gdata, int thread_index)
+{
+   struct impl_job *job = _job;
+   job->progress = job->pass(job->impl, job->data);
+}
+
+static bool
+impls_serial(nir_shader *shader, nir_impl_pass_cb pass, void *data)
+{
+   bool progress = false;
+
+   nir_foreach_function_impl(impl, shader) {
+      progress |= pass(impl, data);
+   }
+
+   return progress;
+}
+
+/**
+ * Runs \p pass on every function implementation of \p shader, with different
+ * implementations running on different threads. See the top of this file for
+ * what the pass is allowed to do. Returns whether \p pass made progress on any
+ * implementation.
+ */
+bool
+nir_shader_impls_parallel(nir_shader *shader, nir_impl_pass_cb pass,
+                          void *data)
+{
+   unsigned num_impls = 0;
+   nir_foreach_function_impl(impl, shader) {
+      num_impls++;
+   }
+
+   /* A pass that already runs on a thread of the queue must not wait for
+    * other jobs of the same queue, so nested calls are always serial.
+    */
+   if (num_impls < MIN_PARALLEL_IMPLS || shader->parallel_lock)
+      return impls_serial(shader, pass, data);
+
+   util_call_once(&nir_queue_once, init_queue);
+   if (!nir_queue_initialized)
+      return impls_serial(shader, pass, data);
+
+   struct impl_job *jobs = calloc(num_impls, sizeof(*jobs));
+   if (!jobs)
+      return impls_serial(shader, pass, data);
+
+   simple_mtx_t lock;
+   simple_mtx_init(&lock, mtx_plain);
+   shader->parallel_lock = &lock;
+   gc_set_thread_safe(shader->gctx, true);
+
+   unsigned i = 0;
+   nir_foreach_function_impl(impl, shader) {
+      struct impl_job *job = &jobs[i];
+      job->impl = impl;
+      job->pass = pass;
+      job->data = data;
+      util_queue_fence_init(&job->fence);
+
+      /* The first implementation is handled by this thread. */
+      if (i > 0) {
+         util_queue_add_job(&nir_queue, job, &job->fence, run_impl_job,
+                            NULL, 0);
+      }
+      i++;
+   }
+
+   run_impl_job(&jobs[0], NULL, 0);
+
+   bool progress = false;
+   for (i = 0; i < num_impls; i++) {
+      if (i > 0)
+         util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+      progress |= jobs[i].progress;
+   }
+
+   gc_set_thread_safe(shader->gctx, false);
+   shader->parallel_lock = NULL;
+   simple_mtx_destroy(&lock);
+   free(jobs);
+
+   return progress;
+}
+
+static bool
+opt_function(nir_function_impl *impl, void *data)
+{
+   bool progress = false;
+   bool this_progress;
+
+   do {
+      this_progress = false;
+      this_progress |= nir_opt_copy_prop_impl(impl);
+      this_progress |= nir_opt_dce_impl(impl);
+      this_progress |= nir_opt_cse_impl(impl);
+      this_progress |= nir_opt_algebraic_impl(impl);
+      progress |= this_progress;
+   } while (this_progress);
+
+   return progress;
+}
+
+/**
+ * Runs copy propagation, DCE, CSE and nir_opt_algebraic to a fixed point on
+ * all functions of the shader in parallel.
+ */
+bool
+nir_opt_functions_parallel(nir_shader *shader)
+{
+   return nir_shader_impls_parallel(shader, opt_function, NULL);
+}
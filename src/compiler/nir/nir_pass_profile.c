@@ -0,0 +1,131 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * NIR_DEBUG=profile_passes collects the number of calls, the number of calls
+ * which made progress and the time spent for every pass run with NIR_PASS.
+ * The statistics are aggregated for the whole process and printed at exit,
+ * which helps finding passes in optimization loops which cost a lot of time
+ * but rarely make progress.
+ *
+ * Passes which run other passes with NIR_PASS are timed including them.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/hash_table.h"
+#include "util/os_time.h"
+#include "util/ralloc.h"
+#include "util/simple_mtx.h"
+#include "nir.h"
+
+#ifndef NDEBUG
+
+struct nir_pass_profile {
+   const char *name;
+   uint64_t calls;
+   uint64_t progress;
+   uint64_t time_ns;
+};
+
+static simple_mtx_t profile_mtx = SIMPLE_MTX_INITIALIZER;
+static struct hash_table *profile_ht;
+
+static int
+compare_time(const void *_a, const void *_b)
+{
+   const struct nir_pass_profile *a = *(const struct nir_pass_profile **)_a;
+   const struct nir_pass_profile *b = *(const struct nir_pass_profile **)_b;
+
+   if (a->time_ns != b->time_ns)
+      return a->time_ns < b->time_ns ? 1 : -1;
+
+   return strcmp(a->name, b->name);
+}
+
+static void
+nir_pass_profile_print(void)
+{
+   simple_mtx_lock(&profile_mtx);
+
+   unsigned num_passes = profile_ht->entries;
+   struct nir_pass_profile **passes = malloc(num_passes * sizeof(*passes));
+   if (!passes)
+      goto out;
+
+   unsigned i = 0;
+   uint64_t total_ns = 0;
+   hash_table_foreach(profile_ht, entry) {
+      passes[i++] = entry->data;
+      total_ns += ((struct nir_pass_profile *)entry->data)->time_ns;
+   }
+
+   qsort(passes, num_passes, sizeof(*passes), compare_time);
+
+   fprintf(stderr, "NIR pass profile, %.3f ms in total:\n", total_ns / 1e6);
+   fprintf(stderr, "%-48s %10s %10s %9s %12s %10s\n",
+           "pass", "calls", "progress", "ratio", "total ms", "avg us");
+
+   for (i = 0; i < num_passes; i++) {
+      const struct nir_pass_profile *p = passes[i];
+
+      fprintf(stderr, "%-48s %10" PRIu64 " %10" PRIu64 " %8.1f%% %12.3f %10.3f\n",
+              p->name, p->calls, p->progress,
+              100.0 * p->progress / p->calls,
+              p->time_ns / 1e6, p->time_ns / 1e3 / p->calls);
+   }
+
+   free(passes);
+
+out:
+   simple_mtx_unlock(&profile_mtx);
+}
+
+int64_t
+nir_pass_profile_start(void)
+{
+   return os_time_get_nano();
+}
+
+void
+nir_pass_profile_end(const char *pass, int64_t start, bool progress)
+{
+   int64_t time_ns = os_time_get_nano() - start;
+
+   simple_mtx_lock(&profile_mtx);
+
+   if (!profile_ht) {
+      profile_ht = _mesa_string_hash_table_create(NULL);
+      if (!profile_ht)
+         goto out;
+
+      atexit(nir_pass_profile_print);
+   }
+
+   struct nir_pass_profile *profile;
+   struct hash_entry *entry = _mesa_hash_table_search(profile_ht, pass);
+   if (entry) {
+      profile = entry->data;
+   } else {
+      profile = rzalloc(profile_ht, struct nir_pass_profile);
+      if (!profile)
+         goto out;
+
+      profile->name = ralloc_strdup(profile, pass);
+      _mesa_hash_table_insert(profile_ht, profile->name, profile);
+   }
+
+   profile->calls++;
+   profile->progress += progress;
+   profile->time_ns += time_ns;
+
+out:
+   simple_mtx_unlock(&profile_mtx);
+}
+
+#endif /* NDEBUG */
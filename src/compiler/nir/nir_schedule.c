@@ -105,9 +105,20 @@ typedef struct {
    uint32_t time;
 
    /* Number of channels currently used by the NIR instructions that have been
-    * scheduled.
+    * scheduled.  With a register file described in the options, this is in
+    * 32-bit registers of that file instead, and uniform_pressure tracks the
+    * uniform register file, if any.
     */
    int pressure;
+   int uniform_pressure;
+
+   /* Highest values of pressure and uniform_pressure seen so far. */
+   int max_pressure;
+   int max_uniform_pressure;
+
+   /* Pressure at which we switch to the CSR heuristic. */
+   int threshold;
+   int uniform_threshold;
 
    /* Options specified by the backend */
    const nir_schedule_options *options;
@@ -172,23 +183,56 @@ nir_schedule_scoreboard_get_src(nir_schedule_scoreboard *scoreboard, nir_src *sr
    return _mesa_hash_table_search_data(scoreboard->remaining_uses, src->ssa);
 }
 
+static bool
+nir_schedule_tracks_reg_file(nir_schedule_scoreboard *scoreboard)
+{
+   return scoreboard->options->reg_file_size != 0;
+}
+
+/* Returns whether the value lives in the uniform register file. */
+static bool
+nir_schedule_def_is_uniform(nir_schedule_scoreboard *scoreboard, nir_def *def)
+{
+   return scoreboard->options->uniform_reg_file_size != 0 && !def->divergent;
+}
+
+/* Number of registers taken by a value, in channels or, when tracking a
+ * register file, in 32-bit registers.  Booleans are assumed to take a full
+ * register per channel.
+ */
+static int
+nir_schedule_value_pressure(nir_schedule_scoreboard *scoreboard,
+                            unsigned num_components, unsigned bit_size)
+{
+   if (!nir_schedule_tracks_reg_file(scoreboard))
+      return num_components;
+
+   if (bit_size == 1)
+      bit_size = 32;
+
+   return DIV_ROUND_UP(num_components * bit_size, 32);
+}
+
 static int
-nir_schedule_reg_pressure(nir_def *reg)
+nir_schedule_reg_pressure(nir_schedule_scoreboard *scoreboard, nir_def *reg)
 {
    nir_intrinsic_instr *decl = nir_reg_get_decl(reg);
-   return nir_intrinsic_num_components(decl);
+   return nir_schedule_value_pressure(scoreboard,
+                                      nir_intrinsic_num_components(decl),
+                                      nir_intrinsic_bit_size(decl));
 }
 
 static int
-nir_schedule_def_pressure(nir_def *def)
+nir_schedule_def_pressure(nir_schedule_scoreboard *scoreboard, nir_def *def)
 {
-   return def->num_components;
+   return nir_schedule_value_pressure(scoreboard, def->num_components,
+                                      def->bit_size);
 }
 
 static int
-nir_schedule_src_pressure(nir_src *src)
+nir_schedule_src_pressure(nir_schedule_scoreboard *scoreboard, nir_src *src)
 {
-   return nir_schedule_def_pressure(src->ssa);
+   return nir_schedule_def_pressure(scoreboard, src->ssa);
 }
 
 /**
@@ -541,7 +585,7 @@ nir_schedule_regs_freed_src_cb(nir_src *src, void *in_state)
 
    if (remaining_uses->entries == 1 &&
        _mesa_set_search(remaining_uses, nir_src_parent_instr(src))) {
-      state->regs_freed += nir_schedule_src_pressure(src);
+      state->regs_freed += nir_schedule_src_pressure(scoreboard, src);
    }
 
    return true;
@@ -552,7 +596,7 @@ nir_schedule_regs_freed_def_cb(nir_def *def, void *in_state)
 {
    nir_schedule_regs_freed_state *state = in_state;
 
-   state->regs_freed -= nir_schedule_def_pressure(def);
+   state->regs_freed -= nir_schedule_def_pressure(state->scoreboard, def);
 
    return true;
 }
@@ -572,7 +616,7 @@ nir_schedule_regs_freed_load_reg(nir_intrinsic_instr *load,
 
    if (remaining_uses->entries == 1 &&
        _mesa_set_search(remaining_uses, &load->instr)) {
-      state->regs_freed += nir_schedule_reg_pressure(reg);
+      state->regs_freed += nir_schedule_reg_pressure(scoreboard, reg);
    }
 
    nir_schedule_regs_freed_def_cb(&load->def, state);
@@ -593,7 +637,7 @@ nir_schedule_regs_freed_store_reg(nir_intrinsic_instr *store,
 
    /* Only the first def of a reg counts against register pressure. */
    if (!_mesa_set_search(scoreboard->live_values, reg))
-      state->regs_freed -= nir_schedule_reg_pressure(reg);
+      state->regs_freed -= nir_schedule_reg_pressure(scoreboard, reg);
 }
 
 static bool
@@ -870,12 +914,18 @@ static void
 nir_schedule_mark_use(nir_schedule_scoreboard *scoreboard,
                       void *reg_or_def,
                       nir_instr *reg_or_def_parent,
-                      int pressure)
+                      int pressure, int uniform_pressure)
 {
    /* Make the value live if it's the first time it's been used. */
    if (!_mesa_set_search(scoreboard->live_values, reg_or_def)) {
       _mesa_set_add(scoreboard->live_values, reg_or_def);
       scoreboard->pressure += pressure;
+      scoreboard->uniform_pressure += uniform_pressure;
+
+      scoreboard->max_pressure = MAX2(scoreboard->max_pressure,
+                                      scoreboard->pressure);
+      scoreboard->max_uniform_pressure = MAX2(scoreboard->max_uniform_pressure,
+                                              scoreboard->uniform_pressure);
    }
 
    /* Make the value dead if it's the last remaining use.  Be careful when one
@@ -887,11 +937,26 @@ nir_schedule_mark_use(nir_schedule_scoreboard *scoreboard,
    if (entry) {
       _mesa_set_remove(remaining_uses, entry);
 
-      if (remaining_uses->entries == 0)
+      if (remaining_uses->entries == 0) {
          scoreboard->pressure -= pressure;
+         scoreboard->uniform_pressure -= uniform_pressure;
+      }
    }
 }
 
+/* Uses of SSA values count against the register file they live in. */
+static void
+nir_schedule_mark_def_use(nir_schedule_scoreboard *scoreboard, nir_def *def,
+                          nir_instr *parent)
+{
+   int pressure = nir_schedule_def_pressure(scoreboard, def);
+
+   if (nir_schedule_def_is_uniform(scoreboard, def))
+      nir_schedule_mark_use(scoreboard, def, parent, 0, pressure);
+   else
+      nir_schedule_mark_use(scoreboard, def, parent, pressure, 0);
+}
+
 static bool
 nir_schedule_mark_src_scheduled(nir_src *src, void *state)
 {
@@ -909,7 +974,7 @@ nir_schedule_mark_src_scheduled(nir_src *src, void *state)
        * they're often folded as immediates into backend instructions and have
        * many unrelated instructions all referencing the same value (0).
        */
-      if (!nir_def_is_const(src->ssa)) {
+      if (scoreboard->instr_map && !nir_def_is_const(src->ssa)) {
          nir_foreach_use(other_src, src->ssa) {
             if (nir_src_parent_instr(other_src) == nir_src_parent_instr(src))
                continue;
@@ -931,10 +996,7 @@ nir_schedule_mark_src_scheduled(nir_src *src, void *state)
       }
    }
 
-   nir_schedule_mark_use(scoreboard,
-                         (void *)src->ssa,
-                         nir_src_parent_instr(src),
-                         nir_schedule_src_pressure(src));
+   nir_schedule_mark_def_use(scoreboard, src->ssa, nir_src_parent_instr(src));
 
    return true;
 }
@@ -944,8 +1006,7 @@ nir_schedule_mark_def_scheduled(nir_def *def, void *state)
 {
    nir_schedule_scoreboard *scoreboard = state;
 
-   nir_schedule_mark_use(scoreboard, def, nir_def_instr(def),
-                         nir_schedule_def_pressure(def));
+   nir_schedule_mark_def_use(scoreboard, def, nir_def_instr(def));
 
    return true;
 }
@@ -961,7 +1022,7 @@ nir_schedule_mark_load_reg_scheduled(nir_intrinsic_instr *load,
       nir_schedule_mark_src_scheduled(&load->src[1], scoreboard);
 
    nir_schedule_mark_use(scoreboard, reg, &load->instr,
-                         nir_schedule_reg_pressure(reg));
+                         nir_schedule_reg_pressure(scoreboard, reg), 0);
 
    nir_schedule_mark_def_scheduled(&load->def, scoreboard);
 }
@@ -983,7 +1044,7 @@ nir_schedule_mark_store_reg_scheduled(nir_intrinsic_instr *store,
     * nodes that also "use" the reg.
     */
    nir_schedule_mark_use(scoreboard, reg, &store->instr,
-                         nir_schedule_reg_pressure(reg));
+                         nir_schedule_reg_pressure(scoreboard, reg), 0);
 }
 
 static bool
@@ -1013,14 +1074,21 @@ nir_schedule_mark_reg_intrin_scheduled(nir_instr *instr,
    }
 }
 
+static void
+nir_schedule_mark_instr_scheduled(nir_schedule_scoreboard *scoreboard,
+                                  nir_instr *instr)
+{
+   if (!nir_schedule_mark_reg_intrin_scheduled(instr, scoreboard)) {
+      nir_foreach_src(instr, nir_schedule_mark_src_scheduled, scoreboard);
+      nir_foreach_def(instr, nir_schedule_mark_def_scheduled, scoreboard);
+   }
+}
+
 static void
 nir_schedule_mark_node_scheduled(nir_schedule_scoreboard *scoreboard,
                                  nir_schedule_node *n)
 {
-   if (!nir_schedule_mark_reg_intrin_scheduled(n->instr, scoreboard)) {
-      nir_foreach_src(n->instr, nir_schedule_mark_src_scheduled, scoreboard);
-      nir_foreach_def(n->instr, nir_schedule_mark_def_scheduled, scoreboard);
-   }
+   nir_schedule_mark_instr_scheduled(scoreboard, n->instr);
 
    util_dynarray_foreach(&n->dag.edges, struct dag_edge, edge) {
       nir_schedule_node *child = (nir_schedule_node *)edge->child;
@@ -1055,7 +1123,8 @@ nir_schedule_instructions(nir_schedule_scoreboard *scoreboard, nir_block *block)
       nir_schedule_node *chosen;
       if (scoreboard->options->fallback)
          chosen = nir_schedule_choose_instruction_fallback(scoreboard);
-      else if (scoreboard->pressure < scoreboard->options->threshold)
+      else if (scoreboard->pressure < scoreboard->threshold &&
+               scoreboard->uniform_pressure < scoreboard->uniform_threshold)
          chosen = nir_schedule_choose_instruction_csp(scoreboard);
       else
          chosen = nir_schedule_choose_instruction_csr(scoreboard);
@@ -1199,6 +1268,20 @@ nir_schedule_ssa_def_init_scoreboard(nir_def *def, void *state)
    return true;
 }
 
+/* Without an explicit threshold, leave 1/8th of the register file as
+ * headroom, since the CSR heuristic can't always free a register right away.
+ */
+static int
+nir_schedule_get_threshold(int threshold, unsigned reg_file_size,
+                           unsigned simd_width)
+{
+   if (threshold || !reg_file_size)
+      return threshold;
+
+   int num_regs = reg_file_size / (4 * MAX2(simd_width, 1));
+   return MAX2(num_regs - num_regs / 8, 1);
+}
+
 static nir_schedule_scoreboard *
 nir_schedule_get_scoreboard(nir_shader *shader,
                             const nir_schedule_options *options)
@@ -1210,8 +1293,18 @@ nir_schedule_get_scoreboard(nir_shader *shader,
    scoreboard->remaining_uses = _mesa_pointer_hash_table_create(scoreboard);
    scoreboard->options = options;
    scoreboard->pressure = 0;
+   scoreboard->threshold = nir_schedule_get_threshold(options->threshold,
+                                                      options->reg_file_size,
+                                                      options->simd_width);
+   scoreboard->uniform_threshold =
+      options->uniform_reg_file_size ?
+         nir_schedule_get_threshold(0, options->uniform_reg_file_size, 1) :
+         INT_MAX;
 
    nir_foreach_function_impl(impl, shader) {
+      if (options->uniform_reg_file_size)
+         nir_metadata_require(impl, nir_metadata_divergence);
+
       nir_foreach_block(block, impl) {
          nir_foreach_instr(instr, block) {
             nir_foreach_def(instr, nir_schedule_ssa_def_init_scoreboard,
@@ -1254,6 +1347,30 @@ nir_schedule_validate_uses(nir_schedule_scoreboard *scoreboard)
    assert(!any_uses);
 }
 
+/* Returns the maximum pressure of the current instruction order, as seen by
+ * the same model the scheduler uses.
+ */
+static void
+nir_schedule_measure(nir_shader *shader, const nir_schedule_options *options,
+                     int *max_pressure, int *max_uniform_pressure)
+{
+   nir_schedule_scoreboard *scoreboard = nir_schedule_get_scoreboard(shader,
+                                                                     options);
+
+   nir_foreach_function_impl(impl, shader) {
+      nir_foreach_block(block, impl) {
+         nir_foreach_instr(instr, block) {
+            nir_schedule_mark_instr_scheduled(scoreboard, instr);
+         }
+      }
+   }
+
+   *max_pressure = scoreboard->max_pressure;
+   *max_uniform_pressure = scoreboard->max_uniform_pressure;
+
+   ralloc_free(scoreboard);
+}
+
 /**
  * Schedules the NIR instructions to try to decrease stalls (for example,
  * delaying texture reads) while managing register pressure.
@@ -1266,11 +1383,25 @@ nir_schedule_validate_uses(nir_schedule_scoreboard *scoreboard)
  * payload values, for example), since the heuristic may not always be able to
  * free a register immediately.  The amount below the limit is up to you to
  * tune.
+ *
+ * Alternatively, backends can describe their register files with
+ * reg_file_size, simd_width and uniform_reg_file_size, which makes pressure
+ * be tracked in 32-bit registers of each file and derives the threshold from
+ * the file sizes.  That's meant for running the scheduler as a pre-pass to
+ * reduce spilling on backends with their own scheduler.
  */
 bool
 nir_schedule(nir_shader *shader,
              const nir_schedule_options *options)
 {
+   bool want_stats = options->stats || NIR_DEBUG(SCHEDULE_STATS);
+   nir_schedule_stats stats = { 0 };
+
+   if (want_stats) {
+      nir_schedule_measure(shader, options, &stats.max_pressure_before,
+                           &stats.max_uniform_pressure_before);
+   }
+
    nir_schedule_scoreboard *scoreboard = nir_schedule_get_scoreboard(shader,
                                                                      options);
 
@@ -1291,6 +1422,25 @@ nir_schedule(nir_shader *shader,
 
    nir_schedule_validate_uses(scoreboard);
 
+   stats.max_pressure_after = scoreboard->max_pressure;
+   stats.max_uniform_pressure_after = scoreboard->max_uniform_pressure;
+
+   if (NIR_DEBUG(SCHEDULE_STATS)) {
+      fprintf(stderr, "nir_schedule: %s shader %s: max pressure %d -> %d",
+              _mesa_shader_stage_to_abbrev(shader->info.stage),
+              shader->info.name ? shader->info.name : "(unnamed)",
+              stats.max_pressure_before, stats.max_pressure_after);
+      if (options->uniform_reg_file_size) {
+         fprintf(stderr, ", uniform %d -> %d",
+                 stats.max_uniform_pressure_before,
+                 stats.max_uniform_pressure_after);
+      }
+      fprintf(stderr, "\n");
+   }
+
+   if (options->stats)
+      *options->stats = stats;
+
    ralloc_free(scoreboard);
    return true;
 }
@@ -47,6 +47,17 @@ typedef struct nir_schedule_dependency {
    } type;
 } nir_schedule_dependency;
 
+/**
+ * Maximum register pressure of a shader before and after scheduling, in the
+ * units of nir_schedule_options::threshold.
+ */
+typedef struct nir_schedule_stats {
+   int max_pressure_before;
+   int max_pressure_after;
+   int max_uniform_pressure_before;
+   int max_uniform_pressure_after;
+} nir_schedule_stats;
+
 typedef struct nir_schedule_options {
    /* On some hardware with some stages the inputs and outputs to the shader
     * share the same memory. In that case the scheduler needs to ensure that
@@ -58,6 +69,24 @@ typedef struct nir_schedule_options {
     * will try to reduce register usage.
     */
    int threshold;
+   /* Size in bytes of the register file available to one thread, for all
+    * invocations it runs together.  If set, pressure is tracked in 32-bit
+    * registers instead of channels, taking the bit size of values into
+    * account, and a threshold of 0 is derived from the register file size
+    * and simd_width.
+    */
+   unsigned reg_file_size;
+   /* Number of invocations sharing the register file, e.g. the dispatch width
+    * or the wave size.  0 is treated as 1.
+    */
+   unsigned simd_width;
+   /* Size in bytes of a separate register file for values that are uniform
+    * across the invocations, like the scalar registers of AMD hardware.  If
+    * set, values that divergence analysis finds uniform are tracked against
+    * this file instead, and the scheduler also tries to reduce pressure when
+    * it's close to full.  Requires reg_file_size.
+    */
+   unsigned uniform_reg_file_size;
    /* If set, instead of trying to optimise parallelism, the scheduler will try
     * to always minimise register pressure. This can be used as a fallback when
     * register allocation fails so that it can at least try to generate a
@@ -81,6 +110,11 @@ typedef struct nir_schedule_options {
    /* Data to pass to the instruction delay callback */
    void *instr_delay_cb_data;
 
+   /* If set, filled in with the register pressure before and after
+    * scheduling.
+    */
+   nir_schedule_stats *stats;
+
 } nir_schedule_options;
 
 bool nir_schedule(nir_shader *shader, const nir_schedule_options *options);
@@ -914,6 +914,55 @@ nir_algebraic_instr(nir_builder *build, nir_instr *instr,
    return false;
 }
 
+static bool
+algebraic_is_unchanged(nir_function_impl *impl,
+                       const bool *condition_flags,
+                       const nir_algebraic_table *table)
+{
+   if (!(impl->valid_metadata & nir_metadata_algebraic))
+      return false;
+
+   for (unsigned i = 0; i < impl->num_algebraic_no_progress; i++) {
+      if (impl->algebraic_no_progress[i].table == table &&
+          !memcmp(impl->algebraic_no_progress[i].condition_flags,
+                  condition_flags, table->num_conditions * sizeof(bool)))
+         return true;
+   }
+
+   return false;
+}
+
+static void
+algebraic_record_no_progress(nir_function_impl *impl,
+                             const bool *condition_flags,
+                             const nir_algebraic_table *table)
+{
+   if (!(impl->valid_metadata & nir_metadata_algebraic)) {
+      for (unsigned i = 0; i < impl->num_algebraic_no_progress; i++)
+         ralloc_free(impl->algebraic_no_progress[i].condition_flags);
+      impl->num_algebraic_no_progress = 0;
+      impl->valid_metadata |= nir_metadata_algebraic;
+   }
+
+   /* Forget the oldest pass if all the slots are used. */
+   unsigned num = impl->num_algebraic_no_progress;
+   if (num == ARRAY_SIZE(impl->algebraic_no_progress)) {
+      ralloc_free(impl->algebraic_no_progress[0].condition_flags);
+      memmove(&impl->algebraic_no_progress[0], &impl->algebraic_no_progress[1],
+              (num - 1) * sizeof(impl->algebraic_no_progress[0]));
+      num--;
+   }
+
+   bool *flags = ralloc_memdup(impl, condition_flags,
+                               table->num_conditions * sizeof(bool));
+   if (!flags)
+      return;
+
+   impl->algebraic_no_progress[num].table = table;
+   impl->algebraic_no_progress[num].condition_flags = flags;
+   impl->num_algebraic_no_progress = num + 1;
+}
+
 bool
 nir_algebraic_impl(nir_function_impl *impl,
                    const bool *condition_flags,
@@ -921,6 +970,16 @@ nir_algebraic_impl(nir_function_impl *impl,
 {
    bool progress = false;
 
+   /* Optimization loops often run the same algebraic pass again without any
+    * other pass changing the shader in between.  That can't find anything
+    * new, so skip it.
+    */
+   const bool skip_unchanged =
+      impl->function->shader->options->skip_unchanged_algebraic;
+   if (skip_unchanged &&
+       algebraic_is_unchanged(impl, condition_flags, table))
+      return nir_no_progress(impl);
+
    nir_builder build = nir_builder_create(impl);
 
    /* Note: it's important here that we're allocating a zeroed array, since
@@ -989,5 +1048,8 @@ nir_algebraic_impl(nir_function_impl *impl,
    _mesa_hash_table_fini(&range_ht, NULL);
    util_dynarray_fini(&states);
 
+   if (!progress && skip_unchanged)
+      algebraic_record_no_progress(impl, condition_flags, table);
+
    return nir_progress(progress, impl, nir_metadata_control_flow);
 }
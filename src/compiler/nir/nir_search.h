@@ -235,6 +235,9 @@ typedef struct {
     * nir_search_variable->cond.
     */
    const nir_search_variable_cond *variable_cond;
+
+   /** Number of condition flags passed to nir_algebraic_impl(). */
+   unsigned num_conditions;
 } nir_algebraic_table;
 
 /* Note: these must match the start states created in
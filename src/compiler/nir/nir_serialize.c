@@ -2330,6 +2330,36 @@ nir_deserialize(void *mem_ctx,
    return ctx.nir;
 }
 
+/**
+ * Reads only the shader_info of a serialized shader.
+ *
+ * The shader_info is at the start of the serialized data, so this doesn't
+ * need to rebuild any of the shader. The name and label are allocated on
+ * \p mem_ctx. Returns false if the blob doesn't contain a whole header.
+ */
+bool
+nir_deserialize_info(void *mem_ctx, struct blob_reader *blob,
+                     struct shader_info *info)
+{
+   /* Skip the index table size. */
+   blob_read_uint32(blob);
+
+   enum nir_serialize_shader_flags flags = blob_read_uint32(blob);
+   const char *name = (flags & NIR_SERIALIZE_SHADER_NAME) ? blob_read_string(blob) : NULL;
+   const char *label = (flags & NIR_SERIALIZE_SHADER_LABEL) ? blob_read_string(blob) : NULL;
+
+   blob_copy_bytes(blob, (uint8_t *)info, sizeof(*info));
+   if (blob->overrun) {
+      memset(info, 0, sizeof(*info));
+      return false;
+   }
+
+   info->name = name ? ralloc_strdup(mem_ctx, name) : NULL;
+   info->label = label ? ralloc_strdup(mem_ctx, label) : NULL;
+
+   return true;
+}
+
 nir_function *
 nir_deserialize_function(void *mem_ctx,
                          const struct nir_shader_compiler_options *options,
@@ -28,6 +28,8 @@
 #include "nir_defines.h"
 #include "nir_shader_compiler_options.h"
 
+struct shader_info;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -37,6 +39,9 @@ nir_shader *nir_deserialize(void *mem_ctx,
                             const struct nir_shader_compiler_options *options,
                             struct blob_reader *blob);
 
+bool nir_deserialize_info(void *mem_ctx, struct blob_reader *blob,
+                          struct shader_info *info);
+
 void
 nir_serialize_function(struct blob *blob, const nir_function *fxn);
 
@@ -243,6 +243,22 @@ typedef enum {
    nir_lower_packing_num_ops,
 } nir_lower_packing_op;
 
+/** Loop transformations that ask nir_shader_compiler_options::loop_transform_cost */
+typedef enum {
+   /**
+    * nir_opt_loop_unroll: unroll the loop completely, or partially by its
+    * guessed trip count. loop->info is valid and has the trip counts.
+    */
+   nir_loop_transform_unroll,
+
+   /**
+    * nir_opt_licm: hoist the loop invariant instructions out of the loop,
+    * which extends their live ranges over the whole loop. loop->info may be
+    * NULL.
+    */
+   nir_loop_transform_licm,
+} nir_loop_transform;
+
 typedef struct nir_shader_compiler_options {
    bool lower_fdiv;
    bool lower_ffma16;
@@ -744,6 +760,13 @@ typedef struct nir_shader_compiler_options {
 
    bool driver_functions;
 
+   /**
+    * Skip algebraic passes on functions which are unchanged since the same
+    * pass last ran on them without making progress, which is common in
+    * optimization loops.  See nir_metadata_algebraic.
+    */
+   bool skip_unchanged_algebraic;
+
    /**
     * If true, the driver will call nir_lower_int64 itself and the frontend
     * should not do so. This may enable better optimization around address
@@ -899,6 +922,23 @@ typedef struct nir_shader_compiler_options {
     */
    unsigned (*max_offset_shift)(nir_intrinsic_instr *, const void *);
 
+   /**
+    * Optional backend cost model for loop transformations.
+    *
+    * Returns the estimated change in the cost of running the loop when the
+    * transformation is applied, in backend-defined units that should include
+    * register pressure (e.g. by charging for the spills it would cause). The
+    * transformation is only applied if the result is negative.
+    *
+    * Loops with unroll control and loops that must be unrolled because of
+    * indirect access to force_indirect_unrolling modes don't ask the callback.
+    * When it isn't set, max_unroll_iterations and the instruction count of
+    * the loop decide unrolling and LICM always hoists.
+    */
+   int (*loop_transform_cost)(const nir_loop *loop,
+                              nir_loop_transform transform,
+                              const void *data);
+
    /**
     * Passed to the callbacks that accept a data pointer.
     */
@@ -28,6 +28,7 @@
 #include <assert.h>
 #include "c11/threads.h"
 #include "util/hash_table.h"
+#include "util/u_atomic.h"
 #include "util/simple_mtx.h"
 #include "nir.h"
 #include "nir_xfb_info.h"
@@ -89,8 +90,20 @@ typedef struct {
 
    /* map of instruction/var/etc to failed assert string */
    struct hash_table *errors;
+
+   /* whether to skip impls with nir_metadata_validated */
+   bool incremental;
 } validate_state;
 
+/* With NIR_DEBUG=incremental_validation, every this many validations still
+ * check all impls, to catch passes which change an impl while preserving all
+ * metadata and changes to one function which break another one, like
+ * changing the parameters of a callee.
+ */
+#define FULL_VALIDATION_INTERVAL 16
+
+static uint32_t validation_count;
+
 static void
 log_error(validate_state *state, const char *cond, const char *file, int line)
 {
@@ -2198,6 +2211,11 @@ validate_function(nir_function *func, validate_state *state)
 {
    if (func->impl != NULL) {
       validate_assert(state, func->impl->function == func);
+
+      if (state->incremental &&
+          (func->impl->valid_metadata & nir_metadata_validated))
+         return;
+
       validate_function_impl(func->impl, state);
    }
 }
@@ -2211,6 +2229,7 @@ init_validate_state(validate_state *state)
    state->var_defs = _mesa_pointer_hash_table_create(state->mem_ctx);
    state->errors = _mesa_pointer_hash_table_create(state->mem_ctx);
    state->nr_tagged_srcs = 0;
+   state->incremental = false;
 
    state->loop = NULL;
    state->in_loop_continue_construct = false;
@@ -2271,6 +2290,11 @@ nir_validate_shader(nir_shader *shader, const char *when)
 
    state.shader = shader;
 
+   if (NIR_DEBUG(INCREMENTAL_VALIDATION)) {
+      state.incremental = p_atomic_inc_return(&validation_count) %
+                          FULL_VALIDATION_INTERVAL != 0;
+   }
+
    nir_variable_mode valid_modes =
       nir_var_shader_in |
       nir_var_shader_out |
@@ -2341,6 +2365,12 @@ nir_validate_shader(nir_shader *shader, const char *when)
    if (_mesa_hash_table_num_entries(state.errors) > 0)
       dump_errors(&state, when);
 
+   if (NIR_DEBUG(INCREMENTAL_VALIDATION)) {
+      nir_foreach_function_impl(impl, shader) {
+         impl->valid_metadata |= nir_metadata_validated;
+      }
+   }
+
    destroy_validate_state(&state);
 }
 
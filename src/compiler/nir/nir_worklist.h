@@ -62,6 +62,31 @@ typedef u_worklist nir_block_worklist;
 
 void nir_block_worklist_add_all(nir_block_worklist *w, nir_function_impl *impl);
 
+/*
+ * Block worklist which always pops the block with the lowest or highest
+ * index.  Block indices follow the source order, which is a reverse
+ * postorder of the CFG without back edges, so forward dataflow analyses
+ * should pop the first block and backward ones the last block.
+ */
+typedef u_priority_worklist nir_block_priority_worklist;
+
+#define nir_block_priority_worklist_init(w, num_blocks, mem_ctx) \
+   u_priority_worklist_init(w, num_blocks, mem_ctx)
+
+#define nir_block_priority_worklist_fini(w) u_priority_worklist_fini(w)
+
+#define nir_block_priority_worklist_is_empty(w) \
+   u_priority_worklist_is_empty(w)
+
+#define nir_block_priority_worklist_push(w, block) \
+   u_priority_worklist_push(w, block, index)
+
+#define nir_block_priority_worklist_pop_first(w) \
+   u_priority_worklist_pop_first(w, nir_block, index)
+
+#define nir_block_priority_worklist_pop_last(w) \
+   u_priority_worklist_pop_last(w, nir_block, index)
+
 /*
  * This worklist implementation, in contrast to the block worklist, does not
  * have unique entries, meaning a nir_instr can be inserted more than once
@@ -271,4 +271,37 @@ TEST_F(nir_opt_idiv_const_test, irem)
    }
 }
 
+TEST_F(nir_opt_algebraic_test, skip_unchanged)
+{
+   options.skip_unchanged_algebraic = true;
+
+   nir_def *x = nir_load_var(b, res_var);
+   nir_store_var(b, res_var, nir_build_alu2(b, nir_op_iadd, x, nir_imm_int(b, 0)), 0x1);
+
+   EXPECT_TRUE(nir_opt_algebraic(b->shader));
+   EXPECT_FALSE(b->impl->valid_metadata & nir_metadata_algebraic);
+
+   /* The second run makes no progress and is recorded, so the third run can
+    * be skipped.
+    */
+   EXPECT_FALSE(nir_opt_algebraic(b->shader));
+   EXPECT_TRUE(b->impl->valid_metadata & nir_metadata_algebraic);
+   EXPECT_EQ(b->impl->num_algebraic_no_progress, 1u);
+   EXPECT_FALSE(nir_opt_algebraic(b->shader));
+   EXPECT_EQ(b->impl->num_algebraic_no_progress, 1u);
+
+   /* Other passes are recorded separately. */
+   EXPECT_FALSE(nir_opt_algebraic_late(b->shader));
+   EXPECT_EQ(b->impl->num_algebraic_no_progress, 2u);
+
+   /* Changing the shader invalidates the record. */
+   b->cursor = nir_after_cf_list(&b->impl->body);
+   x = nir_load_var(b, res_var);
+   nir_store_var(b, res_var, nir_build_alu2(b, nir_op_iadd, x, nir_imm_int(b, 0)), 0x1);
+   nir_progress(true, b->impl, nir_metadata_control_flow);
+
+   EXPECT_FALSE(b->impl->valid_metadata & nir_metadata_algebraic);
+   EXPECT_TRUE(nir_opt_algebraic(b->shader));
+}
+
 }
@@ -117,4 +117,69 @@ TEST_F(nir_core_test, nir_instr_free_and_dce_multiple_src_test)
    nir_validate_shader(b->shader, "after remove_and_dce");
 }
 
+TEST_F(nir_core_test, nir_compact_instrs_test)
+{
+   nir_def *x = nir_load_local_invocation_index(b);
+
+   /* Insert each new add at the top of the block, so that allocation order
+    * is the reverse of program order.
+    */
+   nir_def *last = x;
+   for (unsigned i = 0; i < 8; i++) {
+      b->cursor = nir_after_instr(nir_def_instr(x));
+      last = nir_iadd_imm(b, x, i + 1);
+   }
+
+   b->cursor = nir_after_impl(b->impl);
+   nir_store_global(b, last, nir_undef(b, 1, 64));
+
+   nir_compact_instrs(b->shader);
+   nir_validate_shader(b->shader, "after nir_compact_instrs");
+
+   /* b->impl is gone, the clone replaced it. */
+   b->impl = nir_shader_get_entrypoint(b->shader);
+
+   unsigned num_alu = 0;
+   nir_alu_instr *prev = NULL;
+   nir_foreach_block(block, b->impl) {
+      nir_foreach_instr(instr, block) {
+         if (instr->type != nir_instr_type_alu)
+            continue;
+
+         nir_alu_instr *alu = nir_instr_as_alu(instr);
+         if (prev)
+            ASSERT_LT((uintptr_t)prev, (uintptr_t)alu);
+         prev = alu;
+         num_alu++;
+      }
+   }
+
+   ASSERT_EQ(num_alu, 8);
+}
+
+#ifndef NDEBUG
+TEST_F(nir_core_test, incremental_validation)
+{
+   uint32_t saved_debug = nir_debug;
+   nir_debug |= NIR_DEBUG_INCREMENTAL_VALIDATION;
+
+   nir_store_global(b, nir_load_local_invocation_index(b),
+                    nir_undef(b, 1, 64));
+
+   nir_validate_shader(b->shader, NULL);
+   EXPECT_TRUE(b->impl->valid_metadata & nir_metadata_validated);
+
+   /* Passes without progress keep the impl validated. */
+   nir_no_progress(b->impl);
+   EXPECT_TRUE(b->impl->valid_metadata & nir_metadata_validated);
+
+   nir_progress(true, b->impl, nir_metadata_control_flow);
+   EXPECT_FALSE(b->impl->valid_metadata & nir_metadata_validated);
+
+   nir_validate_shader(b->shader, NULL);
+   EXPECT_TRUE(b->impl->valid_metadata & nir_metadata_validated);
+
+   nir_debug = saved_debug;
+}
+#endif
 }
@@ -200,3 +200,43 @@ UNROLL_TEST_UNKNOWN_INIT_INSERT(iadd_ugt_unknown_init_eq, int, 16, 4,
                                 ult, iadd, true, TRUE, 6, 0)
 UNROLL_TEST_UNKNOWN_INIT_INSERT(iadd_ige_unknown_init, int, 4, 6,
                                 ige, iadd, false, FALSE, 1, 1)
+
+static int
+loop_cost_never(const nir_loop *loop, nir_loop_transform transform,
+                const void *data)
+{
+   return 1;
+}
+
+static int
+loop_cost_always(const nir_loop *loop, nir_loop_transform transform,
+                 const void *data)
+{
+   return -1;
+}
+
+TEST_F(nir_loop_unroll_test, cost_callback_rejects)
+{
+   nir_shader_compiler_options options = *bld.shader->options;
+   options.loop_transform_cost = loop_cost_never;
+   bld.shader->options = &options;
+
+   loop_unroll_test_helper(&bld, nir_imm_int(&bld, 0), nir_imm_int(&bld, 24),
+                           nir_imm_int(&bld, 4), &nir_ige, &nir_iadd, false);
+   EXPECT_FALSE(nir_opt_loop_unroll(bld.shader));
+   EXPECT_EQ(1, count_loops());
+}
+
+TEST_F(nir_loop_unroll_test, cost_callback_overrides_max_iterations)
+{
+   nir_shader_compiler_options options = *bld.shader->options;
+   options.loop_transform_cost = loop_cost_always;
+   bld.shader->options = &options;
+
+   /* 40 iterations, more than max_unroll_iterations. */
+   loop_unroll_test_helper(&bld, nir_imm_int(&bld, 0), nir_imm_int(&bld, 160),
+                           nir_imm_int(&bld, 4), &nir_ige, &nir_iadd, false);
+   EXPECT_TRUE(nir_opt_loop_unroll(bld.shader));
+   EXPECT_EQ(40, count_instr(nir_op_iadd));
+   EXPECT_EQ(0, count_loops());
+}
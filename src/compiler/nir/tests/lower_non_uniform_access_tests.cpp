@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir.h"
+#include "nir_builder.h"
+#include "nir_test.h"
+
+class nir_lower_non_uniform_access_test : public nir_test {
+protected:
+   nir_lower_non_uniform_access_test()
+      : nir_test::nir_test("nir_lower_non_uniform_access_test")
+   {
+      index = nir_load_subgroup_invocation(b);
+      offset = nir_imm_int(b, 0);
+   }
+
+   nir_intrinsic_instr *load_ssbo()
+   {
+      nir_def *def = nir_load_ssbo(b, 1, 32, index, offset,
+                                   .access = ACCESS_NON_UNIFORM);
+      return nir_def_as_intrinsic(def);
+   }
+
+   nir_def *index;
+   nir_def *offset;
+};
+
+TEST_F(nir_lower_non_uniform_access_test, loop)
+{
+   nir_intrinsic_instr *load = load_ssbo();
+   nir_store_ssbo(b, &load->def, nir_imm_int(b, 0), offset);
+
+   nir_lower_non_uniform_access_options options = {
+      .types = nir_lower_non_uniform_ssbo_access,
+   };
+   ASSERT_TRUE(nir_lower_non_uniform_access(b->shader, &options));
+   nir_validate_shader(b->shader, NULL);
+
+   nir_loop *loop = nir_cf_node_as_loop(nir_cf_node_next(&nir_start_block(b->impl)->cf_node));
+   EXPECT_EQ(load->instr.block->cf_node.parent->parent, &loop->cf_node);
+   EXPECT_FALSE(nir_intrinsic_access(load) & ACCESS_NON_UNIFORM);
+}
+
+TEST_F(nir_lower_non_uniform_access_test, uniform_fast_path)
+{
+   nir_intrinsic_instr *load = load_ssbo();
+   nir_def *sum = nir_iadd_imm(b, &load->def, 1);
+   nir_store_ssbo(b, sum, nir_imm_int(b, 0), offset);
+
+   nir_lower_non_uniform_access_options options = {
+      .types = nir_lower_non_uniform_ssbo_access,
+      .uniform_fast_path = true,
+   };
+   ASSERT_TRUE(nir_lower_non_uniform_access(b->shader, &options));
+   nir_validate_shader(b->shader, NULL);
+
+   nir_if *nif = nir_cf_node_as_if(nir_cf_node_next(&nir_start_block(b->impl)->cf_node));
+   EXPECT_EQ(nir_def_as_intrinsic(nif->condition.ssa)->intrinsic, nir_intrinsic_vote_all);
+
+   /* The uniform path uses a copy of the load with the first invocation's index. */
+   nir_instr *clone = nir_block_last_instr(nir_if_first_then_block(nif));
+   ASSERT_EQ(clone->type, nir_instr_type_intrinsic);
+   EXPECT_EQ(nir_instr_as_intrinsic(clone)->intrinsic, nir_intrinsic_load_ssbo);
+   EXPECT_NE(nir_instr_as_intrinsic(clone)->src[0].ssa, index);
+
+   /* The original load is still in the loop on the else side. */
+   nir_cf_node *loop = nir_cf_node_next(&nir_if_first_else_block(nif)->cf_node);
+   ASSERT_EQ(loop->type, nir_cf_node_loop);
+   EXPECT_EQ(load->instr.block->cf_node.parent->parent, loop);
+
+   /* Both results are merged for the users of the load. */
+   nir_instr *phi = nir_def_instr(nir_def_as_alu(sum)->src[0].src.ssa);
+   ASSERT_EQ(phi->type, nir_instr_type_phi);
+   EXPECT_EQ(phi->block, nir_cf_node_as_block(nir_cf_node_next(&nif->cf_node)));
+}
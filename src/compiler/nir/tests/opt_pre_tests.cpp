@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir_test.h"
+
+namespace {
+
+class nir_opt_pre_test : public nir_test {
+protected:
+   nir_opt_pre_test()
+      : nir_test::nir_test("nir_opt_pre_test")
+   {
+      zero = nir_imm_int(b, 0);
+      offset = nir_load_local_invocation_index(b);
+      cond = nir_ieq_imm(b, offset, 0);
+   }
+
+   /* The sources are defined before any if, like the pass requires. */
+   nir_def *load(void)
+   {
+      return nir_load_ubo(b, 1, 32, zero, offset, (gl_access_qualifier)0,
+                          4, 0, 0, ~0u);
+   }
+
+   unsigned count_loads(nir_block *block);
+
+   nir_def *zero;
+   nir_def *offset;
+   nir_def *cond;
+};
+
+unsigned
+nir_opt_pre_test::count_loads(nir_block *block)
+{
+   unsigned count = 0;
+   nir_foreach_instr(instr, block) {
+      if (instr->type == nir_instr_type_intrinsic &&
+          nir_instr_as_intrinsic(instr)->intrinsic == nir_intrinsic_load_ubo)
+         count++;
+   }
+   return count;
+}
+
+TEST_F(nir_opt_pre_test, hoist_from_both_branches)
+{
+   nir_if *nif = nir_push_if(b, cond);
+   nir_def *a = load();
+   nir_push_else(b, nif);
+   nir_def *c = load();
+   nir_pop_if(b, nif);
+   nir_store_global(b, nir_if_phi(b, a, c), nir_undef(b, 1, 64));
+
+   ASSERT_TRUE(nir_opt_pre(b->shader, true));
+   nir_validate_shader(b->shader, NULL);
+
+   nir_block *pre = nir_cf_node_as_block(nir_cf_node_prev(&nif->cf_node));
+   EXPECT_EQ(count_loads(pre), 1);
+   EXPECT_EQ(count_loads(nir_if_first_then_block(nif)), 0);
+   EXPECT_EQ(count_loads(nir_if_first_else_block(nif)), 0);
+}
+
+TEST_F(nir_opt_pre_test, partially_redundant)
+{
+   nir_if *nif = nir_push_if(b, cond);
+   nir_store_global(b, load(), nir_undef(b, 1, 64));
+   nir_pop_if(b, nif);
+   nir_store_global(b, load(), nir_undef(b, 1, 64));
+
+   ASSERT_TRUE(nir_opt_pre(b->shader, true));
+   nir_validate_shader(b->shader, NULL);
+
+   nir_block *after = nir_cf_node_as_block(nir_cf_node_next(&nif->cf_node));
+   EXPECT_EQ(count_loads(after), 0);
+   EXPECT_EQ(count_loads(nir_if_first_then_block(nif)), 1);
+   EXPECT_EQ(count_loads(nir_if_first_else_block(nif)), 1);
+   EXPECT_EQ(nir_block_first_instr(after)->type, nir_instr_type_phi);
+}
+
+TEST_F(nir_opt_pre_test, loads_disabled)
+{
+   nir_if *nif = nir_push_if(b, cond);
+   nir_store_global(b, load(), nir_undef(b, 1, 64));
+   nir_pop_if(b, nif);
+   nir_store_global(b, load(), nir_undef(b, 1, 64));
+
+   ASSERT_FALSE(nir_opt_pre(b->shader, false));
+}
+
+} /* namespace */
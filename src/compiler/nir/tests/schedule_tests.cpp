@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir_test.h"
+#include "nir_schedule.h"
+
+namespace {
+
+class nir_schedule_test : public nir_test {
+protected:
+   nir_schedule_test()
+      : nir_test::nir_test("nir_schedule_test")
+   {
+      zero = nir_imm_int(b, 0);
+   }
+
+   /* Loads all values first and stores them afterwards, which keeps all of
+    * them live at once.
+    */
+   void build_loads_then_stores(nir_def *offset, unsigned count)
+   {
+      nir_def *values[16];
+      assert(count <= ARRAY_SIZE(values));
+
+      for (unsigned i = 0; i < count; i++) {
+         values[i] = nir_load_ubo(b, 4, 32, zero,
+                                  nir_iadd_imm(b, offset, i * 16),
+                                  (gl_access_qualifier)0, 16, 0, 0, ~0u);
+      }
+
+      for (unsigned i = 0; i < count; i++)
+         nir_store_ssbo(b, values[i], zero, offset);
+   }
+
+   nir_def *zero;
+};
+
+TEST_F(nir_schedule_test, stats_reg_file)
+{
+   build_loads_then_stores(nir_load_local_invocation_index(b), 8);
+
+   nir_schedule_stats stats;
+   nir_schedule_options options = {};
+   options.reg_file_size = 16 * 4 * 8;
+   options.simd_width = 8;
+   options.stats = &stats;
+
+   nir_schedule(b->shader, &options);
+   nir_validate_shader(b->shader, "after nir_schedule");
+
+   /* All eight vec4 loads are live before the first store. */
+   EXPECT_GE(stats.max_pressure_before, 8 * 4);
+   EXPECT_LT(stats.max_pressure_after, stats.max_pressure_before);
+   EXPECT_LE(stats.max_pressure_after, 16);
+   EXPECT_EQ(stats.max_uniform_pressure_before, 0);
+   EXPECT_EQ(stats.max_uniform_pressure_after, 0);
+}
+
+TEST_F(nir_schedule_test, stats_uniform_reg_file)
+{
+   /* The offsets are constant, so all loaded values are uniform. */
+   build_loads_then_stores(zero, 8);
+
+   nir_schedule_stats stats;
+   nir_schedule_options options = {};
+   options.reg_file_size = 256 * 4 * 32;
+   options.simd_width = 32;
+   options.uniform_reg_file_size = 128 * 4;
+   options.stats = &stats;
+
+   nir_schedule(b->shader, &options);
+   nir_validate_shader(b->shader, "after nir_schedule");
+
+   EXPECT_GE(stats.max_uniform_pressure_before, 8 * 4);
+   EXPECT_EQ(stats.max_pressure_before, 0);
+   EXPECT_EQ(stats.max_pressure_after, 0);
+}
+
+} // namespace
@@ -195,3 +195,36 @@ TEST_P(nir_serialize_all_but_one_test, single_channel)
 
    ASSERT_SWIZZLE_EQ(vec_alu, vec_alu_dup, 1, 0);
 }
+
+TEST(nir_serialize_info, info_only)
+{
+   const nir_shader_compiler_options options = {};
+   glsl_type_singleton_init_or_ref();
+
+   nir_builder b = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, &options,
+                                                  "info test");
+   b.shader->info.workgroup_size[0] = 64;
+   nir_def *undef = nir_undef(&b, 1, 32);
+   nir_fadd(&b, undef, undef);
+
+   struct blob blob;
+   blob_init(&blob);
+   nir_serialize(&blob, b.shader, false);
+
+   struct blob_reader reader;
+   blob_reader_init(&reader, blob.data, blob.size);
+
+   struct shader_info info;
+   ASSERT_TRUE(nir_deserialize_info(b.shader, &reader, &info));
+   ASSERT_EQ(info.stage, MESA_SHADER_COMPUTE);
+   ASSERT_EQ(info.workgroup_size[0], 64);
+   ASSERT_STREQ(info.name, "info test");
+
+   /* A truncated header must fail. */
+   blob_reader_init(&reader, blob.data, 8);
+   ASSERT_FALSE(nir_deserialize_info(b.shader, &reader, &info));
+
+   blob_finish(&blob);
+   ralloc_free(b.shader);
+   glsl_type_singleton_decref();
+}
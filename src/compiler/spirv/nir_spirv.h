@@ -147,6 +147,11 @@ struct spirv_to_nir_options {
 
    /* If GroupNonUniform capability is used, set this api subgroup size. */
    uint8_t group_non_uniform_subgroup_size;
+
+   /* BLAKE3 of the SPIR-V words if the caller already computed it, it is
+    * used for shader_info::source_blake3 instead of hashing them again.
+    */
+   const uint8_t *source_blake3;
 };
 
 enum spirv_verify_result {
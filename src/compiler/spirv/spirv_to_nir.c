@@ -821,6 +821,133 @@ vtn_foreach_instruction(struct vtn_builder *b, const uint32_t *start,
    return w;
 }
 
+/* Skips the function starting at w, returns the first word after its
+ * OpFunctionEnd.
+ */
+static const uint32_t *
+vtn_skip_function(struct vtn_builder *b, const uint32_t *w,
+                  const uint32_t *end)
+{
+   while (w < end) {
+      SpvOp opcode = w[0] & SpvOpCodeMask;
+      unsigned count = w[0] >> SpvWordCountShift;
+      vtn_fail_if(count < 1 || w + count > end, "Invalid instruction");
+
+      w += count;
+      if (opcode == SpvOpFunctionEnd)
+         return w;
+   }
+
+   vtn_fail("OpFunction without OpFunctionEnd");
+}
+
+/**
+ * Like vtn_foreach_instruction() on the function section of the module, but
+ * skips the functions which can't be reached from the entry point.
+ */
+void
+vtn_foreach_reachable_function_instruction(struct vtn_builder *b,
+                                           const uint32_t *start,
+                                           const uint32_t *end,
+                                           vtn_instruction_handler handler)
+{
+   if (b->reachable_functions == NULL) {
+      vtn_foreach_instruction(b, start, end, handler);
+      return;
+   }
+
+   const uint32_t *w = start;
+   const uint32_t *range_start = start;
+   while (w < end) {
+      SpvOp opcode = w[0] & SpvOpCodeMask;
+      unsigned count = w[0] >> SpvWordCountShift;
+      vtn_fail_if(count < 1 || w + count > end, "Invalid instruction");
+
+      if (opcode == SpvOpFunction && count > 2 &&
+          !BITSET_TEST(b->reachable_functions, w[2])) {
+         vtn_foreach_instruction(b, range_start, w, handler);
+         w = vtn_skip_function(b, w, end);
+         range_start = w;
+      } else {
+         w += count;
+      }
+   }
+
+   vtn_foreach_instruction(b, range_start, end, handler);
+}
+
+/**
+ * Finds the functions that can be reached from the entry point, so that the
+ * other functions of the module, e.g. the ones of other entry points, don't
+ * need to be processed at all.
+ *
+ * A function is considered used by another one if its ID appears as any word
+ * of an instruction in the other one's body. This also finds the functions
+ * that are passed as operands rather than called, e.g. by the cooperative
+ * matrix instructions. A literal that happens to have the same value as a
+ * function ID only makes the result more conservative.
+ */
+static void
+vtn_find_reachable_functions(struct vtn_builder *b, const uint32_t *start,
+                             const uint32_t *end)
+{
+   if (b->options->create_library || b->entry_point == NULL)
+      return;
+
+   const unsigned bound = b->value_id_bound;
+   BITSET_WORD *is_function = vtn_zalloc_array(b, BITSET_WORD, BITSET_WORDS(bound));
+   const uint32_t **function_start = vtn_zalloc_array(b, const uint32_t *, bound);
+
+   unsigned num_functions = 0;
+   for (const uint32_t *w = start; w < end;) {
+      SpvOp opcode = w[0] & SpvOpCodeMask;
+      unsigned count = w[0] >> SpvWordCountShift;
+      vtn_fail_if(count < 1 || w + count > end, "Invalid instruction");
+
+      if (opcode == SpvOpFunction && count > 2 && w[2] < bound) {
+         BITSET_SET(is_function, w[2]);
+         function_start[w[2]] = w;
+         num_functions++;
+      }
+
+      w += count;
+   }
+
+   const uint32_t entry_point_id = b->entry_point - b->values;
+   if (num_functions <= 1 || !BITSET_TEST(is_function, entry_point_id))
+      return;
+
+   BITSET_WORD *reachable = vtn_zalloc_array(b, BITSET_WORD, BITSET_WORDS(bound));
+   uint32_t *worklist = vtn_alloc_array(b, uint32_t, num_functions);
+   unsigned worklist_size = 0;
+
+   BITSET_SET(reachable, entry_point_id);
+   worklist[worklist_size++] = entry_point_id;
+
+   while (worklist_size > 0) {
+      const uint32_t *w = function_start[worklist[--worklist_size]];
+
+      while (w < end) {
+         SpvOp opcode = w[0] & SpvOpCodeMask;
+         unsigned count = w[0] >> SpvWordCountShift;
+
+         for (unsigned i = 1; i < count; i++) {
+            if (w[i] < bound && BITSET_TEST(is_function, w[i]) &&
+                !BITSET_TEST(reachable, w[i])) {
+               BITSET_SET(reachable, w[i]);
+               worklist[worklist_size++] = w[i];
+            }
+         }
+
+         w += count;
+         if (opcode == SpvOpFunctionEnd)
+            break;
+      }
+   }
+
+   b->reachable_functions = reachable;
+}
+
 static bool
 vtn_handle_debug_printf(struct vtn_builder *b, SpvOp ext_opcode,
                         const uint32_t *w, unsigned count)
@@ -7108,6 +7235,7 @@ vtn_create_builder(const uint32_t *words, size_t word_count,
    const linear_opts lin_opts = {
       .min_buffer_size = 2 * value_id_bound * (sizeof(struct vtn_value) +
                                                sizeof(struct vtn_ssa_value)),
+      .arena = true,
    };
    b->lin_ctx = linear_context_with_opts(b, &lin_opts);
 
@@ -7332,7 +7460,13 @@ spirv_to_nir(const uint32_t *words, size_t word_count,
       b->shader->info.workgroup_size_variable = true;
    b->shader->info.cs.shader_index = options->shader_index;
    b->shader->has_debug_info = options->debug_info;
-   _mesa_blake3_compute(words, word_count * sizeof(uint32_t), b->shader->info.source_blake3);
+   if (options->source_blake3) {
+      memcpy(b->shader->info.source_blake3, options->source_blake3,
+             sizeof(b->shader->info.source_blake3));
+   } else {
+      _mesa_blake3_compute(words, word_count * sizeof(uint32_t),
+                           b->shader->info.source_blake3);
+   }
 
    const char *dump_path = os_get_option_secure("MESA_SPIRV_DUMP_PATH");
    if (dump_path) {
@@ -7478,8 +7612,11 @@ spirv_to_nir(const uint32_t *words, size_t word_count,
       }
    }
 
+   vtn_find_reachable_functions(b, words, word_end);
+
    /* Set types on all vtn_values */
-   vtn_foreach_instruction(b, words, word_end, vtn_set_instruction_result_type);
+   vtn_foreach_reachable_function_instruction(b, words, word_end,
+                                              vtn_set_instruction_result_type);
 
    vtn_build_cfg(b, words, word_end);
 
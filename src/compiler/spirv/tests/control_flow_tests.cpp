@@ -240,4 +240,70 @@ OpFunctionEnd
    };
    get_nir(ARRAY_SIZE(words), words, MESA_SHADER_COMPUTE);
    ASSERT_TRUE(shader);
-}
\ No newline at end of file
+}
+
+TEST_F(ControlFlow, OtherEntryPointsSkipped)
+{
+   /*
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpEntryPoint GLCompute %other "other"
+               OpExecutionMode %main LocalSize 1 1 1
+               OpExecutionMode %other LocalSize 1 1 1
+               OpName %main "main"
+               OpName %helper "helper"
+               OpName %other "other"
+               OpName %unused "unused"
+       %void = OpTypeVoid
+          %6 = OpTypeFunction %void
+       %main = OpFunction %void None %6
+          %7 = OpLabel
+          %8 = OpFunctionCall %void %helper
+               OpReturn
+               OpFunctionEnd
+     %helper = OpFunction %void None %6
+          %9 = OpLabel
+               OpReturn
+               OpFunctionEnd
+      %other = OpFunction %void None %6
+         %10 = OpLabel
+         %11 = OpFunctionCall %void %unused
+               OpReturn
+               OpFunctionEnd
+     %unused = OpFunction %void None %6
+         %12 = OpLabel
+               OpReturn
+               OpFunctionEnd
+   */
+   static const uint32_t words[] = {
+      0x07230203, 0x00010000, 0x00000000, 0x0000000d, 0x00000000, 0x00020011,
+      0x00000001, 0x0003000e, 0x00000000, 0x00000001, 0x0005000f, 0x00000005,
+      0x00000001, 0x6e69616d, 0x00000000, 0x0005000f, 0x00000005, 0x00000003,
+      0x6568746f, 0x00000072, 0x00060010, 0x00000001, 0x00000011, 0x00000001,
+      0x00000001, 0x00000001, 0x00060010, 0x00000003, 0x00000011, 0x00000001,
+      0x00000001, 0x00000001, 0x00040005, 0x00000001, 0x6e69616d, 0x00000000,
+      0x00040005, 0x00000002, 0x706c6568, 0x00007265, 0x00040005, 0x00000003,
+      0x6568746f, 0x00000072, 0x00040005, 0x00000004, 0x73756e75, 0x00006465,
+      0x00020013, 0x00000005, 0x00030021, 0x00000006, 0x00000005, 0x00050036,
+      0x00000005, 0x00000001, 0x00000000, 0x00000006, 0x000200f8, 0x00000007,
+      0x00040039, 0x00000005, 0x00000008, 0x00000002, 0x000100fd, 0x00010038,
+      0x00050036, 0x00000005, 0x00000002, 0x00000000, 0x00000006, 0x000200f8,
+      0x00000009, 0x000100fd, 0x00010038, 0x00050036, 0x00000005, 0x00000003,
+      0x00000000, 0x00000006, 0x000200f8, 0x0000000a, 0x00040039, 0x00000005,
+      0x0000000b, 0x00000004, 0x000100fd, 0x00010038, 0x00050036, 0x00000005,
+      0x00000004, 0x00000000, 0x00000006, 0x000200f8, 0x0000000c, 0x000100fd,
+      0x00010038,
+   };
+   get_nir(ARRAY_SIZE(words), words, MESA_SHADER_COMPUTE);
+   ASSERT_TRUE(shader);
+
+   /* Only the functions reachable from "main" are created. */
+   unsigned num_functions = 0;
+   nir_foreach_function(func, shader) {
+      EXPECT_TRUE(strcmp(func->name, "main") == 0 ||
+                  strcmp(func->name, "helper") == 0);
+      num_functions++;
+   }
+   EXPECT_EQ(num_functions, 2);
+}
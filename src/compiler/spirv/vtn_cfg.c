@@ -534,13 +534,8 @@ vtn_parse_switch(struct vtn_builder *b,
 void
 vtn_build_cfg(struct vtn_builder *b, const uint32_t *words, const uint32_t *end)
 {
-   vtn_foreach_instruction(b, words, end,
-                           vtn_cfg_handle_prepass_instruction);
-
-   if (b->shader->info.stage == MESA_SHADER_KERNEL)
-      return;
-
-   vtn_build_structured_cfg(b, words, end);
+   vtn_foreach_reachable_function_instruction(b, words, end,
+                                              vtn_cfg_handle_prepass_instruction);
 }
 
 bool
@@ -28,6 +28,7 @@
 
 #include "nir/nir.h"
 #include "nir/nir_builder.h"
+#include "util/bitset.h"
 #include "util/u_dynarray.h"
 #include "nir_spirv.h"
 #include "spirv.h"
@@ -255,13 +256,17 @@ void vtn_emit_cf_func_structured(struct vtn_builder *b, struct vtn_function *fun
 bool vtn_handle_phis_first_pass(struct vtn_builder *b, SpvOp opcode,
                                 const uint32_t *w, unsigned count);
 void vtn_emit_ret_store(struct vtn_builder *b, const struct vtn_block *block);
-void vtn_build_structured_cfg(struct vtn_builder *b, const uint32_t *words,
-                              const uint32_t *end);
 
 const uint32_t *
 vtn_foreach_instruction(struct vtn_builder *b, const uint32_t *start,
                         const uint32_t *end, vtn_instruction_handler handler);
 
+void
+vtn_foreach_reachable_function_instruction(struct vtn_builder *b,
+                                           const uint32_t *start,
+                                           const uint32_t *end,
+                                           vtn_instruction_handler handler);
+
 struct vtn_ssa_value {
    bool is_variable;
 
@@ -696,6 +701,11 @@ struct vtn_builder {
    struct vtn_value *entry_point;
    struct vtn_value *workgroup_size_builtin;
 
+   /* IDs of the functions reachable from the entry point, or NULL if all
+    * functions are needed, see vtn_find_reachable_functions().
+    */
+   BITSET_WORD *reachable_functions;
+
    uint32_t *interface_ids;
    size_t interface_ids_count;
 
@@ -1084,31 +1084,33 @@ find_merge_pos(struct vtn_builder *b)
    }
 }
 
-void
-vtn_build_structured_cfg(struct vtn_builder *b, const uint32_t *words, const uint32_t *end)
+/* Only called for the functions that are emitted, so that the ones which
+ * aren't reachable from the entry point, e.g. the other entry points of a
+ * large module, don't pay for the analysis.
+ */
+static void
+vtn_build_structured_cfg(struct vtn_builder *b, struct vtn_function *func)
 {
-   vtn_foreach_function(func, &b->functions) {
-      b->func = func;
+   b->func = func;
 
-      sort_blocks(b);
+   sort_blocks(b);
 
-      create_constructs(b);
+   create_constructs(b);
 
-      validate_constructs(b);
+   validate_constructs(b);
 
-      find_innermost_constructs(b);
+   find_innermost_constructs(b);
 
-      find_merge_pos(b);
+   find_merge_pos(b);
 
-      set_branch_types(b);
+   set_branch_types(b);
 
-      if (MESA_SPIRV_DEBUG(STRUCTURED)) {
-         printf("\nBLOCKS (%u):\n", func->ordered_blocks_count);
-         print_ordered_blocks(func);
-         printf("\nCONSTRUCTS (%u):\n", list_length(&func->constructs));
-         print_constructs(func);
-         printf("\n");
-      }
+   if (MESA_SPIRV_DEBUG(STRUCTURED)) {
+      printf("\nBLOCKS (%u):\n", func->ordered_blocks_count);
+      print_ordered_blocks(func);
+      printf("\nCONSTRUCTS (%u):\n", list_length(&func->constructs));
+      print_constructs(func);
+      printf("\n");
    }
 }
 
@@ -1527,6 +1529,8 @@ void
 vtn_emit_cf_func_structured(struct vtn_builder *b, struct vtn_function *func,
                             vtn_instruction_handler handler)
 {
+   vtn_build_structured_cfg(b, func);
+
    struct vtn_construct *current =
       list_first_entry(&func->constructs, struct vtn_construct, link);
    vtn_assert(current->type == vtn_construct_type_function);
@@ -0,0 +1,157 @@
+#!/bin/bash
+#
+# Measure instruction latencies for ir3's latency tables (ir3_delay.c).
+#
+# For each producer we launch a single invocation that overwrites a register
+# with a known value, waits a number of cycles using nops *without* the sync
+# flag the compiler would normally use, and then copies the register with the
+# consumer.  The smallest number of nops for which the consumer sees the new
+# value is the latency reported for the producer.
+#
+# The (sy) producers are loaded once before the measured load so that the data
+# is already in cache, which is what the tables assume.  Textures aren't
+# supported by computerator, so the tex latencies have to be measured some
+# other way.
+#
+# Usage: test-latency.sh [-v] [max nops]
+#
+# add '-v' arg to see the result values
+
+set -e
+
+if [ "$1" = "-v" ]; then
+	verbose="true"
+	shift
+fi
+
+max_nops=${1:-200}
+
+#
+# Helper to emit n cycles worth of nops:
+#
+nops() {
+	n=$1
+	while [ $n -gt 6 ]; do
+		echo "(rpt5)nop"
+		n=$((n - 6))
+	done
+	if [ $n -gt 0 ]; then
+		echo "(rpt$((n - 1)))nop"
+	fi
+}
+
+header_asm() {
+	cat <<EOF
+@localsize 1, 1, 1
+@buf 4 (c2.x)  ; g[0], c2.xy
+@ubo 4 42, 43, 44, 45 ; UBO 0
+@invocationid(r0.x)
+mov.u32u32 r0.y, c2.x
+mov.u32u32 r0.z, c2.y
+mov.u32u32 r0.w, 42
+mov.f32f32 r3.x, (4.0)
+mov.u32u32 r1.x, 0xdeadbeef
+mov.u32u32 r1.y, 0xdeadbeef
+mov.u32u32 r1.z, 0xdeadbeef
+mov.u32u32 r1.w, 0xdeadbeef
+(rpt5)nop
+stg.a.u32 g[r0.y+r0.x<<2+0<<2], r0.w, 1
+(sy)(ss)(rpt5)nop
+EOF
+}
+
+footer_asm() {
+	cat <<EOF
+stib.b.untyped.1d.u32.1.imm r2.x, r0.x, 0
+(sy)nop
+end
+nop
+EOF
+}
+
+#
+# Producers, each writing the last component of r1 that the consumer copies
+# to r2.x, along with the value the consumer is expected to see.  The
+# non_alu producer is consumed by the store directly.
+#
+gen_test() {
+	name=$1
+	n=$2
+
+	header_asm
+	case $name in
+	alu_to_alu)
+		echo "add.u r1.x, r0.w, 0"
+		nops $n
+		echo "add.u r2.x, r1.x, 0"
+		;;
+	non_alu)
+		echo "add.u r2.x, r0.w, 0"
+		nops $n
+		;;
+	sfu_ss)
+		echo "rcp r1.x, r3.x"
+		nops $n
+		echo "mov.u32u32 r2.x, r1.x"
+		;;
+	ldc.[1-4])
+		comps=${name#ldc.}
+		echo "ldc.offset0.$comps.imm r1.x, 0, 0"
+		echo "(sy)(rpt5)nop"
+		echo "mov.u32u32 r1.x, 0xdeadbeef"
+		echo "mov.u32u32 r1.y, 0xdeadbeef"
+		echo "mov.u32u32 r1.z, 0xdeadbeef"
+		echo "mov.u32u32 r1.w, 0xdeadbeef"
+		echo "(rpt5)nop"
+		echo "ldc.offset0.$comps.imm r1.x, 0, 0"
+		nops $n
+		echo "mov.u32u32 r2.x, r1.$(echo xyzw | cut -c$comps)"
+		;;
+	ldg)
+		echo "ldg.a.u32 r1.x, g[r0.y+r0.x<<2+0<<2], 1"
+		echo "(sy)(rpt5)nop"
+		echo "mov.u32u32 r1.x, 0xdeadbeef"
+		echo "(rpt5)nop"
+		echo "ldg.a.u32 r1.x, g[r0.y+r0.x<<2+0<<2], 1"
+		nops $n
+		echo "mov.u32u32 r2.x, r1.x"
+		;;
+	esac
+	if [ $name != non_alu ]; then
+		nops 6
+	fi
+	footer_asm
+}
+
+expected() {
+	case $1 in
+	sfu_ss)  echo "3e800000" ;;   # 1.0 / 4.0
+	ldc.2)   echo "0000002b" ;;
+	ldc.3)   echo "0000002c" ;;
+	ldc.4)   echo "0000002d" ;;
+	*)       echo "0000002a" ;;
+	esac
+}
+
+#
+# Run the tests!
+#
+
+for test in alu_to_alu non_alu sfu_ss ldc.1 ldc.2 ldc.3 ldc.4 ldg; do
+	want=$(expected $test)
+	found=""
+	for n in `seq 0 $max_nops`; do
+		str=`gen_test $test $n | ./computerator -g 1,1,1 | grep "	" | head -1 | xargs`
+		if [ "$verbose" = "true" ]; then
+			echo "$test: $n nops: $str"
+		fi
+		if [ "${str%% *}" = "$want" ]; then
+			found=$n
+			break
+		fi
+		# back-to-back runs of computerator seem to somehow clobber each
+		# other.. which isn't great..
+		sleep 0.1
+	done
+	echo "$test: ${found:-more than $max_nops}"
+done
@@ -23,6 +23,8 @@
 
 #include "freedreno_layout.h"
 
+#include "c11/threads.h"
+
 #if DETECT_ARCH_AARCH64
 #include <arm_neon.h>
 #elif (DETECT_ARCH_X86 || DETECT_ARCH_X86_64) && defined(__AVX2__)
@@ -1090,3 +1092,153 @@ fdl6_memcpy_tiled_to_linear(uint32_t x_start, uint32_t y_start,
    }
 #endif
 }
+
+/* Copies are split into bands of whole macrotile rows, one per thread, so
+ * that threads never touch the same UBWC block.  Below this size per thread
+ * the thread creation overhead outweighs the gain.
+ */
+#define MEMCPY_THREAD_MIN_SIZE (1024 * 1024)
+#define MEMCPY_MAX_THREADS 8
+
+struct memcpy_band {
+   bool to_tiled;
+   uint32_t x_start, y_start;
+   uint32_t width, height;
+   char *tiled;
+   char *linear;
+   const struct fdl_layout *layout;
+   unsigned miplevel;
+   uint32_t linear_pitch;
+   const struct fdl_ubwc_config *config;
+};
+
+static int
+memcpy_band_run(void *data)
+{
+   const struct memcpy_band *band = (const struct memcpy_band *)data;
+
+   if (band->to_tiled) {
+      fdl6_memcpy_linear_to_tiled(band->x_start, band->y_start,
+                                  band->width, band->height,
+                                  band->tiled, band->linear, band->layout,
+                                  band->miplevel, band->linear_pitch,
+                                  band->config);
+   } else {
+      fdl6_memcpy_tiled_to_linear(band->x_start, band->y_start,
+                                  band->width, band->height,
+                                  band->linear, band->tiled, band->layout,
+                                  band->miplevel, band->linear_pitch,
+                                  band->config);
+   }
+
+   return 0;
+}
+
+static void
+memcpy_threaded(const struct memcpy_band *copy, unsigned max_threads)
+{
+   unsigned block_width, block_height;
+   get_block_size(copy->layout->cpp, false, &block_width, &block_height);
+
+   uint32_t row_height = block_height * 4;
+   uint32_t y_end = copy->y_start + copy->height;
+   uint32_t first_row = copy->y_start / row_height;
+   uint32_t rows = DIV_ROUND_UP(y_end, row_height) - first_row;
+   uint64_t size = (uint64_t)copy->width * copy->height * copy->layout->cpp;
+
+   unsigned num_threads = MIN2(max_threads, MEMCPY_MAX_THREADS);
+   num_threads = MIN2(num_threads, size / MEMCPY_THREAD_MIN_SIZE);
+   num_threads = MIN2(num_threads, rows);
+
+   if (num_threads <= 1) {
+      memcpy_band_run((void *)copy);
+      return;
+   }
+
+   struct memcpy_band bands[MEMCPY_MAX_THREADS];
+   thrd_t threads[MEMCPY_MAX_THREADS];
+   bool spawned[MEMCPY_MAX_THREADS] = {};
+
+   uint32_t y = copy->y_start;
+   for (unsigned i = 0; i < num_threads; i++) {
+      uint32_t band_end = i == num_threads - 1 ? y_end :
+         (first_row + rows * (i + 1) / num_threads) * row_height;
+
+      bands[i] = *copy;
+      bands[i].y_start = y;
+      bands[i].height = band_end - y;
+      bands[i].linear = copy->linear + (y - copy->y_start) * copy->linear_pitch;
+      y = band_end;
+   }
+
+   /* The calling thread takes the first band.  If a thread can't be
+    * created, its band is copied inline instead.
+    */
+   for (unsigned i = 1; i < num_threads; i++) {
+      spawned[i] =
+         thrd_create(&threads[i], memcpy_band_run, &bands[i]) == thrd_success;
+   }
+
+   memcpy_band_run(&bands[0]);
+
+   for (unsigned i = 1; i < num_threads; i++) {
+      if (spawned[i])
+         thrd_join(threads[i], NULL);
+      else
+         memcpy_band_run(&bands[i]);
+   }
+}
+
+void
+fdl6_memcpy_linear_to_tiled_threaded(uint32_t x_start, uint32_t y_start,
+                                     uint32_t width, uint32_t height,
+                                     char *dst, const char *src,
+                                     const struct fdl_layout *dst_layout,
+                                     unsigned dst_miplevel,
+                                     uint32_t src_pitch,
+                                     const struct fdl_ubwc_config *config,
+                                     unsigned max_threads)
+{
+   const struct memcpy_band copy = {
+      .to_tiled = true,
+      .x_start = x_start,
+      .y_start = y_start,
+      .width = width,
+      .height = height,
+      .tiled = dst,
+      .linear = (char *)src,
+      .layout = dst_layout,
+      .miplevel = dst_miplevel,
+      .linear_pitch = src_pitch,
+      .config = config,
+   };
+
+   memcpy_threaded(&copy, max_threads);
+}
+
+void
+fdl6_memcpy_tiled_to_linear_threaded(uint32_t x_start, uint32_t y_start,
+                                     uint32_t width, uint32_t height,
+                                     char *dst, const char *src,
+                                     const struct fdl_layout *src_layout,
+                                     unsigned src_miplevel,
+                                     uint32_t dst_pitch,
+                                     const struct fdl_ubwc_config *config,
+                                     unsigned max_threads)
+{
+   const struct memcpy_band copy = {
+      .to_tiled = false,
+      .x_start = x_start,
+      .y_start = y_start,
+      .width = width,
+      .height = height,
+      .tiled = (char *)src,
+      .linear = dst,
+      .layout = src_layout,
+      .miplevel = src_miplevel,
+      .linear_pitch = dst_pitch,
+      .config = config,
+   };
+
+   memcpy_threaded(&copy, max_threads);
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Benchmark for the CPU tiling paths used by host image copy.
+ *
+ * With --check, only verifies that the threaded copies produce the same
+ * result as the single-threaded ones and that linear -> tiled -> linear
+ * round-trips, using unaligned regions.
+ */
+
+#include "freedreno_layout.h"
+#include "fd6_hw.h"
+
+#include "util/os_time.h"
+#include "util/u_cpu_detect.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const enum pipe_format formats[] = {
+   PIPE_FORMAT_R8_UNORM,
+   PIPE_FORMAT_R8G8_UNORM,
+   PIPE_FORMAT_R8G8B8A8_UNORM,
+   PIPE_FORMAT_R16G16B16A16_UNORM,
+   PIPE_FORMAT_R32G32B32A32_UINT,
+};
+
+static const struct fdl_ubwc_config ubwc_configs[] = {
+   { .highest_bank_bit = 15, .bank_swizzle_levels = 0x6,
+     .macrotile_mode = FDL_MACROTILE_4_CHANNEL },
+   { .highest_bank_bit = 16, .bank_swizzle_levels = 0x6,
+     .macrotile_mode = FDL_MACROTILE_8_CHANNEL },
+};
+
+struct image {
+   struct fdl_layout layout;
+   char *tiled;
+   char *linear;
+   uint32_t linear_pitch;
+};
+
+static void
+image_init(struct image *image, const struct fd_dev_info *dev_info,
+           enum pipe_format format, uint32_t width, uint32_t height)
+{
+   struct fdl_image_params params = {
+      .format = format,
+      .nr_samples = 1,
+      .width0 = width,
+      .height0 = height,
+      .depth0 = 1,
+      .mip_levels = 1,
+      .array_size = 1,
+      .tile_mode = TILE6_3,
+   };
+
+   fdl6_layout_image(&image->layout, dev_info, &params, NULL);
+
+   image->linear_pitch = width * image->layout.cpp;
+   image->tiled = (char *)calloc(1, image->layout.size);
+   image->linear = (char *)malloc((size_t)image->linear_pitch * height);
+
+   for (size_t i = 0; i < (size_t)image->linear_pitch * height; i++)
+      image->linear[i] = (char)(i * 7 + i / 251);
+}
+
+static void
+image_finish(struct image *image)
+{
+   free(image->tiled);
+   free(image->linear);
+}
+
+static bool
+check_format(const struct fd_dev_info *dev_info, enum pipe_format format,
+             const struct fdl_ubwc_config *config, unsigned threads)
+{
+   /* Odd offsets and sizes exercise the unaligned edges of every band. */
+   const uint32_t width = 2045, height = 2051;
+   const uint32_t x = 3, y = 5;
+   struct image image;
+   bool ok = true;
+
+   image_init(&image, dev_info, format, width + x, height + y);
+
+   char *tiled = (char *)calloc(1, image.layout.size);
+   char *linear = (char *)calloc(1, (size_t)image.linear_pitch * (height + y));
+
+   fdl6_memcpy_linear_to_tiled(x, y, width, height, image.tiled,
+                               image.linear, &image.layout, 0,
+                               image.linear_pitch, config);
+   fdl6_memcpy_linear_to_tiled_threaded(x, y, width, height, tiled,
+                                        image.linear, &image.layout, 0,
+                                        image.linear_pitch, config, threads);
+   if (memcmp(tiled, image.tiled, image.layout.size)) {
+      fprintf(stderr, "%s: threaded linear to tiled mismatch\n",
+              util_format_short_name(format));
+      ok = false;
+   }
+
+   fdl6_memcpy_tiled_to_linear_threaded(x, y, width, height, linear, tiled,
+                                        &image.layout, 0, image.linear_pitch,
+                                        config, threads);
+   for (uint32_t row = 0; row < height; row++) {
+      if (memcmp(linear + row * image.linear_pitch,
+                 image.linear + row * image.linear_pitch,
+                 width * image.layout.cpp)) {
+         fprintf(stderr, "%s: round trip mismatch at row %u\n",
+                 util_format_short_name(format), row);
+         ok = false;
+         break;
+      }
+   }
+
+   free(tiled);
+   free(linear);
+   image_finish(&image);
+   return ok;
+}
+
+static void
+bench_format(const struct fd_dev_info *dev_info, enum pipe_format format,
+             const struct fdl_ubwc_config *config, uint32_t size,
+             unsigned iterations, unsigned threads)
+{
+   struct image image;
+   image_init(&image, dev_info, format, size, size);
+
+   double mb = (double)size * size * image.layout.cpp / (1024 * 1024);
+
+   for (unsigned dir = 0; dir < 2; dir++) {
+      int64_t start = os_time_get_nano();
+      for (unsigned i = 0; i < iterations; i++) {
+         if (dir == 0) {
+            fdl6_memcpy_linear_to_tiled_threaded(0, 0, size, size,
+                                                 image.tiled, image.linear,
+                                                 &image.layout, 0,
+                                                 image.linear_pitch, config,
+                                                 threads);
+         } else {
+            fdl6_memcpy_tiled_to_linear_threaded(0, 0, size, size,
+                                                 image.linear, image.tiled,
+                                                 &image.layout, 0,
+                                                 image.linear_pitch, config,
+                                                 threads);
+         }
+      }
+      double secs = (os_time_get_nano() - start) / 1e9;
+
+      printf("%-20s %2u cpp %-6s %-15s %2u threads: %8.1f MB/s\n",
+             util_format_short_name(format), image.layout.cpp,
+             config->macrotile_mode == FDL_MACROTILE_4_CHANNEL ? "4chan" : "8chan",
+             dir == 0 ? "linear->tiled" : "tiled->linear", threads,
+             mb * iterations / secs);
+   }
+
+   image_finish(&image);
+}
+
+static void
+usage(const char *name)
+{
+   fprintf(stderr,
+           "Usage: %s [--check] [-s size] [-n iterations] [-t threads]\n",
+           name);
+}
+
+int
+main(int argc, char **argv)
+{
+   static const struct option opts[] = {
+      { "check", no_argument, NULL, 'c' },
+      { "size", required_argument, NULL, 's' },
+      { "iterations", required_argument, NULL, 'n' },
+      { "threads", required_argument, NULL, 't' },
+      { NULL, 0, NULL, 0 },
+   };
+   bool check = false;
+   uint32_t size = 4096;
+   unsigned iterations = 10;
+   unsigned threads = util_get_cpu_caps()->nr_cpus;
+   int c;
+
+   while ((c = getopt_long(argc, argv, "cs:n:t:", opts, NULL)) != -1) {
+      switch (c) {
+      case 'c':
+         check = true;
+         break;
+      case 's':
+         size = atoi(optarg);
+         break;
+      case 'n':
+         iterations = atoi(optarg);
+         break;
+      case 't':
+         threads = atoi(optarg);
+         break;
+      default:
+         usage(argv[0]);
+         return 1;
+      }
+   }
+
+   struct fd_dev_id dev_id = {
+      .gpu_id = 660,
+   };
+   const struct fd_dev_info *dev_info = fd_dev_info_raw(&dev_id);
+   int ret = 0;
+
+   for (unsigned i = 0; i < ARRAY_SIZE(ubwc_configs); i++) {
+      for (unsigned f = 0; f < ARRAY_SIZE(formats); f++) {
+         if (check) {
+            if (!check_format(dev_info, formats[f], &ubwc_configs[i], 4))
+               ret = 1;
+            continue;
+         }
+
+         bench_format(dev_info, formats[f], &ubwc_configs[i], size,
+                      iterations, 1);
+         if (threads > 1) {
+            bench_format(dev_info, formats[f], &ubwc_configs[i], size,
+                         iterations, threads);
+         }
+      }
+   }
+
+   return ret;
+}
@@ -459,6 +459,29 @@ fdl6_memcpy_tiled_to_linear(uint32_t x_start, uint32_t y_start,
                             uint32_t dst_pitch,
                             const struct fdl_ubwc_config *config);
 
+/* Same as above, but large copies are split across up to max_threads
+ * threads.
+ */
+void
+fdl6_memcpy_linear_to_tiled_threaded(uint32_t x_start, uint32_t y_start,
+                                     uint32_t width, uint32_t height,
+                                     char *dst, const char *src,
+                                     const struct fdl_layout *dst_layout,
+                                     unsigned dst_miplevel,
+                                     uint32_t src_pitch,
+                                     const struct fdl_ubwc_config *config,
+                                     unsigned max_threads);
+
+void
+fdl6_memcpy_tiled_to_linear_threaded(uint32_t x_start, uint32_t y_start,
+                                     uint32_t width, uint32_t height,
+                                     char *dst, const char *src,
+                                     const struct fdl_layout *src_layout,
+                                     unsigned src_miplevel,
+                                     uint32_t dst_pitch,
+                                     const struct fdl_ubwc_config *config,
+                                     unsigned max_threads);
+
 uint32_t fdl6_get_bank_mask(const struct fdl_layout *layout, unsigned miplevel,
                             const struct fdl_ubwc_config *config);
 
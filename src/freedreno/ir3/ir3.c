@@ -36,7 +36,11 @@ ir3_create(struct ir3_compiler *compiler, struct ir3_shader_variant *v)
 
    shader->compiler = compiler;
    shader->type = v->type;
-   shader->lin_ctx = linear_context(shader);
+   /* The IR only lives for the duration of the compile. */
+   const linear_opts lin_opts = {
+      .arena = true,
+   };
+   shader->lin_ctx = linear_context_with_opts(shader, &lin_opts);
 
    list_inithead(&shader->block_list);
    list_inithead(&shader->array_list);
@@ -477,7 +481,7 @@ ir3_collect_info(struct ir3_shader_variant *v)
             }
 
             if (is_ss_producer(instr)) {
-               bd->sfu_delay = soft_ss_delay(instr);
+               bd->sfu_delay = soft_ss_delay(shader->compiler, instr);
             } else {
                int n = MIN2(bd->sfu_delay, 1 + instr->repeat + instr->nop);
                bd->sfu_delay -= n;
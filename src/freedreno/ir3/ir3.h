@@ -13,6 +13,7 @@
 
 #include "util/bitscan.h"
 #include "util/list.h"
+#include "util/range_minimum_query.h"
 #include "util/set.h"
 #include "util/u_debug.h"
 
@@ -683,6 +684,12 @@ struct ir3 {
    /* List of ir3_array's: */
    struct list_head array_list;
 
+   /* Used by ir3_dominance_lca(), computed by ir3_calc_dominance(). The
+    * table is indexed by dom_pre_index.
+    */
+   struct range_minimum_query_table dom_lca_table;
+   struct ir3_block **dom_lca_blocks;
+
 #if MESA_DEBUG
    unsigned block_count;
 #endif
@@ -2070,6 +2077,9 @@ struct log_stream;
 void ir3_print_instr_stream(struct log_stream *stream, struct ir3_instruction *instr);
 
 /* delay calculation: */
+unsigned soft_ss_delay(struct ir3_compiler *compiler,
+                       struct ir3_instruction *instr);
+unsigned soft_sy_delay(struct ir3_instruction *instr, struct ir3 *shader);
 unsigned ir3_src_read_delay(struct ir3_compiler *compiler,
                             struct ir3_instruction *instr, unsigned src_n);
 int ir3_delayslots(struct ir3_compiler *compiler,
@@ -2126,29 +2136,6 @@ supports_ss(struct ir3_instruction *instr)
    return opc_cat(instr->opc) < 5 || instr->opc == OPC_ALIAS;
 }
 
-/* The soft delay for approximating the cost of (ss). */
-static inline unsigned
-soft_ss_delay(struct ir3_instruction *instr)
-{
-   /* On a6xx, it takes the number of delay slots to get a SFU result back (ie.
-    * using nop's instead of (ss) is:
-    *
-    *     8 - single warp
-    *     9 - two warps
-    *    10 - four warps
-    *
-    * and so on. Not quite sure where it tapers out (ie. how many warps share an
-    * SFU unit). But 10 seems like a reasonable # to choose:
-    */
-   if (is_sfu(instr) || is_local_mem_load(instr))
-      return 10;
-
-   /* The blob adds 6 nops between shared producers and consumers, and before we
-    * used (ss) this was sufficient in most cases.
-    */
-   return 6;
-}
-
 static inline bool
 is_sy_producer(struct ir3_instruction *instr)
 {
@@ -2157,60 +2144,6 @@ is_sy_producer(struct ir3_instruction *instr)
       is_atomic(instr->opc);
 }
 
-static inline unsigned
-soft_sy_delay(struct ir3_instruction *instr, struct ir3 *shader)
-{
-   /* TODO: this is just an optimistic guess, we can do better post-RA.
-    */
-   bool double_wavesize =
-      shader->type == MESA_SHADER_FRAGMENT ||
-      shader->type == MESA_SHADER_COMPUTE;
-
-   unsigned components = reg_elems(instr->dsts[0]);
-
-   /* These numbers come from counting the number of delay slots to get
-    * cat5/cat6 results back using nops instead of (sy). Note that these numbers
-    * are with the result preloaded to cache by loading it before in the same
-    * shader - uncached results are much larger.
-    *
-    * Note: most ALU instructions can't complete at the full doubled rate, so
-    * they take 2 cycles. The only exception is fp16 instructions with no
-    * built-in conversions. Therefore divide the latency by 2.
-    *
-    * TODO: Handle this properly in the scheduler and remove this.
-    */
-   if (instr->opc == OPC_LDC) {
-      if (double_wavesize)
-         return (21 + 8 * components) / 2;
-      else
-         return 18 + 4 * components;
-   } else if (is_tex_or_prefetch(instr)) {
-      if (double_wavesize) {
-         switch (components) {
-         case 1: return 58 / 2;
-         case 2: return 60 / 2;
-         case 3: return 77 / 2;
-         case 4: return 79 / 2;
-         default: UNREACHABLE("bad number of components");
-         }
-      } else {
-         switch (components) {
-         case 1: return 51;
-         case 2: return 53;
-         case 3: return 62;
-         case 4: return 64;
-         default: UNREACHABLE("bad number of components");
-         }
-      }
-   } else {
-      /* TODO: measure other cat6 opcodes like ldg */
-      if (double_wavesize)
-         return (172 + components) / 2;
-      else
-         return 109 + components;
-   }
-}
-
 /* Some instructions don't immediately consume their sources so may introduce a
  * WAR hazard.
  */
@@ -176,9 +176,11 @@ ir3_compiler_create(struct fd_device *dev, const struct fd_dev_id *dev_id,
    compiler->has_branch_and_or = false;
    compiler->has_rpt_bary_f = false;
    compiler->has_alias_tex = false;
-   compiler->delay_slots.alu_to_alu = 3;
-   compiler->delay_slots.non_alu = 6;
-   compiler->delay_slots.cat3_src2_read = 2;
+
+   compiler->latency = ir3_latency_table_get(dev_id, compiler->gen);
+   compiler->delay_slots.alu_to_alu = compiler->latency->alu_to_alu;
+   compiler->delay_slots.non_alu = compiler->latency->non_alu;
+   compiler->delay_slots.cat3_src2_read = compiler->latency->cat3_src2_read;
 
    if (compiler->gen >= 6) {
       compiler->samgq_workaround = true;
@@ -271,12 +273,6 @@ ir3_compiler_create(struct fd_device *dev, const struct fd_dev_id *dev_id,
       compiler->has_eolm_eogm = dev_info->props.has_eolm_eogm;
 
       compiler->has_alias_tex = (compiler->gen >= 7);
-
-      if (compiler->gen == 7) {
-         compiler->delay_slots.alu_to_alu = 2;
-         compiler->delay_slots.non_alu = 5;
-         compiler->delay_slots.cat3_src2_read = 1;
-      }
    } else {
       compiler->max_const_pipeline = 512;
       compiler->max_const_geom = 512;
@@ -23,6 +23,40 @@ BEGINC;
 struct ir3_ra_reg_set;
 struct ir3_shader;
 
+/* Per-GPU instruction latencies, in cycles, as measured by counting the nops
+ * needed between a producer and its consumer before the consumer sees the
+ * result (see computerator/examples/test-latency.sh).
+ *
+ * The fixed latencies are hard requirements. The (ss) and (sy) ones are only
+ * estimates used by the schedulers to decide how much independent work to put
+ * between a producer and the first consumer that syncs on it.
+ */
+struct ir3_latency_table {
+   /* See ir3_compiler::delay_slots. */
+   unsigned alu_to_alu;
+   unsigned non_alu;
+   unsigned cat3_src2_read;
+
+   /* (ss) producers: SFU and local memory loads, and everything else (ie.
+    * shared register writes).
+    */
+   unsigned sfu_ss;
+   unsigned other_ss;
+
+   /* (sy) producers, indexed by whether the shader runs with a doubled
+    * wavesize. Doubled wavesize numbers are measured with the same nop
+    * counting and halved when used, since most ALU instructions only complete
+    * at half rate there.
+    */
+   struct {
+      unsigned ldc_base;
+      unsigned ldc_per_comp;
+      unsigned tex[4];
+      unsigned mem_base;
+      unsigned mem_per_comp;
+   } sy[2];
+};
+
 struct ir3_compiler_options {
    /* If true, promote UBOs (except for constant data) to constants using ldc.k
     * in the preamble. The driver should ignore everything in ubo_state except
@@ -337,8 +371,16 @@ struct ir3_compiler {
        */
       unsigned cat3_src2_read;
    } delay_slots;
+
+   /* The table delay_slots is initialized from, also used for soft (ss) and
+    * (sy) delays.
+    */
+   const struct ir3_latency_table *latency;
 };
 
+const struct ir3_latency_table *
+ir3_latency_table_get(const struct fd_dev_id *dev_id, unsigned gen);
+
 void ir3_compiler_destroy(struct ir3_compiler *compiler);
 struct ir3_compiler *ir3_compiler_create(struct fd_device *dev,
                                          const struct fd_dev_id *dev_id,
@@ -356,6 +398,12 @@ bool ir3_disk_cache_retrieve(struct ir3_shader *shader,
                              struct ir3_shader_variant *v);
 void ir3_disk_cache_store(struct ir3_shader *shader,
                           struct ir3_shader_variant *v);
+bool ir3_binning_cache_retrieve(struct ir3_shader *shader,
+                                struct ir3_shader_variant *v,
+                                cache_key key);
+void ir3_binning_cache_store(struct ir3_shader *shader,
+                             struct ir3_shader_variant *v,
+                             const cache_key key);
 
 const nir_shader_compiler_options *
 ir3_get_compiler_options(struct ir3_compiler *compiler);
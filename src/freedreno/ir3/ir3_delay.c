@@ -23,6 +23,145 @@
  * src iterators work.
  */
 
+/* Latency tables, see ir3_latency_table.
+ *
+ * The (ss)/(sy) numbers were measured on a6xx with the results preloaded to
+ * cache by loading them before in the same shader; uncached results are much
+ * larger. Older generations have not been measured and share the a6xx table.
+ */
+static const struct ir3_latency_table a6xx_latency = {
+   .alu_to_alu = 3,
+   .non_alu = 6,
+   .cat3_src2_read = 2,
+
+   /* It takes 8 cycles to get a SFU result back with a single warp, 9 with two
+    * warps, 10 with four, and so on. Not quite sure where it tapers out (ie.
+    * how many warps share an SFU unit), but 10 seems like a reasonable number.
+    *
+    * The blob adds 6 nops between shared producers and consumers, and before
+    * we used (ss) this was sufficient in most cases.
+    */
+   .sfu_ss = 10,
+   .other_ss = 6,
+
+   .sy = {
+      {
+         .ldc_base = 18,
+         .ldc_per_comp = 4,
+         .tex = { 51, 53, 62, 64 },
+         /* TODO: measure other cat6 opcodes like ldg */
+         .mem_base = 109,
+         .mem_per_comp = 1,
+      },
+      {
+         .ldc_base = 21,
+         .ldc_per_comp = 8,
+         .tex = { 58, 60, 77, 79 },
+         .mem_base = 172,
+         .mem_per_comp = 1,
+      },
+   },
+};
+
+/* a7xx shortened the ALU pipeline. Variable latencies have not been measured
+ * separately yet and are assumed to be the same as a6xx.
+ */
+static const struct ir3_latency_table a7xx_latency = {
+   .alu_to_alu = 2,
+   .non_alu = 5,
+   .cat3_src2_read = 1,
+
+   .sfu_ss = 10,
+   .other_ss = 6,
+
+   .sy = {
+      {
+         .ldc_base = 18,
+         .ldc_per_comp = 4,
+         .tex = { 51, 53, 62, 64 },
+         .mem_base = 109,
+         .mem_per_comp = 1,
+      },
+      {
+         .ldc_base = 21,
+         .ldc_per_comp = 8,
+         .tex = { 58, 60, 77, 79 },
+         .mem_base = 172,
+         .mem_per_comp = 1,
+      },
+   },
+};
+
+/* Tables are matched in order. A gpu_id of 0 matches every GPU of the
+ * generation, so GPU specific entries must come first.
+ */
+static const struct {
+   unsigned gen;
+   uint32_t gpu_id;
+   const struct ir3_latency_table *table;
+} latency_tables[] = {
+   { 7, 0, &a7xx_latency },
+   { 6, 0, &a6xx_latency },
+};
+
+const struct ir3_latency_table *
+ir3_latency_table_get(const struct fd_dev_id *dev_id, unsigned gen)
+{
+   uint32_t gpu_id = fd_dev_gpu_id(dev_id);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(latency_tables); i++) {
+      if (latency_tables[i].gen != gen)
+         continue;
+      if (latency_tables[i].gpu_id && latency_tables[i].gpu_id != gpu_id)
+         continue;
+      return latency_tables[i].table;
+   }
+
+   return &a6xx_latency;
+}
+
+/* The soft delay for approximating the cost of (ss). */
+unsigned
+soft_ss_delay(struct ir3_compiler *compiler, struct ir3_instruction *instr)
+{
+   if (is_sfu(instr) || is_local_mem_load(instr))
+      return compiler->latency->sfu_ss;
+
+   return compiler->latency->other_ss;
+}
+
+unsigned
+soft_sy_delay(struct ir3_instruction *instr, struct ir3 *shader)
+{
+   /* TODO: this is just an optimistic guess, we can do better post-RA.
+    */
+   bool double_wavesize =
+      shader->type == MESA_SHADER_FRAGMENT ||
+      shader->type == MESA_SHADER_COMPUTE;
+   const struct ir3_latency_table *latency = shader->compiler->latency;
+   unsigned components = reg_elems(instr->dsts[0]);
+   unsigned cycles;
+
+   if (instr->opc == OPC_LDC) {
+      cycles = latency->sy[double_wavesize].ldc_base +
+               latency->sy[double_wavesize].ldc_per_comp * components;
+   } else if (is_tex_or_prefetch(instr)) {
+      assert(components >= 1 && components <= 4);
+      cycles = latency->sy[double_wavesize].tex[components - 1];
+   } else {
+      cycles = latency->sy[double_wavesize].mem_base +
+               latency->sy[double_wavesize].mem_per_comp * components;
+   }
+
+   /* Most ALU instructions can't complete at the full doubled rate, so they
+    * take 2 cycles. The only exception is fp16 instructions with no built-in
+    * conversions. Therefore divide the latency by 2.
+    *
+    * TODO: Handle this properly in the scheduler and remove this.
+    */
+   return double_wavesize ? cycles / 2 : cycles;
+}
+
 /* Return the number of cycles from the start of the instruction until src_n is
  * read.
  */
@@ -73,7 +212,7 @@ ir3_delayslots(struct ir3_compiler *compiler,
       return compiler->delay_slots.non_alu;
 
    if (soft && needs_ss(compiler, assigner, consumer))
-      return soft_ss_delay(assigner);
+      return soft_ss_delay(compiler, assigner);
 
    /* handled via sync flags: */
    if (needs_ss(compiler, assigner, consumer) ||
@@ -280,3 +280,149 @@ ir3_disk_cache_store(struct ir3_shader *shader,
    disk_cache_put(shader->compiler->disk_cache, cache_key, blob.data, blob.size, NULL);
    blob_finish(&blob);
 }
+
+/*
+ * Binning variant cache.
+ *
+ * The binning pass variant is compiled from the same NIR as the draw pass
+ * variant with all non-position outputs removed, so two shaders that only
+ * differ in their varyings produce the same binning variant as long as the
+ * state it inherits from the draw pass variant matches: the const layout,
+ * the vertex inputs that must be kept alive and (pre-a7xx) the size of the
+ * immediates range.
+ */
+static void
+compute_binning_key(struct ir3_shader *shader, struct ir3_shader_variant *v,
+                    cache_key cache_key)
+{
+   const struct ir3_shader_variant *nonbinning = v;
+   struct mesa_sha1 ctx;
+
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, "ir3_binning", strlen("ir3_binning"));
+
+   nir_shader *nir = nir_shader_clone(NULL, shader->nir);
+   ir3_nir_lower_binning(nir);
+
+   bool progress;
+   do {
+      progress = false;
+      NIR_PASS(progress, nir, nir_opt_dce);
+      NIR_PASS(progress, nir, nir_opt_dead_cf);
+   } while (progress);
+
+   nir_shader_gather_info(nir, nir_shader_get_entrypoint(nir));
+   memset(nir->info.source_blake3, 0, sizeof(nir->info.source_blake3));
+
+   struct blob blob;
+   blob_init(&blob);
+   nir_serialize(&blob, nir, true);
+   _mesa_sha1_update(&ctx, blob.data, blob.size);
+   blob_finish(&blob);
+   ralloc_free(nir);
+
+   uint64_t debug_flags = ir3_shader_debug_hash_key();
+   _mesa_sha1_update(&ctx, &debug_flags, sizeof(debug_flags));
+   _mesa_sha1_update(&ctx, &shader->compiler->gen,
+                     sizeof(shader->compiler->gen));
+   _mesa_sha1_update(&ctx, &shader->options.api_wavesize,
+                     sizeof(shader->options.api_wavesize));
+   _mesa_sha1_update(&ctx, &shader->options.real_wavesize,
+                     sizeof(shader->options.real_wavesize));
+   _mesa_sha1_update(&ctx, &shader->options.push_consts_type,
+                     sizeof(shader->options.push_consts_type));
+   _mesa_sha1_update(&ctx, &shader->options.push_consts_base,
+                     sizeof(shader->options.push_consts_base));
+   _mesa_sha1_update(&ctx, &shader->options.push_consts_dwords,
+                     sizeof(shader->options.push_consts_dwords));
+   _mesa_sha1_update(&ctx, &shader->options.nir_options,
+                     sizeof(shader->options.nir_options));
+   _mesa_sha1_update(&ctx, &shader->stream_output,
+                     sizeof(shader->stream_output));
+
+   _mesa_sha1_update(&ctx, &shader->nir->info.num_ssbos,
+                     sizeof(shader->nir->info.num_ssbos));
+   _mesa_sha1_update(&ctx, &shader->nir->info.num_images,
+                     sizeof(shader->nir->info.num_images));
+
+   _mesa_sha1_update(&ctx, &v->key, sizeof(v->key));
+   _mesa_sha1_update(&ctx, &v->mergedregs, sizeof(v->mergedregs));
+
+   _mesa_sha1_update(&ctx, nonbinning->const_state,
+                     sizeof(*nonbinning->const_state));
+   _mesa_sha1_update(&ctx, &nonbinning->inputs_count,
+                     sizeof(nonbinning->inputs_count));
+   _mesa_sha1_update(&ctx, nonbinning->inputs,
+                     nonbinning->inputs_count * sizeof(nonbinning->inputs[0]));
+   _mesa_sha1_update(&ctx, &nonbinning->imm_state.size,
+                     sizeof(nonbinning->imm_state.size));
+
+   _mesa_sha1_final(&ctx, cache_key);
+}
+
+/*
+ * Looks up the binning variant of v in the shader's binning cache.  The
+ * computed key is returned in cache_key so that it can be passed to
+ * ir3_binning_cache_store() on a miss.
+ */
+bool
+ir3_binning_cache_retrieve(struct ir3_shader *shader,
+                           struct ir3_shader_variant *v, cache_key cache_key)
+{
+   const struct ir3_binning_cache *cache = shader->binning_cache;
+
+   compute_binning_key(shader, v, cache_key);
+
+   size_t size;
+   void *buffer = cache->lookup(cache->data, cache_key, &size);
+
+   if (debug) {
+      char sha1[SHA1_DIGEST_STRING_LENGTH];
+      _mesa_sha1_format(sha1, cache_key);
+      fprintf(stderr, "[binning cache] retrieving variant %s: %s\n", sha1,
+              buffer ? "found" : "missing");
+   }
+
+   if (!buffer)
+      return false;
+
+   /* Keep the freshly initialized variant around in case the entry turns
+    * out to be truncated and we have to compile it after all.
+    */
+   void *backup = malloc(VARIANT_CACHE_SIZE);
+   if (!backup) {
+      free(buffer);
+      return false;
+   }
+   memcpy(backup, VARIANT_CACHE_PTR(v->binning), VARIANT_CACHE_SIZE);
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, buffer, size);
+
+   retrieve_variant(&blob, v->binning);
+
+   if (blob.overrun)
+      memcpy(VARIANT_CACHE_PTR(v->binning), backup, VARIANT_CACHE_SIZE);
+
+   free(backup);
+   free(buffer);
+
+   return !blob.overrun;
+}
+
+void
+ir3_binning_cache_store(struct ir3_shader *shader,
+                        struct ir3_shader_variant *v, const cache_key cache_key)
+{
+   const struct ir3_binning_cache *cache = shader->binning_cache;
+
+   struct blob blob;
+   blob_init(&blob);
+
+   store_variant(&blob, v->binning);
+
+   if (!blob.out_of_memory)
+      cache->insert(cache->data, cache_key, blob.data, blob.size);
+
+   blob_finish(&blob);
+}
@@ -55,14 +55,22 @@ calc_dominance(struct ir3_block *block)
    return false;
 }
 
-static unsigned
-calc_dfs_indices(struct ir3_block *block, unsigned index)
+/* Preorder and postorder indices are counted separately, which keeps the
+ * preorder dense for the LCA table.
+ */
+static void
+calc_dfs_indices(struct ir3 *ir, struct ir3_block *block,
+                 unsigned *pre_index, unsigned *post_index)
 {
-   block->dom_pre_index = index++;
+   block->dom_pre_index = (*pre_index)++;
+
+   ir->dom_lca_blocks[block->dom_pre_index] = block;
+   ir->dom_lca_table.table[block->dom_pre_index] =
+      block->imm_dom ? block->imm_dom->dom_pre_index : 0;
+
    for (unsigned i = 0; i < block->dom_children_count; i++)
-      index = calc_dfs_indices(block->dom_children[i], index);
-   block->dom_post_index = index++;
-   return index;
+      calc_dfs_indices(ir, block->dom_children[i], pre_index, post_index);
+   block->dom_post_index = (*post_index)++;
 }
 
 void
@@ -95,7 +103,17 @@ ir3_calc_dominance(struct ir3 *ir)
          array_insert(block->imm_dom, block->imm_dom->dom_children, block);
    }
 
-   calc_dfs_indices(ir3_start_block(ir), 0);
+   ir->dom_lca_blocks =
+      reralloc(ir, ir->dom_lca_blocks, struct ir3_block *, i);
+   range_minimum_query_table_resize(&ir->dom_lca_table, ir, i);
+
+   unsigned pre_index = 0, post_index = 0;
+   calc_dfs_indices(ir, ir3_start_block(ir), &pre_index, &post_index);
+
+   /* Unreachable blocks are not part of the dominance tree */
+   if (pre_index != i)
+      range_minimum_query_table_resize(&ir->dom_lca_table, ir, pre_index);
+   range_minimum_query_table_preprocess(&ir->dom_lca_table);
 }
 
 /* Return true if a dominates b. This includes if a == b. */
@@ -119,5 +137,12 @@ ir3_dominance_lca(struct ir3_block *b1, struct ir3_block *b2)
    if (b2 == NULL)
       return b1;
 
-   return intersect(b1, b2);
+   struct ir3 *ir = b1->shader;
+   uint32_t index = range_minimum_query_tree_lca(&ir->dom_lca_table,
+                                                 b1->dom_pre_index,
+                                                 b2->dom_pre_index);
+   struct ir3_block *lca = ir->dom_lca_blocks[index];
+
+   assert(ir3_block_dominates(lca, b1) && ir3_block_dominates(lca, b2));
+   return lca;
 }
@@ -1046,8 +1046,8 @@ remove_nonbinning_output(nir_builder *b, nir_intrinsic_instr *intr, void *data)
    return true;
 }
 
-static bool
-lower_binning(nir_shader *s)
+bool
+ir3_nir_lower_binning(nir_shader *s)
 {
    return nir_shader_intrinsics_pass(s, remove_nonbinning_output,
                                      nir_metadata_control_flow, NULL);
@@ -1369,7 +1369,7 @@ ir3_nir_lower_variant(struct ir3_shader_variant *so,
    }
 
    if (so->binning_pass) {
-      if (OPT(s, lower_binning)) {
+      if (OPT(s, ir3_nir_lower_binning)) {
          progress = true;
 
          /* outputs_written has changed. */
@@ -127,7 +127,7 @@ schedule(struct ir3_postsched_ctx *ctx, struct ir3_instruction *instr)
       return;
 
    if (is_ss_producer(instr)) {
-      bd->ss_delay = soft_ss_delay(instr);
+      bd->ss_delay = soft_ss_delay(ctx->v->compiler, instr);
    } else if (has_ss_src(instr)) {
       bd->ss_delay = 0;
    } else if (bd->ss_delay > 0) {
@@ -571,7 +571,7 @@ sched_dag_max_delay_cb(struct dag_node *node, void *state)
 
       if (child->has_ss_src &&
           needs_ss(ctx->v->compiler, n->instr, child->instr)) {
-         ss_delay = soft_ss_delay(n->instr);
+         ss_delay = soft_ss_delay(ctx->v->compiler, n->instr);
       }
 
       delay = MAX3(delay, sy_delay, ss_delay);
@@ -333,7 +333,7 @@ schedule(struct ir3_sched_ctx *ctx, struct ir3_instruction *instr)
    unsigned cycles = cycle_count(instr);
 
    if (is_ss_producer(instr)) {
-      ctx->ss_delay = soft_ss_delay(instr);
+      ctx->ss_delay = soft_ss_delay(ctx->compiler, instr);
       n->ss_index = ctx->ss_index++;
    } else if (!is_meta(instr) &&
               sched_check_src_cond(instr, is_outstanding_ss, ctx)) {
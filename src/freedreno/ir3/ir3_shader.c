@@ -582,6 +582,29 @@ needs_binning_variant(struct ir3_shader_variant *v)
    return false;
 }
 
+static bool
+compile_binning_variant(struct ir3_shader *shader,
+                        struct ir3_shader_variant *v)
+{
+   /* The binning variant can only be looked up once the draw pass variant is
+    * compiled, since it inherits its const state and inputs.  Skip the
+    * cache when disassembly was requested, cached entries don't have it.
+    */
+   bool use_cache = shader->binning_cache && !v->disasm_info.write_disasm;
+   cache_key key;
+
+   if (use_cache && ir3_binning_cache_retrieve(shader, v, key))
+      return true;
+
+   if (!compile_variant(shader, v->binning))
+      return false;
+
+   if (use_cache)
+      ir3_binning_cache_store(shader, v, key);
+
+   return true;
+}
+
 static struct ir3_shader_variant *
 create_variant(struct ir3_shader *shader, const struct ir3_shader_key *key,
                bool write_disasm, void *mem_ctx)
@@ -634,7 +657,7 @@ create_variant(struct ir3_shader *shader, const struct ir3_shader_key *key,
    if (!compile_variant(shader, v))
       goto fail;
 
-   if (needs_binning_variant(v) && !compile_variant(shader, v->binning))
+   if (needs_binning_variant(v) && !compile_binning_variant(shader, v))
       goto fail;
 
    ir3_disk_cache_store(shader, v);
@@ -696,6 +719,27 @@ ir3_shader_get_variant(struct ir3_shader *shader,
    return v;
 }
 
+/* Like ir3_shader_get_variant(), but only returns variants that were already
+ * compiled. Lets callers that compile variants on other threads check first
+ * whether there is anything to do.
+ */
+struct ir3_shader_variant *
+ir3_shader_lookup_variant(struct ir3_shader *shader,
+                          const struct ir3_shader_key *key, bool binning_pass)
+{
+   mtx_lock(&shader->variants_lock);
+   struct ir3_shader_variant *v = shader_variant(shader, key);
+
+   if (v && binning_pass) {
+      v = v->binning;
+      assert(v);
+   }
+
+   mtx_unlock(&shader->variants_lock);
+
+   return v;
+}
+
 struct ir3_shader *
 ir3_shader_passthrough_tcs(struct ir3_shader *vs, unsigned patch_vertices)
 {
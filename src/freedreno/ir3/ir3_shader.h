@@ -622,6 +622,20 @@ struct ir3_shader_options {
    bool fragdata_dynamic_remap;
 };
 
+/*
+ * Optional driver-provided cache for binning pass variants.  Entries are
+ * keyed on the position-relevant part of the shader plus everything the
+ * binning variant inherits from its draw pass variant, so shaders that only
+ * differ in their varyings can share a single binning variant.
+ */
+struct ir3_binning_cache {
+   void *data;
+   /* Returns a malloc'ed copy of the entry for key, or NULL on a miss. */
+   void *(*lookup)(void *data, const cache_key key, size_t *size);
+   void (*insert)(void *data, const cache_key key, const void *entry,
+                  size_t size);
+};
+
 struct ir3_shader_output {
    uint8_t slot;
    uint8_t regid;
@@ -1043,6 +1057,9 @@ struct ir3_shader {
 
    cache_key cache_key; /* shader disk-cache key */
 
+   /* Shared binning variant cache, see ir3_binning_cache.  Optional. */
+   const struct ir3_binning_cache *binning_cache;
+
    /* Bitmask of bits of the shader key used by this shader.  Used to avoid
     * recompiles for GL NOS that doesn't actually apply to the shader.
     */
@@ -1183,6 +1200,9 @@ struct ir3_shader_variant *
 ir3_shader_get_variant(struct ir3_shader *shader,
                        const struct ir3_shader_key *key, bool binning_pass,
                        bool keep_ir, bool *created);
+struct ir3_shader_variant *
+ir3_shader_lookup_variant(struct ir3_shader *shader,
+                          const struct ir3_shader_key *key, bool binning_pass);
 
 struct ir3_shader *
 ir3_shader_from_nir(struct ir3_compiler *compiler, nir_shader *nir,
@@ -11,6 +11,7 @@
 #include "tu_image.h"
 #include "tu_pass.h"
 
+#include "util/disk_cache.h"
 #define XXH_INLINE_ALL
 #include "util/xxhash.h"
 
@@ -75,6 +76,17 @@ struct tu_renderpass_history {
    uint32_t num_results;
 
    uint32_t avg_samples;
+
+   /* Whether avg_samples was written to the disk cache */
+   bool persisted;
+};
+
+/**
+ * Results of a renderpass from a previous run, read from the disk cache.
+ */
+struct tu_autotune_persisted_history {
+   bool found;
+   uint32_t avg_samples;
 };
 
 /* Holds per-submission cs which writes the fence. */
@@ -202,6 +214,79 @@ free_history(struct tu_device *dev, struct tu_renderpass_history *history)
    free(history);
 }
 
+static struct disk_cache *
+get_disk_cache(struct tu_autotune *at)
+{
+   return at->device->physical_device->vk.disk_cache;
+}
+
+static void
+compute_persisted_key(struct disk_cache *cache, uint64_t rp_key,
+                      cache_key cache_key)
+{
+   static const char prefix[] = "tu_autotune";
+   uint8_t data[sizeof(prefix) + sizeof(rp_key)];
+
+   memcpy(data, prefix, sizeof(prefix));
+   memcpy(data + sizeof(prefix), &rp_key, sizeof(rp_key));
+   disk_cache_compute_key(cache, data, sizeof(data), cache_key);
+}
+
+static void
+persist_history(struct tu_autotune *at, struct tu_renderpass_history *history)
+{
+   struct disk_cache *cache = get_disk_cache(at);
+   if (!cache)
+      return;
+
+   cache_key cache_key;
+   compute_persisted_key(cache, history->key, cache_key);
+   disk_cache_put(cache, cache_key, &history->avg_samples,
+                  sizeof(history->avg_samples), NULL);
+   history->persisted = true;
+
+   if (TU_AUTOTUNE_DEBUG_LOG)
+      mesa_logi("Persisted history entry %016" PRIx64 " avg_samples=%u",
+                history->key, history->avg_samples);
+}
+
+static bool
+get_persisted_history(struct tu_autotune *at, uint64_t rp_key,
+                      uint32_t *avg_samples)
+{
+   struct disk_cache *cache = get_disk_cache(at);
+   if (!cache)
+      return false;
+
+   simple_mtx_lock(&at->persisted_lock);
+   struct tu_autotune_persisted_history *persisted =
+      (struct tu_autotune_persisted_history *)
+         _mesa_hash_table_u64_search(at->persisted_ht, rp_key);
+   if (!persisted) {
+      persisted = rzalloc(at->persisted_ht,
+                          struct tu_autotune_persisted_history);
+
+      cache_key cache_key;
+      compute_persisted_key(cache, rp_key, cache_key);
+
+      size_t size;
+      void *data = disk_cache_get(cache, cache_key, &size);
+      if (data && size == sizeof(persisted->avg_samples)) {
+         memcpy(&persisted->avg_samples, data, size);
+         persisted->found = true;
+      }
+      free(data);
+
+      _mesa_hash_table_u64_insert(at->persisted_ht, rp_key, persisted);
+   }
+   simple_mtx_unlock(&at->persisted_lock);
+
+   if (persisted->found)
+      *avg_samples = persisted->avg_samples;
+
+   return persisted->found;
+}
+
 static bool
 get_history(struct tu_autotune *at, uint64_t rp_key, uint32_t *avg_samples)
 {
@@ -223,6 +308,10 @@ get_history(struct tu_autotune *at, uint64_t rp_key, uint32_t *avg_samples)
    }
    u_rwlock_rdunlock(&at->ht_lock);
 
+   /* Fall back to what a previous run learned about this renderpass. */
+   if (!has_history)
+      has_history = get_persisted_history(at, rp_key, avg_samples);
+
    return has_history;
 }
 
@@ -237,9 +326,11 @@ create_history_result(struct tu_autotune *at, uint64_t rp_key)
 }
 
 static void
-history_add_result(struct tu_device *dev, struct tu_renderpass_history *history,
-                      struct tu_renderpass_result *result)
+history_add_result(struct tu_autotune *at, struct tu_renderpass_history *history,
+                   struct tu_renderpass_result *result)
 {
+   struct tu_device *dev = at->device;
+
    list_delinit(&result->node);
    list_add(&result->node, &history->results);
 
@@ -265,13 +356,15 @@ history_add_result(struct tu_device *dev, struct tu_renderpass_history *history,
 
    float avg_samples = (float)total_samples / (float)history->num_results;
    p_atomic_set(&history->avg_samples, (uint32_t)avg_samples);
+
+   /* Only store the average once it is based on a full window of results. */
+   if (!history->persisted && history->num_results == MAX_HISTORY_RESULTS)
+      persist_history(at, history);
 }
 
 static void
 process_results(struct tu_autotune *at, uint32_t current_fence)
 {
-   struct tu_device *dev = at->device;
-
    list_for_each_entry_safe(struct tu_renderpass_result, result,
                             &at->pending_results, node) {
       if (fence_before(current_fence, result->fence))
@@ -281,7 +374,7 @@ process_results(struct tu_autotune *at, uint32_t current_fence)
       result->samples_passed =
          result->samples->samples_end - result->samples->samples_start;
 
-      history_add_result(dev, history, result);
+      history_add_result(at, history, result);
    }
 
    list_for_each_entry_safe(struct tu_submission_data, submission_data,
@@ -421,6 +514,9 @@ tu_autotune_init(struct tu_autotune *at, struct tu_device *dev)
                                     renderpass_key_equals);
    u_rwlock_init(&at->ht_lock);
 
+   at->persisted_ht = _mesa_hash_table_u64_create(NULL);
+   simple_mtx_init(&at->persisted_lock, mtx_plain);
+
    list_inithead(&at->pending_results);
    list_inithead(&at->pending_submission_data);
    list_inithead(&at->submission_data_pool);
@@ -471,6 +567,9 @@ tu_autotune_fini(struct tu_autotune *at, struct tu_device *dev)
 
    _mesa_hash_table_destroy(at->ht, NULL);
    u_rwlock_destroy(&at->ht_lock);
+
+   _mesa_hash_table_u64_destroy(at->persisted_ht);
+   simple_mtx_destroy(&at->persisted_lock);
 }
 
 bool
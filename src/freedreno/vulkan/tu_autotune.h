@@ -10,6 +10,7 @@
 
 #include "util/hash_table.h"
 #include "util/rwlock.h"
+#include "util/simple_mtx.h"
 
 #include "tu_suballoc.h"
 
@@ -41,6 +42,10 @@ struct tu_renderpass_history;
  * the amount of overdraw to detect cases where the number of pixels touched is
  * low.
  *
+ * The averaged samples-passed of a renderpass is also written to the disk
+ * cache, so that the next run of the application can make an informed choice
+ * from the first frame instead of falling back to the draw count heuristic.
+ *
  * [1] ignoring early-tile-exit optimizations, but any draw that touches all/
  *     most of the tiles late in the tile-pass can defeat that
  */
@@ -60,6 +65,14 @@ struct tu_autotune {
    struct hash_table *ht;
    struct u_rwlock ht_lock;
 
+   /**
+    * Renderpass key to tu_autotune_persisted_history, for renderpasses
+    * without live history. Filled lazily from the disk cache, including
+    * negative lookups.
+    */
+   struct hash_table_u64 *persisted_ht;
+   simple_mtx_t persisted_lock;
+
    /**
     * List of per-renderpass results that we are waiting for the GPU
     * to finish with before reading back the results.
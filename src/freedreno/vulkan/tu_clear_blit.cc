@@ -2610,12 +2610,11 @@ tu_copy_memory_to_image(struct tu_device *device,
                    extent.width * layout->cpp);
          }
       } else {
-         fdl6_memcpy_linear_to_tiled(offset.x, offset.y,
-                                     extent.width, extent.height,
-                                     dst, src, layout,
-                                     info->imageSubresource.mipLevel,
-                                     src_pitch,
-                                     &device->physical_device->ubwc_config);
+         fdl6_memcpy_linear_to_tiled_threaded(
+            offset.x, offset.y, extent.width, extent.height, dst, src, layout,
+            info->imageSubresource.mipLevel, src_pitch,
+            &device->physical_device->ubwc_config,
+            device->physical_device->host_copy_threads);
       }
 
       if (dst_image->mem->bo->cached_non_coherent) {
@@ -2820,12 +2819,11 @@ tu_copy_image_to_memory(struct tu_device *device,
                    extent.width * layout->cpp);
          }
       } else {
-         fdl6_memcpy_tiled_to_linear(offset.x, offset.y,
-                                     extent.width, extent.height,
-                                     dst, src, layout,
-                                     info->imageSubresource.mipLevel,
-                                     dst_pitch,
-                                     &device->physical_device->ubwc_config);
+         fdl6_memcpy_tiled_to_linear_threaded(
+            offset.x, offset.y, extent.width, extent.height, dst, src, layout,
+            info->imageSubresource.mipLevel, dst_pitch,
+            &device->physical_device->ubwc_config,
+            device->physical_device->host_copy_threads);
       }
    }
 }
@@ -2859,7 +2859,11 @@ tu_trace_end_render_pass(struct tu_cmd_buffer *cmd, bool gmem)
       cmd->state.lrz.valid,
       cmd->state.rp.lrz_disable_reason ? cmd->state.rp.lrz_disable_reason
                                        : "",
-      lrz_disabled_at_draw, lrz_write_disabled_at_draw, addr);
+      lrz_disabled_at_draw,
+      cmd->state.rp.lrz_write_disable_reason
+         ? cmd->state.rp.lrz_write_disable_reason
+         : "",
+      lrz_write_disabled_at_draw, cmd->state.rp.lrz_skipped_draw_count, addr);
 }
 
 static void
@@ -6095,9 +6099,11 @@ tu_render_pass_state_merge(struct tu_render_pass_state *dst,
    }
    if (!dst->lrz_write_disabled_at_draw &&
        src->lrz_write_disabled_at_draw) {
+      dst->lrz_write_disable_reason = src->lrz_write_disable_reason;
       dst->lrz_write_disabled_at_draw =
          dst->drawcall_count + src->lrz_write_disabled_at_draw;
    }
+   dst->lrz_skipped_draw_count += src->lrz_skipped_draw_count;
    if (!dst->gmem_disable_reason && src->gmem_disable_reason) {
       dst->gmem_disable_reason = src->gmem_disable_reason;
    }
@@ -8064,6 +8070,10 @@ tu6_draw_common(struct tu_cmd_buffer *cmd,
    /* Fill draw stats for autotuner */
    rp->drawcall_count++;
 
+   if (cmd->state.lrz.image_view && !cmd->state.lrz.enabled &&
+       cmd->vk.dynamic_graphics_state.ds.depth.test_enable)
+      rp->lrz_skipped_draw_count++;
+
    rp->drawcall_bandwidth_per_sample_sum +=
       cmd->state.bandwidth.color_bandwidth_per_sample;
 
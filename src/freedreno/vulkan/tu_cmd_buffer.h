@@ -344,7 +344,10 @@ struct tu_render_pass_state
 
    const char *lrz_disable_reason;
    uint32_t lrz_disabled_at_draw;
+   const char *lrz_write_disable_reason;
    uint32_t lrz_write_disabled_at_draw;
+   /* Draws with depth test and an LRZ buffer which didn't use LRZ */
+   uint32_t lrz_skipped_draw_count;
 
    const char *gmem_disable_reason;
    const char *cb_disable_reason;
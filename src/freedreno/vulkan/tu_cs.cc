@@ -74,22 +74,122 @@ tu_cs_init_suballoc(struct tu_cs *cs, struct tu_device *device,
    cs->refcount_bo = tu_bo_get_ref(suballoc_bo->bo);
 }
 
+void
+tu_cs_bo_pool_init(struct tu_cs_bo_pool *pool)
+{
+   memset(pool, 0, sizeof(*pool));
+   mtx_init(&pool->mutex, mtx_plain);
+   for (unsigned w = 0; w < 2; w++) {
+      for (unsigned i = 0; i < TU_CS_BO_POOL_ORDERS; i++)
+         util_dynarray_init(&pool->free[w][i], NULL);
+   }
+}
+
+void
+tu_cs_bo_pool_finish(struct tu_device *device, struct tu_cs_bo_pool *pool)
+{
+   for (unsigned w = 0; w < 2; w++) {
+      for (unsigned i = 0; i < TU_CS_BO_POOL_ORDERS; i++) {
+         util_dynarray_foreach (&pool->free[w][i], struct tu_bo *, bo)
+            tu_bo_finish(device, *bo);
+         util_dynarray_fini(&pool->free[w][i]);
+      }
+   }
+   mtx_destroy(&pool->mutex);
+}
+
 /**
- * Finish and release all resources owned by a command stream.
+ * Print and reset the pool statistics.  This is called on every submit, so
+ * the numbers cover the command streams recorded since the previous one.
  */
 void
-tu_cs_finish(struct tu_cs *cs)
+tu_cs_bo_pool_print_stats(struct tu_cs_bo_pool *pool)
 {
-   for (uint32_t i = 0; i < cs->read_only.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_only.bos[i]);
-      tu_bo_finish(cs->device, cs->read_only.bos[i]);
+   mtx_lock(&pool->mutex);
+
+   mesa_logi("cs bo pool: %u recycled (%lld kb), %u allocated (%lld kb), "
+             "%lld kb pooled\n",
+             pool->hits, (long long) (pool->recycled_size / 1024),
+             pool->misses, (long long) (pool->allocated_size / 1024),
+             (long long) (pool->size / 1024));
+
+   pool->hits = pool->misses = 0;
+   pool->recycled_size = pool->allocated_size = 0;
+
+   mtx_unlock(&pool->mutex);
+}
+
+static struct tu_bo *
+tu_cs_bo_pool_get(struct tu_cs_bo_pool *pool, bool writeable, uint32_t order)
+{
+   struct util_dynarray *free_list =
+      &pool->free[writeable][order - TU_CS_BO_POOL_MIN_ORDER];
+   struct tu_bo *bo = NULL;
+
+   mtx_lock(&pool->mutex);
+   if (util_dynarray_num_elements(free_list, struct tu_bo *)) {
+      bo = util_dynarray_pop(free_list, struct tu_bo *);
+      pool->size -= bo->size;
+      pool->hits++;
+      pool->recycled_size += bo->size;
+   } else {
+      pool->misses++;
+      pool->allocated_size += 1ull << order;
    }
+   mtx_unlock(&pool->mutex);
+
+   return bo;
+}
+
+/*
+ * Release a BO owned by a command stream, handing it back to the device pool
+ * when it has one of the pooled sizes and nothing else holds a reference.
+ */
+static void
+tu_cs_release_bo(struct tu_device *device, struct tu_bo *bo, bool writeable)
+{
+   struct tu_cs_bo_pool *pool = &device->cs_bo_pool;
+
+   TU_RMV(resource_destroy, device, bo);
+
+   if (util_is_power_of_two_nonzero64(bo->size) &&
+       bo->size >= (1ull << TU_CS_BO_POOL_MIN_ORDER) &&
+       bo->size <= (1ull << TU_CS_BO_POOL_MAX_ORDER) &&
+       p_atomic_read(&bo->refcnt) == 1) {
+      struct util_dynarray *free_list =
+         &pool->free[writeable][util_logbase2_64(bo->size) -
+                                TU_CS_BO_POOL_MIN_ORDER];
+      struct tu_bo **slot = NULL;
+
+      mtx_lock(&pool->mutex);
+      if (pool->size + bo->size <= TU_CS_BO_POOL_MAX_SIZE)
+         slot = (struct tu_bo **)
+            util_dynarray_grow(free_list, struct tu_bo *, 1);
+      if (slot) {
+         *slot = bo;
+         pool->size += bo->size;
+      }
+      mtx_unlock(&pool->mutex);
 
-   for (uint32_t i = 0; i < cs->read_write.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_write.bos[i]);
-      tu_bo_finish(cs->device, cs->read_write.bos[i]);
+      if (slot)
+         return;
    }
 
+   tu_bo_finish(device, bo);
+}
+
+/**
+ * Finish and release all resources owned by a command stream.
+ */
+void
+tu_cs_finish(struct tu_cs *cs)
+{
+   for (uint32_t i = 0; i < cs->read_only.bo_count; ++i)
+      tu_cs_release_bo(cs->device, cs->read_only.bos[i], false);
+
+   for (uint32_t i = 0; i < cs->read_write.bo_count; ++i)
+      tu_cs_release_bo(cs->device, cs->read_write.bos[i], true);
+
    if (cs->refcount_bo)
       tu_bo_finish(cs->device, cs->refcount_bo);
 
@@ -162,22 +262,35 @@ tu_cs_add_bo(struct tu_cs *cs, uint32_t size)
       bos->bos = new_bos;
    }
 
-   struct tu_bo *new_bo;
-
-   VkResult result =
-      tu_bo_init_new(cs->device, NULL, &new_bo, size * sizeof(uint32_t),
-                     (enum tu_bo_alloc_flags)(COND(!cs->writeable,
-                                                   TU_BO_ALLOC_GPU_READ_ONLY) |
-                                              TU_BO_ALLOC_ALLOW_DUMP),
-                     cs->name);
-   if (result != VK_SUCCESS) {
-      return result;
+   /* Round pooled sizes up to their size class so that the BO can be
+    * recycled by any CS asking for the same class later on.
+    */
+   struct tu_bo *new_bo = NULL;
+   uint64_t bo_size = size * sizeof(uint32_t);
+   uint32_t order = MAX2(util_logbase2_ceil64(bo_size),
+                         TU_CS_BO_POOL_MIN_ORDER);
+   if (order <= TU_CS_BO_POOL_MAX_ORDER) {
+      bo_size = 1ull << order;
+      new_bo = tu_cs_bo_pool_get(&cs->device->cs_bo_pool, cs->writeable,
+                                 order);
    }
 
-   result = tu_bo_map(cs->device, new_bo, NULL);
-   if (result != VK_SUCCESS) {
-      tu_bo_finish(cs->device, new_bo);
-      return result;
+   if (!new_bo) {
+      VkResult result =
+         tu_bo_init_new(cs->device, NULL, &new_bo, bo_size,
+                        (enum tu_bo_alloc_flags)(COND(!cs->writeable,
+                                                      TU_BO_ALLOC_GPU_READ_ONLY) |
+                                                 TU_BO_ALLOC_ALLOW_DUMP),
+                        cs->name);
+      if (result != VK_SUCCESS) {
+         return result;
+      }
+
+      result = tu_bo_map(cs->device, new_bo, NULL);
+      if (result != VK_SUCCESS) {
+         tu_bo_finish(cs->device, new_bo);
+         return result;
+      }
    }
 
    TU_RMV(cmd_buffer_bo_create, cs->device, new_bo);
@@ -185,7 +298,7 @@ tu_cs_add_bo(struct tu_cs *cs, uint32_t size)
    bos->bos[bos->bo_count++] = new_bo;
 
    cs->start = cs->cur = cs->reserved_end = (uint32_t *) new_bo->map;
-   cs->end = cs->start + size;
+   cs->end = cs->start + tu_sanitize_ib_size(new_bo->size / sizeof(uint32_t));
 
    return VK_SUCCESS;
 }
@@ -509,15 +622,11 @@ tu_cs_reset(struct tu_cs *cs)
       return;
    }
 
-   for (uint32_t i = 0; i + 1 < cs->read_only.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_only.bos[i]);
-      tu_bo_finish(cs->device, cs->read_only.bos[i]);
-   }
+   for (uint32_t i = 0; i + 1 < cs->read_only.bo_count; ++i)
+      tu_cs_release_bo(cs->device, cs->read_only.bos[i], false);
 
-   for (uint32_t i = 0; i + 1 < cs->read_write.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_write.bos[i]);
-      tu_bo_finish(cs->device, cs->read_write.bos[i]);
-   }
+   for (uint32_t i = 0; i + 1 < cs->read_write.bo_count; ++i)
+      tu_cs_release_bo(cs->device, cs->read_write.bos[i], true);
 
    assert(!cs->writeable);
 
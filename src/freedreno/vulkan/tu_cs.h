@@ -120,6 +120,46 @@ struct tu_cs
    tu_crb crb(uint32_t nregs);
 };
 
+/* Command stream BOs are allocated in power-of-two size classes from
+ * 4 KiB up to the maximum IB size, anything bigger bypasses the pool.
+ */
+#define TU_CS_BO_POOL_MIN_ORDER 12
+#define TU_CS_BO_POOL_MAX_ORDER 22
+#define TU_CS_BO_POOL_ORDERS \
+   (TU_CS_BO_POOL_MAX_ORDER - TU_CS_BO_POOL_MIN_ORDER + 1)
+
+/* Upper bound of memory kept alive by the pool. */
+#define TU_CS_BO_POOL_MAX_SIZE (64ull * 1024 * 1024)
+
+/* Device-global cache of command stream BOs released by tu_cs_finish and
+ * tu_cs_reset.  Command buffers can only be reset or freed once they are no
+ * longer pending, so any BO that a CS hands back here is idle and can be
+ * recycled by the next CS without waiting on a fence.
+ */
+struct tu_cs_bo_pool
+{
+   mtx_t mutex;
+
+   /* struct tu_bo * free lists, indexed by [writeable][order] */
+   struct util_dynarray free[2][TU_CS_BO_POOL_ORDERS];
+   uint64_t size;
+
+   /* Statistics, reported with TU_DEBUG=bos */
+   uint32_t hits;
+   uint32_t misses;
+   uint64_t recycled_size;
+   uint64_t allocated_size;
+};
+
+void
+tu_cs_bo_pool_init(struct tu_cs_bo_pool *pool);
+
+void
+tu_cs_bo_pool_finish(struct tu_device *device, struct tu_cs_bo_pool *pool);
+
+void
+tu_cs_bo_pool_print_stats(struct tu_cs_bo_pool *pool);
+
 void
 tu_breadcrumbs_init(struct tu_device *device);
 
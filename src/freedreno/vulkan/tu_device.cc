@@ -16,6 +16,7 @@
 
 #include "git_sha1.h"
 #include "util/cache_ops.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_debug.h"
 #include "util/disk_cache.h"
 #include "util/hex.h"
@@ -1656,6 +1657,10 @@ tu_physical_device_init(struct tu_physical_device *device,
          (enum fdl_macrotile_mode) info.macrotile_mode;
    }
 
+   device->host_copy_threads =
+      debug_get_num_option("TU_HOST_COPY_THREADS",
+                           MIN2(util_get_cpu_caps()->nr_cpus, 4));
+
    fd_get_driver_uuid(device->driver_uuid);
    fd_get_device_uuid(device->device_uuid, &device->dev_id);
 
@@ -2724,6 +2729,7 @@ tu_CreateDevice(VkPhysicalDevice physicalDevice,
    mtx_init(&device->bo_mutex, mtx_plain);
    mtx_init(&device->pipeline_mutex, mtx_plain);
    mtx_init(&device->autotune_mutex, mtx_plain);
+   tu_cs_bo_pool_init(&device->cs_bo_pool);
    mtx_init(&device->kgsl_profiling_mutex, mtx_plain);
    mtx_init(&device->event_mutex, mtx_plain);
    mtx_init(&device->trace_mutex, mtx_plain);
@@ -3097,6 +3103,7 @@ fail_queues:
          vk_free(&device->vk.alloc, device->queues[i]);
    }
 
+   tu_cs_bo_pool_finish(device, &device->cs_bo_pool);
    tu_device_destroy_mutexes(device);
    tu_drm_device_finish(device);
    vk_device_finish(&device->vk);
@@ -3202,6 +3209,8 @@ tu_DestroyDevice(VkDevice _device, const VkAllocationCallbacks *pAllocator)
          vk_free(&device->vk.alloc, device->queues[i]);
    }
 
+   tu_cs_bo_pool_finish(device, &device->cs_bo_pool);
+
    tu_drm_device_finish(device);
 
    if (device->physical_device->has_set_iova)
@@ -4297,6 +4306,7 @@ tu_debug_bos_print_stats(struct tu_device *dev)
    }
 
    mesa_logi("submitted %d bos (%d MB)\n", count, DIV_ROUND_UP(size, 1024));
+   tu_cs_bo_pool_print_stats(&dev->cs_bo_pool);
 
    util_dynarray_fini(&dyn);
 
@@ -138,6 +138,9 @@ struct tu_physical_device
 
    struct fdl_ubwc_config ubwc_config;
 
+   /* Maximum number of threads used to (un)tile a host image copy. */
+   unsigned host_copy_threads;
+
    bool has_preemption;
 
    struct {
@@ -356,6 +359,9 @@ struct tu_device
    struct tu_suballocator autotune_suballoc;
    mtx_t autotune_mutex;
 
+   /* Recycled command stream BOs shared by all command buffers. */
+   struct tu_cs_bo_pool cs_bo_pool;
+
    /* KGSL requires a small chunk of GPU mem to retrieve raw GPU time on
     * each submission.
     */
@@ -98,6 +98,7 @@ tu_lrz_disable_write_for_rp(struct tu_cmd_buffer *cmd, const char *reason)
       return;
 
    cmd->state.lrz.disable_write_for_rp = true;
+   cmd->state.rp.lrz_write_disable_reason = reason;
    cmd->state.rp.lrz_write_disabled_at_draw = cmd->state.rp.drawcall_count;
    perf_debug(
       cmd->device,
@@ -347,7 +348,9 @@ tu_lrz_begin_renderpass(struct tu_cmd_buffer *cmd)
 
    cmd->state.rp.lrz_disable_reason = NULL;
    cmd->state.rp.lrz_disabled_at_draw = 0;
+   cmd->state.rp.lrz_write_disable_reason = NULL;
    cmd->state.rp.lrz_write_disabled_at_draw = 0;
+   cmd->state.rp.lrz_skipped_draw_count = 0;
 
    int lrz_img_count = 0;
    for (unsigned i = 0; i < pass->attachment_count; i++) {
@@ -1989,6 +1989,7 @@ tu_pipeline_builder_compile_shaders(struct tu_pipeline_builder *builder,
       }
 
       result = tu_compile_shaders(builder->device,
+                                  builder->cache,
                                   builder->create_flags,
                                   stage_infos,
                                   nir,
@@ -4885,7 +4886,7 @@ tu_compute_pipeline_create(VkDevice device,
       nir_initial_disasm = executable_info ?
          nir_shader_as_str(nir, pipeline->base.executables_mem_ctx) : NULL;
 
-      result = tu_shader_create(dev, &shader, nir, &key, &ir3_key,
+      result = tu_shader_create(dev, cache, &shader, nir, &key, &ir3_key,
                                 pipeline_sha1, sizeof(pipeline_sha1), layout,
                                 executable_info);
       if (!shader) {
@@ -2790,8 +2790,48 @@ tu_shader_deserialize(struct vk_pipeline_cache *cache,
    return &shader->base;
 }
 
+/* Binning pass variants are shared between vertex shaders that compute
+ * the same positions, e.g. the same VS linked against different fragment
+ * shaders, and stored in the pipeline cache as raw data.
+ */
+static void *
+tu_binning_cache_lookup(void *data, const cache_key key, size_t *size)
+{
+   struct vk_pipeline_cache *cache = (struct vk_pipeline_cache *) data;
+   struct vk_pipeline_cache_object *object =
+      vk_pipeline_cache_lookup_object(cache, key, sizeof(cache_key),
+                                      &vk_raw_data_cache_object_ops, NULL);
+   if (!object)
+      return NULL;
+
+   struct vk_raw_data_cache_object *raw_object =
+      container_of(object, struct vk_raw_data_cache_object, base);
+   void *entry = malloc(raw_object->data_size);
+   if (entry) {
+      memcpy(entry, raw_object->data, raw_object->data_size);
+      *size = raw_object->data_size;
+   }
+
+   vk_pipeline_cache_object_unref(cache->base.device, object);
+   return entry;
+}
+
+static void
+tu_binning_cache_insert(void *data, const cache_key key, const void *entry,
+                        size_t size)
+{
+   struct vk_pipeline_cache *cache = (struct vk_pipeline_cache *) data;
+   struct vk_pipeline_cache_object *object =
+      vk_pipeline_cache_create_and_insert_object(cache, key, sizeof(cache_key),
+                                                 entry, size,
+                                                 &vk_raw_data_cache_object_ops);
+   if (object)
+      vk_pipeline_cache_object_unref(cache->base.device, object);
+}
+
 VkResult
 tu_shader_create(struct tu_device *dev,
+                 struct vk_pipeline_cache *cache,
                  struct tu_shader **shader_out,
                  nir_shader *nir,
                  const struct tu_shader_key *key,
@@ -2987,6 +3027,14 @@ tu_shader_create(struct tu_device *dev,
    struct ir3_shader *ir3_shader =
       ir3_shader_from_nir(dev->compiler, nir, &options, &so_info);
 
+   const struct ir3_binning_cache binning_cache = {
+      .data = cache,
+      .lookup = tu_binning_cache_lookup,
+      .insert = tu_binning_cache_insert,
+   };
+   if (cache)
+      ir3_shader->binning_cache = &binning_cache;
+
    shader->variant =
       ir3_shader_create_variant(ir3_shader, ir3_key, executable_info);
 
@@ -3201,6 +3249,7 @@ tu6_get_tessmode(const struct nir_shader *shader)
 
 VkResult
 tu_compile_shaders(struct tu_device *device,
+                   struct vk_pipeline_cache *cache,
                    VkPipelineCreateFlags2KHR pipeline_flags,
                    const VkPipelineShaderStageCreateInfo **stage_infos,
                    nir_shader **nir,
@@ -3324,7 +3373,7 @@ tu_compile_shaders(struct tu_device *device,
       memcpy(shader_sha1, pipeline_sha1, SHA1_DIGEST_LENGTH);
       shader_sha1[SHA1_DIGEST_LENGTH] = (unsigned char) stage;
 
-      result = tu_shader_create(device,
+      result = tu_shader_create(device, cache,
                                 &shaders[stage], nir[stage], &keys[stage],
                                 &ir3_key, shader_sha1, sizeof(shader_sha1),
                                 layout, !!nir_initial_disasm);
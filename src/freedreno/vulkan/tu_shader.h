@@ -188,6 +188,7 @@ tu6_emit_fs(struct tu_cs *cs, const struct ir3_shader_variant *fs);
 
 VkResult
 tu_shader_create(struct tu_device *dev,
+                 struct vk_pipeline_cache *cache,
                  struct tu_shader **shader_out,
                  nir_shader *nir,
                  const struct tu_shader_key *key,
@@ -210,6 +211,7 @@ tu_shader_key_robustness(struct tu_shader_key *key,
 
 VkResult
 tu_compile_shaders(struct tu_device *device,
+                   struct vk_pipeline_cache *cache,
                    VkPipelineCreateFlags2KHR pipeline_flags,
                    const VkPipelineShaderStageCreateInfo **stage_infos,
                    nir_shader **nir,
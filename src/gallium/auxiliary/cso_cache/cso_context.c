@@ -51,6 +51,11 @@
 #include "driver_trace/tr_dump.h"
 #include "util/u_threaded_context.h"
 
+/* Size of the direct-mapped cache of sampler CSOs in front of the hash
+ * table, as a power of two.
+ */
+#define CSO_SAMPLER_CACHE_BITS 6
+
 /**
  * Per-shader sampler information.
  */
@@ -90,6 +95,11 @@ struct cso_context_priv {
     */
    int max_sampler_seen;
 
+   /* Recently used sampler CSOs indexed by cso_sampler_cache_index(), to
+    * skip the hash table lookup. Cleared when sampler CSOs are deleted.
+    */
+   struct cso_sampler *sampler_cache[1 << CSO_SAMPLER_CACHE_BITS];
+
    unsigned nr_so_targets;
    enum mesa_prim so_output_prim;
    struct pipe_stream_output_target *so_targets[PIPE_MAX_SO_BUFFERS];
@@ -153,6 +163,7 @@ delete_cso(struct cso_context_priv *ctx,
       if (ctx->velements == ((struct cso_velements*)state)->data ||
           ctx->velements_saved == ((struct cso_velements*)state)->data)
          return false;
+      ctx->base.velements_generation++;
       break;
    case CSO_SAMPLER:
       /* nothing to do for samplers */
@@ -186,6 +197,8 @@ sanitize_hash(struct cso_hash *hash, enum cso_cache_type type,
       return;
 
    if (type == CSO_SAMPLER) {
+      memset(ctx->sampler_cache, 0, sizeof(ctx->sampler_cache));
+
       samplers_to_restore = MALLOC((MESA_SHADER_MESH_STAGES + 2) * PIPE_MAX_SAMPLERS *
                                    sizeof(*samplers_to_restore));
 
@@ -1315,7 +1328,30 @@ cso_get_vertex_elements_for_bind(struct cso_context *cso,
                                  const struct cso_velems_state *velems)
 {
    struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
-   void *handle = cso_get_vertex_elements(ctx, velems);
+
+   return cso_vertex_elements_handle_for_bind(cso,
+                                              cso_get_vertex_elements(ctx, velems));
+}
+
+/**
+ * Return the vertex elements CSO for velems without binding it. The caller
+ * can keep the handle until cso_context::velements_generation changes.
+ */
+void *
+cso_get_vertex_elements_handle(struct cso_context *cso,
+                               const struct cso_velems_state *velems)
+{
+   return cso_get_vertex_elements((struct cso_context_priv *)cso, velems);
+}
+
+/**
+ * Same as cso_get_vertex_elements_for_bind, but with a handle from
+ * cso_get_vertex_elements_handle.
+ */
+void *
+cso_vertex_elements_handle_for_bind(struct cso_context *cso, void *handle)
+{
+   struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
 
    if (handle && ctx->velements != handle) {
       ctx->velements = handle;
@@ -1443,13 +1479,28 @@ cso_set_vertex_buffers_and_elements(struct cso_context *cso,
 }
 
 
+static inline unsigned
+cso_sampler_cache_index(unsigned hash_key)
+{
+   /* The XOR-folded key has poorly distributed low bits, so mix it first. */
+   return (hash_key * 0x9e3779b1u) >> (32 - CSO_SAMPLER_CACHE_BITS);
+}
+
+
 ALWAYS_INLINE static struct cso_sampler *
 set_sampler(struct cso_context_priv *ctx, mesa_shader_stage shader_stage,
             unsigned idx, const struct pipe_sampler_state *templ,
             size_t key_size)
 {
    unsigned hash_key = cso_construct_key(templ, key_size);
-   struct cso_sampler *cso;
+   struct cso_sampler **cached =
+      &ctx->sampler_cache[cso_sampler_cache_index(hash_key)];
+   struct cso_sampler *cso = *cached;
+
+   if (cso && cso->hash_key == hash_key &&
+       !memcmp(&cso->state, templ, key_size))
+      return cso;
+
    struct cso_hash_iter iter =
       cso_find_state_template(&ctx->cache,
                               hash_key, CSO_SAMPLER,
@@ -1472,6 +1523,7 @@ set_sampler(struct cso_context_priv *ctx, mesa_shader_stage shader_stage,
    } else {
       cso = cso_hash_iter_data(iter);
    }
+   *cached = cso;
    return cso;
 }
 
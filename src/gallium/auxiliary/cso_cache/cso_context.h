@@ -44,6 +44,11 @@ struct cso_context {
 
    /* This is equal to either pipe_context::draw_vbo or u_vbuf_draw_vbo. */
    pipe_draw_func draw_vbo;
+
+   /* Incremented when vertex elements CSOs are deleted, which invalidates
+    * handles returned by cso_get_vertex_elements_handle.
+    */
+   unsigned velements_generation;
 };
 
 #define CSO_NO_USER_VERTEX_BUFFERS (1 << 0)
@@ -92,6 +97,13 @@ void *
 cso_get_vertex_elements_for_bind(struct cso_context *cso,
                                  const struct cso_velems_state *velems);
 
+void *
+cso_get_vertex_elements_handle(struct cso_context *cso,
+                               const struct cso_velems_state *velems);
+
+void *
+cso_vertex_elements_handle_for_bind(struct cso_context *cso, void *handle);
+
 enum pipe_error
 cso_set_vertex_elements(struct cso_context *ctx,
                         const struct cso_velems_state *velems);
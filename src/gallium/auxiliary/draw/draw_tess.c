@@ -358,10 +358,12 @@ int draw_tess_eval_shader_run(struct draw_tess_eval_shader *shader,
 #if DRAW_LLVM_AVAILABLE
    struct pipe_tessellation_factors factors;
    struct pipe_tessellator_data data = { 0 };
-   struct pipe_tessellator *ptess = p_tess_init(shader->prim_mode,
-                                                shader->spacing,
-                                                !shader->vertex_order_cw,
-                                                shader->point_mode);
+   if (!shader->tessellator)
+      shader->tessellator = p_tess_init(shader->prim_mode,
+                                        shader->spacing,
+                                        !shader->vertex_order_cw,
+                                        shader->point_mode);
+   struct pipe_tessellator *ptess = shader->tessellator;
    unsigned first_patch = input_prims->start / shader->draw->pt.vertices_per_patch;
    for (unsigned i = 0; i < input_prims->primitive_count; i++) {
       uint32_t vert_start = output_verts->count;
@@ -421,7 +423,6 @@ int draw_tess_eval_shader_run(struct draw_tess_eval_shader *shader,
          output_prims->primitive_lengths[i] = prim_len;
       }
    }
-   p_tess_destroy(ptess);
 #endif
 
    *elts_out = elts;
@@ -642,6 +643,8 @@ void draw_delete_tess_eval_shader(struct draw_context *draw,
       assert(shader->variants_cached == 0);
       align_free(dtes->tes_input);
    }
+   if (dtes->tessellator)
+      p_tess_destroy(dtes->tessellator);
 #endif
    if (dtes->state.type == PIPE_SHADER_IR_NIR && dtes->state.ir.nir)
       ralloc_free(dtes->state.ir.nir);
@@ -50,6 +50,7 @@
 
 #include "util/compiler.h"
 #include "util/u_thread.h"
+#include "util/u_queue.h"
 #include "util/os_time.h"
 #include "util/simple_mtx.h"
 #include "util/u_debug.h"
@@ -73,6 +74,146 @@ static long nir_count = 0;
 
 static bool trigger_active = true;
 static char *trigger_filename = NULL;
+static bool dump_contents = true;
+
+/*
+ * Binary format, selected with GALLIUM_TRACE_FORMAT=binary.
+ *
+ * Every dump primitive becomes one fixed size record, optionally followed by
+ * a payload padded to 8 bytes for strings and data.  Records are accumulated
+ * in chunks which a separate thread writes to the file, so that tracing
+ * doesn't format text or flush the stream on every call.
+ * src/gallium/tools/trace/tracebin2xml.py converts the result to the XML
+ * format; the op values must be kept in sync with it.
+ */
+#define TRACE_BIN_MAGIC "GTRCBIN1"
+#define TRACE_BIN_CHUNK_SIZE (1024 * 1024)
+#define TRACE_BIN_MAX_QUEUED_CHUNKS 8
+
+enum trace_bin_op {
+   TRACE_BIN_CALL_BEGIN = 1,  /* value: call number, payload: class\0method\0 */
+   TRACE_BIN_CALL_END,        /* value: duration in microseconds */
+   TRACE_BIN_ARG_BEGIN,       /* payload: name */
+   TRACE_BIN_ARG_END,
+   TRACE_BIN_RET_BEGIN,
+   TRACE_BIN_RET_END,
+   TRACE_BIN_BOOL,
+   TRACE_BIN_INT,
+   TRACE_BIN_UINT,
+   TRACE_BIN_FLOAT,           /* value: bits of the double */
+   TRACE_BIN_BYTES,
+   TRACE_BIN_STRING,
+   TRACE_BIN_ENUM,
+   TRACE_BIN_ARRAY_BEGIN,
+   TRACE_BIN_ARRAY_END,
+   TRACE_BIN_ELEM_BEGIN,
+   TRACE_BIN_ELEM_END,
+   TRACE_BIN_STRUCT_BEGIN,    /* payload: name */
+   TRACE_BIN_STRUCT_END,
+   TRACE_BIN_MEMBER_BEGIN,    /* payload: name */
+   TRACE_BIN_MEMBER_END,
+   TRACE_BIN_NULL,
+   TRACE_BIN_PTR,
+   TRACE_BIN_NIR,             /* value: 1 if skipped, payload: printed shader */
+};
+
+struct trace_bin_record {
+   uint8_t op;
+   uint8_t pad[3];
+   uint32_t size;             /* payload size before padding */
+   uint64_t value;
+};
+
+struct trace_bin_chunk {
+   size_t size;
+   uint8_t data[TRACE_BIN_CHUNK_SIZE];
+};
+
+static bool binary = false;
+static struct util_queue bin_queue;
+static struct trace_bin_chunk *bin_chunk = NULL;
+
+static void
+trace_bin_write_chunk(void *job, void *gdata, int thread_index)
+{
+   struct trace_bin_chunk *chunk = job;
+
+   fwrite(chunk->data, chunk->size, 1, stream);
+   fflush(stream);
+   FREE(chunk);
+}
+
+static void
+trace_bin_submit(void)
+{
+   if (!bin_chunk || !bin_chunk->size)
+      return;
+
+   /* Blocks while too many chunks are queued, so nothing is dropped. */
+   util_queue_add_job(&bin_queue, bin_chunk, NULL, trace_bin_write_chunk,
+                      NULL, 0);
+   bin_chunk = NULL;
+}
+
+static void
+trace_bin_append(const void *data, size_t size)
+{
+   const uint8_t *p = data;
+
+   while (size) {
+      if (!bin_chunk) {
+         bin_chunk = MALLOC_STRUCT(trace_bin_chunk);
+         if (!bin_chunk)
+            return;
+         bin_chunk->size = 0;
+      }
+
+      size_t n = MIN2(size, TRACE_BIN_CHUNK_SIZE - bin_chunk->size);
+      memcpy(bin_chunk->data + bin_chunk->size, p, n);
+      bin_chunk->size += n;
+      p += n;
+      size -= n;
+
+      if (bin_chunk->size == TRACE_BIN_CHUNK_SIZE)
+         trace_bin_submit();
+   }
+}
+
+static void
+trace_bin_record2(enum trace_bin_op op, uint64_t value,
+                  const void *payload0, size_t size0,
+                  const void *payload1, size_t size1)
+{
+   static const uint8_t zeros[8];
+   size_t size = size0 + size1;
+
+   if (!stream || !trigger_active)
+      return;
+
+   assert(size <= UINT32_MAX);
+   struct trace_bin_record rec = {
+      .op = op,
+      .size = size,
+      .value = value,
+   };
+   trace_bin_append(&rec, sizeof(rec));
+   trace_bin_append(payload0, size0);
+   trace_bin_append(payload1, size1);
+   trace_bin_append(zeros, align64(size, 8) - size);
+}
+
+static void
+trace_bin_record(enum trace_bin_op op, uint64_t value,
+                 const void *payload, size_t size)
+{
+   trace_bin_record2(op, value, payload, size, NULL, 0);
+}
+
+static void
+trace_bin_record_str(enum trace_bin_op op, const char *str)
+{
+   trace_bin_record(op, 0, str, strlen(str));
+}
 
 void
 trace_dump_trigger_active(bool active)
@@ -210,6 +351,13 @@ trace_dump_tag_end(const char *name)
 void
 trace_dump_trace_flush(void)
 {
+   if (binary) {
+      simple_mtx_lock(&call_mutex);
+      trace_bin_submit();
+      simple_mtx_unlock(&call_mutex);
+      return;
+   }
+
    if (stream) {
       fflush(stream);
    }
@@ -220,7 +368,12 @@ trace_dump_trace_close(void)
 {
    if (stream) {
       trigger_active = true;
-      trace_dump_writes("</trace>\n");
+      if (binary) {
+         trace_bin_submit();
+         util_queue_destroy(&bin_queue);
+      } else {
+         trace_dump_writes("</trace>\n");
+      }
       if (close_stream) {
          fclose(stream);
          close_stream = false;
@@ -235,6 +388,11 @@ trace_dump_trace_close(void)
 static void
 trace_dump_call_time(int64_t time)
 {
+   if (binary) {
+      trace_bin_record(TRACE_BIN_CALL_END, time, NULL, 0);
+      return;
+   }
+
    if (stream) {
       trace_dump_indent(2);
       trace_dump_tag_begin("time");
@@ -255,8 +413,11 @@ trace_dump_trace_begin(void)
       return false;
 
    nir_count = debug_get_num_option("GALLIUM_TRACE_NIR", 32);
+   dump_contents = debug_get_bool_option("GALLIUM_TRACE_CONTENTS", true);
 
    if (!stream) {
+      const char *format = debug_get_option("GALLIUM_TRACE_FORMAT", "xml");
+      binary = strcmp(format, "binary") == 0;
 
       if (strcmp(filename, "stderr") == 0) {
          close_stream = false;
@@ -268,14 +429,28 @@ trace_dump_trace_begin(void)
       }
       else {
          close_stream = true;
-         stream = fopen(filename, "wt");
+         stream = fopen(filename, binary ? "wb" : "wt");
          if (!stream)
             return false;
       }
 
-      trace_dump_writes("<?xml version='1.0' encoding='UTF-8'?>\n");
-      trace_dump_writes("<?xml-stylesheet type='text/xsl' href='trace.xsl'?>\n");
-      trace_dump_writes("<trace version='0.1'>\n");
+      if (binary) {
+         /* This must happen before atexit() below, so that the handler
+          * which destroys queues at exit runs after trace_dump_trace_close.
+          */
+         if (!util_queue_init(&bin_queue, "trace", TRACE_BIN_MAX_QUEUED_CHUNKS,
+                              1, 0, NULL)) {
+            if (close_stream)
+               fclose(stream);
+            stream = NULL;
+            return false;
+         }
+         fwrite(TRACE_BIN_MAGIC, strlen(TRACE_BIN_MAGIC), 1, stream);
+      } else {
+         trace_dump_writes("<?xml version='1.0' encoding='UTF-8'?>\n");
+         trace_dump_writes("<?xml-stylesheet type='text/xsl' href='trace.xsl'?>\n");
+         trace_dump_writes("<trace version='0.1'>\n");
+      }
 
       /* Many applications don't exit cleanly, others may create and destroy a
        * screen multiple times, so we only write </trace> tag and close at exit
@@ -367,6 +542,14 @@ void trace_dump_call_begin_locked(const char *klass, const char *method)
       return;
 
    ++call_no;
+   call_start_time = os_time_get();
+
+   if (binary) {
+      trace_bin_record2(TRACE_BIN_CALL_BEGIN, call_no,
+                        klass, strlen(klass) + 1, method, strlen(method) + 1);
+      return;
+   }
+
    trace_dump_indent(1);
    trace_dump_writes("<call no=\'");
    trace_dump_writef("%lu", call_no);
@@ -376,8 +559,6 @@ void trace_dump_call_begin_locked(const char *klass, const char *method)
    trace_dump_escape(method);
    trace_dump_writes("\'>");
    trace_dump_newline();
-
-   call_start_time = os_time_get();
 }
 
 void trace_dump_call_end_locked(void)
@@ -390,6 +571,9 @@ void trace_dump_call_end_locked(void)
    call_end_time = os_time_get();
 
    trace_dump_call_time(call_end_time - call_start_time);
+   if (binary)
+      return;
+
    trace_dump_indent(1);
    trace_dump_tag_end("call");
    trace_dump_newline();
@@ -413,6 +597,11 @@ void trace_dump_arg_begin(const char *name)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record_str(TRACE_BIN_ARG_BEGIN, name);
+      return;
+   }
+
    trace_dump_indent(2);
    trace_dump_tag_begin1("arg", "name", name);
 }
@@ -422,6 +611,11 @@ void trace_dump_arg_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_ARG_END, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_tag_end("arg");
    trace_dump_newline();
 }
@@ -431,6 +625,11 @@ void trace_dump_ret_begin(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_RET_BEGIN, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_indent(2);
    trace_dump_tag_begin("ret");
 }
@@ -440,6 +639,11 @@ void trace_dump_ret_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_RET_END, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_tag_end("ret");
    trace_dump_newline();
 }
@@ -449,6 +653,11 @@ void trace_dump_bool(bool value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_BOOL, value, NULL, 0);
+      return;
+   }
+
    trace_dump_writef("<bool>%c</bool>", value ? '1' : '0');
 }
 
@@ -457,6 +666,11 @@ void trace_dump_int(int64_t value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_INT, value, NULL, 0);
+      return;
+   }
+
    trace_dump_writef("<int>%" PRIi64 "</int>", value);
 }
 
@@ -465,6 +679,11 @@ void trace_dump_uint(uint64_t value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_UINT, value, NULL, 0);
+      return;
+   }
+
    trace_dump_writef("<uint>%" PRIu64 "</uint>", value);
 }
 
@@ -473,6 +692,13 @@ void trace_dump_float(double value)
    if (!dumping)
       return;
 
+   if (binary) {
+      uint64_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      trace_bin_record(TRACE_BIN_FLOAT, bits, NULL, 0);
+      return;
+   }
+
    trace_dump_writef("<float>%g</float>", value);
 }
 
@@ -486,6 +712,11 @@ void trace_dump_bytes(const void *data,
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_BYTES, 0, data, size);
+      return;
+   }
+
    trace_dump_writes("<bytes>");
    for(i = 0; i < size; ++i) {
       uint8_t byte = *p++;
@@ -515,10 +746,10 @@ void trace_dump_box_bytes(const void *data,
           (uint64_t)stride + (box->depth - 1) * slice_stride;
 
    /*
-    * Only dump buffer transfers to avoid huge files.
-    * TODO: Make this run-time configurable
+    * Only dump buffer transfers to avoid huge files, and none at all with
+    * GALLIUM_TRACE_CONTENTS=false.
     */
-   if (resource->target != PIPE_BUFFER) {
+   if (resource->target != PIPE_BUFFER || !dump_contents) {
       size = 0;
    }
 
@@ -531,6 +762,11 @@ void trace_dump_string(const char *str)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record_str(TRACE_BIN_STRING, str);
+      return;
+   }
+
    trace_dump_writes("<string>");
    trace_dump_escape(str);
    trace_dump_writes("</string>");
@@ -541,6 +777,11 @@ void trace_dump_enum(const char *value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record_str(TRACE_BIN_ENUM, value);
+      return;
+   }
+
    trace_dump_writes("<enum>");
    trace_dump_escape(value);
    trace_dump_writes("</enum>");
@@ -551,6 +792,11 @@ void trace_dump_array_begin(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_ARRAY_BEGIN, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_writes("<array>");
 }
 
@@ -559,6 +805,11 @@ void trace_dump_array_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_ARRAY_END, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_writes("</array>");
 }
 
@@ -567,6 +818,11 @@ void trace_dump_elem_begin(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_ELEM_BEGIN, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_writes("<elem>");
 }
 
@@ -575,6 +831,11 @@ void trace_dump_elem_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_ELEM_END, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_writes("</elem>");
 }
 
@@ -583,6 +844,11 @@ void trace_dump_struct_begin(const char *name)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record_str(TRACE_BIN_STRUCT_BEGIN, name);
+      return;
+   }
+
    trace_dump_writef("<struct name='%s'>", name);
 }
 
@@ -591,6 +857,11 @@ void trace_dump_struct_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_STRUCT_END, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_writes("</struct>");
 }
 
@@ -599,6 +870,11 @@ void trace_dump_member_begin(const char *name)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record_str(TRACE_BIN_MEMBER_BEGIN, name);
+      return;
+   }
+
    trace_dump_writef("<member name='%s'>", name);
 }
 
@@ -607,6 +883,11 @@ void trace_dump_member_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_MEMBER_END, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_writes("</member>");
 }
 
@@ -615,6 +896,11 @@ void trace_dump_null(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_record(TRACE_BIN_NULL, 0, NULL, 0);
+      return;
+   }
+
    trace_dump_writes("<null/>");
 }
 
@@ -623,6 +909,14 @@ void trace_dump_ptr(const void *value)
    if (!dumping)
       return;
 
+   if (binary) {
+      if (value)
+         trace_bin_record(TRACE_BIN_PTR, (uintptr_t)value, NULL, 0);
+      else
+         trace_bin_record(TRACE_BIN_NULL, 0, NULL, 0);
+      return;
+   }
+
    if(value)
       trace_dump_writef("<ptr>0x%08lx</ptr>", (unsigned long)(uintptr_t)value);
    else
@@ -647,6 +941,17 @@ void trace_dump_nir(struct nir_shader *nir)
    if (!dumping)
       return;
 
+   if (binary) {
+      if (--nir_count < 0) {
+         trace_bin_record(TRACE_BIN_NIR, 1, NULL, 0);
+      } else {
+         char *str = nir_shader_as_str(nir, NULL);
+         trace_bin_record_str(TRACE_BIN_NIR, str);
+         ralloc_free(str);
+      }
+      return;
+   }
+
    if (--nir_count < 0) {
       fputs("<string>...</string>", stream);
       return;
@@ -82,6 +82,34 @@
 #define LOG_POLY_DEGREE 4
 
 
+/**
+ * Call a min/max intrinsic.  The AVX-512 ones take an extra rounding control
+ * argument and are only picked for exactly 512 bit vectors.
+ */
+static LLVMValueRef
+lp_build_minmax_intrinsic(struct lp_build_context *bld,
+                          const char *intrinsic,
+                          unsigned intr_size,
+                          LLVMValueRef a,
+                          LLVMValueRef b)
+{
+   if (intr_size == 512) {
+      LLVMValueRef args[3];
+
+      assert(bld->type.width * bld->type.length == 512);
+
+      args[0] = a;
+      args[1] = b;
+      args[2] = lp_build_const_int32(bld->gallivm, 4); /* _MM_FROUND_CUR_DIRECTION */
+      return lp_build_intrinsic(bld->gallivm->builder, intrinsic,
+                                bld->vec_type, args, ARRAY_SIZE(args), 0);
+   }
+
+   return lp_build_intrinsic_binary_anylength(bld->gallivm, intrinsic,
+                                              bld->type, intr_size, a, b);
+}
+
+
 /**
  * Generate min(a, b)
  * No checks for special case values of a or b = 1 or 0 are done.
@@ -114,6 +142,10 @@ lp_build_min_simple(struct lp_build_context *bld,
             intrinsic = "llvm.x86.sse.min.ps";
             intr_size = 128;
          }
+         else if (type.length == 16 && util_get_cpu_caps()->has_avx512f) {
+            intrinsic = "llvm.x86.avx512.min.ps.512";
+            intr_size = 512;
+         }
          else {
             intrinsic = "llvm.x86.avx.min.ps.256";
             intr_size = 256;
@@ -128,6 +160,10 @@ lp_build_min_simple(struct lp_build_context *bld,
             intrinsic = "llvm.x86.sse2.min.pd";
             intr_size = 128;
          }
+         else if (type.length == 8 && util_get_cpu_caps()->has_avx512f) {
+            intrinsic = "llvm.x86.avx512.min.pd.512";
+            intr_size = 512;
+         }
          else {
             intrinsic = "llvm.x86.avx.min.pd.256";
             intr_size = 256;
@@ -176,15 +212,11 @@ lp_build_min_simple(struct lp_build_context *bld,
       if (util_get_cpu_caps()->has_sse && type.floating &&
           nan_behavior == GALLIVM_NAN_RETURN_OTHER) {
          LLVMValueRef isnan, min;
-         min = lp_build_intrinsic_binary_anylength(bld->gallivm, intrinsic,
-                                                   type,
-                                                   intr_size, a, b);
+         min = lp_build_minmax_intrinsic(bld, intrinsic, intr_size, a, b);
          isnan = lp_build_isnan(bld, b);
          return lp_build_select(bld, isnan, a, min);
       } else {
-         return lp_build_intrinsic_binary_anylength(bld->gallivm, intrinsic,
-                                                    type,
-                                                    intr_size, a, b);
+         return lp_build_minmax_intrinsic(bld, intrinsic, intr_size, a, b);
       }
    }
 
@@ -268,6 +300,10 @@ lp_build_max_simple(struct lp_build_context *bld,
             intrinsic = "llvm.x86.sse.max.ps";
             intr_size = 128;
          }
+         else if (type.length == 16 && util_get_cpu_caps()->has_avx512f) {
+            intrinsic = "llvm.x86.avx512.max.ps.512";
+            intr_size = 512;
+         }
          else {
             intrinsic = "llvm.x86.avx.max.ps.256";
             intr_size = 256;
@@ -282,6 +318,10 @@ lp_build_max_simple(struct lp_build_context *bld,
             intrinsic = "llvm.x86.sse2.max.pd";
             intr_size = 128;
          }
+         else if (type.length == 8 && util_get_cpu_caps()->has_avx512f) {
+            intrinsic = "llvm.x86.avx512.max.pd.512";
+            intr_size = 512;
+         }
          else {
             intrinsic = "llvm.x86.avx.max.pd.256";
             intr_size = 256;
@@ -324,15 +364,11 @@ lp_build_max_simple(struct lp_build_context *bld,
       if (util_get_cpu_caps()->has_sse && type.floating &&
           nan_behavior == GALLIVM_NAN_RETURN_OTHER) {
          LLVMValueRef isnan, max;
-         max = lp_build_intrinsic_binary_anylength(bld->gallivm, intrinsic,
-                                                   type,
-                                                   intr_size, a, b);
+         max = lp_build_minmax_intrinsic(bld, intrinsic, intr_size, a, b);
          isnan = lp_build_isnan(bld, b);
          return lp_build_select(bld, isnan, a, max);
       } else {
-         return lp_build_intrinsic_binary_anylength(bld->gallivm, intrinsic,
-                                                    type,
-                                                    intr_size, a, b);
+         return lp_build_minmax_intrinsic(bld, intrinsic, intr_size, a, b);
       }
    }
 
@@ -2632,7 +2668,8 @@ lp_build_fast_rsqrt_available(struct lp_type type)
    assert(type.floating);
 
    if ((util_get_cpu_caps()->has_sse && type.width == 32 && type.length == 4) ||
-       (util_get_cpu_caps()->has_avx && type.width == 32 && type.length == 8)) {
+       (util_get_cpu_caps()->has_avx && type.width == 32 && type.length == 8) ||
+       (util_get_cpu_caps()->has_avx512f && type.width == 32 && type.length == 16)) {
       return true;
    }
    return false;
@@ -2657,6 +2694,17 @@ lp_build_fast_rsqrt(struct lp_build_context *bld,
    if (lp_build_fast_rsqrt_available(type)) {
       const char *intrinsic = NULL;
 
+      if (type.length == 16) {
+         /* rsqrt14 is masked, and more precise than rsqrt */
+         LLVMValueRef args[3];
+         args[0] = a;
+         args[1] = bld->undef;
+         args[2] = LLVMConstInt(LLVMInt16TypeInContext(bld->gallivm->context),
+                                0xffff, 0);
+         return lp_build_intrinsic(builder, "llvm.x86.avx512.rsqrt14.ps.512",
+                                   bld->vec_type, args, ARRAY_SIZE(args), 0);
+      }
+
       if (type.length == 4) {
          intrinsic = "llvm.x86.sse.rsqrt.ps";
       }
@@ -110,7 +110,13 @@ lp_build_half_to_float(struct gallivm_state *gallivm,
    LLVMTypeRef ext_int_vec_type = lp_build_vec_type(gallivm, i32_type);
    LLVMValueRef h;
 
-   if (lp_has_fp16() && (src_length == 4 || src_length == 8)) {
+   /* AVX-512F has a 16 wide vcvtph2ps, which is what the fpext below lowers
+    * to.
+    */
+   if (lp_has_fp16() &&
+       (src_length == 4 || src_length == 8 ||
+        (src_length == 16 && util_get_cpu_caps()->has_avx512f &&
+         LLVM_VERSION_MAJOR >= 11))) {
       if (util_get_cpu_caps()->has_f16c && LLVM_VERSION_MAJOR < 11) {
          const char *intrinsic = NULL;
          if (src_length == 4) {
@@ -200,6 +206,19 @@ lp_build_float_to_half(struct gallivm_state *gallivm,
                                 lp_build_vec_type(gallivm, lp_type_float_vec(16, 16 * length)), "");
    }
 
+   else if (util_get_cpu_caps()->has_avx512f && length == 16) {
+      LLVMTypeRef i16t = LLVMInt16TypeInContext(gallivm->context);
+      LLVMValueRef args[4];
+
+      args[0] = src;
+      args[1] = lp_build_const_int32(gallivm, 3); /* LP_BUILD_ROUND_TRUNCATE */
+      args[2] = LLVMGetUndef(lp_build_vec_type(gallivm, i16_type));
+      args[3] = LLVMConstInt(i16t, 0xffff, 0);
+      result = lp_build_intrinsic(builder, "llvm.x86.avx512.mask.vcvtps2ph.512",
+                                  lp_build_vec_type(gallivm, i16_type),
+                                  args, ARRAY_SIZE(args), 0);
+   }
+
    else {
       result = lp_build_float_to_smallfloat(gallivm, i32_type, src, 10, 5, 0, true);
       /* Convert int32 vector to int16 vector by trunc (might generate bad code) */
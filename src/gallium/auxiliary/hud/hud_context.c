@@ -56,6 +56,7 @@
 
 #include "frontend/api.h"
 #include "cso_cache/cso_context.h"
+#include "util/os_time.h"
 #include "util/u_draw_quad.h"
 #include "util/format/u_format.h"
 #include "util/u_inlines.h"
@@ -497,7 +498,7 @@ hud_draw_results(struct hud_context *hud, struct pipe_resource *tex)
    struct hud_pane *pane;
    struct pipe_resource *releasebuf[3] = { 0 };
 
-   if (!huds_visible)
+   if (!huds_visible || !hud->vertices_valid)
       return;
 
    hud->fb_width = tex->width0;
@@ -688,6 +689,24 @@ hud_stop_queries(struct hud_context *hud, struct pipe_context *pipe)
    struct hud_pane *pane;
    struct hud_graph *gr, *next;
 
+   /* When the HUD is hidden, e.g. because the values are only exported,
+    * only query the values.
+    */
+   hud->vertices_valid = false;
+   if (!huds_visible) {
+      hud_batch_query_update(hud->batch_query, pipe);
+
+      LIST_FOR_EACH_ENTRY(pane, &hud->pane_list, head) {
+         LIST_FOR_EACH_ENTRY(gr, &pane->graph_list, head) {
+            gr->query_new_value(gr, pipe);
+         }
+      }
+
+      if (hud->export_file)
+         fflush(hud->export_file);
+      return;
+   }
+
    /* prepare vertex buffers */
    hud_prepare_vertices(hud, &hud->bg, 16 * 256, 2 * sizeof(float));
    hud_prepare_vertices(hud, &hud->whitelines, 4 * 256, 2 * sizeof(float));
@@ -751,8 +770,12 @@ hud_stop_queries(struct hud_context *hud, struct pipe_context *pipe)
          hud_pane_accumulate_vertices(hud, pane);
    }
 
+   if (hud->export_file)
+      fflush(hud->export_file);
+
    /* unmap the uploader's vertex buffer before drawing */
    u_upload_unmap(pipe->stream_uploader);
+   hud->vertices_valid = true;
 }
 
 /**
@@ -774,7 +797,8 @@ hud_run(struct hud_context *hud, struct cso_context *cso,
       hud_stop_queries(hud, hud->record_pipe);
 
    /* Show info about the record device. */
-   if (hud->record_device_x >= 0 && hud->record_device_y >= 0)
+   if (hud->vertices_valid &&
+       hud->record_device_x >= 0 && hud->record_device_y >= 0)
       hud_draw_string(hud, hud->record_device_x, hud->record_device_y, "Device: %s (%04d:%02x:%02d.%d)",
                hud->record_pipe->screen->get_name(hud->record_pipe->screen),
                hud->record_pipe->screen->caps.pci_group,
@@ -1003,10 +1027,30 @@ hud_pane_add_graph(struct hud_pane *pane, struct hud_graph *gr)
    pane->next_color++;
 }
 
+/**
+ * Write one value as a JSON line to the GALLIUM_HUD_EXPORT stream.
+ * The value isn't clamped to the ceiling of the pane.
+ */
+static void
+hud_export_value(FILE *f, const struct hud_graph *gr, double value)
+{
+   fprintf(f, "{\"time_us\":%" PRId64 ",\"name\":\"", os_time_get());
+   for (const char *c = gr->name; *c; c++) {
+      if (*c == '"' || *c == '\\')
+         fputc('\\', f);
+      fputc(*c, f);
+   }
+   fprintf(f, "\",\"value\":%.17g}\n", isfinite(value) ? value : 0);
+}
+
 void
 hud_graph_add_value(struct hud_graph *gr, double value)
 {
    gr->current_value = value;
+
+   if (gr->pane->hud->export_file)
+      hud_export_value(gr->pane->hud->export_file, gr, value);
+
    value = value > gr->pane->ceiling ? gr->pane->ceiling : value;
 
    if (gr->fd) {
@@ -1110,6 +1154,32 @@ hud_graph_set_dump_file(struct hud_graph *gr, const char *hud_dump_dir,
    gr->separator = separator;
 }
 
+/**
+ * Open the stream for GALLIUM_HUD_EXPORT, which is either a file name or
+ * "fd:<n>" for an already open file descriptor, e.g. a socket set up by
+ * the process that collects the values.
+ */
+static FILE *
+hud_open_export_file(const char *export)
+{
+   FILE *f = NULL;
+   int fd;
+
+   if (sscanf(export, "fd:%d", &fd) == 1) {
+#if DETECT_OS_POSIX
+      f = fdopen(fd, "w");
+#endif
+   } else {
+      f = fopen(export, "a");
+   }
+
+   if (!f) {
+      fprintf(stderr, "gallium_hud: can't open %s for exporting\n", export);
+      fflush(stderr);
+   }
+   return f;
+}
+
 /**
  * Read a string from the environment variable.
  * The separators "+", ",", ":", and ";" terminate the string.
@@ -1648,6 +1718,10 @@ print_help(struct pipe_screen *screen)
    puts("");
    puts("  Example: GALLIUM_HUD=\".w256.h64.x1600.y520.d.c1000fps+cpu,.datom-count\"");
    puts("");
+   puts("  The values can also be written to a file or file descriptor as JSON");
+   puts("  lines with GALLIUM_HUD_EXPORT=<file> or GALLIUM_HUD_EXPORT=fd:<n>.");
+   puts("  Combine it with GALLIUM_HUD_VISIBLE=false to skip drawing.");
+   puts("");
    puts("  Available names:");
    puts("    stdout (prints the counters value to stdout)");
    puts("    csv (prints the counter values to stdout as CSV, use + to separate names)");
@@ -2098,6 +2172,10 @@ hud_create(struct cso_context *cso, struct hud_context *share,
    if (draw_ctx == 0)
       hud_set_draw_context(hud, cso, st, st_invalidate_state);
 
+   const char *export = os_get_option("GALLIUM_HUD_EXPORT");
+   if (export && *export)
+      hud->export_file = hud_open_export_file(export);
+
    hud_parse_env_var(hud, screen, env, default_period_ms);
    return hud;
 }
@@ -2117,6 +2195,8 @@ hud_destroy(struct hud_context *hud, struct cso_context *cso)
 
    if (p_atomic_dec_zero(&hud->refcount)) {
       pipe_resource_reference(&hud->font.texture, NULL);
+      if (hud->export_file)
+         fclose(hud->export_file);
       FREE(hud);
    }
 }
@@ -103,6 +103,12 @@ struct hud_context {
    int record_device_x, record_device_y;
 
    bool has_srgb;
+
+   /* Whether the last hud_stop_queries recorded the vertices to draw. */
+   bool vertices_valid;
+
+   /* GALLIUM_HUD_EXPORT, every value is written as a JSON line. */
+   FILE *export_file;
 };
 
 struct hud_graph {
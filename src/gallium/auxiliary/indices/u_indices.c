@@ -32,11 +32,7 @@ static void translate_byte_to_ushort( const void *in,
                                       UNUSED unsigned restart_index,
                                       void *out )
 {
-   uint8_t *src = (uint8_t *)in + start;
-   uint16_t *dst = out;
-   while (out_nr--) {
-      *dst++ = *src++;
-   }
+   u_index_widen_ubyte_to_ushort((const uint8_t *)in + start, out, out_nr);
 }
 
 enum mesa_prim
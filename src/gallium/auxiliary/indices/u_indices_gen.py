@@ -118,22 +118,28 @@ def do_line(f: 'T.TextIO', intype, outtype, ptr, v0, v1, inpv, outpv ):
     else:
         shape(f, intype, outtype, ptr, v1, v0 )
 
-def do_tri(f: 'T.TextIO', intype, outtype, ptr, v0, v1, v2, inpv, outpv ):
+def tri_verts(v0, v1, v2, inpv, outpv):
     if inpv == outpv:
-        shape(f, intype, outtype, ptr, v0, v1, v2 )
+        return [v0, v1, v2]
     elif inpv == FIRST:
-        shape(f, intype, outtype, ptr, v1, v2, v0 )
+        return [v1, v2, v0]
     else:
-        shape(f, intype, outtype, ptr, v2, v0, v1 )
+        return [v2, v0, v1]
+
+def quad_tri_verts(v0, v1, v2, v3, inpv, outpv):
+    if inpv == LAST:
+        return tri_verts(v0, v1, v3, inpv, outpv) + tri_verts(v1, v2, v3, inpv, outpv)
+    else:
+        return tri_verts(v0, v1, v2, inpv, outpv) + tri_verts(v0, v2, v3, inpv, outpv)
+
+def do_tri(f: 'T.TextIO', intype, outtype, ptr, v0, v1, v2, inpv, outpv ):
+    shape(f, intype, outtype, ptr, *tri_verts(v0, v1, v2, inpv, outpv))
 
 def do_quad(f: 'T.TextIO', intype, outtype, ptr, v0, v1, v2, v3, inpv, outpv, out_prim ):
     if out_prim == OUT_TRIS:
-        if inpv == LAST:
-            do_tri(f, intype, outtype, ptr+'+0',  v0, v1, v3, inpv, outpv );
-            do_tri(f, intype, outtype, ptr+'+3',  v1, v2, v3, inpv, outpv );
-        else:
-            do_tri(f, intype, outtype, ptr+'+0',  v0, v1, v2, inpv, outpv );
-            do_tri(f, intype, outtype, ptr+'+3',  v0, v2, v3, inpv, outpv );
+        verts = quad_tri_verts(v0, v1, v2, v3, inpv, outpv)
+        shape(f, intype, outtype, ptr+'+0', *verts[:3])
+        shape(f, intype, outtype, ptr+'+3', *verts[3:])
     else:
         if inpv == outpv:
             shape(f, intype, outtype, ptr, v0, v1, v2, v3)
@@ -291,9 +297,107 @@ def polygon(f: 'T.TextIO', intype, outtype, inpv, outpv, pr):
     postamble(f)
 
 
+sizeof_type = dict(uint8=1, uint16=2, uint32=4)
+
+def has_quads_simd(intype, outtype, pr, out_prim):
+    if out_prim != OUT_TRIS or pr != PRDISABLE:
+        return False
+    return (intype, outtype) in ((GENERATE, UINT16), (GENERATE, UINT32),
+                                 (UINT8, UINT16), (UINT16, UINT16),
+                                 (UINT32, UINT32))
+
+def quads_simd(f: 'T.TextIO', intype, outtype, inpv, outpv):
+    """Split quads into triangles a few vectors at a time
+
+    Each iteration writes three vectors worth of output indices, which
+    covers 2 quads with 32-bit indices and 4 quads with 16-bit ones.  The
+    caller's scalar loop handles the remainder.
+    """
+    perm = quad_tri_verts(0, 1, 2, 3, inpv, outpv)
+    size = sizeof_type[outtype]
+    lanes = 16 // size
+    out_step = 3 * lanes
+    in_step = 2 * lanes
+    # Index of the input vertex each output index is taken from.
+    src = [(k // 6) * 4 + perm[k % 6] for k in range(out_step)]
+    shuf = lambda a, b, c, d: f'_MM_SHUFFLE({d}, {c}, {b}, {a})'
+
+    if intype == GENERATE:
+        f.write(f'  static const {outtype}_t offsets[{out_step}] = {{ ' +
+                ', '.join(str(v) for v in src) + ' };\n')
+        f.write('#if DETECT_ARCH_SSE\n')
+        f.write(f'  for (; j + {out_step} <= out_nr; j += {out_step}, i += {in_step}) {{\n')
+        f.write(f'      const __m128i base = _mm_set1_epi{size * 8}(({"int" if size == 4 else "short"})i);\n')
+        for v in range(3):
+            f.write(f'      _mm_storeu_si128((__m128i *)(out + j + {v * lanes}), '
+                    f'_mm_add_epi{size * 8}(base, _mm_loadu_si128((const __m128i *)(offsets + {v * lanes}))));\n')
+        f.write('   }\n')
+        f.write('#elif defined(U_INDICES_HAVE_NEON)\n')
+        f.write(f'  for (; j + {out_step} <= out_nr; j += {out_step}, i += {in_step}) {{\n')
+        f.write(f'      const uint{size * 8}x{lanes}_t base = vdupq_n_u{size * 8}(({outtype}_t)i);\n')
+        for v in range(3):
+            f.write(f'      vst1q_u{size * 8}(out + j + {v * lanes}, '
+                    f'vaddq_u{size * 8}(base, vld1q_u{size * 8}(offsets + {v * lanes})));\n')
+        f.write('   }\n')
+        f.write('#endif\n')
+        return
+
+    # NEON can gather any byte of two registers with a table lookup.
+    tbl = [s * size + b for s in src for b in range(size)]
+    f.write('#if DETECT_ARCH_SSE\n')
+    f.write('  for (; j + 12 <= out_nr; j += 12, i += 8) {\n')
+    if size == 4:
+        f.write('      const __m128i q0 = _mm_loadu_si128((const __m128i *)(in + i));\n')
+        f.write('      const __m128i q1 = _mm_loadu_si128((const __m128i *)(in + i + 4));\n')
+        f.write(f'      _mm_storeu_si128((__m128i *)(out + j), _mm_shuffle_epi32(q0, {shuf(*perm[0:4])}));\n')
+        f.write('      _mm_storeu_si128((__m128i *)(out + j + 4),\n')
+        f.write('                       _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(q0), _mm_castsi128_ps(q1),\n')
+        f.write(f'                                                       {shuf(perm[4], perm[5], perm[0], perm[1])})));\n')
+        f.write(f'      _mm_storeu_si128((__m128i *)(out + j + 8), _mm_shuffle_epi32(q1, {shuf(*perm[2:6])}));\n')
+    else:
+        if intype == UINT8:
+            f.write('      const __m128i q = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(in + i)),\n')
+            f.write('                                          _mm_setzero_si128());\n')
+        else:
+            f.write('      const __m128i q = _mm_loadu_si128((const __m128i *)(in + i));\n')
+        # a holds the first four indices of both quads, b the last two.
+        f.write(f'      const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(q, {shuf(*perm[0:4])}),\n')
+        f.write(f'                                            {shuf(*perm[0:4])});\n')
+        f.write(f'      const __m128i b = _mm_shufflehi_epi16(_mm_shufflelo_epi16(q, {shuf(*(perm[4:6] * 2))}),\n')
+        f.write(f'                                            {shuf(*(perm[4:6] * 2))});\n')
+        f.write('      const __m128 t = _mm_shuffle_ps(_mm_castsi128_ps(b), _mm_castsi128_ps(a), _MM_SHUFFLE(3, 2, 2, 0));\n')
+        f.write('      _mm_storeu_si128((__m128i *)(out + j),\n')
+        f.write('                       _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), t, _MM_SHUFFLE(2, 0, 1, 0))));\n')
+        f.write('      _mm_storel_epi64((__m128i *)(out + j + 8),\n')
+        f.write('                       _mm_shuffle_epi32(_mm_castps_si128(t), _MM_SHUFFLE(1, 3, 1, 3)));\n')
+    f.write('   }\n')
+    f.write('#elif defined(U_INDICES_HAVE_NEON)\n')
+    f.write('  {\n')
+    f.write('   static const uint8_t tbl[48] = { ' + ', '.join(str(v) for v in tbl) + ' };\n')
+    f.write('   const uint8x16_t t0 = vld1q_u8(tbl), t1 = vld1q_u8(tbl + 16), t2 = vld1q_u8(tbl + 32);\n')
+    f.write(f'   for (; j + {out_step} <= out_nr; j += {out_step}, i += {in_step}) {{\n')
+    f.write('      uint8x16x2_t q;\n')
+    if intype == UINT8:
+        f.write('      const uint8x16_t b = vld1q_u8(in + i);\n')
+        f.write('      q.val[0] = vreinterpretq_u8_u16(vmovl_u8(vget_low_u8(b)));\n')
+        f.write('      q.val[1] = vreinterpretq_u8_u16(vmovl_high_u8(b));\n')
+    else:
+        f.write(f'      q.val[0] = vreinterpretq_u8_u{size * 8}(vld1q_u{size * 8}(in + i));\n')
+        f.write(f'      q.val[1] = vreinterpretq_u8_u{size * 8}(vld1q_u{size * 8}(in + i + {lanes}));\n')
+    for v, t in enumerate(('t0', 't1', 't2')):
+        f.write(f'      vst1q_u8((uint8_t *)(out + j + {v * lanes}), vqtbl2q_u8(q, {t}));\n')
+    f.write('   }\n')
+    f.write('  }\n')
+    f.write('#endif\n')
+
 def quads(f: 'T.TextIO', intype, outtype, inpv, outpv, pr, out_prim):
     preamble(f, intype, outtype, inpv, outpv, pr, out_prim=out_prim, prim='quads')
-    if out_prim == OUT_TRIS:
+    if has_quads_simd(intype, outtype, pr, out_prim):
+        f.write('  i = start;\n')
+        f.write('  j = 0;\n')
+        quads_simd(f, intype, outtype, inpv, outpv)
+        f.write('  for (; j < out_nr; j+=6, i+=4) {\n')
+    elif out_prim == OUT_TRIS:
         f.write('  for (i = start, j = 0; j < out_nr; j+=6, i+=4) {\n')
     else:
         f.write('  for (i = start, j = 0; j < out_nr; j+=4, i+=4) {\n')
@@ -26,8 +26,16 @@
 #define U_INDICES_PRIV_H
 
 #include "util/compiler.h"
+#include "util/detect_arch.h"
 #include "u_indices.h"
 
+#if DETECT_ARCH_SSE
+#include <emmintrin.h>
+#elif DETECT_ARCH_AARCH64 && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define U_INDICES_HAVE_NEON 1
+#endif
+
 #define IN_UINT8      0
 #define IN_UINT16     1
 #define IN_UINT32     2
@@ -60,6 +68,31 @@ static void translate_memcpy_ushort( const void *in,
    memcpy(out, &((short *)in)[start], out_nr*sizeof(short));
 }
 
+/* Zero-extend 8-bit indices to 16 bits, 16 at a time where possible. */
+static inline void
+u_index_widen_ubyte_to_ushort(const uint8_t * restrict in,
+                              uint16_t * restrict out,
+                              unsigned count)
+{
+   unsigned i = 0;
+#if DETECT_ARCH_SSE
+   const __m128i zero = _mm_setzero_si128();
+   for (; i + 16 <= count; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+      _mm_storeu_si128((__m128i *)(out + i), _mm_unpacklo_epi8(v, zero));
+      _mm_storeu_si128((__m128i *)(out + i + 8), _mm_unpackhi_epi8(v, zero));
+   }
+#elif defined(U_INDICES_HAVE_NEON)
+   for (; i + 16 <= count; i += 16) {
+      uint8x16_t v = vld1q_u8(in + i);
+      vst1q_u16(out + i, vmovl_u8(vget_low_u8(v)));
+      vst1q_u16(out + i + 8, vmovl_high_u8(v));
+   }
+#endif
+   for (; i < count; i++)
+      out[i] = in[i];
+}
+
 static unsigned out_size_idx( unsigned index_size )
 {
    switch (index_size) {
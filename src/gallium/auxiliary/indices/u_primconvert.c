@@ -41,6 +41,7 @@
  */
 
 #include "pipe/p_state.h"
+#include "util/hash_table.h"
 #include "util/u_draw.h"
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
@@ -51,11 +52,37 @@
 #include "indices/u_indices.h"
 #include "indices/u_primconvert.h"
 
+/* Number of converted draws kept when cfg.cache_static_indices is set */
+#define PRIMCONVERT_CACHE_SIZE 16
+
+struct primconvert_cache_entry
+{
+   /* Key, the index buffer and vertex state are referenced so that their
+    * address can't be reused while the entry exists.
+    */
+   struct pipe_resource *index_buffer;
+   struct pipe_vertex_state *vstate;
+   unsigned start;
+   unsigned count;
+   unsigned restart_index;
+   enum mesa_prim mode;
+   uint8_t index_size;
+   bool primitive_restart;
+   unsigned api_pv;
+
+   /* The converted draw, info.index.resource is referenced */
+   struct pipe_draw_info info;
+   struct pipe_draw_start_count_bias draw;
+   struct pipe_vertex_state *new_vstate;
+};
+
 struct primconvert_context
 {
    struct pipe_context *pipe;
    struct primconvert_config cfg;
    unsigned api_pv;
+
+   struct primconvert_cache_entry cache[PRIMCONVERT_CACHE_SIZE];
 };
 
 
@@ -78,12 +105,83 @@ util_primconvert_create(struct pipe_context *pipe, uint32_t primtypes_mask)
    return util_primconvert_create_config(pipe, &cfg);
 }
 
+static void
+primconvert_cache_entry_release(struct primconvert_cache_entry *entry)
+{
+   pipe_resource_reference(&entry->index_buffer, NULL);
+   pipe_vertex_state_reference(&entry->vstate, NULL);
+   pipe_resource_reference(&entry->info.index.resource, NULL);
+   pipe_vertex_state_reference(&entry->new_vstate, NULL);
+}
+
 void
 util_primconvert_destroy(struct primconvert_context *pc)
 {
+   for (unsigned i = 0; i < PRIMCONVERT_CACHE_SIZE; i++)
+      primconvert_cache_entry_release(&pc->cache[i]);
    FREE(pc);
 }
 
+static struct primconvert_cache_entry *
+primconvert_cache_slot(struct primconvert_context *pc,
+                       struct pipe_vertex_state *vstate,
+                       const struct pipe_draw_info *info,
+                       const struct pipe_draw_start_count_bias *draw)
+{
+   uint32_t hash = _mesa_hash_pointer(info->index.resource) ^
+                   _mesa_hash_pointer(vstate) ^
+                   (draw->start * 0x9e3779b1u) ^ draw->count ^ info->mode;
+
+   return &pc->cache[hash % PRIMCONVERT_CACHE_SIZE];
+}
+
+static bool
+primconvert_cache_entry_matches(const struct primconvert_context *pc,
+                                const struct primconvert_cache_entry *entry,
+                                struct pipe_vertex_state *vstate,
+                                const struct pipe_draw_info *info,
+                                const struct pipe_draw_start_count_bias *draw)
+{
+   return entry->index_buffer == info->index.resource &&
+          entry->vstate == vstate &&
+          entry->start == draw->start &&
+          entry->count == draw->count &&
+          entry->mode == info->mode &&
+          entry->index_size == info->index_size &&
+          entry->primitive_restart == info->primitive_restart &&
+          (!info->primitive_restart ||
+           entry->restart_index == info->restart_index) &&
+          entry->api_pv == pc->api_pv;
+}
+
+/* Replaces the entry with the draw that was just converted; the entry takes
+ * over the reference to the new index buffer.
+ */
+static void
+primconvert_cache_entry_store(struct primconvert_context *pc,
+                              struct primconvert_cache_entry *entry,
+                              struct pipe_vertex_state *vstate,
+                              const struct pipe_draw_info *info,
+                              const struct pipe_draw_start_count_bias *draw,
+                              const struct pipe_draw_info *new_info,
+                              const struct pipe_draw_start_count_bias *new_draw)
+{
+   primconvert_cache_entry_release(entry);
+
+   pipe_resource_reference(&entry->index_buffer, info->index.resource);
+   pipe_vertex_state_reference(&entry->vstate, vstate);
+   entry->start = draw->start;
+   entry->count = draw->count;
+   entry->restart_index = info->restart_index;
+   entry->mode = info->mode;
+   entry->index_size = info->index_size;
+   entry->primitive_restart = info->primitive_restart;
+   entry->api_pv = pc->api_pv;
+
+   entry->info = *new_info;
+   entry->draw = *new_draw;
+}
+
 void
 util_primconvert_save_rasterizer_state(struct primconvert_context *pc,
                                        const struct pipe_rasterizer_state
@@ -108,11 +206,13 @@ primconvert_init_draw(struct primconvert_context *pc,
                       const struct pipe_draw_start_count_bias *draws,
                       struct pipe_draw_info *new_info,
                       struct pipe_draw_start_count_bias *new_draw,
+                      bool static_indices,
                       struct pipe_resource **releasebuf)
 {
    struct pipe_draw_start_count_bias *direct_draws = NULL;
    unsigned num_direct_draws = 0;
    struct pipe_transfer *src_transfer = NULL;
+   struct pipe_transfer *dst_transfer = NULL;
    u_translate_func trans_func, direct_draw_func;
    u_generate_func gen_func;
    const void *src = NULL;
@@ -225,10 +325,30 @@ primconvert_init_draw(struct primconvert_context *pc,
    uint64_t new_size = (uint64_t)new_info->index_size * new_draw->count;
    if (new_size > UINT_MAX)
       return false;
-   u_upload_alloc(pc->pipe->stream_uploader, 0, new_size, 4,
-                  &ib_offset, &new_info->index.resource, releasebuf, &dst);
-   if (!dst)
-      return false;
+   if (static_indices) {
+      /* The indices outlive this draw, so they can't come from the stream
+       * uploader which recycles its buffers.
+       */
+      new_info->index.resource =
+         pipe_buffer_create(pc->pipe->screen, PIPE_BIND_INDEX_BUFFER,
+                            PIPE_USAGE_DEFAULT, new_size);
+      if (!new_info->index.resource)
+         return false;
+      *releasebuf = new_info->index.resource;
+      ib_offset = 0;
+      dst = pipe_buffer_map(pc->pipe, new_info->index.resource,
+                            PIPE_MAP_WRITE | PIPE_MAP_DISCARD_WHOLE_RESOURCE,
+                            &dst_transfer);
+      if (!dst) {
+         pipe_resource_reference(releasebuf, NULL);
+         return false;
+      }
+   } else {
+      u_upload_alloc(pc->pipe->stream_uploader, 0, new_size, 4,
+                     &ib_offset, &new_info->index.resource, releasebuf, &dst);
+      if (!dst)
+         return false;
+   }
    new_draw->start = ib_offset / new_info->index_size;
    new_draw->index_bias = info->index_size ? draw.index_bias : 0;
 
@@ -274,7 +394,10 @@ primconvert_init_draw(struct primconvert_context *pc,
    if (src_transfer)
       pipe_buffer_unmap(pc->pipe, src_transfer);
 
-   u_upload_unmap(pc->pipe->stream_uploader);
+   if (dst_transfer)
+      pipe_buffer_unmap(pc->pipe, dst_transfer);
+   else
+      u_upload_unmap(pc->pipe->stream_uploader);
 
    free(direct_draws);
    free(rewrite_buffer);
@@ -290,12 +413,33 @@ util_primconvert_draw_single_vbo(struct primconvert_context *pc,
    struct pipe_draw_info new_info;
    struct pipe_draw_start_count_bias new_draw;
    struct pipe_resource *releasebuf = NULL;
+   struct primconvert_cache_entry *entry = NULL;
+
+   if (pc->cfg.cache_static_indices && info->index_size &&
+       !info->has_user_indices &&
+       info->index.resource->usage == PIPE_USAGE_IMMUTABLE) {
+      entry = primconvert_cache_slot(pc, NULL, info, draw);
+      if (primconvert_cache_entry_matches(pc, entry, NULL, info, draw)) {
+         new_info = entry->info;
+         new_info.start_instance = info->start_instance;
+         new_info.instance_count = info->instance_count;
+         new_draw = entry->draw;
+         new_draw.index_bias = draw->index_bias;
+         pc->pipe->draw_vbo(pc->pipe, &new_info, drawid_offset, NULL, &new_draw, 1);
+         return;
+      }
+   }
 
-   if (!primconvert_init_draw(pc, info, draw, &new_info, &new_draw, &releasebuf))
+   if (!primconvert_init_draw(pc, info, draw, &new_info, &new_draw,
+                              entry != NULL, &releasebuf))
       return;
    /* to the translated draw: */
    pc->pipe->draw_vbo(pc->pipe, &new_info, drawid_offset, NULL, &new_draw, 1);
-   pipe_resource_release(pc->pipe, releasebuf);
+   if (entry)
+      primconvert_cache_entry_store(pc, entry, NULL, info, draw,
+                                    &new_info, &new_draw);
+   else
+      pipe_resource_release(pc->pipe, releasebuf);
 }
 
 void
@@ -359,7 +503,27 @@ util_primconvert_draw_vertex_state(struct primconvert_context *pc,
    dinfo.index_size = 4;
    dinfo.instance_count = 1;
    dinfo.index.resource = vstate->input.indexbuf;
-   if (!primconvert_init_draw(pc, &dinfo, draws, &new_info, &new_draw, &releasebuf))
+
+   /* Vertex states are immutable, so their converted draws can be kept. */
+   struct primconvert_cache_entry *entry = NULL;
+   if (pc->cfg.cache_static_indices) {
+      entry = primconvert_cache_slot(pc, vstate, &dinfo, draws);
+      if (primconvert_cache_entry_matches(pc, entry, vstate, &dinfo, draws)) {
+         struct pipe_draw_vertex_state_info new_vinfo;
+         new_vinfo.mode = entry->info.mode;
+         new_vinfo.take_vertex_state_ownership = false;
+         new_draw = entry->draw;
+         new_draw.index_bias = draws->index_bias;
+         pc->pipe->draw_vertex_state(pc->pipe, entry->new_vstate, partial_velem_mask,
+                                     new_vinfo, &new_draw, 1);
+         if (info.take_vertex_state_ownership)
+            pipe_vertex_state_reference(&vstate, NULL);
+         return;
+      }
+   }
+
+   if (!primconvert_init_draw(pc, &dinfo, draws, &new_info, &new_draw,
+                              entry != NULL, &releasebuf))
       return;
 
    struct pipe_vertex_state *new_state = pc->pipe->screen->create_vertex_state(pc->pipe->screen,
@@ -371,11 +535,17 @@ util_primconvert_draw_vertex_state(struct primconvert_context *pc,
    if (new_state) {
       struct pipe_draw_vertex_state_info new_vinfo;
       new_vinfo.mode = new_info.mode;
-      new_vinfo.take_vertex_state_ownership = true;
+      new_vinfo.take_vertex_state_ownership = entry == NULL;
       /* to the translated draw: */
       pc->pipe->draw_vertex_state(pc->pipe, new_state, partial_velem_mask, new_vinfo, &new_draw, 1);
    }
+   if (entry && new_state) {
+      primconvert_cache_entry_store(pc, entry, vstate, &dinfo, draws,
+                                    &new_info, &new_draw);
+      entry->new_vstate = new_state;
+   } else {
+      pipe_resource_release(pc->pipe, releasebuf);
+   }
    if (info.take_vertex_state_ownership)
       pipe_vertex_state_reference(&vstate, NULL);
-   pipe_resource_release(pc->pipe, releasebuf);
 }
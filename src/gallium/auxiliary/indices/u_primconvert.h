@@ -39,6 +39,11 @@ struct primconvert_config {
    uint32_t primtypes_mask;
    uint32_t restart_primtypes_mask;
    bool fixed_prim_restart;
+   /* Keep the converted indices of draws from index buffers which can't
+    * change (PIPE_USAGE_IMMUTABLE buffers and vertex states), so that
+    * repeating the draw doesn't convert them again.
+    */
+   bool cache_static_indices;
 };
 
 struct primconvert_context *util_primconvert_create(struct pipe_context *pipe,
@@ -35,6 +35,7 @@ DRI_CONF_SECTION_DEBUG
    DRI_CONF_ALLOW_HIGHER_COMPAT_VERSION(false)
    DRI_CONF_ALLOW_GLSL_COMPAT_SHADERS(false)
    DRI_CONF_FORCE_GLSL_ABS_SQRT(false)
+   DRI_CONF_GLSL_ES_SKIP_IR_OPTIMIZATIONS(false)
    DRI_CONF_GLSL_CORRECT_DERIVATIVES_AFTER_DISCARD(false)
    DRI_CONF_GLSL_IGNORE_WRITE_TO_READONLY_VAR(false)
    DRI_CONF_ALLOW_DRAW_OUT_OF_ORDER(true)
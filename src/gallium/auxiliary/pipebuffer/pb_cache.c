@@ -29,6 +29,8 @@
 #include "pb_cache.h"
 #include "util/u_memory.h"
 #include "util/os_time.h"
+#include "util/timespec.h"
+#include "util/u_math.h"
 
 /*
  * Helper function for detecting time outs, taking in account overflow.
@@ -59,6 +61,21 @@ get_buffer(struct pb_cache *mgr, struct pb_cache_entry *entry)
    return (struct pb_buffer_lean*)((char*)entry - mgr->offsetof_pb_cache_entry);
 }
 
+static unsigned
+get_size_class(pb_size size)
+{
+   int log2 = util_logbase2_ceil64(MAX2(size, 1));
+
+   return CLAMP(log2 - PB_CACHE_MIN_SIZE_CLASS_LOG2, 0,
+                PB_CACHE_NUM_SIZE_CLASSES - 1);
+}
+
+static struct list_head *
+get_bucket(struct pb_cache *mgr, unsigned bucket_index, unsigned size_class)
+{
+   return &mgr->buckets[bucket_index * PB_CACHE_NUM_SIZE_CLASSES + size_class];
+}
+
 /**
  * Actually destroy the buffer.
  */
@@ -70,6 +87,7 @@ destroy_buffer_locked(struct pb_cache *mgr, struct pb_cache_entry *entry)
    assert(!pipe_is_referenced(&buf->reference));
    if (list_is_linked(&entry->head)) {
       list_del(&entry->head);
+      list_del(&entry->lru);
       assert(mgr->num_buffers);
       --mgr->num_buffers;
       mgr->cache_size -= buf->size;
@@ -78,28 +96,16 @@ destroy_buffer_locked(struct pb_cache *mgr, struct pb_cache_entry *entry)
 }
 
 /**
- * Free as many cache buffers from the list head as possible.
+ * Free all expired buffers. They are at the start of the LRU list.
  */
 static void
-release_expired_buffers_locked(struct pb_cache *mgr, struct list_head *cache,
-                               unsigned current_time_ms)
+release_expired_buffers_locked(struct pb_cache *mgr, unsigned current_time_ms)
 {
-   struct list_head *curr, *next;
-   struct pb_cache_entry *entry;
-
-   curr = cache->next;
-   next = curr->next;
-   while (curr != cache) {
-      entry = list_entry(curr, struct pb_cache_entry, head);
-
-      if (!time_timeout_ms(entry->start_ms, mgr->msecs,
-                           current_time_ms))
+   list_for_each_entry_safe(struct pb_cache_entry, entry, &mgr->lru, lru) {
+      if (!time_timeout_ms(entry->start_ms, mgr->msecs, current_time_ms))
          break;
 
       destroy_buffer_locked(mgr, entry);
-
-      curr = next;
-      next = curr->next;
    }
 }
 
@@ -110,17 +116,16 @@ release_expired_buffers_locked(struct pb_cache *mgr, struct list_head *cache,
 void
 pb_cache_add_buffer(struct pb_cache *mgr, struct pb_cache_entry *entry)
 {
-   struct list_head *cache = &mgr->buckets[entry->bucket_index];
    struct pb_buffer_lean *buf = get_buffer(mgr, entry);
-   unsigned i;
+   struct list_head *cache = get_bucket(mgr, entry->bucket_index,
+                                        get_size_class(buf->size));
 
    simple_mtx_lock(&mgr->mutex);
    assert(!pipe_is_referenced(&buf->reference));
 
    unsigned current_time_ms = time_get_ms(mgr);
 
-   for (i = 0; i < mgr->num_heaps; i++)
-      release_expired_buffers_locked(mgr, &mgr->buckets[i], current_time_ms);
+   release_expired_buffers_locked(mgr, current_time_ms);
 
    /* Directly release any buffer that exceeds the limit. */
    if (mgr->cache_size + buf->size > mgr->max_cache_size) {
@@ -129,11 +134,21 @@ pb_cache_add_buffer(struct pb_cache *mgr, struct pb_cache_entry *entry)
       return;
    }
 
-   entry->start_ms = time_get_ms(mgr);
+   bool was_empty = list_is_empty(&mgr->lru);
+
+   entry->start_ms = current_time_ms;
    list_addtail(&entry->head, cache);
+   list_addtail(&entry->lru, &mgr->lru);
    ++mgr->num_buffers;
    mgr->cache_size += buf->size;
    simple_mtx_unlock(&mgr->mutex);
+
+   /* The trim thread waits without a timeout while the cache is empty. */
+   if (was_empty && mgr->trim_thread_started) {
+      mtx_lock(&mgr->trim_mutex);
+      cnd_signal(&mgr->trim_cond);
+      mtx_unlock(&mgr->trim_mutex);
+   }
 }
 
 /**
@@ -173,57 +188,36 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
                         unsigned alignment, unsigned usage,
                         unsigned bucket_index)
 {
-   struct pb_cache_entry *entry;
-   struct pb_cache_entry *cur_entry;
-   struct list_head *cur, *next;
-   int ret = 0;
+   struct pb_cache_entry *entry = NULL;
 
    assert(bucket_index < mgr->num_heaps);
-   struct list_head *cache = &mgr->buckets[bucket_index];
 
-   simple_mtx_lock(&mgr->mutex);
+   if (usage & mgr->bypass_usage)
+      return NULL;
 
-   entry = NULL;
-   cur = cache->next;
-   next = cur->next;
-
-   /* search in the expired buffers, freeing them in the process */
-   unsigned now = time_get_ms(mgr);
-   while (cur != cache) {
-      cur_entry = list_entry(cur, struct pb_cache_entry, head);
-
-      if (!entry && (ret = pb_cache_is_buffer_compat(mgr, cur_entry, size,
-                                                     alignment, usage)) > 0)
-         entry = cur_entry;
-      else if (time_timeout_ms(cur_entry->start_ms, mgr->msecs, now))
-         destroy_buffer_locked(mgr, cur_entry);
-      else
-         /* This buffer (and all hereafter) are still hot in cache */
-         break;
+   simple_mtx_lock(&mgr->mutex);
 
-      /* the buffer is busy (and probably all remaining ones too) */
-      if (ret == -1)
-         break;
+   release_expired_buffers_locked(mgr, time_get_ms(mgr));
 
-      cur = next;
-      next = cur->next;
-   }
+   /* Only the size classes between the requested size and the biggest
+    * acceptable size can contain compatible buffers.
+    */
+   unsigned first_class = get_size_class(size);
+   unsigned last_class = get_size_class((pb_size)(mgr->size_factor * size));
 
-   /* keep searching in the hot buffers */
-   if (!entry && ret != -1) {
-      while (cur != cache) {
-         cur_entry = list_entry(cur, struct pb_cache_entry, head);
-         ret = pb_cache_is_buffer_compat(mgr, cur_entry, size, alignment, usage);
+   for (unsigned c = first_class; c <= last_class && !entry; c++) {
+      struct list_head *cache = get_bucket(mgr, bucket_index, c);
 
+      list_for_each_entry(struct pb_cache_entry, cur_entry, cache, head) {
+         int ret = pb_cache_is_buffer_compat(mgr, cur_entry, size,
+                                             alignment, usage);
          if (ret > 0) {
             entry = cur_entry;
             break;
          }
+         /* the buffer is busy (and probably all remaining ones too) */
          if (ret == -1)
             break;
-         /* no need to check the timeout here */
-         cur = next;
-         next = cur->next;
       }
    }
 
@@ -233,6 +227,7 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
 
       mgr->cache_size -= buf->size;
       list_del(&entry->head);
+      list_del(&entry->lru);
       --mgr->num_buffers;
       simple_mtx_unlock(&mgr->mutex);
       /* Increase refcount */
@@ -250,24 +245,12 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
 unsigned
 pb_cache_release_all_buffers(struct pb_cache *mgr)
 {
-   struct list_head *curr, *next;
-   struct pb_cache_entry *buf;
    unsigned num_reclaims = 0;
-   unsigned i;
 
    simple_mtx_lock(&mgr->mutex);
-   for (i = 0; i < mgr->num_heaps; i++) {
-      struct list_head *cache = &mgr->buckets[i];
-
-      curr = cache->next;
-      next = curr->next;
-      while (curr != cache) {
-         buf = list_entry(curr, struct pb_cache_entry, head);
-         destroy_buffer_locked(mgr, buf);
-         num_reclaims++;
-         curr = next;
-         next = curr->next;
-      }
+   list_for_each_entry_safe(struct pb_cache_entry, entry, &mgr->lru, lru) {
+      destroy_buffer_locked(mgr, entry);
+      num_reclaims++;
    }
    simple_mtx_unlock(&mgr->mutex);
    return num_reclaims;
@@ -287,9 +270,10 @@ pb_cache_init_entry(struct pb_cache *mgr, struct pb_cache_entry *entry,
  * Initialize a caching buffer manager.
  *
  * @param mgr     The cache buffer manager
- * @param num_heaps  Number of separate caches/buckets indexed by bucket_index
- *                   for faster buffer matching (alternative to slower
- *                   "usage"-based matching).
+ * @param num_heaps  Number of separate caches indexed by bucket_index for
+ *                   faster buffer matching (alternative to slower
+ *                   "usage"-based matching). Each of them is further
+ *                   divided by size.
  * @param usecs   Unused buffers may be released from the cache after this
  *                time
  * @param size_factor  Declare buffers that are size_factor times bigger than
@@ -312,12 +296,14 @@ pb_cache_init(struct pb_cache *mgr, unsigned num_heaps,
 {
    unsigned i;
 
-   mgr->buckets = CALLOC(num_heaps, sizeof(struct list_head));
+   mgr->buckets = CALLOC(num_heaps * PB_CACHE_NUM_SIZE_CLASSES,
+                         sizeof(struct list_head));
    if (!mgr->buckets)
       return;
 
-   for (i = 0; i < num_heaps; i++)
+   for (i = 0; i < num_heaps * PB_CACHE_NUM_SIZE_CLASSES; i++)
       list_inithead(&mgr->buckets[i]);
+   list_inithead(&mgr->lru);
 
    (void) simple_mtx_init(&mgr->mutex, mtx_plain);
    mgr->winsys = winsys;
@@ -340,8 +326,83 @@ pb_cache_init(struct pb_cache *mgr, unsigned num_heaps,
 void
 pb_cache_deinit(struct pb_cache *mgr)
 {
+   if (mgr->trim_thread_started) {
+      mtx_lock(&mgr->trim_mutex);
+      mgr->trim_thread_exit = true;
+      cnd_signal(&mgr->trim_cond);
+      mtx_unlock(&mgr->trim_mutex);
+
+      thrd_join(mgr->trim_thread, NULL);
+      cnd_destroy(&mgr->trim_cond);
+      mtx_destroy(&mgr->trim_mutex);
+      mgr->trim_thread_started = false;
+   }
+
    pb_cache_release_all_buffers(mgr);
    simple_mtx_destroy(&mgr->mutex);
    FREE(mgr->buckets);
    mgr->buckets = NULL;
 }
+
+static int
+pb_cache_trim_thread(void *data)
+{
+   struct pb_cache *mgr = data;
+
+   u_thread_setname("pb_cache_trim");
+
+   mtx_lock(&mgr->trim_mutex);
+   while (!mgr->trim_thread_exit) {
+      simple_mtx_lock(&mgr->mutex);
+      unsigned now = time_get_ms(mgr);
+      release_expired_buffers_locked(mgr, now);
+
+      /* Sleep until the oldest buffer expires. */
+      int64_t wait_ms = -1;
+      if (!list_is_empty(&mgr->lru)) {
+         struct pb_cache_entry *oldest =
+            list_first_entry(&mgr->lru, struct pb_cache_entry, lru);
+         wait_ms = (int64_t)oldest->start_ms + mgr->msecs - now + 1;
+         wait_ms = CLAMP(wait_ms, 1, mgr->msecs + 1);
+      }
+      simple_mtx_unlock(&mgr->mutex);
+
+      if (wait_ms < 0) {
+         cnd_wait(&mgr->trim_cond, &mgr->trim_mutex);
+      } else {
+         struct timespec now_ts, abs_timeout_ts;
+         timespec_get(&now_ts, TIME_UTC);
+         timespec_add_msec(&abs_timeout_ts, &now_ts, wait_ms);
+         cnd_timedwait(&mgr->trim_cond, &mgr->trim_mutex, &abs_timeout_ts);
+      }
+   }
+   mtx_unlock(&mgr->trim_mutex);
+   return 0;
+}
+
+/**
+ * Start a thread which releases expired buffers even when no buffers are
+ * allocated or released, so that idle processes don't keep them cached.
+ */
+void
+pb_cache_start_trim_thread(struct pb_cache *mgr)
+{
+   assert(!mgr->trim_thread_started);
+
+   if (mtx_init(&mgr->trim_mutex, mtx_plain) != thrd_success)
+      return;
+
+   if (cnd_init(&mgr->trim_cond) != thrd_success) {
+      mtx_destroy(&mgr->trim_mutex);
+      return;
+   }
+
+   mgr->trim_thread_exit = false;
+   if (u_thread_create(&mgr->trim_thread, pb_cache_trim_thread, mgr) != thrd_success) {
+      cnd_destroy(&mgr->trim_cond);
+      mtx_destroy(&mgr->trim_mutex);
+      return;
+   }
+
+   mgr->trim_thread_started = true;
+}
@@ -39,17 +39,27 @@
  */
 struct pb_cache_entry
 {
-   struct list_head head;
+   struct list_head head; /**< Link in the bucket of the size class */
+   struct list_head lru;  /**< Link in pb_cache::lru */
    unsigned start_ms; /**< Cached start time */
    unsigned bucket_index;
 };
 
+/* Buffers of each heap are bucketed by power-of-two size, starting with
+ * everything up to 4 KiB.
+ */
+#define PB_CACHE_MIN_SIZE_CLASS_LOG2   12
+#define PB_CACHE_NUM_SIZE_CLASSES      28
+
 struct pb_cache
 {
    /* The cache is divided into buckets for minimizing cache misses.
-    * The driver controls which buffer goes into which bucket.
+    * The driver controls which heap a buffer goes into, and each heap has
+    * PB_CACHE_NUM_SIZE_CLASSES buckets.
     */
    struct list_head *buckets;
+   /* All cached buffers, least recently added first. */
+   struct list_head lru;
 
    simple_mtx_t mutex;
    void *winsys;
@@ -65,6 +75,13 @@ struct pb_cache
 
    void (*destroy_buffer)(void *winsys, struct pb_buffer_lean *buf);
    bool (*can_reclaim)(void *winsys, struct pb_buffer_lean *buf);
+
+   /* Releases expired buffers while nothing else touches the cache. */
+   thrd_t trim_thread;
+   mtx_t trim_mutex;
+   cnd_t trim_cond;
+   bool trim_thread_started;
+   bool trim_thread_exit;
 };
 
 void pb_cache_add_buffer(struct pb_cache *mgr, struct pb_cache_entry *entry);
@@ -81,5 +98,6 @@ void pb_cache_init(struct pb_cache *mgr, unsigned num_heaps,
                    void (*destroy_buffer)(void *winsys, struct pb_buffer_lean *buf),
                    bool (*can_reclaim)(void *winsys, struct pb_buffer_lean *buf));
 void pb_cache_deinit(struct pb_cache *mgr);
+void pb_cache_start_trim_thread(struct pb_cache *mgr);
 
 #endif
@@ -31,8 +31,23 @@
 
 #include <new>
 
+/// Number of tessellated patches remembered by a tessellator
+#define PIPE_TESS_PATTERN_CACHE_SIZE 8
+
 namespace pipe_tessellator_wrap
 {
+   /// The output of one tessellation, the factors are compared bitwise
+   struct pattern
+   {
+      uint32_t factors[6];
+      uint32_t num_factors;
+      uint32_t num_domain_points;
+      uint32_t num_indices;
+      uint32_t capacity;
+      /// u, v and the indices share one allocation of capacity bytes
+      uint8_t *data;
+   };
+
    /// Wrapper class for the CHWTessellator reference tessellator from MSFT
    /// This class will store data not originally stored in CHWTessellator
    class pipe_ts : private CHWTessellator
@@ -44,7 +59,66 @@ namespace pipe_tessellator_wrap
       alignas(32) float      domain_points_v[MAX_POINT_COUNT];
       uint32_t               num_domain_points;
 
+      /// The output only depends on the factors, and most patches of a draw
+      /// share a handful of them.
+      struct pattern         patterns[PIPE_TESS_PATTERN_CACHE_SIZE];
+
+      static uint32_t PatternPointsSize(uint32_t num_domain_points)
+      {
+         return align(num_domain_points * sizeof(float), 32);
+      }
+
+      struct pattern *FindPattern(const uint32_t *factors, uint32_t num_factors,
+                                  bool *found)
+      {
+         uint32_t hash = 0;
+         for (uint32_t i = 0; i < num_factors; i++)
+            hash = (hash ^ factors[i]) * 0x01000193;
+         hash ^= hash >> 16;
+
+         struct pattern *pat = &patterns[hash % PIPE_TESS_PATTERN_CACHE_SIZE];
+         *found = pat->num_factors == num_factors &&
+                  !memcmp(pat->factors, factors, num_factors * sizeof(uint32_t));
+         return pat;
+      }
+
+      void StorePattern(struct pattern *pat, const uint32_t *factors,
+                        uint32_t num_factors,
+                        const struct pipe_tessellator_data *tess_data)
+      {
+         uint32_t points_size = PatternPointsSize(tess_data->num_domain_points);
+         uint32_t size = 2 * points_size +
+                         tess_data->num_indices * sizeof(uint32_t);
+
+         /* Leave the entry invalid if the allocation fails. */
+         pat->num_factors = 0;
+         if (size > pat->capacity) {
+            align_free(pat->data);
+            pat->data = (uint8_t *)align_malloc(size, 32);
+            pat->capacity = pat->data ? size : 0;
+            if (!pat->data)
+               return;
+         }
+
+         memcpy(pat->data, tess_data->domain_points_u,
+                tess_data->num_domain_points * sizeof(float));
+         memcpy(pat->data + points_size, tess_data->domain_points_v,
+                tess_data->num_domain_points * sizeof(float));
+         memcpy(pat->data + 2 * points_size, tess_data->indices,
+                tess_data->num_indices * sizeof(uint32_t));
+         memcpy(pat->factors, factors, num_factors * sizeof(uint32_t));
+         pat->num_domain_points = tess_data->num_domain_points;
+         pat->num_indices = tess_data->num_indices;
+         pat->num_factors = num_factors;
+      }
+
    public:
+      ~pipe_ts()
+      {
+         for (uint32_t i = 0; i < PIPE_TESS_PATTERN_CACHE_SIZE; i++)
+            align_free(patterns[i].data);
+      }
+
       void Init(enum mesa_prim tes_prim_mode,
                 enum pipe_tess_spacing ts_spacing,
                 bool tes_vertex_order_cw, bool tes_point_mode)
@@ -70,11 +144,44 @@ namespace pipe_tessellator_wrap
 
          prim_mode          = tes_prim_mode;
          num_domain_points = 0;
+         memset(patterns, 0, sizeof(patterns));
       }
 
       void Tessellate(const struct pipe_tessellation_factors *tess_factors,
                       struct pipe_tessellator_data *tess_data)
       {
+         uint32_t factors[6];
+         uint32_t num_factors;
+
+         switch (prim_mode) {
+         case MESA_PRIM_QUADS:
+            memcpy(&factors[0], tess_factors->outer_tf, 4 * sizeof(float));
+            memcpy(&factors[4], tess_factors->inner_tf, 2 * sizeof(float));
+            num_factors = 6;
+            break;
+         case MESA_PRIM_TRIANGLES:
+            memcpy(&factors[0], tess_factors->outer_tf, 3 * sizeof(float));
+            memcpy(&factors[3], tess_factors->inner_tf, sizeof(float));
+            num_factors = 4;
+            break;
+         default:
+            memcpy(&factors[0], tess_factors->outer_tf, 2 * sizeof(float));
+            num_factors = 2;
+            break;
+         }
+
+         bool found;
+         struct pattern *pat = FindPattern(factors, num_factors, &found);
+         if (found) {
+            uint32_t points_size = PatternPointsSize(pat->num_domain_points);
+            tess_data->num_domain_points = pat->num_domain_points;
+            tess_data->domain_points_u = (float *)pat->data;
+            tess_data->domain_points_v = (float *)(pat->data + points_size);
+            tess_data->num_indices = pat->num_indices;
+            tess_data->indices = (uint32_t *)(pat->data + 2 * points_size);
+            return;
+         }
+
          switch (prim_mode)
             {
             case MESA_PRIM_QUADS:
@@ -120,6 +227,8 @@ namespace pipe_tessellator_wrap
          tess_data->num_indices = (uint32_t)SUPER::GetIndexCount();
 
          tess_data->indices = (uint32_t*)SUPER::GetIndices();
+
+         StorePattern(pat, factors, num_factors, tess_data);
       }
    };
 } // namespace Tessellator
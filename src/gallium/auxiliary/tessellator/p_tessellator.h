@@ -59,6 +59,10 @@ void p_tess_destroy(struct pipe_tessellator *pipe_ts);
 
 
 /// Perform Tessellation
+///
+/// The arrays returned in tess_data belong to the tessellator and are valid
+/// until the next call.  Tessellating with the same factors as one of the
+/// recent calls returns the remembered result.
 void p_tessellate(struct pipe_tessellator *pipe_ts,
                   const struct pipe_tessellation_factors *tess_factors,
                   struct pipe_tessellator_data *tess_data);
@@ -30,6 +30,7 @@
   *   Keith Whitwell <keithw@vmware.com>
   */
 
+#include "util/detect_arch.h"
 #include "util/u_memory.h"
 #include "util/format/u_format.h"
 #include "util/half_float.h"
@@ -38,10 +39,27 @@
 #include "translate.h"
 
 
+#if DETECT_ARCH_SSE
+#include <emmintrin.h>
+#elif (DETECT_ARCH_AARCH64 || DETECT_ARCH_ARM) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TRANSLATE_HAVE_NEON 1
+#endif
+
+
 #define DRAW_DBG 0
 
 typedef void (*emit_func)(const void *attrib, void *ptr);
 
+/**
+ * Fetch 'count' vertices of one attribute and write them out as
+ * R32G32B32A32_FLOAT, without going through the float[4] temporary and
+ * the separate fetch/emit calls.
+ */
+typedef void (*fetch_row_func)(uint8_t *restrict dst, unsigned dst_stride,
+                               const uint8_t *restrict src,
+                               unsigned src_stride, unsigned count);
+
 
 
 struct translate_generic {
@@ -59,6 +77,9 @@ struct translate_generic {
       emit_func emit;
       unsigned output_offset;
 
+      /* fused fetch + emit for common formats, NULL if unavailable */
+      fetch_row_func fetch_row;
+
       const uint8_t *input_ptr;
       unsigned input_stride;
       unsigned max_index;
@@ -76,6 +97,9 @@ struct translate_generic {
    } attrib[TRANSLATE_MAX_ATTRIBS];
 
    unsigned nr_attrib;
+
+   /* number of attribs with a fetch_row function */
+   unsigned nr_row_attrib;
 };
 
 
@@ -584,13 +608,141 @@ get_emit_func(enum pipe_format format)
    }
 }
 
+/**
+ * Row fetchers for the formats most commonly fed to the draw module,
+ * all writing R32G32B32A32_FLOAT.  Missing components are filled with
+ * (0, 0, 0, 1) as in the u_format unpack functions.
+ */
+#define ROW_FLOAT(NAME, SZ)                                             \
+static void                                                             \
+row_float4_##NAME(uint8_t *restrict dst, unsigned dst_stride,           \
+                  const uint8_t *restrict src, unsigned src_stride,     \
+                  unsigned count)                                       \
+{                                                                       \
+   static const float defaults[4] = { 0.0f, 0.0f, 0.0f, 1.0f };         \
+                                                                        \
+   for (unsigned i = 0; i < count; i++) {                               \
+      float out[4];                                                     \
+      memcpy(out, src, SZ * sizeof(float));                             \
+      memcpy(out + SZ, defaults + SZ, (4 - SZ) * sizeof(float));        \
+      memcpy(dst, out, sizeof(out));                                    \
+      src += src_stride;                                                \
+      dst += dst_stride;                                                \
+   }                                                                    \
+}
+
+ROW_FLOAT(R32G32B32_FLOAT, 3)
+ROW_FLOAT(R32G32_FLOAT,    2)
+ROW_FLOAT(R32_FLOAT,       1)
+
+static void
+row_float4_R16G16B16A16_FLOAT(uint8_t *restrict dst, unsigned dst_stride,
+                              const uint8_t *restrict src,
+                              unsigned src_stride, unsigned count)
+{
+   for (unsigned i = 0; i < count; i++) {
+      uint16_t in[4];
+      float out[4];
+      memcpy(in, src, sizeof(in));
+      for (unsigned c = 0; c < 4; c++)
+         out[c] = _mesa_half_to_float(in[c]);
+      memcpy(dst, out, sizeof(out));
+      src += src_stride;
+      dst += dst_stride;
+   }
+}
+
+static inline void
+unorm8x4_to_float4(float *restrict out, const uint8_t *restrict src,
+                   bool swap_rb)
+{
+   uint32_t packed;
+   memcpy(&packed, src, sizeof(packed));
+
+#if DETECT_ARCH_SSE
+   const __m128i zero = _mm_setzero_si128();
+   __m128i v = _mm_cvtsi32_si128(packed);
+   v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+   if (swap_rb)
+      v = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 0, 1, 2));
+   _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(v),
+                                 _mm_set1_ps(1.0f / 255.0f)));
+#elif defined(TRANSLATE_HAVE_NEON)
+   uint8x8_t b = vreinterpret_u8_u32(vdup_n_u32(packed));
+   uint32x4_t v = vmovl_u16(vget_low_u16(vmovl_u8(b)));
+   float32x4_t f = vmulq_n_f32(vcvtq_f32_u32(v), 1.0f / 255.0f);
+   if (swap_rb) {
+      float tmp = vgetq_lane_f32(f, 0);
+      f = vsetq_lane_f32(vgetq_lane_f32(f, 2), f, 0);
+      f = vsetq_lane_f32(tmp, f, 2);
+   }
+   vst1q_f32(out, f);
+#else
+   const uint8_t *in = (const uint8_t *)&packed;
+   out[0] = in[swap_rb ? 2 : 0] * (1.0f / 255.0f);
+   out[1] = in[1] * (1.0f / 255.0f);
+   out[2] = in[swap_rb ? 0 : 2] * (1.0f / 255.0f);
+   out[3] = in[3] * (1.0f / 255.0f);
+#endif
+}
+
+static void
+row_float4_R8G8B8A8_UNORM(uint8_t *restrict dst, unsigned dst_stride,
+                          const uint8_t *restrict src, unsigned src_stride,
+                          unsigned count)
+{
+   for (unsigned i = 0; i < count; i++) {
+      float out[4];
+      unorm8x4_to_float4(out, src, false);
+      memcpy(dst, out, sizeof(out));
+      src += src_stride;
+      dst += dst_stride;
+   }
+}
+
+static void
+row_float4_B8G8R8A8_UNORM(uint8_t *restrict dst, unsigned dst_stride,
+                          const uint8_t *restrict src, unsigned src_stride,
+                          unsigned count)
+{
+   for (unsigned i = 0; i < count; i++) {
+      float out[4];
+      unorm8x4_to_float4(out, src, true);
+      memcpy(dst, out, sizeof(out));
+      src += src_stride;
+      dst += dst_stride;
+   }
+}
+
+static const fetch_row_func fetch_row_float4[] = {
+   [PIPE_FORMAT_R32G32B32_FLOAT] = row_float4_R32G32B32_FLOAT,
+   [PIPE_FORMAT_R32G32_FLOAT] = row_float4_R32G32_FLOAT,
+   [PIPE_FORMAT_R32_FLOAT] = row_float4_R32_FLOAT,
+   [PIPE_FORMAT_R16G16B16A16_FLOAT] = row_float4_R16G16B16A16_FLOAT,
+   [PIPE_FORMAT_R8G8B8A8_UNORM] = row_float4_R8G8B8A8_UNORM,
+   [PIPE_FORMAT_B8G8R8A8_UNORM] = row_float4_B8G8R8A8_UNORM,
+};
+
+static fetch_row_func
+get_fetch_row_func(const struct translate_element *elem)
+{
+   if (elem->type != TRANSLATE_ELEMENT_NORMAL ||
+       elem->instance_divisor ||
+       elem->output_format != PIPE_FORMAT_R32G32B32A32_FLOAT ||
+       elem->input_format >= ARRAY_SIZE(fetch_row_float4))
+      return NULL;
+
+   return fetch_row_float4[elem->input_format];
+}
+
 static ALWAYS_INLINE void UTIL_CDECL
 generic_run_one(struct translate_generic *tg,
                 unsigned elt,
                 unsigned start_instance,
                 unsigned instance_id,
                 void *vert,
-                unsigned index_size)
+                unsigned index_size,
+                bool skip_rows)
 {
    unsigned nr_attrs = tg->nr_attrib;
    unsigned attr;
@@ -624,7 +776,10 @@ generic_run_one(struct translate_generic *tg,
                (ptrdiff_t)tg->attrib[attr].input_stride * index;
 
          copy_size = tg->attrib[attr].copy_size;
-         if (likely(copy_size >= 0)) {
+         if (tg->attrib[attr].fetch_row) {
+            if (!skip_rows)
+               tg->attrib[attr].fetch_row(dst, 0, src, 0, 1);
+         } else if (likely(copy_size >= 0)) {
             memcpy(dst, src, copy_size);
          } else {
             tg->attrib[attr].fetch(data, src, 1);
@@ -667,7 +822,8 @@ generic_run_elts(struct translate *translate,
    unsigned i;
 
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 4);
+      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 4,
+                      false);
       vert += tg->translate.key.output_stride;
    }
 }
@@ -685,7 +841,8 @@ generic_run_elts16(struct translate *translate,
    unsigned i;
 
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 2);
+      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 2,
+                      false);
       vert += tg->translate.key.output_stride;
    }
 }
@@ -703,7 +860,8 @@ generic_run_elts8(struct translate *translate,
    unsigned i;
 
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 1);
+      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 1,
+                      false);
       vert += tg->translate.key.output_stride;
    }
 }
@@ -717,12 +875,31 @@ generic_run(struct translate *translate,
             void *output_buffer)
 {
    struct translate_generic *tg = translate_generic(translate);
+   const unsigned stride = tg->translate.key.output_stride;
    char *vert = output_buffer;
    unsigned i;
 
+   /* Linear runs fetch the attribs with a row function one attrib at a
+    * time over all vertices, the per-vertex loop only handles the rest.
+    */
+   for (i = 0; i < tg->nr_attrib && tg->nr_row_attrib; i++) {
+      if (!tg->attrib[i].fetch_row)
+         continue;
+
+      tg->attrib[i].fetch_row((uint8_t *)vert + tg->attrib[i].output_offset,
+                              stride,
+                              tg->attrib[i].input_ptr +
+                              (ptrdiff_t)tg->attrib[i].input_stride * start,
+                              tg->attrib[i].input_stride, count);
+   }
+
+   if (tg->nr_row_attrib == tg->nr_attrib)
+      return;
+
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, start + i, start_instance, instance_id, vert, 0);
-      vert += tg->translate.key.output_stride;
+      generic_run_one(tg, start + i, start_instance, instance_id, vert, 0,
+                      tg->nr_row_attrib != 0);
+      vert += stride;
    }
 }
 
@@ -839,6 +1016,10 @@ translate_generic_create(const struct translate_key *key)
          tg->attrib[i].emit = get_emit_func(key->element[i].output_format);
       else
          tg->attrib[i].emit  = NULL;
+
+      tg->attrib[i].fetch_row = get_fetch_row_func(&key->element[i]);
+      if (tg->attrib[i].fetch_row)
+         tg->nr_row_attrib++;
    }
 
    tg->nr_attrib = key->nr_elements;
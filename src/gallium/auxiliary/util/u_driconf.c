@@ -61,6 +61,7 @@ u_driconf_fill_st_options(struct st_config_options *options,
    query_bool_option(vs_position_always_invariant);
    query_bool_option(vs_position_always_precise);
    query_bool_option(force_glsl_abs_sqrt);
+   query_bool_option(glsl_es_skip_ir_optimizations);
    query_bool_option(allow_glsl_cross_stage_interpolation_mismatch);
    query_bool_option(do_dce_before_clip_cull_analysis);
    query_bool_option(allow_draw_out_of_order);
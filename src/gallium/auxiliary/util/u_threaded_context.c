@@ -553,6 +553,20 @@ tc_update_batch_generation(struct threaded_context *tc, struct tc_batch *next)
    assert(next->batch_idx >= 0 && next->batch_idx < INT8_MAX);
 }
 
+/* Submits the copies offloaded to the helper context since the last flush.
+ * The unflushed batch waits for them, so this must be called before it's
+ * executed.
+ */
+static void
+tc_flush_helper(struct threaded_context *tc)
+{
+   if (!tc->helper_fence)
+      return;
+
+   tc->helper->flush(tc->helper, tc->helper_fence, PIPE_FLUSH_ASYNC);
+   tc->helper_fence = NULL;
+}
+
 static void
 tc_batch_flush(struct threaded_context *tc, bool full_copy)
 {
@@ -571,6 +585,22 @@ tc_batch_flush(struct threaded_context *tc, bool full_copy)
    tc->bytes_mapped_estimate = 0;
    tc->bytes_replaced_estimate = 0;
    p_atomic_add(&tc->num_offloaded_slots, next->num_total_slots);
+   p_atomic_inc(&tc->num_batches);
+   /* Exponential moving average with a weight of 1/8 for the new batch. */
+   p_atomic_set(&tc->batch_fill_percent,
+                (tc->batch_fill_percent * 7 +
+                 next->num_total_slots * 100 / TC_SLOTS_PER_BATCH) / 8);
+
+   if (tc->adaptive_batches) {
+      /* If the driver thread has already executed the previous batch, it's
+       * waiting for work, so flush sooner. Otherwise, make batches bigger to
+       * amortize the queuing overhead.
+       */
+      if (util_queue_fence_is_signalled(&tc->batch_slots[tc->last].fence))
+         tc->batch_flush_slots = MAX2(tc->batch_flush_slots / 2, TC_MIN_SLOTS_PER_BATCH);
+      else
+         tc->batch_flush_slots = MIN2(tc->batch_flush_slots * 2, TC_SLOTS_PER_BATCH);
+   }
 
    if (next->token) {
       next->token->tc = NULL;
@@ -587,8 +617,15 @@ tc_batch_flush(struct threaded_context *tc, bool full_copy)
    }
 
    tc_update_batch_generation(tc, next);
+   tc_flush_helper(tc);
+
+   /* This blocks if all batches are queued, which is the backpressure from
+    * the driver thread.
+    */
+   int64_t start = os_time_get_nano();
    util_queue_add_job(&tc->queue, next, &next->fence, tc_batch_execute,
                       NULL, 0);
+   p_atomic_add(&tc->sync_wait_time_ns, os_time_get_nano() - start);
    tc->last = tc->next;
    tc->next = next_id;
    tc_begin_next_buffer_list(tc);
@@ -608,7 +645,8 @@ tc_add_sized_call(struct threaded_context *tc, enum tc_call_id id,
    assert(num_slots <= TC_SLOTS_PER_BATCH - 1);
    tc_debug_check(tc);
 
-   if (unlikely(next->num_total_slots + num_slots + resv_slots > TC_SLOTS_PER_BATCH - 1)) {
+   if (unlikely(next->num_total_slots + num_slots + resv_slots > TC_SLOTS_PER_BATCH - 1 ||
+                next->num_total_slots >= tc->batch_flush_slots)) {
       /* copy existing renderpass info during flush */
       tc_batch_flush(tc, full_copy);
       tc->seen_fb_state = false;
@@ -715,7 +753,8 @@ tc_is_sync(struct threaded_context *tc)
 }
 
 static void
-_tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char *func)
+_tc_sync(struct threaded_context *tc, enum tc_sync_reason reason,
+         UNUSED const char *info, UNUSED const char *func)
 {
    struct tc_batch *last = &tc->batch_slots[tc->last];
    struct tc_batch *next = &tc->batch_slots[tc->next];
@@ -741,7 +780,9 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
 
    /* Only wait for queued calls... */
    if (!util_queue_fence_is_signalled(&last->fence)) {
+      int64_t start = os_time_get_nano();
       util_queue_fence_wait(&last->fence);
+      p_atomic_add(&tc->sync_wait_time_ns, os_time_get_nano() - start);
       synced = true;
    }
 
@@ -754,6 +795,7 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
 
    /* .. and execute unflushed calls directly. */
    if (next->num_total_slots) {
+      tc_flush_helper(tc);
       p_atomic_add(&tc->num_direct_slots, next->num_total_slots);
       tc->bytes_mapped_estimate = 0;
       tc->bytes_replaced_estimate = 0;
@@ -766,6 +808,7 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
 
    if (synced) {
       p_atomic_inc(&tc->num_syncs);
+      p_atomic_inc(&tc->num_syncs_by_reason[reason]);
 
       if (tc_strcmp(func, "tc_destroy") != 0) {
          tc_printf("sync %s %s", func, info);
@@ -793,8 +836,9 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
    }
 }
 
-#define tc_sync(tc) _tc_sync(tc, "", __func__)
-#define tc_sync_msg(tc, info) _tc_sync(tc, info, __func__)
+#define tc_sync(tc) _tc_sync(tc, TC_SYNC_OTHER, "", __func__)
+#define tc_sync_msg(tc, info) _tc_sync(tc, TC_SYNC_OTHER, info, __func__)
+#define tc_sync_reason(tc, reason, info) _tc_sync(tc, reason, info, __func__)
 
 /**
  * Call this from fence_finish for same-context fence waits of deferred fences
@@ -820,7 +864,7 @@ threaded_context_flush(struct pipe_context *_pipe,
       if (prefer_async || !util_queue_fence_is_signalled(&last->fence))
          tc_batch_flush(tc, false);
       else
-         tc_sync(token->tc);
+         tc_sync_reason(token->tc, TC_SYNC_FLUSH, "");
    }
 }
 
@@ -1306,7 +1350,7 @@ tc_get_query_result(struct pipe_context *_pipe,
    bool flushed = tq->flushed;
 
    if (!flushed) {
-      tc_sync_msg(tc, wait ? "wait" : "nowait");
+      tc_sync_reason(tc, TC_SYNC_QUERY, wait ? "wait" : "nowait");
       tc_set_driver_thread(tc);
    }
 
@@ -1714,6 +1758,18 @@ tc_set_constant_buffer(struct pipe_context *_pipe,
    }
    struct pipe_resource *buffer = cb->buffer;
    unsigned offset = cb->buffer_offset;
+   uint32_t *bound_id = &tc->const_buffers[shader][index];
+
+   /* Skip binding the same range again, so that the draws before and after
+    * this can be merged. Buffer IDs aren't reused while the driver keeps the
+    * buffer bound. Slot 0 is excluded because binding it also invalidates
+    * inlinable constants.
+    */
+   if (index > 0 && buffer && *bound_id &&
+       *bound_id == threaded_resource(buffer)->buffer_id_unique &&
+       tc->const_buffer_offsets[shader][index] == offset &&
+       tc->const_buffer_sizes[shader][index] == cb->buffer_size)
+      return;
 
    struct tc_constant_buffer *p =
       tc_add_call(tc, TC_CALL_set_constant_buffer, tc_constant_buffer);
@@ -1726,10 +1782,11 @@ tc_set_constant_buffer(struct pipe_context *_pipe,
    p->cb.buffer = buffer;
 
    if (buffer) {
-      tc_bind_buffer(&tc->const_buffers[shader][index],
-                     &tc->buffer_lists[tc->next_buf_list], buffer);
+      tc_bind_buffer(bound_id, &tc->buffer_lists[tc->next_buf_list], buffer);
+      tc->const_buffer_offsets[shader][index] = offset;
+      tc->const_buffer_sizes[shader][index] = cb->buffer_size;
    } else {
-      tc_unbind_buffer(&tc->const_buffers[shader][index]);
+      tc_unbind_buffer(bound_id);
    }
 }
 
@@ -2768,7 +2825,7 @@ tc_buffer_map(struct pipe_context *_pipe,
             unsigned valid_range_len = tres->valid_buffer_range.end - tres->valid_buffer_range.start;
             u_box_1d(tres->valid_buffer_range.start, valid_range_len, &box2);
 
-            tc_sync_msg(tc, "cpu storage GPU -> CPU copy");
+            tc_sync_reason(tc, TC_SYNC_MAP, "cpu storage GPU -> CPU copy");
             tc_set_driver_thread(tc);
 
             void *ret = pipe->buffer_map(pipe, tres->latest ? tres->latest : resource,
@@ -2845,8 +2902,14 @@ tc_buffer_map(struct pipe_context *_pipe,
 
    /* Unsychronized buffer mappings don't have to synchronize the thread. */
    if (!(usage & TC_TRANSFER_MAP_THREADED_UNSYNC)) {
-      tc_sync_msg(tc, usage & PIPE_MAP_DISCARD_RANGE ? "  discard_range" :
-                      usage & PIPE_MAP_READ ? "  read" : "  staging conflict");
+      /* Waiting for the driver thread is blocking too. */
+      if (usage & PIPE_MAP_DONTBLOCK) {
+         *transfer = NULL;
+         return NULL;
+      }
+
+      tc_sync_reason(tc, TC_SYNC_MAP, usage & PIPE_MAP_DISCARD_RANGE ? "  discard_range" :
+                                      usage & PIPE_MAP_READ ? "  read" : "  staging conflict");
       tc_set_driver_thread(tc);
    }
 
@@ -2882,7 +2945,7 @@ tc_texture_map(struct pipe_context *_pipe,
    if (is_internal_unsynchronized) {
       usage |= TC_TRANSFER_MAP_THREADED_UNSYNC;
    } else {
-      tc_sync_msg(tc, "texture");
+      tc_sync_reason(tc, TC_SYNC_MAP, "texture");
       tc_set_driver_thread(tc);
       /* block all unsync texture subdata during map */
       tc_set_resource_batch_usage_persistent(tc, resource, true);
@@ -3338,7 +3401,7 @@ tc_texture_subdata(struct pipe_context *_pipe,
          if (can_unsync) {
             usage |= unsync_usage;
          } else {
-            tc_sync(tc);
+            tc_sync_reason(tc, TC_SYNC_MAP, "texture subdata");
             tc_set_driver_thread(tc);
          }
          pipe->texture_subdata(pipe, resource, level, usage, box, data,
@@ -3503,8 +3566,11 @@ tc_call_fence_server_sync(struct pipe_context *pipe, void *call)
    struct tc_fence_call *p = (void*)to_call(call, tc_fence_call);
    struct pipe_fence_handle *fence = p->fence;
 
-   pipe->fence_server_sync(pipe, fence, p->value);
-   pipe->screen->fence_reference(pipe->screen, &fence, NULL);
+   /* The wait for the helper context has no fence if it didn't return one. */
+   if (fence) {
+      pipe->fence_server_sync(pipe, fence, p->value);
+      pipe->screen->fence_reference(pipe->screen, &fence, NULL);
+   }
    return call_size(tc_fence_call);
 }
 
@@ -3717,8 +3783,8 @@ tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
 out_of_memory:
    tc->flushing = true;
    /* renderpass info is signaled during sync */
-   tc_sync_msg(tc, flags & PIPE_FLUSH_END_OF_FRAME ? "end of frame" :
-                   flags & PIPE_FLUSH_DEFERRED ? "deferred fence" : "normal");
+   tc_sync_reason(tc, TC_SYNC_FLUSH, flags & PIPE_FLUSH_END_OF_FRAME ? "end of frame" :
+                                       flags & PIPE_FLUSH_DEFERRED ? "deferred fence" : "normal");
 
    if (!deferred) {
       tc_flush_queries(tc);
@@ -4541,6 +4607,49 @@ tc_call_resource_copy_region(struct pipe_context *pipe, void *call)
    return call_size(tc_resource_copy_region);
 }
 
+/* Executes a buffer copy on the helper context if no queued work uses the
+ * destination or writes the source, so the driver thread doesn't have to.
+ * Later calls wait for the helper through a fence_server_sync call.
+ */
+static bool
+tc_offload_buffer_copy(struct threaded_context *tc,
+                       struct pipe_resource *dst, unsigned dstx,
+                       struct pipe_resource *src, const struct pipe_box *src_box)
+{
+   struct threaded_resource *tdst = threaded_resource(dst);
+   struct threaded_resource *tsrc = threaded_resource(src);
+
+   if (dst->target != PIPE_BUFFER || src->target != PIPE_BUFFER ||
+       tdst->is_user_ptr || tsrc->is_user_ptr ||
+       tc_is_buffer_busy(tc, tdst, PIPE_MAP_READ_WRITE) ||
+       tc_is_buffer_busy(tc, tsrc, PIPE_MAP_READ))
+      return false;
+
+   if (!tc->helper_fence) {
+      struct tc_fence_call *call = tc_add_call(tc, TC_CALL_fence_server_sync,
+                                               tc_fence_call);
+      call->fence = NULL;
+      call->value = 0;
+      tc->helper_fence = &call->fence;
+   }
+
+   /* Like direct mappings, use the latest storage of invalidated buffers. */
+   tc->helper->resource_copy_region(tc->helper, tdst->latest, 0, dstx, 0, 0,
+                                    tsrc->latest, 0, src_box);
+
+   /* The driver doesn't know that the helper uses the buffers until it's
+    * flushed, so keep them busy until the batch waiting for it is done.
+    */
+   struct tc_buffer_list *next = &tc->buffer_lists[tc->next_buf_list];
+   tc_add_to_buffer_list(next, src);
+   tc_add_to_buffer_list(next, dst);
+
+   tc_buffer_disable_cpu_storage(dst);
+   util_range_add(&tdst->b, &tdst->valid_buffer_range,
+                  dstx, dstx + src_box->width);
+   return true;
+}
+
 static void
 tc_resource_copy_region(struct pipe_context *_pipe,
                         struct pipe_resource *dst, unsigned dst_level,
@@ -4550,6 +4659,10 @@ tc_resource_copy_region(struct pipe_context *_pipe,
 {
    struct threaded_context *tc = threaded_context(_pipe);
    struct threaded_resource *tdst = threaded_resource(dst);
+
+   if (tc->helper && tc_offload_buffer_copy(tc, dst, dstx, src, src_box))
+      return;
+
    struct tc_resource_copy_region *p =
       tc_add_call(tc, TC_CALL_resource_copy_region,
                   tc_resource_copy_region);
@@ -5106,7 +5219,7 @@ tc_get_intel_perf_query_info(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* n_active vs begin/end_intel_perf_query */
+   tc_sync_reason(tc, TC_SYNC_QUERY, ""); /* n_active vs begin/end_intel_perf_query */
    pipe->get_intel_perf_query_info(pipe, query_index, name, data_size,
          n_counters, n_active);
 }
@@ -5178,7 +5291,7 @@ tc_delete_intel_perf_query(struct pipe_context *_pipe, struct pipe_query *q)
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync_reason(tc, TC_SYNC_QUERY, ""); /* flush potentially pending begin/end_intel_perf_queries */
    pipe->delete_intel_perf_query(pipe, q);
 }
 
@@ -5188,7 +5301,7 @@ tc_wait_intel_perf_query(struct pipe_context *_pipe, struct pipe_query *q)
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync_reason(tc, TC_SYNC_QUERY, ""); /* flush potentially pending begin/end_intel_perf_queries */
    pipe->wait_intel_perf_query(pipe, q);
 }
 
@@ -5198,7 +5311,7 @@ tc_is_intel_perf_query_ready(struct pipe_context *_pipe, struct pipe_query *q)
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync_reason(tc, TC_SYNC_QUERY, ""); /* flush potentially pending begin/end_intel_perf_queries */
    return pipe->is_intel_perf_query_ready(pipe, q);
 }
 
@@ -5212,7 +5325,7 @@ tc_get_intel_perf_query_data(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync_reason(tc, TC_SYNC_QUERY, ""); /* flush potentially pending begin/end_intel_perf_queries */
    return pipe->get_intel_perf_query_data(pipe, q, data_size, data, bytes_written);
 }
 
@@ -5430,6 +5543,9 @@ tc_destroy(struct pipe_context *_pipe)
 
    tc_sync(tc);
 
+   if (tc->helper)
+      tc->helper->destroy(tc->helper);
+
    if (util_queue_is_initialized(&tc->queue)) {
       util_queue_destroy(&tc->queue);
 
@@ -5528,6 +5644,12 @@ threaded_context_create(struct pipe_context *pipe,
       pipe->screen->caps.min_map_buffer_alignment;
    tc->ubo_alignment =
       MAX2(pipe->screen->caps.constant_buffer_offset_alignment, 64);
+   tc->adaptive_batches =
+      debug_get_bool_option("GALLIUM_THREAD_ADAPTIVE_BATCHES", false);
+   tc->batch_flush_slots = TC_SLOTS_PER_BATCH;
+   if (tc->options.create_helper_context &&
+       debug_get_bool_option("GALLIUM_THREAD_OFFLOAD_COPIES", false))
+      tc->helper = tc->options.create_helper_context(pipe->screen);
    tc->base.priv = pipe; /* priv points to the wrapped driver context */
    tc->base.screen = pipe->screen;
    tc->base.destroy = tc_destroy;
@@ -5542,6 +5664,13 @@ threaded_context_create(struct pipe_context *pipe,
    if (!tc->base.stream_uploader || !tc->base.const_uploader)
       goto fail;
 
+   /* Idle upload buffers can be detected without syncing, so reuse them. */
+   if (tc->options.is_resource_busy) {
+      u_upload_enable_ring(tc->base.stream_uploader);
+      if (tc->base.const_uploader != tc->base.stream_uploader)
+         u_upload_enable_ring(tc->base.const_uploader);
+   }
+
    tc->use_forced_staging_uploads = true;
 
    /* The queue size is the number of batches "waiting". Batches are removed
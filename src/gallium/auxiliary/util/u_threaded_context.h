@@ -257,6 +257,14 @@ struct tc_unflushed_batch_token;
  */
 #define TC_SLOTS_PER_BATCH    1536
 
+/* The smallest batch size used when adaptive batch sizing is enabled with
+ * GALLIUM_THREAD_ADAPTIVE_BATCHES.  If the driver thread is idle when a batch
+ * is flushed, the flush threshold is halved down to this value, so that light
+ * apps don't wait for a full batch before the driver starts working.  If the
+ * driver thread is busy, the threshold is doubled up to TC_SLOTS_PER_BATCH.
+ */
+#define TC_MIN_SLOTS_PER_BATCH 192
+
 /* The buffer list queue is much deeper than the batch queue because buffer
  * lists need to stay around until the driver internally flushes its command
  * buffer.
@@ -571,6 +579,23 @@ struct threaded_context_options {
     */
    void (*dsa_parse)(void *state, struct tc_renderpass_info *info);
    void (*fs_parse)(void *state, struct tc_renderpass_info *info);
+
+   /**
+    * Optional. Creates a context which GALLIUM_THREAD_OFFLOAD_COPIES uses to
+    * execute buffer copies that don't depend on queued work directly from
+    * the frontend thread. pipe_context::fence_server_sync of the wrapped
+    * context must be able to wait for the fences of this context.
+    */
+   struct pipe_context *(*create_helper_context)(struct pipe_screen *screen);
+};
+
+/* Why the frontend thread had to wait for the driver thread. */
+enum tc_sync_reason {
+   TC_SYNC_FLUSH,
+   TC_SYNC_MAP,
+   TC_SYNC_QUERY,
+   TC_SYNC_OTHER,
+   TC_NUM_SYNC_REASONS,
 };
 
 struct tc_vertex_buffers {
@@ -594,6 +619,25 @@ struct threaded_context {
    unsigned num_offloaded_slots;
    unsigned num_direct_slots;
    unsigned num_syncs;
+   unsigned num_syncs_by_reason[TC_NUM_SYNC_REASONS];
+   unsigned num_batches;
+   /* Average batch fill ratio in percent of TC_SLOTS_PER_BATCH. */
+   unsigned batch_fill_percent;
+   /* Time the frontend thread spent waiting for the driver thread. */
+   uint64_t sync_wait_time_ns;
+
+   /* Number of slots after which a batch is flushed early, see
+    * TC_MIN_SLOTS_PER_BATCH.
+    */
+   unsigned batch_flush_slots;
+   bool adaptive_batches;
+
+   /* Context executing offloaded buffer copies, see tc_offload_buffer_copy. */
+   struct pipe_context *helper;
+   /* Fence of the wait for the helper in the unflushed batch. It's filled
+    * when the helper is flushed together with the batch.
+    */
+   struct pipe_fence_handle **helper_fence;
 
    bool use_forced_staging_uploads;
    bool add_all_gfx_bindings_to_buffer_list;
@@ -678,6 +722,11 @@ struct threaded_context {
    uint32_t shader_buffers_writeable_mask[MESA_SHADER_MESH_STAGES];
    uint64_t image_buffers_writeable_mask[MESA_SHADER_MESH_STAGES];
    uint32_t sampler_buffers[MESA_SHADER_MESH_STAGES][PIPE_MAX_SHADER_SAMPLER_VIEWS];
+   /* Ranges of const_buffers, used to skip redundant rebinds, which would
+    * prevent merging the draws around them.
+    */
+   uint32_t const_buffer_offsets[MESA_SHADER_MESH_STAGES][PIPE_MAX_CONSTANT_BUFFERS];
+   uint32_t const_buffer_sizes[MESA_SHADER_MESH_STAGES][PIPE_MAX_CONSTANT_BUFFERS];
 
    struct tc_batch batch_slots[TC_MAX_BATCHES];
    struct tc_buffer_list buffer_lists[TC_MAX_BUFFER_LISTS];
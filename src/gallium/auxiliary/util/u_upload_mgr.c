@@ -38,6 +38,9 @@
 #include "u_upload_mgr.h"
 
 
+/* Number of filled upload buffers kept for reuse in ring mode. */
+#define U_UPLOAD_RING_SIZE 3
+
 struct u_upload_mgr {
    struct pipe_context *pipe;
 
@@ -54,6 +57,12 @@ struct u_upload_mgr {
    unsigned buffer_size; /* Same as buffer->width0. */
    unsigned offset; /* Aligned offset to the upload buffer, pointing
                      * at the first unused byte. */
+   /* Ring mode: filled buffers, oldest first, reused once the GPU is done
+    * with them instead of allocating new buffers.
+    */
+   bool ring;
+   unsigned num_ring_buffers;
+   struct pipe_resource *ring_buffers[U_UPLOAD_RING_SIZE];
 };
 
 
@@ -107,6 +116,8 @@ u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload)
                                                  upload->flags);
    if (!upload->map_persistent && result->map_persistent)
       u_upload_disable_persistent(result);
+   if (upload->ring)
+      u_upload_enable_ring(result);
 
    return result;
 }
@@ -119,6 +130,12 @@ u_upload_disable_persistent(struct u_upload_mgr *upload)
    upload->map_flags |= PIPE_MAP_FLUSH_EXPLICIT;
 }
 
+void
+u_upload_enable_ring(struct u_upload_mgr *upload)
+{
+   upload->ring = true;
+}
+
 static void
 upload_unmap_internal(struct u_upload_mgr *upload, bool destroying)
 {
@@ -157,11 +174,66 @@ u_upload_release_buffer(struct u_upload_mgr *upload)
 void
 u_upload_destroy(struct u_upload_mgr *upload)
 {
+   for (unsigned i = 0; i < upload->num_ring_buffers; i++)
+      pipe_resource_release(upload->pipe, upload->ring_buffers[i]);
+
    u_upload_release_buffer(upload);
    pipe_resource_release(upload->pipe, upload->buffer);
    FREE(upload);
 }
 
+/* In ring mode, the old buffer is kept instead of released. The oldest kept
+ * buffer becomes the upload buffer again if mapping it doesn't block, i.e.
+ * the GPU is done with it. Returns whether it was reused.
+ */
+static bool
+u_upload_reuse_ring_buffer(struct u_upload_mgr *upload, unsigned size,
+                           struct pipe_resource **releasebuf)
+{
+   struct pipe_resource *old = *releasebuf;
+   struct pipe_resource *oldest = NULL;
+
+   if (upload->num_ring_buffers) {
+      oldest = upload->ring_buffers[0];
+
+      if (oldest->width0 >= size) {
+         unsigned map_flags = (upload->map_flags & ~PIPE_MAP_UNSYNCHRONIZED) |
+                              PIPE_MAP_DONTBLOCK;
+
+         upload->map = pipe_buffer_map_range(upload->pipe, oldest, 0,
+                                             oldest->width0, map_flags,
+                                             &upload->transfer);
+         if (upload->map == NULL)
+            upload->transfer = NULL;
+      }
+   }
+
+   /* Drop the oldest buffer if it's reused or if there is no room for the
+    * old one.
+    */
+   if (upload->map || (old && upload->num_ring_buffers == U_UPLOAD_RING_SIZE)) {
+      upload->num_ring_buffers--;
+      memmove(upload->ring_buffers, upload->ring_buffers + 1,
+              upload->num_ring_buffers * sizeof(upload->ring_buffers[0]));
+   } else {
+      oldest = NULL;
+   }
+
+   if (old)
+      upload->ring_buffers[upload->num_ring_buffers++] = old;
+
+   if (!upload->map) {
+      *releasebuf = oldest;
+      return false;
+   }
+
+   *releasebuf = NULL;
+   upload->buffer = oldest;
+   upload->buffer_size = oldest->width0;
+   upload->offset = 0;
+   return true;
+}
+
 /* Return the allocated buffer size or 0 if it failed. */
 static unsigned
 u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size, struct pipe_resource **releasebuf)
@@ -176,9 +248,13 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size, struct pip
    *releasebuf = upload->buffer;
    upload->buffer = NULL;
 
+   size = align(MAX2(upload->default_size, min_size), 4096);
+
+   if (upload->ring && u_upload_reuse_ring_buffer(upload, size, releasebuf))
+      return upload->buffer_size;
+
    /* Allocate a new one:
     */
-   size = align(MAX2(upload->default_size, min_size), 4096);
 
    memset(&buffer, 0, sizeof buffer);
    buffer.target = PIPE_BUFFER;
@@ -73,6 +73,14 @@ u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload);
 void
 u_upload_disable_persistent(struct u_upload_mgr *upload);
 
+/**
+ * Keep filled upload buffers and reuse them once they are idle instead of
+ * allocating new buffers. Whether a buffer is idle is checked by mapping it
+ * with PIPE_MAP_DONTBLOCK.
+ */
+void
+u_upload_enable_ring(struct u_upload_mgr *upload);
+
 /**
  * Destroy the upload manager.
  */
@@ -87,6 +87,11 @@
 
 #include "util/u_vbuf.h"
 
+#include "util/detect_arch.h"
+#if DETECT_ARCH_AARCH64
+#include <arm_neon.h>
+#endif
+
 #include "util/u_dump.h"
 #include "util/format/u_format.h"
 #include "util/u_helpers.h"
@@ -368,6 +373,7 @@ u_vbuf_create(struct pipe_context *pipe, struct u_vbuf_caps *caps)
       cfg.fixed_prim_restart = caps->rewrite_restart_index;
       cfg.primtypes_mask = caps->supported_prim_modes;
       cfg.restart_primtypes_mask = caps->supported_restart_modes;
+      cfg.cache_static_indices = true;
       mgr->pc = util_primconvert_create_config(pipe, &cfg);
    }
    mgr->translate_cache = translate_cache_create();
@@ -1274,6 +1280,115 @@ static bool u_vbuf_mapping_vertex_buffer_blocks(const struct u_vbuf *mgr, uint32
             mgr->ve->nonzero_stride_vb_mask)) != 0;
 }
 
+/* Restart indices are mapped to values that can't affect the result, which
+ * keeps the loops free of branches so that the compiler can vectorize them.
+ */
+#define MINMAX_SCALAR(bits)                                                   \
+static void                                                                   \
+minmax_scalar_u##bits(const uint##bits##_t *indices, unsigned count,          \
+                      bool restart, uint##bits##_t restart_index,             \
+                      uint##bits##_t *inout_min, uint##bits##_t *inout_max)   \
+{                                                                             \
+   uint##bits##_t min = *inout_min, max = *inout_max;                         \
+                                                                              \
+   if (restart) {                                                             \
+      for (unsigned i = 0; i < count; i++) {                                  \
+         uint##bits##_t skip = indices[i] == restart_index ? ~0 : 0;          \
+         uint##bits##_t lo = indices[i] | skip;                               \
+         uint##bits##_t hi = indices[i] & ~skip;                              \
+         min = MIN2(min, lo);                                                 \
+         max = MAX2(max, hi);                                                 \
+      }                                                                       \
+   } else {                                                                   \
+      for (unsigned i = 0; i < count; i++) {                                  \
+         min = MIN2(min, indices[i]);                                         \
+         max = MAX2(max, indices[i]);                                         \
+      }                                                                       \
+   }                                                                          \
+                                                                              \
+   *inout_min = min;                                                          \
+   *inout_max = max;                                                          \
+}
+
+MINMAX_SCALAR(8)
+MINMAX_SCALAR(16)
+MINMAX_SCALAR(32)
+
+#if DETECT_ARCH_AARCH64
+/* Scans 4 vectors per iteration with independent accumulators, and leaves the
+ * tail to the scalar loop.
+ */
+#define MINMAX_NEON(bits, lanes)                                              \
+static unsigned                                                               \
+minmax_neon_u##bits(const uint##bits##_t *indices, unsigned count,            \
+                    bool restart, uint##bits##_t restart_index,               \
+                    uint##bits##_t *out_min, uint##bits##_t *out_max)         \
+{                                                                             \
+   const unsigned step = 4 * lanes;                                           \
+   uint##bits##x##lanes##_t min[4], max[4];                                   \
+   uint##bits##x##lanes##_t restart_vec = vdupq_n_u##bits(restart_index);     \
+   unsigned i;                                                                \
+                                                                              \
+   for (unsigned j = 0; j < 4; j++) {                                         \
+      min[j] = vdupq_n_u##bits((uint##bits##_t)~0);                           \
+      max[j] = vdupq_n_u##bits(0);                                            \
+   }                                                                          \
+                                                                              \
+   for (i = 0; i + step <= count; i += step) {                                \
+      for (unsigned j = 0; j < 4; j++) {                                      \
+         uint##bits##x##lanes##_t v =                                         \
+            vld1q_u##bits(indices + i + j * lanes);                           \
+         if (restart) {                                                       \
+            uint##bits##x##lanes##_t skip = vceqq_u##bits(v, restart_vec);    \
+            min[j] = vminq_u##bits(min[j], vorrq_u##bits(v, skip));           \
+            max[j] = vmaxq_u##bits(max[j], vbicq_u##bits(v, skip));           \
+         } else {                                                             \
+            min[j] = vminq_u##bits(min[j], v);                                \
+            max[j] = vmaxq_u##bits(max[j], v);                                \
+         }                                                                    \
+      }                                                                       \
+   }                                                                          \
+                                                                              \
+   min[0] = vminq_u##bits(vminq_u##bits(min[0], min[1]),                      \
+                          vminq_u##bits(min[2], min[3]));                     \
+   max[0] = vmaxq_u##bits(vmaxq_u##bits(max[0], max[1]),                      \
+                          vmaxq_u##bits(max[2], max[3]));                     \
+   *out_min = vminvq_u##bits(min[0]);                                         \
+   *out_max = vmaxvq_u##bits(max[0]);                                         \
+                                                                              \
+   return i;                                                                  \
+}
+
+MINMAX_NEON(8, 16)
+MINMAX_NEON(16, 8)
+MINMAX_NEON(32, 4)
+#endif
+
+#if DETECT_ARCH_AARCH64
+#define MINMAX_CASE(bits)                                                     \
+   case bits / 8: {                                                           \
+      const uint##bits##_t *ind = (const uint##bits##_t *)indices;            \
+      uint##bits##_t min, max;                                                \
+      unsigned done = minmax_neon_u##bits(ind, count, restart,                \
+                                          info->restart_index, &min, &max);   \
+      minmax_scalar_u##bits(ind + done, count - done, restart,                \
+                            info->restart_index, &min, &max);                 \
+      *out_min_index = min;                                                   \
+      *out_max_index = max;                                                   \
+      break;                                                                  \
+   }
+#else
+#define MINMAX_CASE(bits)                                                     \
+   case bits / 8: {                                                           \
+      uint##bits##_t min = ~0, max = 0;                                       \
+      minmax_scalar_u##bits((const uint##bits##_t *)indices, count, restart,  \
+                            info->restart_index, &min, &max);                 \
+      *out_min_index = min;                                                   \
+      *out_max_index = max;                                                   \
+      break;                                                                  \
+   }
+#endif
+
 static void
 u_vbuf_get_minmax_index_mapped(const struct pipe_draw_info *info,
                                unsigned count,
@@ -1286,78 +1401,21 @@ u_vbuf_get_minmax_index_mapped(const struct pipe_draw_info *info,
       return;
    }
 
+   /* A restart index that doesn't fit in the index type never matches. */
+   bool restart = info->primitive_restart &&
+                  info->restart_index <= u_uintN_max(info->index_size * 8);
+
    switch (info->index_size) {
-   case 4: {
-      const unsigned *ui_indices = (const unsigned*)indices;
-      unsigned max = 0;
-      unsigned min = ~0u;
-      if (info->primitive_restart) {
-         for (unsigned i = 0; i < count; i++) {
-            if (ui_indices[i] != info->restart_index) {
-               if (ui_indices[i] > max) max = ui_indices[i];
-               if (ui_indices[i] < min) min = ui_indices[i];
-            }
-         }
-      }
-      else {
-         for (unsigned i = 0; i < count; i++) {
-            if (ui_indices[i] > max) max = ui_indices[i];
-            if (ui_indices[i] < min) min = ui_indices[i];
-         }
-      }
-      *out_min_index = min;
-      *out_max_index = max;
-      break;
-   }
-   case 2: {
-      const unsigned short *us_indices = (const unsigned short*)indices;
-      unsigned short max = 0;
-      unsigned short min = ~((unsigned short)0);
-      if (info->primitive_restart) {
-         for (unsigned i = 0; i < count; i++) {
-            if (us_indices[i] != info->restart_index) {
-               if (us_indices[i] > max) max = us_indices[i];
-               if (us_indices[i] < min) min = us_indices[i];
-            }
-         }
-      }
-      else {
-         for (unsigned i = 0; i < count; i++) {
-            if (us_indices[i] > max) max = us_indices[i];
-            if (us_indices[i] < min) min = us_indices[i];
-         }
-      }
-      *out_min_index = min;
-      *out_max_index = max;
-      break;
-   }
-   case 1: {
-      const unsigned char *ub_indices = (const unsigned char*)indices;
-      unsigned char max = 0;
-      unsigned char min = ~((unsigned char)0);
-      if (info->primitive_restart) {
-         for (unsigned i = 0; i < count; i++) {
-            if (ub_indices[i] != info->restart_index) {
-               if (ub_indices[i] > max) max = ub_indices[i];
-               if (ub_indices[i] < min) min = ub_indices[i];
-            }
-         }
-      }
-      else {
-         for (unsigned i = 0; i < count; i++) {
-            if (ub_indices[i] > max) max = ub_indices[i];
-            if (ub_indices[i] < min) min = ub_indices[i];
-         }
-      }
-      *out_min_index = min;
-      *out_max_index = max;
-      break;
-   }
+   MINMAX_CASE(32)
+   MINMAX_CASE(16)
+   MINMAX_CASE(8)
    default:
       UNREACHABLE("bad index size");
    }
 }
 
+#undef MINMAX_CASE
+
 void u_vbuf_get_minmax_index(struct pipe_context *pipe,
                              const struct pipe_draw_info *info,
                              const struct pipe_draw_start_count_bias *draw,
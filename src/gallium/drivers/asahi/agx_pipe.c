@@ -32,6 +32,7 @@
 #include "util/macros.h"
 #include "util/simple_mtx.h"
 #include "util/timespec.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_drm.h"
 #include "util/u_gen_mipmap.h"
 #include "util/u_helpers.h"
@@ -1000,8 +1001,10 @@ agx_transfer_map(struct pipe_context *pctx, struct pipe_resource *resource,
             uint8_t *dst =
                (uint8_t *)transfer->map + transfer->base.layer_stride * z;
 
-            ail_detile(map, dst, &rsrc->layout, level, transfer->base.stride,
-                       box->x, box->y, box->width, box->height);
+            ail_detile_threaded(map, dst, &rsrc->layout, level,
+                                transfer->base.stride, box->x, box->y,
+                                box->width, box->height,
+                                util_get_cpu_caps()->nr_cpus);
          }
       }
 
@@ -1049,9 +1052,10 @@ agx_transfer_unmap(struct pipe_context *pctx, struct pipe_transfer *transfer)
             agx_map_texture_cpu(rsrc, transfer->level, transfer->box.z + z);
          uint8_t *src = (uint8_t *)trans->map + transfer->layer_stride * z;
 
-         ail_tile(map, src, &rsrc->layout, transfer->level, transfer->stride,
-                  transfer->box.x, transfer->box.y, transfer->box.width,
-                  transfer->box.height);
+         ail_tile_threaded(map, src, &rsrc->layout, transfer->level,
+                           transfer->stride, transfer->box.x, transfer->box.y,
+                           transfer->box.width, transfer->box.height,
+                           util_get_cpu_caps()->nr_cpus);
       }
    }
 
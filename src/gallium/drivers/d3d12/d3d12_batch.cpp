@@ -75,18 +75,12 @@ d3d12_init_batch(struct d3d12_context *ctx, struct d3d12_batch *batch)
       batch->queries = _mesa_set_create(NULL, _mesa_hash_pointer,
                                         _mesa_key_pointer_equal);
 
-      batch->view_heap =
-         d3d12_descriptor_heap_new(screen->dev,
-                                    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
-                                    D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
-                                    8096);
-
       batch->sampler_tables = _mesa_hash_table_create(NULL, d3d12_sampler_desc_table_key_hash,
                                                       d3d12_sampler_desc_table_key_equals);
       batch->sampler_views = _mesa_set_create(NULL, _mesa_hash_pointer,
                                              _mesa_key_pointer_equal);
 
-      if (!batch->sampler_tables || !batch->sampler_views || !batch->view_heap || !batch->queries)
+      if (!batch->sampler_tables || !batch->sampler_views || !batch->queries)
          return false;
 
       batch->zombie_samplers = UTIL_DYNARRAY_INIT;
@@ -157,6 +151,25 @@ delete_query(set_entry *entry)
    if (pipe_reference(&query->reference, nullptr))
       d3d12_destroy_query(query);
 }
+
+/* View descriptors are allocated from a ring shared by all batches of the
+ * context, everything after the start of the oldest batch that hasn't been
+ * reset yet may still be in use by the GPU.
+ */
+static void
+update_view_heap_tail(struct d3d12_context *ctx)
+{
+   for (unsigned i = 1; i <= ARRAY_SIZE(ctx->batches); ++i) {
+      unsigned idx = (ctx->current_batch_idx + i) % ARRAY_SIZE(ctx->batches);
+      if (ctx->batches[idx].view_heap_in_use) {
+         d3d12_descriptor_heap_release_to(ctx->view_heap, ctx->batches[idx].view_heap_start);
+         return;
+      }
+   }
+
+   d3d12_descriptor_heap_release_to(ctx->view_heap,
+                                    d3d12_descriptor_heap_get_offset(ctx->view_heap));
+}
 #endif // HAVE_GALLIUM_D3D12_GRAPHICS
 
 bool
@@ -191,8 +204,9 @@ d3d12_reset_batch(struct d3d12_context *ctx, struct d3d12_batch *batch, uint64_t
       util_dynarray_foreach(&batch->zombie_samplers, d3d12_descriptor_handle, handle)
          d3d12_descriptor_handle_free(handle);
       util_dynarray_clear(&batch->zombie_samplers);
-      d3d12_descriptor_heap_clear(batch->view_heap);
       d3d12_descriptor_heap_clear(batch->sampler_heap);
+      batch->view_heap_in_use = false;
+      update_view_heap_tail(ctx);
    }
 #endif // HAVE_GALLIUM_D3D12_GRAPHICS
 
@@ -215,7 +229,6 @@ d3d12_destroy_batch(struct d3d12_context *ctx, struct d3d12_batch *batch)
 #ifdef HAVE_GALLIUM_D3D12_GRAPHICS
    if (d3d12_screen(ctx->base.screen)->max_feature_level >= D3D_FEATURE_LEVEL_11_0) {
       d3d12_descriptor_heap_free(batch->sampler_heap);
-      d3d12_descriptor_heap_free(batch->view_heap);
       _mesa_hash_table_destroy(batch->sampler_tables, NULL);
       _mesa_set_destroy(batch->sampler_views, NULL);
       _mesa_set_destroy(batch->queries, NULL);
@@ -259,9 +272,11 @@ d3d12_start_batch(struct d3d12_context *ctx, struct d3d12_batch *batch)
 
 #ifdef HAVE_GALLIUM_D3D12_GRAPHICS
    if (screen->max_feature_level >= D3D_FEATURE_LEVEL_11_0) {
-      ID3D12DescriptorHeap* heaps[2] = { d3d12_descriptor_heap_get(batch->view_heap),
+      ID3D12DescriptorHeap* heaps[2] = { d3d12_descriptor_heap_get(ctx->view_heap),
                                        d3d12_descriptor_heap_get(batch->sampler_heap) };
       ctx->cmdlist->SetDescriptorHeaps(2, heaps);
+      batch->view_heap_start = d3d12_descriptor_heap_get_offset(ctx->view_heap);
+      batch->view_heap_in_use = true;
 
       ctx->cmdlist_dirty = ~0;
       for (int i = 0; i < MESA_SHADER_STAGES; ++i)
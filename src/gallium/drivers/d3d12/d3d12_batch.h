@@ -57,7 +57,8 @@ struct d3d12_batch {
 
    ID3D12CommandAllocator *cmdalloc;
    struct d3d12_descriptor_heap *sampler_heap;
-   struct d3d12_descriptor_heap *view_heap;
+   uint32_t view_heap_start; /* Offset of the first view descriptor used by the batch */
+   bool view_heap_in_use;
    bool has_errors;
    bool pending_memory_barrier;
 
@@ -90,6 +90,15 @@ enum d3d12_shader_dirty_flags
 #define D3D12_SHADER_DIRTY_ALL (D3D12_SHADER_DIRTY_CONSTBUF | D3D12_SHADER_DIRTY_SAMPLER_VIEWS | \
                                 D3D12_SHADER_DIRTY_SAMPLERS | D3D12_SHADER_DIRTY_SSBO | \
                                 D3D12_SHADER_DIRTY_IMAGE)
+#define D3D12_NUM_DESCRIPTOR_TABLE_TYPES 5
+
+/* Last descriptor table filled for a shader stage and table type, it stays
+ * valid until the matching shader dirty flag is set again.
+ */
+struct d3d12_descriptor_table_cache {
+   const struct d3d12_shader *shader;
+   D3D12_GPU_DESCRIPTOR_HANDLE handle;
+};
 
 enum d3d12_binding_type {
    D3D12_BINDING_CONSTANT_BUFFER,
@@ -269,6 +278,7 @@ struct d3d12_context {
    struct d3d12_gfx_pipeline_state gfx_pipeline_state;
    struct d3d12_compute_pipeline_state compute_pipeline_state;
    unsigned shader_dirty[MESA_SHADER_STAGES];
+   struct d3d12_descriptor_table_cache descriptor_tables[MESA_SHADER_STAGES][D3D12_NUM_DESCRIPTOR_TABLE_TYPES];
    unsigned state_dirty;
    unsigned cmdlist_dirty;
    ID3D12PipelineState *current_gfx_pso;
@@ -279,6 +289,7 @@ struct d3d12_context {
 
    struct d3d12_descriptor_pool *sampler_pool;
    struct d3d12_descriptor_handle null_sampler;
+   struct d3d12_descriptor_heap *view_heap;
 
    PFN_D3D12_SERIALIZE_VERSIONED_ROOT_SIGNATURE D3D12SerializeVersionedRootSignature;
 #ifndef _GAMING_XBOX
@@ -413,6 +424,10 @@ d3d12_rebind_buffer(struct d3d12_context *ctx, struct d3d12_resource *res);
 void
 d3d12_init_null_sampler(struct d3d12_context *ctx);
 
+void
+d3d12_invalidate_descriptor_table_cache(struct d3d12_context *ctx,
+                                        const struct d3d12_shader_selector *sel);
+
 bool
 d3d12_init_polygon_stipple(struct pipe_context *pctx);
 
@@ -97,6 +97,10 @@ d3d12_context_destroy(struct pipe_context *pctx)
    d3d12_end_batch(ctx, d3d12_current_batch(ctx));
    for (unsigned i = 0; i < ARRAY_SIZE(ctx->batches); ++i)
       d3d12_destroy_batch(ctx, &ctx->batches[i]);
+#ifdef HAVE_GALLIUM_D3D12_GRAPHICS
+   if (ctx->view_heap)
+      d3d12_descriptor_heap_free(ctx->view_heap);
+#endif // HAVE_GALLIUM_D3D12_GRAPHICS
    ctx->cmdlist->Release();
    if (ctx->cmdlist2)
       ctx->cmdlist2->Release();
@@ -633,6 +637,23 @@ d3d12_context_create(struct pipe_screen *pscreen, void *priv, unsigned flags)
 
    ctx->submit_id = (uint64_t)p_atomic_add_return(&screen->ctx_count, 1) << 32ull;
 
+#ifdef HAVE_GALLIUM_D3D12_GRAPHICS
+   if (screen->max_feature_level >= D3D_FEATURE_LEVEL_11_0) {
+      /* Shared by all batches, so that a single batch can use more than its
+       * share of descriptors before having to be flushed.
+       */
+      ctx->view_heap =
+         d3d12_descriptor_heap_new(screen->dev,
+                                   D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+                                   D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+                                   8096 * ARRAY_SIZE(ctx->batches));
+      if (!ctx->view_heap) {
+         FREE(ctx);
+         return NULL;
+      }
+   }
+#endif // HAVE_GALLIUM_D3D12_GRAPHICS
+
    for (unsigned i = 0; i < ARRAY_SIZE(ctx->batches); ++i) {
       if (!d3d12_init_batch(ctx, &ctx->batches[i])) {
          FREE(ctx);
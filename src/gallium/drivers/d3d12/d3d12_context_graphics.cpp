@@ -1047,6 +1047,7 @@ delete_shader(struct d3d12_context *ctx, mesa_shader_stage stage,
               struct d3d12_shader_selector *shader)
 {
    d3d12_gfx_pipeline_state_cache_invalidate_shader(ctx, stage, shader);
+   d3d12_invalidate_descriptor_table_cache(ctx, shader);
 
    /* Make sure the pipeline state no longer reference the deleted shader */
    struct d3d12_shader *iter = shader->first;
@@ -1201,6 +1202,7 @@ d3d12_delete_compute_state(struct pipe_context *pctx, void *cs)
    struct d3d12_context *ctx = d3d12_context(pctx);
    struct d3d12_shader_selector *shader = (struct d3d12_shader_selector *)cs;
    d3d12_compute_pipeline_state_cache_invalidate_shader(ctx, shader);
+   d3d12_invalidate_descriptor_table_cache(ctx, shader);
 
    /* Make sure the pipeline state no longer reference the deleted shader */
    struct d3d12_shader *iter = shader->first;
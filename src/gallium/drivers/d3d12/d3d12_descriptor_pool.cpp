@@ -52,6 +52,7 @@ struct d3d12_descriptor_heap {
    uint64_t gpu_base;
    uint32_t size;
    uint32_t next;
+   uint32_t tail;
    util_dynarray free_list;
    list_head link;
 };
@@ -188,9 +189,49 @@ void
 d3d12_descriptor_heap_clear(struct d3d12_descriptor_heap *heap)
 {
    heap->next = 0;
+   heap->tail = 0;
    util_dynarray_clear(&heap->free_list);
 }
 
+uint32_t
+d3d12_descriptor_heap_get_offset(struct d3d12_descriptor_heap *heap)
+{
+   return heap->next;
+}
+
+bool
+d3d12_descriptor_heap_reserve(struct d3d12_descriptor_heap *heap,
+                              uint32_t num_handles)
+{
+   uint32_t needed = num_handles * heap->desc_size;
+
+   /* One descriptor is always kept free between next and tail, so that a
+    * full ring can't be mistaken for an empty one.
+    */
+   if (heap->next < heap->tail)
+      return heap->next + needed + heap->desc_size <= heap->tail;
+
+   uint32_t end = heap->tail ? heap->size : heap->size - heap->desc_size;
+   if (heap->next + needed <= end)
+      return true;
+
+   /* Descriptor tables can't wrap around, skip the end of the ring. */
+   if (needed + heap->desc_size <= heap->tail) {
+      heap->next = 0;
+      return true;
+   }
+
+   return false;
+}
+
+void
+d3d12_descriptor_heap_release_to(struct d3d12_descriptor_heap *heap,
+                                 uint32_t offset)
+{
+   assert(offset <= heap->size);
+   heap->tail = offset;
+}
+
 struct d3d12_descriptor_pool*
 d3d12_descriptor_pool_new(struct d3d12_screen *screen,
                           D3D12_DESCRIPTOR_HEAP_TYPE type,
@@ -92,4 +92,22 @@ d3d12_descriptor_heap_append_handles(struct d3d12_descriptor_heap *heap,
 void
 d3d12_descriptor_heap_clear(struct d3d12_descriptor_heap *heap);
 
+/* Online Descriptor Rings
+ *
+ * Descriptors are allocated linearly from the ring and released in
+ * allocation order by moving the tail up to an offset previously returned by
+ * d3d12_descriptor_heap_get_offset().
+ */
+
+uint32_t
+d3d12_descriptor_heap_get_offset(struct d3d12_descriptor_heap *heap);
+
+bool
+d3d12_descriptor_heap_reserve(struct d3d12_descriptor_heap *heap,
+                              uint32_t num_handles);
+
+void
+d3d12_descriptor_heap_release_to(struct d3d12_descriptor_heap *heap,
+                                 uint32_t offset);
+
 #endif
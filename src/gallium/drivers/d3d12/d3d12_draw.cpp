@@ -58,7 +58,7 @@ fill_cbv_descriptors(struct d3d12_context *ctx,
 {
    struct d3d12_batch *batch = d3d12_current_batch(ctx);
    struct d3d12_descriptor_handle table_start;
-   d2d12_descriptor_heap_get_next_handle(batch->view_heap, &table_start);
+   d2d12_descriptor_heap_get_next_handle(ctx->view_heap, &table_start);
 
    for (unsigned i = shader->begin_ubo_binding; i < shader->end_ubo_binding; i++) {
       struct pipe_constant_buffer *buffer = &ctx->cbufs[stage][i];
@@ -74,7 +74,7 @@ fill_cbv_descriptors(struct d3d12_context *ctx,
       }
 
       struct d3d12_descriptor_handle handle;
-      d3d12_descriptor_heap_alloc_handle(batch->view_heap, &handle);
+      d3d12_descriptor_heap_alloc_handle(ctx->view_heap, &handle);
       d3d12_screen(ctx->base.screen)->dev->CreateConstantBufferView(&cbv_desc, handle.cpu_handle);
    }
 
@@ -91,7 +91,7 @@ fill_srv_descriptors(struct d3d12_context *ctx,
    D3D12_CPU_DESCRIPTOR_HANDLE descs[PIPE_MAX_SHADER_SAMPLER_VIEWS];
    struct d3d12_descriptor_handle table_start;
 
-   d2d12_descriptor_heap_get_next_handle(batch->view_heap, &table_start);
+   d2d12_descriptor_heap_get_next_handle(ctx->view_heap, &table_start);
 
    for (unsigned i = shader->begin_srv_binding; i < shader->end_srv_binding; i++)
    {
@@ -136,7 +136,7 @@ fill_srv_descriptors(struct d3d12_context *ctx,
       }
    }
 
-   d3d12_descriptor_heap_append_handles(batch->view_heap, descs, shader->end_srv_binding - shader->begin_srv_binding);
+   d3d12_descriptor_heap_append_handles(ctx->view_heap, descs, shader->end_srv_binding - shader->begin_srv_binding);
 
    return table_start.gpu_handle;
 }
@@ -149,7 +149,7 @@ fill_ssbo_descriptors(struct d3d12_context *ctx,
    struct d3d12_batch *batch = d3d12_current_batch(ctx);
    struct d3d12_descriptor_handle table_start;
 
-   d2d12_descriptor_heap_get_next_handle(batch->view_heap, &table_start);
+   d2d12_descriptor_heap_get_next_handle(ctx->view_heap, &table_start);
 
    for (unsigned i = 0; i < shader->nir->info.num_ssbos; i++)
    {
@@ -175,7 +175,7 @@ fill_ssbo_descriptors(struct d3d12_context *ctx,
       }
 
       struct d3d12_descriptor_handle handle;
-      d3d12_descriptor_heap_alloc_handle(batch->view_heap, &handle);
+      d3d12_descriptor_heap_alloc_handle(ctx->view_heap, &handle);
       d3d12_screen(ctx->base.screen)->dev->CreateUnorderedAccessView(d3d12_res, nullptr, &uav_desc, handle.cpu_handle);
    }
 
@@ -261,7 +261,7 @@ fill_image_descriptors(struct d3d12_context *ctx,
    struct d3d12_batch *batch = d3d12_current_batch(ctx);
    struct d3d12_descriptor_handle table_start;
 
-   d2d12_descriptor_heap_get_next_handle(batch->view_heap, &table_start);
+   d2d12_descriptor_heap_get_next_handle(ctx->view_heap, &table_start);
 
    for (unsigned i = 0; i < shader->nir->info.num_images; i++)
    {
@@ -346,10 +346,10 @@ fill_image_descriptors(struct d3d12_context *ctx,
          d3d12_batch_reference_resource(batch, res, true);
 
          struct d3d12_descriptor_handle handle;
-         d3d12_descriptor_heap_alloc_handle(batch->view_heap, &handle);
+         d3d12_descriptor_heap_alloc_handle(ctx->view_heap, &handle);
          d3d12_screen(ctx->base.screen)->dev->CreateUnorderedAccessView(d3d12_res, nullptr, &uav_desc, handle.cpu_handle);
       } else {
-         d3d12_descriptor_heap_append_handles(batch->view_heap, &screen->null_uavs[shader->uav_bindings[i].dimension].cpu_handle, 1);
+         d3d12_descriptor_heap_append_handles(ctx->view_heap, &screen->null_uavs[shader->uav_bindings[i].dimension].cpu_handle, 1);
       }
    }
 
@@ -479,7 +479,7 @@ check_descriptors_left(struct d3d12_context *ctx, bool compute)
       needed_descs += shader->current->nir->info.num_images;
    }
 
-   if (d3d12_descriptor_heap_get_remaining_handles(batch->view_heap) < needed_descs)
+   if (!d3d12_descriptor_heap_reserve(ctx->view_heap, needed_descs))
       return false;
 
    needed_descs = 0;
@@ -500,9 +500,69 @@ check_descriptors_left(struct d3d12_context *ctx, bool compute)
 
 #define MAX_DESCRIPTOR_TABLES (D3D12_GFX_SHADER_STAGES * 4)
 
+void
+d3d12_invalidate_descriptor_table_cache(struct d3d12_context *ctx,
+                                        const struct d3d12_shader_selector *sel)
+{
+   for (const struct d3d12_shader *shader = sel->first; shader; shader = shader->next_variant) {
+      for (unsigned i = 0; i < D3D12_NUM_DESCRIPTOR_TABLE_TYPES; ++i) {
+         if (ctx->descriptor_tables[sel->stage][i].shader == shader)
+            ctx->descriptor_tables[sel->stage][i].shader = NULL;
+      }
+   }
+}
+
+/* Returns the descriptor table to bind for a shader dirty flag, or a null
+ * handle if the bound one is still valid. When the root signature has been
+ * rebound but the table contents didn't change, the last table is reused
+ * instead of filling a new one.
+ */
+static D3D12_GPU_DESCRIPTOR_HANDLE
+update_descriptor_table(struct d3d12_context *ctx,
+                        const struct d3d12_shader_selector *shader_sel,
+                        enum d3d12_shader_dirty_flags flag,
+                        bool rebind)
+{
+   auto stage = shader_sel->stage;
+   struct d3d12_shader *shader = shader_sel->current;
+   struct d3d12_descriptor_table_cache *cache =
+      &ctx->descriptor_tables[stage][ffs(flag) - 1];
+
+   if (!(ctx->shader_dirty[stage] & flag)) {
+      if (rebind && cache->shader == shader)
+         return cache->handle;
+      if (!rebind)
+         return D3D12_GPU_DESCRIPTOR_HANDLE{ 0 };
+   }
+
+   switch (flag) {
+   case D3D12_SHADER_DIRTY_CONSTBUF:
+      cache->handle = fill_cbv_descriptors(ctx, shader, stage);
+      break;
+   case D3D12_SHADER_DIRTY_SAMPLER_VIEWS:
+      cache->handle = fill_srv_descriptors(ctx, shader, stage);
+      break;
+   case D3D12_SHADER_DIRTY_SAMPLERS:
+      cache->handle = fill_sampler_descriptors(ctx, shader_sel, stage);
+      break;
+   case D3D12_SHADER_DIRTY_SSBO:
+      cache->handle = fill_ssbo_descriptors(ctx, shader, stage);
+      break;
+   case D3D12_SHADER_DIRTY_IMAGE:
+      cache->handle = fill_image_descriptors(ctx, shader, stage);
+      break;
+   default:
+      UNREACHABLE("unexpected shader dirty flag");
+   }
+   cache->shader = shader;
+
+   return cache->handle;
+}
+
 static void
 update_shader_stage_root_parameters(struct d3d12_context *ctx,
                                     const struct d3d12_shader_selector *shader_sel,
+                                    bool rebind,
                                     unsigned &num_params,
                                     unsigned &num_root_descriptors,
                                     D3D12_GPU_DESCRIPTOR_HANDLE root_desc_tables[MAX_DESCRIPTOR_TABLES],
@@ -510,43 +570,31 @@ update_shader_stage_root_parameters(struct d3d12_context *ctx,
 {
    auto stage = shader_sel->stage;
    struct d3d12_shader *shader = shader_sel->current;
-   uint64_t dirty = ctx->shader_dirty[stage];
    assert(shader);
 
-   if (shader->end_ubo_binding - shader->begin_ubo_binding > 0) {
-      if (dirty & D3D12_SHADER_DIRTY_CONSTBUF) {
-         assert(num_root_descriptors < MAX_DESCRIPTOR_TABLES);
-         root_desc_tables[num_root_descriptors] = fill_cbv_descriptors(ctx, shader, stage);
-         root_desc_indices[num_root_descriptors++] = num_params;
-      }
-      num_params++;
-   }
-   if (shader->end_srv_binding > 0) {
-      if (dirty & D3D12_SHADER_DIRTY_SAMPLER_VIEWS) {
-         assert(num_root_descriptors < MAX_DESCRIPTOR_TABLES);
-         root_desc_tables[num_root_descriptors] = fill_srv_descriptors(ctx, shader, stage);
-         root_desc_indices[num_root_descriptors++] = num_params;
-      }
-      num_params++;
-      if (dirty & D3D12_SHADER_DIRTY_SAMPLERS) {
-         assert(num_root_descriptors < MAX_DESCRIPTOR_TABLES);
-         root_desc_tables[num_root_descriptors] = fill_sampler_descriptors(ctx, shader_sel, stage);
-         root_desc_indices[num_root_descriptors++] = num_params;
-      }
-      num_params++;
-   }
-   if (shader->nir->info.num_ssbos > 0) {
-      if (dirty & D3D12_SHADER_DIRTY_SSBO) {
-         assert(num_root_descriptors < MAX_DESCRIPTOR_TABLES);
-         root_desc_tables[num_root_descriptors] = fill_ssbo_descriptors(ctx, shader, stage);
-         root_desc_indices[num_root_descriptors++] = num_params;
-      }
-      num_params++;
-   }
-   if (shader->nir->info.num_images > 0) {
-      if (dirty & D3D12_SHADER_DIRTY_IMAGE) {
+   /* Tables of types the shader doesn't use are not refilled below */
+   u_foreach_bit(i, ctx->shader_dirty[stage] & D3D12_SHADER_DIRTY_ALL)
+      ctx->descriptor_tables[stage][i].shader = NULL;
+
+   const struct {
+      enum d3d12_shader_dirty_flags flag;
+      bool used;
+   } tables[] = {
+      { D3D12_SHADER_DIRTY_CONSTBUF, shader->end_ubo_binding - shader->begin_ubo_binding > 0 },
+      { D3D12_SHADER_DIRTY_SAMPLER_VIEWS, shader->end_srv_binding > 0 },
+      { D3D12_SHADER_DIRTY_SAMPLERS, shader->end_srv_binding > 0 },
+      { D3D12_SHADER_DIRTY_SSBO, shader->nir->info.num_ssbos > 0 },
+      { D3D12_SHADER_DIRTY_IMAGE, shader->nir->info.num_images > 0 },
+   };
+
+   for (unsigned i = 0; i < ARRAY_SIZE(tables); ++i) {
+      if (!tables[i].used)
+         continue;
+
+      D3D12_GPU_DESCRIPTOR_HANDLE table = update_descriptor_table(ctx, shader_sel, tables[i].flag, rebind);
+      if (table.ptr) {
          assert(num_root_descriptors < MAX_DESCRIPTOR_TABLES);
-         root_desc_tables[num_root_descriptors] = fill_image_descriptors(ctx, shader, stage);
+         root_desc_tables[num_root_descriptors] = table;
          root_desc_indices[num_root_descriptors++] = num_params;
       }
       num_params++;
@@ -570,7 +618,8 @@ update_graphics_root_parameters(struct d3d12_context *ctx,
       if (!shader_sel)
          continue;
 
-      update_shader_stage_root_parameters(ctx, shader_sel, num_params, num_root_descriptors, root_desc_tables, root_desc_indices);
+      update_shader_stage_root_parameters(ctx, shader_sel, ctx->cmdlist_dirty & D3D12_DIRTY_ROOT_SIGNATURE,
+                                          num_params, num_root_descriptors, root_desc_tables, root_desc_indices);
       /* TODO Don't always update state vars */
       if (shader_sel->current->num_state_vars > 0) {
          uint32_t constants[D3D12_MAX_GRAPHICS_STATE_VARS * 4];
@@ -594,7 +643,8 @@ update_compute_root_parameters(struct d3d12_context *ctx,
 
    struct d3d12_shader_selector *shader_sel = ctx->compute_state;
    if (shader_sel) {
-      update_shader_stage_root_parameters(ctx, shader_sel, num_params, num_root_descriptors, root_desc_tables, root_desc_indices);
+      update_shader_stage_root_parameters(ctx, shader_sel, ctx->cmdlist_dirty & D3D12_DIRTY_COMPUTE_ROOT_SIGNATURE,
+                                          num_params, num_root_descriptors, root_desc_tables, root_desc_indices);
       /* TODO Don't always update state vars */
       if (shader_sel->current->num_state_vars > 0) {
          uint32_t constants[D3D12_MAX_COMPUTE_STATE_VARS * 4];
@@ -1030,8 +1080,6 @@ d3d12_draw_vbo(struct pipe_context *pctx,
       if (ctx->gfx_pipeline_state.root_signature != root_signature) {
          ctx->gfx_pipeline_state.root_signature = root_signature;
          ctx->state_dirty |= D3D12_DIRTY_ROOT_SIGNATURE;
-         for (int i = 0; i < D3D12_GFX_SHADER_STAGES; ++i)
-            ctx->shader_dirty[i] |= D3D12_SHADER_DIRTY_ALL;
       }
    }
 
@@ -1042,8 +1090,14 @@ d3d12_draw_vbo(struct pipe_context *pctx,
 
    ctx->cmdlist_dirty |= ctx->state_dirty;
 
-   if (!check_descriptors_left(ctx, false))
+   if (!check_descriptors_left(ctx, false)) {
       d3d12_flush_cmdlist(ctx);
+      /* The descriptors still in use by older batches may need to be
+       * released too.
+       */
+      if (!check_descriptors_left(ctx, false))
+         d3d12_flush_cmdlist_and_wait(ctx);
+   }
    batch = d3d12_current_batch(ctx);
 
    if (ctx->cmdlist_dirty & D3D12_DIRTY_ROOT_SIGNATURE) {
@@ -1270,8 +1324,13 @@ d3d12_draw_vbo(struct pipe_context *pctx,
    /* The next dispatch needs to reassert the compute PSO */
    ctx->cmdlist_dirty |= D3D12_DIRTY_COMPUTE_SHADER;
 
-   for (unsigned i = 0; i < D3D12_GFX_SHADER_STAGES; ++i)
+   for (unsigned i = 0; i < D3D12_GFX_SHADER_STAGES; ++i) {
+      if (!ctx->gfx_stages[i]) {
+         u_foreach_bit(j, ctx->shader_dirty[i] & D3D12_SHADER_DIRTY_ALL)
+            ctx->descriptor_tables[i][j].shader = NULL;
+      }
       ctx->shader_dirty[i] = 0;
+   }
 
    for (int i = 0; i < ctx->fb.nr_cbufs; ++i) {
       if (ctx->fb_cbufs[i]) {
@@ -1353,7 +1412,6 @@ d3d12_launch_grid(struct pipe_context *pctx, const struct pipe_grid_info *info)
       if (ctx->compute_pipeline_state.root_signature != root_signature) {
          ctx->compute_pipeline_state.root_signature = root_signature;
          ctx->state_dirty |= D3D12_DIRTY_COMPUTE_ROOT_SIGNATURE;
-         ctx->shader_dirty[MESA_SHADER_COMPUTE] |= D3D12_SHADER_DIRTY_ALL;
       }
    }
 
@@ -1364,8 +1422,11 @@ d3d12_launch_grid(struct pipe_context *pctx, const struct pipe_grid_info *info)
 
    ctx->cmdlist_dirty |= ctx->state_dirty;
 
-   if (!check_descriptors_left(ctx, true))
+   if (!check_descriptors_left(ctx, true)) {
       d3d12_flush_cmdlist(ctx);
+      if (!check_descriptors_left(ctx, true))
+         d3d12_flush_cmdlist_and_wait(ctx);
+   }
    batch = d3d12_current_batch(ctx);
 
    if (ctx->cmdlist_dirty & D3D12_DIRTY_COMPUTE_ROOT_SIGNATURE) {
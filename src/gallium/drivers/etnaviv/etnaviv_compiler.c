@@ -91,7 +91,7 @@ etna_compiler_create(const char *renderer, const struct etna_core_info *info)
       compiler = NULL;
    }
 
-   etna_disk_cache_init(compiler, renderer);
+   etna_disk_cache_init(compiler, renderer, info);
 
    return compiler;
 }
@@ -32,7 +32,8 @@
 #define debug 0
 
 void
-etna_disk_cache_init(struct etna_compiler *compiler, const char *renderer)
+etna_disk_cache_init(struct etna_compiler *compiler, const char *renderer,
+                     const struct etna_core_info *info)
 {
    if (DBG_ENABLED(ETNA_DBG_NOCACHE))
       return;
@@ -44,8 +45,28 @@ etna_disk_cache_init(struct etna_compiler *compiler, const char *renderer)
    const uint8_t *id_sha1 = build_id_data(note);
    assert(id_sha1);
 
+   /* The renderer string only has the model and revision, but the hwdb
+    * entry (and with it the features the compiler looks at) also depends on
+    * product, eco and customer id. Hash the whole GPU identity together with
+    * the build id.
+    */
+   struct mesa_sha1 ctx;
+   unsigned char sha1[SHA1_DIGEST_LENGTH];
+
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, id_sha1, build_id_length(note));
+   _mesa_sha1_update(&ctx, &info->model, sizeof(info->model));
+   _mesa_sha1_update(&ctx, &info->revision, sizeof(info->revision));
+   _mesa_sha1_update(&ctx, &info->product_id, sizeof(info->product_id));
+   _mesa_sha1_update(&ctx, &info->eco_id, sizeof(info->eco_id));
+   _mesa_sha1_update(&ctx, &info->customer_id, sizeof(info->customer_id));
+   _mesa_sha1_update(&ctx, &info->halti, sizeof(info->halti));
+   _mesa_sha1_update(&ctx, &info->gpu, sizeof(info->gpu));
+   _mesa_sha1_update(&ctx, info->feature, sizeof(info->feature));
+   _mesa_sha1_final(&ctx, sha1);
+
    char timestamp[SHA1_DIGEST_STRING_LENGTH];
-   _mesa_sha1_format(timestamp, id_sha1);
+   _mesa_sha1_format(timestamp, sha1);
 
    compiler->disk_cache = disk_cache_create(renderer, timestamp, etna_mesa_debug);
 }
@@ -181,3 +202,93 @@ etna_disk_cache_store(struct etna_compiler *compiler, struct etna_shader_variant
    disk_cache_put(compiler->disk_cache, cache_key, blob.data, blob.size, NULL);
    blob_finish(&blob);
 }
+
+static void
+compute_variant_set_key(struct etna_compiler *compiler, struct etna_shader *shader,
+                        cache_key cache_key)
+{
+   static const char tag[] = "variant set";
+   struct blob blob;
+
+   blob_init(&blob);
+
+   blob_write_bytes(&blob, &shader->cache_key, sizeof(shader->cache_key));
+   blob_write_bytes(&blob, tag, sizeof(tag));
+
+   disk_cache_compute_key(compiler->disk_cache, blob.data, blob.size, cache_key);
+
+   blob_finish(&blob);
+}
+
+struct etna_shader_key *
+etna_disk_cache_retrieve_variant_set(struct etna_compiler *compiler,
+                                     struct etna_shader *shader,
+                                     uint32_t *count)
+{
+   *count = 0;
+
+   if (!compiler->disk_cache)
+      return NULL;
+
+   cache_key cache_key;
+
+   compute_variant_set_key(compiler, shader, cache_key);
+
+   size_t size;
+   void *buffer = disk_cache_get(compiler->disk_cache, cache_key, &size);
+
+   if (debug)
+      fprintf(stderr, "[mesa disk cache] retrieving variant set: %s\n",
+              buffer ? "found" : "missing");
+
+   if (!buffer)
+      return NULL;
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, buffer, size);
+
+   uint32_t key_count = blob_read_uint32(&blob);
+   struct etna_shader_key *keys = NULL;
+
+   if (!blob.overrun && key_count > 0 &&
+       (size_t)(blob.end - blob.current) == key_count * sizeof(*keys)) {
+      keys = malloc(key_count * sizeof(*keys));
+      if (keys) {
+         blob_copy_bytes(&blob, keys, key_count * sizeof(*keys));
+         *count = key_count;
+      }
+   }
+
+   free(buffer);
+
+   return keys;
+}
+
+void
+etna_disk_cache_store_variant_set(struct etna_compiler *compiler,
+                                  struct etna_shader *shader)
+{
+   if (!compiler->disk_cache)
+      return;
+
+   cache_key cache_key;
+
+   compute_variant_set_key(compiler, shader, cache_key);
+
+   uint32_t key_count = 0;
+   for (struct etna_shader_variant *v = shader->variants; v; v = v->next)
+      key_count++;
+
+   if (debug)
+      fprintf(stderr, "[mesa disk cache] storing variant set of %u\n", key_count);
+
+   struct blob blob;
+   blob_init(&blob);
+
+   blob_write_uint32(&blob, key_count);
+   for (struct etna_shader_variant *v = shader->variants; v; v = v->next)
+      blob_write_bytes(&blob, &v->key, sizeof(v->key));
+
+   disk_cache_put(compiler->disk_cache, cache_key, blob.data, blob.size, NULL);
+   blob_finish(&blob);
+}
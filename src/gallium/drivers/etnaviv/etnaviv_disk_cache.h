@@ -31,7 +31,8 @@
 #include "etnaviv_compiler.h"
 
 void
-etna_disk_cache_init(struct etna_compiler *compiler, const char *renderer);
+etna_disk_cache_init(struct etna_compiler *compiler, const char *renderer,
+                     const struct etna_core_info *info);
 
 void
 etna_disk_cache_init_shader_key(struct etna_compiler *compiler, struct etna_shader *shader);
@@ -42,4 +43,17 @@ etna_disk_cache_retrieve(struct etna_compiler *compiler, struct etna_shader_vari
 void
 etna_disk_cache_store(struct etna_compiler *compiler, struct etna_shader_variant *v);
 
+/* The variant set of a shader records the keys of all the variants that were
+ * needed at draw time, so they can be created ahead of time the next time
+ * the same shader is seen.
+ */
+struct etna_shader_key *
+etna_disk_cache_retrieve_variant_set(struct etna_compiler *compiler,
+                                     struct etna_shader *shader,
+                                     uint32_t *count);
+
+void
+etna_disk_cache_store_variant_set(struct etna_compiler *compiler,
+                                  struct etna_shader *shader);
+
 #endif
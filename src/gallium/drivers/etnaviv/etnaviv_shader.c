@@ -483,9 +483,14 @@ etna_shader_variant(struct etna_shader *shader,
 
    assert(shader->specs->fragment_sampler_count <= ARRAY_SIZE(key->tex_swizzle));
 
-   for (v = shader->variants; v; v = v->next)
-      if (etna_shader_key_equal(key, &v->key))
+   simple_mtx_lock(&shader->variants_lock);
+
+   for (v = shader->variants; v; v = v->next) {
+      if (etna_shader_key_equal(key, &v->key)) {
+         simple_mtx_unlock(&shader->variants_lock);
          return v;
+      }
+   }
 
    /* compile new variant if it doesn't exist already */
    v = create_variant(shader, key);
@@ -493,8 +498,16 @@ etna_shader_variant(struct etna_shader *shader,
       v->next = shader->variants;
       shader->variants = v;
       dump_shader_info(v, debug);
+
+      /* Remember the variants we needed at draw time, so that they can be
+       * created along with the initial variant next time.
+       */
+      if (called_from_draw)
+         etna_disk_cache_store_variant_set(shader->compiler, shader);
    }
 
+   simple_mtx_unlock(&shader->variants_lock);
+
    if (called_from_draw) {
       perf_debug_message(debug, SHADER_INFO,
                          "%s shader: recompiling at draw time: global "
@@ -521,14 +534,34 @@ initial_variants_synchronous(struct etna_context *ctx)
                    DBG_ENABLED(ETNA_DBG_DUMP_SHADERS);
 }
 
+static void
+create_initial_variants(struct etna_shader *shader,
+                        struct util_debug_callback *debug)
+{
+   struct etna_shader_key key = {};
+
+   etna_shader_variant(shader, &key, debug, false);
+
+   /* Also create the variants recorded the last time this shader was used,
+    * these usually come straight from the disk cache.
+    */
+   uint32_t count;
+   struct etna_shader_key *keys =
+      etna_disk_cache_retrieve_variant_set(shader->compiler, shader, &count);
+
+   for (uint32_t i = 0; i < count; i++)
+      etna_shader_variant(shader, &keys[i], debug, false);
+
+   free(keys);
+}
+
 static void
 create_initial_variants_async(void *job, void *gdata, int thread_index)
 {
    struct etna_shader *shader = job;
    struct util_debug_callback debug = {};
-   static struct etna_shader_key key;
 
-   etna_shader_variant(shader, &key, &debug, false);
+   create_initial_variants(shader, &debug);
 }
 
 static void *
@@ -548,6 +581,7 @@ etna_create_shader_state(struct pipe_context *pctx,
    shader->specs = &screen->specs;
    shader->compiler = screen->compiler;
    util_queue_fence_init(&shader->ready);
+   simple_mtx_init(&shader->variants_lock, mtx_plain);
 
    shader->nir = (pss->type == PIPE_SHADER_IR_NIR) ? pss->ir.nir :
                   tgsi_to_nir(pss->tokens, pctx->screen, false);
@@ -555,8 +589,7 @@ etna_create_shader_state(struct pipe_context *pctx,
    etna_disk_cache_init_shader_key(compiler, shader);
 
    if (initial_variants_synchronous(ctx)) {
-      struct etna_shader_key key = {};
-      etna_shader_variant(shader, &key, &ctx->base.debug, false);
+      create_initial_variants(shader, &ctx->base.debug);
    } else {
       struct etna_screen *screen = ctx->screen;
       util_queue_add_job(&screen->shader_compiler_queue, shader, &shader->ready,
@@ -588,6 +621,7 @@ etna_delete_shader_state(struct pipe_context *pctx, void *ss)
 
    ralloc_free(shader->nir);
    util_queue_fence_destroy(&shader->ready);
+   simple_mtx_destroy(&shader->variants_lock);
    FREE(shader);
 }
 
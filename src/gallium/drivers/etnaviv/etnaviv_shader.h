@@ -32,6 +32,7 @@
 #include "nir.h"
 #include "pipe/p_state.h"
 #include "util/disk_cache.h"
+#include "util/simple_mtx.h"
 #include "util/u_queue.h"
 
 struct etna_context;
@@ -87,6 +88,8 @@ struct etna_shader {
    const struct etna_specs *specs;
    struct etna_compiler *compiler;
 
+   /* variants can be created from the draw and the shader compiler thread */
+   simple_mtx_t variants_lock;
    struct etna_shader_variant *variants;
 
    cache_key cache_key;     /* shader disk-cache key */
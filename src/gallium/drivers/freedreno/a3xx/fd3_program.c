@@ -468,7 +468,8 @@ fd3_prog_init(struct pipe_context *pctx)
 {
    struct fd_context *ctx = fd_context(pctx);
 
-   ctx->shader_cache = ir3_cache_create(&cache_funcs, ctx);
+   ctx->shader_cache = ir3_cache_create(&cache_funcs, ctx,
+                                        &ctx->screen->compile_queue);
    ir3_prog_init(pctx);
    fd_prog_init(pctx);
 }
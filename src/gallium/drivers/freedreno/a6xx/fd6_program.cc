@@ -1648,7 +1648,8 @@ fd6_prog_init(struct pipe_context *pctx)
 {
    struct fd_context *ctx = fd_context(pctx);
 
-   ctx->shader_cache = ir3_cache_create(&cache_funcs<CHIP>, ctx);
+   ctx->shader_cache = ir3_cache_create(&cache_funcs<CHIP>, ctx,
+                                        &ctx->screen->compile_queue);
 
    ir3_prog_init(pctx);
 
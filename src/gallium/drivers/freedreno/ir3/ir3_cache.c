@@ -39,16 +39,21 @@ struct ir3_cache {
 
    const struct ir3_cache_funcs *funcs;
    void *data;
+
+   /* queue used to compile the variants of a new program in parallel */
+   struct util_queue *queue;
 };
 
 struct ir3_cache *
-ir3_cache_create(const struct ir3_cache_funcs *funcs, void *data)
+ir3_cache_create(const struct ir3_cache_funcs *funcs, void *data,
+                 struct util_queue *queue)
 {
    struct ir3_cache *cache = rzalloc(NULL, struct ir3_cache);
 
    cache->ht = _mesa_hash_table_create(cache, key_hash, key_equals);
    cache->funcs = funcs;
    cache->data = data;
+   cache->queue = queue;
 
    return cache;
 }
@@ -99,34 +104,27 @@ ir3_cache_lookup(struct ir3_cache *cache, const struct ir3_cache_key *key,
       shaders[MESA_SHADER_TESS_CTRL] = hs;
    }
 
-   const struct ir3_shader_variant *variants[MESA_SHADER_STAGES];
+   const struct ir3_shader_variant *variants[MESA_SHADER_STAGES] = {};
    struct ir3_shader_key shader_key = key->key;
+   uint32_t stages = 0;
 
    for (mesa_shader_stage stage = MESA_SHADER_VERTEX; stage < MESA_SHADER_STAGES;
         stage++) {
-      if (shaders[stage]) {
-         variants[stage] =
-            ir3_shader_variant(shaders[stage], shader_key, false, debug);
-         if (!variants[stage])
-            return NULL;
-      } else {
-         variants[stage] = NULL;
-      }
+      if (shaders[stage])
+         stages |= BITFIELD_BIT(stage);
    }
 
+   if (!ir3_shader_variants(cache->queue, shaders, stages, shader_key,
+                            variants, debug))
+      return NULL;
+
    struct ir3_compiler *compiler = shaders[MESA_SHADER_VERTEX]->compiler;
    uint32_t safe_constlens = ir3_trim_constlen(variants, compiler);
    shader_key.safe_constlen = true;
 
-   for (mesa_shader_stage stage = MESA_SHADER_VERTEX; stage < MESA_SHADER_STAGES;
-        stage++) {
-      if (safe_constlens & (1 << stage)) {
-         variants[stage] =
-            ir3_shader_variant(shaders[stage], shader_key, false, debug);
-         if (!variants[stage])
-            return NULL;
-      }
-   }
+   if (!ir3_shader_variants(cache->queue, shaders, safe_constlens, shader_key,
+                            variants, debug))
+      return NULL;
 
    const struct ir3_shader_variant *bs;
 
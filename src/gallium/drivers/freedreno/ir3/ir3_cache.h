@@ -51,10 +51,13 @@ struct ir3_cache_funcs {
 };
 
 struct ir3_cache;
+struct util_queue;
 
-/* construct a shader cache.  Free with ralloc_free() */
+/* construct a shader cache.  Free with ralloc_free().  Missing variants of a
+ * new program are compiled in parallel on the specified queue.
+ */
 struct ir3_cache *ir3_cache_create(const struct ir3_cache_funcs *funcs,
-                                   void *data);
+                                   void *data, struct util_queue *queue);
 void ir3_cache_destroy(struct ir3_cache *cache);
 
 /* debug callback is used for shader-db logs in case the lookup triggers
@@ -138,6 +138,87 @@ ir3_shader_variant(struct ir3_shader *shader, struct ir3_shader_key key,
    return v;
 }
 
+struct variant_job {
+   struct ir3_shader *shader;
+   struct ir3_shader_key key;
+   struct ir3_shader_variant *variant;
+   struct util_queue_fence ready;
+};
+
+static void
+variant_job_execute(void *job, void *gdata, int thread_index)
+{
+   struct variant_job *j = job;
+   struct util_debug_callback debug = {};
+
+   MESA_TRACE_FUNC();
+
+   j->variant = ir3_shader_variant(j->shader, j->key, false, &debug);
+}
+
+/**
+ * Get the draw pass variants for several stages of a program at once.
+ *
+ * Variants which don't exist yet are compiled, or loaded from the disk
+ * cache, in parallel on the compile queue, so that a draw-time miss for a
+ * whole program only costs as much as its slowest stage.
+ */
+bool
+ir3_shader_variants(struct util_queue *queue,
+                    struct ir3_shader *const shaders[MESA_SHADER_STAGES],
+                    uint32_t stages, struct ir3_shader_key key,
+                    const struct ir3_shader_variant *variants[MESA_SHADER_STAGES],
+                    struct util_debug_callback *debug)
+{
+   uint32_t missing = 0;
+
+   u_foreach_bit (stage, stages) {
+      struct ir3_shader_key stage_key = key;
+      ir3_key_clear_unused(&stage_key, shaders[stage]);
+      variants[stage] =
+         ir3_shader_lookup_variant(shaders[stage], &stage_key, false);
+      if (!variants[stage])
+         missing |= BITFIELD_BIT(stage);
+   }
+
+   /* Not worth the round trip through the queue for a single stage.  The
+    * debug callback can't be called from the compile threads, so compile
+    * synchronously if shader-db stats or debug messages are wanted.
+    */
+   if (util_bitcount(missing) < 2 || unlikely(debug && debug->debug_message) ||
+       FD_DBG(SHADERDB)) {
+      u_foreach_bit (stage, missing) {
+         variants[stage] = ir3_shader_variant(shaders[stage], key, false, debug);
+         if (!variants[stage])
+            return false;
+      }
+      return true;
+   }
+
+   struct variant_job jobs[MESA_SHADER_STAGES];
+
+   u_foreach_bit (stage, missing) {
+      jobs[stage].shader = shaders[stage];
+      jobs[stage].key = key;
+      jobs[stage].variant = NULL;
+      util_queue_fence_init(&jobs[stage].ready);
+      util_queue_add_job(queue, &jobs[stage], &jobs[stage].ready,
+                         variant_job_execute, NULL, 0);
+   }
+
+   bool success = true;
+
+   u_foreach_bit (stage, missing) {
+      util_queue_fence_wait(&jobs[stage].ready);
+      util_queue_fence_destroy(&jobs[stage].ready);
+      variants[stage] = jobs[stage].variant;
+      if (!variants[stage])
+         success = false;
+   }
+
+   return success;
+}
+
 static void
 copy_stream_out(struct ir3_stream_output_info *i,
                 const struct pipe_stream_output_info *p)
@@ -22,10 +22,17 @@ BEGINC;
  * underlying ir3_shader
  */
 struct ir3_shader_state;
+struct util_queue;
 
 struct ir3_shader_variant *
 ir3_shader_variant(struct ir3_shader *shader, struct ir3_shader_key key,
                    bool binning_pass, struct util_debug_callback *debug);
+bool
+ir3_shader_variants(struct util_queue *queue,
+                    struct ir3_shader *const shaders[MESA_SHADER_STAGES],
+                    uint32_t stages, struct ir3_shader_key key,
+                    const struct ir3_shader_variant *variants[MESA_SHADER_STAGES],
+                    struct util_debug_callback *debug);
 
 void *ir3_shader_compute_state_create(struct pipe_context *pctx,
                                       const struct pipe_compute_state *cso);
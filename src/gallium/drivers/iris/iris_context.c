@@ -306,6 +306,8 @@ iris_create_context(struct pipe_screen *pscreen, void *priv, unsigned flags)
    if (!ice)
       return NULL;
 
+   iris_disk_cache_init(screen);
+
    struct pipe_context *ctx = &ice->ctx;
 
    ctx->screen = pscreen;
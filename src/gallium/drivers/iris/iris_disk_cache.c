@@ -36,6 +36,7 @@
 #include "util/build_id.h"
 #include "util/disk_cache.h"
 #include "util/mesa-sha1.h"
+#include "util/u_atomic.h"
 #include "intel/compiler/brw/brw_compiler.h"
 #ifdef INTEL_USE_ELK
 #include "intel/compiler/elk/elk_compiler.h"
@@ -340,11 +341,8 @@ iris_disk_cache_retrieve(struct iris_screen *screen,
 #endif
 }
 
-/**
- * Initialize the on-disk shader cache.
- */
-void
-iris_disk_cache_init(struct iris_screen *screen)
+static void
+iris_disk_cache_create(struct iris_screen *screen)
 {
 #ifdef ENABLE_SHADER_CACHE
    if (INTEL_DEBUG(DEBUG_DISK_CACHE_DISABLE_MASK))
@@ -384,3 +382,20 @@ iris_disk_cache_init(struct iris_screen *screen)
    screen->disk_cache = disk_cache_create(renderer, timestamp, driver_flags);
 #endif
 }
+
+/**
+ * Initialize the on-disk shader cache, the first time it is needed.
+ */
+void
+iris_disk_cache_init(struct iris_screen *screen)
+{
+   if (p_atomic_read(&screen->disk_cache_initialized))
+      return;
+
+   simple_mtx_lock(&screen->disk_cache_lock);
+   if (!screen->disk_cache_initialized) {
+      iris_disk_cache_create(screen);
+      p_atomic_set(&screen->disk_cache_initialized, true);
+   }
+   simple_mtx_unlock(&screen->disk_cache_lock);
+}
@@ -542,6 +542,7 @@ iris_screen_destroy(struct iris_screen *screen)
    u_transfer_helper_destroy(screen->base.transfer_helper);
    iris_bufmgr_unref(screen->bufmgr);
    disk_cache_destroy(screen->disk_cache);
+   simple_mtx_destroy(&screen->disk_cache_lock);
    close(screen->winsys_fd);
    ralloc_free(screen);
 }
@@ -579,6 +580,8 @@ static struct disk_cache *
 iris_get_disk_shader_cache(struct pipe_screen *pscreen)
 {
    struct iris_screen *screen = (struct iris_screen *) pscreen;
+
+   iris_disk_cache_init(screen);
    return screen->disk_cache;
 }
 
@@ -673,6 +676,8 @@ iris_screen_create(int fd, const struct pipe_screen_config *config)
    if (!screen)
       return NULL;
 
+   simple_mtx_init(&screen->disk_cache_lock, mtx_plain);
+
    driParseConfigFiles(config->options, config->options_info, 0, "iris",
                        NULL, NULL, NULL, 0, NULL, 0);
 
@@ -769,8 +774,6 @@ iris_screen_create(int fd, const struct pipe_screen_config *config)
    screen->l3_config_3d = iris_get_default_l3_config(screen->devinfo, false);
    screen->l3_config_cs = iris_get_default_l3_config(screen->devinfo, true);
 
-   iris_disk_cache_init(screen);
-
    slab_create_parent(&screen->transfer_pool,
                       sizeof(struct iris_transfer), 64);
 
@@ -26,6 +26,7 @@
 #include "pipe/p_screen.h"
 #include "frontend/drm_driver.h"
 #include "util/disk_cache.h"
+#include "util/simple_mtx.h"
 #include "util/slab.h"
 #include "util/u_screen.h"
 #include "intel/dev/intel_device_info.h"
@@ -249,7 +250,13 @@ struct iris_screen {
 
    struct util_queue shader_compiler_queue;
 
+   /**
+    * Opened by iris_disk_cache_init() when the first context is created, so
+    * that screens only used for allocations (e.g. GBM) don't pay for it.
+    */
    struct disk_cache *disk_cache;
+   simple_mtx_t disk_cache_lock;
+   bool disk_cache_initialized;
 
    struct intel_measure_device measure;
 
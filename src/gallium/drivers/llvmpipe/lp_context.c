@@ -61,6 +61,10 @@ llvmpipe_destroy(struct pipe_context *pipe)
    mtx_unlock(&lp_screen->ctx_mutex);
    lp_print_counters();
 
+   /* Queued variants point back to this context */
+   if (util_queue_is_initialized(&lp_screen->fs_compile_queue))
+      util_queue_finish(&lp_screen->fs_compile_queue);
+
    if (llvmpipe->csctx) {
       lp_csctx_destroy(llvmpipe->csctx);
    }
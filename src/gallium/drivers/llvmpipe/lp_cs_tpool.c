@@ -28,10 +28,17 @@
  * based on threadpool.c but modified heavily to be compute shader tuned.
  */
 
+#include "util/u_atomic.h"
+#include "util/u_math.h"
 #include "util/u_thread.h"
 #include "util/u_memory.h"
 #include "lp_cs_tpool.h"
 
+/* Chunks each thread gets on average, more chunks balance the load better
+ * when the iterations take different amounts of time.
+ */
+#define LP_CS_TPOOL_CHUNKS_PER_THREAD 4
+
 static int
 lp_cs_tpool_worker(void *data)
 {
@@ -43,7 +50,6 @@ lp_cs_tpool_worker(void *data)
 
    while (!pool->shutdown) {
       struct lp_cs_tpool_task *task;
-      unsigned iter_per_thread;
 
       while (list_is_empty(&pool->workqueue) && !pool->shutdown)
          cnd_wait(&pool->new_work, &pool->m);
@@ -53,29 +59,32 @@ lp_cs_tpool_worker(void *data)
 
       task = list_first_entry(&pool->workqueue, struct lp_cs_tpool_task,
                               list);
+      task->num_workers++;
+      mtx_unlock(&pool->m);
 
-      unsigned this_iter = task->iter_start;
-
-      iter_per_thread = task->iter_per_thread;
-
-      if (task->iter_remainder &&
-          task->iter_start + task->iter_remainder == task->iter_total) {
-         task->iter_remainder--;
-         iter_per_thread = 1;
+      /* Claim chunks of iterations until the task runs out */
+      unsigned iter_done = 0;
+      while (true) {
+         unsigned this_iter = p_atomic_fetch_add(&task->iter_next,
+                                                 task->iter_per_chunk);
+         if (this_iter >= task->iter_total)
+            break;
+
+         unsigned iter_end = MIN2(this_iter + task->iter_per_chunk,
+                                  task->iter_total);
+         for (unsigned i = this_iter; i < iter_end; i++)
+            task->work(task->data, i, &lmem);
+         iter_done += iter_end - this_iter;
       }
 
-      task->iter_start += iter_per_thread;
-
-      if (task->iter_start == task->iter_total)
-         list_del(&task->list);
-
-      mtx_unlock(&pool->m);
-      for (unsigned i = 0; i < iter_per_thread; i++)
-         task->work(task->data, this_iter + i, &lmem);
-
       mtx_lock(&pool->m);
-      task->iter_finished += iter_per_thread;
-      if (task->iter_finished == task->iter_total)
+      if (task->queued) {
+         list_del(&task->list);
+         task->queued = false;
+      }
+      task->num_workers--;
+      task->iter_finished += iter_done;
+      if (task->iter_finished == task->iter_total && !task->num_workers)
          cnd_broadcast(&task->finish);
    }
    mtx_unlock(&pool->m);
@@ -95,7 +104,9 @@ lp_cs_tpool_create(unsigned num_threads)
    cnd_init(&pool->new_work);
 
    list_inithead(&pool->workqueue);
-   assert (num_threads <= LP_MAX_THREADS);
+   pool->threads = CALLOC(MAX2(1, num_threads), sizeof(*pool->threads));
+   if (!pool->threads)
+      num_threads = 0;
    for (unsigned i = 0; i < num_threads; i++) {
       if (thrd_success != u_thread_create(pool->threads + i, lp_cs_tpool_worker, pool)) {
          num_threads = i;  /* previous thread is max */
@@ -123,6 +134,7 @@ lp_cs_tpool_destroy(struct lp_cs_tpool *pool)
 
    cnd_destroy(&pool->new_work);
    mtx_destroy(&pool->m);
+   FREE(pool->threads);
    FREE(pool);
 }
 
@@ -151,14 +163,15 @@ lp_cs_tpool_queue_task(struct lp_cs_tpool *pool,
    task->data = data;
    task->iter_total = num_iters;
 
-   task->iter_per_thread = num_iters / pool->num_threads;
-   task->iter_remainder = num_iters % pool->num_threads;
+   task->iter_per_chunk =
+      MAX2(1, num_iters / (pool->num_threads * LP_CS_TPOOL_CHUNKS_PER_THREAD));
 
    cnd_init(&task->finish);
 
    mtx_lock(&pool->m);
 
    list_addtail(&task->list, &pool->workqueue);
+   task->queued = true;
 
    cnd_broadcast(&pool->new_work);
    mtx_unlock(&pool->m);
@@ -175,7 +188,8 @@ lp_cs_tpool_wait_for_task(struct lp_cs_tpool *pool,
       return;
 
    mtx_lock(&pool->m);
-   while (task->iter_finished < task->iter_total)
+   while (task->queued || task->num_workers ||
+          task->iter_finished < task->iter_total)
       cnd_wait(&task->finish, &pool->m);
    mtx_unlock(&pool->m);
 
@@ -66,7 +66,12 @@
 
 #define LP_MAX_SAMPLES 8
 
-#define LP_MAX_THREADS 32
+/**
+ * Upper bound for LP_NUM_THREADS.  The per-thread state of the rasterizer,
+ * the compute thread pool and the queries is sized for the actual number of
+ * threads.
+ */
+#define LP_MAX_THREADS 256
 
 
 /**
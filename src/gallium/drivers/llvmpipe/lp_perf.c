@@ -53,6 +53,13 @@ lp_print_counters(void)
       debug_printf("llvmpipe: nr_rectangles:                %9u\n", lp_count.nr_rects);
       debug_printf("llvmpipe: nr_culled_rectangles:         %9u\n", lp_count.nr_culled_rects);
 
+      debug_printf("llvmpipe: nr_scenes:                    %9u\n", lp_count.nr_scenes);
+      debug_printf("llvmpipe:   avg_scene_data_size:        %9u\n",
+                   lp_count.nr_scenes ? (unsigned)(lp_count.scene_data_size / lp_count.nr_scenes) : 0);
+      debug_printf("llvmpipe: nr_bin_commands:              %9u (%.1f per triangle/rectangle)\n",
+                   lp_count.nr_bin_commands,
+                   (float) lp_count.nr_bin_commands / (float) MAX2(1, lp_count.nr_tris + lp_count.nr_rects));
+
       total_64 = (lp_count.nr_empty_64 +
                   lp_count.nr_fully_covered_64 +
                   lp_count.nr_partially_covered_64);
@@ -62,6 +62,9 @@ struct lp_counters
    unsigned nr_rect_fully_covered_4;
    unsigned nr_rect_partially_covered_4;
    unsigned nr_non_empty_4;
+   unsigned nr_bin_commands;
+   unsigned nr_scenes;
+   uint64_t scene_data_size;  /**< total, in bytes */
    unsigned nr_llvm_compiles;
    int64_t llvm_compile_time;  /**< total, in microseconds */
 
@@ -499,6 +499,21 @@ lp_scene_add_frag_shader_reference(struct lp_scene *scene,
 }
 
 
+/**
+ * Wait for the fragment shader variants referenced by the scene to be
+ * compiled, see LP_ASYNC_COMPILE.
+ */
+void
+lp_scene_wait_frag_shaders(const struct lp_scene *scene)
+{
+   for (const struct shader_ref *ref = scene->frag_shaders; ref;
+        ref = ref->next) {
+      for (int i = 0; i < ref->count; i++)
+         util_queue_fence_wait(&ref->variant[i]->ready);
+   }
+}
+
+
 /**
  * Does this scene have a reference to the given resource?
  * Returns bitmask of LP_REFERENCED_FOR_READ/WRITE bits.
@@ -645,12 +660,39 @@ lp_scene_begin_binning(struct lp_scene *scene,
 void
 lp_scene_end_binning(struct lp_scene *scene)
 {
+   if (LP_DEBUG & DEBUG_COUNTERS) {
+      LP_COUNT(nr_scenes);
+      LP_COUNT_ADD(scene_data_size, lp_scene_data_size(scene));
+   }
+
    if (LP_DEBUG & DEBUG_SCENE) {
+      unsigned bins_used = 0, nr_cmds = 0, max_cmds = 0;
+
+      for (unsigned y = 0; y < scene->tiles_y; y++) {
+         for (unsigned x = 0; x < scene->tiles_x; x++) {
+            const struct cmd_bin *bin = lp_scene_get_bin(scene, x, y);
+            unsigned sz = 0;
+            for (const struct cmd_block *block = bin->head; block;
+                 block = block->next)
+               sz += block->count;
+            if (sz) {
+               bins_used++;
+               nr_cmds += sz;
+               max_cmds = MAX2(max_cmds, sz);
+            }
+         }
+      }
+
       debug_printf("rasterize scene:\n");
       debug_printf("  scene_size: %u\n",
                    scene->scene_size);
       debug_printf("  data size: %u\n",
                    lp_scene_data_size(scene));
+      debug_printf("  bins used: %u of %u\n",
+                   bins_used, scene->tiles_x * scene->tiles_y);
+      debug_printf("  commands: %u (%.1f per used bin, max %u)\n",
+                   nr_cmds, bins_used ? (float) nr_cmds / bins_used : 0.0f,
+                   max_cmds);
 
       if (0)
          lp_debug_bins(scene);
@@ -38,6 +38,7 @@
 #include "util/u_thread.h"
 #include "lp_rast.h"
 #include "lp_debug.h"
+#include "lp_perf.h"
 
 struct lp_scene_queue;
 struct lp_rast_state;
@@ -231,6 +232,8 @@ unsigned lp_scene_is_resource_referenced(const struct lp_scene *scene,
 bool lp_scene_add_frag_shader_reference(struct lp_scene *scene,
                                         struct lp_fragment_shader_variant *variant);
 
+void lp_scene_wait_frag_shaders(const struct lp_scene *scene);
+
 
 
 /**
@@ -344,6 +347,8 @@ lp_scene_bin_command(struct lp_scene *scene,
       tail->count++;
    }
 
+   LP_COUNT(nr_bin_commands);
+
    return true;
 }
 
@@ -761,6 +761,9 @@ llvmpipe_destroy_screen(struct pipe_screen *_screen)
    if (screen->cs_tpool)
       lp_cs_tpool_destroy(screen->cs_tpool);
 
+   if (util_queue_is_initialized(&screen->fs_compile_queue))
+      util_queue_destroy(&screen->fs_compile_queue);
+
    if (screen->rast)
       lp_rast_destroy(screen->rast);
 
@@ -1018,6 +1021,12 @@ llvmpipe_create_screen(struct sw_winsys *winsys)
                                               screen->num_threads);
    screen->num_threads = MIN2(screen->num_threads, LP_MAX_THREADS);
 
+   if (debug_get_bool_option("LP_ASYNC_COMPILE", false)) {
+      /* Failing to create the queue just means compiling synchronously */
+      util_queue_init(&screen->fs_compile_queue, "lpfs", 64, 1,
+                      UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL);
+   }
+
    for (unsigned i = 0; i < MESA_SHADER_MESH_STAGES; i++)
       screen->base.nir_options[i] = &gallivm_nir_options;
 
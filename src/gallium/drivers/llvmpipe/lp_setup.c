@@ -238,6 +238,9 @@ lp_setup_rasterize_scene(struct lp_setup_context *setup)
 
    lp_scene_end_binning(scene);
 
+   /* The rasterizer needs the compiled fragment shaders */
+   lp_scene_wait_frag_shaders(scene);
+
    mtx_lock(&screen->rast_mutex);
    lp_rast_queue_scene(screen->rast, scene);
    mtx_unlock(&screen->rast_mutex);
@@ -1072,10 +1072,12 @@ llvmpipe_remove_cs_shader_variant(struct llvmpipe_context *lp,
    list_del(&variant->list_item_local.list);
    variant->shader->variants_cached--;
 
-   /* remove from context's list */
+   /* remove from context's list, which isn't necessarily the one of 'lp'
+    * when the shader is shared between contexts
+    */
    list_del(&variant->list_item_global.list);
-   lp->nr_cs_variants--;
-   lp->nr_cs_instrs -= variant->nr_instrs;
+   variant->lp->nr_cs_variants--;
+   variant->lp->nr_cs_instrs -= variant->nr_instrs;
 
    FREE(variant->function_name);
    FREE(variant);
@@ -1389,6 +1391,17 @@ llvmpipe_update_cs_variant(struct llvmpipe_context *lp,
        */
       list_move_to(&variant->list_item_global.list,
                    &lp->cs_variants_list.list);
+
+      if (variant->lp != lp) {
+         /* The shader is shared with another context, take the variant
+          * over into our own accounting.
+          */
+         variant->lp->nr_cs_variants--;
+         variant->lp->nr_cs_instrs -= variant->nr_instrs;
+         variant->lp = lp;
+         lp->nr_cs_variants++;
+         lp->nr_cs_instrs += variant->nr_instrs;
+      }
    } else {
       /* variant not found, create it now */
 
@@ -1452,6 +1465,7 @@ llvmpipe_update_cs_variant(struct llvmpipe_context *lp,
       if (variant) {
          list_add(&variant->list_item_local.list, &shader->variants.list);
          list_add(&variant->list_item_global.list, &lp->cs_variants_list.list);
+         variant->lp = lp;
          lp->nr_cs_variants++;
          lp->nr_cs_instrs += variant->nr_instrs;
          shader->variants_cached++;
@@ -99,6 +99,9 @@ struct lp_compute_shader_variant
 
    struct lp_cs_variant_list_item list_item_global, list_item_local;
 
+   /* Context whose variant list holds list_item_global */
+   struct llvmpipe_context *lp;
+
    struct lp_compute_shader *shader;
 
    /* For debugging/profiling purposes */
@@ -60,6 +60,7 @@
 #include <limits.h>
 #include "pipe/p_defines.h"
 #include "util/u_inlines.h"
+#include "util/u_atomic.h"
 #include "util/u_memory.h"
 #include "util/u_pointer.h"
 #include "util/format/u_format.h"
@@ -3832,46 +3833,215 @@ lp_fs_get_ir_cache_key(struct lp_fragment_shader_variant *variant,
 }
 
 
+/**
+ * State needed to generate and compile the code of a variant, possibly on
+ * the screen's compile queue.
+ */
+struct lp_fs_variant_job {
+   struct llvmpipe_context *lp;
+   struct lp_fragment_shader_variant *variant;
+   struct lp_cached_code cached;
+   bool linear_pipeline;
+   bool fullcolormask;
+};
+
+
+/**
+ * Generate and compile the LLVM code of a variant.  Nothing here depends
+ * on the context state, so this can run on another thread than the one
+ * which created the variant.
+ */
+static void
+compile_variant(struct lp_fs_variant_job *job)
+{
+   struct llvmpipe_context *lp = job->lp;
+   struct lp_fragment_shader_variant *variant = job->variant;
+   struct lp_fragment_shader *shader = variant->shader;
+   const struct lp_fragment_shader_variant_key *key = &variant->key;
+
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   unsigned char ir_sha1_cache_key[SHA1_DIGEST_LENGTH];
+   bool needs_caching = false;
+   if (shader->base.ir.nir) {
+      lp_fs_get_ir_cache_key(variant, ir_sha1_cache_key);
+
+      lp_disk_cache_find_shader(screen, &job->cached, ir_sha1_cache_key);
+      if (!job->cached.data_size)
+         needs_caching = true;
+   }
+
+   llvmpipe_fs_variant_fastpath(variant);
+
+   lp_jit_init_types(variant);
+
+   if (variant->jit_function[RAST_EDGE_TEST] == NULL)
+      generate_fragment(lp, shader, variant, RAST_EDGE_TEST);
+
+   if (variant->jit_function[RAST_WHOLE] == NULL) {
+      if (variant->opaque) {
+         /* Specialized shader, which doesn't need to read the color buffer. */
+         generate_fragment(lp, shader, variant, RAST_WHOLE);
+      }
+   }
+
+   if (job->linear_pipeline) {
+      /* Currently keeping both the old fastpaths and new linear path
+       * active.  The older code is still somewhat faster for the cases
+       * it covers.
+       *
+       * XXX: consider restricting this to aero-mode only.
+       */
+      if (job->fullcolormask &&
+          !key->alpha.enabled &&
+          !key->blend.alpha_to_coverage) {
+         llvmpipe_fs_variant_linear_fastpath(variant);
+      }
+
+      /* If the original fastpath doesn't cover this variant, try the new
+       * code:
+       */
+      if (variant->jit_linear == NULL) {
+         if (shader->kind == LP_FS_KIND_BLIT_RGBA ||
+             shader->kind == LP_FS_KIND_BLIT_RGB1 ||
+             shader->kind == LP_FS_KIND_LLVM_LINEAR) {
+            llvmpipe_fs_variant_linear_llvm(lp, shader, variant);
+         }
+      }
+   } else {
+      if (LP_DEBUG & DEBUG_LINEAR) {
+         lp_debug_fs_variant(variant);
+         debug_printf("    ----> no linear path for this variant\n");
+      }
+   }
+
+   /*
+    * Compile everything
+    */
+
+#if GALLIVM_USE_ORCJIT
+/* module has been moved into ORCJIT after gallivm_compile_module */
+   variant->nr_instrs += lp_build_count_ir_module(variant->gallivm->module);
+
+   gallivm_compile_module(variant->gallivm);
+#else
+   gallivm_compile_module(variant->gallivm);
+
+   variant->nr_instrs += lp_build_count_ir_module(variant->gallivm->module);
+#endif
+
+   if (variant->function[RAST_EDGE_TEST]) {
+      variant->jit_function[RAST_EDGE_TEST] = (lp_jit_frag_func)
+            gallivm_jit_function(variant->gallivm,
+                                 variant->function[RAST_EDGE_TEST],
+                                 variant->function_name[RAST_EDGE_TEST]);
+   }
+
+   if (variant->function[RAST_WHOLE]) {
+      variant->jit_function[RAST_WHOLE] = (lp_jit_frag_func)
+         gallivm_jit_function(variant->gallivm,
+                              variant->function[RAST_WHOLE],
+                              variant->function_name[RAST_WHOLE]);
+   } else if (!variant->jit_function[RAST_WHOLE]) {
+      variant->jit_function[RAST_WHOLE] = (lp_jit_frag_func)
+         variant->jit_function[RAST_EDGE_TEST];
+   }
+
+   if (job->linear_pipeline) {
+      if (variant->linear_function) {
+         variant->jit_linear_llvm = (lp_jit_linear_llvm_func)
+            gallivm_jit_function(variant->gallivm, variant->linear_function,
+                                 variant->linear_function_name);
+      }
+
+      /*
+       * This must be done after LLVM compilation, as it will call the JIT'ed
+       * code to determine active inputs.
+       */
+      lp_linear_check_variant(variant);
+   }
+
+   if (needs_caching) {
+      lp_disk_cache_insert_shader(screen, &job->cached, ir_sha1_cache_key);
+   }
+
+   gallivm_free_ir(variant->gallivm);
+
+   p_atomic_add(&lp->nr_fs_instrs, variant->nr_instrs);
+}
+
+
+static void
+compile_variant_job(void *data, void *gdata, int thread_index)
+{
+   compile_variant(data);
+}
+
+
+static void
+free_variant_job(void *data, void *gdata, int thread_index)
+{
+   FREE(data);
+}
+
+
 /**
  * Generate a new fragment shader variant from the shader code and
  * other state indicated by the key.
+ *
+ * With LP_ASYNC_COMPILE the LLVM compilation is queued and the variant is
+ * returned right away: binning doesn't need the compiled code, and
+ * lp_setup waits for the variants a scene uses before rasterizing it.
  */
 static struct lp_fragment_shader_variant *
 generate_variant(struct llvmpipe_context *lp,
                  struct lp_fragment_shader *shader,
                  const struct lp_fragment_shader_variant_key *key)
 {
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   const bool async = util_queue_is_initialized(&screen->fs_compile_queue);
    struct nir_shader *nir = shader->base.ir.nir;
+
+   struct lp_fs_variant_job sync_job = { 0 };
+   struct lp_fs_variant_job *job = async ? CALLOC_STRUCT(lp_fs_variant_job)
+                                         : &sync_job;
+   if (!job)
+      return NULL;
+
    struct lp_fragment_shader_variant *variant =
       MALLOC(sizeof *variant + shader->variant_key_size - sizeof variant->key);
-   if (!variant)
+   if (!variant) {
+      if (async)
+         FREE(job);
       return NULL;
+   }
 
    memset(variant, 0, sizeof(*variant));
 
    pipe_reference_init(&variant->reference, 1);
+   util_queue_fence_init(&variant->ready);
    lp_fs_reference(lp, &variant->shader, shader);
 
    memcpy(&variant->key, key, shader->variant_key_size);
 
-   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
-   struct lp_cached_code cached = { 0 };
-   unsigned char ir_sha1_cache_key[SHA1_DIGEST_LENGTH];
-   bool needs_caching = false;
-   if (shader->base.ir.nir) {
-      lp_fs_get_ir_cache_key(variant, ir_sha1_cache_key);
-
-      lp_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
-      if (!cached.data_size)
-         needs_caching = true;
-   }
+   /* The context's LLVM context can't be used from the compile queue, give
+    * each queued variant its own.
+    */
+   if (async)
+      lp_context_create(&variant->context);
 
    char module_name[64];
    snprintf(module_name, sizeof(module_name), "fs%u_variant%u",
             shader->no, shader->variants_created);
-   variant->gallivm = gallivm_create(module_name, &lp->context, &cached);
+   variant->gallivm = gallivm_create(module_name,
+                                     async ? &variant->context : &lp->context,
+                                     &job->cached);
    if (!variant->gallivm) {
+      lp_context_destroy(&variant->context);
+      util_queue_fence_destroy(&variant->ready);
+      lp_fs_reference(lp, &variant->shader, NULL);
       FREE(variant);
+      if (async)
+         FREE(job);
       return NULL;
    }
 
@@ -3985,102 +4155,18 @@ generate_variant(struct llvmpipe_context *lp,
       lp_debug_fs_variant(variant);
    }
 
-   llvmpipe_fs_variant_fastpath(variant);
-
-   lp_jit_init_types(variant);
-
-   if (variant->jit_function[RAST_EDGE_TEST] == NULL)
-      generate_fragment(lp, shader, variant, RAST_EDGE_TEST);
-
-   if (variant->jit_function[RAST_WHOLE] == NULL) {
-      if (variant->opaque) {
-         /* Specialized shader, which doesn't need to read the color buffer. */
-         generate_fragment(lp, shader, variant, RAST_WHOLE);
-      }
-   }
-
-   if (linear_pipeline) {
-      /* Currently keeping both the old fastpaths and new linear path
-       * active.  The older code is still somewhat faster for the cases
-       * it covers.
-       *
-       * XXX: consider restricting this to aero-mode only.
-       */
-      if (fullcolormask &&
-          !key->alpha.enabled &&
-          !key->blend.alpha_to_coverage) {
-         llvmpipe_fs_variant_linear_fastpath(variant);
-      }
+   job->lp = lp;
+   job->variant = variant;
+   job->linear_pipeline = linear_pipeline;
+   job->fullcolormask = fullcolormask;
 
-      /* If the original fastpath doesn't cover this variant, try the new
-       * code:
-       */
-      if (variant->jit_linear == NULL) {
-         if (shader->kind == LP_FS_KIND_BLIT_RGBA ||
-             shader->kind == LP_FS_KIND_BLIT_RGB1 ||
-             shader->kind == LP_FS_KIND_LLVM_LINEAR) {
-            llvmpipe_fs_variant_linear_llvm(lp, shader, variant);
-         }
-      }
+   if (async) {
+      util_queue_add_job(&screen->fs_compile_queue, job, &variant->ready,
+                         compile_variant_job, free_variant_job, 0);
    } else {
-      if (LP_DEBUG & DEBUG_LINEAR) {
-         lp_debug_fs_variant(variant);
-         debug_printf("    ----> no linear path for this variant\n");
-      }
-   }
-
-   /*
-    * Compile everything
-    */
-
-#if GALLIVM_USE_ORCJIT
-/* module has been moved into ORCJIT after gallivm_compile_module */
-   variant->nr_instrs += lp_build_count_ir_module(variant->gallivm->module);
-
-   gallivm_compile_module(variant->gallivm);
-#else
-   gallivm_compile_module(variant->gallivm);
-
-   variant->nr_instrs += lp_build_count_ir_module(variant->gallivm->module);
-#endif
-
-   if (variant->function[RAST_EDGE_TEST]) {
-      variant->jit_function[RAST_EDGE_TEST] = (lp_jit_frag_func)
-            gallivm_jit_function(variant->gallivm,
-                                 variant->function[RAST_EDGE_TEST],
-                                 variant->function_name[RAST_EDGE_TEST]);
-   }
-
-   if (variant->function[RAST_WHOLE]) {
-      variant->jit_function[RAST_WHOLE] = (lp_jit_frag_func)
-         gallivm_jit_function(variant->gallivm,
-                              variant->function[RAST_WHOLE],
-                              variant->function_name[RAST_WHOLE]);
-   } else if (!variant->jit_function[RAST_WHOLE]) {
-      variant->jit_function[RAST_WHOLE] = (lp_jit_frag_func)
-         variant->jit_function[RAST_EDGE_TEST];
+      compile_variant(job);
    }
 
-   if (linear_pipeline) {
-      if (variant->linear_function) {
-         variant->jit_linear_llvm = (lp_jit_linear_llvm_func)
-            gallivm_jit_function(variant->gallivm, variant->linear_function,
-                                 variant->linear_function_name);
-      }
-
-      /*
-       * This must be done after LLVM compilation, as it will call the JIT'ed
-       * code to determine active inputs.
-       */
-      lp_linear_check_variant(variant);
-   }
-
-   if (needs_caching) {
-      lp_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
-   }
-
-   gallivm_free_ir(variant->gallivm);
-
    return variant;
 }
 
@@ -4224,14 +4310,19 @@ llvmpipe_remove_shader_variant(struct llvmpipe_context *lp,
                    lp->nr_fs_variants, variant->nr_instrs, lp->nr_fs_instrs);
    }
 
+   /* nr_instrs is only known once the variant is compiled */
+   util_queue_fence_wait(&variant->ready);
+
    /* remove from shader's list */
    list_del(&variant->list_item_local.list);
    variant->shader->variants_cached--;
 
-   /* remove from context's list */
+   /* remove from context's list, which isn't necessarily the one of 'lp'
+    * when the shader is shared between contexts
+    */
    list_del(&variant->list_item_global.list);
-   lp->nr_fs_variants--;
-   lp->nr_fs_instrs -= variant->nr_instrs;
+   variant->lp->nr_fs_variants--;
+   p_atomic_add(&variant->lp->nr_fs_instrs, -(int)variant->nr_instrs);
 }
 
 
@@ -4239,7 +4330,10 @@ void
 llvmpipe_destroy_shader_variant(struct llvmpipe_context *lp,
                                 struct lp_fragment_shader_variant *variant)
 {
+   util_queue_fence_wait(&variant->ready);
+   util_queue_fence_destroy(&variant->ready);
    gallivm_destroy(variant->gallivm);
+   lp_context_destroy(&variant->context);
    lp_fs_reference(lp, &variant->shader, NULL);
    FREE(variant->function_name[RAST_EDGE_TEST]);
    FREE(variant->function_name[RAST_WHOLE]);
@@ -4784,6 +4878,18 @@ llvmpipe_update_fs(struct llvmpipe_context *lp)
        * deletion of shader's when we have too many.
        */
       list_move_to(&variant->list_item_global.list, &lp->fs_variants_list.list);
+
+      if (variant->lp != lp) {
+         /* The shader is shared with another context, take the variant
+          * over into our own accounting.
+          */
+         util_queue_fence_wait(&variant->ready);
+         variant->lp->nr_fs_variants--;
+         p_atomic_add(&variant->lp->nr_fs_instrs, -(int)variant->nr_instrs);
+         variant->lp = lp;
+         lp->nr_fs_variants++;
+         p_atomic_add(&lp->nr_fs_instrs, variant->nr_instrs);
+      }
    } else {
       /* variant not found, create it now */
 
@@ -4849,8 +4955,8 @@ llvmpipe_update_fs(struct llvmpipe_context *lp)
       if (variant) {
          list_add(&variant->list_item_local.list, &shader->variants.list);
          list_add(&variant->list_item_global.list, &lp->fs_variants_list.list);
+         variant->lp = lp;
          lp->nr_fs_variants++;
-         lp->nr_fs_instrs += variant->nr_instrs;
          shader->variants_cached++;
       }
    }
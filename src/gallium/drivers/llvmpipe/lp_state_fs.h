@@ -38,6 +38,8 @@
 #include "gallivm/lp_bld_tgsi.h" /* for lp_tgsi_info */
 #include "lp_bld_interp.h" /* for struct lp_shader_input */
 #include "util/u_inlines.h"
+#include "util/u_queue.h"
+#include "gallivm/lp_bld.h"
 #include "lp_jit.h"
 
 struct lp_fragment_shader;
@@ -156,6 +158,12 @@ struct lp_fragment_shader_variant
    unsigned linear_input_mask:16;
    struct pipe_reference reference;
 
+   /* Signalled once the functions below have been compiled */
+   struct util_queue_fence ready;
+
+   /* Only owned by variants compiled on the screen's compile queue */
+   lp_context_ref context;
+
    struct gallivm_state *gallivm;
 
    LLVMTypeRef jit_context_type;
@@ -191,6 +199,9 @@ struct lp_fragment_shader_variant
    unsigned nr_instrs;
 
    struct lp_fs_variant_list_item list_item_global, list_item_local;
+
+   /* Context whose variant list holds list_item_global */
+   struct llvmpipe_context *lp;
    struct lp_fragment_shader *shader;
 
    /* For debugging/profiling purposes */
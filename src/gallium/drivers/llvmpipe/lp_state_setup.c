@@ -28,6 +28,7 @@
 
 #include "util/u_math.h"
 #include "util/u_memory.h"
+#include "util/mesa-sha1.h"
 #include "util/os_time.h"
 #include "gallivm/lp_bld_arit.h"
 #include "gallivm/lp_bld_bitarit.h"
@@ -628,6 +629,21 @@ init_args(struct gallivm_state *gallivm,
 }
 
 
+static void
+lp_setup_get_ir_cache_key(const struct lp_setup_variant_key *key,
+                          unsigned char ir_sha1_cache_key[SHA1_DIGEST_LENGTH])
+{
+   /* The generated code only depends on the key */
+   static const char tag[] = "llvmpipe setup";
+
+   struct mesa_sha1 ctx;
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, tag, sizeof(tag));
+   _mesa_sha1_update(&ctx, key, key->size);
+   _mesa_sha1_final(&ctx, ir_sha1_cache_key);
+}
+
+
 /**
  * Generate the runtime callable function for the coefficient calculation.
  *
@@ -647,13 +663,26 @@ generate_setup_variant(struct lp_setup_variant_key *key,
 
    variant->no = setup_no++;
 
-   char func_name[64];
-   snprintf(func_name, sizeof(func_name), "setup_variant_%u",
+   char module_name[64];
+   snprintf(module_name, sizeof(module_name), "setup_variant_%u",
             variant->no);
 
+   /* The function name must not depend on the variant number, so that the
+    * cached object code can be used by other processes.
+    */
+   const char *func_name = "setup_variant";
+
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   struct lp_cached_code cached = { 0 };
+   unsigned char ir_sha1_cache_key[SHA1_DIGEST_LENGTH];
+   lp_setup_get_ir_cache_key(key, ir_sha1_cache_key);
+   lp_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
+   bool needs_caching = !cached.data_size;
+
    struct gallivm_state *gallivm;
-   variant->gallivm = gallivm = gallivm_create(func_name, &lp->context, NULL);
+   variant->gallivm = gallivm = gallivm_create(module_name, &lp->context, &cached);
    if (!variant->gallivm) {
+      free(cached.data);
       goto fail;
    }
 
@@ -743,6 +772,9 @@ generate_setup_variant(struct lp_setup_variant_key *key,
    if (!variant->jit_function)
       goto fail;
 
+   if (needs_caching)
+      lp_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
+
    gallivm_free_ir(variant->gallivm);
 
    /*
@@ -24,6 +24,10 @@
 #include "nv50_ir_target.h"
 #include "nv50_ir_driver.h"
 
+#include <inttypes.h>
+
+#include "util/os_time.h"
+
 namespace nv50_ir {
 
 Modifier::Modifier(operation op)
@@ -1304,9 +1308,23 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info,
    prog->dbgFlags = info->dbgFlags;
    prog->optLevel = info->optLevel;
 
+   int64_t start, stage_start;
+   start = stage_start = os_time_get_nano();
+
+// Prints the time since the previous stage with NV50_IR_DEBUG_TIME.
+#define STAGE_DONE(name)                                                  \
+   do {                                                                   \
+      if (prog->dbgFlags & NV50_IR_DEBUG_TIME) {                          \
+         const int64_t now = os_time_get_nano();                          \
+         INFO("%s: %" PRId64 " us\n", name, (now - stage_start) / 1000);  \
+         stage_start = now;                                               \
+      }                                                                   \
+   } while (0)
+
    ret = prog->makeFromNIR(info, info_out) ? 0 : -2;
    if (ret < 0)
       goto out;
+   STAGE_DONE("from_nir");
    if (prog->dbgFlags & NV50_IR_DEBUG_VERBOSE)
       prog->print();
 
@@ -1314,12 +1332,14 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info,
    prog->getTarget()->runLegalizePass(prog, nv50_ir::CG_STAGE_PRE_SSA);
 
    prog->convertToSSA();
+   STAGE_DONE("ssa");
 
    if (prog->dbgFlags & NV50_IR_DEBUG_VERBOSE)
       prog->print();
 
    prog->optimizeSSA(info->optLevel);
    prog->getTarget()->runLegalizePass(prog, nv50_ir::CG_STAGE_SSA);
+   STAGE_DONE("optimize_ssa");
 
    if (prog->dbgFlags & NV50_IR_DEBUG_BASIC)
       prog->print();
@@ -1328,17 +1348,25 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info,
       ret = -4;
       goto out;
    }
+   STAGE_DONE("register_allocation");
    prog->getTarget()->runLegalizePass(prog, nv50_ir::CG_STAGE_POST_RA);
 
    prog->optimizePostRA(info->optLevel);
+   STAGE_DONE("optimize_post_ra");
 
    if (!prog->emitBinary(info_out)) {
       ret = -5;
       goto out;
    }
+   STAGE_DONE("emit");
+
+#undef STAGE_DONE
 
 out:
    INFO_DBG(prog->dbgFlags, VERBOSE, "nv50_ir_generate_code: ret = %i\n", ret);
+   if (prog->dbgFlags & NV50_IR_DEBUG_TIME)
+      INFO("total: %" PRId64 " us, %u bytes\n",
+           (os_time_get_nano() - start) / 1000, prog->binSize);
 
    info_out->bin.maxGPR = prog->maxGPR;
    info_out->bin.code = prog->code;
@@ -71,6 +71,7 @@ struct nv50_ir_sysval
 # define NV50_IR_DEBUG_VERBOSE   0
 # define NV50_IR_DEBUG_REG_ALLOC 0
 #endif
+#define NV50_IR_DEBUG_TIME       (1 << 3)
 
 struct nv50_ir_prog_symbol
 {
@@ -696,8 +696,7 @@ private:
 
    inline void checkInterference(const RIG_Node *, Graph::EdgeIterator&);
 
-   inline void insertOrderedTail(std::list<RIG_Node *>&, RIG_Node *);
-   void checkList(std::list<RIG_Node *>&);
+   void checkList(std::vector<RIG_Node *>&);
 
 private:
    std::stack<uint32_t> stack;
@@ -1136,11 +1135,11 @@ GCRA::~GCRA()
 }
 
 void
-GCRA::checkList(std::list<RIG_Node *>& lst)
+GCRA::checkList(std::vector<RIG_Node *>& lst)
 {
    GCRA::RIG_Node *prev = NULL;
 
-   for (std::list<RIG_Node *>::iterator it = lst.begin();
+   for (std::vector<RIG_Node *>::iterator it = lst.begin();
         it != lst.end();
         ++it) {
       assert((*it)->getValue()->join == (*it)->getValue());
@@ -1150,43 +1149,43 @@ GCRA::checkList(std::list<RIG_Node *>& lst)
    }
 }
 
-void
-GCRA::insertOrderedTail(std::list<RIG_Node *>& list, RIG_Node *node)
-{
-   if (node->livei.isEmpty())
-      return;
-   // only the intervals of joined values don't necessarily arrive in order
-   std::list<RIG_Node *>::iterator prev, it;
-   for (it = list.end(); it != list.begin(); it = prev) {
-      prev = it;
-      --prev;
-      if ((*prev)->livei.begin() <= node->livei.begin())
-         break;
-   }
-   list.insert(it, node);
-}
-
 void
 GCRA::buildRIG(ArrayList& insns)
 {
-   std::list<RIG_Node *> values, active;
+   std::vector<RIG_Node *> values;
+   std::list<RIG_Node *> active;
+
+   values.reserve(nodeCount);
 
    for (std::deque<ValueDef>::iterator it = func->ins.begin();
-        it != func->ins.end(); ++it)
-      insertOrderedTail(values, getNode(it->get()->asLValue()));
+        it != func->ins.end(); ++it) {
+      RIG_Node *node = getNode(it->get()->asLValue());
+      if (!node->livei.isEmpty())
+         values.push_back(node);
+   }
 
    for (unsigned int i = 0; i < insns.getSize(); ++i) {
       Instruction *insn = reinterpret_cast<Instruction *>(insns.get(i));
-      for (int d = 0; insn->defExists(d); ++d)
+      for (int d = 0; insn->defExists(d); ++d) {
          if (insn->getDef(d)->reg.file <= LAST_REGISTER_FILE &&
-             insn->getDef(d)->rep() == insn->getDef(d))
-            insertOrderedTail(values, getNode(insn->getDef(d)->asLValue()));
+             insn->getDef(d)->rep() == insn->getDef(d)) {
+            RIG_Node *node = getNode(insn->getDef(d)->asLValue());
+            if (!node->livei.isEmpty())
+               values.push_back(node);
+         }
+      }
    }
-   checkList(values);
 
-   while (!values.empty()) {
-      RIG_Node *cur = values.front();
+   // Only the intervals of joined values don't necessarily arrive in order.
+   // Sorting once is much cheaper than an ordered insertion of each value for
+   // large functions, and stable so the order of equal starts is kept.
+   std::stable_sort(values.begin(), values.end(),
+                    [](const RIG_Node *a, const RIG_Node *b) {
+                       return a->livei.begin() < b->livei.begin();
+                    });
+   checkList(values);
 
+   for (RIG_Node *cur : values) {
       for (std::list<RIG_Node *>::iterator it = active.begin();
            it != active.end();) {
          RIG_Node *node = *it;
@@ -1199,7 +1198,6 @@ GCRA::buildRIG(ArrayList& insns)
             ++it;
          }
       }
-      values.pop_front();
       active.push_back(cur);
    }
 }
@@ -24,6 +24,7 @@
 #include "pipe/p_shader_tokens.h"
 
 #include "compiler/nir/nir.h"
+#include "util/blob.h"
 
 #include "nv50/nv50_context.h"
 #include "nv50/nv50_program.h"
@@ -327,11 +328,16 @@ nv50_program_create_strmout_state(const struct nv50_ir_prog_info_out *info,
 
 bool
 nv50_program_translate(struct nv50_program *prog, uint16_t chipset,
+                       struct disk_cache *disk_shader_cache,
                        struct util_debug_callback *debug)
 {
+   struct blob blob;
+   size_t cache_size;
    struct nv50_ir_prog_info *info;
    struct nv50_ir_prog_info_out info_out = {};
-   int i, ret;
+   int i, ret = 0;
+   cache_key key;
+   bool shader_loaded = false;
    const uint8_t map_undef = (prog->type == MESA_SHADER_VERTEX) ? 0x40 : 0x80;
 
    info = CALLOC_STRUCT(nv50_ir_prog_info);
@@ -383,11 +389,54 @@ nv50_program_translate(struct nv50_program *prog, uint16_t chipset,
    info->optLevel = 4;
 #endif
 
-   ret = nv50_ir_generate_code(info, &info_out);
-   if (ret) {
-      NOUVEAU_ERR("shader translation failed: %i\n", ret);
-      goto out;
+   blob_init(&blob);
+
+   if (disk_shader_cache) {
+      if (nv50_ir_prog_info_serialize(&blob, info)) {
+         void *cached_data = NULL;
+
+         disk_cache_compute_key(disk_shader_cache, blob.data, blob.size, key);
+         cached_data = disk_cache_get(disk_shader_cache, key, &cache_size);
+
+         if (cached_data && cache_size >= blob.size) { // blob.size is the size of serialized "info"
+            /* Blob contains only "info". In disk cache, "info_out" comes right after it */
+            size_t offset = blob.size;
+            if (nv50_ir_prog_info_out_deserialize(cached_data, cache_size, offset, &info_out))
+               shader_loaded = true;
+            else
+               debug_printf("WARNING: Couldn't deserialize shaders");
+         }
+         free(cached_data);
+      } else {
+         debug_printf("WARNING: Couldn't serialize input shaders");
+      }
+   }
+   if (shader_loaded) {
+      /* The slots stored in info_out are already assigned, but the program
+       * state that is set up along with them is not part of the cache.
+       */
+      ret = nv50_program_assign_varying_slots(&info_out);
+      if (ret) {
+         NOUVEAU_ERR("shader translation failed: %i\n", ret);
+         blob_finish(&blob);
+         goto out;
+      }
+      info->io.mul_zero_wins = info->bin.nir->info.use_legacy_math_rules;
+   } else {
+      ret = nv50_ir_generate_code(info, &info_out);
+      if (ret) {
+         NOUVEAU_ERR("shader translation failed: %i\n", ret);
+         blob_finish(&blob);
+         goto out;
+      }
+      if (disk_shader_cache) {
+         if (nv50_ir_prog_info_out_serialize(&blob, &info_out))
+            disk_cache_put(disk_shader_cache, key, blob.data, blob.size, NULL);
+         else
+            debug_printf("WARNING: Couldn't serialize shaders");
+      }
    }
+   blob_finish(&blob);
 
    prog->code = info_out.bin.code;
    prog->code_size = info_out.bin.codeSize;
@@ -100,6 +100,20 @@ static void r600_dump_streamout(struct pipe_stream_output_info *so)
 	}
 }
 
+static void r600_count_fetch_clauses(struct r600_bytecode *bc,
+				     unsigned *ntex, unsigned *nvtx)
+{
+	struct r600_bytecode_cf *cf;
+
+	*ntex = *nvtx = 0;
+	LIST_FOR_EACH_ENTRY(cf, &bc->cf, list) {
+		if (cf->op == CF_OP_TEX)
+			(*ntex)++;
+		else if (cf->op == CF_OP_VTX)
+			(*nvtx)++;
+	}
+}
+
 static int store_shader(struct pipe_context *ctx,
 			struct r600_pipe_shader *shader)
 {
@@ -276,14 +290,17 @@ int r600_pipe_shader_create(struct pipe_context *ctx,
 	}
 
 	if (unlikely(rctx->screen->b.debug_flags & DBG_SHADER_DB)) {
-		util_debug_message(&rctx->b.debug, SHADER_INFO, "%s shader: %d dw, %d gprs, %d alu_groups, %d loops, %d cf, %d stack",
+		unsigned ntex, nvtx;
+		r600_count_fetch_clauses(&shader->shader.bc, &ntex, &nvtx);
+		util_debug_message(&rctx->b.debug, SHADER_INFO, "%s shader: %d dw, %d gprs, %d alu_groups, %d loops, %d cf, %d stack, %u tex clauses, %u vtx clauses",
 				   _mesa_shader_stage_to_abbrev(processor),
 				   shader->shader.bc.ndw,
 				   shader->shader.bc.ngpr,
 				   shader->shader.bc.nalu_groups,
 				   shader->shader.num_loops,
 				   shader->shader.bc.ncf,
-				   shader->shader.bc.nstack);
+				   shader->shader.bc.nstack,
+				   ntex, nvtx);
 	}
 
 	if (!sel->nir_blob && sel->nir && sel->ir_type != PIPE_SHADER_IR_TGSI) {
@@ -45,6 +45,7 @@ static const struct debug_named_value sfn_debug_options[] = {
    {"opt",      SfnLog::opt,         "Log optimization"                     },
    {"steps",    SfnLog::steps,       "Log shaders at transformation steps"  },
    {"noopt",    SfnLog::noopt,       "Don't run backend optimizations"      },
+   {"texgroup", SfnLog::texgroup,    "Schedule for larger TEX clauses"      },
    {"warn" ,    SfnLog::warn,        "Print warnings"                       },
    DEBUG_NAMED_VALUE_END
 };
@@ -50,6 +50,7 @@ public:
       nomerge = 1 << 16,
       steps = 1 << 17,
       noopt = 1 << 18,
+      texgroup = 1 << 19,
       warn = 1 << 20,
    };
 
@@ -6,6 +6,7 @@
 
 #include "sfn_memorypool.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -32,17 +33,33 @@ struct MemoryBacking {
 
 struct MemoryPoolImpl {
 public:
-   MemoryPoolImpl();
+   MemoryPoolImpl(void *buffer, size_t buffer_size);
    ~MemoryPoolImpl();
 #ifdef HAVE_MEMORY_RESOURCE
    using MemoryBacking = ::std::pmr::monotonic_buffer_resource;
 #endif
    MemoryBacking *pool;
+   size_t used;
 };
 
+/* The pool keeps a buffer of the size the largest compile on this thread
+ * needed so far, up to this size, and hands it to the next compile, so that
+ * the common case doesn't have to go to malloc at all.
+ */
+static const size_t max_retained_size = 8 * 1024 * 1024;
+
 MemoryPool::MemoryPool() noexcept:
-    impl(nullptr)
+    impl(nullptr),
+    m_buffer(nullptr),
+    m_buffer_size(0),
+    m_peak_size(0)
+{
+}
+
+MemoryPool::~MemoryPool()
 {
+   free();
+   ::free(m_buffer);
 }
 
 MemoryPool&
@@ -55,6 +72,12 @@ MemoryPool::instance()
 void
 MemoryPool::free()
 {
+   if (!impl)
+      return;
+
+   if (impl->used > m_peak_size)
+      m_peak_size = impl->used;
+
    delete impl;
    impl = nullptr;
 }
@@ -62,14 +85,35 @@ MemoryPool::free()
 void
 MemoryPool::initialize()
 {
-   if (!impl)
-      impl = new MemoryPoolImpl();
+   if (impl)
+      return;
+
+#ifdef HAVE_MEMORY_RESOURCE
+   size_t wanted_size = std::min(m_peak_size, max_retained_size);
+   if (wanted_size > m_buffer_size) {
+      /* Some headroom, so that slightly larger shaders fit, too. */
+      wanted_size = std::min(wanted_size + wanted_size / 4, max_retained_size);
+
+      ::free(m_buffer);
+      m_buffer = malloc(wanted_size);
+      m_buffer_size = m_buffer ? wanted_size : 0;
+   }
+#endif
+
+   impl = new MemoryPoolImpl(m_buffer, m_buffer_size);
+}
+
+size_t
+MemoryPool::peak_size() const
+{
+   return impl && impl->used > m_peak_size ? impl->used : m_peak_size;
 }
 
 void *
 MemoryPool::allocate(size_t size)
 {
    assert(impl);
+   impl->used += size;
    return impl->pool->allocate(size);
 }
 
@@ -77,6 +121,7 @@ void *
 MemoryPool::allocate(size_t size, size_t align)
 {
    assert(impl);
+   impl->used += size;
    return impl->pool->allocate(size, align);
 }
 
@@ -110,7 +155,20 @@ Allocate::operator delete(void *p, size_t size)
    // MemoryPool::instance().deallocate(p, size);
 }
 
-MemoryPoolImpl::MemoryPoolImpl() { pool = new MemoryBacking(); }
+MemoryPoolImpl::MemoryPoolImpl(void *buffer, size_t buffer_size):
+    used(0)
+{
+#ifdef HAVE_MEMORY_RESOURCE
+   if (buffer_size)
+      pool = new MemoryBacking(buffer, buffer_size);
+   else
+      pool = new MemoryBacking();
+#else
+   (void)buffer;
+   (void)buffer_size;
+   pool = new MemoryBacking();
+#endif
+}
 
 MemoryPoolImpl::~MemoryPoolImpl() { delete pool; }
 
@@ -34,13 +34,22 @@ public:
    void free();
    void initialize();
 
+   /* The most memory a single compile on this thread used so far. */
+   size_t peak_size() const;
+
    void *allocate(size_t size);
    void *allocate(size_t size, size_t align);
 
 private:
    MemoryPool() noexcept;
+   ~MemoryPool();
 
    struct MemoryPoolImpl *impl;
+
+   /* Kept across compiles on this thread, see initialize(). */
+   void *m_buffer;
+   size_t m_buffer_size;
+   size_t m_peak_size;
 };
 
 template <typename T> struct Allocator {
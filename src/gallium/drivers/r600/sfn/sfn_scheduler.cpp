@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <sstream>
+#include <unordered_set>
 
 namespace r600 {
 
@@ -165,6 +166,7 @@ private:
                                     AluInstr **predicate);
 
    bool schedule_tex(Shader::ShaderBlocks& out_blocks);
+   bool feeds_pending_tex(const AluInstr& alu) const;
    bool schedule_vtx(Shader::ShaderBlocks& out_blocks);
 
    template <typename I>
@@ -210,6 +212,11 @@ private:
    std::list<Instr *> gds_ready;
    std::list<Instr *> waitacks_ready;
 
+   /* TEX instructions of the current block that are not ready yet, only
+    * tracked with SfnLog::texgroup. */
+   std::unordered_set<const Instr *> m_pending_tex;
+   bool m_group_tex{false};
+
    enum {
       sched_alu,
       sched_tex,
@@ -292,6 +299,8 @@ BlockScheduler::BlockScheduler(r600_chip_class chip_class,
                          chip_family != CHIP_RV670 &&
                          chip_family != CHIP_RS780 &&
                          chip_family != CHIP_RS880;
+
+   m_group_tex = sfn_log.has_debug_flag(SfnLog::texgroup);
 }
 
 void
@@ -325,6 +334,10 @@ BlockScheduler::schedule_block(Block& in_block, Shader::ShaderBlocks& out_blocks
    CollectInstructions cir(*m_vf);
    in_block.accept(cir);
 
+   m_pending_tex.clear();
+   if (m_group_tex)
+      m_pending_tex.insert(cir.tex.begin(), cir.tex.end());
+
    bool have_instr = collect_ready(cir);
 
    m_current_block = new Block(in_block.nesting_depth(), m_next_block_id++);
@@ -746,12 +759,29 @@ BlockScheduler::schedule_tex(Shader::ShaderBlocks& out_blocks)
       (*ii)->pin_dest_to_chan();
       (*ii)->set_scheduled();
       m_current_block->push_back(*ii);
+      m_pending_tex.erase(*ii);
       tex_ready.erase(ii);
       return true;
    }
    return false;
 }
 
+/* Whether the ALU instruction computes a source of a TEX instruction that
+ * isn't scheduled yet. */
+bool
+BlockScheduler::feeds_pending_tex(const AluInstr& alu) const
+{
+   auto dest = alu.dest();
+   if (!dest || !dest->has_flag(Register::ssa))
+      return false;
+
+   for (auto use : dest->uses()) {
+      if (m_pending_tex.count(use))
+         return true;
+   }
+   return false;
+}
+
 bool
 BlockScheduler::schedule_vtx(Shader::ShaderBlocks& out_blocks)
 {
@@ -1317,6 +1347,15 @@ BlockScheduler::collect_ready_alu_vec(std::list<AluInstr *>& ready,
 
          priority += 100 * (*i)->register_priority();
 
+         /* Compute the sources of TEX instructions first, so that more of
+          * them are ready when the ALU runs out of work and they end up in
+          * one clause. Once a full clause is ready this would only increase
+          * the register pressure, so stop there. */
+         if (m_group_tex &&
+             tex_ready.size() < (m_chip_class >= ISA_CC_EVERGREEN ? 16u : 8u) &&
+             feeds_pending_tex(**i))
+            priority += 150;
+
          (*i)->add_priority(priority);
          ready.push_back(*i);
 
@@ -1835,7 +1835,13 @@ static void radeon_enc_encode_bitstream(struct pipe_video_codec *encoder,
 
    *fb = enc->fb = CALLOC_STRUCT(radeon_enc_fb_buffer);
 
-   enc->fb->res = si_resource(pipe_buffer_create(enc->screen, 0, PIPE_USAGE_STAGING, 4096));
+   if (enc->fb_cache_count) {
+      enc->fb->res = enc->fb_cache[--enc->fb_cache_count];
+      enc->fb_cache[enc->fb_cache_count] = NULL;
+   } else {
+      enc->fb->res = si_resource(pipe_buffer_create(enc->screen, 0, PIPE_USAGE_STAGING,
+                                                    RADEON_ENC_FB_SIZE));
+   }
    if (!enc->fb->res) {
       RADEON_ENC_ERR("Can't create feedback buffer.\n");
       return;
@@ -1996,6 +2002,8 @@ static void radeon_enc_destroy(struct pipe_video_codec *encoder)
       si_resource_reference(&enc->si, NULL);
    }
 
+   for (unsigned i = 0; i < enc->fb_cache_count; i++)
+      si_resource_reference(&enc->fb_cache[i], NULL);
    si_resource_reference(&enc->dpb, NULL);
    si_resource_reference(&enc->cdf, NULL);
    si_resource_reference(&enc->roi, NULL);
@@ -2019,6 +2027,14 @@ static void radeon_enc_get_feedback(struct pipe_video_codec *encoder, void *feed
       *size = ptr[6] - ptr[8];
    else
       *size = 0;
+
+   /* The buffer is idle now, so it can be handed to a later frame. Clear it
+    * so that a failed encode can't report the size of an older one.
+    */
+   if (enc->fb_cache_count < RADEON_ENC_FB_CACHE_SIZE) {
+      memset(ptr, 0, RADEON_ENC_FB_SIZE);
+      si_resource_reference(&enc->fb_cache[enc->fb_cache_count++], fb->res);
+   }
    enc->ws->buffer_unmap(enc->ws, fb->res->buf);
 
    metadata->present_metadata = PIPE_VIDEO_FEEDBACK_METADATA_TYPE_CODEC_UNIT_LOCATION;
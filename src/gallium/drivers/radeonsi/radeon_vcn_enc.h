@@ -45,6 +45,9 @@
       mesa_loge("%s:%d %s VCN - " fmt, __FILE__, __LINE__, __func__, ##args);           \
    } while(0)
 
+#define RADEON_ENC_FB_SIZE 4096
+#define RADEON_ENC_FB_CACHE_SIZE 16
+
 typedef void (*radeon_enc_get_buffer)(struct pipe_resource *resource, struct pb_buffer_lean **handle,
                                       struct radeon_surf **surface);
 
@@ -231,6 +234,9 @@ struct radeon_encoder {
 
    struct si_resource *si;
    struct radeon_enc_fb_buffer *fb;
+   /* Feedback buffers of retrieved frames, reused for the next ones. */
+   struct si_resource *fb_cache[RADEON_ENC_FB_CACHE_SIZE];
+   unsigned fb_cache_count;
    struct si_resource *dpb;
    struct si_resource *cdf;
    struct si_resource *roi;
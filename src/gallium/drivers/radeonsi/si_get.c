@@ -675,6 +675,7 @@ static struct disk_cache *si_get_disk_shader_cache(struct pipe_screen *pscreen)
 {
    struct si_screen *sscreen = (struct si_screen *)pscreen;
 
+   si_init_disk_shader_cache(sscreen);
    return sscreen->disk_shader_cache;
 }
 
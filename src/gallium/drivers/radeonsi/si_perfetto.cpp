@@ -64,23 +64,18 @@ using perfetto::protos::pbzero::InternedGpuRenderStageSpecification_RenderStageC
 
 static void sync_timestamp(SIRenderpassDataSource::TraceContext &ctx, struct si_ds_device *device)
 {
-   uint64_t cpu_ts, gpu_ts;
-
    struct si_context *sctx = container_of(device, struct si_context, ds);
-   gpu_ts = sctx->screen->b.get_timestamp(&sctx->screen->b);
-
    uint32_t cpu_clock_id = perfetto::protos::pbzero::BUILTIN_CLOCK_BOOTTIME;
-   cpu_ts = perfetto::base::GetBootTimeNs().count();
-
-   if (cpu_ts < device->next_clock_sync_ns)
-      return;
-
-   PERFETTO_LOG("sending clocks gpu=0x%08x", device->gpu_clock_id);
 
-   device->sync_gpu_ts = gpu_ts;
-   device->next_clock_sync_ns = cpu_ts + 1000000000ull;
    MesaRenderpassDataSource<SIRenderpassDataSource, SIRenderpassTraits>::
-      EmitClockSync(ctx, cpu_ts, gpu_ts, cpu_clock_id, device->gpu_clock_id);
+      MaybeEmitClockSync(ctx, device->next_clock_sync_ns,
+                         MESA_RENDERPASS_CLOCK_SYNC_PERIOD_NS,
+                         cpu_clock_id, device->gpu_clock_id,
+                         [sctx, device](uint64_t &cpu_ts, uint64_t &gpu_ts) {
+         gpu_ts = sctx->screen->b.get_timestamp(&sctx->screen->b);
+         cpu_ts = perfetto::base::GetBootTimeNs().count();
+         device->sync_gpu_ts = gpu_ts;
+      });
 }
 
 static void send_descriptors(SIRenderpassDataSource::TraceContext &ctx,
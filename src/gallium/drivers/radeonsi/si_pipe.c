@@ -121,6 +121,8 @@ static const struct debug_named_value radeonsi_shader_debug_options[] = {
    {"checkir", DBG(CHECK_IR), "Enable additional sanity checks on shader IR"},
    {"mono", DBG(MONOLITHIC_SHADERS), "Use old-style monolithic shaders compiled on demand"},
    {"nooptvariant", DBG(NO_OPT_VARIANT), "Disable compiling optimized shader variants."},
+   {"novariantpredict", DBG(NO_VARIANT_PREDICTION),
+    "Don't precompile shader variants that previous runs needed."},
    {"usellvm", DBG(USE_LLVM), "Use LLVM as shader compiler when possible"},
 
    DEBUG_NAMED_VALUE_END /* must be last */
@@ -151,6 +153,7 @@ static const struct debug_named_value test_options[] = {
    {"dmaperf", DBG(TEST_DMA_PERF), "Test DMA performance"},
    {"testmemperf", DBG(TEST_MEM_PERF), "Test map + memcpy perf using the winsys."},
    {"blitperf", DBG(TEST_BLIT_PERF), "Test gfx and compute clear/copy/blit/resolve performance"},
+   {"drawperf", DBG(TEST_DRAW_PERF), "Test draw, dispatch and descriptor update performance"},
 
    DEBUG_NAMED_VALUE_END /* must be last */
 };
@@ -525,6 +528,8 @@ static struct pipe_context *si_create_context(struct pipe_screen *screen, unsign
       return NULL;
    }
 
+   si_init_disk_shader_cache(sscreen);
+
    struct si_context *sctx = CALLOC_STRUCT(si_context);
    struct radeon_winsys *ws = sscreen->ws;
 
@@ -862,7 +867,14 @@ static struct pipe_context *si_create_context(struct pipe_screen *screen, unsign
 
       /* Check if the aux_context needs to be recreated */
       for (unsigned i = 0; i < ARRAY_SIZE(sscreen->aux_contexts); i++) {
-         struct si_context *saux = si_get_aux_context(&sscreen->aux_contexts[i]);
+         /* Don't create aux contexts that haven't been used yet. */
+         mtx_lock(&sscreen->aux_contexts[i].lock);
+         struct si_context *saux = (struct si_context *)sscreen->aux_contexts[i].ctx;
+         if (!saux) {
+            mtx_unlock(&sscreen->aux_contexts[i].lock);
+            continue;
+         }
+
          enum pipe_reset_status status =
             sctx->ws->ctx_query_reset_status(saux->ctx, true, NULL, NULL);
 
@@ -955,6 +967,12 @@ static bool si_is_resource_busy(struct pipe_screen *screen, struct pipe_resource
                            RADEON_USAGE_DISALLOW_SLOW_REPLY);
 }
 
+static struct pipe_context *si_create_tc_helper_context(struct pipe_screen *screen)
+{
+   return si_create_context(screen, PIPE_CONTEXT_COMPUTE_ONLY |
+                                    PIPE_CONTEXT_LOSE_CONTEXT_ON_RESET);
+}
+
 static struct pipe_context *si_pipe_create_context(struct pipe_screen *screen, void *priv,
                                                    unsigned flags)
 {
@@ -1005,6 +1023,8 @@ static struct pipe_context *si_pipe_create_context(struct pipe_screen *screen, v
                                  .is_resource_busy = si_is_resource_busy,
                                  .driver_calls_flush_notify = true,
                                  .unsynchronized_create_fence_fd = true,
+                                 .create_helper_context = sscreen->info.is_amdgpu ?
+                                       si_create_tc_helper_context : NULL,
                               },
                               &((struct si_context *)ctx)->tc);
 
@@ -1041,19 +1061,18 @@ void si_destroy_screen(struct pipe_screen *pscreen)
    pipe_resource_reference(&sscreen->tess_rings_tmz, NULL);
 
    for (unsigned i = 0; i < ARRAY_SIZE(sscreen->aux_contexts); i++) {
-      if (!sscreen->aux_contexts[i].ctx)
-         continue;
-
-      struct si_context *saux = si_get_aux_context(&sscreen->aux_contexts[i]);
-      struct u_log_context *aux_log = saux->log;
-      if (aux_log) {
-         saux->b.set_log_context(&saux->b, NULL);
-         u_log_context_destroy(aux_log);
-         FREE(aux_log);
-      }
+      struct si_context *saux = (struct si_context *)sscreen->aux_contexts[i].ctx;
+
+      if (saux) {
+         struct u_log_context *aux_log = saux->log;
+         if (aux_log) {
+            saux->b.set_log_context(&saux->b, NULL);
+            u_log_context_destroy(aux_log);
+            FREE(aux_log);
+         }
 
-      saux->b.destroy(&saux->b);
-      mtx_unlock(&sscreen->aux_contexts[i].lock);
+         saux->b.destroy(&saux->b);
+      }
       mtx_destroy(&sscreen->aux_contexts[i].lock);
    }
 
@@ -1097,6 +1116,7 @@ void si_destroy_screen(struct pipe_screen *pscreen)
    simple_mtx_destroy(&sscreen->gpu_load_mutex);
    simple_mtx_destroy(&sscreen->gds_mutex);
    simple_mtx_destroy(&sscreen->tess_ring_lock);
+   simple_mtx_destroy(&sscreen->disk_shader_cache_lock);
 
    radeon_bo_reference(sscreen->ws, &sscreen->gds_oa, NULL);
 
@@ -1120,8 +1140,8 @@ static void si_init_gs_info(struct si_screen *sscreen)
 
 static void si_test_vmfault(struct si_screen *sscreen, uint64_t test_flags)
 {
-   struct pipe_context *ctx = sscreen->aux_context.general.ctx;
-   struct si_context *sctx = (struct si_context *)ctx;
+   struct si_context *sctx = si_get_aux_context(&sscreen->aux_context.general);
+   struct pipe_context *ctx = &sctx->b;
    struct pipe_resource *buf = pipe_buffer_create_const0(&sscreen->b, 0, PIPE_USAGE_DEFAULT, 64);
 
    if (!buf) {
@@ -1196,6 +1216,19 @@ static void si_disk_cache_create(struct si_screen *sscreen)
                                                   cache_id, sscreen->info.address32_hi);
 }
 
+void si_init_disk_shader_cache(struct si_screen *sscreen)
+{
+   if (p_atomic_read(&sscreen->disk_shader_cache_initialized))
+      return;
+
+   simple_mtx_lock(&sscreen->disk_shader_cache_lock);
+   if (!sscreen->disk_shader_cache_initialized) {
+      si_disk_cache_create(sscreen);
+      p_atomic_set(&sscreen->disk_shader_cache_initialized, true);
+   }
+   simple_mtx_unlock(&sscreen->disk_shader_cache_lock);
+}
+
 static void si_set_max_shader_compiler_threads(struct pipe_screen *screen, unsigned max_threads)
 {
    struct si_screen *sscreen = (struct si_screen *)screen;
@@ -1443,6 +1476,7 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    (void)simple_mtx_init(&sscreen->gpu_load_mutex, mtx_plain);
    (void)simple_mtx_init(&sscreen->gds_mutex, mtx_plain);
    (void)simple_mtx_init(&sscreen->tess_ring_lock, mtx_plain);
+   (void)simple_mtx_init(&sscreen->disk_shader_cache_lock, mtx_plain);
 
    si_init_gs_info(sscreen);
    if (!si_init_shader_cache(sscreen)) {
@@ -1454,8 +1488,6 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    if (sscreen->info.gfx_level < GFX10_3)
       sscreen->options.vrs2x2 = false;
 
-   si_disk_cache_create(sscreen);
-
    /* Determine the number of shader compiler threads. */
    const struct util_cpu_caps_t *caps = util_get_cpu_caps();
    hw_threads = caps->nr_cpus;
@@ -1500,7 +1532,8 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    if (!util_queue_init(&sscreen->shader_compiler_queue, "sh", num_slots,
                         num_comp_hi_threads,
                         UTIL_QUEUE_INIT_RESIZE_IF_FULL |
-                        UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL)) {
+                        UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY |
+                        UTIL_QUEUE_INIT_WORK_STEALING, NULL)) {
       si_destroy_shader_cache(sscreen);
       FREE(sscreen->nir_options);
       FREE(sscreen);
@@ -1511,7 +1544,8 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    if (!util_queue_init(&sscreen->shader_compiler_queue_opt_variants, "sh_opt", num_slots,
                         num_comp_lo_threads,
                         UTIL_QUEUE_INIT_RESIZE_IF_FULL |
-                        UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL)) {
+                        UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY |
+                        UTIL_QUEUE_INIT_WORK_STEALING, NULL)) {
       si_destroy_shader_cache(sscreen);
       FREE(sscreen->nir_options);
       FREE(sscreen);
@@ -1628,25 +1662,20 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
                                   2 * 1024 * 1024);
    }
 
-   /* Create the auxiliary context. This must be done last. */
+   /* Set up the auxiliary contexts. They are created on first use, because screens that are
+    * only used for allocations (e.g. GBM) or queries may never need them.
+    */
    for (unsigned i = 0; i < ARRAY_SIZE(sscreen->aux_contexts); i++) {
       (void)mtx_init(&sscreen->aux_contexts[i].lock, mtx_plain | mtx_recursive);
 
       bool compute = !sscreen->info.has_graphics ||
                      &sscreen->aux_contexts[i] == &sscreen->aux_context.compute_resource_init ||
                      &sscreen->aux_contexts[i] == &sscreen->aux_context.shader_upload;
-      sscreen->aux_contexts[i].ctx =
-         si_create_context(&sscreen->b,
-                           SI_CONTEXT_FLAG_AUX | PIPE_CONTEXT_LOSE_CONTEXT_ON_RESET |
-                           (sscreen->options.aux_debug ? PIPE_CONTEXT_DEBUG : 0) |
-                           (compute ? PIPE_CONTEXT_COMPUTE_ONLY : 0));
-
-      if (sscreen->options.aux_debug) {
-         u_log_context_init(&sscreen->aux_contexts[i].log);
-
-         struct pipe_context *ctx = sscreen->aux_contexts[i].ctx;
-         ctx->set_log_context(ctx, &sscreen->aux_contexts[i].log);
-      }
+      sscreen->aux_contexts[i].screen = sscreen;
+      sscreen->aux_contexts[i].context_flags =
+         SI_CONTEXT_FLAG_AUX | PIPE_CONTEXT_LOSE_CONTEXT_ON_RESET |
+         (sscreen->options.aux_debug ? PIPE_CONTEXT_DEBUG : 0) |
+         (compute ? PIPE_CONTEXT_COMPUTE_ONLY : 0);
    }
 
    if (test_flags & DBG(TEST_CLEAR_BUFFER))
@@ -1670,6 +1699,9 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    if (test_flags & DBG(TEST_BLIT_PERF))
       si_test_blit_perf(sscreen);
 
+   if (test_flags & DBG(TEST_DRAW_PERF))
+      si_test_draw_perf(sscreen);
+
    if (test_flags & (DBG(TEST_VMFAULT_CP) | DBG(TEST_VMFAULT_SHADER)))
       si_test_vmfault(sscreen, test_flags);
 
@@ -1727,6 +1759,15 @@ struct pipe_screen *radeonsi_screen_create(int fd, const struct pipe_screen_conf
 struct si_context *si_get_aux_context(struct si_aux_context *ctx)
 {
    mtx_lock(&ctx->lock);
+
+   if (!ctx->ctx) {
+      ctx->ctx = si_create_context(&ctx->screen->b, ctx->context_flags);
+
+      if (ctx->ctx && ctx->screen->options.aux_debug) {
+         u_log_context_init(&ctx->log);
+         ctx->ctx->set_log_context(ctx->ctx, &ctx->log);
+      }
+   }
    return (struct si_context*)ctx->ctx;
 }
 
@@ -256,6 +256,7 @@ enum
    DBG_CHECK_IR,
    DBG_MONOLITHIC_SHADERS,
    DBG_NO_OPT_VARIANT,
+   DBG_NO_VARIANT_PREDICTION,
 
    DBG_USE_LLVM,
 };
@@ -285,6 +286,7 @@ enum
    DBG_TEST_DMA_PERF,
    DBG_TEST_MEM_PERF,
    DBG_TEST_BLIT_PERF,
+   DBG_TEST_DRAW_PERF,
 };
 
 #define DBG_ALL_SHADERS (((1 << (DBG_MS + 1)) - 1))
@@ -531,12 +533,20 @@ struct si_aux_context {
    struct pipe_context *ctx;
    struct u_log_context log;
    mtx_t lock;
+   /* The context is created by si_get_aux_context on first use. */
+   struct si_screen *screen;
+   unsigned context_flags;
 };
 
 struct si_screen {
    struct pipe_screen b;
    struct radeon_winsys *ws;
    struct disk_cache *disk_shader_cache;
+   /* The disk cache is opened by si_init_disk_shader_cache when the first
+    * context is created, so that allocation-only users don't pay for it.
+    */
+   simple_mtx_t disk_shader_cache_lock;
+   bool disk_shader_cache_initialized;
 
    struct radeon_info info;
    struct nir_shader_compiler_options *nir_options;
@@ -1136,6 +1146,13 @@ struct si_context {
    bool vertex_buffers_dirty;
    uint16_t vertex_buffer_unaligned; /* bitmask of not dword-aligned buffers */
    struct pipe_vertex_buffer vertex_buffer[SI_NUM_VERTEX_BUFFERS];
+   /* The last uploaded list of VB descriptors that don't fit into user SGPRs.
+    * The first half is scratch space for the new list, the second half is the last upload.
+    */
+   uint32_t vb_desc_cache[2 * 4 * SI_MAX_ATTRIBS];
+   unsigned vb_desc_cache_size; /* in bytes, 0 = invalid */
+   unsigned vb_desc_cache_ib;   /* num_gfx_cs_flushes at the time of the upload */
+   uint64_t vb_desc_cache_va;
 
    /* MSAA config state. */
    uint8_t ps_iter_samples;
@@ -1643,6 +1660,7 @@ void si_init_compute_functions(struct si_context *sctx);
 /* si_pipe.c */
 struct ac_llvm_compiler *si_create_llvm_compiler(struct si_screen *sscreen);
 void si_init_aux_async_compute_ctx(struct si_screen *sscreen);
+void si_init_disk_shader_cache(struct si_screen *sscreen);
 struct si_context *si_get_aux_context(struct si_aux_context *ctx);
 void si_put_aux_context_flush(struct si_aux_context *ctx);
 void si_get_scratch_tmpring_size(struct si_context *sctx, unsigned bytes_per_wave,
@@ -1696,6 +1714,9 @@ void si_test_copy_buffer(struct si_screen *sscreen);
 /* si_test_blit_perf.c */
 void si_test_blit_perf(struct si_screen *sscreen);
 
+/* si_test_draw_perf.c */
+void si_test_draw_perf(struct si_screen *sscreen);
+
 /* si_uvd.c */
 struct pipe_video_codec *si_uvd_create_decoder(struct pipe_context *context,
                                                const struct pipe_video_codec *templ);
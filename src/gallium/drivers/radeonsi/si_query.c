@@ -153,6 +153,27 @@ static bool si_query_sw_begin(struct si_context *sctx, struct si_query *squery)
    case SI_QUERY_TC_NUM_SYNCS:
       query->begin_result = sctx->tc ? sctx->tc->num_syncs : 0;
       break;
+   case SI_QUERY_TC_SYNCS_FLUSH:
+      query->begin_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_FLUSH] : 0;
+      break;
+   case SI_QUERY_TC_SYNCS_MAP:
+      query->begin_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_MAP] : 0;
+      break;
+   case SI_QUERY_TC_SYNCS_QUERY:
+      query->begin_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_QUERY] : 0;
+      break;
+   case SI_QUERY_TC_SYNCS_OTHER:
+      query->begin_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_OTHER] : 0;
+      break;
+   case SI_QUERY_TC_NUM_BATCHES:
+      query->begin_result = sctx->tc ? sctx->tc->num_batches : 0;
+      break;
+   case SI_QUERY_TC_BATCH_FILL:
+      query->begin_result = 0;
+      break;
+   case SI_QUERY_TC_SYNC_WAIT_TIME:
+      query->begin_result = sctx->tc ? sctx->tc->sync_wait_time_ns : 0;
+      break;
    case SI_QUERY_REQUESTED_VRAM:
    case SI_QUERY_REQUESTED_GTT:
    case SI_QUERY_MAPPED_VRAM:
@@ -309,6 +330,27 @@ static bool si_query_sw_end(struct si_context *sctx, struct si_query *squery)
    case SI_QUERY_TC_NUM_SYNCS:
       query->end_result = sctx->tc ? sctx->tc->num_syncs : 0;
       break;
+   case SI_QUERY_TC_SYNCS_FLUSH:
+      query->end_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_FLUSH] : 0;
+      break;
+   case SI_QUERY_TC_SYNCS_MAP:
+      query->end_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_MAP] : 0;
+      break;
+   case SI_QUERY_TC_SYNCS_QUERY:
+      query->end_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_QUERY] : 0;
+      break;
+   case SI_QUERY_TC_SYNCS_OTHER:
+      query->end_result = sctx->tc ? sctx->tc->num_syncs_by_reason[TC_SYNC_OTHER] : 0;
+      break;
+   case SI_QUERY_TC_NUM_BATCHES:
+      query->end_result = sctx->tc ? sctx->tc->num_batches : 0;
+      break;
+   case SI_QUERY_TC_BATCH_FILL:
+      query->end_result = sctx->tc ? sctx->tc->batch_fill_percent : 0;
+      break;
+   case SI_QUERY_TC_SYNC_WAIT_TIME:
+      query->end_result = sctx->tc ? sctx->tc->sync_wait_time_ns : 0;
+      break;
    case SI_QUERY_REQUESTED_VRAM:
    case SI_QUERY_REQUESTED_GTT:
    case SI_QUERY_MAPPED_VRAM:
@@ -459,6 +501,7 @@ static bool si_query_sw_get_result(struct si_context *sctx, struct si_query *squ
 
    switch (query->b.type) {
    case SI_QUERY_BUFFER_WAIT_TIME:
+   case SI_QUERY_TC_SYNC_WAIT_TIME:
    case SI_QUERY_GPU_TEMPERATURE:
       result->u64 /= 1000;
       break;
@@ -1774,6 +1817,13 @@ static struct pipe_driver_query_info si_driver_query_list[] = {
    X("tc-offloaded-slots", TC_OFFLOADED_SLOTS, UINT64, AVERAGE),
    X("tc-direct-slots", TC_DIRECT_SLOTS, UINT64, AVERAGE),
    X("tc-num-syncs", TC_NUM_SYNCS, UINT64, AVERAGE),
+   X("tc-syncs-flush", TC_SYNCS_FLUSH, UINT64, AVERAGE),
+   X("tc-syncs-map", TC_SYNCS_MAP, UINT64, AVERAGE),
+   X("tc-syncs-query", TC_SYNCS_QUERY, UINT64, AVERAGE),
+   X("tc-syncs-other", TC_SYNCS_OTHER, UINT64, AVERAGE),
+   X("tc-num-batches", TC_NUM_BATCHES, UINT64, AVERAGE),
+   X("tc-batch-fill", TC_BATCH_FILL, PERCENTAGE, AVERAGE),
+   X("tc-sync-wait-time", TC_SYNC_WAIT_TIME, MICROSECONDS, CUMULATIVE),
    X("CS-thread-busy", CS_THREAD_BUSY, UINT64, AVERAGE),
    X("gallium-thread-busy", GALLIUM_THREAD_BUSY, UINT64, AVERAGE),
    X("requested-VRAM", REQUESTED_VRAM, BYTES, AVERAGE),
@@ -1901,6 +1951,9 @@ static int si_get_driver_query_info(struct pipe_screen *screen, unsigned index,
    case SI_QUERY_GPU_TEMPERATURE:
       info->max_value.u64 = 125;
       break;
+   case SI_QUERY_TC_BATCH_FILL:
+      info->max_value.u64 = 100;
+      break;
    case SI_QUERY_VRAM_VIS_USAGE:
       info->max_value.u64 = (uint64_t)sscreen->info.vram_vis_size_kb * 1024;
       break;
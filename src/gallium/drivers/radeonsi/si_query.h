@@ -42,6 +42,13 @@ enum
    SI_QUERY_TC_OFFLOADED_SLOTS,
    SI_QUERY_TC_DIRECT_SLOTS,
    SI_QUERY_TC_NUM_SYNCS,
+   SI_QUERY_TC_SYNCS_FLUSH,
+   SI_QUERY_TC_SYNCS_MAP,
+   SI_QUERY_TC_SYNCS_QUERY,
+   SI_QUERY_TC_SYNCS_OTHER,
+   SI_QUERY_TC_NUM_BATCHES,
+   SI_QUERY_TC_BATCH_FILL,
+   SI_QUERY_TC_SYNC_WAIT_TIME,
    SI_QUERY_CS_THREAD_BUSY,
    SI_QUERY_GALLIUM_THREAD_BUSY,
    SI_QUERY_REQUESTED_VRAM,
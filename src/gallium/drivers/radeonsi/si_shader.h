@@ -494,6 +494,9 @@ struct si_shader_selector {
    void *nir_binary;
    unsigned nir_size;
 
+   /* Disk cache key of the variant keys that this shader needed before. */
+   unsigned char variant_keys_cache_key[20];
+
    struct si_shader_info info;
 };
 
@@ -779,6 +782,7 @@ struct si_shader {
    bool compilation_failed;
    bool is_monolithic;
    bool is_optimized;
+   bool is_predicted; /* compiled ahead of time because a previous run used it */
    bool is_binary_shared;
    bool is_gs_copy_shader;
    uint8_t wave_size;
@@ -1929,6 +1929,34 @@ static unsigned get_vb_descriptor_sgpr_ptr_offset(void)
    return dw_offset * 4;
 }
 
+template<amd_gfx_level GFX_VERSION>
+static bool ALWAYS_INLINE si_upload_vb_descriptors(struct si_context *sctx, unsigned alloc_size,
+                                                   uint64_t *va, uint32_t **ptr)
+{
+   struct pipe_resource *upload_buf, *release_buf;
+   unsigned offset;
+
+   /* Vertex buffer descriptors are the only ones which are uploaded directly
+    * and don't go through si_upload_graphics_shader_descriptors.
+    */
+   u_upload_alloc(sctx->b.const_uploader, 0, alloc_size,
+                  si_optimal_tcc_alignment(sctx, alloc_size), &offset, &upload_buf,
+                  &release_buf, (void **)ptr);
+   pipe_resource_release(&sctx->b, release_buf);
+   if (!upload_buf)
+      return false;
+
+   radeon_add_to_buffer_list(sctx, &sctx->gfx_cs, si_resource(upload_buf),
+                             RADEON_USAGE_READ | RADEON_PRIO_DESCRIPTORS);
+   *va = si_resource(upload_buf)->gpu_address + offset;
+
+   /* GFX6 doesn't support the L2 prefetch. */
+   if (GFX_VERSION >= GFX7)
+      si_cp_dma_prefetch_inline<GFX_VERSION>(&sctx->gfx_cs, *va, alloc_size);
+
+   return true;
+}
+
 template <amd_gfx_level GFX_VERSION, si_has_tess HAS_TESS, si_has_gs HAS_GS, si_has_ngg NGG,
           si_is_draw_vertex_state IS_DRAW_VERTEX_STATE, si_has_sh_pairs_packed HAS_SH_PAIRS_PACKED,
           util_popcnt POPCNT> ALWAYS_INLINE
@@ -1956,30 +1984,9 @@ static bool si_upload_and_prefetch_VB_descriptors(struct si_context *sctx,
       uint64_t vb_descriptors_address = 0;
       uint32_t *ptr;
 
-      if (alloc_size) {
-         struct pipe_resource *upload_buf, *release_buf;
-         unsigned offset;
-
-         /* Vertex buffer descriptors are the only ones which are uploaded directly
-          * and don't go through si_upload_graphics_shader_descriptors.
-          */
-         u_upload_alloc(sctx->b.const_uploader, 0, alloc_size,
-                        si_optimal_tcc_alignment(sctx, alloc_size), &offset, &upload_buf,
-                        &release_buf, (void **)&ptr);
-         pipe_resource_release(&sctx->b, release_buf);
-         if (!upload_buf)
-            return false;
-
-         radeon_add_to_buffer_list(sctx, &sctx->gfx_cs, si_resource(upload_buf),
-                                   RADEON_USAGE_READ | RADEON_PRIO_DESCRIPTORS);
-         vb_descriptors_address = si_resource(upload_buf)->gpu_address + offset;
-
-         /* GFX6 doesn't support the L2 prefetch. */
-         if (GFX_VERSION >= GFX7) {
-            uint64_t address = si_resource(upload_buf)->gpu_address + offset;
-            si_cp_dma_prefetch_inline<GFX_VERSION>(&sctx->gfx_cs, address, alloc_size);
-         }
-      }
+      if (IS_DRAW_VERTEX_STATE && alloc_size &&
+          !si_upload_vb_descriptors<GFX_VERSION>(sctx, alloc_size, &vb_descriptors_address, &ptr))
+         return false;
 
       unsigned count_in_user_sgprs = MIN2(count, num_vbos_in_user_sgprs);
       unsigned i = 0;
@@ -2046,15 +2053,40 @@ static bool si_upload_and_prefetch_VB_descriptors(struct si_context *sctx,
          }
 
          if (alloc_size) {
+            uint32_t *cache = sctx->vb_desc_cache;
+            unsigned size = (count - i) * 16;
+
             /* the first iteration always executes */
             do {
                unsigned vbo_index = velems->vertex_buffer_index[i];
                const struct pipe_vertex_buffer *vb = &sctx->vertex_buffer[vbo_index];
-               uint32_t *desc = &ptr[(i - num_vbos_in_user_sgprs) * 4];
+               uint32_t desc[4];
 
                si_set_vb_descriptor<GFX_VERSION>(velems, vb, i, desc);
+               memcpy(&cache[(i - num_vbos_in_user_sgprs) * 4], desc, 16);
             } while (++i < count);
 
+            /* Apps often rebind the same vertex buffers between draws. If the descriptors
+             * are the same as the last upload in this IB, reuse it. The previous upload
+             * buffer is still referenced by the IB, so its contents are still valid.
+             */
+            if (sctx->vb_desc_cache_size == size &&
+                sctx->vb_desc_cache_ib == sctx->num_gfx_cs_flushes &&
+                !memcmp(cache, cache + SI_MAX_ATTRIBS * 4, size)) {
+               vb_descriptors_address = sctx->vb_desc_cache_va;
+            } else {
+               if (!si_upload_vb_descriptors<GFX_VERSION>(sctx, alloc_size,
+                                                          &vb_descriptors_address, &ptr)) {
+                  sctx->vb_desc_cache_size = 0;
+                  return false;
+               }
+               memcpy(ptr, cache, size);
+               memcpy(cache + SI_MAX_ATTRIBS * 4, cache, size);
+               sctx->vb_desc_cache_size = size;
+               sctx->vb_desc_cache_ib = sctx->num_gfx_cs_flushes;
+               sctx->vb_desc_cache_va = vb_descriptors_address;
+            }
+
             unsigned vb_desc_ptr_offset =
                sh_base + get_vb_descriptor_sgpr_ptr_offset<GFX_VERSION, HAS_TESS, HAS_GS, NGG>();
             radeon_begin(&sctx->gfx_cs);
@@ -458,6 +458,120 @@ bool si_shader_cache_load_shader(struct si_screen *sscreen, unsigned char ir_sha
    return false;
 }
 
+/* Return the size of a shader cache entry, including the GS copy shader that follows
+ * legacy GS binaries.
+ */
+static unsigned si_shader_cache_entry_size(const uint32_t *binary, unsigned max_size, bool gs_copy)
+{
+   if (max_size < sizeof(struct si_shader_blob_head) || binary[0] > max_size ||
+       binary[0] < sizeof(struct si_shader_blob_head) || binary[0] % 4)
+      return 0;
+
+   if (!gs_copy)
+      return binary[0];
+
+   unsigned rest = max_size - binary[0];
+   const uint32_t *gs_copy_binary = binary + binary[0] / 4;
+   if (rest < sizeof(struct si_shader_blob_head) || gs_copy_binary[0] > rest)
+      return 0;
+
+   return binary[0] + gs_copy_binary[0];
+}
+
+static void si_write_cached_shader(struct si_screen *sscreen, struct si_shader_selector *sel,
+                                   struct si_shader *shader, struct blob *blob)
+{
+   unsigned char ir_sha1_cache_key[SHA1_DIGEST_LENGTH];
+   bool gs_copy = sel->stage == MESA_SHADER_GEOMETRY && !shader->key.ge.as_ngg;
+
+   if (sel->stage <= MESA_SHADER_GEOMETRY || sel->stage == MESA_SHADER_MESH) {
+      si_get_ir_cache_key(sel, shader->key.ge.as_ngg, shader->key.ge.as_es, shader->wave_size,
+                          ir_sha1_cache_key);
+   } else {
+      si_get_ir_cache_key(sel, false, false, shader->wave_size, ir_sha1_cache_key);
+   }
+
+   simple_mtx_lock(&sscreen->shader_cache_mutex);
+   struct hash_entry *entry = _mesa_hash_table_search(sscreen->shader_cache, ir_sha1_cache_key);
+   if (entry) {
+      const uint32_t *binary = (const uint32_t *)entry->data;
+      unsigned size = binary[0];
+
+      if (gs_copy)
+         size += binary[size / 4];
+
+      blob_write_bytes(blob, ir_sha1_cache_key, SHA1_DIGEST_LENGTH);
+      blob_write_uint32(blob, gs_copy);
+      blob_write_uint32(blob, size);
+      blob_write_bytes(blob, binary, size);
+   }
+   simple_mtx_unlock(&sscreen->shader_cache_mutex);
+}
+
+/**
+ * Write the shader cache entries of the main shader parts of a shader, which are put back
+ * into the memory cache by si_add_shader_binary when a GL program binary is loaded.
+ */
+static void si_get_shader_binary_for_cache(struct pipe_screen *screen, void *shader,
+                                           mesa_shader_stage shader_type, struct blob *blob)
+{
+   struct si_screen *sscreen = (struct si_screen *)screen;
+   struct si_shader_selector *sel = (struct si_shader_selector *)shader;
+
+   util_queue_fence_wait(&sel->ready);
+
+   if (shader_type == MESA_SHADER_COMPUTE) {
+      struct si_compute *program = (struct si_compute *)shader;
+
+      if (!program->shader.compilation_failed)
+         si_write_cached_shader(sscreen, sel, &program->shader, blob);
+      return;
+   }
+
+   for (unsigned i = 0; i < ARRAY_SIZE(sel->main_parts.variants); i++) {
+      if (sel->main_parts.variants[i])
+         si_write_cached_shader(sscreen, sel, sel->main_parts.variants[i], blob);
+   }
+}
+
+static void si_add_shader_binary(struct pipe_screen *screen, const void *data, size_t size)
+{
+   struct si_screen *sscreen = (struct si_screen *)screen;
+   struct blob_reader blob;
+
+   blob_reader_init(&blob, data, size);
+
+   simple_mtx_lock(&sscreen->shader_cache_mutex);
+   while (blob.current < blob.end && !blob.overrun) {
+      const void *key = blob_read_bytes(&blob, SHA1_DIGEST_LENGTH);
+      bool gs_copy = blob_read_uint32(&blob);
+      unsigned binary_size = blob_read_uint32(&blob);
+      const void *binary = blob_read_bytes(&blob, binary_size);
+
+      if (blob.overrun ||
+          si_shader_cache_entry_size((const uint32_t *)binary, binary_size, gs_copy) != binary_size)
+         break;
+
+      if (sscreen->shader_cache_size >= sscreen->shader_cache_max_size)
+         break;
+
+      if (_mesa_hash_table_search(sscreen->shader_cache, key))
+         continue;
+
+      /* The CRC of each binary is checked when it's loaded. */
+      void *copy = mem_dup(binary, binary_size);
+      if (!copy)
+         break;
+
+      if (!_mesa_hash_table_insert(sscreen->shader_cache, mem_dup(key, SHA1_DIGEST_LENGTH), copy)) {
+         FREE(copy);
+         break;
+      }
+      sscreen->shader_cache_size += binary_size;
+   }
+   simple_mtx_unlock(&sscreen->shader_cache_mutex);
+}
+
 static uint32_t si_shader_cache_key_hash(const void *key)
 {
    /* Take the first dword of SHA1. */
@@ -3064,6 +3178,159 @@ use_local_key_copy(const SHADER_KEY_TYPE *key, SHADER_KEY_TYPE *local_key, unsig
    return local_key;
 }
 
+/* Keys of the variants that a shader needed are stored in the disk cache, so that the next run
+ * can compile them on the compiler queue while the shader is created instead of at the first draw
+ * that needs them.
+ */
+#define SI_MAX_PREDICTED_VARIANTS 16
+
+struct si_variant_keys_header {
+   uint32_t key_size;
+   uint32_t num_keys;
+};
+
+static bool si_predict_variants(struct si_screen *sscreen)
+{
+   return sscreen->disk_shader_cache &&
+          !(sscreen->shader_debug_flags & DBG(NO_VARIANT_PREDICTION));
+}
+
+static bool si_is_predictable_variant(struct si_shader_selector *sel,
+                                      const union si_shader_key *key)
+{
+   /* Optimized variants are compiled asynchronously anyway. */
+   if (sel->stage == MESA_SHADER_FRAGMENT)
+      return memcmp(&key->ps.opt, &zeroed.ps.opt, sizeof(key->ps.opt)) == 0;
+
+   /* Merged shaders point to the selector of the first stage, which can't be stored. */
+   if ((sel->stage == MESA_SHADER_TESS_CTRL && key->ge.part.tcs.ls) ||
+       (sel->stage == MESA_SHADER_GEOMETRY && key->ge.part.gs.es))
+      return false;
+
+   return memcmp(&key->ge.opt, &zeroed.ge.opt, sizeof(key->ge.opt)) == 0;
+}
+
+static void si_get_variant_keys_cache_key(struct si_screen *sscreen,
+                                          struct si_shader_selector *sel)
+{
+   static const char tag[] = "si_variant_keys";
+   unsigned char data[sizeof(tag) + SHA1_DIGEST_LENGTH];
+
+   memcpy(data, tag, sizeof(tag));
+   si_get_ir_cache_key(sel, false, false, 64, data + sizeof(tag));
+   disk_cache_compute_key(sscreen->disk_shader_cache, data, sizeof(data),
+                          sel->variant_keys_cache_key);
+}
+
+/* Store the keys of the predictable variants of the shader. */
+static void si_store_variant_keys(struct si_screen *sscreen, struct si_shader_selector *sel)
+{
+   simple_mtx_lock(&sel->mutex);
+
+   size_t size = sizeof(struct si_variant_keys_header) +
+                 MIN2(sel->variants_count, SI_MAX_PREDICTED_VARIANTS) * sizeof(union si_shader_key);
+   struct si_variant_keys_header *header = (struct si_variant_keys_header *)malloc(size);
+   if (!header) {
+      simple_mtx_unlock(&sel->mutex);
+      return;
+   }
+
+   union si_shader_key *keys = (union si_shader_key *)(header + 1);
+   header->key_size = sizeof(union si_shader_key);
+   header->num_keys = 0;
+
+   for (unsigned i = 0; i < sel->variants_count && header->num_keys < SI_MAX_PREDICTED_VARIANTS;
+        i++) {
+      struct si_shader *shader = sel->variants[i];
+
+      if (!si_is_predictable_variant(sel, &sel->keys[i]) ||
+          (util_queue_fence_is_signalled(&shader->ready) && shader->compilation_failed))
+         continue;
+
+      keys[header->num_keys++] = sel->keys[i];
+   }
+   simple_mtx_unlock(&sel->mutex);
+
+   size = sizeof(*header) + header->num_keys * sizeof(union si_shader_key);
+   disk_cache_put(sscreen->disk_shader_cache, sel->variant_keys_cache_key, header, size, NULL);
+   free(header);
+}
+
+/* Queue the compilation of the variants that previous runs needed. This is called from
+ * the compiler queue before the selector is ready, so the draw that needs a variant can
+ * find it and wait for it instead of compiling it again.
+ */
+static void si_precompile_predicted_variants(struct si_screen *sscreen,
+                                             struct si_shader_selector *sel)
+{
+   si_get_variant_keys_cache_key(sscreen, sel);
+
+   size_t size;
+   struct si_variant_keys_header *header = (struct si_variant_keys_header *)
+      disk_cache_get(sscreen->disk_shader_cache, sel->variant_keys_cache_key, &size);
+   if (!header)
+      return;
+
+   if (size < sizeof(*header) || header->key_size != sizeof(union si_shader_key) ||
+       size != sizeof(*header) + (size_t)header->num_keys * sizeof(union si_shader_key)) {
+      free(header);
+      return;
+   }
+
+   const union si_shader_key *keys = (const union si_shader_key *)(header + 1);
+
+   simple_mtx_lock(&sel->mutex);
+   for (unsigned i = 0; i < MIN2(header->num_keys, SI_MAX_PREDICTED_VARIANTS); i++) {
+      const union si_shader_key *key = &keys[i];
+
+      if (!si_is_predictable_variant(sel, key))
+         continue;
+
+      struct si_shader *shader = CALLOC_STRUCT(si_shader);
+      if (!shader)
+         break;
+
+      util_queue_fence_init(&shader->ready);
+      shader->selector = sel;
+      shader->key = *key;
+      shader->wave_size = si_determine_wave_size(sscreen, shader);
+
+      bool is_pure_monolithic =
+         sscreen->use_monolithic_shaders ||
+         (sel->stage == MESA_SHADER_FRAGMENT ?
+             memcmp(&key->ps.mono, &zeroed.ps.mono, sizeof(key->ps.mono)) :
+             memcmp(&key->ge.mono, &zeroed.ge.mono, sizeof(key->ge.mono))) != 0;
+
+      /* Only the main part compiled at creation can be used from here. */
+      if (!is_pure_monolithic && !*si_get_main_shader_part(sel, key, shader->wave_size)) {
+         util_queue_fence_destroy(&shader->ready);
+         FREE(shader);
+         continue;
+      }
+
+      shader->is_monolithic = is_pure_monolithic;
+      shader->is_predicted = true;
+
+      if (sel->variants_count == sel->variants_max_count) {
+         sel->variants_max_count += 2;
+         sel->variants = (struct si_shader**)
+            realloc(sel->variants, sel->variants_max_count * sizeof(struct si_shader*));
+         sel->keys = (union si_shader_key*)
+            realloc(sel->keys, sel->variants_max_count * sizeof(union si_shader_key));
+      }
+
+      util_queue_add_job(&sscreen->shader_compiler_queue_opt_variants, shader, &shader->ready,
+                         si_build_shader_variant_low_priority, NULL, 0);
+
+      sel->variants[sel->variants_count] = shader;
+      sel->keys[sel->variants_count] = shader->key;
+      sel->variants_count++;
+   }
+   simple_mtx_unlock(&sel->mutex);
+
+   free(header);
+}
+
 #define NO_INLINE_UNIFORMS false
 
 /**
@@ -3133,8 +3400,11 @@ current_not_ready:
    /* This must be done before the mutex is locked, because async GS
     * compilation calls this function too, and therefore must enter
     * the mutex first.
+    *
+    * The draw can't continue without the shader, so move its compilation in
+    * front of the other queued compilations.
     */
-   util_queue_fence_wait(&sel->ready);
+   util_queue_job_wait(&sscreen->shader_compiler_queue, &sel->ready);
 
    simple_mtx_lock(&sel->mutex);
 
@@ -3180,7 +3450,11 @@ current_not_ready:
                goto again;
             }
 
-            util_queue_fence_wait(&iter->ready);
+            /* A predicted variant may still be queued behind other compilations. */
+            if (iter->is_predicted)
+               util_queue_job_wait(&sscreen->shader_compiler_queue_opt_variants, &iter->ready);
+            else
+               util_queue_fence_wait(&iter->ready);
          }
 
          if (iter->compilation_failed) {
@@ -3335,9 +3609,14 @@ current_not_ready:
 
    util_queue_fence_signal(&shader->ready);
 
-   if (!shader->compilation_failed)
+   if (!shader->compilation_failed) {
       state->current = shader;
 
+      if (si_predict_variants(sscreen) &&
+          si_is_predictable_variant(sel, &shader->key))
+         si_store_variant_keys(sscreen, sel);
+   }
+
    return shader->compilation_failed ? -1 : 0;
 }
 
@@ -3509,6 +3788,12 @@ static void si_init_shader_selector_async(void *job, void *gdata, int thread_ind
    /* Free NIR. We only keep serialized NIR after this point. */
    ralloc_free(sel->nir);
    sel->nir = NULL;
+
+   /* This must be done after NIR is freed, because variants compiled on other threads use
+    * the serialized NIR if sel->nir is NULL.
+    */
+   if (si_predict_variants(sscreen))
+      si_precompile_predicted_variants(sscreen, sel);
 }
 
 void si_schedule_initial_compile(struct si_context *sctx, mesa_shader_stage stage,
@@ -4002,7 +4287,7 @@ static void si_bind_ps_shader(struct pipe_context *ctx, void *state)
 
 static void si_delete_shader(struct si_context *sctx, struct si_shader *shader)
 {
-   if (shader->is_optimized) {
+   if (shader->is_optimized || shader->is_predicted) {
       util_queue_drop_job(&sctx->screen->shader_compiler_queue_opt_variants, &shader->ready);
    }
 
@@ -4934,6 +5219,9 @@ void si_init_screen_live_shader_cache(struct si_screen *sscreen)
 {
    util_live_shader_cache_init(&sscreen->live_shader_cache, si_create_shader_selector,
                                si_destroy_shader_selector);
+
+   sscreen->b.get_shader_binary = si_get_shader_binary_for_cache;
+   sscreen->b.add_shader_binary = si_add_shader_binary;
 }
 
 template<int NUM_INTERP>
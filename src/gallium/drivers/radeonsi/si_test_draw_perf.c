@@ -0,0 +1,477 @@
+/*
+ * Copyright 2024 Mesa contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* This file implements performance tests for draws, compute dispatches and descriptor updates.
+ *
+ * The output is CSV with the CPU time per operation and the GPU throughput, so that the driver
+ * overhead and the hardware rate can be compared between driver versions and chips. The
+ * geometry path is selected by the screen, so run the test again with AMD_DEBUG=nongg or
+ * AMD_DEBUG=nonggc to get the other paths.
+ */
+
+#include "si_pipe.h"
+#include "nir_builder.h"
+#include "util/os_time.h"
+#include "util/u_inlines.h"
+#include "util/u_sampler.h"
+#include "util/u_simple_shaders.h"
+#include "util/u_surface.h"
+
+#define WARMUP_RUNS 2
+#define NUM_RUNS    8
+#define FB_SIZE     256
+#define MAX_TRIS    65536
+
+struct perf_result {
+   double cpu_ns_per_op;
+   double gpu_ns_per_op;
+};
+
+typedef void (*perf_op_func)(struct si_context *sctx, void *data, unsigned index);
+
+/* Return the average CPU time of op() and the average GPU time of what it submitted. */
+static struct perf_result run_op(struct si_context *sctx, unsigned num_ops, perf_op_func op,
+                                 void *data)
+{
+   struct pipe_context *ctx = &sctx->b;
+   struct pipe_query *q = ctx->create_query(ctx, PIPE_QUERY_TIME_ELAPSED, 0);
+   int64_t cpu_time = 0;
+
+   for (unsigned run = 0; run < WARMUP_RUNS + NUM_RUNS; run++) {
+      if (run == WARMUP_RUNS)
+         ctx->begin_query(ctx, q);
+
+      int64_t start = os_time_get_nano();
+      for (unsigned i = 0; i < num_ops; i++)
+         op(sctx, data, i);
+
+      if (run >= WARMUP_RUNS)
+         cpu_time += os_time_get_nano() - start;
+   }
+
+   ctx->end_query(ctx, q);
+
+   union pipe_query_result result;
+   ctx->get_query_result(ctx, q, true, &result);
+   ctx->destroy_query(ctx, q);
+
+   struct perf_result r = {
+      .cpu_ns_per_op = cpu_time / (double)(NUM_RUNS * num_ops),
+      .gpu_ns_per_op = result.u64 / (double)(NUM_RUNS * num_ops),
+   };
+   return r;
+}
+
+static void print_result(struct si_context *sctx, const char *test, const char *path,
+                         const char *config, unsigned size, struct perf_result r,
+                         double items_per_op)
+{
+   printf("%s,%s,%s,%s,%u,%.1f,%.1f,", ac_get_family_name(sctx->screen->info.family), test,
+          path, config, size, r.cpu_ns_per_op, r.gpu_ns_per_op);
+
+   /* The elapsed time can be 0 for very small ops on some chips. */
+   if (r.gpu_ns_per_op > 0 && items_per_op > 0)
+      printf("%.2f\n", items_per_op / r.gpu_ns_per_op * 1000.0);
+   else
+      printf("n/a\n");
+}
+
+static const char *get_ge_path(struct si_screen *sscreen)
+{
+   if (!sscreen->use_ngg)
+      return "legacy";
+
+   return sscreen->use_ngg_culling ? "NGG culling" : "NGG";
+}
+
+/* Tiny triangles spread over the framebuffer, counter-clockwise. */
+static struct pipe_resource *create_triangles(struct pipe_context *ctx)
+{
+   struct pipe_resource *buf =
+      pipe_buffer_create(ctx->screen, PIPE_BIND_VERTEX_BUFFER, PIPE_USAGE_IMMUTABLE,
+                         MAX_TRIS * 3 * 4 * sizeof(float));
+   float *v = (float *)malloc(buf->width0);
+   const float d = 2.0 / FB_SIZE;
+
+   for (unsigned i = 0; i < MAX_TRIS; i++) {
+      float x = -1 + (i % FB_SIZE) * d;
+      float y = -1 + ((i / FB_SIZE) % FB_SIZE) * d;
+      float tri[3][4] = {
+         {x, y, 0, 1},
+         {x + d, y, 0, 1},
+         {x, y + d, 0, 1},
+      };
+      memcpy(v + i * 12, tri, sizeof(tri));
+   }
+
+   pipe_buffer_write(ctx, buf, 0, buf->width0, v);
+   free(v);
+   return buf;
+}
+
+static struct pipe_resource *create_indices(struct pipe_context *ctx)
+{
+   struct pipe_resource *buf =
+      pipe_buffer_create(ctx->screen, PIPE_BIND_INDEX_BUFFER, PIPE_USAGE_IMMUTABLE,
+                         MAX_TRIS * 3 * sizeof(uint32_t));
+   uint32_t *indices = (uint32_t *)malloc(buf->width0);
+
+   for (unsigned i = 0; i < MAX_TRIS * 3; i++)
+      indices[i] = i;
+
+   pipe_buffer_write(ctx, buf, 0, buf->width0, indices);
+   free(indices);
+   return buf;
+}
+
+static void set_framebuffer(struct pipe_context *ctx, struct pipe_resource *rt)
+{
+   struct pipe_framebuffer_state fb = {0};
+
+   fb.width = rt->width0;
+   fb.height = rt->height0;
+   fb.layers = 1;
+   fb.nr_cbufs = 1;
+   u_surface_default_template(&fb.cbufs[0], rt);
+   ctx->set_framebuffer_state(ctx, &fb);
+
+   struct pipe_viewport_state viewport = {
+      .scale = {0.5f * rt->width0, 0.5f * rt->height0, 1},
+      .translate = {0.5f * rt->width0, 0.5f * rt->height0, 0},
+      .swizzle_x = PIPE_VIEWPORT_SWIZZLE_POSITIVE_X,
+      .swizzle_y = PIPE_VIEWPORT_SWIZZLE_POSITIVE_Y,
+      .swizzle_z = PIPE_VIEWPORT_SWIZZLE_POSITIVE_Z,
+      .swizzle_w = PIPE_VIEWPORT_SWIZZLE_POSITIVE_W,
+   };
+   ctx->set_viewport_states(ctx, 0, 1, &viewport);
+}
+
+struct draw_test {
+   struct pipe_draw_info info;
+   struct pipe_draw_start_count_bias draw;
+};
+
+static void do_draw(struct si_context *sctx, void *data, unsigned index)
+{
+   struct draw_test *test = (struct draw_test *)data;
+
+   sctx->b.draw_vbo(&sctx->b, &test->info, 0, NULL, &test->draw, 1);
+}
+
+enum {
+   DRAW_VISIBLE,
+   DRAW_VISIBLE_INDEXED,
+   DRAW_CULLED,
+   DRAW_CULLED_INDEXED,
+   NUM_DRAW_CONFIGS,
+};
+
+static const char *draw_config_strings[] = {
+   [DRAW_VISIBLE] = "visible",
+   [DRAW_VISIBLE_INDEXED] = "visible indexed",
+   [DRAW_CULLED] = "backface culled",
+   [DRAW_CULLED_INDEXED] = "backface culled indexed",
+};
+
+static void test_draws(struct si_context *sctx, struct pipe_resource *vb,
+                       struct pipe_resource *ib)
+{
+   struct pipe_context *ctx = &sctx->b;
+   const enum tgsi_semantic names[] = {TGSI_SEMANTIC_POSITION};
+   const unsigned indices[] = {0};
+
+   void *vs = util_make_vertex_passthrough_shader(ctx, 1, names, indices, false);
+   void *fs = util_make_empty_fragment_shader(ctx);
+   ctx->bind_vs_state(ctx, vs);
+   ctx->bind_fs_state(ctx, fs);
+
+   struct pipe_vertex_element velem = {
+      .src_format = PIPE_FORMAT_R32G32B32A32_FLOAT,
+      .src_stride = 4 * sizeof(float),
+   };
+   void *velems = ctx->create_vertex_elements_state(ctx, 1, &velem);
+   ctx->bind_vertex_elements_state(ctx, velems);
+
+   struct pipe_vertex_buffer vbuf = {.buffer.resource = vb};
+   ctx->set_vertex_buffers(ctx, 1, &vbuf);
+
+   for (unsigned config = 0; config < NUM_DRAW_CONFIGS; config++) {
+      bool indexed = config == DRAW_VISIBLE_INDEXED || config == DRAW_CULLED_INDEXED;
+      bool culled = config == DRAW_CULLED || config == DRAW_CULLED_INDEXED;
+
+      struct pipe_rasterizer_state rs_templ = {
+         .half_pixel_center = 1,
+         .bottom_edge_rule = 1,
+         .depth_clip_near = 1,
+         .depth_clip_far = 1,
+         .cull_face = PIPE_FACE_BACK,
+         .front_ccw = !culled,
+      };
+      void *rs = ctx->create_rasterizer_state(ctx, &rs_templ);
+      ctx->bind_rasterizer_state(ctx, rs);
+
+      for (unsigned num_tris = 1; num_tris <= MAX_TRIS; num_tris *= 16) {
+         struct draw_test test = {
+            .info = {
+               .mode = MESA_PRIM_TRIANGLES,
+               .index_size = indexed ? 4 : 0,
+               .instance_count = 1,
+               .index.resource = indexed ? ib : NULL,
+            },
+            .draw = {.count = num_tris * 3},
+         };
+         /* Keep the number of triangles per run close for all draw sizes. */
+         unsigned num_draws = CLAMP(262144 / num_tris, 4, 4096);
+
+         struct perf_result r = run_op(sctx, num_draws, do_draw, &test);
+         print_result(sctx, "draw", get_ge_path(sctx->screen), draw_config_strings[config],
+                      num_tris, r, num_tris);
+      }
+
+      ctx->bind_rasterizer_state(ctx, NULL);
+      ctx->delete_rasterizer_state(ctx, rs);
+   }
+
+   ctx->bind_vertex_elements_state(ctx, NULL);
+   ctx->delete_vertex_elements_state(ctx, velems);
+   ctx->bind_vs_state(ctx, NULL);
+   ctx->bind_fs_state(ctx, NULL);
+   ctx->delete_vs_state(ctx, vs);
+   ctx->delete_fs_state(ctx, fs);
+}
+
+struct dispatch_test {
+   struct pipe_grid_info info;
+   bool barrier;
+};
+
+static void do_dispatch(struct si_context *sctx, void *data, unsigned index)
+{
+   struct dispatch_test *test = (struct dispatch_test *)data;
+
+   if (test->barrier) {
+      sctx->barrier_flags |= SI_BARRIER_SYNC_CS;
+      si_mark_atom_dirty(sctx, &sctx->atoms.s.barrier);
+   }
+
+   sctx->b.launch_grid(&sctx->b, &test->info);
+}
+
+static void test_dispatches(struct si_context *sctx)
+{
+   struct pipe_context *ctx = &sctx->b;
+   nir_builder b = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, sctx->screen->nir_options,
+                                                  "dispatch_perf");
+   b.shader->info.workgroup_size[0] = 64;
+   b.shader->info.workgroup_size[1] = 1;
+   b.shader->info.workgroup_size[2] = 1;
+
+   void *cs = si_create_shader_state(sctx, b.shader);
+   ctx->bind_compute_state(ctx, cs);
+
+   for (unsigned barrier = 0; barrier <= 1; barrier++) {
+      for (unsigned num_groups = 1; num_groups <= 16384; num_groups *= 16) {
+         struct dispatch_test test = {
+            .info = {
+               .work_dim = 1,
+               .block = {64, 1, 1},
+               .grid = {num_groups, 1, 1},
+            },
+            .barrier = barrier,
+         };
+
+         struct perf_result r = run_op(sctx, 4096, do_dispatch, &test);
+         print_result(sctx, "dispatch", "compute", barrier ? "barrier" : "no barrier",
+                      num_groups, r, num_groups);
+      }
+   }
+
+   ctx->bind_compute_state(ctx, NULL);
+   ctx->delete_compute_state(ctx, cs);
+}
+
+enum {
+   DESC_CONST_BUFFER,
+   DESC_SAMPLER_VIEWS,
+   NUM_DESC_CONFIGS,
+};
+
+static const char *desc_config_strings[] = {
+   [DESC_CONST_BUFFER] = "constant buffer upload",
+   [DESC_SAMPLER_VIEWS] = "sampler views",
+};
+
+struct descriptor_test {
+   struct draw_test draw;
+   unsigned config;
+   unsigned size;
+   struct pipe_sampler_view *views[2][PIPE_MAX_SHADER_SAMPLER_VIEWS];
+   uint32_t constants[4096];
+};
+
+static void do_descriptor_update(struct si_context *sctx, void *data, unsigned index)
+{
+   struct descriptor_test *test = (struct descriptor_test *)data;
+
+   if (test->config == DESC_CONST_BUFFER) {
+      struct pipe_constant_buffer cb = {
+         .user_buffer = test->constants,
+         .buffer_size = test->size,
+      };
+      sctx->b.set_constant_buffer(&sctx->b, MESA_SHADER_FRAGMENT, 0, &cb);
+   } else {
+      /* Alternate between two sets so that every draw changes the descriptors. */
+      sctx->b.set_sampler_views(&sctx->b, MESA_SHADER_FRAGMENT, 0, test->size, 0,
+                                test->views[index % 2]);
+   }
+
+   do_draw(sctx, &test->draw, index);
+}
+
+static void test_descriptors(struct si_context *sctx, struct pipe_resource *vb)
+{
+   struct pipe_context *ctx = &sctx->b;
+   const enum tgsi_semantic names[] = {TGSI_SEMANTIC_POSITION, TGSI_SEMANTIC_GENERIC};
+   const unsigned indices[] = {0, 0};
+
+   void *vs = util_make_vertex_passthrough_shader(ctx, 2, names, indices, false);
+   void *fs = util_make_fragment_tex_shader(ctx, TGSI_TEXTURE_2D, TGSI_RETURN_TYPE_FLOAT,
+                                            TGSI_RETURN_TYPE_FLOAT, false, false);
+   ctx->bind_vs_state(ctx, vs);
+   ctx->bind_fs_state(ctx, fs);
+
+   /* The texture coordinates are the positions. */
+   struct pipe_vertex_element velems_templ[2] = {
+      {.src_format = PIPE_FORMAT_R32G32B32A32_FLOAT, .src_stride = 4 * sizeof(float)},
+      {.src_format = PIPE_FORMAT_R32G32B32A32_FLOAT, .src_stride = 4 * sizeof(float)},
+   };
+   void *velems = ctx->create_vertex_elements_state(ctx, 2, velems_templ);
+   ctx->bind_vertex_elements_state(ctx, velems);
+
+   struct pipe_vertex_buffer vbuf = {.buffer.resource = vb};
+   ctx->set_vertex_buffers(ctx, 1, &vbuf);
+
+   struct pipe_rasterizer_state rs_templ = {
+      .half_pixel_center = 1,
+      .bottom_edge_rule = 1,
+      .depth_clip_near = 1,
+      .depth_clip_far = 1,
+   };
+   void *rs = ctx->create_rasterizer_state(ctx, &rs_templ);
+   ctx->bind_rasterizer_state(ctx, rs);
+
+   struct pipe_sampler_state sampler_templ = {0};
+   void *sampler = ctx->create_sampler_state(ctx, &sampler_templ);
+   ctx->bind_sampler_states(ctx, MESA_SHADER_FRAGMENT, 0, 1, &sampler);
+
+   struct descriptor_test *test = CALLOC_STRUCT(descriptor_test);
+   const struct pipe_resource tex_templ = {
+      .target = PIPE_TEXTURE_2D,
+      .format = PIPE_FORMAT_R8G8B8A8_UNORM,
+      .width0 = 16,
+      .height0 = 16,
+      .depth0 = 1,
+      .array_size = 1,
+      .bind = PIPE_BIND_SAMPLER_VIEW,
+   };
+
+   for (unsigned set = 0; set < 2; set++) {
+      for (unsigned i = 0; i < PIPE_MAX_SHADER_SAMPLER_VIEWS; i++) {
+         struct pipe_resource *tex = ctx->screen->resource_create(ctx->screen, &tex_templ);
+         struct pipe_sampler_view view_templ;
+
+         u_sampler_view_default_template(&view_templ, tex, tex->format);
+         test->views[set][i] = ctx->create_sampler_view(ctx, tex, &view_templ);
+         pipe_resource_reference(&tex, NULL);
+      }
+   }
+
+   test->draw.info.mode = MESA_PRIM_TRIANGLES;
+   test->draw.info.instance_count = 1;
+   test->draw.draw.count = 3;
+
+   for (test->config = 0; test->config < NUM_DESC_CONFIGS; test->config++) {
+      unsigned min_size = test->config == DESC_CONST_BUFFER ? 16 : 1;
+      unsigned max_size = test->config == DESC_CONST_BUFFER ? sizeof(test->constants) :
+                                                              PIPE_MAX_SHADER_SAMPLER_VIEWS;
+
+      for (test->size = min_size; test->size <= max_size; test->size *= 4) {
+         struct perf_result r = run_op(sctx, 4096, do_descriptor_update, test);
+         print_result(sctx, "descriptors", get_ge_path(sctx->screen),
+                      desc_config_strings[test->config], test->size, r, 1);
+      }
+   }
+
+   ctx->set_sampler_views(ctx, MESA_SHADER_FRAGMENT, 0, 0, PIPE_MAX_SHADER_SAMPLER_VIEWS, NULL);
+   ctx->set_constant_buffer(ctx, MESA_SHADER_FRAGMENT, 0, NULL);
+
+   for (unsigned set = 0; set < 2; set++) {
+      for (unsigned i = 0; i < PIPE_MAX_SHADER_SAMPLER_VIEWS; i++)
+         pipe_sampler_view_reference(&test->views[set][i], NULL);
+   }
+   FREE(test);
+
+   ctx->bind_sampler_states(ctx, MESA_SHADER_FRAGMENT, 0, 1, NULL);
+   ctx->delete_sampler_state(ctx, sampler);
+   ctx->bind_rasterizer_state(ctx, NULL);
+   ctx->delete_rasterizer_state(ctx, rs);
+   ctx->bind_vertex_elements_state(ctx, NULL);
+   ctx->delete_vertex_elements_state(ctx, velems);
+   ctx->bind_vs_state(ctx, NULL);
+   ctx->bind_fs_state(ctx, NULL);
+   ctx->delete_vs_state(ctx, vs);
+   ctx->delete_fs_state(ctx, fs);
+}
+
+void si_test_draw_perf(struct si_screen *sscreen)
+{
+   struct pipe_screen *screen = &sscreen->b;
+   struct pipe_context *ctx = screen->context_create(screen, NULL, 0);
+   struct si_context *sctx = (struct si_context *)ctx;
+
+   sscreen->ws->cs_set_pstate(&sctx->gfx_cs, RADEON_CTX_PSTATE_PEAK);
+
+   const struct pipe_resource rt_templ = {
+      .target = PIPE_TEXTURE_2D,
+      .format = PIPE_FORMAT_R8G8B8A8_UNORM,
+      .width0 = FB_SIZE,
+      .height0 = FB_SIZE,
+      .depth0 = 1,
+      .array_size = 1,
+      .bind = PIPE_BIND_RENDER_TARGET,
+   };
+   struct pipe_resource *rt = screen->resource_create(screen, &rt_templ);
+   struct pipe_resource *vb = create_triangles(ctx);
+   struct pipe_resource *ib = create_indices(ctx);
+
+   set_framebuffer(ctx, rt);
+
+   void *blend = ctx->create_blend_state(ctx, &(struct pipe_blend_state){
+      .rt[0].colormask = PIPE_MASK_RGBA,
+   });
+   void *dsa = ctx->create_depth_stencil_alpha_state(ctx,
+      &(struct pipe_depth_stencil_alpha_state){0});
+   ctx->bind_blend_state(ctx, blend);
+   ctx->bind_depth_stencil_alpha_state(ctx, dsa);
+
+   printf("Chip,Test,Path,Config,Size,CPU ns/op,GPU ns/op,GPU M/s\n");
+
+   test_draws(sctx, vb, ib);
+   test_dispatches(sctx);
+   test_descriptors(sctx, vb);
+
+   ctx->bind_blend_state(ctx, NULL);
+   ctx->bind_depth_stencil_alpha_state(ctx, NULL);
+   ctx->delete_blend_state(ctx, blend);
+   ctx->delete_depth_stencil_alpha_state(ctx, dsa);
+
+   pipe_resource_reference(&rt, NULL);
+   pipe_resource_reference(&vb, NULL);
+   pipe_resource_reference(&ib, NULL);
+
+   ctx->destroy(ctx);
+   exit(0);
+}
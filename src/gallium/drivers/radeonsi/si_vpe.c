@@ -598,11 +598,10 @@ si_vpe_reuse_scaling_info(struct vpe_video_processor *vpeproc,
                           float *scaling_ratios)
 {
    if (vpeproc->lanczos_info) {
-      uint8_t scaling_pass_num = (vpeproc->geometric_passes)? vpeproc->geometric_passes : 1;
       struct vpe_scaling_lanczos_info *lanczof = vpeproc->lanczos_info;
       uint8_t idx;
 
-      for (idx = 0; idx < scaling_pass_num; idx++) {
+      for (idx = 0; idx < VPE_LANCZOS_INFO_NUM; idx++) {
          if (lanczof[idx].scaling_ratios[0] == 0 && lanczof[idx].scaling_ratios[1] == 0)
             break;
          else if (lanczof[idx].scaling_ratios[0] == scaling_ratios[0] &&
@@ -635,7 +634,6 @@ si_vpe_init_polyphase_filter(struct vpe_video_processor *vpeproc,
    uint32_t hTaps = stream->scaling_info.taps.h_taps;
    uint32_t vTaps = stream->scaling_info.taps.v_taps;
    uint32_t hw_num_phases = 64;
-   uint8_t scaling_pass_num = (vpeproc->geometric_passes)? vpeproc->geometric_passes : 1;
 
    if (hTaps > 0)
       hw_num_taps[0] = hTaps;
@@ -655,27 +653,25 @@ si_vpe_init_polyphase_filter(struct vpe_video_processor *vpeproc,
    if (scaling_ratios[1] > 0)
       generate_lanczos_coeff(scaling_ratios[1], hw_num_taps[1], hw_num_phases, stream->polyphase_scaling_coeffs.vert_polyphase_coeffs);
 
-   /* backup the scaling ratio and coeff info for re-using in next round */
+   /* backup the scaling ratio and coeff info for re-using in next round.
+    * Multi-pass (geometric) scaling and multi-output transcoding use several ratios per frame,
+    * so keep a few of them and replace the oldest one when the array is full.
+    */
    if (!vpeproc->lanczos_info)
-      vpeproc->lanczos_info = (struct vpe_scaling_lanczos_info *)CALLOC(scaling_pass_num, sizeof(struct vpe_scaling_lanczos_info));
+      vpeproc->lanczos_info = (struct vpe_scaling_lanczos_info *)CALLOC(VPE_LANCZOS_INFO_NUM, sizeof(struct vpe_scaling_lanczos_info));
 
    if (vpeproc->lanczos_info) {
       struct vpe_scaling_lanczos_info *lanczof = vpeproc->lanczos_info;
-      uint8_t idx;
+      uint8_t idx = vpeproc->lanczos_info_next;
 
-      for (idx = 0; idx < scaling_pass_num; idx++) {
-         if (lanczof[idx].scaling_ratios[0] == 0 && lanczof[idx].scaling_ratios[1] == 0) {
-            lanczof[idx].scaling_ratios[0] = scaling_ratios[0];
-            lanczof[idx].scaling_ratios[1] = scaling_ratios[1];
-            memcpy(&lanczof[idx].filterCoeffs,
-                   &stream->polyphase_scaling_coeffs,
-                   sizeof(struct vpe_scaling_filter_coeffs));
-            SIVPE_INFO(vpeproc->log_level, "Backup Scaling Coeff into to array[%d]\n", idx);
-            break;
-         }
-      }
-      if (idx == scaling_pass_num)
-         SIVPE_INFO(vpeproc->log_level, "Backup Scaling Coeff failed\n");
+      lanczof[idx].scaling_ratios[0] = scaling_ratios[0];
+      lanczof[idx].scaling_ratios[1] = scaling_ratios[1];
+      memcpy(&lanczof[idx].filterCoeffs,
+             &stream->polyphase_scaling_coeffs,
+             sizeof(struct vpe_scaling_filter_coeffs));
+      SIVPE_INFO(vpeproc->log_level, "Backup Scaling Coeff into to array[%d]\n", idx);
+
+      vpeproc->lanczos_info_next = (idx + 1) % VPE_LANCZOS_INFO_NUM;
    }
 }
 
@@ -48,6 +48,9 @@
 
 #define VPE_MAX_GEOMETRIC_DOWNSCALE 4.f
 
+/* Number of scaling ratios whose Lanczos coefficients are kept for reuse */
+#define VPE_LANCZOS_INFO_NUM        8
+
 struct vpe_scaling_lanczos_info {
     float scaling_ratios[2];
     struct vpe_scaling_filter_coeffs filterCoeffs;
@@ -93,6 +96,7 @@ struct vpe_video_processor {
 
     /* For Lanczos Coeff */
     struct vpe_scaling_lanczos_info *lanczos_info;
+    uint8_t lanczos_info_next;
 };
 
 struct pipe_video_codec*
@@ -342,6 +342,35 @@ static void virgl_reemit_compute_resources(struct virgl_context *vctx)
    virgl_attach_res_atomic_buffers(vctx);
 }
 
+static void virgl_defer_state(struct virgl_context *vctx, uint32_t bit,
+                              unsigned dwords)
+{
+   struct virgl_deferred_state *deferred = &vctx->deferred;
+
+   if (deferred->dirty & bit)
+      deferred->elided_bytes += dwords * 4;
+   deferred->dirty |= bit;
+}
+
+static void virgl_defer_bind(struct virgl_context *vctx, uint32_t bit,
+                             uint32_t *pending, uint32_t hw_handle,
+                             uint32_t handle)
+{
+   struct virgl_deferred_state *deferred = &vctx->deferred;
+
+   /* bind_object is the command dword plus the handle */
+   if (deferred->dirty & bit)
+      deferred->elided_bytes += 2 * 4;
+
+   *pending = handle;
+   if (handle == hw_handle) {
+      deferred->elided_bytes += 2 * 4;
+      deferred->dirty &= ~bit;
+   } else {
+      deferred->dirty |= bit;
+   }
+}
+
 static void *virgl_create_blend_state(struct pipe_context *ctx,
                                               const struct pipe_blend_state *blend_state)
 {
@@ -359,7 +388,8 @@ static void virgl_bind_blend_state(struct pipe_context *ctx,
 {
    struct virgl_context *vctx = virgl_context(ctx);
    uint32_t handle = (uintptr_t)blend_state;
-   virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_BLEND);
+   virgl_defer_bind(vctx, VIRGL_DEFERRED_BLEND, &vctx->deferred.blend,
+                    vctx->deferred.hw_blend, handle);
 }
 
 static void virgl_delete_blend_state(struct pipe_context *ctx,
@@ -386,7 +416,8 @@ static void virgl_bind_depth_stencil_alpha_state(struct pipe_context *ctx,
 {
    struct virgl_context *vctx = virgl_context(ctx);
    uint32_t handle = (uintptr_t)blend_state;
-   virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_DSA);
+   virgl_defer_bind(vctx, VIRGL_DEFERRED_DSA, &vctx->deferred.dsa,
+                    vctx->deferred.hw_dsa, handle);
 }
 
 static void virgl_delete_depth_stencil_alpha_state(struct pipe_context *ctx,
@@ -425,7 +456,9 @@ static void virgl_bind_rasterizer_state(struct pipe_context *ctx,
       vctx->rs_state = *vrs;
       handle = vrs->handle;
    }
-   virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_RASTERIZER);
+   virgl_defer_bind(vctx, VIRGL_DEFERRED_RASTERIZER,
+                    &vctx->deferred.rasterizer,
+                    vctx->deferred.hw_rasterizer, handle);
 }
 
 static void virgl_delete_rasterizer_state(struct pipe_context *ctx,
@@ -513,7 +546,19 @@ static void virgl_set_viewport_states(struct pipe_context *ctx,
                                      const struct pipe_viewport_state *state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   virgl_encoder_set_viewport_states(vctx, start_slot, num_viewports, state);
+   struct virgl_deferred_state *deferred = &vctx->deferred;
+   uint32_t mask = u_bit_consecutive(start_slot, num_viewports);
+
+   if (deferred->dirty & VIRGL_DEFERRED_VIEWPORTS)
+      deferred->elided_bytes +=
+         util_bitcount(deferred->viewport_mask & mask) * 6 * 4;
+
+   memcpy(&deferred->viewports[start_slot], state,
+          num_viewports * sizeof(*state));
+   if (!(deferred->dirty & VIRGL_DEFERRED_VIEWPORTS))
+      deferred->viewport_mask = 0;
+   deferred->viewport_mask |= mask;
+   deferred->dirty |= VIRGL_DEFERRED_VIEWPORTS;
 }
 
 static void *virgl_create_vertex_elements_state(struct pipe_context *ctx,
@@ -567,8 +612,10 @@ static void virgl_bind_vertex_elements_state(struct pipe_context *ctx,
    struct virgl_vertex_elements_state *state =
       (struct virgl_vertex_elements_state *)ve;
    vctx->vertex_elements = state;
-   virgl_encode_bind_object(vctx, state ? state->handle : 0,
-                            VIRGL_OBJECT_VERTEX_ELEMENTS);
+   virgl_defer_bind(vctx, VIRGL_DEFERRED_VERTEX_ELEMENTS,
+                    &vctx->deferred.vertex_elements,
+                    vctx->deferred.hw_vertex_elements,
+                    state ? state->handle : 0);
    vctx->vertex_array_dirty = true;
 }
 
@@ -618,14 +665,18 @@ static void virgl_set_stencil_ref(struct pipe_context *ctx,
                                  const struct pipe_stencil_ref ref)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   virgl_encoder_set_stencil_ref(vctx, &ref);
+   vctx->deferred.stencil_ref = ref;
+   virgl_defer_state(vctx, VIRGL_DEFERRED_STENCIL_REF,
+                     1 + VIRGL_SET_STENCIL_REF_SIZE);
 }
 
 static void virgl_set_blend_color(struct pipe_context *ctx,
                                  const struct pipe_blend_color *color)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   virgl_encoder_set_blend_color(vctx, color);
+   vctx->deferred.blend_color = *color;
+   virgl_defer_state(vctx, VIRGL_DEFERRED_BLEND_COLOR,
+                     1 + VIRGL_SET_BLEND_COLOR_SIZE);
 }
 
 static void virgl_hw_set_index_buffer(struct virgl_context *vctx,
@@ -1251,7 +1302,9 @@ static void virgl_set_polygon_stipple(struct pipe_context *ctx,
                                      const struct pipe_poly_stipple *ps)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   virgl_encoder_set_polygon_stipple(vctx, ps);
+   vctx->deferred.stipple = *ps;
+   virgl_defer_state(vctx, VIRGL_DEFERRED_POLY_STIPPLE,
+                     1 + VIRGL_POLYGON_STIPPLE_SIZE);
 }
 
 static void virgl_set_scissor_states(struct pipe_context *ctx,
@@ -1260,14 +1313,27 @@ static void virgl_set_scissor_states(struct pipe_context *ctx,
                                    const struct pipe_scissor_state *ss)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   virgl_encoder_set_scissor_state(vctx, start_slot, num_scissor, ss);
+   struct virgl_deferred_state *deferred = &vctx->deferred;
+   uint32_t mask = u_bit_consecutive(start_slot, num_scissor);
+
+   if (deferred->dirty & VIRGL_DEFERRED_SCISSORS)
+      deferred->elided_bytes +=
+         util_bitcount(deferred->scissor_mask & mask) * 2 * 4;
+
+   memcpy(&deferred->scissors[start_slot], ss, num_scissor * sizeof(*ss));
+   if (!(deferred->dirty & VIRGL_DEFERRED_SCISSORS))
+      deferred->scissor_mask = 0;
+   deferred->scissor_mask |= mask;
+   deferred->dirty |= VIRGL_DEFERRED_SCISSORS;
 }
 
 static void virgl_set_sample_mask(struct pipe_context *ctx,
                                  unsigned sample_mask)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   virgl_encoder_set_sample_mask(vctx, sample_mask);
+   vctx->deferred.sample_mask = sample_mask;
+   virgl_defer_state(vctx, VIRGL_DEFERRED_SAMPLE_MASK,
+                     1 + VIRGL_SET_SAMPLE_MASK_SIZE);
 }
 
 static void virgl_set_min_samples(struct pipe_context *ctx,
@@ -1278,14 +1344,18 @@ static void virgl_set_min_samples(struct pipe_context *ctx,
 
    if (!(rs->caps.caps.v2.capability_bits & VIRGL_CAP_SET_MIN_SAMPLES))
       return;
-   virgl_encoder_set_min_samples(vctx, min_samples);
+   vctx->deferred.min_samples = min_samples;
+   virgl_defer_state(vctx, VIRGL_DEFERRED_MIN_SAMPLES,
+                     1 + VIRGL_SET_MIN_SAMPLES_SIZE);
 }
 
 static void virgl_set_clip_state(struct pipe_context *ctx,
                                 const struct pipe_clip_state *clip)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   virgl_encoder_set_clip_state(vctx, clip);
+   vctx->deferred.clip = *clip;
+   virgl_defer_state(vctx, VIRGL_DEFERRED_CLIP,
+                     1 + VIRGL_SET_CLIP_STATE_SIZE);
 }
 
 static void virgl_set_tess_state(struct pipe_context *ctx,
@@ -1610,6 +1680,10 @@ virgl_context_destroy( struct pipe_context *ctx )
 
    util_unreference_framebuffer_state (&fb->base);
 
+   if (virgl_debug & VIRGL_DEBUG_VERBOSE)
+      debug_printf("VIRGL: %" PRIu64 " bytes of superseded state elided\n",
+                   vctx->deferred.elided_bytes);
+
    virgl_encoder_destroy_sub_ctx(vctx, vctx->hw_sub_ctx_id);
    virgl_flush_eq(vctx, vctx, NULL);
 
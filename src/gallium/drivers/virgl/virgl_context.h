@@ -77,6 +77,51 @@ struct virgl_framebuffer_state
    uint32_t zsbuf_handle;
 };
 
+enum virgl_deferred_dirty {
+   VIRGL_DEFERRED_BLEND           = 1 << 0,
+   VIRGL_DEFERRED_DSA             = 1 << 1,
+   VIRGL_DEFERRED_RASTERIZER      = 1 << 2,
+   VIRGL_DEFERRED_VERTEX_ELEMENTS = 1 << 3,
+   VIRGL_DEFERRED_VIEWPORTS       = 1 << 4,
+   VIRGL_DEFERRED_SCISSORS        = 1 << 5,
+   VIRGL_DEFERRED_STENCIL_REF     = 1 << 6,
+   VIRGL_DEFERRED_BLEND_COLOR     = 1 << 7,
+   VIRGL_DEFERRED_SAMPLE_MASK     = 1 << 8,
+   VIRGL_DEFERRED_MIN_SAMPLES     = 1 << 9,
+   VIRGL_DEFERRED_CLIP            = 1 << 10,
+   VIRGL_DEFERRED_POLY_STIPPLE    = 1 << 11,
+};
+
+/*
+ * Small state updates that are only encoded once a command that consumes
+ * them is about to be written, so that state overwritten in between never
+ * reaches the host.  The last value written to each slot wins.
+ */
+struct virgl_deferred_state {
+   uint32_t dirty;
+
+   /* Object handles are never reused, so comparing against what the host
+    * has bound is enough to drop redundant binds.
+    */
+   uint32_t blend, dsa, rasterizer, vertex_elements;
+   uint32_t hw_blend, hw_dsa, hw_rasterizer, hw_vertex_elements;
+
+   uint32_t viewport_mask;
+   struct pipe_viewport_state viewports[PIPE_MAX_VIEWPORTS];
+   uint32_t scissor_mask;
+   struct pipe_scissor_state scissors[PIPE_MAX_VIEWPORTS];
+
+   struct pipe_stencil_ref stencil_ref;
+   struct pipe_blend_color blend_color;
+   unsigned sample_mask;
+   unsigned min_samples;
+   struct pipe_clip_state clip;
+   struct pipe_poly_stipple stipple;
+
+   /* Bytes of commands that were superseded before being encoded. */
+   uint64_t elided_bytes;
+};
+
 struct virgl_context {
    struct pipe_context base;
    struct virgl_cmd_buf *cbuf;
@@ -113,6 +158,8 @@ struct virgl_context {
 
    /* The total size of staging resources used in queued copy transfers. */
    uint64_t queued_staging_res_size;
+
+   struct virgl_deferred_state deferred;
 };
 
 struct virgl_vertex_elements_state {
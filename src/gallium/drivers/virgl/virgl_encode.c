@@ -534,11 +534,53 @@ enum pipe_format virgl_to_pipe_format(enum virgl_formats format)
    return PIPE_FORMAT_NONE;
 }
 
+/* Commands that neither read nor change the state held back in struct
+ * virgl_deferred_state, so they don't need it to be encoded first.
+ */
+static bool virgl_cmd_skips_deferred_state(uint32_t cmd)
+{
+   switch (cmd) {
+   case VIRGL_CCMD_NOP:
+   case VIRGL_CCMD_CREATE_OBJECT:
+   case VIRGL_CCMD_BIND_OBJECT:
+   case VIRGL_CCMD_SET_VIEWPORT_STATE:
+   case VIRGL_CCMD_SET_FRAMEBUFFER_STATE:
+   case VIRGL_CCMD_SET_VERTEX_BUFFERS:
+   case VIRGL_CCMD_SET_SAMPLER_VIEWS:
+   case VIRGL_CCMD_SET_INDEX_BUFFER:
+   case VIRGL_CCMD_SET_CONSTANT_BUFFER:
+   case VIRGL_CCMD_SET_STENCIL_REF:
+   case VIRGL_CCMD_SET_BLEND_COLOR:
+   case VIRGL_CCMD_SET_SCISSOR_STATE:
+   case VIRGL_CCMD_BIND_SAMPLER_STATES:
+   case VIRGL_CCMD_SET_POLYGON_STIPPLE:
+   case VIRGL_CCMD_SET_CLIP_STATE:
+   case VIRGL_CCMD_SET_SAMPLE_MASK:
+   case VIRGL_CCMD_SET_UNIFORM_BUFFER:
+   case VIRGL_CCMD_SET_SUB_CTX:
+   case VIRGL_CCMD_CREATE_SUB_CTX:
+   case VIRGL_CCMD_DESTROY_SUB_CTX:
+   case VIRGL_CCMD_BIND_SHADER:
+   case VIRGL_CCMD_SET_TESS_STATE:
+   case VIRGL_CCMD_SET_MIN_SAMPLES:
+   case VIRGL_CCMD_SET_SHADER_BUFFERS:
+   case VIRGL_CCMD_SET_SHADER_IMAGES:
+   case VIRGL_CCMD_SET_ATOMIC_BUFFERS:
+      return true;
+   default:
+      return false;
+   }
+}
+
 static int virgl_encoder_write_cmd_dword(struct virgl_context *ctx,
                                         uint32_t dword)
 {
    int len = (dword >> 16);
 
+   if (unlikely(ctx->deferred.dirty) &&
+       !virgl_cmd_skips_deferred_state(dword & 0xff))
+      virgl_encode_deferred_state(ctx);
+
    if ((ctx->cbuf->cdw + len + 1) > VIRGL_MAX_CMDBUF_DWORDS)
       ctx->base.flush(&ctx->base, NULL, 0);
 
@@ -1738,6 +1780,66 @@ void virgl_encode_copy_transfer(struct virgl_context *ctx,
    virgl_encoder_write_dword(ctx->cbuf, direction_and_synchronized);
 }
 
+void virgl_encode_deferred_state(struct virgl_context *ctx)
+{
+   struct virgl_deferred_state *deferred = &ctx->deferred;
+   uint32_t dirty = deferred->dirty;
+
+   /* The encoders below must not end up back here. */
+   deferred->dirty = 0;
+
+   if (dirty & VIRGL_DEFERRED_BLEND) {
+      virgl_encode_bind_object(ctx, deferred->blend, VIRGL_OBJECT_BLEND);
+      deferred->hw_blend = deferred->blend;
+   }
+   if (dirty & VIRGL_DEFERRED_DSA) {
+      virgl_encode_bind_object(ctx, deferred->dsa, VIRGL_OBJECT_DSA);
+      deferred->hw_dsa = deferred->dsa;
+   }
+   if (dirty & VIRGL_DEFERRED_RASTERIZER) {
+      virgl_encode_bind_object(ctx, deferred->rasterizer,
+                               VIRGL_OBJECT_RASTERIZER);
+      deferred->hw_rasterizer = deferred->rasterizer;
+   }
+   if (dirty & VIRGL_DEFERRED_VERTEX_ELEMENTS) {
+      virgl_encode_bind_object(ctx, deferred->vertex_elements,
+                               VIRGL_OBJECT_VERTEX_ELEMENTS);
+      deferred->hw_vertex_elements = deferred->vertex_elements;
+   }
+
+   if (dirty & VIRGL_DEFERRED_VIEWPORTS) {
+      uint32_t mask = deferred->viewport_mask;
+      while (mask) {
+         int start, count;
+         u_bit_scan_consecutive_range(&mask, &start, &count);
+         virgl_encoder_set_viewport_states(ctx, start, count,
+                                           &deferred->viewports[start]);
+      }
+   }
+   if (dirty & VIRGL_DEFERRED_SCISSORS) {
+      uint32_t mask = deferred->scissor_mask;
+      while (mask) {
+         int start, count;
+         u_bit_scan_consecutive_range(&mask, &start, &count);
+         virgl_encoder_set_scissor_state(ctx, start, count,
+                                         &deferred->scissors[start]);
+      }
+   }
+
+   if (dirty & VIRGL_DEFERRED_STENCIL_REF)
+      virgl_encoder_set_stencil_ref(ctx, &deferred->stencil_ref);
+   if (dirty & VIRGL_DEFERRED_BLEND_COLOR)
+      virgl_encoder_set_blend_color(ctx, &deferred->blend_color);
+   if (dirty & VIRGL_DEFERRED_SAMPLE_MASK)
+      virgl_encoder_set_sample_mask(ctx, deferred->sample_mask);
+   if (dirty & VIRGL_DEFERRED_MIN_SAMPLES)
+      virgl_encoder_set_min_samples(ctx, deferred->min_samples);
+   if (dirty & VIRGL_DEFERRED_CLIP)
+      virgl_encoder_set_clip_state(ctx, &deferred->clip);
+   if (dirty & VIRGL_DEFERRED_POLY_STIPPLE)
+      virgl_encoder_set_polygon_stipple(ctx, &deferred->stipple);
+}
+
 void virgl_encode_end_transfers(struct virgl_cmd_buf *buf)
 {
    uint32_t command, diff;
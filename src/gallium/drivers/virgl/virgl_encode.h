@@ -215,6 +215,8 @@ void virgl_encoder_set_min_samples(struct virgl_context *ctx,
 void virgl_encoder_set_clip_state(struct virgl_context *ctx,
                                  const struct pipe_clip_state *clip);
 
+void virgl_encode_deferred_state(struct virgl_context *ctx);
+
 int virgl_encode_resource_copy_region(struct virgl_context *ctx,
                                      struct virgl_resource *dst_res,
                                      unsigned dst_level,
@@ -20,6 +20,17 @@ debug_describe_zink_batch_state(char *buf, const struct zink_batch_state *ptr)
    sprintf(buf, "zink_batch_state");
 }
 
+/* tracking ids are never 0 so that new resource objects never match a batch state */
+static uint32_t
+new_track_id(struct zink_screen *screen)
+{
+   uint32_t id;
+   do {
+      id = p_atomic_inc_return(&screen->batch_track_id);
+   } while (!id);
+   return id;
+}
+
 /* this resets the batch usage and tracking for a resource object */
 static void
 reset_obj(struct zink_screen *screen, struct zink_batch_state *bs, struct zink_resource_object *obj)
@@ -154,6 +165,7 @@ reset_batch_state_internal(struct zink_screen *screen, struct zink_batch_state *
    bs->usage.usage = 0;
    bs->next = NULL;
    bs->last_added_obj = NULL;
+   bs->track_id = new_track_id(screen);
 
    bs->has_work = false;
    bs->has_reordered_work = false;
@@ -358,6 +370,7 @@ create_batch_state(struct zink_context *ctx)
    _mesa_set_init(ptr, bs, _mesa_hash_pointer, _mesa_key_pointer_equal)
 
    bs->ctx = ctx;
+   bs->track_id = new_track_id(screen);
 
    SET_CREATE(&bs->programs);
    SET_CREATE(&bs->active_queries);
@@ -1089,6 +1102,11 @@ zink_batch_reference_resource_move(struct zink_context *ctx, struct zink_resourc
    if (res->obj == bs->last_added_obj) {
       return true;
    }
+   /* the object remembers the last batch state that tracked it, which avoids a list lookup */
+   if (p_atomic_read(&res->obj->track_id) == bs->track_id) {
+      bs->last_added_obj = res->obj;
+      return true;
+   }
 
    struct zink_bo *bo = res->obj->bo;
    struct zink_batch_obj_list *list;
@@ -1101,7 +1119,9 @@ zink_batch_reference_resource_move(struct zink_context *ctx, struct zink_resourc
    } else {
       list = &bs->sparse_objs;
    }
-   return batch_reference_resource_move_internal(bs, list, res);
+   bool found = batch_reference_resource_move_internal(bs, list, res);
+   p_atomic_set(&res->obj->track_id, bs->track_id);
+   return found;
 }
 
 bool
@@ -817,8 +817,10 @@ update_descriptor_state_sampler(struct zink_context *ctx, mesa_shader_stage shad
 void
 zink_update_shadow_samplerviews(struct zink_context *ctx, unsigned mask)
 {
-   u_foreach_bit(slot, mask)
+   u_foreach_bit(slot, mask) {
       update_descriptor_state_sampler(ctx, MESA_SHADER_FRAGMENT, slot, ctx->di.descriptor_res[ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW][MESA_SHADER_FRAGMENT][slot]);
+      zink_descriptors_db_mark_dirty(ctx, MESA_SHADER_FRAGMENT, ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW, slot, 1);
+   }
 }
 
 ALWAYS_INLINE static struct zink_resource *
@@ -2967,8 +2969,10 @@ update_res_sampler_layouts(struct zink_context *ctx, struct zink_resource *res)
    for (unsigned i = 0; find && i < MESA_SHADER_COMPUTE; i++) {
       u_foreach_bit(slot, res->sampler_binds[i]) {
          /* only set layout, skip rest of update */
-         if (ctx->di.descriptor_res[ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW][i][slot] == res)
+         if (ctx->di.descriptor_res[ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW][i][slot] == res) {
             ctx->di.textures[i][slot].imageLayout = zink_descriptor_util_image_layout_eval(ctx, res, false);
+            zink_descriptors_db_mark_dirty(ctx, i, ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW, slot, 1);
+         }
          find--;
          if (!find) break;
       }
@@ -6034,6 +6038,7 @@ zink_update_barriers(struct zink_context *ctx, bool is_compute,
    ctx->need_barriers[is_compute] = &ctx->update_barriers[is_compute][ctx->barrier_set_idx[is_compute]];
    bool general_layout = zink_screen(ctx->base.screen)->driver_workarounds.general_layout;
    ASSERTED bool check_rp = ctx->in_rp && ctx->dynamic_fb.tc_info.zsbuf_invalidate;
+   zink_barrier_batch_begin(ctx);
    set_foreach(need_barriers, he) {
       struct zink_resource *res = (struct zink_resource *)he->key;
       if (res->bind_count[is_compute]) {
@@ -6067,6 +6072,7 @@ zink_update_barriers(struct zink_context *ctx, bool is_compute,
       if (!need_barriers->entries)
          break;
    }
+   zink_barrier_batch_end(ctx);
 }
 
 /**
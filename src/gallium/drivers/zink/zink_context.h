@@ -171,6 +171,10 @@ zink_resource_buffer_transfer_dst_barrier(struct zink_context *ctx, struct zink_
 void
 zink_synchronization_init(struct zink_screen *screen);
 void
+zink_barrier_batch_begin(struct zink_context *ctx);
+void
+zink_barrier_batch_end(struct zink_context *ctx);
+void
 zink_update_descriptor_refs(struct zink_context *ctx, bool compute);
 void
 zink_init_vk_sample_locations(struct zink_context *ctx, VkSampleLocationsInfoEXT *loc);
@@ -332,6 +332,9 @@ init_db_template_entry(struct zink_screen *screen, struct zink_shader *shader, e
     int index = shader->bindings[type][idx].index;
     mesa_shader_stage stage = clamp_stage(&shader->info);
     entry->count = shader->bindings[type][idx].size;
+    entry->stage = stage;
+    entry->type = type;
+    entry->index = index;
 
     switch (shader->bindings[type][idx].type) {
     case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
@@ -509,6 +512,7 @@ zink_descriptor_program_init(struct zink_context *ctx, struct zink_program *pg)
 
    unsigned entry_idx[ZINK_DESCRIPTOR_BASE_TYPES] = {0};
    if (zink_descriptor_mode == ZINK_DESCRIPTOR_MODE_DB) {
+      pg->dd.db_id = p_atomic_inc_return(&screen->db_program_counter);
       unsigned desc_set_size[ZINK_DESCRIPTOR_BASE_TYPES];
       for (unsigned i = 0; i < ZINK_DESCRIPTOR_BASE_TYPES; i++)
          desc_set_size[i] = zink_program_num_bindings_typed(pg, i);
@@ -1171,6 +1175,28 @@ update_separable(struct zink_context *ctx, struct zink_program *pg)
    }
 }
 
+static bool
+db_cache_resize(struct zink_descriptor_db_cache *cache, unsigned size)
+{
+   cache->program_id = 0;
+   if (cache->size == size)
+      return true;
+   free(cache->data);
+   /* padding between bindings is never written, so keep it deterministic */
+   cache->data = calloc(1, size);
+   cache->size = cache->data ? size : 0;
+   return !!cache->data;
+}
+
+static bool
+db_cache_binding_dirty(const struct zink_context *ctx, enum zink_pipeline_idx pidx, const struct zink_descriptor_template *t)
+{
+   /* slots which don't fit in the mask are always updated */
+   if (t->index + t->count > 64)
+      return true;
+   return (ctx->dd.db_dirty[pidx][t->stage][t->type] & BITFIELD64_RANGE(t->index, t->count)) != 0;
+}
+
 /* updates the mask of changed_sets and binds the mask of bind_sets */
 static void
 zink_descriptors_update_masked_buffer(struct zink_context *ctx, enum zink_pipeline_idx pidx, uint8_t changed_sets, uint8_t bind_sets)
@@ -1194,25 +1220,35 @@ zink_descriptors_update_masked_buffer(struct zink_context *ctx, enum zink_pipeli
       uint64_t offset = changed ? bs->dd.db_offset : bs->dd.cur_db_offset[type];
       if (pg->dd.db_template[type] && changed) {
          const struct zink_descriptor_layout_key *key = pg->dd.pool_key[type]->layout;
+         struct zink_descriptor_db_cache *cache = &ctx->dd.db_cache[pidx][type];
          VkDescriptorGetInfoEXT info;
          info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
          info.pNext = NULL;
          assert(bs->dd.db->base.b.width0 > bs->dd.db_offset + pg->dd.db_size[type]);
+         /* the cached set can only be partially updated if it was last written for this program */
+         bool cache_valid = cache->program_id == pg->dd.db_id;
+         if (!cache_valid && !db_cache_resize(cache, pg->dd.db_size[type])) {
+            mesa_loge("ZINK: failed to allocate descriptor cache!");
+            return;
+         }
          for (unsigned i = 0; i < key->num_bindings; i++) {
+            const struct zink_descriptor_template *t = &pg->dd.db_template[type][i];
+            if (cache_valid && !db_cache_binding_dirty(ctx, pidx, t))
+               continue;
             info.type = key->bindings[i].descriptorType;
-            uint64_t desc_offset = offset + pg->dd.db_offset[type][i];
+            uint32_t desc_offset = pg->dd.db_offset[type][i];
             if (screen->info.db_props.combinedImageSamplerDescriptorSingleArray ||
                 key->bindings[i].descriptorType != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
                 key->bindings[i].descriptorCount == 1) {
                for (unsigned j = 0; j < key->bindings[i].descriptorCount; j++) {
                   /* VkDescriptorDataEXT is a union of pointers; the member doesn't matter */
-                  info.data.pSampler = (void*)(((uint8_t*)ctx) + pg->dd.db_template[type][i].offset + j * pg->dd.db_template[type][i].stride);
-                  VKSCR(GetDescriptorEXT)(screen->dev, &info, pg->dd.db_template[type][i].db_size, bs->dd.db_map + desc_offset + j * pg->dd.db_template[type][i].db_size);
+                  info.data.pSampler = (void*)(((uint8_t*)ctx) + t->offset + j * t->stride);
+                  VKSCR(GetDescriptorEXT)(screen->dev, &info, t->db_size, cache->data + desc_offset + j * t->db_size);
                }
             } else {
                assert(key->bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
                char buf[1024];
-               uint8_t *db = bs->dd.db_map + desc_offset;
+               uint8_t *db = cache->data + desc_offset;
                uint8_t *samplers = db + key->bindings[i].descriptorCount * screen->info.db_props.sampledImageDescriptorSize;
                for (unsigned j = 0; j < key->bindings[i].descriptorCount; j++) {
                   /* VkDescriptorDataEXT is a union of pointers; the member doesn't matter */
@@ -1232,6 +1268,15 @@ zink_descriptors_update_masked_buffer(struct zink_context *ctx, enum zink_pipeli
                }
             }
          }
+         /* every binding of the set is valid now */
+         for (unsigned i = 0; i < key->num_bindings; i++) {
+            const struct zink_descriptor_template *t = &pg->dd.db_template[type][i];
+            if (t->index + t->count <= 64)
+               ctx->dd.db_dirty[pidx][t->stage][t->type] &= ~BITFIELD64_RANGE(t->index, t->count);
+         }
+         cache->program_id = pg->dd.db_id;
+         /* the db is usually write-combined memory: write the whole set sequentially */
+         memcpy(bs->dd.db_map + offset, cache->data, pg->dd.db_size[type]);
          bs->dd.cur_db_offset[type] = bs->dd.db_offset;
          bs->dd.db_offset += pg->dd.db_size[type];
       }
@@ -1483,6 +1528,21 @@ zink_descriptors_update(struct zink_context *ctx, enum zink_pipeline_idx pidx)
    ctx->dd.state_changed[pidx] = 0;
 }
 
+/* marks descriptors which have to be regenerated the next time their set is written in db mode */
+void
+zink_descriptors_db_mark_dirty(struct zink_context *ctx, mesa_shader_stage shader, enum zink_descriptor_type type, unsigned start, unsigned count)
+{
+   uint64_t mask = start >= 64 ? 0 : BITFIELD64_RANGE(start, MIN2(count, 64 - start));
+   if (shader == MESA_SHADER_COMPUTE) {
+      ctx->dd.db_dirty[ZINK_PIPELINE_COMPUTE][shader][type] |= mask;
+   } else {
+      if (shader <= MESA_SHADER_FRAGMENT)
+         ctx->dd.db_dirty[ZINK_PIPELINE_GFX][shader][type] |= mask;
+      if (shader >= MESA_SHADER_FRAGMENT)
+         ctx->dd.db_dirty[ZINK_PIPELINE_MESH][shader][type] |= mask;
+   }
+}
+
 /* called from gallium descriptor change hooks, e.g., set_sampler_views */
 void
 zink_context_invalidate_descriptor_state(struct zink_context *ctx, mesa_shader_stage shader, enum zink_descriptor_type type, unsigned start, unsigned count)
@@ -1497,6 +1557,7 @@ zink_context_invalidate_descriptor_state(struct zink_context *ctx, mesa_shader_s
       else
          ctx->dd.push_state_changed[ZINK_PIPELINE_GFX] = ctx->dd.push_state_changed[ZINK_PIPELINE_MESH] = true;
    } else {
+      zink_descriptors_db_mark_dirty(ctx, shader, type, start, count);
       if (shader == MESA_SHADER_COMPUTE)
          ctx->dd.state_changed[ZINK_PIPELINE_COMPUTE] |= BITFIELD_BIT(type);
       else if (shader < MESA_SHADER_FRAGMENT)
@@ -1522,6 +1583,7 @@ zink_context_invalidate_descriptor_state_compact(struct zink_context *ctx, mesa_
       else
          ctx->dd.push_state_changed[ZINK_PIPELINE_GFX] = ctx->dd.push_state_changed[ZINK_PIPELINE_MESH] = true;
    else {
+      zink_descriptors_db_mark_dirty(ctx, shader, type, start, count);
       if (type > ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW)
          type -= ZINK_DESCRIPTOR_COMPACT;
       if (shader == MESA_SHADER_COMPUTE)
@@ -1728,6 +1790,10 @@ zink_descriptors_deinit(struct zink_context *ctx)
    if (ctx->dd.push_dsl[1])
       VKSCR(DestroyDescriptorSetLayout)(screen->dev, ctx->dd.push_dsl[1]->layout, NULL);
    VKSCR(DestroyDescriptorSetLayout)(screen->dev, ctx->dd.old_push_dsl, NULL);
+   for (unsigned i = 0; i < ZINK_PIPELINE_MAX; i++) {
+      for (unsigned j = 0; j < ZINK_DESCRIPTOR_BASE_TYPES; j++)
+         free(ctx->dd.db_cache[i][j].data);
+   }
 }
 
 /* called on screen creation */
@@ -186,6 +186,8 @@ void
 zink_context_invalidate_descriptor_state(struct zink_context *ctx, mesa_shader_stage shader, enum zink_descriptor_type type, unsigned, unsigned);
 void
 zink_context_invalidate_descriptor_state_compact(struct zink_context *ctx, mesa_shader_stage shader, enum zink_descriptor_type type, unsigned, unsigned);
+void
+zink_descriptors_db_mark_dirty(struct zink_context *ctx, mesa_shader_stage shader, enum zink_descriptor_type type, unsigned start, unsigned count);
 
 void
 zink_batch_descriptor_deinit(struct zink_screen *screen, struct zink_batch_state *bs);
@@ -968,6 +968,7 @@ zink_gfx_program_compile_queue(struct zink_context *ctx, struct zink_gfx_pipelin
    struct zink_screen *screen = zink_screen(ctx->base.screen);
    if (screen->driver_workarounds.disable_optimized_compile)
       return;
+   ctx->hud.pipeline_async_compiles++;
    if (zink_debug & ZINK_DEBUG_NOBGC) {
       if (pc_entry->prog->base.uses_shobj)
          optimized_shobj_compile_job(pc_entry, screen, 0);
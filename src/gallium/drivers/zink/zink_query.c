@@ -14,6 +14,10 @@
 #define NOWAIT_CHECK_THRESHOLD 10 //prevent spinning
 
 #define ZINK_QUERY_RENDER_PASSES (PIPE_QUERY_DRIVER_SPECIFIC + 0)
+#define ZINK_QUERY_PIPELINE_MISSES (PIPE_QUERY_DRIVER_SPECIFIC + 1)
+#define ZINK_QUERY_PIPELINE_FAST_LINKS (PIPE_QUERY_DRIVER_SPECIFIC + 2)
+#define ZINK_QUERY_PIPELINE_SYNC_COMPILES (PIPE_QUERY_DRIVER_SPECIFIC + 3)
+#define ZINK_QUERY_PIPELINE_ASYNC_COMPILES (PIPE_QUERY_DRIVER_SPECIFIC + 4)
 
 struct zink_query_pool {
    struct list_head list;
@@ -93,6 +97,10 @@ struct zink_query {
 
 static const struct pipe_driver_query_info zink_specific_queries[] = {
    {"render-passes", ZINK_QUERY_RENDER_PASSES, { 0 }},
+   {"pipeline-misses", ZINK_QUERY_PIPELINE_MISSES, { 0 }},
+   {"pipeline-fast-links", ZINK_QUERY_PIPELINE_FAST_LINKS, { 0 }},
+   {"pipeline-sync-compiles", ZINK_QUERY_PIPELINE_SYNC_COMPILES, { 0 }},
+   {"pipeline-async-compiles", ZINK_QUERY_PIPELINE_ASYNC_COMPILES, { 0 }},
 };
 
 static inline int
@@ -1137,9 +1145,29 @@ zink_get_query_result(struct pipe_context *pctx,
       return result->b;
    }
 
-   if (query->type == ZINK_QUERY_RENDER_PASSES) {
-      result->u64 = ctx->hud.render_passes;
-      ctx->hud.render_passes = 0;
+   if (query->type >= PIPE_QUERY_DRIVER_SPECIFIC) {
+      uint64_t *counter;
+      switch (query->type) {
+      case ZINK_QUERY_RENDER_PASSES:
+         counter = &ctx->hud.render_passes;
+         break;
+      case ZINK_QUERY_PIPELINE_MISSES:
+         counter = &ctx->hud.pipeline_misses;
+         break;
+      case ZINK_QUERY_PIPELINE_FAST_LINKS:
+         counter = &ctx->hud.pipeline_fast_links;
+         break;
+      case ZINK_QUERY_PIPELINE_SYNC_COMPILES:
+         counter = &ctx->hud.pipeline_sync_compiles;
+         break;
+      case ZINK_QUERY_PIPELINE_ASYNC_COMPILES:
+         counter = &ctx->hud.pipeline_async_compiles;
+         break;
+      default:
+         UNREACHABLE("unknown driver query");
+      }
+      result->u64 = *counter;
+      *counter = 0;
       return true;
    }
 
@@ -259,6 +259,76 @@ struct emit_memory_barrier {
 };
 
 
+static void
+barrier_batch_flush(struct zink_context *ctx)
+{
+   unsigned num_memory = util_dynarray_num_elements(&ctx->barrier_batch.memory_barriers, VkMemoryBarrier2);
+   unsigned num_image = util_dynarray_num_elements(&ctx->barrier_batch.image_barriers, VkImageMemoryBarrier2);
+   if (!num_memory && !num_image)
+      return;
+
+   VkDependencyInfo dep = {
+      VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+      NULL,
+      0,
+      num_memory,
+      (VkMemoryBarrier2 *)ctx->barrier_batch.memory_barriers.data,
+      0,
+      NULL,
+      num_image,
+      (VkImageMemoryBarrier2 *)ctx->barrier_batch.image_barriers.data
+   };
+   VKCTX(CmdPipelineBarrier2)(ctx->barrier_batch.cmdbuf, &dep);
+
+   util_dynarray_clear(&ctx->barrier_batch.memory_barriers);
+   util_dynarray_clear(&ctx->barrier_batch.image_barriers);
+}
+
+/* returns whether the barrier should be added to the batch instead of being emitted */
+static bool
+barrier_batch_prepare(struct zink_context *ctx, VkCommandBuffer cmdbuf)
+{
+   if (!ctx->barrier_batch.active)
+      return false;
+   if (ctx->barrier_batch.cmdbuf != cmdbuf) {
+      barrier_batch_flush(ctx);
+      ctx->barrier_batch.cmdbuf = cmdbuf;
+   }
+   return true;
+}
+
+/* Barriers emitted between begin and end are collected per cmdbuf and emitted together.
+ * Nothing else may be recorded in the meantime, which is the case for the resource
+ * barriers emitted by zink_update_barriers(): each resource is only synchronized once,
+ * and the cmdbuf used for them either is the reordered cmdbuf or has no renderpass active.
+ */
+void
+zink_barrier_batch_begin(struct zink_context *ctx)
+{
+   struct zink_screen *screen = zink_screen(ctx->base.screen);
+
+   /* debug markers need to wrap each barrier */
+   if (zink_tracing || !(screen->info.have_vulkan13 || screen->info.have_KHR_synchronization2))
+      return;
+
+   if (!ctx->barrier_batch.memory_barriers.mem_ctx) {
+      util_dynarray_init(&ctx->barrier_batch.memory_barriers, ctx);
+      util_dynarray_init(&ctx->barrier_batch.image_barriers, ctx);
+   }
+   ctx->barrier_batch.active = true;
+   ctx->barrier_batch.cmdbuf = VK_NULL_HANDLE;
+}
+
+void
+zink_barrier_batch_end(struct zink_context *ctx)
+{
+   if (!ctx->barrier_batch.active)
+      return;
+
+   barrier_batch_flush(ctx);
+   ctx->barrier_batch.active = false;
+}
+
 template <>
 struct emit_memory_barrier<barrier_KHR_synchronzation2> {
    static void for_image(struct zink_context *ctx, struct zink_resource *res, VkImageLayout new_layout,
@@ -276,6 +346,10 @@ struct emit_memory_barrier<barrier_KHR_synchronzation2> {
          res->queue = VK_QUEUE_FAMILY_IGNORED;
          *queue_import = true;
       }
+      if (barrier_batch_prepare(ctx, cmdbuf)) {
+         util_dynarray_append(&ctx->barrier_batch.image_barriers, imb);
+         return;
+      }
       VkDependencyInfo dep = {
          VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
          NULL,
@@ -306,6 +380,10 @@ struct emit_memory_barrier<barrier_KHR_synchronzation2> {
       bmb.srcAccessMask = src_flags;
       bmb.dstStageMask = pipeline;
       bmb.dstAccessMask = flags;
+      if (barrier_batch_prepare(ctx, cmdbuf)) {
+         util_dynarray_append(&ctx->barrier_batch.memory_barriers, bmb);
+         return;
+      }
       VkDependencyInfo dep = {
           VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
           NULL,
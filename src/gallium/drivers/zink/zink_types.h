@@ -428,10 +428,20 @@ struct zink_descriptor_pool_key {
 struct zink_descriptor_template {
    uint16_t stride; //the stride between mem pointers
    uint16_t db_size; //the size of the entry in the buffer
+   uint8_t stage; //the stage of the host data
+   uint8_t type; //the zink_descriptor_type of the host data
+   uint16_t index; //the first slot of the host data
    unsigned count; //the number of descriptors
    size_t offset; //the offset of the base host pointer to update from
 };
 
+/* a CPU copy of the last contents of a descriptor set written in db mode */
+struct zink_descriptor_db_cache {
+   unsigned program_id; //the zink_program_descriptor_data::db_id the data was written for, 0 if invalid
+   unsigned size;
+   uint8_t *data;
+};
+
 /* ctx->dd; created at context creation */
 struct zink_descriptor_data {
    bool bindless_bound;
@@ -471,6 +481,10 @@ struct zink_descriptor_data {
    uint32_t db_size[ZINK_PIPELINE_MAX]; //gfx, compute, mesh
    uint32_t db_offset[ZINK_GFX_SHADER_COUNT + 1]; //gfx + fbfetch
    /* compute offset is always 0 */
+
+   /* db mode only rewrites the descriptors that were invalidated since a set was last written */
+   struct zink_descriptor_db_cache db_cache[ZINK_PIPELINE_MAX][ZINK_DESCRIPTOR_BASE_TYPES]; //gfx, compute, mesh
+   uint64_t db_dirty[ZINK_PIPELINE_MAX][MESA_SHADER_STAGES][ZINK_DESCRIPTOR_BASE_TYPES]; //bitmask of invalidated slots
 };
 
 /* pg->dd; created at program creation */
@@ -491,6 +505,7 @@ struct zink_program_descriptor_data {
       struct zink_descriptor_template *db_template[ZINK_DESCRIPTOR_NON_BINDLESS_TYPES];
    };
    uint32_t db_size[ZINK_DESCRIPTOR_NON_BINDLESS_TYPES]; //the total size of the layout
+   unsigned db_id; //unique id for matching ctx->dd.db_cache
    uint32_t *db_offset[ZINK_DESCRIPTOR_NON_BINDLESS_TYPES]; //the offset of each binding in the layout
 };
 
@@ -656,6 +671,8 @@ struct zink_batch_state {
    struct zink_batch_obj_list sparse_objs;
    struct zink_batch_obj_list unsync_objs;
    struct zink_resource_object *last_added_obj;
+   /* screen-unique id of the current recording; objects in real/slab/sparse_objs store it in track_id */
+   uint32_t track_id;
    struct util_dynarray swapchain_obj; //this doesn't have a zink_bo and must be handled differently
    struct util_dynarray swapchain_obj_unsync; //this doesn't have a zink_bo and must be handled differently
 
@@ -1200,6 +1217,10 @@ struct zink_resource_object {
    bool unsync_access;
    bool copies_valid;
    bool copies_need_reset; //for use with batch state resets
+   /* the zink_batch_state::track_id of the last batch state that added this object to its
+    * real/slab/sparse object list; this is only a hint and may be overwritten by other contexts
+    */
+   uint32_t track_id;
 
    struct u_rwlock copy_lock;
    struct util_dynarray copies[16]; //regions being copied to; for barrier omission
@@ -1366,6 +1387,7 @@ struct zink_screen {
    bool frame_marker_emitted;
    bool driver_name_is_inferred;
    uint64_t curr_batch; //the current batch id
+   uint32_t batch_track_id; //the last zink_batch_state::track_id
    uint32_t last_finished;
    VkSemaphore sem;
    VkFence fence;
@@ -1388,6 +1410,7 @@ struct zink_screen {
    unsigned buffer_rebind_counter;
    unsigned image_rebind_counter;
    unsigned robust_ctx_count;
+   unsigned db_program_counter;
 
    struct hash_table dts;
    simple_mtx_t dt_lock;
@@ -1875,6 +1898,10 @@ struct zink_context {
    } render_condition;
    struct {
       uint64_t render_passes;
+      uint64_t pipeline_misses; //pipeline state hash misses on draw
+      uint64_t pipeline_fast_links; //misses resolved by fast-linking library parts
+      uint64_t pipeline_sync_compiles; //misses resolved by compiling a full pipeline on draw
+      uint64_t pipeline_async_compiles; //optimized pipelines queued for background compiles
    } hud;
 
    struct pipe_resource *dummy_xfb_buffer;
@@ -1950,6 +1977,13 @@ struct zink_context {
    struct set *need_barriers[2]; //gfx, compute
    struct set update_barriers[2][2]; //[gfx, compute][current, next]
    uint8_t barrier_set_idx[2];
+   /* barriers collected by zink_update_barriers() and emitted with a single vkCmdPipelineBarrier2 */
+   struct {
+      bool active;
+      VkCommandBuffer cmdbuf;
+      struct util_dynarray memory_barriers; //VkMemoryBarrier2
+      struct util_dynarray image_barriers; //VkImageMemoryBarrier2
+   } barrier_batch;
    unsigned memory_barrier;
 
    uint32_t ds3_states;
@@ -315,6 +315,30 @@ get_image_handle_bda(struct lvp_device *device, VkDeviceAddress address, size_t
    return *handle;
 }
 
+static void
+write_immutable_samplers(struct lvp_descriptor_set *set)
+{
+   const struct lvp_descriptor_set_layout *layout = set->layout;
+
+   for (uint32_t binding_index = 0; binding_index < layout->binding_count; binding_index++) {
+      const struct lvp_descriptor_set_binding_layout *bind_layout = &layout->binding[binding_index];
+      if (!bind_layout->immutable_samplers)
+         continue;
+
+      struct lp_descriptor *desc = set->map;
+      desc += bind_layout->descriptor_index;
+
+      for (uint32_t sampler_index = 0; sampler_index < bind_layout->array_size; sampler_index++) {
+         if (bind_layout->immutable_samplers[sampler_index]) {
+            for (uint32_t s = 0; s < bind_layout->stride; s++)  {
+               int idx = sampler_index * bind_layout->stride + s;
+               desc[idx] = bind_layout->immutable_samplers[sampler_index]->desc;
+            }
+         }
+      }
+   }
+}
+
 VkResult
 lvp_descriptor_set_create(struct lvp_device *device,
                           struct lvp_descriptor_set_layout *layout,
@@ -357,29 +381,23 @@ lvp_descriptor_set_create(struct lvp_device *device,
 
    device->pscreen->resource_bind_backing(device->pscreen, set->bo, set->pmem, 0, 0, 0);
 
-   for (uint32_t binding_index = 0; binding_index < layout->binding_count; binding_index++) {
-      const struct lvp_descriptor_set_binding_layout *bind_layout = &set->layout->binding[binding_index];
-      if (!bind_layout->immutable_samplers)
-         continue;
-
-      struct lp_descriptor *desc = set->map;
-      desc += bind_layout->descriptor_index;
-
-      for (uint32_t sampler_index = 0; sampler_index < bind_layout->array_size; sampler_index++) {
-         if (bind_layout->immutable_samplers[sampler_index]) {
-            for (uint32_t s = 0; s < bind_layout->stride; s++)  {
-               int idx = sampler_index * bind_layout->stride + s;
-               desc[idx] = bind_layout->immutable_samplers[sampler_index]->desc;
-            }
-         }
-      }
-   }
+   write_immutable_samplers(set);
 
    *out_set = set;
 
    return VK_SUCCESS;
 }
 
+/* Puts the set back into the state lvp_descriptor_set_create() returns it
+ * in, without reallocating its memory.
+ */
+void
+lvp_descriptor_set_reset(struct lvp_descriptor_set *set)
+{
+   memset(set->map, 0, set->bo->width0);
+   write_immutable_samplers(set);
+}
+
 void
 lvp_descriptor_set_destroy(struct lvp_device *device,
                            struct lvp_descriptor_set *set)
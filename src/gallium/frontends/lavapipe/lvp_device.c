@@ -1635,7 +1635,7 @@ VKAPI_ATTR void VKAPI_CALL lvp_GetPhysicalDeviceQueueFamilyProperties2(
          VK_QUEUE_COMPUTE_BIT |
          VK_QUEUE_TRANSFER_BIT |
          (DETECT_OS_LINUX ? VK_QUEUE_SPARSE_BINDING_BIT : 0),
-         .queueCount = 1,
+         .queueCount = LVP_NUM_QUEUES,
          .timestampValidBits = 64,
          .minImageTransferGranularity = (VkExtent3D) { 1, 1, 1 },
       };
@@ -1748,7 +1748,13 @@ lvp_queue_submit(struct vk_queue *vk_queue,
    if (result != VK_SUCCESS)
       return result;
 
-   simple_mtx_lock(&queue->lock);
+   /* Shaders and pipelines are shared by all queues and the gallium state
+    * objects behind them aren't thread-safe, so the replay into the queue's
+    * context is serialized on the lock of the first queue.  Waiting for the
+    * replayed commands to complete happens outside of it, so the other
+    * queues can replay while this one's thread pool is busy.
+    */
+   simple_mtx_lock(&device->queue.lock);
 
    for (uint32_t i = 0; i < submit->buffer_bind_count; i++) {
       VkSparseBufferMemoryBindInfo *bind = &submit->buffer_binds[i];
@@ -1773,9 +1779,13 @@ lvp_queue_submit(struct vk_queue *vk_queue,
          container_of(submit->command_buffers[i], struct lvp_cmd_buffer, vk);
 
       lvp_execute_cmds(device, queue, cmd_buffer);
+
+      simple_mtx_unlock(&device->queue.lock);
+      lvp_finish_cmds(device, queue);
+      simple_mtx_lock(&device->queue.lock);
    }
 
-   simple_mtx_unlock(&queue->lock);
+   simple_mtx_unlock(&device->queue.lock);
 
    if (submit->command_buffer_count > 0)
       queue->ctx->flush(queue->ctx, &queue->last_fence, 0);
@@ -1785,7 +1795,7 @@ lvp_queue_submit(struct vk_queue *vk_queue,
          vk_sync_as_lvp_pipe_sync(submit->signals[i].sync);
       lvp_pipe_sync_signal_with_fence(device, sync, queue->last_fence);
    }
-   destroy_pipelines(queue);
+   destroy_pipelines(&device->queue);
 
    return VK_SUCCESS;
 }
@@ -1814,6 +1824,7 @@ lvp_queue_init(struct lvp_device *device, struct lvp_queue *queue,
 
    simple_mtx_init(&queue->lock, mtx_plain);
    queue->pipeline_destroys = UTIL_DYNARRAY_INIT;
+   queue->desc_set_cache = _mesa_pointer_hash_table_create(NULL);
 
    return VK_SUCCESS;
 }
@@ -1827,6 +1838,13 @@ lvp_queue_finish(struct lvp_queue *queue)
    simple_mtx_destroy(&queue->lock);
    util_dynarray_fini(&queue->pipeline_destroys);
 
+   hash_table_foreach(queue->desc_set_cache, entry) {
+      util_dynarray_foreach((struct util_dynarray *)entry->data,
+                            struct lvp_descriptor_set *, set)
+         lvp_descriptor_set_destroy(lvp_queue_device(queue), *set);
+   }
+   _mesa_hash_table_destroy(queue->desc_set_cache, NULL);
+
    u_upload_destroy(queue->uploader);
    cso_destroy_context(queue->cso);
    queue->ctx->destroy(queue->ctx);
@@ -1844,14 +1862,16 @@ VKAPI_ATTR VkResult VKAPI_CALL lvp_CreateDevice(
 
    assert(pCreateInfo->sType == VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO);
 
-   size_t state_size = lvp_get_rendering_state_size();
+   size_t state_size = align(lvp_get_rendering_state_size(), 8);
    device = vk_zalloc2(&physical_device->vk.instance->alloc, pAllocator,
-                       sizeof(*device) + state_size, 8,
+                       sizeof(*device) + state_size * LVP_NUM_QUEUES, 8,
                        VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
    if (!device)
       return vk_error(instance, VK_ERROR_OUT_OF_HOST_MEMORY);
 
    device->queue.state = device + 1;
+   for (uint32_t i = 0; i < LVP_NUM_QUEUES - 1; i++)
+      device->extra_queues[i].state = (char *)(device + 1) + state_size * (i + 1);
    device->poison_mem = debug_get_bool_option("LVP_POISON_MEMORY", false);
    device->print_cmds = debug_get_bool_option("LVP_CMD_DEBUG", false);
 
@@ -1875,14 +1895,21 @@ VKAPI_ATTR VkResult VKAPI_CALL lvp_CreateDevice(
 
    device->pscreen = physical_device->pscreen;
 
-   assert(pCreateInfo->queueCreateInfoCount <= LVP_NUM_QUEUES);
+   assert(pCreateInfo->queueCreateInfoCount <= 1);
    if (pCreateInfo->queueCreateInfoCount) {
-      assert(pCreateInfo->pQueueCreateInfos[0].queueFamilyIndex == 0);
-      assert(pCreateInfo->pQueueCreateInfos[0].queueCount == 1);
-      result = lvp_queue_init(device, &device->queue, pCreateInfo->pQueueCreateInfos, 0);
+      const VkDeviceQueueCreateInfo *queue_create = pCreateInfo->pQueueCreateInfos;
+      assert(queue_create->queueFamilyIndex == 0);
+      assert(queue_create->queueCount <= LVP_NUM_QUEUES);
+      result = lvp_queue_init(device, &device->queue, queue_create, 0);
+
+      for (uint32_t i = 1; result == VK_SUCCESS && i < queue_create->queueCount; i++) {
+         result = lvp_queue_init(device, &device->extra_queues[i - 1], queue_create, i);
+         if (result == VK_SUCCESS)
+            device->num_extra_queues++;
+      }
    } else {
       /* VK_KHR_maintenance9 allows zero queues devices used to compile shaders only.
-      *  Since we only ever create a single queue, and it has no hardward backing it,
+      *  Since our queues have no hardware backing them,
       *  we can just create a dummy queue on the behalf of the user.
       */
       const float fake_priority = 1.0f;
@@ -1898,6 +1925,10 @@ VKAPI_ATTR VkResult VKAPI_CALL lvp_CreateDevice(
    }
 
    if (result != VK_SUCCESS) {
+      for (uint32_t i = 0; i < device->num_extra_queues; i++)
+         lvp_queue_finish(&device->extra_queues[i]);
+      if (device->queue.ctx)
+         lvp_queue_finish(&device->queue);
       vk_free(&device->vk.alloc, device);
       return result;
    }
@@ -1968,6 +1999,18 @@ VKAPI_ATTR void VKAPI_CALL lvp_DestroyDevice(
    simple_mtx_destroy(&device->bda_lock);
    pipe_resource_reference(&device->zero_buffer, NULL);
 
+   /* Pending pipelines may have shader variants in the variant lists of
+    * any queue's context, so destroy them before those go away.
+    */
+   destroy_pipelines(&device->queue);
+
+   for (uint32_t i = 0; i < device->num_extra_queues; i++) {
+      struct lvp_queue *queue = &device->extra_queues[i];
+      if (queue->last_fence)
+         device->pscreen->fence_reference(device->pscreen, &queue->last_fence, NULL);
+      lvp_queue_finish(queue);
+   }
+
    lvp_queue_finish(&device->queue);
    vk_device_finish(&device->vk);
    vk_free(&device->vk.alloc, device);
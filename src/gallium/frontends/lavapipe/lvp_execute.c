@@ -57,6 +57,9 @@
 
 #define DOUBLE_EQ(a, b) (fabs((a) - (b)) < DBL_EPSILON)
 
+/* Upper bound on the descriptor sets a queue keeps between replays */
+#define LVP_MAX_CACHED_DESC_SETS 1024
+
 enum gs_output {
   GS_OUTPUT_NONE,
   GS_OUTPUT_NOT_LINES,
@@ -90,6 +93,7 @@ struct lvp_conditional_rendering_state {
 struct rendering_state {
    struct pipe_context *pctx;
    struct lvp_device *device;
+   struct lvp_queue *queue;
    struct u_upload_mgr *uploader;
    struct cso_context *cso;
 
@@ -1156,6 +1160,32 @@ static void handle_set_stage(struct rendering_state *state,
    handle_set_stage_buffer(state, set->bo, 0, stage, index);
 }
 
+/* Descriptor sets which only live until the end of the replay.  They are
+ * recycled through the queue's cache, replaying the same command buffers
+ * over and over would otherwise allocate and free them every time.
+ */
+static struct lvp_descriptor_set *
+create_temp_set(struct rendering_state *state,
+                struct lvp_descriptor_set_layout *layout)
+{
+   struct lvp_queue *queue = state->queue;
+   struct lvp_descriptor_set *set = NULL;
+
+   struct hash_entry *entry = _mesa_hash_table_search(queue->desc_set_cache, layout);
+   struct util_dynarray *cached = entry ? entry->data : NULL;
+   if (cached && util_dynarray_contains(cached, struct lvp_descriptor_set *)) {
+      set = util_dynarray_pop(cached, struct lvp_descriptor_set *);
+      queue->num_cached_desc_sets--;
+      lvp_descriptor_set_reset(set);
+   } else {
+      lvp_descriptor_set_create(state->device, layout, &set);
+   }
+
+   util_dynarray_append(&state->push_desc_sets, set);
+
+   return set;
+}
+
 static void
 apply_dynamic_offsets(struct lvp_descriptor_set **out_set, const uint32_t *offsets, uint32_t offset_count,
                       struct rendering_state *state)
@@ -1165,10 +1195,7 @@ apply_dynamic_offsets(struct lvp_descriptor_set **out_set, const uint32_t *offse
 
    struct lvp_descriptor_set *in_set = *out_set;
 
-   struct lvp_descriptor_set *set;
-   lvp_descriptor_set_create(state->device, in_set->layout, &set);
-
-   util_dynarray_append(&state->push_desc_sets, set);
+   struct lvp_descriptor_set *set = create_temp_set(state, in_set->layout);
 
    memcpy(set->map, in_set->map, in_set->bo->width0);
 
@@ -3266,10 +3293,7 @@ static void handle_push_descriptor_set(struct vk_cmd_queue_entry *cmd,
    VK_FROM_HANDLE(lvp_pipeline_layout, layout, pds->layout);
    struct lvp_descriptor_set_layout *set_layout = (struct lvp_descriptor_set_layout *)layout->vk.set_layouts[pds->set];
 
-   struct lvp_descriptor_set *set;
-   lvp_descriptor_set_create(state->device, set_layout, &set);
-
-   util_dynarray_append(&state->push_desc_sets, set);
+   struct lvp_descriptor_set *set = create_temp_set(state, set_layout);
 
    uint32_t types = lvp_pipeline_types_from_shader_stages(pds->stageFlags);
    u_foreach_bit(pipeline_type, types) {
@@ -3304,10 +3328,7 @@ static void handle_push_descriptor_set_with_template(struct vk_cmd_queue_entry *
    VK_FROM_HANDLE(lvp_pipeline_layout, layout, pds->layout);
    struct lvp_descriptor_set_layout *set_layout = (struct lvp_descriptor_set_layout *)layout->vk.set_layouts[pds->set];
 
-   struct lvp_descriptor_set *set;
-   lvp_descriptor_set_create(state->device, set_layout, &set);
-
-   util_dynarray_append(&state->push_desc_sets, set);
+   struct lvp_descriptor_set *set = create_temp_set(state, set_layout);
 
    struct lvp_descriptor_set *base = state->desc_sets[lvp_pipeline_type_from_bind_point(templ->bind_point)][pds->set];
    if (base)
@@ -5387,6 +5408,7 @@ VkResult lvp_execute_cmds(struct lvp_device *device,
    memset(state, 0, sizeof(*state));
    state->pctx = queue->ctx;
    state->device = device;
+   state->queue = queue;
    state->uploader = queue->uploader;
    state->cso = queue->cso;
    state->blend_dirty = true;
@@ -5434,10 +5456,36 @@ VkResult lvp_execute_cmds(struct lvp_device *device,
       }
    }
 
+   return VK_SUCCESS;
+}
+
+/* Waits for the commands replayed by lvp_execute_cmds() to complete and
+ * releases what they kept alive.  This only touches the queue's own state
+ * and can run without holding the device's queue lock.
+ */
+void
+lvp_finish_cmds(struct lvp_device *device, struct lvp_queue *queue)
+{
+   struct rendering_state *state = queue->state;
+
    finish_fence(state);
 
-   util_dynarray_foreach (&state->push_desc_sets, struct lvp_descriptor_set *, set)
-      lvp_descriptor_set_destroy(device, *set);
+   util_dynarray_foreach (&state->push_desc_sets, struct lvp_descriptor_set *, set) {
+      if (queue->num_cached_desc_sets >= LVP_MAX_CACHED_DESC_SETS) {
+         lvp_descriptor_set_destroy(device, *set);
+         continue;
+      }
+
+      struct hash_entry *entry =
+         _mesa_hash_table_search(queue->desc_set_cache, (*set)->layout);
+      if (!entry) {
+         struct util_dynarray *sets = rzalloc(queue->desc_set_cache, struct util_dynarray);
+         util_dynarray_init(sets, queue->desc_set_cache);
+         entry = _mesa_hash_table_insert(queue->desc_set_cache, (*set)->layout, sets);
+      }
+      util_dynarray_append((struct util_dynarray *)entry->data, *set);
+      queue->num_cached_desc_sets++;
+   }
 
    struct pipe_resource **pres = state->releasebufs.data;
    unsigned count = util_dynarray_num_elements(&state->releasebufs, struct pipe_resource*);
@@ -5449,8 +5497,6 @@ VkResult lvp_execute_cmds(struct lvp_device *device,
 
    for (unsigned i = 0; i < ARRAY_SIZE(state->desc_buffers); i++)
       pipe_resource_reference(&state->desc_buffers[i], NULL);
-
-   return VK_SUCCESS;
 }
 
 size_t
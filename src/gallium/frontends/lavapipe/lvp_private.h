@@ -96,7 +96,7 @@ typedef uint32_t xcb_window_t;
 extern "C" {
 #endif
 
-#define LVP_NUM_QUEUES 1
+#define LVP_NUM_QUEUES 4
 #define MAX_SETS 8
 #define MAX_DESCRIPTORS 1000000 /* Required by vkd3d-proton */
 #define MAX_PUSH_CONSTANTS_SIZE 256
@@ -189,6 +189,12 @@ struct lvp_queue {
    void *state;
    struct util_dynarray pipeline_destroys;
    simple_mtx_t lock;
+
+   /* Descriptor sets created for a single replay and kept for the next one,
+    * maps a set layout to a util_dynarray of sets.
+    */
+   struct hash_table *desc_set_cache;
+   unsigned num_cached_desc_sets;
 };
 
 static inline struct lvp_device *
@@ -205,7 +211,12 @@ struct lvp_pipeline_cache {
 struct lvp_device {
    struct vk_device vk;
 
+   /* The context of the first queue also creates and destroys the objects
+    * shared by all queues, and its lock serializes their use.
+    */
    struct lvp_queue queue;
+   struct lvp_queue extra_queues[LVP_NUM_QUEUES - 1];
+   uint32_t num_extra_queues;
    struct pipe_screen *pscreen;
    void *noop_fs;
    simple_mtx_t bda_lock;
@@ -390,6 +401,9 @@ lvp_descriptor_set_create(struct lvp_device *device,
                           struct lvp_descriptor_set_layout *layout,
                           struct lvp_descriptor_set **out_set);
 
+void
+lvp_descriptor_set_reset(struct lvp_descriptor_set *set);
+
 void
 lvp_descriptor_set_destroy(struct lvp_device *device,
                            struct lvp_descriptor_set *set);
@@ -722,6 +736,7 @@ VkResult lvp_image_bind_sparse(struct lvp_device *device,
 VkResult lvp_execute_cmds(struct lvp_device *device,
                           struct lvp_queue *queue,
                           struct lvp_cmd_buffer *cmd_buffer);
+void lvp_finish_cmds(struct lvp_device *device, struct lvp_queue *queue);
 size_t
 lvp_get_rendering_state_size(void);
 
@@ -201,6 +201,42 @@ impl Context {
         Ok(res)
     }
 
+    /// Wraps the pages `user_ptr` points into in a user memory buffer on every device, because
+    /// drivers only accept page aligned pointers. Returns the buffers together with the offset of
+    /// `user_ptr` inside of them, or `None` if any device can't import the memory. In that case
+    /// [Self::create_buffer] has to be used, which copies from and to `user_ptr`.
+    pub fn create_buffer_from_user_pages(
+        &self,
+        size: usize,
+        user_ptr: *mut c_void,
+        bda: bool,
+    ) -> Option<(HashMap<&'static Device, PipeResourceOwned>, usize)> {
+        let offset = user_ptr as usize % util::page_size();
+        let adj_size: u32 = (size + offset).try_into().ok()?;
+        let base = user_ptr.wrapping_byte_sub(offset);
+        let pipe_flags = if bda {
+            PIPE_RESOURCE_FLAG_FIXED_ADDRESS
+        } else {
+            0
+        };
+
+        let res = self
+            .devs
+            .iter()
+            .map(|&dev| {
+                let res = dev.screen().resource_create_buffer_from_user(
+                    adj_size,
+                    base,
+                    PIPE_BIND_GLOBAL,
+                    pipe_flags,
+                )?;
+                Some((dev, res))
+            })
+            .collect::<Option<_>>()?;
+
+        Some((res, offset))
+    }
+
     pub fn create_texture(
         &self,
         desc: &cl_image_desc,
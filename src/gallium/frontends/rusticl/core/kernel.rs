@@ -619,6 +619,9 @@ fn opt_nir(nir: &mut NirShader, dev: &Device, has_explicit_types: bool) {
     while {
         let mut progress = false;
 
+        // libclc functions often aren't inlined, so run the function local
+        // passes on all functions at once.
+        progress |= nir_pass!(nir, nir_opt_functions_parallel);
         progress |= nir_pass!(nir, nir_opt_copy_prop);
         progress |= nir_pass!(nir, nir_opt_copy_prop_vars);
         progress |= nir_pass!(nir, nir_opt_dead_write_vars);
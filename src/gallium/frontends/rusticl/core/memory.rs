@@ -19,6 +19,7 @@ use mesa_rust::pipe::context::*;
 use mesa_rust::pipe::resource::*;
 use mesa_rust::pipe::screen::ResourceType;
 use mesa_rust::pipe::transfer::*;
+use mesa_rust::util;
 use mesa_rust_gen::*;
 use mesa_rust_util::conversion::*;
 use mesa_rust_util::properties::Properties;
@@ -837,10 +838,20 @@ impl MemBase {
             .then(|| context.get_svm_alloc(host_ptr as usize))
             .flatten();
 
+        // Drivers can only import page aligned host memory. For other pointers we import all
+        // pages the buffer touches instead, so that the memory is still shared without copies.
+        let user_pages = (svm.is_none()
+            && bit_check(flags, CL_MEM_USE_HOST_PTR)
+            && host_ptr as usize % util::page_size() != 0)
+            .then(|| context.create_buffer_from_user_pages(size, host_ptr, bda))
+            .flatten();
+
         let alloc = if let Some((svm_ptr, ref svm_alloc)) = svm {
             // SAFETY: svm_ptr is the base of the allocation host_ptr points into.
             let offset = unsafe { host_ptr.byte_offset_from(svm_ptr) } as usize;
             Allocation::new_svm(Arc::clone(svm_alloc), offset)
+        } else if let Some((buffer, offset)) = user_pages {
+            Allocation::new(buffer, offset, host_ptr.wrapping_byte_sub(offset))
         } else {
             let res_type = if bit_check(flags, CL_MEM_ALLOC_HOST_PTR) {
                 ResourceType::Staging
@@ -876,7 +887,8 @@ impl MemBase {
                     let address = if let Some((address, _)) = svm {
                         NonZeroU64::new(address as usize as u64)
                     } else if let Some(res) = alloc.get_res_of_dev(dev) {
-                        res.resource_get_address()
+                        res.resource_get_address()?
+                            .checked_add(alloc.offset() as u64)
                     } else {
                         // if there is no resource, it's a system SVM allocation
                         assert!(dev.system_svm_supported());
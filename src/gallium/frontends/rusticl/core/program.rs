@@ -26,6 +26,7 @@ use std::sync::Arc;
 use std::sync::Mutex;
 use std::sync::MutexGuard;
 use std::sync::Once;
+use std::thread;
 
 // 8 bytes so we don't have any padding.
 const BIN_RUSTICL_MAGIC_STRING: &[u8; 8] = b"rusticl\0";
@@ -118,35 +119,76 @@ impl ProgramBuild {
 
         self.kernels = kernels;
 
-        for kernel_name in &self.kernels {
-            let kernel_args: HashSet<_> = devs
+        let kernel_args: Vec<_> = self
+            .kernels
+            .iter()
+            .map(|kernel_name| {
+                let kernel_args: HashSet<_> = devs
+                    .iter()
+                    .filter_map(|d| self.args(d, kernel_name))
+                    .collect();
+
+                kernel_args.into_iter().next().unwrap()
+            })
+            .collect();
+
+        let builds: Vec<_> = devs
+            .iter()
+            .filter_map(|&dev| {
+                let build = self.builds_by_device.get(dev)?;
+                build.is_success().then_some((dev, build))
+            })
+            .collect();
+
+        let build_device = |&(dev, build): &(&'static Device, &DeviceProgramBuild)| {
+            self.kernels
                 .iter()
-                .filter_map(|d| self.args(d, kernel_name))
-                .collect();
+                .zip(&kernel_args)
+                .map(|(kernel_name, args)| {
+                    convert_spirv_to_nir(build, kernel_name, args, &self.spec_constants, dev)
+                })
+                .collect::<Vec<_>>()
+        };
+
+        // Devices don't share any compiler state, so each of them builds all the kernels on its
+        // own thread.
+        let results: Vec<_> = if builds.len() > 1 {
+            thread::scope(|s| {
+                let handles: Vec<_> = builds
+                    .iter()
+                    .map(|build| s.spawn(|| build_device(build)))
+                    .collect();
 
-            let args = kernel_args.into_iter().next().unwrap();
-            let mut kernel_info_set = HashSet::new();
+                handles
+                    .into_iter()
+                    .map(|handle| handle.join().unwrap())
+                    .collect()
+            })
+        } else {
+            builds.iter().map(build_device).collect()
+        };
 
-            // TODO: we could run this in parallel?
-            for dev in devs {
-                let Some(build) = self.builds_by_device.get_mut(dev) else {
-                    continue;
-                };
+        let built_devs: Vec<_> = builds.iter().map(|&(dev, _)| dev).collect();
+        let mut kernel_info_sets: Vec<_> = self.kernels.iter().map(|_| HashSet::new()).collect();
 
-                if !build.is_success() {
-                    continue;
-                }
+        for (dev, dev_results) in built_devs.into_iter().zip(results) {
+            let build = self.builds_by_device.get_mut(dev).unwrap();
 
-                let build_result =
-                    convert_spirv_to_nir(build, kernel_name, &args, &self.spec_constants, dev);
+            for ((kernel_name, build_result), kernel_info_set) in self
+                .kernels
+                .iter()
+                .zip(dev_results)
+                .zip(&mut kernel_info_sets)
+            {
                 kernel_info_set.insert(build_result.kernel_info);
-
-                self.builds_by_device.get_mut(dev).unwrap().kernels.insert(
+                build.kernels.insert(
                     kernel_name.clone(),
                     Arc::new(build_result.nir_kernel_builds),
                 );
             }
+        }
 
+        for (kernel_name, kernel_info_set) in self.kernels.iter().zip(kernel_info_sets) {
             // we want the same (internal) args for every compiled kernel, for now
             assert_eq!(kernel_info_set.len(), 1);
             let mut kernel_info = kernel_info_set.into_iter().next().unwrap();
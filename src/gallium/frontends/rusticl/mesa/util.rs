@@ -1,6 +1,7 @@
 // Copyright 2022 Red Hat.
 // SPDX-License-Identifier: MIT
 
+use mesa_rust_gen::os_get_page_size;
 use mesa_rust_gen::util_get_cpu_caps;
 
 pub mod disk_cache;
@@ -15,3 +16,15 @@ pub fn cpu_count() -> u32 {
 
     caps.nr_cpus as u32
 }
+
+/// Gets the page size of the system.
+pub fn page_size() -> usize {
+    let mut size = 0;
+
+    // SAFETY: `os_get_page_size()` only writes to `size`.
+    if unsafe { os_get_page_size(&mut size) } {
+        size as usize
+    } else {
+        4096
+    }
+}
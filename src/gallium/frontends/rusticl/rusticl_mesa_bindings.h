@@ -24,6 +24,7 @@
 #include "util/blob.h"
 #include "util/disk_cache.h"
 #include "util/hex.h"
+#include "util/os_misc.h"
 #include "util/os_time.h"
 #include "util/sha1/sha1.h"
 #include "util/u_cpu_detect.h"
@@ -54,6 +54,11 @@ if __name__ == '__main__':
       help='input standard deviation')
   parser.add_argument(
       '--num_threads', default=None, type=int, help='number of threads')
+  parser.add_argument(
+      '-n',
+      '--num_iterations',
+      default=4, type=int,
+      help='number of timed invocations')
   parser.add_argument(
       '-e', '--ext_delegate', help='external_delegate_library path')
   parser.add_argument(
@@ -112,14 +117,16 @@ if __name__ == '__main__':
 
   interpreter.set_tensor(input_details[0]['index'], input_data)
 
+  # The first invocation includes the lazy setup done by the delegate.
+  start_time = time.perf_counter()
   interpreter.invoke()
+  first_latency = (time.perf_counter() - start_time) * 1000
 
-  num_iterations = 4
-
-  start_time = time.time()
-  for i in range(0, num_iterations):
+  latencies = []
+  for i in range(0, args.num_iterations):
+    start_time = time.perf_counter()
     interpreter.invoke()
-  stop_time = time.time()
+    latencies.append((time.perf_counter() - start_time) * 1000)
 
   output_data = interpreter.get_tensor(output_details[0]['index'])
   results = np.squeeze(output_data)
@@ -132,4 +139,8 @@ if __name__ == '__main__':
     else:
       print('{:08.6f}: {}'.format(float(results[i] / 255.0), labels[i]))
 
-  print('time: {:.3f}ms'.format((stop_time - start_time) * 1000 / num_iterations))
+  print('first: {:.3f}ms'.format(first_latency))
+  if latencies:
+    print('time: {:.3f}ms (min {:.3f}ms, median {:.3f}ms, max {:.3f}ms)'.format(
+        np.mean(latencies), np.min(latencies), np.median(latencies),
+        np.max(latencies)))
@@ -56,8 +56,29 @@ struct teflon_subgraph {
 
    unsigned *output_tensors;
    unsigned output_count;
+
+   /* Scratch space for the tensor buffers passed to the driver on each invoke,
+    * sized for the larger of the input and output lists.
+    */
+   void **buffers;
+   bool *input_is_signed;
+   bool *output_is_signed;
 };
 
+static bool
+tensor_type_is_signed(TfLiteType type)
+{
+   switch (type) {
+   case kTfLiteInt8:
+   case kTfLiteInt16:
+   case kTfLiteInt32:
+   case kTfLiteInt64:
+      return true;
+   default:
+      return false;
+   }
+}
+
 static struct pipe_resource *
 create_resource(struct pipe_context *context, TfLiteTensor tensor)
 {
@@ -311,15 +332,11 @@ all_zero_points_equal(const TfLiteAffineQuantization *quant)
 static void
 fill_tensor(struct teflon_delegate *delegate, TfLiteContext *tf_context, struct pipe_tensor *tensor, unsigned index)
 {
-   struct pipe_context *context = delegate->context;
    TfLiteTensor tf_tensor = tf_context->tensors[index];
 
    if (tf_tensor.type == kTfLiteNoType)
       return; /* Placeholder tensor */
 
-   if (tf_tensor.data.data)
-      tensor->resource = create_resource(context, tf_tensor);
-
    tensor->index = index;
    for (int out_dim = 0; out_dim < 4; out_dim++) {
       int in_dim = tf_tensor.dims->size - 4 + out_dim;
@@ -345,15 +362,28 @@ fill_tensor(struct teflon_delegate *delegate, TfLiteContext *tf_context, struct
       }
    }
 
-   switch (tf_tensor.type) {
-   case kTfLiteInt8:
-   case kTfLiteInt16:
-   case kTfLiteInt32:
-   case kTfLiteInt64:
-      tensor->is_signed = true;
-      break;
-   default:
-      tensor->is_signed = false;
+   tensor->is_signed = tensor_type_is_signed(tf_tensor.type);
+}
+
+/* Constant tensors are only uploaded once a node consuming them is looked at,
+ * so that weights of the operations left to the CPU don't take up device
+ * memory.
+ */
+static void
+fill_constant_tensors(struct teflon_delegate *delegate, TfLiteContext *tf_context, TfLiteNode *node)
+{
+   for (int i = 0; i < node->inputs->size; i++) {
+      int index = node->inputs->data[i];
+      if (index < 0)
+         continue;
+
+      TfLiteTensor tf_tensor = tf_context->tensors[index];
+      struct pipe_tensor *tensor = &delegate->tensors[index];
+
+      if (tf_tensor.type == kTfLiteNoType || !tf_tensor.data.data || tensor->resource)
+         continue;
+
+      tensor->resource = create_resource(delegate->context, tf_tensor);
    }
 }
 
@@ -514,6 +544,16 @@ partition_init(TfLiteContext *tf_context, const char *buffer, size_t length)
    memcpy(tsubgraph->output_tensors, params->output_tensors->data,
           params->output_tensors->size * sizeof(*tsubgraph->output_tensors));
 
+   tsubgraph->buffers = malloc(MAX2(tsubgraph->input_count, tsubgraph->output_count) * sizeof(*tsubgraph->buffers));
+
+   tsubgraph->input_is_signed = malloc(tsubgraph->input_count * sizeof(*tsubgraph->input_is_signed));
+   for (unsigned i = 0; i < tsubgraph->input_count; i++)
+      tsubgraph->input_is_signed[i] = tensor_type_is_signed(tf_context->tensors[tsubgraph->input_tensors[i]].type);
+
+   tsubgraph->output_is_signed = malloc(tsubgraph->output_count * sizeof(*tsubgraph->output_is_signed));
+   for (unsigned i = 0; i < tsubgraph->output_count; i++)
+      tsubgraph->output_is_signed[i] = tensor_type_is_signed(tf_context->tensors[tsubgraph->output_tensors[i]].type);
+
    if (unlikely(debug_get_option_debug_teflon() & TEFLON_DEBUG_VERBOSE)) {
       struct timespec time;
       clock_gettime(CLOCK_MONOTONIC, &time);
@@ -547,6 +587,9 @@ partition_free(TfLiteContext *tf_context, void *buffer)
    context->ml_subgraph_destroy(context, subgraph);
    free(tsubgraph->input_tensors);
    free(tsubgraph->output_tensors);
+   free(tsubgraph->buffers);
+   free(tsubgraph->input_is_signed);
+   free(tsubgraph->output_is_signed);
    free(tsubgraph);
 }
 
@@ -565,35 +608,17 @@ partition_invoke(TfLiteContext *tf_context, TfLiteNode *node)
       start = (long)time.tv_sec * 1000 + (long)time.tv_nsec / 1000000;
    }
 
-   void **buffers = malloc(tsubgraph->input_count * sizeof(*buffers));
-   bool *is_signed = malloc(tsubgraph->input_count * sizeof(*is_signed));
-   for (unsigned i = 0; i < tsubgraph->input_count; i++) {
-      TfLiteTensor tf_tensor = tf_context->tensors[tsubgraph->input_tensors[i]];
+   /* The interpreter may move the tensor data between invocations, so only
+    * the pointers are refreshed here.
+    */
+   void **buffers = tsubgraph->buffers;
+   for (unsigned i = 0; i < tsubgraph->input_count; i++)
+      buffers[i] = tf_context->tensors[tsubgraph->input_tensors[i]].data.data;
+   context->ml_subgraph_invoke(context, subgraph, tsubgraph->input_count, tsubgraph->input_tensors, buffers, tsubgraph->input_is_signed);
 
-      buffers[i] = tf_tensor.data.data;
-      is_signed[i] = tf_tensor.type == kTfLiteInt8 ||
-                     tf_tensor.type == kTfLiteInt16 ||
-                     tf_tensor.type == kTfLiteInt32 ||
-                     tf_tensor.type == kTfLiteInt64;
-   }
-   context->ml_subgraph_invoke(context, subgraph, tsubgraph->input_count, tsubgraph->input_tensors, buffers, is_signed);
-   free(buffers);
-   free(is_signed);
-
-   buffers = malloc(tsubgraph->output_count * sizeof(*buffers));
-   is_signed = malloc(tsubgraph->output_count * sizeof(*is_signed));
-   for (unsigned i = 0; i < tsubgraph->output_count; i++) {
-      TfLiteTensor tf_tensor = tf_context->tensors[tsubgraph->output_tensors[i]];
-
-      buffers[i] = tf_tensor.data.data;
-      is_signed[i] = tf_tensor.type == kTfLiteInt8 ||
-                     tf_tensor.type == kTfLiteInt16 ||
-                     tf_tensor.type == kTfLiteInt32 ||
-                     tf_tensor.type == kTfLiteInt64;
-   }
-   context->ml_subgraph_read_output(context, subgraph, tsubgraph->output_count, tsubgraph->output_tensors, buffers, is_signed);
-   free(buffers);
-   free(is_signed);
+   for (unsigned i = 0; i < tsubgraph->output_count; i++)
+      buffers[i] = tf_context->tensors[tsubgraph->output_tensors[i]].data.data;
+   context->ml_subgraph_read_output(context, subgraph, tsubgraph->output_count, tsubgraph->output_tensors, buffers, tsubgraph->output_is_signed);
 
    if (unlikely(debug_get_option_debug_teflon() & TEFLON_DEBUG_VERBOSE)) {
       struct timespec time;
@@ -753,6 +778,7 @@ PrepareDelegate(TfLiteContext *tf_context, TfLiteDelegate *tf_delegate)
    TF_LITE_ENSURE_STATUS(tf_context->GetExecutionPlan(tf_context, &plan));
 
    delegate->tensors = calloc(tf_context->tensors_size, sizeof(*delegate->tensors));
+   delegate->tensor_count = tf_context->tensors_size;
 
    for (int i = 0; i < tf_context->tensors_size; i++)
       fill_tensor(delegate, tf_context, &delegate->tensors[i], i);
@@ -771,6 +797,7 @@ PrepareDelegate(TfLiteContext *tf_context, TfLiteDelegate *tf_delegate)
       TF_LITE_ENSURE_STATUS(tf_context->GetNodeAndRegistration(
          tf_context, node_index, &node, &registration));
 
+      fill_constant_tensors(delegate, tf_context, node);
       supported = check_op_support(tf_delegate, tf_context, node, registration);
 
       teflon_debug("%3d %-15s v%-2d %-11s in:", node_index,
@@ -813,6 +840,23 @@ PrepareDelegate(TfLiteContext *tf_context, TfLiteDelegate *tf_delegate)
    }
    supported_nodes->size = node_count;
 
+   /* Drop the constant tensors that only unsupported nodes consume. */
+   bool *tensor_used = calloc(tf_context->tensors_size, sizeof(*tensor_used));
+   for (unsigned i = 0; i < node_count; i++) {
+      TfLiteRegistration *registration;
+      TF_LITE_ENSURE_STATUS(tf_context->GetNodeAndRegistration(
+         tf_context, supported_nodes->data[i], &node, &registration));
+      for (int j = 0; j < node->inputs->size; j++) {
+         if (node->inputs->data[j] >= 0)
+            tensor_used[node->inputs->data[j]] = true;
+      }
+   }
+   for (int i = 0; i < tf_context->tensors_size; i++) {
+      if (!tensor_used[i])
+         pipe_resource_reference(&delegate->tensors[i].resource, NULL);
+   }
+   free(tensor_used);
+
    TfLiteRegistration registration;
 
    registration.init = partition_init;
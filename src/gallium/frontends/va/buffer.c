@@ -145,6 +145,26 @@ VAStatus vlVaMapBuffer2(VADriverContextP ctx, VABufferID buf_id,
       return VA_STATUS_ERROR_INVALID_BUFFER;
    }
 
+   /* Wait for the encode without holding the driver lock, so that frames
+    * of other contexts can be submitted while this one is retrieved.
+    */
+   if (buf->type == VAEncCodedBufferType && buf->feedback && buf->fence &&
+       buf->ctx && buf->ctx->decoder) {
+      vlVaContext *context = buf->ctx;
+
+      mtx_lock(&context->mutex);
+      mtx_unlock(&drv->mutex);
+      context->decoder->fence_wait(context->decoder, buf->fence, VA_TIMEOUT_INFINITE);
+      mtx_unlock(&context->mutex);
+
+      mtx_lock(&drv->mutex);
+      buf = handle_table_get(drv->htab, buf_id);
+      if (!buf || buf->export_refcount > 0) {
+         mtx_unlock(&drv->mutex);
+         return VA_STATUS_ERROR_INVALID_BUFFER;
+      }
+   }
+
    if (buf->type == VAEncCodedBufferType)
       vlVaGetBufferFeedback(buf);
 
@@ -190,6 +190,7 @@ struct st_config_options
    bool vs_position_always_invariant;
    bool vs_position_always_precise;
    bool force_glsl_abs_sqrt;
+   bool glsl_es_skip_ir_optimizations;
    bool allow_glsl_cross_stage_interpolation_mismatch;
    bool do_dce_before_clip_cull_analysis;
    bool allow_draw_out_of_order;
@@ -51,6 +51,7 @@ extern "C" {
 
 
 /** Opaque types */
+struct blob;
 struct winsys_handle;
 struct pipe_fence_handle;
 struct pipe_resource;
@@ -584,6 +585,23 @@ struct pipe_screen {
                                                    void *shader,
                                                    mesa_shader_stage shader_type);
 
+   /**
+    * Append the compiled code of a shader CSO to \p blob in a driver-defined
+    * format, so that it can be embedded in GL program binaries. This waits
+    * for the shader to be compiled. Nothing is appended if the code isn't
+    * available.
+    */
+   void (*get_shader_binary)(struct pipe_screen *screen, void *shader,
+                             mesa_shader_stage shader_type, struct blob *blob);
+
+   /**
+    * Make code returned by get_shader_binary available to shaders created
+    * afterwards, so that they don't have to be compiled. Invalid data must
+    * be ignored.
+    */
+   void (*add_shader_binary)(struct pipe_screen *screen,
+                             const void *data, size_t size);
+
    void (*driver_thread_add_job)(struct pipe_screen *screen,
                                  void *job,
                                  struct util_queue_fence *fence,
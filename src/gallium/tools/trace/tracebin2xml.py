@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+# Copyright 2024 Mesa contributors
+# SPDX-License-Identifier: MIT
+#
+# Converts a trace written with GALLIUM_TRACE_FORMAT=binary to the XML
+# format the other tools in this directory read.  The op values must be kept
+# in sync with src/gallium/auxiliary/driver_trace/tr_dump.c.
+
+import argparse
+import struct
+import sys
+
+
+MAGIC = b'GTRCBIN1'
+RECORD = struct.Struct('<B3xIQ')
+
+(
+    CALL_BEGIN,
+    CALL_END,
+    ARG_BEGIN,
+    ARG_END,
+    RET_BEGIN,
+    RET_END,
+    BOOL,
+    INT,
+    UINT,
+    FLOAT,
+    BYTES,
+    STRING,
+    ENUM,
+    ARRAY_BEGIN,
+    ARRAY_END,
+    ELEM_BEGIN,
+    ELEM_END,
+    STRUCT_BEGIN,
+    STRUCT_END,
+    MEMBER_BEGIN,
+    MEMBER_END,
+    NULL,
+    PTR,
+    NIR,
+) = range(1, 25)
+
+
+def escape(data):
+    out = []
+    for c in data:
+        if c == 0x3c:
+            out.append('&lt;')
+        elif c == 0x3e:
+            out.append('&gt;')
+        elif c == 0x26:
+            out.append('&amp;')
+        elif c == 0x27:
+            out.append('&apos;')
+        elif c == 0x22:
+            out.append('&quot;')
+        elif 0x20 <= c <= 0x7e:
+            out.append(chr(c))
+        else:
+            out.append('&#%u;' % c)
+    return ''.join(out).encode('ascii')
+
+
+def signed64(value):
+    return value - (1 << 64) if value & (1 << 63) else value
+
+
+def records(data):
+    if not data.startswith(MAGIC):
+        raise ValueError('not a binary gallium trace')
+    offset = len(MAGIC)
+    while offset + RECORD.size <= len(data):
+        op, size, value = RECORD.unpack_from(data, offset)
+        offset += RECORD.size
+        payload = data[offset:offset + size]
+        if len(payload) != size:
+            break
+        offset += (size + 7) & ~7
+        yield op, value, payload
+
+
+def convert(data, out):
+    out.write(b"<?xml version='1.0' encoding='UTF-8'?>\n")
+    out.write(b"<?xml-stylesheet type='text/xsl' href='trace.xsl'?>\n")
+    out.write(b"<trace version='0.1'>\n")
+
+    for op, value, payload in records(data):
+        if op == CALL_BEGIN:
+            klass, method = payload.split(b'\0')[:2]
+            out.write(b"\t<call no='%u' class='%s' method='%s'>\n" %
+                      (value, escape(klass), escape(method)))
+        elif op == CALL_END:
+            out.write(b'\t\t<time><int>%d</int></time>\n' % signed64(value))
+            out.write(b'\t</call>\n')
+        elif op == ARG_BEGIN:
+            out.write(b"\t\t<arg name='%s'>" % escape(payload))
+        elif op == ARG_END:
+            out.write(b'</arg>\n')
+        elif op == RET_BEGIN:
+            out.write(b'\t\t<ret>')
+        elif op == RET_END:
+            out.write(b'</ret>\n')
+        elif op == BOOL:
+            out.write(b'<bool>%c</bool>' % (b'1' if value else b'0'))
+        elif op == INT:
+            out.write(b'<int>%d</int>' % signed64(value))
+        elif op == UINT:
+            out.write(b'<uint>%u</uint>' % value)
+        elif op == FLOAT:
+            f, = struct.unpack('<d', struct.pack('<Q', value))
+            out.write(b'<float>%s</float>' % ('%g' % f).encode('ascii'))
+        elif op == BYTES:
+            out.write(b'<bytes>%s</bytes>' % payload.hex().upper().encode('ascii'))
+        elif op == STRING:
+            out.write(b'<string>%s</string>' % escape(payload))
+        elif op == ENUM:
+            out.write(b'<enum>%s</enum>' % escape(payload))
+        elif op == ARRAY_BEGIN:
+            out.write(b'<array>')
+        elif op == ARRAY_END:
+            out.write(b'</array>')
+        elif op == ELEM_BEGIN:
+            out.write(b'<elem>')
+        elif op == ELEM_END:
+            out.write(b'</elem>')
+        elif op == STRUCT_BEGIN:
+            out.write(b"<struct name='%s'>" % payload)
+        elif op == STRUCT_END:
+            out.write(b'</struct>')
+        elif op == MEMBER_BEGIN:
+            out.write(b"<member name='%s'>" % payload)
+        elif op == MEMBER_END:
+            out.write(b'</member>')
+        elif op == NULL:
+            out.write(b'<null/>')
+        elif op == PTR:
+            out.write(b'<ptr>0x%08x</ptr>' % value)
+        elif op == NIR:
+            if value:
+                out.write(b'<string>...</string>')
+            else:
+                out.write(b'<string><![CDATA[%s]]></string>' % payload)
+        else:
+            raise ValueError('unknown trace record %u' % op)
+
+    out.write(b'</trace>\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a binary gallium trace to XML')
+    parser.add_argument('input', help='binary trace file')
+    parser.add_argument('output', nargs='?', help='XML trace file, stdout by default')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    if args.output:
+        with open(args.output, 'wb') as out:
+            convert(data, out)
+    else:
+        convert(data, sys.stdout.buffer)
+
+
+if __name__ == '__main__':
+    main()
@@ -496,6 +496,7 @@ amdgpu_winsys_create(int fd, const struct pipe_screen_config *config,
                     /* Cast to void* because one of the function parameters
                      * is a struct pointer instead of void*. */
                     (void*)amdgpu_bo_destroy, (void*)amdgpu_bo_can_reclaim);
+      pb_cache_start_trim_thread(&aws->bo_cache);
 
       if (!pb_slabs_init(&aws->bo_slabs,
                          8,  /* min slab entry size: 256 bytes */
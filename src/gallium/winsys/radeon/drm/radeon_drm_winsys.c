@@ -959,6 +959,7 @@ radeon_drm_winsys_create(int fd, const struct pipe_screen_config *config,
                  NULL,
                  radeon_bo_destroy,
                  radeon_bo_can_reclaim);
+   pb_cache_start_trim_thread(&ws->bo_cache);
 
    if (ws->info.r600_has_virtual_memory) {
       /* There is no fundamental obstacle to using slab buffer allocation
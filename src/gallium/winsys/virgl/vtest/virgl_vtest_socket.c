@@ -29,6 +29,7 @@
 #include <unistd.h>
 
 #include <util/format/u_format.h>
+#include <util/u_debug.h>
 #include <util/u_process.h>
 
 #include "virgl_vtest_winsys.h"
@@ -381,6 +382,41 @@ uint32_t virgl_vtest_send_resource_create(struct virgl_vtest_winsys *vws,
    return handle;
 }
 
+static void virgl_vtest_create_cmd_ring(struct virgl_vtest_winsys *vws)
+{
+   uint32_t vtest_hdr[VTEST_HDR_SIZE];
+   uint32_t cmd[VCMD_CMD_RING_CREATE_SIZE];
+   uint32_t result;
+   int ring_fd, doorbell_fd;
+
+   vtest_hdr[VTEST_CMD_LEN] = VCMD_CMD_RING_CREATE_SIZE;
+   vtest_hdr[VTEST_CMD_ID] = VCMD_CMD_RING_CREATE;
+   cmd[VCMD_CMD_RING_CREATE_BUFFER_SIZE] = VTEST_RING_BUFFER_SIZE;
+
+   virgl_block_write(vws->sock_fd, &vtest_hdr, sizeof(vtest_hdr));
+   virgl_block_write(vws->sock_fd, &cmd, sizeof(cmd));
+
+   virgl_block_read(vws->sock_fd, vtest_hdr, sizeof(vtest_hdr));
+   assert(vtest_hdr[VTEST_CMD_ID] == VCMD_CMD_RING_CREATE);
+   virgl_block_read(vws->sock_fd, &result, sizeof(result));
+   if (result)
+      return;
+
+   ring_fd = virgl_vtest_receive_fd(vws->sock_fd);
+   doorbell_fd = virgl_vtest_receive_fd(vws->sock_fd);
+   if (ring_fd < 0 || doorbell_fd < 0) {
+      if (ring_fd >= 0)
+         close(ring_fd);
+      if (doorbell_fd >= 0)
+         close(doorbell_fd);
+      return;
+   }
+
+   if (!vtest_ring_init(&vws->ring, ring_fd, doorbell_fd,
+                        VTEST_RING_BUFFER_SIZE))
+      fprintf(stderr, "failed to map the vtest command ring\n");
+}
+
 int virgl_vtest_submit_cmd(struct virgl_vtest_winsys *vws,
                            uint32_t *buf, uint32_t buf_len)
 {
@@ -388,6 +424,24 @@ int virgl_vtest_submit_cmd(struct virgl_vtest_winsys *vws,
    vtest_hdr[VTEST_CMD_LEN] = buf_len;
    vtest_hdr[VTEST_CMD_ID] = VCMD_SUBMIT_CMD;
 
+   /* The protocol version may still be lowered while querying the caps, so
+    * only look for the ring once commands are actually submitted.
+    */
+   if (!vws->ring_checked) {
+      vws->ring_checked = true;
+      if (vws->protocol_version >= 5 &&
+          debug_get_bool_option("VTEST_SHM_RING", true))
+         virgl_vtest_create_cmd_ring(vws);
+   }
+
+   if (vws->ring.map &&
+       vtest_ring_reserve(&vws->ring, sizeof(vtest_hdr) + 4 * buf_len)) {
+      vtest_ring_write(&vws->ring, vtest_hdr, sizeof(vtest_hdr));
+      vtest_ring_write(&vws->ring, buf, 4 * buf_len);
+      vtest_ring_submit(&vws->ring);
+      return 0;
+   }
+
    virgl_block_write(vws->sock_fd, &vtest_hdr, sizeof(vtest_hdr));
    virgl_block_write(vws->sock_fd, buf, 4 * buf_len);
    return 0;
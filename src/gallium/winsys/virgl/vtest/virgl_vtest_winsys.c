@@ -721,6 +721,8 @@ virgl_vtest_winsys_destroy(struct virgl_winsys *vws)
 
    virgl_resource_cache_flush(&vtws->cache);
 
+   vtest_ring_fini(&vtws->ring);
+
    mtx_destroy(&vtws->mutex);
    FREE(vtws);
 }
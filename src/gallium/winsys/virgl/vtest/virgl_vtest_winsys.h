@@ -32,6 +32,7 @@
 
 #include "virgl/virgl_winsys.h"
 #include "vtest/vtest_protocol.h"
+#include "vtest/vtest_ring.h"
 #include "virgl_resource_cache.h"
 
 struct pipe_fence_handle;
@@ -51,6 +52,10 @@ struct virgl_vtest_winsys {
 
    int32_t blob_id;
    unsigned protocol_version;
+
+   /* command ring, created on the first submission if the server has it */
+   struct vtest_ring ring;
+   bool ring_checked;
 };
 
 struct virgl_hw_res {
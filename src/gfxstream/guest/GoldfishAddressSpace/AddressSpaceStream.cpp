@@ -39,6 +39,9 @@ AddressSpaceStream::AddressSpaceStream(address_space_handle_t handle, uint32_t v
       m_buf((unsigned char*)context.buffer),
       m_writeStart(m_buf),
       m_writeStep(context.ring_config->flush_interval),
+      m_inPlaceSize(0),
+      m_inPlaceStart(nullptr),
+      m_inPlaceEnd(nullptr),
       m_notifs(0),
       m_written(0),
       m_backoffIters(0),
@@ -83,6 +86,19 @@ void* AddressSpaceStream::allocBuffer(size_t minSize) {
     size_t allocSize =
         (m_writeStep < minSize ? minSize : m_writeStep);
 
+    // Packets larger than a write step but small enough for the write buffer
+    // are encoded in place and sent as a single type 1 transfer, instead of
+    // being copied from a temporary buffer into the large transfer ring.
+    if (m_writeStep < allocSize && allocSize <= m_writeBufferSize / 2) {
+        if (m_usingTmpBuf) {
+            writeFully(m_tmpBuf, m_tmpBufXferSize);
+            m_usingTmpBuf = false;
+            m_tmpBufXferSize = 0;
+        }
+
+        return allocInPlace(allocSize);
+    }
+
     if (m_writeStep < allocSize) {
         if (!m_tmpBuf) {
             m_tmpBufSize = allocSize * 2;
@@ -108,10 +124,28 @@ void* AddressSpaceStream::allocBuffer(size_t minSize) {
             m_tmpBufXferSize = 0;
         }
 
+        // Don't overwrite a multi-step transfer the host is still reading.
+        if (m_writeStart >= m_inPlaceStart && m_writeStart < m_inPlaceEnd) {
+            ensureType1Finished();
+        }
+
         return m_writeStart;
     }
 }
 
+void* AddressSpaceStream::allocInPlace(size_t size) {
+    // Outstanding transfers are accounted for in steps, so wait for the
+    // host to consume everything. The whole write buffer is free after that.
+    ensureType1Finished();
+
+    if (m_writeStart + size > m_buf + m_writeBufferSize) {
+        m_writeStart = m_buf;
+    }
+
+    m_inPlaceSize = size;
+    return m_writeStart;
+}
+
 int AddressSpaceStream::commitBuffer(size_t size)
 {
     if (size == 0) return 0;
@@ -121,6 +155,19 @@ int AddressSpaceStream::commitBuffer(size_t size)
         m_tmpBufXferSize = 0;
         m_usingTmpBuf = false;
         return 0;
+    } else if (m_inPlaceSize) {
+        int res = type1Write(m_writeStart - m_buf, size);
+        uint32_t steps = (size + m_writeStep - 1) / m_writeStep;
+
+        m_inPlaceStart = m_writeStart;
+        m_inPlaceEnd = m_writeStart + steps * m_writeStep;
+        m_inPlaceSize = 0;
+
+        m_writeStart = m_inPlaceEnd;
+        if (m_writeStart == m_buf + m_writeBufferSize) {
+            m_writeStart = m_buf;
+        }
+        return res;
     } else {
         int res = type1Write(m_writeStart - m_buf, size);
         advanceWrite();
@@ -462,6 +509,9 @@ void AddressSpaceStream::ensureType1Finished() {
             return;
         }
     }
+
+    m_inPlaceStart = nullptr;
+    m_inPlaceEnd = nullptr;
 }
 
 void AddressSpaceStream::ensureType3Finished() {
@@ -39,6 +39,7 @@ private:
     void notifyAvailable();
     uint32_t getRelativeBufferPos(uint32_t pos);
     void advanceWrite();
+    void* allocInPlace(size_t size);
     void ensureConsumerFinishing();
     void ensureType1Finished();
     void ensureType3Finished();
@@ -72,6 +73,13 @@ private:
     unsigned char* m_writeStart;
     uint32_t m_writeStep;
 
+    // Size of the current buffer if it spans several write steps, 0 otherwise.
+    size_t m_inPlaceSize;
+    // Write buffer range of the last multi-step transfer, until the host
+    // consumed it.
+    unsigned char* m_inPlaceStart;
+    unsigned char* m_inPlaceEnd;
+
     uint32_t m_notifs;
     uint32_t m_written;
 
@@ -4,6 +4,7 @@
  */
 #include "HostVisibleMemoryVirtualization.h"
 
+#include <algorithm>
 #include <set>
 
 #include "ResourceTracker.h"
@@ -11,6 +12,7 @@
 #include "VkEncoder.h"
 #include "util/detect_os.h"
 #include "util/log.h"
+#include "util/macros.h"
 
 namespace gfxstream {
 namespace vk {
@@ -39,6 +41,14 @@ CoherentMemory::~CoherentMemory() {
 
 VkDeviceMemory CoherentMemory::getDeviceMemory() const { return mMemory; }
 
+VkDevice CoherentMemory::getDevice() const { return mDevice; }
+
+uint64_t CoherentMemory::getSize() const { return mSize; }
+
+uint64_t CoherentMemory::getUsedSize() const { return mUsedSize; }
+
+uint32_t CoherentMemory::getAllocationCount() const { return mAllocationCount; }
+
 bool CoherentMemory::subAllocate(uint64_t size, uint8_t** ptr, uint64_t& offset) {
     // 2^12 = 4096 (page size)
     auto block = u_mmAllocMem(mHeap, size, 12, 0);
@@ -46,12 +56,16 @@ bool CoherentMemory::subAllocate(uint64_t size, uint8_t** ptr, uint64_t& offset)
 
     offset = block->ofs;
     *ptr = mBaseAddr + block->ofs;
+    mUsedSize += block->size;
+    ++mAllocationCount;
     return true;
 }
 
 bool CoherentMemory::release(uint64_t offset) {
     auto block = u_mmFindBlock(mHeap, offset);
     if (block) {
+        mUsedSize -= block->size;
+        --mAllocationCount;
         u_mmFreeMem(block);
         return true;
     } else {
@@ -61,5 +75,38 @@ bool CoherentMemory::release(uint64_t offset) {
     return false;
 }
 
+uint64_t CoherentMemoryBlockSizer::getBlockSize(uint32_t memoryTypeIndex,
+                                                uint64_t allocationSize) const {
+    uint64_t blockSize = kDefaultHostMemBlockSize;
+    if (memoryTypeIndex < VK_MAX_MEMORY_TYPES && mBlockSizes[memoryTypeIndex]) {
+        blockSize = mBlockSizes[memoryTypeIndex];
+    }
+
+    return std::max(ALIGN_POT(allocationSize, kMegaByte), blockSize);
+}
+
+void CoherentMemoryBlockSizer::onBlockCreated(uint32_t memoryTypeIndex) {
+    if (memoryTypeIndex >= VK_MAX_MEMORY_TYPES) return;
+
+    // The first block of a memory type uses the default size. Needing more
+    // than one means the application keeps a lot of small allocations alive,
+    // so make the next ones larger to save on host mappings.
+    uint64_t& blockSize = mBlockSizes[memoryTypeIndex];
+    if (!blockSize) blockSize = kDefaultHostMemBlockSize;
+    if (mBlockCounts[memoryTypeIndex]++) {
+        blockSize = std::min(blockSize * 2, kMaxHostMemBlockSize);
+    }
+}
+
+void CoherentMemoryBlockSizer::onBlockEvicted(uint32_t memoryTypeIndex) {
+    if (memoryTypeIndex >= VK_MAX_MEMORY_TYPES) return;
+
+    // Blocks are going unused, so smaller ones waste less memory.
+    uint64_t& blockSize = mBlockSizes[memoryTypeIndex];
+    if (!blockSize) blockSize = kDefaultHostMemBlockSize;
+    blockSize = std::max(blockSize / 2, kMinHostMemBlockSize);
+    if (mBlockCounts[memoryTypeIndex]) --mBlockCounts[memoryTypeIndex];
+}
+
 }  // namespace vk
 }  // namespace gfxstream
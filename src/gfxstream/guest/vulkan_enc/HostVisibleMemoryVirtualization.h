@@ -19,6 +19,11 @@ constexpr uint64_t kMegaByte = 1048576;
 // images.
 constexpr uint64_t kLargestPageSize = 65536;
 constexpr uint64_t kDefaultHostMemBlockSize = 16 * kMegaByte;  // 16 mb
+constexpr uint64_t kMinHostMemBlockSize = 4 * kMegaByte;
+constexpr uint64_t kMaxHostMemBlockSize = 64 * kMegaByte;
+
+// Number of blocks without suballocations that are kept mapped for reuse.
+constexpr uint32_t kMaxIdleHostMemBlocks = 4;
 
 namespace gfxstream {
 namespace vk {
@@ -38,6 +43,11 @@ class CoherentMemory {
     ~CoherentMemory();
 
     VkDeviceMemory getDeviceMemory() const;
+    VkDevice getDevice() const;
+
+    uint64_t getSize() const;
+    uint64_t getUsedSize() const;
+    uint32_t getAllocationCount() const;
 
     bool subAllocate(uint64_t size, uint8_t** ptr, uint64_t& offset);
     bool release(uint64_t offset);
@@ -54,9 +64,35 @@ class CoherentMemory {
 
     uint8_t* mBaseAddr = nullptr;
     struct mem_block* mHeap = nullptr;
+
+    uint64_t mUsedSize = 0;
+    uint32_t mAllocationCount = 0;
 };
 
 using CoherentMemoryPtr = std::shared_ptr<CoherentMemory>;
 
+// Picks the size of new coherent memory blocks for each memory type. Every
+// block is a separate host mapping, so the size grows while a memory type
+// keeps running out of space and shrinks again when idle blocks have to be
+// torn down.
+class CoherentMemoryBlockSizer {
+   public:
+    uint64_t getBlockSize(uint32_t memoryTypeIndex, uint64_t allocationSize) const;
+
+    void onBlockCreated(uint32_t memoryTypeIndex);
+    void onBlockEvicted(uint32_t memoryTypeIndex);
+
+   private:
+    uint64_t mBlockSizes[VK_MAX_MEMORY_TYPES] = {};
+    uint32_t mBlockCounts[VK_MAX_MEMORY_TYPES] = {};
+};
+
+struct CoherentMemoryStats {
+    uint64_t mappingsCreated = 0;
+    uint64_t blocksReused = 0;
+    uint64_t blocksEvicted = 0;
+    uint64_t suballocations = 0;
+};
+
 }  // namespace vk
 }  // namespace gfxstream
@@ -25,6 +25,7 @@
 #include "vk_format_info.h"
 #include <vndk/hardware_buffer.h>
 #endif
+#include <inttypes.h>
 #include <stdlib.h>
 #include <stdint.h>
 
@@ -774,6 +775,46 @@ CoherentMemoryPtr ResourceTracker::freeCoherentMemoryLocked(VkDeviceMemory memor
     return nullptr;
 }
 
+CoherentMemoryPtr ResourceTracker::parkCoherentMemoryLocked(CoherentMemoryPtr coherentMemory,
+                                                            const VkDeviceMemory_Info& info) {
+    // Only shared blocks that nothing else references anymore are worth keeping.
+    if (!coherentMemory || info.dedicated || coherentMemory.use_count() > 1 ||
+        coherentMemory->getAllocationCount()) {
+        return coherentMemory;
+    }
+
+    mIdleCoherentMemories.push_back({std::move(coherentMemory), info.memoryTypeIndex});
+    if (mIdleCoherentMemories.size() <= kMaxIdleHostMemBlocks) return nullptr;
+
+    // Too many blocks are going unused, evict the oldest one. The caller frees it.
+    IdleCoherentMemory evicted = std::move(mIdleCoherentMemories.front());
+    mIdleCoherentMemories.erase(mIdleCoherentMemories.begin());
+    mCoherentMemoryBlockSizer.onBlockEvicted(evicted.memoryTypeIndex);
+    ++mCoherentMemoryStats.blocksEvicted;
+    return std::move(evicted.memory);
+}
+
+void ResourceTracker::dumpCoherentMemoryStatsLocked(VkDevice device) {
+    std::set<CoherentMemory*> blocks;
+    for (const auto& [memory, info] : info_VkDeviceMemory) {
+        if (info.device == device && info.coherentMemory) blocks.insert(info.coherentMemory.get());
+    }
+
+    uint64_t size = 0;
+    uint64_t used = 0;
+    for (auto block : blocks) {
+        size += block->getSize();
+        used += block->getUsedSize();
+    }
+
+    mesa_logd("%s: coherent memory: %zu live blocks, %" PRIu64 " of %" PRIu64
+              " bytes used (%.1f%% fragmentation), %" PRIu64 " mappings created, %" PRIu64
+              " idle blocks reused, %" PRIu64 " evicted, %" PRIu64 " suballocations\n",
+              __func__, blocks.size(), used, size, size ? 100.0 * (size - used) / size : 0.0,
+              mCoherentMemoryStats.mappingsCreated, mCoherentMemoryStats.blocksReused,
+              mCoherentMemoryStats.blocksEvicted, mCoherentMemoryStats.suballocations);
+}
+
 void ResourceTracker::EmitGuestAndHostTraceMarker(VkEncoder* encoder) {
 #ifdef HAVE_PERFETTO
     const uint64_t flowId = GeneratePseudoUniqueId();
@@ -864,8 +905,10 @@ static void collectAllPendingDescriptorSetsBottomUp(const std::vector<VkCommandB
     }
 }
 
-static void commitDescriptorSetUpdates(void* context, VkQueue queue,
-                                       const std::unordered_set<VkDescriptorSet>& sets) {
+// Returns the number of descriptor writes that were merged into a neighbouring
+// write of the same binding instead of being sent to the host separately.
+static uint32_t commitDescriptorSetUpdates(void* context, VkQueue queue,
+                                           const std::unordered_set<VkDescriptorSet>& sets) {
     VkEncoder* enc = (VkEncoder*)context;
 
     std::unordered_map<VkDescriptorPool, uint32_t> poolSet;
@@ -877,6 +920,15 @@ static void commitDescriptorSetUpdates(void* context, VkQueue queue,
     std::vector<uint32_t> writeStartingIndices;
     std::vector<VkWriteDescriptorSet> writesForHost;
 
+    // Consecutive array elements of a binding are sent as one write, so their
+    // infos are gathered into contiguous arrays. The arrays may still grow, so
+    // writes record an index and get their pointers once everything is known.
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    std::vector<VkBufferView> bufferViews;
+    std::vector<size_t> writeInfoIndices;
+    uint32_t merged = 0;
+
     uint32_t poolIndex = 0;
     uint32_t currentWriteIndex = 0;
     for (auto set : sets) {
@@ -904,32 +956,21 @@ static void commitDescriptorSetUpdates(void* context, VkQueue queue,
 
         for (size_t i = 0; i < writes.size(); ++i) {
             uint32_t binding = i;
+            VkWriteDescriptorSet* run = nullptr;
+            DescriptorWriteType runType = DescriptorWriteType::Empty;
 
             for (size_t j = 0; j < writes[i].size(); ++j) {
                 auto& write = writes[i][j];
 
-                if (write.type == DescriptorWriteType::Empty) continue;
-
-                uint32_t dstArrayElement = 0;
-
-                VkDescriptorImageInfo* imageInfo = nullptr;
-                VkDescriptorBufferInfo* bufferInfo = nullptr;
-                VkBufferView* bufferView = nullptr;
+                if (write.type == DescriptorWriteType::Empty) {
+                    run = nullptr;
+                    continue;
+                }
 
                 switch (write.type) {
-                    case DescriptorWriteType::Empty:
-                        break;
                     case DescriptorWriteType::ImageInfo:
-                        dstArrayElement = j;
-                        imageInfo = &write.imageInfo;
-                        break;
                     case DescriptorWriteType::BufferInfo:
-                        dstArrayElement = j;
-                        bufferInfo = &write.bufferInfo;
-                        break;
                     case DescriptorWriteType::BufferView:
-                        dstArrayElement = j;
-                        bufferView = &write.bufferView;
                         break;
                     case DescriptorWriteType::InlineUniformBlock:
                     case DescriptorWriteType::AccelerationStructure:
@@ -939,25 +980,53 @@ static void commitDescriptorSetUpdates(void* context, VkQueue queue,
                             "desc write, abort (NYI)\n");
                         abort();
                     default:
-                        break;
+                        run = nullptr;
+                        continue;
                 }
 
-                // TODO: Combine multiple writes into one VkWriteDescriptorSet.
-                VkWriteDescriptorSet forHost = {
-                    VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                    0 /* TODO: inline uniform block */,
-                    set,
-                    binding,
-                    dstArrayElement,
-                    1,
-                    write.descriptorType,
-                    imageInfo,
-                    bufferInfo,
-                    bufferView,
-                };
+                // Extend the previous write if this is the next array element
+                // of the same kind.
+                if (run && run->descriptorType == write.descriptorType &&
+                    runType == write.type) {
+                    ++run->descriptorCount;
+                    ++merged;
+                } else {
+                    VkWriteDescriptorSet forHost = {
+                        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        0 /* TODO: inline uniform block */,
+                        set,
+                        binding,
+                        (uint32_t)j,
+                        1,
+                        write.descriptorType,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                    };
+
+                    size_t infoIndex = 0;
+                    if (write.type == DescriptorWriteType::ImageInfo) {
+                        infoIndex = imageInfos.size();
+                    } else if (write.type == DescriptorWriteType::BufferInfo) {
+                        infoIndex = bufferInfos.size();
+                    } else {
+                        infoIndex = bufferViews.size();
+                    }
+
+                    writesForHost.push_back(forHost);
+                    writeInfoIndices.push_back(infoIndex);
+                    run = &writesForHost.back();
+                    runType = write.type;
+                    ++currentWriteIndex;
+                }
 
-                writesForHost.push_back(forHost);
-                ++currentWriteIndex;
+                if (write.type == DescriptorWriteType::ImageInfo) {
+                    imageInfos.push_back(write.imageInfo);
+                } else if (write.type == DescriptorWriteType::BufferInfo) {
+                    bufferInfos.push_back(write.bufferInfo);
+                } else {
+                    bufferViews.push_back(write.bufferView);
+                }
 
                 // Set it back to empty.
                 write.type = DescriptorWriteType::Empty;
@@ -967,7 +1036,19 @@ static void commitDescriptorSetUpdates(void* context, VkQueue queue,
 
     // Skip out if there's nothing to VkWriteDescriptorSet home about.
     if (writesForHost.empty()) {
-        return;
+        return 0;
+    }
+
+    for (size_t i = 0; i < writesForHost.size(); ++i) {
+        VkWriteDescriptorSet& write = writesForHost[i];
+
+        if (isDescriptorTypeImageInfo(write.descriptorType)) {
+            write.pImageInfo = imageInfos.data() + writeInfoIndices[i];
+        } else if (isDescriptorTypeBufferInfo(write.descriptorType)) {
+            write.pBufferInfo = bufferInfos.data() + writeInfoIndices[i];
+        } else {
+            write.pTexelBufferView = bufferViews.data() + writeInfoIndices[i];
+        }
     }
 
     enc->vkQueueCommitDescriptorSetUpdatesGOOGLE(
@@ -981,6 +1062,8 @@ static void commitDescriptorSetUpdates(void* context, VkQueue queue,
         ReifiedDescriptorSet* reified = as_goldfish_VkDescriptorSet(set)->reified;
         reified->allocationPending = false;
     }
+
+    return merged;
 }
 
 uint32_t ResourceTracker::syncEncodersForCommandBuffer(VkCommandBuffer commandBuffer,
@@ -1264,15 +1347,25 @@ void ResourceTracker::unregister_VkDescriptorSetLayout(VkDescriptorSetLayout set
 void ResourceTracker::freeDescriptorSetsIfHostAllocated(VkEncoder* enc, VkDevice device,
                                                         uint32_t descriptorSetCount,
                                                         const VkDescriptorSet* sets) {
+    // Sets the host has seen are freed with one call per pool.
+    std::unordered_map<VkDescriptorPool, std::vector<VkDescriptorSet>> hostSets;
+
     for (uint32_t i = 0; i < descriptorSetCount; ++i) {
         struct goldfish_VkDescriptorSet* ds = as_goldfish_VkDescriptorSet(sets[i]);
         if (ds->reified->allocationPending) {
             unregister_VkDescriptorSet(sets[i]);
             delete_goldfish_VkDescriptorSet(sets[i]);
+            ++mDescriptorBatchStats.elidedFrees;
         } else {
-            enc->vkFreeDescriptorSets(device, ds->reified->pool, 1, &sets[i], false /* no lock */);
+            hostSets[ds->reified->pool].push_back(sets[i]);
         }
     }
+
+    for (auto& [pool, poolSets] : hostSets) {
+        enc->vkFreeDescriptorSets(device, pool, (uint32_t)poolSets.size(), poolSets.data(),
+                                  false /* no lock */);
+        mDescriptorBatchStats.elidedFrees += poolSets.size() - 1;
+    }
 }
 
 void ResourceTracker::clearDescriptorPoolAndUnregisterDescriptorSets(void* context, VkDevice device,
@@ -2334,11 +2427,34 @@ VkResult ResourceTracker::on_vkCreateDevice(void* context, VkResult input_result
 void ResourceTracker::on_vkDestroyDevice_pre(void* context, VkDevice device,
                                              const VkAllocationCallbacks*) {
     (void)context;
+
+    // Freed after the lock is released, as the destructor calls into VkEncoder.
+    std::vector<IdleCoherentMemory> idleCoherentMemories;
     std::lock_guard<std::recursive_mutex> lock(mLock);
 
     auto it = info_VkDevice.find(device);
     if (it == info_VkDevice.end()) return;
 
+    dumpCoherentMemoryStatsLocked(device);
+
+    for (auto idle = mIdleCoherentMemories.begin(); idle != mIdleCoherentMemories.end();) {
+        if (idle->memory->getDevice() == device) {
+            idleCoherentMemories.push_back(std::move(*idle));
+            idle = mIdleCoherentMemories.erase(idle);
+        } else {
+            idle++;
+        }
+    }
+
+    if (mFeatureInfo.hasVulkanBatchedDescriptorSetUpdate) {
+        mesa_logd(
+            "%s: descriptor host calls elided: %" PRIu64 " allocations, %" PRIu64
+            " updates, %" PRIu64 " frees, %" PRIu64 " merged writes\n",
+            __func__, mDescriptorBatchStats.elidedAllocations.load(),
+            mDescriptorBatchStats.elidedUpdates.load(), mDescriptorBatchStats.elidedFrees.load(),
+            mDescriptorBatchStats.mergedWrites.load());
+    }
+
     for (auto itr = info_VkDeviceMemory.cbegin(); itr != info_VkDeviceMemory.cend();) {
         auto& memInfo = itr->second;
         if (memInfo.device == device) {
@@ -3201,8 +3317,9 @@ VkResult ResourceTracker::allocateCoherentMemory(VkDevice device,
         hostAllocationInfo.allocationSize =
             ALIGN_POT(pAllocateInfo->allocationSize, kLargestPageSize);
     } else {
-        VkDeviceSize roundedUpAllocSize = ALIGN_POT(pAllocateInfo->allocationSize, kMegaByte);
-        hostAllocationInfo.allocationSize = std::max(roundedUpAllocSize, kDefaultHostMemBlockSize);
+        std::lock_guard<std::recursive_mutex> lock(mLock);
+        hostAllocationInfo.allocationSize = mCoherentMemoryBlockSizer.getBlockSize(
+            pAllocateInfo->memoryTypeIndex, pAllocateInfo->allocationSize);
     }
 
     // Support device address capture/replay allocations
@@ -3288,6 +3405,9 @@ VkResult ResourceTracker::allocateCoherentMemory(VkDevice device,
         info.coherentMemoryOffset = offset;
         info.coherentMemory = coherentMemory;
         info.ptr = ptr;
+
+        std::lock_guard<std::recursive_mutex> lock(mLock);
+        ++mCoherentMemoryStats.mappingsCreated;
     }
 
     info.coherentMemorySize = hostAllocationInfo.allocationSize;
@@ -3316,6 +3436,10 @@ VkResult ResourceTracker::allocateCoherentMemory(VkDevice device,
         info.ptr = ptr;
         info_VkDeviceMemory[mem] = info;
         *pMemory = mem;
+
+        ++mCoherentMemoryStats.mappingsCreated;
+        ++mCoherentMemoryStats.suballocations;
+        if (!dedicated) mCoherentMemoryBlockSizer.onBlockCreated(info.memoryTypeIndex);
     } else {
         enc->vkFreeMemory(device, mem, nullptr, true);
         std::lock_guard<std::recursive_mutex> lock(mLock);
@@ -3359,7 +3483,26 @@ VkResult ResourceTracker::getCoherentMemory(const VkMemoryAllocateInfo* pAllocat
             coherentMemory = info.coherentMemory;
             break;
         }
+        if (!coherentMemory && !dedicated) {
+            // Reuse an idle block before creating a new host mapping.
+            for (auto idle = mIdleCoherentMemories.begin(); idle != mIdleCoherentMemories.end();
+                 idle++) {
+                if (idle->memory->getDevice() != device) continue;
+
+                if (idle->memoryTypeIndex != pAllocateInfo->memoryTypeIndex) continue;
+
+                if (!idle->memory->subAllocate(pAllocateInfo->allocationSize, &ptr, offset))
+                    continue;
+
+                coherentMemory = std::move(idle->memory);
+                mIdleCoherentMemories.erase(idle);
+                ++mCoherentMemoryStats.blocksReused;
+                break;
+            }
+        }
         if (coherentMemory) {
+            ++mCoherentMemoryStats.suballocations;
+
             struct VkDeviceMemory_Info info;
             info.coherentMemoryOffset = offset;
             info.ptr = ptr;
@@ -4226,7 +4369,7 @@ void ResourceTracker::on_vkFreeMemory(void* context, VkDevice device, VkDeviceMe
         return;
     }
 
-    auto coherentMemory = freeCoherentMemoryLocked(memory, info);
+    auto coherentMemory = parkCoherentMemoryLocked(freeCoherentMemoryLocked(memory, info), info);
 
     // We have to release the lock before we could possibly free a
     // CoherentMemory, because that will call into VkEncoder, which
@@ -4288,6 +4431,7 @@ VkResult ResourceTracker::on_vkMapMemory(void* context, VkResult host_result, Vk
         deviceMemoryInfo.coherentMemoryOffset = offset;
         deviceMemoryInfo.coherentMemory = coherentMemory;
         deviceMemoryInfo.ptr = ptr;
+        ++mCoherentMemoryStats.mappingsCreated;
     }
 
     if (!deviceMemoryInfo.ptr) {
@@ -5251,6 +5395,8 @@ VkResult ResourceTracker::on_vkAllocateDescriptorSets(
 
         if (poolAllocResult != VK_SUCCESS) return poolAllocResult;
 
+        ++mDescriptorBatchStats.elidedAllocations;
+
         for (uint32_t i = 0; i < ci->descriptorSetCount; ++i) {
             register_VkDescriptorSet(sets[i]);
             VkDescriptorSetLayout setLayout =
@@ -5430,6 +5576,8 @@ void ResourceTracker::on_vkUpdateDescriptorSets(void* context, VkDevice device,
     }
 
     if (mFeatureInfo.hasVulkanBatchedDescriptorSetUpdate) {
+        ++mDescriptorBatchStats.elidedUpdates;
+
         for (uint32_t i = 0; i < descriptorWriteCount; ++i) {
             VkDescriptorSet set = transformedWrites[i].dstSet;
             doEmulatedDescriptorWrite(&transformedWrites[i],
@@ -6158,7 +6306,7 @@ void ResourceTracker::flushStagingStreams(void* context, VkQueue queue, uint32_t
 
     std::unordered_set<VkDescriptorSet> pendingSets;
     collectAllPendingDescriptorSetsBottomUp(toFlush, pendingSets);
-    commitDescriptorSetUpdates(context, queue, pendingSets);
+    mDescriptorBatchStats.mergedWrites += commitDescriptorSetUpdates(context, queue, pendingSets);
 
     flushCommandBufferPendingCommandsBottomUp(context, queue, toFlush);
 
@@ -6932,7 +7080,10 @@ void ResourceTracker::on_vkUpdateDescriptorSetWithTemplate(
         }
     }
 
-    if (batched) return;
+    if (batched) {
+        ++mDescriptorBatchStats.elidedUpdates;
+        return;
+    }
 
     enc->vkUpdateDescriptorSetWithTemplateSized2GOOGLE(
         device, descriptorSet, descriptorUpdateTemplate, imageInfoCount, bufferInfoCount,
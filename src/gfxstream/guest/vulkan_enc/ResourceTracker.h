@@ -887,11 +887,38 @@ class ResourceTracker {
 
     void transformImageMemoryRequirementsForGuestLocked(VkImage image, VkMemoryRequirements* reqs);
     CoherentMemoryPtr freeCoherentMemoryLocked(VkDeviceMemory memory, VkDeviceMemory_Info& info);
+    CoherentMemoryPtr parkCoherentMemoryLocked(CoherentMemoryPtr coherentMemory,
+                                               const VkDeviceMemory_Info& info);
+    void dumpCoherentMemoryStatsLocked(VkDevice device);
 
     void EmitGuestAndHostTraceMarker(VkEncoder* encoder);
 
     std::recursive_mutex mLock;
 
+    // Host calls avoided by the batched descriptor set update path, logged when a
+    // device is destroyed.
+    struct DescriptorBatchStats {
+        // vkAllocateDescriptorSets calls handled in the guest.
+        std::atomic<uint64_t> elidedAllocations = 0;
+        // vkUpdateDescriptorSets calls deferred to the next submit.
+        std::atomic<uint64_t> elidedUpdates = 0;
+        // Sets freed without reaching the host or in a shared per-pool call.
+        std::atomic<uint64_t> elidedFrees = 0;
+        // Array element writes sent as part of a neighbouring write.
+        std::atomic<uint64_t> mergedWrites = 0;
+    };
+    DescriptorBatchStats mDescriptorBatchStats;
+
+    // Blocks without suballocations, kept mapped so that allocation churn does
+    // not create a new host mapping every time. Oldest first.
+    struct IdleCoherentMemory {
+        CoherentMemoryPtr memory;
+        uint32_t memoryTypeIndex;
+    };
+    std::vector<IdleCoherentMemory> mIdleCoherentMemories;
+    CoherentMemoryBlockSizer mCoherentMemoryBlockSizer;
+    CoherentMemoryStats mCoherentMemoryStats;
+
     std::optional<const VkPhysicalDeviceMemoryProperties> mCachedPhysicalDeviceMemoryProps;
 
     struct GfxStreamVkFeatureInfo mFeatureInfo = {};
@@ -96,6 +96,7 @@ pco_shader *pco_shader_create(pco_ctx *ctx, nir_shader *nir, void *mem_ctx)
    shader->is_internal = nir->info.internal;
    shader->is_grouped = false;
    list_inithead(&shader->funcs);
+   util_dynarray_init(&shader->pass_times, shader);
 
    return shader;
 }
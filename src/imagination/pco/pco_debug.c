@@ -26,6 +26,7 @@ static const struct debug_named_value pco_debug_options[] = {
    { "val_skip", PCO_DEBUG_VAL_SKIP, "Skip IR validation." },
    { "reindex", PCO_DEBUG_REINDEX, "Reindex IR at the end of each pass." },
    { "no_pred_cf", PCO_DEBUG_NO_PRED_CF, "No predicated execution in CF." },
+   { "no_sched", PCO_DEBUG_NO_SCHED, "Don't reorder instructions." },
    DEBUG_NAMED_VALUE_END,
 };
 
@@ -42,6 +43,7 @@ static const struct debug_named_value pco_debug_print_options[] = {
    { "binary", PCO_DEBUG_PRINT_BINARY, "Print the resulting binary." },
    { "verbose", PCO_DEBUG_PRINT_VERBOSE, "Print verbose IR." },
    { "ra", PCO_DEBUG_PRINT_RA, "Print register alloc info." },
+   { "times", PCO_DEBUG_PRINT_TIMES, "Print the time spent in each pass." },
    DEBUG_NAMED_VALUE_END,
 };
 
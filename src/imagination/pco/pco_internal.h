@@ -24,6 +24,7 @@
 #include "util/hash_table.h"
 #include "util/macros.h"
 #include "util/list.h"
+#include "util/os_time.h"
 #include "util/u_debug.h"
 #include "util/u_dynarray.h"
 #include "util/u_math.h"
@@ -57,6 +58,7 @@ enum pco_debug {
    PCO_DEBUG_VAL_SKIP = BITFIELD64_BIT(0),
    PCO_DEBUG_REINDEX = BITFIELD64_BIT(1),
    PCO_DEBUG_NO_PRED_CF = BITFIELD64_BIT(2),
+   PCO_DEBUG_NO_SCHED = BITFIELD64_BIT(3),
 };
 
 extern uint64_t pco_debug;
@@ -75,6 +77,7 @@ enum pco_debug_print {
    PCO_DEBUG_PRINT_BINARY = BITFIELD64_BIT(6),
    PCO_DEBUG_PRINT_VERBOSE = BITFIELD64_BIT(7),
    PCO_DEBUG_PRINT_RA = BITFIELD64_BIT(8),
+   PCO_DEBUG_PRINT_TIMES = BITFIELD64_BIT(9),
 };
 
 extern uint64_t pco_debug_print;
@@ -374,8 +377,20 @@ typedef struct _pco_shader {
 
    pco_data data; /** Shader data. */
    struct util_dynarray binary; /** Shader binary. */
+
+   struct util_dynarray pass_times; /** Time spent in passes (pco_pass_time). */
 } pco_shader;
 
+/** Time spent in a pass. */
+typedef struct _pco_pass_time {
+   const char *name; /** Pass name. */
+   unsigned runs; /** Number of times the pass was run. */
+   uint64_t ns; /** Total time spent in the pass, in nanoseconds. */
+} pco_pass_time;
+
+void pco_record_pass_time(pco_shader *shader, const char *name, uint64_t ns);
+void pco_print_pass_times(pco_shader *shader, FILE *fp);
+
 /** Op info. */
 struct pco_op_info {
    const char *str; /** Op name string. */
@@ -3089,7 +3104,18 @@ static inline bool pco_should_skip_pass(const char *pass)
          break;                                               \
       }                                                       \
                                                               \
-      if (pass(shader, ##__VA_ARGS__)) {                      \
+      int64_t _start = 0;                                     \
+      if (PCO_DEBUG_PRINT(TIMES))                             \
+         _start = os_time_get_nano();                         \
+                                                              \
+      bool _progress = pass(shader, ##__VA_ARGS__);           \
+                                                              \
+      if (PCO_DEBUG_PRINT(TIMES)) {                           \
+         int64_t _ns = os_time_get_nano() - _start;           \
+         pco_record_pass_time(shader, #pass, _ns);            \
+      }                                                       \
+                                                              \
+      if (_progress) {                                        \
          UNUSED bool _;                                       \
          progress = true;                                     \
                                                               \
@@ -14,7 +14,9 @@
 #include "pco_internal.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 /**
  * \brief Runs passes on a PCO shader.
@@ -62,4 +64,53 @@ void pco_process_ir(pco_ctx *ctx, pco_shader *shader)
 
    if (pco_should_print_shader(shader))
       pco_print_shader(shader, stdout, "after passes");
+
+   if (PCO_DEBUG_PRINT(TIMES))
+      pco_print_pass_times(shader, stdout);
+}
+
+/**
+ * \brief Records the time spent running a pass.
+ *
+ * \param[in,out] shader PCO shader.
+ * \param[in] name Pass name.
+ * \param[in] ns Time spent in the pass, in nanoseconds.
+ */
+void pco_record_pass_time(pco_shader *shader, const char *name, uint64_t ns)
+{
+   util_dynarray_foreach (&shader->pass_times, pco_pass_time, pass_time) {
+      if (!strcmp(pass_time->name, name)) {
+         ++pass_time->runs;
+         pass_time->ns += ns;
+         return;
+      }
+   }
+
+   pco_pass_time pass_time = { .name = name, .runs = 1, .ns = ns };
+   util_dynarray_append(&shader->pass_times, pass_time);
+}
+
+/**
+ * \brief Prints the time spent in each pass.
+ *
+ * Times of passes run from within other passes (e.g. the pco_opt sub-passes)
+ * are also included in the time of the outer pass.
+ *
+ * \param[in] shader PCO shader.
+ * \param[in] fp Output file.
+ */
+void pco_print_pass_times(pco_shader *shader, FILE *fp)
+{
+   fprintf(fp,
+           "Pass times for %s shader \"%s\":\n",
+           _mesa_shader_stage_to_abbrev(shader->stage),
+           shader->name ? shader->name : "");
+
+   util_dynarray_foreach (&shader->pass_times, pco_pass_time, pass_time) {
+      fprintf(fp,
+              "  %-24s %4u run(s) %10.3f us\n",
+              pass_time->name,
+              pass_time->runs,
+              pass_time->ns / 1000.0);
+   }
 }
@@ -13,45 +13,554 @@
 #include "pco.h"
 #include "pco_builder.h"
 #include "pco_internal.h"
+#include "util/bitset.h"
+#include "util/dag.h"
 #include "util/macros.h"
+#include "util/ralloc.h"
 
 #include <stdbool.h>
+#include <string.h>
+
+/** Per-core scheduling model. */
+struct pco_sched_model {
+   unsigned alu_latency; /** Latency of instructions without data return. */
+   unsigned smp_latency; /** Latency of texture samples. */
+   unsigned ld_latency; /** Latency of memory loads. */
+   unsigned drc_latency; /** Latency of other data return instructions. */
+
+   /**
+    * Number of live SSA channels above which reducing register pressure
+    * takes priority over hiding latency.
+    */
+   unsigned max_live_chans;
+};
+
+/* These are estimates in instruction slots; the scheduler only relies on
+ * their relative size.
+ */
+static const struct pco_sched_model pco_sched_model_rogue = {
+   .alu_latency = 1,
+   .smp_latency = 48,
+   .ld_latency = 32,
+   .drc_latency = 24,
+   .max_live_chans = 48,
+};
+
+static const struct pco_sched_model pco_sched_model_rogue_xe = {
+   .alu_latency = 1,
+   .smp_latency = 32,
+   .ld_latency = 24,
+   .drc_latency = 16,
+   .max_live_chans = 32,
+};
+
+/** Scheduling node. */
+struct sched_node {
+   struct dag_node dag; /** DAG node, must be first. */
+   pco_instr *instr;
+
+   unsigned latency; /** Cycles until the results are available. */
+   unsigned height; /** Critical path length to the end of the region. */
+   unsigned ready_cycle; /** Earliest cycle the sources are available. */
+};
+
+/** Scheduling state. */
+struct sched_ctx {
+   const struct pco_sched_model *model;
+   pco_func *func;
+
+   struct sched_node **ssa_def; /** SSA index -> defining node in region. */
+   unsigned *ssa_uses; /** SSA index -> number of uses in the function. */
+   unsigned *ssa_region_uses; /** SSA index -> uses left in the region. */
+
+   unsigned live_chans; /** Live SSA channels at the current point. */
+   unsigned cycle; /** Current cycle. */
+};
+
+static const struct pco_sched_model *
+pco_sched_model_for_dev(const struct pvr_device_info *dev_info)
+{
+   if (PVR_HAS_FEATURE(dev_info, roguexe))
+      return &pco_sched_model_rogue_xe;
+
+   return &pco_sched_model_rogue;
+}
+
+static inline bool instr_returns_data(pco_instr *instr)
+{
+   pco_foreach_instr_src (psrc, instr) {
+      if (pco_ref_is_drc(*psrc))
+         return true;
+   }
+
+   return false;
+}
 
 /**
- * \brief Schedules instructions and inserts waits.
+ * \brief Returns whether an instruction must not be moved at all, so the
+ *        block is split into independently scheduled regions around it.
+ */
+static inline bool instr_is_barrier(pco_instr *instr)
+{
+   if (instr->op == PCO_OP_PHI || instr->op == PCO_OP_WDF ||
+       instr->op == PCO_OP_IDF || pco_op_info[instr->op].has_target_cf_node) {
+      return true;
+   }
+
+   return pco_instr_has_end(instr) && pco_instr_get_end(instr);
+}
+
+/**
+ * \brief Returns whether an instruction only reads and writes SSA values,
+ *        so that it can be moved anywhere its SSA dependencies allow.
  *
- * \param[in,out] shader PCO shader.
- * \return True if the pass made progress.
+ * All other instructions (memory accesses, hardware register accesses,
+ * predicated instructions...) keep their relative order.
  */
-bool pco_schedule(pco_shader *shader)
+static bool instr_is_free(pco_instr *instr)
+{
+   if (!instr->num_dests || instr_returns_data(instr))
+      return false;
+
+   if (!pco_instr_has_default_exec(instr))
+      return false;
+
+   pco_foreach_instr_dest (pdest, instr) {
+      if (!pco_ref_is_ssa(*pdest))
+         return false;
+   }
+
+   pco_foreach_instr_src (psrc, instr) {
+      if (pco_ref_is_ssa(*psrc) || pco_ref_is_imm(*psrc))
+         continue;
+
+      if (pco_ref_is_hwreg(*psrc) && psrc->reg_class == PCO_REG_CLASS_CONST)
+         continue;
+
+      return false;
+   }
+
+   return true;
+}
+
+static unsigned instr_latency(const struct sched_ctx *ctx, pco_instr *instr)
+{
+   if (!instr_returns_data(instr))
+      return ctx->model->alu_latency;
+
+   switch (instr->op) {
+   case PCO_OP_SMP:
+      return ctx->model->smp_latency;
+
+   case PCO_OP_LD:
+   case PCO_OP_LD_REGBL:
+      return ctx->model->ld_latency;
+
+   default:
+      return ctx->model->drc_latency;
+   }
+}
+
+static void sched_node_height(struct dag_node *dag_node, UNUSED void *data)
+{
+   struct sched_node *node = (struct sched_node *)dag_node;
+
+   node->height = node->latency;
+   util_dynarray_foreach (&node->dag.edges, struct dag_edge, edge) {
+      struct sched_node *child = (struct sched_node *)edge->child;
+      node->height = MAX2(node->height, child->height + edge->data);
+   }
+}
+
+static bool ssa_src_is_repeated(pco_instr *instr, const pco_ref *psrc)
+{
+   for (const pco_ref *other = &instr->src[0]; other < psrc; ++other) {
+      if (pco_ref_is_ssa(*other) && other->val == psrc->val)
+         return true;
+   }
+
+   return false;
+}
+
+static unsigned ssa_src_count(pco_instr *instr, unsigned val)
+{
+   unsigned count = 0;
+
+   pco_foreach_instr_src_ssa (psrc, instr) {
+      if (psrc->val == val)
+         ++count;
+   }
+
+   return count;
+}
+
+/**
+ * \brief Returns the change in live SSA channels from scheduling a node.
+ */
+static int sched_node_pressure_delta(const struct sched_ctx *ctx,
+                                     const struct sched_node *node)
+{
+   int delta = 0;
+
+   pco_foreach_instr_dest_ssa (pdest, node->instr) {
+      delta += pco_ref_get_chans(*pdest);
+   }
+
+   pco_foreach_instr_src_ssa (psrc, node->instr) {
+      /* Only count values that die here, i.e. defined in the region and
+       * without uses after it.
+       */
+      if (ssa_src_is_repeated(node->instr, psrc))
+         continue;
+
+      if (ctx->ssa_def[psrc->val] &&
+          ctx->ssa_region_uses[psrc->val] ==
+             ssa_src_count(node->instr, psrc->val) &&
+          ctx->ssa_uses[psrc->val] == 0) {
+         delta -= pco_ref_get_chans(*psrc);
+      }
+   }
+
+   return delta;
+}
+
+static struct sched_node *sched_choose(struct sched_ctx *ctx, struct dag *dag)
+{
+   struct sched_node *best = NULL;
+   bool high_pressure = ctx->live_chans >= ctx->model->max_live_chans;
+   int best_delta = 0;
+
+   list_for_each_entry (struct sched_node, node, &dag->heads, dag.link) {
+      if (!best) {
+         best = node;
+         best_delta = sched_node_pressure_delta(ctx, node);
+         continue;
+      }
+
+      if (high_pressure) {
+         int delta = sched_node_pressure_delta(ctx, node);
+         if (delta != best_delta) {
+            if (delta < best_delta) {
+               best = node;
+               best_delta = delta;
+            }
+            continue;
+         }
+      }
+
+      /* Prefer nodes that can issue now, then the longest critical path. */
+      bool ready = node->ready_cycle <= ctx->cycle;
+      bool best_ready = best->ready_cycle <= ctx->cycle;
+      if (ready != best_ready) {
+         if (ready) {
+            best = node;
+            best_delta = sched_node_pressure_delta(ctx, node);
+         }
+         continue;
+      }
+
+      if (!ready && node->ready_cycle != best->ready_cycle) {
+         if (node->ready_cycle < best->ready_cycle) {
+            best = node;
+            best_delta = sched_node_pressure_delta(ctx, node);
+         }
+         continue;
+      }
+
+      if (node->height > best->height) {
+         best = node;
+         best_delta = sched_node_pressure_delta(ctx, node);
+      }
+   }
+
+   return best;
+}
+
+/**
+ * \brief List schedules the instructions in [first, last) of a block, placing
+ *        them before last (or at the end of the block if NULL).
+ */
+static void sched_region(struct sched_ctx *ctx,
+                         pco_block *block,
+                         pco_instr *first,
+                         pco_instr *last)
+{
+   void *mem_ctx = ralloc_context(NULL);
+   struct dag *dag = dag_create(mem_ctx);
+   struct sched_node *last_fixed = NULL;
+   unsigned num_nodes = 0;
+
+   struct list_head *end = last ? &last->link : &block->instrs;
+   for (struct list_head *link = &first->link; link != end;
+        link = link->next) {
+      pco_instr *instr = list_entry(link, pco_instr, link);
+      struct sched_node *node = rzalloc(mem_ctx, struct sched_node);
+
+      dag_init_node(dag, &node->dag);
+      node->instr = instr;
+      node->latency = instr_latency(ctx, instr);
+
+      pco_foreach_instr_src_ssa (psrc, instr) {
+         struct sched_node *def = ctx->ssa_def[psrc->val];
+         if (!def)
+            continue;
+
+         dag_add_edge_max_data(&def->dag, &node->dag, def->latency);
+         ++ctx->ssa_region_uses[psrc->val];
+         --ctx->ssa_uses[psrc->val];
+      }
+
+      if (!instr_is_free(instr)) {
+         if (last_fixed)
+            dag_add_edge_max_data(&last_fixed->dag, &node->dag, 0);
+         last_fixed = node;
+      }
+
+      pco_foreach_instr_dest_ssa (pdest, instr) {
+         ctx->ssa_def[pdest->val] = node;
+      }
+
+      ++num_nodes;
+   }
+
+   dag_traverse_bottom_up(dag, sched_node_height, NULL);
+
+   ctx->live_chans = 0;
+   ctx->cycle = 0;
+
+   pco_instr *first_sched = NULL;
+
+   while (!list_is_empty(&dag->heads)) {
+      struct sched_node *node = sched_choose(ctx, dag);
+      pco_instr *instr = node->instr;
+
+      ctx->live_chans += sched_node_pressure_delta(ctx, node);
+      pco_foreach_instr_src_ssa (psrc, instr) {
+         if (ctx->ssa_def[psrc->val])
+            --ctx->ssa_region_uses[psrc->val];
+      }
+
+      ctx->cycle = MAX2(ctx->cycle, node->ready_cycle);
+      util_dynarray_foreach (&node->dag.edges, struct dag_edge, edge) {
+         struct sched_node *child = (struct sched_node *)edge->child;
+         child->ready_cycle =
+            MAX2(child->ready_cycle, ctx->cycle + (unsigned)edge->data);
+      }
+      ++ctx->cycle;
+
+      list_del(&instr->link);
+      list_addtail(&instr->link, end);
+      if (!first_sched)
+         first_sched = instr;
+
+      dag_prune_head(dag, &node->dag);
+      --num_nodes;
+   }
+
+   assert(!num_nodes);
+
+   /* Defs from this region are not visible to later regions. */
+   for (struct list_head *link = &first_sched->link; link != end;
+        link = link->next) {
+      pco_instr *instr = list_entry(link, pco_instr, link);
+      pco_foreach_instr_dest_ssa (pdest, instr) {
+         ctx->ssa_def[pdest->val] = NULL;
+         ctx->ssa_region_uses[pdest->val] = 0;
+      }
+   }
+
+   ralloc_free(mem_ctx);
+}
+
+static void sched_block(struct sched_ctx *ctx, pco_block *block)
+{
+   pco_instr *first = NULL;
+
+   pco_foreach_instr_in_block_safe (instr, block) {
+      if (!instr_is_barrier(instr)) {
+         if (!first)
+            first = instr;
+         continue;
+      }
+
+      if (first)
+         sched_region(ctx, block, first, instr);
+      first = NULL;
+   }
+
+   if (first)
+      sched_region(ctx, block, first, NULL);
+}
+
+static void count_ssa_uses(pco_func *func, unsigned *ssa_uses)
+{
+   pco_foreach_instr_in_func (instr, func) {
+      pco_foreach_instr_src_ssa (psrc, instr) {
+         ++ssa_uses[psrc->val];
+      }
+
+      if (instr->op == PCO_OP_PHI) {
+         pco_foreach_phi_src_in_instr (phi_src, instr) {
+            if (pco_ref_is_ssa(phi_src->ref))
+               ++ssa_uses[phi_src->ref.val];
+         }
+      }
+   }
+}
+
+/**
+ * \brief Reorders instructions to hide the latency of data return ops
+ *        while keeping register pressure in check.
+ *
+ * \param[in,out] func PCO function.
+ * \param[in] model Scheduling model.
+ */
+static void sched_func(pco_func *func, const struct pco_sched_model *model)
+{
+   struct sched_ctx ctx = {
+      .model = model,
+      .func = func,
+      .ssa_def = rzalloc_array(NULL, struct sched_node *, func->next_ssa),
+      .ssa_uses = rzalloc_array(NULL, unsigned, func->next_ssa),
+      .ssa_region_uses = rzalloc_array(NULL, unsigned, func->next_ssa),
+   };
+
+   count_ssa_uses(func, ctx.ssa_uses);
+
+   pco_foreach_block_in_func (block, func) {
+      sched_block(&ctx, block);
+   }
+
+   ralloc_free(ctx.ssa_region_uses);
+   ralloc_free(ctx.ssa_uses);
+   ralloc_free(ctx.ssa_def);
+}
+
+/**
+ * \brief Returns whether an instruction reads any of the pending data
+ *        return results.
+ */
+static bool instr_reads_pending(pco_instr *instr,
+                                const BITSET_WORD *pending)
+{
+   pco_foreach_instr_src_ssa (psrc, instr) {
+      if (BITSET_TEST(pending, psrc->val))
+         return true;
+   }
+
+   return false;
+}
+
+/**
+ * \brief Inserts the data fence waits for a block.
+ *
+ * Results of data return ops with SSA dests are only waited for right
+ * before they are first read, or before an instruction that can't be
+ * reordered with pending memory accesses, so the instructions scheduled in
+ * between execute while the data is in flight.
+ *
+ * \return True if any waits were inserted.
+ */
+static bool insert_waits(pco_func *func, pco_block *block, BITSET_WORD *pending)
 {
+   bool drc_pending[_PCO_DRC_COUNT] = { 0 };
+   bool any_pending = false;
    bool progress = false;
    pco_builder b;
 
-   pco_foreach_func_in_shader (func, shader) {
-      pco_foreach_instr_in_func_safe (instr, func) {
-         if (instr->op == PCO_OP_WDF || instr->op == PCO_OP_IDF)
-            continue;
+   pco_foreach_instr_in_block_safe (instr, block) {
+      if (instr->op == PCO_OP_WDF || instr->op == PCO_OP_IDF)
+         continue;
 
-         pco_foreach_instr_src (psrc, instr) {
-            if (!pco_ref_is_drc(*psrc))
-               continue;
+      bool returns_data = instr_returns_data(instr);
+      bool can_defer = returns_data && instr->num_dests > 0;
+      pco_foreach_instr_dest (pdest, instr) {
+         if (!pco_ref_is_ssa(*pdest))
+            can_defer = false;
+      }
 
-            b = pco_builder_create(func, pco_cursor_after_instr(instr));
+      if (any_pending && ((!instr_is_free(instr) && !can_defer) ||
+                          instr_reads_pending(instr, pending))) {
+         b = pco_builder_create(func, pco_cursor_before_instr(instr));
+         for (unsigned d = 0; d < _PCO_DRC_COUNT; ++d) {
+            if (drc_pending[d])
+               pco_wdf(&b, pco_ref_drc(d));
+            drc_pending[d] = false;
+         }
 
-            if ((instr->op == PCO_OP_ST32 || instr->op == PCO_OP_ST32_REGBL) &&
-                pco_instr_get_idf(instr)) {
-               pco_ref addr = pco_ref_chans(instr->src[3], 2);
-               pco_idf(&b, *psrc, addr);
-               pco_instr_set_idf(instr, false);
-            }
+         memset(pending, 0, BITSET_WORDS(func->next_ssa) * sizeof(*pending));
+         any_pending = false;
+      }
 
-            pco_wdf(&b, *psrc);
+      if (!returns_data)
+         continue;
 
-            progress = true;
+      pco_foreach_instr_src (psrc, instr) {
+         if (!pco_ref_is_drc(*psrc))
+            continue;
+
+         if (can_defer && psrc->val < _PCO_DRC_COUNT) {
+            drc_pending[psrc->val] = true;
+            any_pending = true;
+            pco_foreach_instr_dest_ssa (pdest, instr) {
+               BITSET_SET(pending, pdest->val);
+            }
             break;
          }
+
+         b = pco_builder_create(func, pco_cursor_after_instr(instr));
+
+         if ((instr->op == PCO_OP_ST32 || instr->op == PCO_OP_ST32_REGBL) &&
+             pco_instr_get_idf(instr)) {
+            pco_ref addr = pco_ref_chans(instr->src[3], 2);
+            pco_idf(&b, *psrc, addr);
+            pco_instr_set_idf(instr, false);
+         }
+
+         pco_wdf(&b, *psrc);
+         break;
       }
+
+      progress = true;
+   }
+
+   if (any_pending) {
+      b = pco_builder_create(func, pco_cursor_after_block(block));
+      for (unsigned d = 0; d < _PCO_DRC_COUNT; ++d) {
+         if (drc_pending[d])
+            pco_wdf(&b, pco_ref_drc(d));
+      }
+
+      memset(pending, 0, BITSET_WORDS(func->next_ssa) * sizeof(*pending));
+   }
+
+   return progress;
+}
+
+/**
+ * \brief Schedules instructions and inserts waits.
+ *
+ * \param[in,out] shader PCO shader.
+ * \return True if the pass made progress.
+ */
+bool pco_schedule(pco_shader *shader)
+{
+   const struct pco_sched_model *model =
+      pco_sched_model_for_dev(shader->ctx->dev_info);
+   bool progress = false;
+
+   pco_foreach_func_in_shader (func, shader) {
+      if (!PCO_DEBUG(NO_SCHED))
+         sched_func(func, model);
+
+      BITSET_WORD *pending =
+         rzalloc_array(NULL, BITSET_WORD, BITSET_WORDS(func->next_ssa));
+
+      pco_foreach_block_in_func (block, func) {
+         progress |= insert_waits(func, block, pending);
+      }
+
+      ralloc_free(pending);
    }
 
    return progress;
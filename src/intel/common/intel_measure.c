@@ -100,6 +100,8 @@ intel_measure_init(struct intel_measure_device *device)
       const char *interval_s = strstr(env_copy, "interval=");
       const char *batch_size_s = strstr(env_copy, "batch_size=");
       const char *buffer_size_s = strstr(env_copy, "buffer_size=");
+      const char *sample_s = strstr(env_copy, "sample=");
+      const char *binary_s = strstr(env_copy, "binary");
       const char *cpu_s = strstr(env_copy, "cpu");
       const char *no_ogl = strstr(env_copy, "nogl");
       while (true) {
@@ -211,9 +213,29 @@ intel_measure_init(struct intel_measure_device *device)
          config.buffer_size = buffer_size;
       }
 
+      if (sample_s) {
+         sample_s += 7;
+         const int sample_interval = atoi(sample_s);
+         if (sample_interval < 1) {
+            fprintf(stderr, "INTEL_MEASURE sample interval must be positive: "
+                    "%d\n", sample_interval);
+            abort();
+         }
+         config.sample_interval = sample_interval;
+      }
+
       if (cpu_s) {
          config.cpu_measure = true;
       }
+
+      if (binary_s) {
+         if (config.cpu_measure || !config.deferred_create_filename) {
+            fprintf(stderr, "INTEL_MEASURE binary output requires a file "
+                    "and gpu timestamps\n");
+            abort();
+         }
+         config.binary = true;
+      }
    }
 
    device->config = NULL;
@@ -332,6 +354,12 @@ intel_measure_state_changed(const struct intel_measure_batch *batch,
 void
 intel_measure_frame_transition(unsigned frame)
 {
+   /* restore the capture state that sampling disabled for the last frame */
+   if (config.sample_skipped) {
+      config.enabled = true;
+      config.sample_skipped = false;
+   }
+
    if (frame == config.start_frame)
       config.enabled = true;
    else if (frame == config.end_frame)
@@ -374,6 +402,12 @@ intel_measure_frame_transition(unsigned frame)
          }
       }
    }
+
+   if (config.enabled && config.sample_interval > 1 &&
+       frame % config.sample_interval != 0) {
+      config.enabled = false;
+      config.sample_skipped = true;
+   }
 }
 
 #define TIMESTAMP_BITS 36
@@ -615,6 +649,36 @@ print_combined_results(struct intel_measure_device *measure_device,
    const struct intel_measure_snapshot *begin = &start_result->snapshot;
    uint32_t renderpass = (start_result->primary_renderpass)
       ? start_result->primary_renderpass : begin->renderpass;
+
+   if (config.binary) {
+      struct intel_measure_binary_record record = {
+         .start_ts = start_result->start_ts,
+         .end_ts = current_result->end_ts,
+         .idle_ns = duration_idle_ns,
+         .time_ns = duration_time_ns,
+         .batch_size = start_result->batch_size,
+         .frame = start_result->frame,
+         .batch_count = start_result->batch_count,
+         .renderpass = renderpass,
+         .event_index = start_result->event_index,
+         .event_count = event_count,
+         .type = begin->type,
+         .count = begin->count,
+         .vs = begin->vs,
+         .tcs = begin->tcs,
+         .tes = begin->tes,
+         .gs = begin->gs,
+         .fs = begin->fs,
+         .cs = begin->cs,
+         .ms = begin->ms,
+         .ts = begin->ts,
+      };
+      strncpy(record.event_name, begin->event_name,
+              sizeof(record.event_name) - 1);
+      fwrite(&record, sizeof(record), 1, config.file);
+      return;
+   }
+
    fprintf(config.file, "%"PRIu64",%"PRIu64",%u,%u,%"PRIu64",%u,%u,%u,%s,%u,"
            "0x%x,0x%x,0x%x,0x%x,0x%x,0x%x,0x%x,0x%x,%.3lf,%.3lf\n",
            start_result->start_ts, current_result->end_ts,
@@ -665,7 +729,14 @@ intel_measure_print(struct intel_measure_device *device,
       free(config.deferred_create_filename);
       config.deferred_create_filename = NULL;
 
-      if (!config.cpu_measure)
+      if (config.binary) {
+         struct intel_measure_binary_header header = {
+            .magic = INTEL_MEASURE_BINARY_MAGIC,
+            .record_size = sizeof(struct intel_measure_binary_record),
+            .timestamp_frequency = info->timestamp_frequency,
+         };
+         fwrite(&header, sizeof(header), 1, config.file);
+      } else if (!config.cpu_measure)
          fputs("draw_start,draw_end,frame,batch,batch_size,renderpass,"
                "event_index,event_count,type,count,vs,tcs,tes,"
                "gs,fs,cs,ms,ts,idle_us,time_us\n",
@@ -109,6 +109,21 @@ struct intel_measure_config {
 
    /* Measure CPU timing, not GPU timing */
    bool                       cpu_measure;
+
+   /* Only collect one of every {num} frames while capture is enabled.  Set
+    * with INTEL_MEASURE=sample={num}
+    */
+   unsigned                   sample_interval;
+
+   /* true when capture is enabled, but the current frame was skipped by
+    * sample_interval
+    */
+   bool                       sample_skipped;
+
+   /* Write intel_measure_binary_record structs instead of csv.  Set with
+    * INTEL_MEASURE=binary
+    */
+   bool                       binary;
 };
 
 struct intel_measure_batch;
@@ -130,6 +145,33 @@ struct intel_measure_buffered_result {
 ;
 };
 
+#define INTEL_MEASURE_BINARY_MAGIC "INTELMS1"
+
+/* Layout of the output file with INTEL_MEASURE=binary.  The file begins with
+ * this header, followed by one record per line that would have been written
+ * to the csv.  All values are little endian.
+ */
+struct intel_measure_binary_header {
+   char magic[8];
+   uint32_t record_size;
+   uint32_t pad;
+   uint64_t timestamp_frequency;
+};
+
+struct intel_measure_binary_record {
+   uint64_t start_ts, end_ts;
+   uint64_t idle_ns, time_ns;
+   uint64_t batch_size;
+   uint32_t frame, batch_count, renderpass, event_index, event_count;
+   /* enum intel_measure_snapshot_type */
+   uint32_t type;
+   uint32_t count;
+   uint32_t vs, tcs, tes, gs, fs, cs, ms, ts;
+   uint32_t pad;
+   /* Truncated, NUL-terminated event name */
+   char event_name[24];
+};
+
 struct intel_measure_ringbuffer {
    unsigned head, tail;
    struct intel_measure_buffered_result results[0];
@@ -147,6 +147,7 @@ brw_compile_cs(const struct brw_compiler *compiler,
       .devinfo = compiler->devinfo,
       .prog_data = prog_data,
       .required_width = brw_required_dispatch_width(&nir->info),
+      .wide_first = devinfo->ver >= 30 || compiler->optimistic_simd_heuristic,
    };
 
    unsigned pressure[SIMD_COUNT];
@@ -162,7 +163,7 @@ brw_compile_cs(const struct brw_compiler *compiler,
    std::unique_ptr<brw_shader> v[3];
 
    for (unsigned i = 0; i < 3; i++) {
-      const unsigned simd = devinfo->ver >= 30 ? 2 - i : i;
+      const unsigned simd = brw_simd_compile_order(simd_state, i);
 
       if (!brw_simd_should_compile(simd_state, simd))
          continue;
@@ -199,7 +200,7 @@ brw_compile_cs(const struct brw_compiler *compiler,
          (!simd_state.compiled[simd - 1] && !brw_simd_should_compile(simd_state, simd - 1)) ||
          nir->info.workgroup_size_variable;
 
-      if (devinfo->ver < 30 || nir->info.workgroup_size_variable) {
+      if (!simd_state.wide_first || nir->info.workgroup_size_variable) {
          ASSERTED const int first = brw_simd_first_compiled(simd_state);
          assert(allow_spilling == (first < 0 || nir->info.workgroup_size_variable));
       }
@@ -207,7 +208,7 @@ brw_compile_cs(const struct brw_compiler *compiler,
       if (run_cs(*v[simd], allow_spilling)) {
          brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
 
-         if (devinfo->ver >= 30 && !v[simd]->spilled_any_registers &&
+         if (simd_state.wide_first && !v[simd]->spilled_any_registers &&
              !nir->info.workgroup_size_variable)
             break;
       } else {
@@ -333,6 +333,7 @@ brw_compile_task(const struct brw_compiler *compiler,
       .devinfo = compiler->devinfo,
       .prog_data = &prog_data->base,
       .required_width = brw_required_dispatch_width(&nir->info),
+      .wide_first = devinfo->ver >= 30 || compiler->optimistic_simd_heuristic,
    };
 
    brw_debug_archive_nir(params->base.archiver, nir, 0, "before-simd");
@@ -348,7 +349,7 @@ brw_compile_task(const struct brw_compiler *compiler,
    std::unique_ptr<brw_shader> v[3];
 
    for (unsigned i = 0; i < 3; i++) {
-      const unsigned simd = devinfo->ver >= 30 ? 2 - i : i;
+      const unsigned simd = brw_simd_compile_order(simd_state, i);
 
       if (!brw_simd_should_compile(simd_state, simd))
          continue;
@@ -385,7 +386,7 @@ brw_compile_task(const struct brw_compiler *compiler,
       if (run_task_mesh(*v[simd], allow_spilling)) {
          brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
 
-         if (devinfo->ver >= 30 && !v[simd]->spilled_any_registers)
+         if (simd_state.wide_first && !v[simd]->spilled_any_registers)
             break;
       } else {
          simd_state.error[simd] = ralloc_strdup(params->base.mem_ctx, v[simd]->fail_msg);
@@ -1057,6 +1058,7 @@ brw_compile_mesh(const struct brw_compiler *compiler,
       .devinfo = compiler->devinfo,
       .prog_data = &prog_data->base,
       .required_width = brw_required_dispatch_width(&nir->info),
+      .wide_first = devinfo->ver >= 30 || compiler->optimistic_simd_heuristic,
    };
 
    std::unique_ptr<brw_shader> v[3];
@@ -1064,7 +1066,7 @@ brw_compile_mesh(const struct brw_compiler *compiler,
    brw_debug_archive_nir(params->base.archiver, nir, 0, "before-simd");
 
    for (unsigned i = 0; i < 3; i++) {
-      const unsigned simd = devinfo->ver >= 30 ? 2 - i : i;
+      const unsigned simd = brw_simd_compile_order(simd_state, i);
 
       if (!brw_simd_should_compile(simd_state, simd))
          continue;
@@ -1105,7 +1107,7 @@ brw_compile_mesh(const struct brw_compiler *compiler,
       if (run_task_mesh(*v[simd], allow_spilling)) {
          brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
 
-         if (devinfo->ver >= 30 && !v[simd]->spilled_any_registers)
+         if (simd_state.wide_first && !v[simd]->spilled_any_registers)
             break;
       } else {
          simd_state.error[simd] = ralloc_strdup(params->base.mem_ctx, v[simd]->fail_msg);
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Compiles serialized NIR compute shaders with several variants of the
+ * backend and prints the statistics of each compilation as CSV, e.g. to
+ * compare scheduling heuristics on a corpus of shaders.
+ *
+ * The input files must contain the output of nir_serialize() for a shader
+ * that is ready for brw_compile_cs(), i.e. after all of the driver lowering.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "brw_compiler.h"
+#include "compiler/nir/nir.h"
+#include "compiler/nir/nir_serialize.h"
+#include "dev/intel_debug.h"
+#include "dev/intel_device_info.h"
+#include "util/blob.h"
+#include "util/os_file.h"
+#include "util/os_time.h"
+#include "util/ralloc.h"
+
+struct variant {
+   const char *name;
+   uint32_t pre_ra_schedule_modes;
+   bool no_bank_conflicts_opt;
+};
+
+static const struct variant variants[] = {
+   { "default",           0,                                         false },
+   { "no-bank-conflicts", 0,                                         true  },
+   { "latency-sensitive", BITFIELD_BIT(BRW_SCHEDULE_PRE_LATENCY),   false },
+   { "top-down",          BITFIELD_BIT(BRW_SCHEDULE_PRE),           false },
+   { "non-lifo",          BITFIELD_BIT(BRW_SCHEDULE_PRE_NON_LIFO),  false },
+   { "lifo",              BITFIELD_BIT(BRW_SCHEDULE_PRE_LIFO),      false },
+   { "none",              BITFIELD_BIT(BRW_SCHEDULE_NONE),          false },
+};
+
+static void
+log_nothing(void *data, unsigned *id, const char *fmt, ...)
+{
+}
+
+static bool
+compile_variant(struct brw_compiler *compiler, const char *path,
+                const void *data, size_t size, const struct variant *variant,
+                unsigned repeat)
+{
+   compiler->pre_ra_schedule_modes = variant->pre_ra_schedule_modes;
+   compiler->no_bank_conflicts_opt = variant->no_bank_conflicts_opt;
+
+   struct genisa_stats stats[3];
+   int64_t total_ns = 0;
+
+   for (unsigned r = 0; r < repeat; r++) {
+      void *mem_ctx = ralloc_context(NULL);
+
+      struct blob_reader reader;
+      blob_reader_init(&reader, data, size);
+      nir_shader *nir =
+         nir_deserialize(mem_ctx, &compiler->nir_options[MESA_SHADER_COMPUTE],
+                         &reader);
+      if (reader.overrun || !nir) {
+         fprintf(stderr, "%s: not a serialized NIR shader\n", path);
+         ralloc_free(mem_ctx);
+         return false;
+      }
+
+      if (nir->info.stage != MESA_SHADER_COMPUTE) {
+         fprintf(stderr, "%s: only compute shaders are supported, got %s\n",
+                 path, _mesa_shader_stage_to_string(nir->info.stage));
+         ralloc_free(mem_ctx);
+         return false;
+      }
+
+      struct brw_cs_prog_key key = {};
+      struct brw_cs_prog_data prog_data = {};
+      memset(stats, 0, sizeof(stats));
+
+      struct brw_compile_cs_params params = {
+         .base = {
+            .mem_ctx = mem_ctx,
+            .nir = nir,
+            .stats = stats,
+         },
+         .key = &key,
+         .prog_data = &prog_data,
+      };
+
+      const int64_t start = os_time_get_nano();
+      const unsigned *code = brw_compile_cs(compiler, &params);
+      total_ns += os_time_get_nano() - start;
+
+      if (!code) {
+         fprintf(stderr, "%s: %s failed to compile: %s\n", path,
+                 variant->name, params.base.error_str);
+         ralloc_free(mem_ctx);
+         return false;
+      }
+
+      ralloc_free(mem_ctx);
+   }
+
+   for (unsigned i = 0; i < ARRAY_SIZE(stats); i++) {
+      if (!stats[i].dispatch_width)
+         continue;
+
+      printf("%s,%s,%u,%u,%u,%u,%u,%u,%" PRId64 "\n",
+             path, variant->name, stats[i].dispatch_width, stats[i].instrs,
+             stats[i].cycle_count, stats[i].spill_count, stats[i].fill_count,
+             stats[i].send_messages, total_ns / repeat / 1000);
+   }
+
+   return true;
+}
+
+static void
+print_help(const char *progname, FILE *file)
+{
+   fprintf(file,
+           "Usage: %s [OPTION]... FILE...\n"
+           "Compile serialized NIR compute shaders with several backend\n"
+           "variants and print their statistics as CSV.\n\n"
+           "      --help             display this help and exit\n"
+           "      --gen=platform     compile for the given platform\n"
+           "                         (3 letter platform name)\n"
+           "      --variant=NAME     only compile the given variant, may be\n"
+           "                         repeated, default is all of them\n"
+           "      --repeat=N         compile each variant N times and report\n"
+           "                         the average compile time\n\n"
+           "Variants:\n",
+           progname);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(variants); i++)
+      fprintf(file, "      %s\n", variants[i].name);
+}
+
+int main(int argc, char *argv[])
+{
+   uint16_t pci_id = 0;
+   uint32_t variant_mask = 0;
+   unsigned repeat = 1;
+   int c;
+
+   bool help = false;
+   const struct option opts[] = {
+      { "help",          no_argument,       (int *) &help,      true },
+      { "gen",           required_argument, NULL,               'g' },
+      { "variant",       required_argument, NULL,               'v' },
+      { "repeat",        required_argument, NULL,               'r' },
+      { NULL,            0,                 NULL,                0 }
+   };
+
+   while ((c = getopt_long(argc, argv, ":g:v:r:h", opts, NULL)) != -1) {
+      switch (c) {
+      case 'g': {
+         const int id = intel_device_name_to_pci_device_id(optarg);
+         if (id < 0) {
+            fprintf(stderr, "can't parse gen: '%s', expected 3 letter "
+                            "platform name\n", optarg);
+            return EXIT_FAILURE;
+         }
+         pci_id = id;
+         break;
+      }
+      case 'v': {
+         unsigned i;
+         for (i = 0; i < ARRAY_SIZE(variants); i++) {
+            if (strcmp(optarg, variants[i].name) == 0)
+               break;
+         }
+         if (i == ARRAY_SIZE(variants)) {
+            fprintf(stderr, "unknown variant: '%s'\n", optarg);
+            return EXIT_FAILURE;
+         }
+         variant_mask |= BITFIELD_BIT(i);
+         break;
+      }
+      case 'r':
+         repeat = MAX2(atoi(optarg), 1);
+         break;
+      case 'h':
+         print_help(argv[0], stdout);
+         return EXIT_SUCCESS;
+      case 0:
+         break;
+      case ':':
+         fprintf(stderr, "%s: option `-%c' requires an argument\n",
+                 argv[0], optopt);
+         return EXIT_FAILURE;
+      case '?':
+      default:
+         fprintf(stderr, "%s: option `-%c' is invalid\n", argv[0], optopt);
+         return EXIT_FAILURE;
+      }
+   }
+
+   if (help || !pci_id || optind >= argc) {
+      print_help(argv[0], stderr);
+      return help ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+
+   if (!variant_mask)
+      variant_mask = BITFIELD_MASK(ARRAY_SIZE(variants));
+
+   struct intel_device_info devinfo;
+   if (!intel_get_device_info_from_pci_id(pci_id, &devinfo)) {
+      fprintf(stderr, "can't find device information: pci_id=0x%x\n", pci_id);
+      return EXIT_FAILURE;
+   }
+
+   if (devinfo.ver < 9) {
+      fprintf(stderr, "device has gfx version %d but must be >= 9\n",
+              devinfo.ver);
+      return EXIT_FAILURE;
+   }
+
+   process_intel_debug_variable();
+
+   void *mem_ctx = ralloc_context(NULL);
+   struct brw_compiler *compiler = brw_compiler_create(mem_ctx, &devinfo);
+   compiler->shader_debug_log = log_nothing;
+   compiler->shader_perf_log = log_nothing;
+
+   int result = EXIT_SUCCESS;
+
+   printf("file,variant,simd,instructions,cycles,spills,fills,sends,"
+          "compile_us\n");
+
+   for (int f = optind; f < argc; f++) {
+      size_t size;
+      char *data = os_read_file(argv[f], &size);
+      if (!data) {
+         fprintf(stderr, "Unable to read input file : %s\n", argv[f]);
+         result = EXIT_FAILURE;
+         continue;
+      }
+
+      u_foreach_bit(i, variant_mask) {
+         if (!compile_variant(compiler, argv[f], data, size, &variants[i],
+                              repeat))
+            result = EXIT_FAILURE;
+      }
+
+      free(data);
+   }
+
+   ralloc_free(mem_ctx);
+
+   return result;
+}
@@ -60,6 +60,15 @@ struct brw_storage_format {
    uint32_t isl_formats[3];
 };
 
+enum brw_instruction_scheduler_mode {
+   BRW_SCHEDULE_PRE_LATENCY,
+   BRW_SCHEDULE_PRE,
+   BRW_SCHEDULE_PRE_NON_LIFO,
+   BRW_SCHEDULE_PRE_LIFO,
+   BRW_SCHEDULE_POST,
+   BRW_SCHEDULE_NONE,
+};
+
 struct brw_compiler {
    const struct intel_device_info *devinfo;
 
@@ -140,6 +149,9 @@ struct brw_compiler {
     * Run-time performance of the shaders will be reduced since this
     * removes the ability to use a static analysis to estimate the
     * relative performance of the dispatch modes supported.
+    *
+    * For compute, task and mesh shaders, this makes pre-xe3 platforms
+    * try the widest SIMD first as well, see brw_simd_compile_order().
     */
    bool optimistic_simd_heuristic;
 
@@ -152,6 +164,18 @@ struct brw_compiler {
     */
    int spilling_rate;
 
+   /**
+    * Bitmask of the pre-RA scheduling heuristics (1 << BRW_SCHEDULE_*)
+    * brw_allocate_registers() may pick from.  Zero lets it try all of them.
+    * Only meant for comparing the heuristics, e.g. with brw_compile_stats.
+    */
+   uint32_t pre_ra_schedule_modes;
+
+   /**
+    * Skip brw_opt_bank_conflicts().  Only meant for measuring its effect.
+    */
+   bool no_bank_conflicts_opt;
+
    /**
     * We perform a quick register pressure estimate at the NIR level before
     * attempting backend compilation at various SIMD widths.  If the estimated
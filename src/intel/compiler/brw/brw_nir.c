@@ -1404,6 +1404,7 @@ brw_nir_optimize(nir_shader *nir,
       LOOP_OPT(nir_opt_copy_prop);
       LOOP_OPT(nir_opt_dce);
       LOOP_OPT(nir_opt_cse);
+      LOOP_OPT(nir_opt_pre, true);
       LOOP_OPT(nir_opt_combine_stores, nir_var_all);
 
       /* For indirect loads of uniforms (push constants), we assume that array
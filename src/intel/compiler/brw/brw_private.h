@@ -66,6 +66,11 @@ struct brw_simd_selection_state {
 
    unsigned required_width;
 
+   /* Try the widest SIMD first and stop at the first one which doesn't
+    * spill, instead of compiling every width and picking the best.
+    */
+   bool wide_first;
+
    const char *error[SIMD_COUNT];
 
    bool compiled[SIMD_COUNT];
@@ -89,6 +94,8 @@ inline bool brw_simd_any_compiled(const brw_simd_selection_state &state)
 
 unsigned brw_geometry_stage_dispatch_width(const struct intel_device_info *devinfo);
 
+unsigned brw_simd_compile_order(const brw_simd_selection_state &state, unsigned i);
+
 bool brw_simd_should_compile(brw_simd_selection_state &state, unsigned simd);
 
 void brw_simd_mark_compiled(brw_simd_selection_state &state, unsigned simd, bool spilled);
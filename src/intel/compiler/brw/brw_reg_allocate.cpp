@@ -311,7 +311,7 @@ private:
    void set_spill_costs();
    int choose_spill_reg();
    brw_reg alloc_spill_reg(unsigned size, int ip);
-   void spill_reg(unsigned spill_reg);
+   void spill_regs(const int *regs, unsigned count);
 
    void *mem_ctx;
    brw_shader *fs;
@@ -1105,6 +1105,15 @@ brw_reg_alloc::choose_spill_reg()
       return -1;
 
    assert(node >= first_vgrf_node);
+
+   /* We're about to replace all uses of this register.  It no longer
+    * conflicts with anything so we can get rid of its interference.  Doing
+    * it here lets the next choose_spill_reg() take it into account, even if
+    * the spill code isn't emitted yet.
+    */
+   ra_set_node_spill_cost(g, node, 0);
+   ra_reset_node_interference(g, node);
+
    return node - first_vgrf_node;
 }
 
@@ -1142,22 +1151,31 @@ brw_reg_alloc::alloc_spill_reg(unsigned size, int ip)
    return brw_vgrf(vgrf, BRW_TYPE_F);
 }
 
+/**
+ * Spills all of the given virtual registers, which have already been removed
+ * from the interference graph by choose_spill_reg().  This only walks the
+ * program once, no matter how many registers are spilled.
+ */
 void
-brw_reg_alloc::spill_reg(unsigned spill_reg)
+brw_reg_alloc::spill_regs(const int *regs, unsigned count)
 {
-   int size = fs->alloc.sizes[spill_reg];
-   unsigned int spill_offset = fs->last_scratch;
-   assert(align(spill_offset, 16) == spill_offset); /* oword read/write req. */
+   /* Scratch offset of every virtual register being spilled, or ~0u.  The
+    * registers allocated for the spill code are never spilled here, so only
+    * the ones that existed before are tracked.
+    */
+   const unsigned vgrf_count = fs->alloc.count;
+   unsigned *spill_offsets = ralloc_array(mem_ctx, unsigned, vgrf_count);
+   memset(spill_offsets, 0xff, vgrf_count * sizeof(unsigned));
 
-   fs->spilled_any_registers = true;
+   for (unsigned r = 0; r < count; r++) {
+      const int size = fs->alloc.sizes[regs[r]];
+      spill_offsets[regs[r]] = fs->last_scratch;
+      assert(align(fs->last_scratch, 16) == fs->last_scratch); /* oword read/write req. */
 
-   fs->last_scratch += align(size * REG_SIZE, REG_SIZE * reg_unit(devinfo));
+      fs->last_scratch += align(size * REG_SIZE, REG_SIZE * reg_unit(devinfo));
+   }
 
-   /* We're about to replace all uses of this register.  It no longer
-    * conflicts with anything so we can get rid of its interference.
-    */
-   ra_set_node_spill_cost(g, first_vgrf_node + spill_reg, 0);
-   ra_reset_node_interference(g, first_vgrf_node + spill_reg);
+   fs->spilled_any_registers = true;
 
    /* Generate spill/unspill instructions for the objects being
     * spilled.  Right now, we spill or unspill the whole thing to a
@@ -1172,7 +1190,9 @@ brw_reg_alloc::spill_reg(unsigned spill_reg)
 
       for (unsigned int i = 0; i < inst->sources; i++) {
 	 if (inst->src[i].file == VGRF &&
-             inst->src[i].nr == spill_reg) {
+             inst->src[i].nr < vgrf_count &&
+             spill_offsets[inst->src[i].nr] != ~0u) {
+            const unsigned spill_offset = spill_offsets[inst->src[i].nr];
             /* Count registers needed in units of physical registers */
             int count = align(regs_read(devinfo, inst, i), reg_unit(devinfo));
             /* Align the spilling offset the physical register size */
@@ -1211,8 +1231,10 @@ brw_reg_alloc::spill_reg(unsigned spill_reg)
       }
 
       if (inst->dst.file == VGRF &&
-          inst->dst.nr == spill_reg &&
+          inst->dst.nr < vgrf_count &&
+          spill_offsets[inst->dst.nr] != ~0u &&
           inst->opcode != SHADER_OPCODE_UNDEF) {
+         const unsigned spill_offset = spill_offsets[inst->dst.nr];
          /* Count registers needed in units of physical registers */
          int count = align(regs_written(inst), reg_unit(devinfo));
          /* Align the spilling offset the physical register size */
@@ -1282,6 +1304,8 @@ brw_reg_alloc::spill_reg(unsigned spill_reg)
    }
 
    assert(ip == live_instr_count);
+
+   ralloc_free(spill_offsets);
 }
 
 bool
@@ -1296,7 +1320,7 @@ brw_reg_alloc::assign_regs(bool allow_spilling, bool spill_all)
       if (unlikely(spill_all)) {
          int reg = choose_spill_reg();
          if (reg != -1) {
-            spill_reg(reg);
+            spill_regs(&reg, 1);
             spilled++;
             continue;
          }
@@ -1315,17 +1339,22 @@ brw_reg_alloc::assign_regs(bool allow_spilling, bool spill_all)
       if (compiler->spilling_rate)
          nr_spills = MAX2(1, spilled / compiler->spilling_rate);
 
-      for (unsigned j = 0; j < nr_spills; j++) {
+      int *regs = ralloc_array(mem_ctx, int, nr_spills);
+      unsigned count = 0;
+      while (count < nr_spills) {
          int reg = choose_spill_reg();
-         if (reg == -1) {
-            if (j == 0)
-               return false; /* Nothing to spill */
+         if (reg == -1)
             break;
-         }
 
-         spill_reg(reg);
-         spilled++;
+         regs[count++] = reg;
       }
+
+      if (count == 0)
+         return false; /* Nothing to spill */
+
+      spill_regs(regs, count);
+      spilled += count;
+      ralloc_free(regs);
    }
 
    if (spilled)
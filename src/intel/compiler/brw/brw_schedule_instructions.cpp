@@ -55,6 +55,9 @@
 
 static bool debug = false;
 
+/* Number of children searched for an existing edge in add_dep(). */
+#define MAX_DEP_LOOKBACK 16
+
 struct schedule_node_child;
 
 class schedule_node : public brw_exec_node
@@ -1044,7 +1047,15 @@ brw_instruction_scheduler::add_dep(schedule_node *before, schedule_node *after,
 
    assert(before != after);
 
-   for (int i = 0; i < before->children_count; i++) {
+   /* Only look for an existing edge among the most recently added children.
+    * Nodes like barriers or values with many readers can have thousands of
+    * children, and scanning all of them made building the DAG quadratic in
+    * the size of the block.  Duplicated edges are harmless: each one counts
+    * as a parent of "after" and is released when "before" is scheduled, and
+    * the latencies of all of them are applied.
+    */
+   const int lookback_end = MAX2(before->children_count - MAX_DEP_LOOKBACK, 0);
+   for (int i = before->children_count - 1; i >= lookback_end; i--) {
       schedule_node_child *child = &before->children[i];
       if (child->n == after) {
          child->effective_latency = MAX2(child->effective_latency, latency);
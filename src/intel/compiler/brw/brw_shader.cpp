@@ -1083,6 +1083,14 @@ brw_allocate_registers(brw_shader &s, bool allow_spilling)
       [BRW_SCHEDULE_NONE] = "none",
    };
 
+   /* Only the modes the compiler allows, if it restricts them at all. */
+   uint32_t allowed_modes = 0;
+   for (unsigned i = 0; i < ARRAY_SIZE(pre_modes); i++)
+      allowed_modes |= BITFIELD_BIT(pre_modes[i]);
+   const bool all_modes = !(s.compiler->pre_ra_schedule_modes & allowed_modes);
+   if (!all_modes)
+      allowed_modes &= s.compiler->pre_ra_schedule_modes;
+
    uint32_t best_register_pressure = UINT32_MAX;
    float best_perf = -INFINITY;
    unsigned best_press_idx = 0;
@@ -1118,17 +1126,21 @@ brw_allocate_registers(brw_shader &s, bool allow_spilling)
    for (unsigned i = 0; i < ARRAY_SIZE(pre_modes); i++) {
       enum brw_instruction_scheduler_mode sched_mode = pre_modes[i];
 
+      if (!(allowed_modes & BITFIELD_BIT(sched_mode)))
+         continue;
+
       /* Only use the PRE heuristic on pre-xe3 platforms during the
        * first pass, since the trade-off between EU thread count and
        * GRF use isn't a concern on platforms that don't support VRT.
        */
-      if (devinfo->ver < 30 && sched_mode != BRW_SCHEDULE_PRE)
+      if (all_modes && devinfo->ver < 30 && sched_mode != BRW_SCHEDULE_PRE)
          continue;
 
       /* These don't appear to provide much benefit on xe3+.
        */
-      if (devinfo->ver >= 30 && (sched_mode == BRW_SCHEDULE_PRE_LIFO ||
-                                 sched_mode == BRW_SCHEDULE_NONE))
+      if (all_modes && devinfo->ver >= 30 &&
+          (sched_mode == BRW_SCHEDULE_PRE_LIFO ||
+           sched_mode == BRW_SCHEDULE_NONE))
          continue;
 
       brw_schedule_instructions_pre_ra(s, sched, sched_mode);
@@ -1166,10 +1178,13 @@ brw_allocate_registers(brw_shader &s, bool allow_spilling)
       for (unsigned i = 0; i < ARRAY_SIZE(pre_modes); i++) {
          enum brw_instruction_scheduler_mode sched_mode = pre_modes[i];
 
+         if (!(allowed_modes & BITFIELD_BIT(sched_mode)))
+            continue;
+
          /* The latency-sensitive heuristic is unlikely to be helpful
           * if we failed to register-allocate.
           */
-         if (sched_mode == BRW_SCHEDULE_PRE_LATENCY)
+         if (all_modes && sched_mode == BRW_SCHEDULE_PRE_LATENCY)
             continue;
 
          /* Already tried to register-allocate this. */
@@ -1269,7 +1284,8 @@ brw_allocate_registers(brw_shader &s, bool allow_spilling)
       OPT(brw_lower_fill_and_spill);
    }
 
-   OPT(brw_opt_bank_conflicts);
+   if (!s.compiler->no_bank_conflicts_opt)
+      OPT(brw_opt_bank_conflicts);
    OPT_V(brw_schedule_instructions_post_ra);
 
    /* Lowering VGRF to FIXED_GRF is currently done as a separate pass instead
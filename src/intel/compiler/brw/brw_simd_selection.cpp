@@ -74,6 +74,28 @@ get_prog_data(brw_simd_selection_state &state)
 
 }
 
+/**
+ * Returns the SIMD to try in the i-th compilation.
+ *
+ * In wide_first mode, pre-Xe2 platforms start with SIMD16, because SIMD32
+ * is only used when required there.
+ */
+unsigned
+brw_simd_compile_order(const brw_simd_selection_state &state, unsigned i)
+{
+   assert(i < SIMD_COUNT);
+
+   if (!state.wide_first)
+      return i;
+
+   if (state.devinfo->ver < 20) {
+      static const unsigned order[SIMD_COUNT] = { 1, 0, 2 };
+      return order[i];
+   }
+
+   return SIMD_COUNT - 1 - i;
+}
+
 bool
 brw_simd_should_compile(brw_simd_selection_state &state, unsigned simd)
 {
@@ -396,3 +396,38 @@ TEST_F(SIMDSelectionCS, FirstCompiledIsSIMD32)
    ASSERT_TRUE(brw_simd_any_compiled(simd_state));
    ASSERT_EQ(brw_simd_first_compiled(simd_state), SIMD32);
 }
+
+TEST_F(SIMDSelectionCS, CompileOrder)
+{
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 0), SIMD8);
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 1), SIMD16);
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 2), SIMD32);
+}
+
+TEST_F(SIMDSelectionCS, WideFirstCompileOrder)
+{
+   simd_state.wide_first = true;
+
+   devinfo->ver = 12;
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 0), SIMD16);
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 1), SIMD8);
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 2), SIMD32);
+
+   devinfo->ver = 20;
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 0), SIMD32);
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 1), SIMD16);
+   ASSERT_EQ(brw_simd_compile_order(simd_state, 2), SIMD8);
+}
+
+TEST_F(SIMDSelectionCS, WideFirstFallsBackToSIMD8)
+{
+   simd_state.wide_first = true;
+
+   /* SIMD16 is tried first and fails without spilling. */
+   ASSERT_TRUE(brw_simd_should_compile(simd_state, SIMD16));
+   ASSERT_TRUE(brw_simd_should_compile(simd_state, SIMD8));
+   brw_simd_mark_compiled(simd_state, SIMD8, spilled);
+   ASSERT_FALSE(brw_simd_should_compile(simd_state, SIMD32));
+
+   ASSERT_EQ(brw_simd_select(simd_state), SIMD8);
+}
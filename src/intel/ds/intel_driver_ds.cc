@@ -126,31 +126,23 @@ static void
 sync_timestamp(IntelRenderpassDataSource::TraceContext &ctx,
                struct intel_ds_device *device)
 {
-   uint64_t cpu_ts, gpu_ts;
-   uint64_t boottime = perfetto::base::GetBootTimeNs().count();
-
-   if (boottime < device->next_clock_sync_ns)
-      return;
-
-   if (!intel_gem_read_correlate_cpu_gpu_timestamp(device->fd,
-                                                   device->info.kmd_type,
-                                                   INTEL_ENGINE_CLASS_RENDER, 0,
-                                                   CLOCK_BOOTTIME,
-                                                   &cpu_ts, &gpu_ts, NULL)) {
-      cpu_ts = perfetto::base::GetBootTimeNs().count();
-      intel_gem_read_render_timestamp(device->fd, device->info.kmd_type,
-                                      &gpu_ts);
-   }
-
    uint32_t cpu_clock_id = perfetto::protos::pbzero::BUILTIN_CLOCK_BOOTTIME;
-   gpu_ts = intel_device_info_timebase_scale(&device->info, gpu_ts);
-
-   PERFETTO_LOG("sending clocks gpu=0x%08x", device->gpu_clock_id);
 
-   device->next_clock_sync_ns = boottime + 1000000000ull;
-
-   MesaRenderpassDataSource<IntelRenderpassDataSource, IntelRenderpassTraits>::EmitClockSync(ctx,
-      cpu_ts, gpu_ts, cpu_clock_id, device->gpu_clock_id);
+   MesaRenderpassDataSource<IntelRenderpassDataSource, IntelRenderpassTraits>::MaybeEmitClockSync(ctx,
+      device->next_clock_sync_ns, MESA_RENDERPASS_CLOCK_SYNC_PERIOD_NS,
+      cpu_clock_id, device->gpu_clock_id,
+      [device](uint64_t &cpu_ts, uint64_t &gpu_ts) {
+         if (!intel_gem_read_correlate_cpu_gpu_timestamp(device->fd,
+                                                         device->info.kmd_type,
+                                                         INTEL_ENGINE_CLASS_RENDER, 0,
+                                                         CLOCK_BOOTTIME,
+                                                         &cpu_ts, &gpu_ts, NULL)) {
+            cpu_ts = perfetto::base::GetBootTimeNs().count();
+            intel_gem_read_render_timestamp(device->fd, device->info.kmd_type,
+                                            &gpu_ts);
+         }
+         gpu_ts = intel_device_info_timebase_scale(&device->info, gpu_ts);
+      });
 }
 
 static void
@@ -29,6 +29,7 @@
 #include "dev/intel_debug.h"
 #include "genxml/genX_bits.h"
 #include "util/log.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_math.h"
 
 #include "isl.h"
@@ -43,6 +44,7 @@
 
 isl_genX_declare_get_func(surf_fill_state_s)
 isl_genX_declare_get_func(buffer_fill_state_s)
+isl_genX_declare_get_func(buffer_fill_states_s)
 isl_genX_declare_get_func(emit_depth_stencil_hiz_s)
 isl_genX_declare_get_func(null_fill_state_s)
 isl_genX_declare_get_func(emit_cpb_control_s)
@@ -56,6 +58,15 @@ isl_memcpy_linear_to_tiled(uint32_t xt1, uint32_t xt2,
                            enum isl_tiling tiling,
                            isl_memcpy_type copy_type)
 {
+#ifdef USE_AVX2
+   if (util_get_cpu_caps()->has_avx2) {
+      _isl_memcpy_linear_to_tiled_avx2(
+         xt1, xt2, yt1, yt2, dst, src, dst_pitch, src_pitch, has_swizzling,
+         tiling, copy_type);
+      return;
+   }
+#endif
+
 #ifdef USE_SSE41
    if (copy_type == ISL_MEMCPY_STREAMING_LOAD) {
       _isl_memcpy_linear_to_tiled_sse41(
@@ -79,6 +90,15 @@ isl_memcpy_tiled_to_linear(uint32_t xt1, uint32_t xt2,
                            enum isl_tiling tiling,
                            isl_memcpy_type copy_type)
 {
+#ifdef USE_AVX2
+   if (util_get_cpu_caps()->has_avx2) {
+      _isl_memcpy_tiled_to_linear_avx2(
+         xt1, xt2, yt1, yt2, dst, src, dst_pitch, src_pitch, has_swizzling,
+         tiling, copy_type);
+      return;
+   }
+#endif
+
 #ifdef USE_SSE41
    if (copy_type == ISL_MEMCPY_STREAMING_LOAD) {
       _isl_memcpy_tiled_to_linear_sse41(
@@ -421,6 +441,7 @@ isl_device_init(struct isl_device *dev,
 
    dev->surf_fill_state_s = isl_surf_fill_state_s_get_func(dev);
    dev->buffer_fill_state_s = isl_buffer_fill_state_s_get_func(dev);
+   dev->buffer_fill_states_s = isl_buffer_fill_states_s_get_func(dev);
    dev->emit_depth_stencil_hiz_s = isl_emit_depth_stencil_hiz_s_get_func(dev);
    dev->null_fill_state_s = isl_null_fill_state_s_get_func(dev);
    dev->emit_cpb_control_s = isl_emit_cpb_control_s_get_func(dev);
@@ -1362,6 +1362,11 @@ struct isl_device {
    void (*buffer_fill_state_s)(const struct isl_device *dev, void *state,
                                const struct isl_buffer_fill_state_info *restrict info);
 
+   void (*buffer_fill_states_s)(const struct isl_device *dev, void *state,
+                                uint32_t state_stride_B,
+                                const struct isl_buffer_fill_state_info *infos,
+                                uint32_t count);
+
    void (*emit_depth_stencil_hiz_s)(const struct isl_device *dev, void *batch,
                                     const struct isl_depth_stencil_hiz_emit_info *restrict info);
 
@@ -2864,6 +2869,13 @@ isl_surf_get_ccs_surf(const struct isl_device *dev,
 #define isl_buffer_fill_state_s(dev, state, info) \
    (dev)->buffer_fill_state_s(dev, state, info);
 
+/* Fill count buffer surface states, state_stride_B bytes apart. Consecutive
+ * infos with the same format, stride, swizzle & usage share most of the
+ * packing work.
+ */
+#define isl_buffer_fill_states_s(dev, state, state_stride_B, infos, count) \
+   (dev)->buffer_fill_states_s(dev, state, state_stride_B, infos, count);
+
 #define isl_null_fill_state(dev, state, ...) \
    (dev)->null_fill_state_s(dev, state, \
                             &(struct isl_null_fill_state_info) {  __VA_ARGS__ });
@@ -40,6 +40,12 @@ void
 isl_genX(buffer_fill_state_s)(const struct isl_device *dev, void *state,
                               const struct isl_buffer_fill_state_info *restrict info);
 
+void
+isl_genX(buffer_fill_states_s)(const struct isl_device *dev, void *state,
+                               uint32_t state_stride_B,
+                               const struct isl_buffer_fill_state_info *infos,
+                               uint32_t count);
+
 void
 isl_genX(emit_depth_stencil_hiz_s)(const struct isl_device *dev, void *batch,
                                    const struct isl_depth_stencil_hiz_emit_info *restrict info);
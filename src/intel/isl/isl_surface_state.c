@@ -978,9 +978,120 @@ isl_genX(surf_fill_state_s)(const struct isl_device *dev, void *state,
    GENX(RENDER_SURFACE_STATE_pack)(NULL, state, &s);
 }
 
-void
-isl_genX(buffer_fill_state_s)(const struct isl_device *dev, void *state,
-                              const struct isl_buffer_fill_state_info *restrict info)
+/* Fields of a buffer surface state that only depend on how the buffer is
+ * accessed, not on which range of memory it covers.
+ */
+static void
+buffer_fill_template(const struct isl_device *dev,
+                     struct GENX(RENDER_SURFACE_STATE) *s,
+                     const struct isl_buffer_fill_state_info *restrict info)
+{
+   s->SurfaceFormat = info->format;
+
+   s->SurfaceType = SURFTYPE_BUFFER;
+#if GFX_VERx10 >= 125
+   if (info->is_scratch) {
+      /* From the BSpec:
+       *
+       *    "For surfaces of type SURFTYPE_SCRATCH, valid range of pitch is:
+       *    [63,262143] -> [64B, 256KB].  Also, for SURFTYPE_SCRATCH, the
+       *    pitch must be a multiple of 64bytes."
+       */
+      assert(info->format == ISL_FORMAT_RAW);
+      assert(info->stride_B % 64 == 0);
+      assert(info->stride_B <= 256 * 1024);
+      s->SurfaceType = SURFTYPE_SCRATCH;
+   }
+#else
+   assert(!info->is_scratch);
+#endif
+
+   s->SurfacePitch = info->stride_B - 1;
+
+#if GFX_VER >= 6
+   s->SurfaceVerticalAlignment = isl_encode_valign(4);
+#if GFX_VERx10 >= 125
+   s->SurfaceHorizontalAlignment = isl_encode_halign(128);
+#elif GFX_VER >= 7
+   s->SurfaceHorizontalAlignment = isl_encode_halign(4);
+   s->SurfaceArray = false;
+#endif
+#endif
+
+#if GFX_VER >= 6
+   s->NumberofMultisamples = MULTISAMPLECOUNT_1;
+#endif
+
+#if (GFX_VER >= 8)
+   s->TileMode = LINEAR;
+#else
+   s->TiledSurface = false;
+#endif
+
+#if (GFX_VER >= 8)
+   s->RenderCacheReadWriteMode = WriteOnlyCache;
+#else
+   s->RenderCacheReadWriteMode = 0;
+#endif
+
+#if GFX_VERx10 >= 200
+   s->EnableSamplerRoutetoLSC = isl_format_support_sampler_route_to_lsc(info->format);
+   /* Per-application override.
+    *
+    * Bspec 57023: "Enable Sampler Route to LSC" programming note states that,
+    * this bit can be set for surface type SURFTYPE_2D or SURFTYPE_BUFFER.
+    */
+   s->EnableSamplerRoutetoLSC &= dev->sampler_route_to_lsc;
+#endif /* if GFX_VERx10 >= 200 */
+
+#if GFX_VERx10 >= 125
+   /* Setting L1 caching policy to Write-back or Write-through mode. */
+   s->L1CacheControl =
+      (dev->l1_storage_wt && (info->usage & ISL_SURF_USAGE_STORAGE_BIT)) ?
+      L1CC_WT : L1CC_WB;
+#endif
+
+#if (GFX_VERx10 >= 75)
+   struct isl_swizzle swz = isl_get_shader_channel_select(info->format,
+                                                          info->swizzle);
+
+   s->ShaderChannelSelectRed = (enum GENX(ShaderChannelSelect)) swz.r;
+   s->ShaderChannelSelectGreen = (enum GENX(ShaderChannelSelect)) swz.g;
+   s->ShaderChannelSelectBlue = (enum GENX(ShaderChannelSelect)) swz.b;
+   s->ShaderChannelSelectAlpha = (enum GENX(ShaderChannelSelect)) swz.a;
+#endif
+
+#if GFX_VER >= 9
+   /* Wa_14019708328: all SURFTYPE_BUFFERs has AuxiliarySurfaceMode ==
+    * AUX_NONE so no need to check for it. In case workaround is not needed
+    * and buffer_length_in_aux_addr is false, it will set
+    * AuxiliarySurfaceBaseAddress to 0.
+    */
+   if (!dev->buffer_length_in_aux_addr)
+      s->AuxiliarySurfaceBaseAddress = dev->dummy_aux_address;
+#else
+   assert(!dev->buffer_length_in_aux_addr);
+#endif
+}
+
+static inline bool
+buffer_fill_template_matches(const struct isl_buffer_fill_state_info *a,
+                             const struct isl_buffer_fill_state_info *b)
+{
+   return a->format == b->format &&
+          a->stride_B == b->stride_B &&
+          a->is_scratch == b->is_scratch &&
+          a->usage == b->usage &&
+          a->swizzle.r == b->swizzle.r &&
+          a->swizzle.g == b->swizzle.g &&
+          a->swizzle.b == b->swizzle.b &&
+          a->swizzle.a == b->swizzle.a;
+}
+
+static void
+buffer_fill_range(const struct isl_device *dev,
+                  struct GENX(RENDER_SURFACE_STATE) *s,
+                  const struct isl_buffer_fill_state_info *restrict info)
 {
    uint64_t buffer_size = info->size_B;
 
@@ -1036,83 +1147,23 @@ isl_genX(buffer_fill_state_s)(const struct isl_device *dev, void *state,
       }
    }
 
-   struct GENX(RENDER_SURFACE_STATE) s = { 0, };
-
-   s.SurfaceFormat = info->format;
-
-   s.SurfaceType = SURFTYPE_BUFFER;
-#if GFX_VERx10 >= 125
-   if (info->is_scratch) {
-      /* From the BSpec:
-       *
-       *    "For surfaces of type SURFTYPE_SCRATCH, valid range of pitch is:
-       *    [63,262143] -> [64B, 256KB].  Also, for SURFTYPE_SCRATCH, the
-       *    pitch must be a multiple of 64bytes."
-       */
-      assert(info->format == ISL_FORMAT_RAW);
-      assert(info->stride_B % 64 == 0);
-      assert(info->stride_B <= 256 * 1024);
-      s.SurfaceType = SURFTYPE_SCRATCH;
-   }
-#else
-   assert(!info->is_scratch);
-#endif
-
-   s.SurfacePitch = info->stride_B - 1;
-
-#if GFX_VER >= 6
-   s.SurfaceVerticalAlignment = isl_encode_valign(4);
-#if GFX_VERx10 >= 125
-   s.SurfaceHorizontalAlignment = isl_encode_halign(128);
-#elif GFX_VER >= 7
-   s.SurfaceHorizontalAlignment = isl_encode_halign(4);
-   s.SurfaceArray = false;
-#endif
-#endif
-
 #if GFX_VER >= 9
-   s.Height = ((num_elements - 1) >> 7) & 0x3fff;
-   s.Width = (num_elements - 1) & 0x7f;
-   s.Depth = ((num_elements - 1) >> 21) & 0x7ff;
+   s->Height = ((num_elements - 1) >> 7) & 0x3fff;
+   s->Width = (num_elements - 1) & 0x7f;
+   s->Depth = ((num_elements - 1) >> 21) & 0x7ff;
 #elif GFX_VER >= 7
-   s.Height = ((num_elements - 1) >> 7) & 0x3fff;
-   s.Width = (num_elements - 1) & 0x7f;
-   s.Depth = ((num_elements - 1) >> 21) & 0x3ff;
+   s->Height = ((num_elements - 1) >> 7) & 0x3fff;
+   s->Width = (num_elements - 1) & 0x7f;
+   s->Depth = ((num_elements - 1) >> 21) & 0x3ff;
 #else
-   s.Height = ((num_elements - 1) >> 7) & 0x1fff;
-   s.Width = (num_elements - 1) & 0x7f;
-   s.Depth = ((num_elements - 1) >> 20) & 0x7f;
+   s->Height = ((num_elements - 1) >> 7) & 0x1fff;
+   s->Width = (num_elements - 1) & 0x7f;
+   s->Depth = ((num_elements - 1) >> 20) & 0x7f;
 #endif
 
+   s->SurfaceBaseAddress = info->address;
 #if GFX_VER >= 6
-   s.NumberofMultisamples = MULTISAMPLECOUNT_1;
-#endif
-
-#if (GFX_VER >= 8)
-   s.TileMode = LINEAR;
-#else
-   s.TiledSurface = false;
-#endif
-
-#if (GFX_VER >= 8)
-   s.RenderCacheReadWriteMode = WriteOnlyCache;
-#else
-   s.RenderCacheReadWriteMode = 0;
-#endif
-
-#if GFX_VERx10 >= 200
-   s.EnableSamplerRoutetoLSC = isl_format_support_sampler_route_to_lsc(info->format);
-   /* Per-application override.
-    *
-    * Bspec 57023: "Enable Sampler Route to LSC" programming note states that,
-    * this bit can be set for surface type SURFTYPE_2D or SURFTYPE_BUFFER.
-    */
-   s.EnableSamplerRoutetoLSC &= dev->sampler_route_to_lsc;
-#endif /* if GFX_VERx10 >= 200 */
-
-   s.SurfaceBaseAddress = info->address;
-#if GFX_VER >= 6
-   s.MOCS = info->mocs;
+   s->MOCS = info->mocs;
 #endif
 
 #if GFX_VER >= 9
@@ -1122,39 +1173,45 @@ isl_genX(buffer_fill_state_s)(const struct isl_device *dev, void *state,
     */
    if (dev->buffer_length_in_aux_addr) {
       assert(intel_needs_workaround(dev->info, 14019708328) == false);
-      s.AuxiliarySurfaceBaseAddress = info->size_B << 32;
-   } else {
-      /* Wa_14019708328: all SURFTYPE_BUFFERs has
-       * AuxiliarySurfaceMode == AUX_NONE so no need to check for it.
-       * In case workaround is not needed and buffer_length_in_aux_addr is
-       * false, it will set AuxiliarySurfaceBaseAddress to 0.
-       */
-      s.AuxiliarySurfaceBaseAddress = dev->dummy_aux_address;
+      s->AuxiliarySurfaceBaseAddress = info->size_B << 32;
    }
-#else
-   assert(!dev->buffer_length_in_aux_addr);
-#endif
-
-#if GFX_VERx10 >= 125
-   /* Setting L1 caching policy to Write-back or Write-through mode. */
-   s.L1CacheControl =
-      (dev->l1_storage_wt && (info->usage & ISL_SURF_USAGE_STORAGE_BIT)) ?
-      L1CC_WT : L1CC_WB;
 #endif
+}
 
-#if (GFX_VERx10 >= 75)
-   struct isl_swizzle swz = isl_get_shader_channel_select(info->format,
-                                                          info->swizzle);
+void
+isl_genX(buffer_fill_state_s)(const struct isl_device *dev, void *state,
+                              const struct isl_buffer_fill_state_info *restrict info)
+{
+   struct GENX(RENDER_SURFACE_STATE) s = { 0, };
 
-   s.ShaderChannelSelectRed = (enum GENX(ShaderChannelSelect)) swz.r;
-   s.ShaderChannelSelectGreen = (enum GENX(ShaderChannelSelect)) swz.g;
-   s.ShaderChannelSelectBlue = (enum GENX(ShaderChannelSelect)) swz.b;
-   s.ShaderChannelSelectAlpha = (enum GENX(ShaderChannelSelect)) swz.a;
-#endif
+   buffer_fill_template(dev, &s, info);
+   buffer_fill_range(dev, &s, info);
 
    GENX(RENDER_SURFACE_STATE_pack)(NULL, state, &s);
 }
 
+void
+isl_genX(buffer_fill_states_s)(const struct isl_device *dev, void *state,
+                               uint32_t state_stride_B,
+                               const struct isl_buffer_fill_state_info *infos,
+                               uint32_t count)
+{
+   struct GENX(RENDER_SURFACE_STATE) s = { 0, };
+
+   for (uint32_t i = 0; i < count; i++) {
+      /* Only redo the access dependent part of the state when it changes,
+       * arrays of descriptors usually share it.
+       */
+      if (i == 0 || !buffer_fill_template_matches(&infos[i - 1], &infos[i])) {
+         s = (struct GENX(RENDER_SURFACE_STATE)) { 0, };
+         buffer_fill_template(dev, &s, &infos[i]);
+      }
+      buffer_fill_range(dev, &s, &infos[i]);
+
+      GENX(RENDER_SURFACE_STATE_pack)(NULL, state + i * state_stride_B, &s);
+   }
+}
+
 void
 isl_genX(null_fill_state_s)(const struct isl_device *dev, void *state,
                             const struct isl_null_fill_state_info *restrict info)
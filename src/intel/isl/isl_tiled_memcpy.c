@@ -36,7 +36,9 @@
 #include "util/rounding.h"
 #include "isl_priv.h"
 
-#if defined(__SSSE3__)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
 #include <tmmintrin.h>
 #elif defined(__SSE2__)
 #include <emmintrin.h>
@@ -1310,6 +1312,18 @@ _memcpy_streaming_load(void *dest, const void *src, size_t count)
       _mm_storeu_si128((__m128i *)dest, val);
       return dest;
    } else if (count == 64) {
+#if defined(INLINE_AVX2)
+      /* X-tiled spans are cacheline aligned in the tile, so this only falls
+       * back to 16-byte loads for oddly aligned mappings.
+       */
+      if (util_ptr_is_aligned(src, 32)) {
+         __m256i val0 = _mm256_stream_load_si256(((__m256i *)src) + 0);
+         __m256i val1 = _mm256_stream_load_si256(((__m256i *)src) + 1);
+         _mm256_storeu_si256(((__m256i *)dest) + 0, val0);
+         _mm256_storeu_si256(((__m256i *)dest) + 1, val1);
+         return dest;
+      }
+#endif
       __m128i val0 = _mm_stream_load_si128(((__m128i *)src) + 0);
       __m128i val1 = _mm_stream_load_si128(((__m128i *)src) + 1);
       __m128i val2 = _mm_stream_load_si128(((__m128i *)src) + 2);
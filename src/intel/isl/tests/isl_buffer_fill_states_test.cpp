@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "dev/intel_device_info.h"
+#include "isl/isl.h"
+
+class BufferFillStates : public ::testing::TestWithParam<int> {
+protected:
+   void SetUp() override {
+      ASSERT_TRUE(intel_get_device_info_from_pci_id(GetParam(), &devinfo));
+      isl_device_init(&dev, &devinfo);
+   }
+
+   struct intel_device_info devinfo;
+   struct isl_device dev;
+};
+
+static struct isl_buffer_fill_state_info
+make_info(const struct isl_device *dev, uint64_t address, uint64_t size_B,
+          enum isl_format format, uint32_t stride_B,
+          isl_surf_usage_flags_t usage)
+{
+   struct isl_buffer_fill_state_info info = {};
+   info.address = address;
+   info.size_B = size_B;
+   info.mocs = isl_mocs(dev, usage, false);
+   info.format = format;
+   info.swizzle = ISL_SWIZZLE_IDENTITY;
+   info.stride_B = stride_B;
+   info.usage = usage;
+   return info;
+}
+
+TEST_P(BufferFillStates, MatchesSingleFills)
+{
+   const struct isl_buffer_fill_state_info infos[] = {
+      make_info(&dev, 0x10000, 256, ISL_FORMAT_RAW, 1,
+                ISL_SURF_USAGE_CONSTANT_BUFFER_BIT),
+      make_info(&dev, 0x20040, 1023, ISL_FORMAT_RAW, 1,
+                ISL_SURF_USAGE_CONSTANT_BUFFER_BIT),
+      make_info(&dev, 0x30000, 4096, ISL_FORMAT_RAW, 1,
+                ISL_SURF_USAGE_STORAGE_BIT),
+      make_info(&dev, 0x40000, 1 << 20, ISL_FORMAT_R32G32B32A32_FLOAT, 16,
+                ISL_SURF_USAGE_TEXTURE_BIT),
+      make_info(&dev, 0x50000, 16, ISL_FORMAT_R32G32B32A32_FLOAT, 16,
+                ISL_SURF_USAGE_TEXTURE_BIT),
+      make_info(&dev, 0x60000, 6, ISL_FORMAT_RAW, 1,
+                ISL_SURF_USAGE_STORAGE_BIT),
+   };
+   const uint32_t count = ARRAY_SIZE(infos);
+   const uint32_t stride = 2 * dev.ss.size;
+
+   uint8_t expected[ARRAY_SIZE(infos) * 2 * 64] = {};
+   uint8_t actual[ARRAY_SIZE(infos) * 2 * 64] = {};
+   ASSERT_LE(stride * count, sizeof(expected));
+
+   for (uint32_t i = 0; i < count; i++)
+      isl_buffer_fill_state_s(&dev, expected + i * stride, &infos[i]);
+
+   isl_buffer_fill_states_s(&dev, actual, stride, infos, count);
+
+   for (uint32_t i = 0; i < count; i++) {
+      EXPECT_EQ(memcmp(expected + i * stride, actual + i * stride,
+                       dev.ss.size), 0) << "surface state " << i;
+   }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+   Intel, BufferFillStates,
+   ::testing::Values(0x1912 /* SKL GT2 */,
+                     0x8a52 /* ICL GT2 */,
+                     0x9a49 /* TGL GT2 */,
+                     0x5690 /* DG2 */,
+                     0x6420 /* LNL */));
@@ -24,6 +24,7 @@
 #include <gtest/gtest.h>
 #include <inttypes.h>
 
+#include "util/u_cpu_detect.h"
 #include "util/u_math.h"
 #include "isl/isl.h"
 #include "isl/isl_priv.h"
@@ -198,6 +199,7 @@ protected:
    uint32_t linear_sz;
    uint32_t fmt_bs; /* format bytes per block */
    TILE_CONV conv;
+   isl_memcpy_type copy_type;
    struct tile_swizzle_ops ops;
    bool print_results;
    struct isl_tile_info tile_info;
@@ -205,7 +207,8 @@ protected:
 public:
    void test_setup(TILE_CONV convert, enum isl_tiling tiling_fmt,
               enum isl_format format,
-              uint32_t max_width, uint32_t max_height);
+              uint32_t max_width, uint32_t max_height,
+              isl_memcpy_type type = ISL_MEMCPY);
    void TearDown();
    uint32_t swizzle_bitops(uint32_t num, uint8_t field,
                            uint8_t curr_ind, uint8_t swizzle_ind);
@@ -240,12 +243,14 @@ void tileTFixture::test_setup(TILE_CONV convert,
                          enum isl_tiling tiling_fmt,
                          enum isl_format format,
                          uint32_t max_width,
-                         uint32_t max_height)
+                         uint32_t max_height,
+                         isl_memcpy_type type)
 {
    print_results = debug_get_bool_option("ISL_TEST_DEBUG", false);
 
    const struct isl_format_layout *fmtl = isl_format_get_layout(format);
    conv = convert;
+   copy_type = type;
    fmt_bs = fmtl->bpb / 8;
    ops.tiling = tiling_fmt;
 
@@ -335,13 +340,13 @@ void tileTFixture::convert_texture(uint32_t x1_el, uint32_t x2_el, uint32_t y1_e
                                  (char *)buf_dst,
                                  (const char *)buf_src + linear_offset_B,
                                  tiled_pitch_B, linear_pitch_B,
-                                 0, ops.tiling, ISL_MEMCPY);
+                                 0, ops.tiling, copy_type);
    else
       isl_memcpy_tiled_to_linear(x1_el * fmt_bs, x2_el * fmt_bs, y1_el, y2_el,
                                  (char *)buf_dst + linear_offset_B,
                                  (const char *)buf_src,
                                  linear_pitch_B, tiled_pitch_B,
-                                 0, ops.tiling, ISL_MEMCPY);
+                                 0, ops.tiling, copy_type);
 
    if (print_results) {
       printf("/************** Printing dest **************/\n");
@@ -443,6 +448,41 @@ TEST_P(tileXFixture, tiletolin)
     run_test(x1, x2, y1, y2);
 }
 
+#ifdef USE_SSE41
+TEST_P(tileYFixture, tiletolin_streaming)
+{
+    if (!util_get_cpu_caps()->has_sse4_1)
+       GTEST_SKIP() << "streaming loads require SSE4.1";
+
+    auto [x1, x2, y1, y2] = GetParam();
+    test_setup(TILE_TO_LIN, ISL_TILING_Y0, IMAGE_FORMAT, x2, y2,
+               ISL_MEMCPY_STREAMING_LOAD);
+    run_test(x1, x2, y1, y2);
+}
+
+TEST_P(tile4Fixture, tiletolin_streaming)
+{
+    if (!util_get_cpu_caps()->has_sse4_1)
+       GTEST_SKIP() << "streaming loads require SSE4.1";
+
+    auto [x1, x2, y1, y2] = GetParam();
+    test_setup(TILE_TO_LIN, ISL_TILING_4, IMAGE_FORMAT, x2, y2,
+               ISL_MEMCPY_STREAMING_LOAD);
+    run_test(x1, x2, y1, y2);
+}
+
+TEST_P(tileXFixture, tiletolin_streaming)
+{
+    if (!util_get_cpu_caps()->has_sse4_1)
+       GTEST_SKIP() << "streaming loads require SSE4.1";
+
+    auto [x1, x2, y1, y2] = GetParam();
+    test_setup(TILE_TO_LIN, ISL_TILING_X, IMAGE_FORMAT, x2, y2,
+               ISL_MEMCPY_STREAMING_LOAD);
+    run_test(x1, x2, y1, y2);
+}
+#endif
+
 TEST_P(tileWFixture, lintotile)
 {
     auto [x1, x2, y1, y2] = GetParam();
@@ -98,6 +98,29 @@ void genX(write_3DPRIMITIVE_EXTENDED)(global void *dst_ptr,
 }
 #endif
 
+#if GFX_VERx10 >= 125
+void genX(write_3DMESH_3D)(global uint32_t *dst_ptr,
+                           bool is_predicated,
+                           uint32_t thread_group_count_x,
+                           uint32_t thread_group_count_y,
+                           uint32_t thread_group_count_z,
+                           uint32_t param_draw_id)
+{
+   struct GENX(3DMESH_3D) v = {
+      GENX(3DMESH_3D_header),
+      .PredicateEnable = is_predicated,
+      .ExtendedParameter0Present = true,
+      .ThreadGroupCountX = thread_group_count_x,
+      .ThreadGroupCountY = thread_group_count_y,
+      .ThreadGroupCountZ = thread_group_count_z,
+   };
+   /* The pack function doesn't know about the extended parameter dword. */
+   v.DWordLength += 1;
+   GENX(3DMESH_3D_pack)(dst_ptr, &v);
+   dst_ptr[GENX(3DMESH_3D_length)] = param_draw_id;
+}
+#endif
+
 void genX(write_MI_BATCH_BUFFER_START)(global void *dst_ptr, uint64_t addr)
 {
    struct GENX(MI_BATCH_BUFFER_START) v = {
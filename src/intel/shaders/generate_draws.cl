@@ -84,6 +84,19 @@ genX(libanv_write_draw)(global void *dst_base,
       }
 #endif
 
+#if GFX_VERx10 >= 125
+      if (flags & ANV_GENERATED_FLAG_MESH) {
+         VkDrawMeshTasksIndirectCommandEXT data =
+            *((global VkDrawMeshTasksIndirectCommandEXT *)indirect_ptr);
+
+         genX(write_3DMESH_3D)(dst_ptr + inst_offset_B,
+                               is_predicated,
+                               data.groupCountX,
+                               data.groupCountY,
+                               data.groupCountZ,
+                               draw_id);
+      } else
+#endif
       genX(write_draw)(dst_ptr + inst_offset_B,
                        indirect_ptr, draw_id_ptr,
                        draw_id, instance_multiplier,
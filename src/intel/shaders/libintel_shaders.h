@@ -46,6 +46,8 @@ enum anv_generated_draw_flags {
    ANV_GENERATED_FLAG_WA_16011107343 = BITFIELD_BIT(7),
    /* Wa_22018402687 */
    ANV_GENERATED_FLAG_WA_22018402687 = BITFIELD_BIT(8),
+   /* Generate 3DMESH_3D instead of 3DPRIMITIVE (Gfx12.5+) */
+   ANV_GENERATED_FLAG_MESH           = BITFIELD_BIT(9),
 };
 
 /**
@@ -93,6 +95,15 @@ void genX(write_3DPRIMITIVE_EXTENDED)(global void *dst_ptr,
                                       uint32_t param_draw_id);
 #endif
 
+#if GFX_VERx10 >= 125
+void genX(write_3DMESH_3D)(global uint32_t *dst_ptr,
+                           bool is_predicated,
+                           uint32_t thread_group_count_x,
+                           uint32_t thread_group_count_y,
+                           uint32_t thread_group_count_z,
+                           uint32_t param_draw_id);
+#endif
+
 void genX(write_MI_BATCH_BUFFER_START)(global void *dst_ptr, uint64_t addr);
 
 void genX(write_draw)(global uint32_t *dst_ptr,
@@ -27,6 +27,9 @@
  *
  * Replay with :
  *    $ intel_hang_replay -d error_state.dmp
+ *
+ * Measure the execution time of the captured batch with :
+ *    $ intel_hang_replay -d error_state.dmp -r 100
  */
 
 #include <fcntl.h>
@@ -50,6 +53,7 @@
 #include "drm-uapi/i915_drm.h"
 
 #include "util/u_dynarray.h"
+#include "util/os_time.h"
 #include "util/u_math.h"
 
 #include "intel_hang_replay_xe.h"
@@ -244,6 +248,8 @@ print_help(const char *filename, FILE *f)
    fprintf(f, "    -h, --help         print this screen\n");
    fprintf(f, "    -a, --address ADDR Find BO containing ADDR\n");
    fprintf(f, "    -D, --dumpable     add DRM_XE_VM_BIND_FLAG_DUMPABLE to all VMA binds\n");
+   fprintf(f, "    -r, --repeat N     replay the batch N times, restoring the captured state\n"
+              "                       before each run, and print execution time statistics\n");
 }
 
 static int
@@ -278,9 +284,20 @@ execbuffer(int drm_fd,
    return ret;
 }
 
+static void
+gem_context_destroy(int drm_fd, uint32_t ctx_id)
+{
+   struct drm_i915_gem_context_destroy destroy = {
+      .ctx_id = ctx_id,
+   };
+
+   intel_ioctl(drm_fd, DRM_IOCTL_I915_GEM_CONTEXT_DESTROY, &destroy);
+}
+
 static int process_i915_dmp_file(int file_fd, int drm_fd, struct util_dynarray *buffers,
                                  void *mem_ctx, struct intel_hang_dump_block_exec *init,
-                                 struct intel_hang_dump_block_exec *exec) {
+                                 struct intel_hang_dump_block_exec *exec,
+                                 uint32_t repeat) {
    void *hw_img = NULL;
    uint32_t hw_img_size = 0;
 
@@ -300,19 +317,6 @@ static int process_i915_dmp_file(int file_fd, int drm_fd, struct util_dynarray *
       gem_allocated += bo->size;
    }
 
-   uint32_t ctx_id = gem_context_create(drm_fd);
-   if (ctx_id == 0) {
-      fprintf(stderr, "fail to create context: %s\n", strerror(errno));
-      return EXIT_FAILURE;
-   }
-
-   if (hw_img != NULL) {
-      if (!gem_context_set_hw_image(drm_fd, ctx_id, hw_img, hw_img_size)) {
-         fprintf(stderr, "fail to set context hw img: %s\n", strerror(errno));
-         return EXIT_FAILURE;
-      }
-   }
-
    struct util_dynarray execbuffer_bos;
    util_dynarray_init(&execbuffer_bos, mem_ctx);
 
@@ -352,51 +356,91 @@ static int process_i915_dmp_file(int file_fd, int drm_fd, struct util_dynarray *
    struct drm_i915_gem_exec_object2 *execbuf_bo =
       util_dynarray_grow(&execbuffer_bos, struct drm_i915_gem_exec_object2, 1);
 
+   uint64_t *durations_ns = repeat > 1 ?
+      rzalloc_array(mem_ctx, uint64_t, repeat) : NULL;
    int ret;
 
-   if (init_bo) {
-      fprintf(stderr, "init: 0x%016"PRIx64"\n", init_bo->offset);
-      *execbuf_bo = (struct drm_i915_gem_exec_object2) {
-         .handle           = init_bo->gem_handle,
-         .relocation_count = 0,
-         .relocs_ptr       = 0,
-         .flags            = EXEC_OBJECT_SUPPORTS_48B_ADDRESS |
-                             EXEC_OBJECT_PINNED |
-                             EXEC_OBJECT_CAPTURE,
-         .offset           = intel_canonical_address(init_bo->offset),
-      };
-      ret = execbuffer(drm_fd, ctx_id, &execbuffer_bos, init_bo, init->offset);
-      if (ret != 0) {
-         fprintf(stderr, "initialization buffer failed to execute errno=%i\n", errno);
-         exit(-1);
+   for (uint32_t r = 0; r < MAX2(repeat, 1); r++) {
+      /* Every run starts from the captured memory & context state so that
+       * the replayed batch does the same work each time.
+       */
+      if (r > 0) {
+         util_dynarray_foreach(buffers, struct gem_bo, bo) {
+            if (bo->hw_img || bo->file_offset == 0)
+               continue;
+            lseek(file_fd, bo->file_offset, SEEK_SET);
+            write_gem_bo_data(drm_fd, bo->gem_handle, file_fd, bo->size);
+         }
       }
-   } else {
-      fprintf(stderr, "no init BO\n");
-   }
 
-   if (batch_bo) {
-      fprintf(stderr, "exec: 0x%016"PRIx64" aperture=%.2fMb\n", batch_bo->offset,
-              gem_allocated / 1024.0 / 1024.0);
-      *execbuf_bo = (struct drm_i915_gem_exec_object2) {
-         .handle           = batch_bo->gem_handle,
-         .relocation_count = 0,
-         .relocs_ptr       = 0,
-         .flags            = EXEC_OBJECT_SUPPORTS_48B_ADDRESS |
-                             EXEC_OBJECT_PINNED |
-                             EXEC_OBJECT_CAPTURE,
-         .offset           = intel_canonical_address(batch_bo->offset),
-      };
-      ret = execbuffer(drm_fd, ctx_id, &execbuffer_bos, batch_bo, exec->offset);
-      if (ret != 0) {
-         fprintf(stderr, "replayed buffer failed to execute errno=%i\n", errno);
-         exit(-1);
-      } else {
-         fprintf(stderr, "exec completed successfully\n");
+      uint32_t ctx_id = gem_context_create(drm_fd);
+      if (ctx_id == 0) {
+         fprintf(stderr, "fail to create context: %s\n", strerror(errno));
+         return EXIT_FAILURE;
       }
-   } else {
-      fprintf(stderr, "no exec BO\n");
+
+      if (hw_img != NULL) {
+         if (!gem_context_set_hw_image(drm_fd, ctx_id, hw_img, hw_img_size)) {
+            fprintf(stderr, "fail to set context hw img: %s\n", strerror(errno));
+            return EXIT_FAILURE;
+         }
+      }
+
+      if (init_bo) {
+         if (r == 0)
+            fprintf(stderr, "init: 0x%016"PRIx64"\n", init_bo->offset);
+         *execbuf_bo = (struct drm_i915_gem_exec_object2) {
+            .handle           = init_bo->gem_handle,
+            .relocation_count = 0,
+            .relocs_ptr       = 0,
+            .flags            = EXEC_OBJECT_SUPPORTS_48B_ADDRESS |
+                                EXEC_OBJECT_PINNED |
+                                EXEC_OBJECT_CAPTURE,
+            .offset           = intel_canonical_address(init_bo->offset),
+         };
+         ret = execbuffer(drm_fd, ctx_id, &execbuffer_bos, init_bo, init->offset);
+         if (ret != 0) {
+            fprintf(stderr, "initialization buffer failed to execute errno=%i\n", errno);
+            exit(-1);
+         }
+      } else if (r == 0) {
+         fprintf(stderr, "no init BO\n");
+      }
+
+      if (batch_bo) {
+         if (r == 0) {
+            fprintf(stderr, "exec: 0x%016"PRIx64" aperture=%.2fMb\n", batch_bo->offset,
+                    gem_allocated / 1024.0 / 1024.0);
+         }
+         *execbuf_bo = (struct drm_i915_gem_exec_object2) {
+            .handle           = batch_bo->gem_handle,
+            .relocation_count = 0,
+            .relocs_ptr       = 0,
+            .flags            = EXEC_OBJECT_SUPPORTS_48B_ADDRESS |
+                                EXEC_OBJECT_PINNED |
+                                EXEC_OBJECT_CAPTURE,
+            .offset           = intel_canonical_address(batch_bo->offset),
+         };
+         int64_t start_ns = os_time_get_nano();
+         ret = execbuffer(drm_fd, ctx_id, &execbuffer_bos, batch_bo, exec->offset);
+         if (ret != 0) {
+            fprintf(stderr, "replayed buffer failed to execute errno=%i\n", errno);
+            exit(-1);
+         } else if (durations_ns) {
+            durations_ns[r] = os_time_get_nano() - start_ns;
+         } else {
+            fprintf(stderr, "exec completed successfully\n");
+         }
+      } else if (r == 0) {
+         fprintf(stderr, "no exec BO\n");
+      }
+
+      gem_context_destroy(drm_fd, ctx_id);
    }
 
+   if (durations_ns)
+      print_replay_timings(stdout, durations_ns, repeat);
+
    return EXIT_SUCCESS;
 }
 
@@ -405,7 +449,7 @@ replay_dmp_file(int file_fd, int drm_fd, const struct intel_device_info *devinfo
                 struct util_dynarray *buffers, void *mem_ctx,
                 struct intel_hang_dump_block_exec *init,
                 struct intel_hang_dump_block_exec *exec,
-                uint32_t vm_flags, uint32_t bo_dumpable)
+                uint32_t vm_flags, uint32_t bo_dumpable, uint32_t repeat)
 {
    /* Sort buffers by size */
    qsort(util_dynarray_begin(buffers),
@@ -414,10 +458,11 @@ replay_dmp_file(int file_fd, int drm_fd, const struct intel_device_info *devinfo
          compare_bos);
 
    if (devinfo->kmd_type == INTEL_KMD_TYPE_I915)
-      return process_i915_dmp_file(file_fd, drm_fd, buffers, mem_ctx, init, exec);
+      return process_i915_dmp_file(file_fd, drm_fd, buffers, mem_ctx, init, exec,
+                                   repeat);
    else if (devinfo->kmd_type == INTEL_KMD_TYPE_XE)
       return process_xe_dmp_file(file_fd, drm_fd, devinfo, buffers, mem_ctx, init, exec,
-                                 vm_flags, bo_dumpable);
+                                 vm_flags, bo_dumpable, repeat);
    else
       fprintf(stderr, "driver is unknown, exiting\n");
 
@@ -434,6 +479,7 @@ main(int argc, char *argv[])
       { "shader",     required_argument, NULL, 's' },
       { "list",       no_argument,       NULL, 'l' },
       { "dumpable",   no_argument,       0,    'D'},
+      { "repeat",     required_argument, NULL, 'r' },
       { "help",       no_argument,       NULL, 'h' },
       { NULL,         0,                 NULL,   0 },
    };
@@ -447,8 +493,9 @@ main(int argc, char *argv[])
    const char *file = NULL;
    uint64_t check_addr = -1;
    uint32_t vm_flags = -1;
+   uint32_t repeat = 1;
    int c, i;
-   while ((c = getopt_long(argc, argv, "a:d:hlDs:", aubinator_opts, &i)) != -1) {
+   while ((c = getopt_long(argc, argv, "a:d:hlDr:s:", aubinator_opts, &i)) != -1) {
       switch (c) {
       case 'a':
          check_addr = strtol(optarg, NULL, 0);
@@ -471,6 +518,9 @@ main(int argc, char *argv[])
       case 'D':
          bo_dumpable = true;
          break;
+      case 'r':
+         repeat = MAX2(strtoul(optarg, NULL, 0), 1);
+         break;
       default:
          break;
       }
@@ -661,7 +711,8 @@ main(int argc, char *argv[])
    }
 
    if (!list && util_dynarray_num_elements(&shader_addresses, uint64_t) == 0)
-      replay_dmp_file(file_fd, drm_fd, &devinfo, &buffers, mem_ctx, &init, &exec, vm_flags, bo_dumpable);
+      replay_dmp_file(file_fd, drm_fd, &devinfo, &buffers, mem_ctx, &init, &exec, vm_flags, bo_dumpable,
+                      repeat);
 
    close(drm_fd);
    close(file_fd);
@@ -5,6 +5,9 @@
 
 #include "intel_hang_replay_lib.h"
 
+#include <math.h>
+#include <stdlib.h>
+
 int
 compare_bos(const void *b1, const void *b2)
 {
@@ -32,3 +35,42 @@ write_malloc_data(void *out_data,
    }
    assert(total_read_len == size);
 }
+
+static int
+compare_durations(const void *d1, const void *d2)
+{
+   const uint64_t a = *(const uint64_t *)d1, b = *(const uint64_t *)d2;
+
+   return (a > b) - (a < b);
+}
+
+/* Print statistics about the replayed batch execution times. The durations
+ * are sorted in place.
+ */
+void
+print_replay_timings(FILE *f, uint64_t *durations_ns, uint32_t count)
+{
+   if (count == 0)
+      return;
+
+   qsort(durations_ns, count, sizeof(*durations_ns), compare_durations);
+
+   double mean = 0.0;
+   for (uint32_t i = 0; i < count; i++)
+      mean += durations_ns[i];
+   mean /= count;
+
+   double variance = 0.0;
+   for (uint32_t i = 0; i < count; i++)
+      variance += (durations_ns[i] - mean) * (durations_ns[i] - mean);
+   variance /= count;
+
+   const double median = (count % 2) ? durations_ns[count / 2] :
+      (durations_ns[count / 2 - 1] + durations_ns[count / 2]) / 2.0;
+
+   fprintf(f, "runs=%u min=%.3fus median=%.3fus mean=%.3fus max=%.3fus "
+              "stddev=%.3fus (%.2f%%)\n",
+           count, durations_ns[0] / 1000.0, median / 1000.0, mean / 1000.0,
+           durations_ns[count - 1] / 1000.0, sqrt(variance) / 1000.0,
+           mean > 0.0 ? 100.0 * sqrt(variance) / mean : 0.0);
+}
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdio.h>
 #include <inttypes.h>
 #include <sys/mman.h>
 #include <sys/types.h>
@@ -26,3 +27,4 @@ struct gem_bo {
 int compare_bos(const void *b1, const void *b2);
 void skip_data(int file_fd, size_t size);
 void write_malloc_data(void *out_data, int file_fd, size_t size);
+void print_replay_timings(FILE *f, uint64_t *durations_ns, uint32_t count);
@@ -8,6 +8,9 @@
 #include "drm-uapi/xe_drm.h"
 #include "common/intel_gem.h"
 #include "intel_hang_replay_lib.h"
+#include "util/macros.h"
+#include "util/os_time.h"
+#include "util/ralloc.h"
 
 static int syncobj_wait(int drm_fd, uint32_t *handles, uint32_t count, uint64_t abs_timeout_nsec,
                         uint32_t flags)
@@ -283,7 +286,7 @@ process_xe_dmp_file(int file_fd, int drm_fd, const struct intel_device_info *dev
                     struct util_dynarray *buffers, void *mem_ctx,
                     struct intel_hang_dump_block_exec *init,
                     struct intel_hang_dump_block_exec *block_exec,
-                    uint32_t vm_flags, uint32_t bo_dumpable)
+                    uint32_t vm_flags, uint32_t bo_dumpable, uint32_t repeat)
 {
    void *hw_img = NULL;
    uint32_t hw_img_size = 0;
@@ -374,26 +377,58 @@ process_xe_dmp_file(int file_fd, int drm_fd, const struct intel_device_info *dev
       }
    }
 
-   if (hw_img) {
-      exec_queue = xe_create_exec_queue_and_set_hw_image(drm_fd, vm, hw_img, hw_img_size);
-      if (exec_queue == 0) {
-         fprintf(stderr, "error: dump file didn't include a hw image context, exiting... %s\n", strerror(errno));
-            return EXIT_FAILURE;
-      }
-   }
-
-   exec.exec_queue_id = exec_queue;
-   exec.address = block_exec->offset;
-
    /* wait for last bind */
    syncobj_wait(drm_fd, &sync.handle, 1, INT64_MAX, 0);
    syncobj_reset(drm_fd, &sync.handle, 1);
 
-   xe_exec(drm_fd, &exec);
-   syncobj_wait(drm_fd, &sync.handle, 1, INT64_MAX, 0);
+   uint64_t *durations_ns = repeat > 1 ?
+      rzalloc_array(mem_ctx, uint64_t, repeat) : NULL;
+
+   for (uint32_t r = 0; r < MAX2(repeat, 1); r++) {
+      /* Every run starts from the captured memory & context state so that
+       * the replayed batch does the same work each time.
+       */
+      if (r > 0) {
+         util_dynarray_foreach(buffers, struct gem_bo, bo) {
+            if (bo->hw_img || bo->file_offset == 0)
+               continue;
+
+            lseek(file_fd, bo->file_offset, SEEK_SET);
+            if (bo->props.mem_type == INTEL_HANG_DUMP_BLOCK_MEM_TYPE_USERPTR) {
+               write_malloc_data((void *)(uintptr_t)bo->offset, file_fd, bo->size);
+            } else if (bo->gem_handle != 0) {
+               write_xe_bo_data(drm_fd, bo->gem_handle, file_fd, bo->size,
+                                bo->props.pat_index, devinfo);
+            }
+         }
+      }
+
+      if (hw_img) {
+         exec_queue = xe_create_exec_queue_and_set_hw_image(drm_fd, vm, hw_img, hw_img_size);
+         if (exec_queue == 0) {
+            fprintf(stderr, "error: dump file didn't include a hw image context, exiting... %s\n", strerror(errno));
+               return EXIT_FAILURE;
+         }
+      }
+
+      exec.exec_queue_id = exec_queue;
+      exec.address = block_exec->offset;
+
+      int64_t start_ns = os_time_get_nano();
+      xe_exec(drm_fd, &exec);
+      syncobj_wait(drm_fd, &sync.handle, 1, INT64_MAX, 0);
+      if (durations_ns)
+         durations_ns[r] = os_time_get_nano() - start_ns;
+      syncobj_reset(drm_fd, &sync.handle, 1);
+
+      if (hw_img)
+         xe_exec_queue_destroy(drm_fd, exec.exec_queue_id);
+   }
+
+   if (durations_ns)
+      print_replay_timings(stdout, durations_ns, repeat);
 
    syncobj_destroy(drm_fd, sync.handle);
-   xe_exec_queue_destroy(drm_fd, exec.exec_queue_id);
    xe_vm_destroy(drm_fd, vm);
 
    if (hw_img)
@@ -16,4 +16,5 @@ bool process_xe_dmp_file(int file_fd, int drm_fd, const struct intel_device_info
                          struct util_dynarray *buffers, void *mem_ctx,
                          struct intel_hang_dump_block_exec *init,
                          struct intel_hang_dump_block_exec *exec,
-                         uint32_t  vm_uapi_flags, uint32_t bo_dumpable);
+                         uint32_t  vm_uapi_flags, uint32_t bo_dumpable,
+                         uint32_t repeat);
@@ -96,8 +96,9 @@ print_help(const char *progname, FILE *file)
       "      `intel_monitor -e -f eustall.csv` in separate console.\n"
       "   3. When enough data has been collected, close intel_monitor by pressing any key.\n"
       "   4. Correlate eustall data in eustall.csv with shader instructions in asm.txt by\n"
-      "      matching instruction offsets. Use data to determine which instructions are\n"
-      "      stalling and why.\n"
+      "      matching instruction offsets, e.g. with\n"
+      "      `intel_monitor_annotate.py asm.txt eustall.csv [--hash <src_hash>]`. Use data\n"
+      "      to determine which instructions are stalling and why.\n"
       "\n"
       "Eu stall defintions:\n"
       "tdr_count        - Number of cycles EU stalled, with at least one thread waiting\n"
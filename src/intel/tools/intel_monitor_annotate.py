@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+# Copyright 2024 Mesa contributors
+# SPDX-License-Identifier: MIT
+#
+# Annotates shader assembly dumped with INTEL_DEBUG=shaders-lineno with the
+# EU stall samples collected by `intel_monitor -e`.  Both files use offsets
+# relative to the instruction base address, so stall IPs can be matched
+# directly against the disassembly.
+
+from __future__ import annotations
+
+import argparse
+import csv
+import re
+import sys
+
+STALL_REASONS = ['tdr_count', 'other_count', 'control_count',
+                 'pipestall_count', 'send_count', 'dist_acc_count',
+                 'sbid_count', 'sync_count', 'inst_fetch_count',
+                 'active_count']
+
+SHADER_RE = re.compile(r'^Dumping shader asm for (\S+)(?: SIMD(\d+))? '
+                       r'\(src_hash 0x([0-9a-fA-F]+)\):')
+INST_RE = re.compile(r'^0x([0-9a-fA-F]+): (.*)$')
+
+
+class Shader:
+    def __init__(self, stage: str, simd: str | None, src_hash: int):
+        self.stage = stage
+        self.simd = simd
+        self.src_hash = src_hash
+        self.lines: list[tuple[int | None, str]] = []
+
+    def name(self) -> str:
+        simd = f' SIMD{self.simd}' if self.simd else ''
+        return f'{self.stage}{simd} (src_hash 0x{self.src_hash:08x})'
+
+    def offsets(self):
+        return (off for off, _ in self.lines if off is not None)
+
+
+def parse_asm(path: str) -> list[Shader]:
+    shaders = []
+    shader = None
+    with open(path, 'r', errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            m = SHADER_RE.match(line)
+            if m:
+                shader = Shader(m.group(1), m.group(2), int(m.group(3), 16))
+                shaders.append(shader)
+                continue
+            if shader is None:
+                continue
+            m = INST_RE.match(line)
+            if m:
+                shader.lines.append((int(m.group(1), 16), m.group(2)))
+            elif line.startswith('LABEL') or line.startswith('   ERROR'):
+                shader.lines.append((None, line))
+    return shaders
+
+
+def parse_stalls(path: str) -> dict[int, dict[str, int]]:
+    stalls = {}
+    with open(path, 'r') as f:
+        for row in csv.DictReader(f):
+            counts = {r: int(row[r]) for r in STALL_REASONS}
+            counts['sum'] = int(row['sum'])
+            stalls[int(row['offset'], 16)] = counts
+    return stalls
+
+
+def main_reason(counts: dict[str, int]) -> str:
+    reason = max(STALL_REASONS, key=lambda r: counts[r])
+    return reason[:-len('_count')] if counts[reason] else ''
+
+
+def print_shader(shader: Shader, stalls: dict[int, dict[str, int]],
+                 width: int, out):
+    total = sum(stalls[o]['sum'] for o in shader.offsets() if o in stalls)
+    if total == 0:
+        return
+    peak = max(stalls[o]['sum'] for o in shader.offsets() if o in stalls)
+
+    out.write(f'\n{shader.name()}: {total} samples\n\n')
+    for offset, text in shader.lines:
+        if offset is None:
+            out.write(f'{"":>{width + 37}}{text}\n')
+            continue
+        counts = stalls.get(offset)
+        if counts is None or counts['sum'] == 0:
+            out.write(f'{"":>{width + 25}}0x{offset:08x}: {text}\n')
+            continue
+        bar = '#' * max(1, counts['sum'] * width // peak)
+        pct = 100.0 * counts['sum'] / total
+        out.write(f'{bar:<{width}} {pct:5.1f}% {main_reason(counts):>16} '
+                  f'0x{offset:08x}: {text}\n')
+
+
+def print_top(shaders: list[Shader], stalls: dict[int, dict[str, int]],
+              count: int, out):
+    owner = {}
+    for shader in shaders:
+        for offset, text in shader.lines:
+            if offset is not None:
+                owner[offset] = (shader, text)
+
+    total = sum(c['sum'] for c in stalls.values())
+    if total == 0:
+        return
+    hot = sorted(stalls.items(), key=lambda kv: kv[1]['sum'], reverse=True)
+    out.write(f'{"samples":>10} {"pct":>6} {"reason":>16} {"offset":>10}  '
+              'shader / instruction\n')
+    for offset, counts in hot[:count]:
+        shader, text = owner.get(offset, (None, '<unknown>'))
+        name = shader.name() if shader else '<unknown shader>'
+        out.write(f'{counts["sum"]:>10} {100.0 * counts["sum"] / total:5.1f}% '
+                  f'{main_reason(counts):>16} 0x{offset:08x}  {name}\n'
+                  f'{"":>47}{text}\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Annotate shader assembly with intel_monitor EU stall samples')
+    parser.add_argument('asm', help='stderr of the application run with '
+                        'INTEL_DEBUG=shaders-lineno')
+    parser.add_argument('stalls', help='csv written by intel_monitor -e')
+    parser.add_argument('--hash', type=lambda h: int(h, 16),
+                        help='only annotate shaders with this source hash')
+    parser.add_argument('--top', type=int, metavar='N',
+                        help='list the N instructions with the most samples '
+                        'instead of annotating the assembly')
+    parser.add_argument('--width', type=int, default=20,
+                        help='width of the histogram bars. DEFAULT=20')
+    args = parser.parse_args()
+
+    shaders = parse_asm(args.asm)
+    if args.hash is not None:
+        shaders = [s for s in shaders if s.src_hash == args.hash]
+    stalls = parse_stalls(args.stalls)
+
+    if args.top:
+        if args.hash is not None:
+            offsets = {o for s in shaders for o in s.offsets()}
+            stalls = {o: c for o, c in stalls.items() if o in offsets}
+        print_top(shaders, stalls, args.top, sys.stdout)
+        return
+
+    # Hottest shaders first
+    def shader_total(s):
+        return sum(stalls[o]['sum'] for o in s.offsets() if o in stalls)
+    for shader in sorted(shaders, key=shader_total, reverse=True):
+        print_shader(shader, stalls, args.width, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
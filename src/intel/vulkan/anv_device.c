@@ -999,6 +999,9 @@ VkResult anv_CreateDevice(
 
    simple_mtx_init(&device->accel_struct_build.mutex, mtx_plain);
 
+   if (device->vk.enabled_features.hostImageCopy)
+      anv_device_init_host_copy_queue(device);
+
    *pDevice = anv_device_to_handle(device);
 
    return VK_SUCCESS;
@@ -1130,6 +1133,9 @@ void anv_DestroyDevice(
    /* Do TRTT batch garbage collection before destroying queues. */
    anv_device_finish_trtt(device);
 
+   if (util_queue_is_initialized(&device->host_copy_queue))
+      util_queue_destroy(&device->host_copy_queue);
+
    if (device->accel_struct_build.radix_sort) {
       radix_sort_vk_destroy(device->accel_struct_build.radix_sort,
                             _device, &device->vk.alloc);
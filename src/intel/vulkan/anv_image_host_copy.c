@@ -14,6 +14,141 @@
 
 #define TMP_BUFFER_SIZE 4096
 
+/* Tiled copies are split in slices of at least this size across the host
+ * copy queue, the calling thread always takes the first slice.
+ */
+#define HOST_COPY_MIN_SLICE_SIZE (1024 * 1024)
+#define HOST_COPY_MAX_THREADS 4
+
+void
+anv_device_init_host_copy_queue(struct anv_device *device)
+{
+   const int num_threads =
+      MIN2(util_get_cpu_caps()->nr_cpus - 1, HOST_COPY_MAX_THREADS);
+   if (num_threads < 1)
+      return;
+
+   if (!util_queue_init(&device->host_copy_queue, "anv_host_copy",
+                        4 * HOST_COPY_MAX_THREADS, num_threads,
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL))
+      mesa_logw("anv: failed to create the host image copy queue");
+}
+
+struct tiled_copy_slice {
+   struct util_queue_fence fence;
+
+   uint32_t x1_B, x2_B, y1_el, y2_el;
+   char *img_ptr;
+   char *mem_ptr;
+   uint32_t img_row_pitch_B;
+   uint64_t mem_row_pitch_B;
+   enum isl_tiling tiling;
+   bool mem_to_img;
+};
+
+static void
+tiled_copy_slice(const struct tiled_copy_slice *slice)
+{
+   if (slice->mem_to_img) {
+      isl_memcpy_linear_to_tiled(slice->x1_B, slice->x2_B,
+                                 slice->y1_el, slice->y2_el,
+                                 slice->img_ptr,
+                                 slice->mem_ptr,
+                                 slice->img_row_pitch_B,
+                                 slice->mem_row_pitch_B,
+                                 false,
+                                 slice->tiling,
+                                 ISL_MEMCPY);
+   } else {
+      isl_memcpy_tiled_to_linear(slice->x1_B, slice->x2_B,
+                                 slice->y1_el, slice->y2_el,
+                                 slice->mem_ptr,
+                                 slice->img_ptr,
+                                 slice->mem_row_pitch_B,
+                                 slice->img_row_pitch_B,
+                                 false,
+                                 slice->tiling,
+#if defined(USE_SSE41)
+                                 util_get_cpu_caps()->has_sse4_1 ?
+                                 ISL_MEMCPY_STREAMING_LOAD :
+#endif
+                                 ISL_MEMCPY);
+   }
+}
+
+static void
+tiled_copy_slice_execute(void *job, void *gdata, int thread_index)
+{
+   tiled_copy_slice(job);
+}
+
+/* Copy between linear memory and a tiled surface, splitting the rows of
+ * large copies across the host copy queue.  Slices are aligned to tile rows
+ * so the threads never write to the same tile, and we wait for all of them
+ * before returning since the API call is synchronous.
+ */
+static void
+tiled_copy(struct anv_device *device,
+           const struct isl_surf *surf,
+           uint32_t x1_B, uint32_t x2_B,
+           uint32_t y1_el, uint32_t y2_el,
+           void *img_ptr, void *mem_ptr,
+           uint64_t mem_row_pitch_B,
+           bool mem_to_img)
+{
+   struct tiled_copy_slice slices[HOST_COPY_MAX_THREADS + 1];
+   uint32_t num_slices = 1;
+
+   if (util_queue_is_initialized(&device->host_copy_queue)) {
+      const uint64_t size_B = (uint64_t)(x2_B - x1_B) * (y2_el - y1_el);
+      num_slices = CLAMP(size_B / HOST_COPY_MIN_SLICE_SIZE, 1,
+                         device->host_copy_queue.num_threads + 1);
+   }
+
+   struct isl_tile_info tile;
+   isl_surf_get_tile_info(surf, &tile);
+
+   const uint32_t tile_h_el = tile.logical_extent_el.h;
+   const uint32_t slice_h_el =
+      align(DIV_ROUND_UP(y2_el - y1_el, num_slices), tile_h_el);
+
+   uint32_t count = 0;
+   for (uint32_t y_el = y1_el; y_el < y2_el; count++) {
+      /* Only the first slice may start in the middle of a tile row. */
+      const uint32_t end_el =
+         MIN2(ROUND_DOWN_TO(y_el, tile_h_el) + slice_h_el, y2_el);
+
+      assert(count < ARRAY_SIZE(slices));
+      slices[count] = (struct tiled_copy_slice) {
+         .x1_B = x1_B,
+         .x2_B = x2_B,
+         .y1_el = y_el,
+         .y2_el = end_el,
+         .img_ptr = img_ptr,
+         .mem_ptr = (char *)mem_ptr + (y_el - y1_el) * mem_row_pitch_B,
+         .img_row_pitch_B = surf->row_pitch_B,
+         .mem_row_pitch_B = mem_row_pitch_B,
+         .tiling = surf->tiling,
+         .mem_to_img = mem_to_img,
+      };
+      y_el = end_el;
+   }
+
+   for (uint32_t i = 1; i < count; i++) {
+      util_queue_fence_init(&slices[i].fence);
+      util_queue_add_job(&device->host_copy_queue, &slices[i],
+                         &slices[i].fence, tiled_copy_slice_execute,
+                         NULL, 0);
+   }
+
+   tiled_copy_slice(&slices[0]);
+
+   for (uint32_t i = 1; i < count; i++) {
+      util_queue_fence_wait(&slices[i].fence);
+      util_queue_fence_destroy(&slices[i].fence);
+   }
+}
+
 static inline VkOffset3D
 vk_offset3d_to_el(enum isl_format format, VkOffset3D offset)
 {
@@ -161,29 +296,8 @@ anv_copy_image_memory(struct anv_device *device,
       tile_extents(surf, offset_el, extent_el, level, img_depth_or_layer,
                    &x1, &x2, &y1, &y2);
 
-      if (mem_to_img) {
-         isl_memcpy_linear_to_tiled(x1, x2, y1, y2,
-                                    img_ptr,
-                                    mem_ptr,
-                                    surf->row_pitch_B,
-                                    mem_row_pitch_B,
-                                    false,
-                                    surf->tiling,
-                                    ISL_MEMCPY);
-      } else {
-         isl_memcpy_tiled_to_linear(x1, x2, y1, y2,
-                                    mem_ptr,
-                                    img_ptr,
-                                    mem_row_pitch_B,
-                                    surf->row_pitch_B,
-                                    false,
-                                    surf->tiling,
-#if defined(USE_SSE41)
-                                    util_get_cpu_caps()->has_sse4_1 ?
-                                    ISL_MEMCPY_STREAMING_LOAD :
-#endif
-                                    ISL_MEMCPY);
-      }
+      tiled_copy(device, surf, x1, x2, y1, y2, img_ptr, mem_ptr,
+                 mem_row_pitch_B, mem_to_img);
    }
 
 #ifdef SUPPORT_INTEL_INTEGRATED_GPUS
@@ -87,6 +87,7 @@ static const struct debug_control debug_control[] = {
    { "video-encode", ANV_DEBUG_VIDEO_ENCODE},
    { "shader-hash",  ANV_DEBUG_SHADER_HASH},
    { "no-slab",      ANV_DEBUG_NO_SLAB},
+   { "shader-heap-stats", ANV_DEBUG_SHADER_HEAP_STATS},
    { NULL,    0 }
 };
 
@@ -2392,8 +2392,21 @@ anv_physical_device_init_disk_cache(struct anv_physical_device *device)
                                device->info.pci_device_id);
    assert(len == sizeof(renderer) - 2);
 
+   /* The renderer only has the PCI ID, which doesn't cover all of the device
+    * information the compiler looks at.  Internal kernels (BLORP, generated
+    * draws, ...) are looked up by name alone, so also hash the device
+    * information to make them safe to share between processes.
+    */
+   struct mesa_sha1 sha1_ctx;
+   uint8_t sha1[SHA1_DIGEST_LENGTH];
+   _mesa_sha1_init(&sha1_ctx);
+   _mesa_sha1_update(&sha1_ctx, device->driver_build_sha1,
+                     sizeof(device->driver_build_sha1));
+   brw_device_sha1_update(&sha1_ctx, &device->info);
+   _mesa_sha1_final(&sha1_ctx, sha1);
+
    char timestamp[SHA1_DIGEST_STRING_LENGTH];
-   _mesa_sha1_format(timestamp, device->driver_build_sha1);
+   _mesa_sha1_format(timestamp, sha1);
 
    const uint64_t driver_flags =
       brw_get_compiler_config_value(device->compiler);
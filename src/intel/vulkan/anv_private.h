@@ -70,6 +70,7 @@
 #endif
 #include "util/u_vector.h"
 #include "util/u_math.h"
+#include "util/u_queue.h"
 #include "util/u_tristate.h"
 #include "util/vma.h"
 #include "util/xmlconfig.h"
@@ -1265,6 +1266,13 @@ struct anv_shader_heap {
 
    struct util_vma_heap vma;
    simple_mtx_t mutex;
+
+   /* Statistics, protected by the mutex */
+   uint32_t alloc_count;
+   uint32_t peak_alloc_count;
+   uint64_t peak_used_size;
+   uint32_t peak_fragmentation;
+   uint32_t failed_alloc_count;
 };
 
 struct anv_shader_alloc {
@@ -1740,6 +1748,7 @@ enum anv_debug {
    ANV_DEBUG_VIDEO_ENCODE      = BITFIELD_BIT(6),
    ANV_DEBUG_SHADER_HASH       = BITFIELD_BIT(7),
    ANV_DEBUG_NO_SLAB           = BITFIELD_BIT(8),
+   ANV_DEBUG_SHADER_HEAP_STATS = BITFIELD_BIT(9),
 };
 
 struct anv_instance {
@@ -2753,6 +2762,11 @@ struct anv_device {
        struct vk_acceleration_structure_build_args build_args;
    } accel_struct_build;
 
+   /** Worker threads used to split large host image copies, only
+    * initialized if hostImageCopy is enabled.
+    */
+   struct util_queue host_copy_queue;
+
    struct vk_meta_device meta_device;
 
    struct pb_slabs bo_slabs[3];
@@ -4778,12 +4792,25 @@ struct anv_cmd_state {
 #define ANV_MIN_CMD_BUFFER_BATCH_SIZE 8192
 #define ANV_MAX_CMD_BUFFER_BATCH_SIZE (16 * 1024 * 1024)
 
+/* How a secondary command buffer is executed by vkCmdExecuteCommands(),
+ * chosen when the secondary is ended.
+ */
 enum anv_cmd_buffer_exec_mode {
    ANV_CMD_BUFFER_EXEC_MODE_PRIMARY,
+   /* Copy the commands into the primary batch */
    ANV_CMD_BUFFER_EXEC_MODE_EMIT,
    ANV_CMD_BUFFER_EXEC_MODE_GROW_AND_EMIT,
+   /* Jump into the secondary and patch its final MI_BATCH_BUFFER_START to
+    * jump back, only possible without SIMULTANEOUS_USE
+    */
    ANV_CMD_BUFFER_EXEC_MODE_CHAIN,
+   /* Clone the secondary batch BOs and chain into the copies */
    ANV_CMD_BUFFER_EXEC_MODE_COPY_AND_CHAIN,
+   /* Default: jump into the secondary BOs without copying anything, after
+    * writing the return address into the secondary's final
+    * MI_BATCH_BUFFER_START from the primary batch on the GPU.  Disabled with
+    * ANV_DEBUG=no-secondary-call.
+    */
    ANV_CMD_BUFFER_EXEC_MODE_CALL_AND_RETURN,
 };
 
@@ -6442,6 +6469,8 @@ struct anv_image_create_info {
    bool no_private_binding_alloc;
 };
 
+void anv_device_init_host_copy_queue(struct anv_device *device);
+
 VkResult anv_image_init(struct anv_device *device, struct anv_image *image,
                         const struct anv_image_create_info *create_info);
 
@@ -687,6 +687,25 @@ anv_shader_create(struct anv_device *device,
                           shader->kernel, shader_data->code,
                           shader_data->prog_data.base.program_size);
 
+   if (INTEL_DEBUG(DEBUG_SHADERS_LINENO)) {
+      const uint32_t source_hash = shader_data->prog_data.base.source_hash;
+      if (!intel_shader_dump_filter ||
+          intel_shader_dump_filter == source_hash) {
+         /* Dump each SIMD variant with offsets relative to the instruction
+          * base address, matching the IPs reported by EU stall sampling.
+          */
+         const struct brw_isa_info *isa = &device->physical->compiler->isa;
+         int start = 0;
+         while (start < shader_data->prog_data.base.program_size) {
+            brw_disassemble_with_lineno(isa, stage, -1, source_hash,
+                                        shader_data->code, start,
+                                        shader->kernel.offset, stderr);
+            start += align(brw_disassemble_find_end(isa, shader_data->code,
+                                                    start), 64);
+         }
+      }
+   }
+
    if (mesa_shader_stage_is_rt(shader->vk.stage)) {
       const struct brw_bs_prog_data *bs_prog_data =
          (const struct brw_bs_prog_data *)shader->prog_data;
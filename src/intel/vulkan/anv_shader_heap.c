@@ -32,6 +32,39 @@ shader_bo_index(struct anv_shader_heap *heap, uint64_t addr)
    return b;
 }
 
+static inline uint64_t
+shader_heap_used_size(const struct anv_shader_heap *heap)
+{
+   return (heap->va_range.size - 64) - heap->vma.free_size;
+}
+
+/* Percentage of the free space that is not part of the largest hole. */
+static uint32_t
+shader_heap_fragmentation(struct anv_shader_heap *heap)
+{
+   if (heap->vma.free_size == 0)
+      return 0;
+
+   const uint64_t largest_hole =
+      util_vma_heap_get_max_free_continuous_size(&heap->vma);
+   return 100 - (largest_hole * 100) / heap->vma.free_size;
+}
+
+static void
+shader_heap_print_stats(struct anv_shader_heap *heap, const char *when)
+{
+   mesa_logi("anv shader heap stats (%s): %u allocations (peak %u), "
+             "%"PRIu64"KiB used (peak %"PRIu64"KiB), "
+             "%"PRIu64"KiB largest free hole, %u%% fragmentation "
+             "(peak %u%%), %u BOs, %u failed allocations",
+             when, heap->alloc_count, heap->peak_alloc_count,
+             shader_heap_used_size(heap) / 1024,
+             heap->peak_used_size / 1024,
+             util_vma_heap_get_max_free_continuous_size(&heap->vma) / 1024,
+             shader_heap_fragmentation(heap), heap->peak_fragmentation,
+             BITSET_COUNT(heap->allocated_bos), heap->failed_alloc_count);
+}
+
 VkResult
 anv_shader_heap_init(struct anv_shader_heap *heap,
                      struct anv_device *device,
@@ -88,6 +121,9 @@ anv_shader_heap_init(struct anv_shader_heap *heap,
 void
 anv_shader_heap_finish(struct anv_shader_heap *heap)
 {
+   if (heap->device->physical->instance->debug & ANV_DEBUG_SHADER_HEAP_STATS)
+      shader_heap_print_stats(heap, "device destroy");
+
    for (uint32_t i = 0; i < ARRAY_SIZE(heap->bos); i++) {
       if (heap->bos[i].bo) {
          ANV_DMR_BO_FREE(&heap->device->vk.base, heap->bos[i].bo);
@@ -168,6 +204,20 @@ anv_shader_heap_alloc(struct anv_shader_heap *heap,
       }
    }
 
+   if (addr != 0) {
+      heap->alloc_count++;
+      heap->peak_alloc_count = MAX2(heap->peak_alloc_count,
+                                    heap->alloc_count);
+      heap->peak_used_size = MAX2(heap->peak_used_size,
+                                  shader_heap_used_size(heap));
+   } else if (!requested_addr) {
+      /* Report the state of the heap the first time we run out of space,
+       * most likely due to fragmentation.
+       */
+      if (heap->failed_alloc_count++ == 0)
+         shader_heap_print_stats(heap, "allocation failure");
+   }
+
    simple_mtx_unlock(&heap->mutex);
 
    return alloc;
@@ -181,6 +231,15 @@ anv_shader_heap_free(struct anv_shader_heap *heap, struct anv_shader_alloc alloc
    util_vma_heap_free(&heap->vma, heap->va_range.addr + alloc.offset,
                       alloc.alloc_size);
 
+   assert(heap->alloc_count > 0);
+   heap->alloc_count--;
+
+   /* Walking the holes isn't free, only track this when asked to. */
+   if (heap->device->physical->instance->debug & ANV_DEBUG_SHADER_HEAP_STATS) {
+      heap->peak_fragmentation = MAX2(heap->peak_fragmentation,
+                                      shader_heap_fragmentation(heap));
+   }
+
    simple_mtx_unlock(&heap->mutex);
 }
 
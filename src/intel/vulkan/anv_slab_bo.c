@@ -35,7 +35,6 @@ anv_bo_alloc_flags_to_slab_heap(struct anv_device *device,
                                            ANV_BO_ALLOC_EXTERNAL |
                                            ANV_BO_ALLOC_CAPTURE |
                                            ANV_BO_ALLOC_FIXED_ADDRESS |
-                                           ANV_BO_ALLOC_CLIENT_VISIBLE_ADDRESS |
                                            ANV_BO_ALLOC_DESCRIPTOR_POOL |
                                            ANV_BO_ALLOC_LOCAL_MEM_CPU_VISIBLE |
                                            ANV_BO_ALLOC_SCANOUT |
@@ -49,6 +48,15 @@ anv_bo_alloc_flags_to_slab_heap(struct anv_device *device,
                         ANV_BO_ALLOC_IMPLICIT_WRITE);
    }
 
+   /* Memory allocated with VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT only needs
+    * its own VMA range if the application can replay its address, otherwise
+    * a slab entry address is as good as any other.  This covers most small
+    * allocations of applications relying on buffer device address.
+    */
+   if (device->vk.enabled_features.bufferDeviceAddressCaptureReplay ||
+       device->vk.enabled_features.descriptorBufferCaptureReplay)
+      not_supported |= ANV_BO_ALLOC_CLIENT_VISIBLE_ADDRESS;
+
    if (alloc_flags == ANV_BO_ALLOC_BATCH_BUFFER_FLAGS ||
        alloc_flags == ANV_BO_ALLOC_BATCH_BUFFER_INTERNAL_FLAGS)
       return ANV_BO_SLAB_HEAP_CACHED_COHERENT_CAPTURE;
@@ -2556,6 +2556,19 @@ genX(CmdDrawMeshTasksIndirectEXT)(
       return;
    }
 
+   if (anv_use_generated_draws(cmd_buffer, drawCount)) {
+      genX(cmd_buffer_emit_indirect_generated_draws)(
+         cmd_buffer,
+         anv_address_add(buffer->address, offset),
+         MAX2(stride, sizeof(VkDrawMeshTasksIndirectCommandEXT)),
+         ANV_NULL_ADDRESS /* count_addr */,
+         drawCount,
+         false /* indexed */);
+
+      trace_intel_end_draw_mesh_indirect(&cmd_buffer->trace, drawCount);
+      return;
+   }
+
    cmd_buffer_flush_gfx_state(cmd_buffer);
 
    if (cmd_state->conditional_render_enabled)
@@ -2623,6 +2636,20 @@ genX(CmdDrawMeshTasksIndirectCountEXT)(
       return;
    }
 
+   if (anv_use_generated_draws(cmd_buffer, maxDrawCount)) {
+      genX(cmd_buffer_emit_indirect_generated_draws)(
+         cmd_buffer,
+         anv_address_add(buffer->address, offset),
+         MAX2(stride, sizeof(VkDrawMeshTasksIndirectCommandEXT)),
+         count_addr,
+         maxDrawCount,
+         false /* indexed */);
+
+      trace_intel_end_draw_mesh_indirect_count(&cmd_buffer->trace,
+                                               anv_address_utrace(count_addr));
+      return;
+   }
+
    cmd_buffer_flush_gfx_state(cmd_buffer);
 
    bool uses_drawid = (task_prog_data && task_prog_data->uses_drawid) ||
@@ -65,8 +65,12 @@ genX(cmd_buffer_emit_generate_draws)(struct anv_cmd_buffer *cmd_buffer,
       return ANV_STATE_NULL;
 
    const struct anv_cmd_graphics_state *gfx = &cmd_buffer->state.gfx;
+   const bool is_mesh = anv_gfx_has_stage(gfx, MESA_SHADER_MESH);
    const struct brw_vs_prog_data *vs_prog_data = get_gfx_vs_prog_data(gfx);
    const bool use_tbimr = cmd_buffer->state.gfx.dyn_state.use_tbimr;
+   const bool uses_base = vs_prog_data &&
+      (vs_prog_data->uses_firstvertex || vs_prog_data->uses_baseinstance);
+   const bool uses_drawid = vs_prog_data && vs_prog_data->uses_drawid;
 
    struct anv_address draw_count_addr;
    if (anv_address_is_null(count_addr)) {
@@ -125,10 +129,9 @@ genX(cmd_buffer_emit_generate_draws)(struct anv_cmd_buffer *cmd_buffer,
                                 (indexed ? ANV_GENERATED_FLAG_INDEXED : 0) |
                                 (cmd_buffer->state.conditional_render_enabled ?
                                  ANV_GENERATED_FLAG_PREDICATED : 0) |
-                                ((vs_prog_data->uses_firstvertex ||
-                                  vs_prog_data->uses_baseinstance) ?
-                                 ANV_GENERATED_FLAG_BASE : 0) |
-                                (vs_prog_data->uses_drawid ? ANV_GENERATED_FLAG_DRAWID : 0) |
+                                (uses_base ? ANV_GENERATED_FLAG_BASE : 0) |
+                                (uses_drawid ? ANV_GENERATED_FLAG_DRAWID : 0) |
+                                (is_mesh ? ANV_GENERATED_FLAG_MESH : 0) |
                                 (!anv_address_is_null(count_addr) ?
                                  ANV_GENERATED_FLAG_COUNT : 0) |
                                 (ring_count != 0 ? ANV_GENERATED_FLAG_RING_MODE : 0),
@@ -219,6 +222,12 @@ genX(cmd_buffer_get_draw_id_addr)(struct anv_cmd_buffer *cmd_buffer,
 static uint32_t
 genX(cmd_buffer_get_generated_draw_stride)(struct anv_cmd_buffer *cmd_buffer)
 {
+#if GFX_VERx10 >= 125
+   /* 3DMESH_3D with the draw id in the extended parameter */
+   if (anv_gfx_has_stage(&cmd_buffer->state.gfx, MESA_SHADER_MESH))
+      return 4 * (GENX(3DMESH_3D_length) + 1);
+#endif
+
    /* With the extended parameters in 3DPRIMITIVE on Gfx11+ we can emit
     * everything. Prior to this, we need to emit a couple of
     * VERTEX_BUFFER_STATE.
@@ -401,11 +410,20 @@ genX(cmd_buffer_emit_indirect_generated_draws_inring)(struct anv_cmd_buffer *cmd
       genX(cmd_buffer_get_generated_draw_stride)(cmd_buffer);
 
    if (cmd_buffer->generation.ring_bo == NULL) {
+      /* The ring is reused by all the generated draws of the command buffer,
+       * size it for 3DPRIMITIVE even if the first user is a mesh draw.
+       */
+      const uint32_t ring_cmd_stride =
+#if GFX_VER >= 11
+         MAX2(draw_cmd_stride, 4 * GENX(3DPRIMITIVE_EXTENDED_length));
+#else
+         draw_cmd_stride;
+#endif
       const uint32_t bo_size = align(
 #if GFX_VER >= 12
          GENX(MI_ARB_CHECK_length) * 4 +
 #endif
-         draw_cmd_stride * MAX_RING_BO_ITEMS +
+         ring_cmd_stride * MAX_RING_BO_ITEMS +
 #if GFX_VER == 9
          4 * MAX_RING_BO_ITEMS +
 #endif
@@ -132,6 +132,52 @@ void mtl_draw_indexed_primitives_indirect(mtl_render_encoder *encoder,
                                           mtl_buffer *indirect_buffer,
                                           uint64_t indirect_buffer_offset);
 
+/* Commands recorded on the driver side and encoded in bulk with
+ * mtl_render_encode_commands, to avoid crossing the bridge for every state
+ * change and draw. */
+enum mtl_render_cmd_type {
+   MTL_RENDER_CMD_SET_VERTEX_BUFFER,
+   MTL_RENDER_CMD_SET_FRAGMENT_BUFFER,
+   MTL_RENDER_CMD_SET_PIPELINE_STATE,
+   MTL_RENDER_CMD_SET_DEPTH_STENCIL_STATE,
+   MTL_RENDER_CMD_DRAW_PRIMITIVES,
+   MTL_RENDER_CMD_DRAW_INDEXED_PRIMITIVES,
+};
+
+struct mtl_render_cmd {
+   enum mtl_render_cmd_type type;
+   union {
+      struct {
+         mtl_buffer *buffer;
+         uint32_t offset;
+         uint32_t index;
+      } buffer;
+      mtl_render_pipeline_state *pipeline;
+      mtl_depth_stencil_state *depth_stencil;
+      struct {
+         enum mtl_primitive_type primitive_type;
+         uint32_t vertex_start;
+         uint32_t vertex_count;
+         uint32_t instance_count;
+         uint32_t base_instance;
+      } draw;
+      struct {
+         enum mtl_primitive_type primitive_type;
+         uint32_t index_count;
+         enum mtl_index_type index_type;
+         mtl_buffer *index_buffer;
+         uint32_t index_buffer_offset;
+         uint32_t instance_count;
+         int32_t base_vertex;
+         uint32_t base_instance;
+      } draw_indexed;
+   };
+};
+
+void mtl_render_encode_commands(mtl_render_encoder *encoder,
+                                const struct mtl_render_cmd *cmds,
+                                uint32_t count);
+
 void mtl_render_use_resource(mtl_compute_encoder *encoder,
                              mtl_resource *res_handle, uint32_t usage);
 
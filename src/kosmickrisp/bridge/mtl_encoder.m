@@ -441,6 +441,38 @@ mtl_draw_indexed_primitives(
    }
 }
 
+void
+mtl_render_encode_commands(mtl_render_encoder *encoder,
+                           const struct mtl_render_cmd *cmds, uint32_t count)
+{
+   @autoreleasepool {
+      id<MTLRenderCommandEncoder> enc = (id<MTLRenderCommandEncoder>)encoder;
+      for (uint32_t i = 0u; i < count; ++i) {
+         const struct mtl_render_cmd *cmd = &cmds[i];
+         switch (cmd->type) {
+         case MTL_RENDER_CMD_SET_VERTEX_BUFFER:
+            [enc setVertexBuffer:(id<MTLBuffer>)cmd->buffer.buffer offset:cmd->buffer.offset atIndex:cmd->buffer.index];
+            break;
+         case MTL_RENDER_CMD_SET_FRAGMENT_BUFFER:
+            [enc setFragmentBuffer:(id<MTLBuffer>)cmd->buffer.buffer offset:cmd->buffer.offset atIndex:cmd->buffer.index];
+            break;
+         case MTL_RENDER_CMD_SET_PIPELINE_STATE:
+            [enc setRenderPipelineState:(id<MTLRenderPipelineState>)cmd->pipeline];
+            break;
+         case MTL_RENDER_CMD_SET_DEPTH_STENCIL_STATE:
+            [enc setDepthStencilState:(id<MTLDepthStencilState>)cmd->depth_stencil];
+            break;
+         case MTL_RENDER_CMD_DRAW_PRIMITIVES:
+            [enc drawPrimitives:(MTLPrimitiveType)cmd->draw.primitive_type vertexStart:cmd->draw.vertex_start vertexCount:cmd->draw.vertex_count instanceCount:cmd->draw.instance_count baseInstance:cmd->draw.base_instance];
+            break;
+         case MTL_RENDER_CMD_DRAW_INDEXED_PRIMITIVES:
+            [enc drawIndexedPrimitives:(MTLPrimitiveType)cmd->draw_indexed.primitive_type indexCount:cmd->draw_indexed.index_count indexType:(MTLIndexType)cmd->draw_indexed.index_type indexBuffer:(id<MTLBuffer>)cmd->draw_indexed.index_buffer indexBufferOffset:cmd->draw_indexed.index_buffer_offset instanceCount:cmd->draw_indexed.instance_count baseVertex:cmd->draw_indexed.base_vertex baseInstance:cmd->draw_indexed.base_instance];
+            break;
+         }
+      }
+   }
+}
+
 void
 mtl_draw_primitives_indirect(mtl_render_encoder *encoder,
                              enum mtl_primitive_type primitve_type,
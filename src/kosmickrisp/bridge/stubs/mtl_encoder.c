@@ -221,6 +221,12 @@ mtl_draw_indexed_primitives(
 {
 }
 
+void
+mtl_render_encode_commands(mtl_render_encoder *encoder,
+                           const struct mtl_render_cmd *cmds, uint32_t count)
+{
+}
+
 void
 mtl_draw_primitives_indirect(mtl_render_encoder *encoder,
                              enum mtl_primitive_type primitve_type,
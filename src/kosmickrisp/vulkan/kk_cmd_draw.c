@@ -687,7 +687,11 @@ kk_flush_draw_state(struct kk_cmd_buffer *cmd)
    struct kk_graphics_state *gfx = &cmd->state.gfx;
    struct vk_dynamic_graphics_state *dyn = &cmd->vk.dynamic_graphics_state;
    struct kk_descriptor_state *desc = &cmd->state.gfx.descriptors;
-   mtl_render_encoder *enc = kk_render_encoder(cmd);
+
+   /* Start the render encoder now so the bound root buffer we track below
+    * belongs to it */
+   if (gfx->need_to_start_render_pass)
+      kk_render_encoder(cmd);
 
    if (BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_VI_BINDING_STRIDES)) {
       u_foreach_bit(ndx, dyn->vi->bindings_valid) {
@@ -698,7 +702,7 @@ kk_flush_draw_state(struct kk_cmd_buffer *cmd)
 
    if (BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_RS_RASTERIZER_DISCARD_ENABLE)) {
       if (dyn->rs.rasterizer_discard_enable) {
-         set_empty_scissor(enc);
+         set_empty_scissor(kk_render_encoder(cmd));
       } else {
          /* Enforce setting the correct scissors */
          BITSET_SET(dyn->dirty, MESA_VK_DYNAMIC_VP_VIEWPORT_COUNT);
@@ -709,9 +713,9 @@ kk_flush_draw_state(struct kk_cmd_buffer *cmd)
       gfx->is_cull_front_and_back =
          dyn->rs.cull_mode == VK_CULL_MODE_FRONT_AND_BACK;
       if (gfx->is_cull_front_and_back) {
-         set_empty_scissor(enc);
+         set_empty_scissor(kk_render_encoder(cmd));
       } else {
-         mtl_set_cull_mode(enc,
+         mtl_set_cull_mode(kk_render_encoder(cmd),
                            vk_front_face_to_mtl_cull_mode(dyn->rs.cull_mode));
          /* Enforce setting the correct scissors */
          BITSET_SET(dyn->dirty, MESA_VK_DYNAMIC_VP_VIEWPORT_COUNT);
@@ -756,17 +760,20 @@ kk_flush_draw_state(struct kk_cmd_buffer *cmd)
          dyn->rp.attachments & MESA_VK_RP_ATTACHMENT_STENCIL_BIT;
       gfx->depth_stencil_state = kk_compile_depth_stencil_state(
          device, &dyn->ds, has_depth, has_stencil);
-      mtl_set_depth_stencil_state(enc, gfx->depth_stencil_state);
+      kk_render_cmd_push(cmd, MTL_RENDER_CMD_SET_DEPTH_STENCIL_STATE)
+         ->depth_stencil = gfx->depth_stencil_state;
    }
 
    if (BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_RS_FRONT_FACE)) {
       mtl_set_front_face_winding(
-         enc, vk_front_face_to_mtl_winding(
-                 cmd->vk.dynamic_graphics_state.rs.front_face));
+         kk_render_encoder(cmd),
+         vk_front_face_to_mtl_winding(
+            cmd->vk.dynamic_graphics_state.rs.front_face));
    }
 
    if (BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_RS_DEPTH_BIAS_FACTORS)) {
-      mtl_set_depth_bias(enc, dyn->rs.depth_bias.constant_factor,
+      mtl_set_depth_bias(kk_render_encoder(cmd),
+                         dyn->rs.depth_bias.constant_factor,
                          dyn->rs.depth_bias.slope_factor,
                          dyn->rs.depth_bias.clamp);
    }
@@ -775,12 +782,13 @@ kk_flush_draw_state(struct kk_cmd_buffer *cmd)
       enum mtl_depth_clip_mode mode = dyn->rs.depth_clamp_enable
                                          ? MTL_DEPTH_CLIP_MODE_CLAMP
                                          : MTL_DEPTH_CLIP_MODE_CLIP;
-      mtl_set_depth_clip_mode(enc, mode);
+      mtl_set_depth_clip_mode(kk_render_encoder(cmd), mode);
    }
 
    if (BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_DS_STENCIL_REFERENCE))
       mtl_set_stencil_references(
-         enc, cmd->vk.dynamic_graphics_state.ds.stencil.front.reference,
+         kk_render_encoder(cmd),
+         cmd->vk.dynamic_graphics_state.ds.stencil.front.reference,
          cmd->vk.dynamic_graphics_state.ds.stencil.back.reference);
 
    if (BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_CB_BLEND_CONSTANTS)) {
@@ -821,9 +829,11 @@ kk_flush_draw_state(struct kk_cmd_buffer *cmd)
    }
 
    if (gfx->dirty & KK_DIRTY_PIPELINE) {
-      mtl_render_set_pipeline_state(enc, gfx->pipeline_state);
+      kk_render_cmd_push(cmd, MTL_RENDER_CMD_SET_PIPELINE_STATE)->pipeline =
+         gfx->pipeline_state;
       if (gfx->depth_stencil_state)
-         mtl_set_depth_stencil_state(enc, gfx->depth_stencil_state);
+         kk_render_cmd_push(cmd, MTL_RENDER_CMD_SET_DEPTH_STENCIL_STATE)
+            ->depth_stencil = gfx->depth_stencil_state;
    }
 
    if (desc->push_dirty)
@@ -831,14 +841,24 @@ kk_flush_draw_state(struct kk_cmd_buffer *cmd)
    if (desc->root_dirty)
       kk_upload_descriptor_root(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS);
 
+   /* Most draws don't change the root buffer, skip binding it again */
    struct kk_bo *root_buffer = desc->root.root_buffer;
-   if (root_buffer) {
-      mtl_set_vertex_buffer(enc, root_buffer->map, 0, 0);
-      mtl_set_fragment_buffer(enc, root_buffer->map, 0, 0);
+   if (root_buffer && root_buffer->map != cmd->encoder->render_root_buffer) {
+      struct mtl_render_cmd *bind =
+         kk_render_cmd_push(cmd, MTL_RENDER_CMD_SET_VERTEX_BUFFER);
+      bind->buffer.buffer = root_buffer->map;
+      bind->buffer.offset = 0u;
+      bind->buffer.index = 0u;
+      bind = kk_render_cmd_push(cmd, MTL_RENDER_CMD_SET_FRAGMENT_BUFFER);
+      bind->buffer.buffer = root_buffer->map;
+      bind->buffer.offset = 0u;
+      bind->buffer.index = 0u;
+      cmd->encoder->render_root_buffer = root_buffer->map;
    }
 
    if (gfx->dirty & KK_DIRTY_OCCLUSION) {
-      mtl_set_visibility_result_mode(enc, gfx->occlusion.mode,
+      mtl_set_visibility_result_mode(kk_render_encoder(cmd),
+                                     gfx->occlusion.mode,
                                      gfx->occlusion.index * sizeof(uint64_t));
    }
 
@@ -870,9 +890,13 @@ kk_CmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount,
       struct kk_pool pool = kk_pool_upload(cmd, &draw, sizeof(draw), 4u);
       kk_encoder_render_triangle_fan_indirect(cmd, pool.handle, 0u);
    } else {
-      mtl_render_encoder *enc = kk_render_encoder(cmd);
-      mtl_draw_primitives(enc, cmd->state.gfx.primitive_type, firstVertex,
-                          vertexCount, instanceCount, firstInstance);
+      struct mtl_render_cmd *draw =
+         kk_render_cmd_push(cmd, MTL_RENDER_CMD_DRAW_PRIMITIVES);
+      draw->draw.primitive_type = cmd->state.gfx.primitive_type;
+      draw->draw.vertex_start = firstVertex;
+      draw->draw.vertex_count = vertexCount;
+      draw->draw.instance_count = instanceCount;
+      draw->draw.base_instance = firstInstance;
    }
 }
 
@@ -931,11 +955,16 @@ kk_CmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount,
       uint32_t index_buffer_offset_B =
          firstIndex * bytes_per_index + cmd->state.gfx.index.offset;
 
-      mtl_render_encoder *enc = kk_render_encoder(cmd);
-      mtl_draw_indexed_primitives(
-         enc, cmd->state.gfx.primitive_type, indexCount, index_type,
-         cmd->state.gfx.index.handle, index_buffer_offset_B, instanceCount,
-         vertexOffset, firstInstance);
+      struct mtl_render_cmd *draw =
+         kk_render_cmd_push(cmd, MTL_RENDER_CMD_DRAW_INDEXED_PRIMITIVES);
+      draw->draw_indexed.primitive_type = cmd->state.gfx.primitive_type;
+      draw->draw_indexed.index_count = indexCount;
+      draw->draw_indexed.index_type = index_type;
+      draw->draw_indexed.index_buffer = cmd->state.gfx.index.handle;
+      draw->draw_indexed.index_buffer_offset = index_buffer_offset_B;
+      draw->draw_indexed.instance_count = instanceCount;
+      draw->draw_indexed.base_vertex = vertexOffset;
+      draw->draw_indexed.base_instance = firstInstance;
    }
 }
 
@@ -946,8 +975,6 @@ kk_CmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer _buffer,
    VK_FROM_HANDLE(kk_cmd_buffer, cmd, commandBuffer);
    VK_FROM_HANDLE(kk_buffer, buffer, _buffer);
 
-   mtl_render_encoder *enc = kk_render_encoder(cmd);
-
    for (uint32_t i = 0u; i < drawCount; ++i, offset += stride) {
       cmd->state.gfx.descriptors.root_dirty = true;
       cmd->state.gfx.descriptors.root.draw.draw_id = i;
@@ -961,7 +988,8 @@ kk_CmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer _buffer,
          kk_encoder_render_triangle_fan_indirect(cmd, buffer->mtl_handle,
                                                  offset);
       } else {
-         mtl_draw_primitives_indirect(enc, cmd->state.gfx.primitive_type,
+         mtl_draw_primitives_indirect(kk_render_encoder(cmd),
+                                      cmd->state.gfx.primitive_type,
                                       buffer->mtl_handle, offset);
       }
    }
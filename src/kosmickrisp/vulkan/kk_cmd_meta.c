@@ -279,6 +279,7 @@ kk_CmdClearAttachments(VkCommandBuffer commandBuffer, uint32_t attachmentCount,
    uint32_t view_mask = cmd->state.gfx.render.view_mask;
    struct kk_encoder *encoder = cmd->encoder;
    uint32_t layer_ids[KK_MAX_MULTIVIEW_VIEW_COUNT] = {};
+   kk_encoder_flush_render_cmds(encoder);
    mtl_set_vertex_amplification_count(encoder->main.encoder, layer_ids, 1u);
 
    struct kk_meta_save save;
@@ -293,6 +294,7 @@ kk_CmdClearAttachments(VkCommandBuffer commandBuffer, uint32_t attachmentCount,
    if (view_mask == 0u) {
       layer_ids[count++] = 0;
    }
+   kk_encoder_flush_render_cmds(encoder);
    mtl_set_vertex_amplification_count(encoder->main.encoder, layer_ids, count);
 }
 
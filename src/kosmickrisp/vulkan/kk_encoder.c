@@ -91,6 +91,7 @@ kk_encoder_start_render(struct kk_cmd_buffer *cmd,
       mtl_set_vertex_amplification_count(encoder->main.encoder, layer_ids,
                                          count);
       encoder->main.user_heap_hash = UINT32_MAX;
+      encoder->render_root_buffer = NULL;
 
       /* Bind read only data aka samplers' argument buffer. */
       struct kk_device *dev = kk_cmd_buffer_device(cmd);
@@ -223,6 +224,7 @@ kk_encoder_signal_fence_and_end(struct kk_cmd_buffer *cmd)
    }
 
    if (encoder->main.last_used != KK_ENC_NONE) {
+      kk_encoder_flush_render_cmds(encoder);
       kk_encoder_signal_fence(encoder);
       kk_encoder_internal_end_encoding(&encoder->main);
    }
@@ -281,9 +283,42 @@ kk_render_encoder(struct kk_cmd_buffer *cmd)
    }
    /* Render encoders are created at vkBeginRendering only */
    assert(encoder->main.last_used == KK_ENC_RENDER && encoder->main.encoder);
+
+   /* The caller will encode directly, keep the command order */
+   kk_encoder_flush_render_cmds(encoder);
    return (mtl_render_encoder *)encoder->main.encoder;
 }
 
+struct mtl_render_cmd *
+kk_render_cmd_push(struct kk_cmd_buffer *cmd, enum mtl_render_cmd_type type)
+{
+   struct kk_encoder *encoder = cmd->encoder;
+
+   if (cmd->state.gfx.need_to_start_render_pass)
+      kk_render_encoder(cmd);
+   assert(encoder->main.last_used == KK_ENC_RENDER && encoder->main.encoder);
+
+   if (encoder->render_cmd_count == KK_RENDER_CMD_BATCH_SIZE)
+      kk_encoder_flush_render_cmds(encoder);
+
+   struct mtl_render_cmd *render_cmd =
+      &encoder->render_cmds[encoder->render_cmd_count++];
+   render_cmd->type = type;
+   return render_cmd;
+}
+
+void
+kk_encoder_flush_render_cmds(struct kk_encoder *encoder)
+{
+   if (encoder->render_cmd_count == 0u)
+      return;
+
+   assert(encoder->main.last_used == KK_ENC_RENDER && encoder->main.encoder);
+   mtl_render_encode_commands(encoder->main.encoder, encoder->render_cmds,
+                              encoder->render_cmd_count);
+   encoder->render_cmd_count = 0u;
+}
+
 mtl_compute_encoder *
 kk_compute_encoder(struct kk_cmd_buffer *cmd)
 {
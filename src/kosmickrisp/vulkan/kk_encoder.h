@@ -7,6 +7,7 @@
 #ifndef KK_ENCODER_H
 #define KK_ENCODER_H 1
 
+#include "kosmickrisp/bridge/mtl_encoder.h"
 #include "kosmickrisp/bridge/mtl_types.h"
 
 #include "util/u_dynarray.h"
@@ -54,9 +55,19 @@ struct kk_copy_query_pool_results_info {
    uint32_t query_count;
 };
 
+/* Number of render commands recorded before they are encoded */
+#define KK_RENDER_CMD_BATCH_SIZE 64u
+
 struct kk_encoder {
    mtl_device *dev;
    struct kk_encoder_internal main;
+   /* Render commands for main not yet encoded. Anything encoding into the
+    * render encoder directly must flush these first, kk_render_encoder does
+    * it for us */
+   struct mtl_render_cmd render_cmds[KK_RENDER_CMD_BATCH_SIZE];
+   uint32_t render_cmd_count;
+   /* Root buffer last bound to the render encoder, to skip rebinding it */
+   mtl_buffer *render_root_buffer;
    /* Compute only for pre gfx required work */
    struct kk_encoder_internal pre_gfx;
 
@@ -97,6 +108,14 @@ void kk_encoder_signal_fence_and_end(struct kk_cmd_buffer *cmd);
 
 mtl_render_encoder *kk_render_encoder(struct kk_cmd_buffer *cmd);
 
+/* Returns a new render command to be filled, encoded with the next flush. The
+ * render encoder is started if needed */
+struct mtl_render_cmd *kk_render_cmd_push(struct kk_cmd_buffer *cmd,
+                                          enum mtl_render_cmd_type type);
+
+/* Encodes all recorded render commands in a single bridge call */
+void kk_encoder_flush_render_cmds(struct kk_encoder *encoder);
+
 mtl_compute_encoder *kk_compute_encoder(struct kk_cmd_buffer *cmd);
 
 mtl_blit_encoder *kk_blit_encoder(struct kk_cmd_buffer *cmd);
@@ -38,6 +38,7 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <sys/param.h>
+#include <sys/utsname.h>
 #ifdef MAJOR_IN_MKDEV
 #include <sys/mkdev.h>
 #endif
@@ -47,8 +48,11 @@
 #include <GL/gl.h>
 #include "mesa_interface.h"
 #include "loader.h"
+#include "util/disk_cache.h"
 #include "util/drm_is_nouveau.h"
+#include "util/hex.h"
 #include "util/libdrm.h"
+#include "util/mesa-sha1.h"
 #include "util/os_file.h"
 #include "util/os_misc.h"
 #include "util/u_debug.h"
@@ -758,6 +762,94 @@ out:
    return driver;
 }
 
+/* Resolving the driver for a device parses every drirc file and walks the
+ * PCI id tables, which short-lived processes pay on every eglInitialize().
+ * The result is remembered in the shader cache directory, namespaced by the
+ * build-id of this Mesa build.
+ */
+static struct disk_cache *
+loader_create_driver_cache(void)
+{
+   struct mesa_sha1 ctx;
+   unsigned char sha1[SHA1_DIGEST_LENGTH];
+   char build_id[SHA1_DIGEST_STRING_LENGTH];
+
+   _mesa_sha1_init(&ctx);
+   if (!disk_cache_get_function_identifier(loader_create_driver_cache, &ctx))
+      return NULL;
+   _mesa_sha1_final(&ctx, sha1);
+   mesa_bytes_to_hex(build_id, sha1, SHA1_DIGEST_LENGTH);
+
+   return disk_cache_create("mesa_loader", build_id, 0);
+}
+
+/* The cached driver name is keyed by everything the lookup depends on: the
+ * device node and its PCI ids, the kernel driver and kernel version, the
+ * drirc files and the environment consulted by the driver predicates.
+ */
+static bool
+loader_compute_driver_cache_key(struct disk_cache *cache, int fd,
+                                cache_key key)
+{
+   struct mesa_sha1 ctx;
+   unsigned char sha1[SHA1_DIGEST_LENGTH];
+   struct stat sbuf;
+   struct utsname uts;
+   int vendor_id = 0, chip_id = 0;
+
+   if (fstat(fd, &sbuf) != 0 || uname(&uts) != 0)
+      return false;
+
+   drmVersionPtr version = drmGetVersion(fd);
+   if (!version)
+      return false;
+
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, &sbuf.st_rdev, sizeof(sbuf.st_rdev));
+   _mesa_sha1_update(&ctx, uts.release, strlen(uts.release) + 1);
+   _mesa_sha1_update(&ctx, version->name, version->name_len);
+   _mesa_sha1_update(&ctx, &version->version_major, sizeof(version->version_major));
+   _mesa_sha1_update(&ctx, &version->version_minor, sizeof(version->version_minor));
+   _mesa_sha1_update(&ctx, &version->version_patchlevel, sizeof(version->version_patchlevel));
+   drmFreeVersion(version);
+
+   loader_get_pci_id_for_fd(fd, &vendor_id, &chip_id);
+   _mesa_sha1_update(&ctx, &vendor_id, sizeof(vendor_id));
+   _mesa_sha1_update(&ctx, &chip_id, sizeof(chip_id));
+
+   const char *use_zink = os_get_option("NOUVEAU_USE_ZINK");
+   if (use_zink)
+      _mesa_sha1_update(&ctx, use_zink, strlen(use_zink) + 1);
+
+#if defined(USE_DRICONF)
+   unsigned char drirc_sha1[SHA1_DIGEST_LENGTH];
+   driComputeConfigFilesSha1(drirc_sha1);
+   _mesa_sha1_update(&ctx, drirc_sha1, sizeof(drirc_sha1));
+#endif
+
+   _mesa_sha1_final(&ctx, sha1);
+   disk_cache_compute_key(cache, sha1, sizeof(sha1), key);
+   return true;
+}
+
+static char *
+loader_lookup_driver_for_fd(int fd)
+{
+   char *driver;
+
+#if defined(USE_DRICONF)
+   driver = loader_get_dri_config_driver(fd);
+   if (driver)
+      return driver;
+#endif
+
+   driver = loader_get_pci_driver(fd);
+   if (!driver)
+      driver = loader_get_kernel_driver_name(fd);
+
+   return driver;
+}
+
 char *
 loader_get_driver_for_fd(int fd)
 {
@@ -774,15 +866,33 @@ loader_get_driver_for_fd(int fd)
          return strdup(override);
    }
 
-#if defined(USE_DRICONF)
-   driver = loader_get_dri_config_driver(fd);
-   if (driver)
-      return driver;
-#endif
+   struct disk_cache *cache = loader_create_driver_cache();
+   cache_key key;
 
-   driver = loader_get_pci_driver(fd);
-   if (!driver)
-      driver = loader_get_kernel_driver_name(fd);
+   if (cache && !loader_compute_driver_cache_key(cache, fd, key)) {
+      disk_cache_destroy(cache);
+      cache = NULL;
+   }
+
+   if (cache) {
+      size_t size = 0;
+      driver = disk_cache_get(cache, key, &size);
+      if (driver && size > 1 && driver[size - 1] == '\0') {
+         log_(_LOADER_DEBUG, "MESA-LOADER: using cached driver %s for fd %d\n",
+              driver, fd);
+         disk_cache_destroy(cache);
+         return driver;
+      }
+      free(driver);
+   }
+
+   driver = loader_lookup_driver_for_fd(fd);
+
+   if (cache) {
+      if (driver)
+         disk_cache_put(cache, key, driver, strlen(driver) + 1, NULL);
+      disk_cache_destroy(cache);
+   }
 
    return driver;
 }
@@ -1218,6 +1218,7 @@ copy_array_object(struct gl_context *ctx,
    dest->NonZeroDivisorMask = src->NonZeroDivisorMask;
    dest->NonIdentityBufferAttribMapping = src->NonIdentityBufferAttribMapping;
    dest->_AttributeMapMode = src->_AttributeMapMode;
+   dest->_VertexElementsGeneration++;
    /* skip NumUpdates and IsDynamic because they can only increase, not decrease */
 }
 
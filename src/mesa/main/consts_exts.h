@@ -599,6 +599,12 @@ struct gl_constants
     */
    GLboolean ForceGLSLAbsSqrt;
 
+   /**
+    * Don't run the GLSL IR optimizations at compile time for GLSL ES shaders,
+    * NIR does all of that again after linking.
+    */
+   GLboolean GLSLESSkipIROptimizations;
+
    /**
     * Forces the GLSL compiler to ignore writes to readonly vars rather than
     * throwing an error.
@@ -13042,9 +13042,33 @@ execute_list(struct gl_context *ctx, GLuint list)
                                       (n[1].f, n[2].f, n[3].f, n[4].f,
                                        n[5].f, n[6].f, n[7].f, n[8].f));
             break;
-         case OPCODE_VERTEX_LIST:
-            vbo_save_playback_vertex_list(ctx, &n[0], false);
+         case OPCODE_VERTEX_LIST: {
+            /* A vertex list is split whenever the vertex store fills, so
+             * big glBegin/glEnd blocks turn into runs of vertex lists that
+             * usually share the same vertex state. Draw those with one
+             * state validation.
+             */
+            void *nodes[16];
+            unsigned count = 1;
+
+            nodes[0] = &n[0];
+            while (count < ARRAY_SIZE(nodes) &&
+                   n[0].opcode == OPCODE_VERTEX_LIST) {
+               Node *next = n + n[0].InstSize;
+
+               if ((next[0].opcode != OPCODE_VERTEX_LIST &&
+                    next[0].opcode != OPCODE_VERTEX_LIST_COPY_CURRENT) ||
+                   !vbo_save_vertex_lists_mergeable(&n[0], &next[0]))
+                  break;
+
+               n = next;
+               nodes[count++] = &n[0];
+            }
+
+            vbo_save_playback_vertex_lists(ctx, nodes, count,
+                                           n[0].opcode == OPCODE_VERTEX_LIST_COPY_CURRENT);
             break;
+         }
 
          case OPCODE_VERTEX_LIST_COPY_CURRENT:
             vbo_save_playback_vertex_list(ctx, &n[0], true);
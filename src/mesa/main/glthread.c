@@ -37,7 +37,9 @@
 #include "main/glthread_marshal.h"
 #include "main/hash.h"
 #include "main/pixelstore.h"
+#include "util/log.h"
 #include "util/u_atomic.h"
+#include "util/u_debug.h"
 #include "util/u_thread.h"
 #include "util/u_cpu_detect.h"
 #include "util/thread_sched.h"
@@ -244,6 +246,8 @@ _mesa_glthread_init(struct gl_context *ctx)
    glthread->next_batch = &glthread->batches[glthread->next];
    glthread->used = 0;
    glthread->stats.queue = &glthread->queue;
+   glthread->SyncStatsEnabled =
+      debug_get_bool_option("MESA_GLTHREAD_SYNC_STATS", false);
 
    _mesa_glthread_init_call_fence(&glthread->LastProgramChangeBatch);
    _mesa_glthread_init_call_fence(&glthread->LastDListChangeBatchIndex);
@@ -270,6 +274,34 @@ free_vao(void *data, UNUSED void *userData)
    free(data);
 }
 
+static int
+compare_sync_stats(const void *a, const void *b)
+{
+   const struct glthread_sync_stat *sa = a, *sb = b;
+
+   /* Most syncs first. */
+   return sa->count < sb->count ? 1 : sa->count > sb->count ? -1 : 0;
+}
+
+static void
+print_sync_stats(struct glthread_state *glthread)
+{
+   unsigned total = 0;
+
+   qsort(glthread->SyncStats, glthread->NumSyncStats,
+         sizeof(glthread->SyncStats[0]), compare_sync_stats);
+
+   for (unsigned i = 0; i < glthread->NumSyncStats; i++)
+      total += glthread->SyncStats[i].count;
+
+   mesa_logi("glthread: %u batches, %u syncs, %u from entry points:",
+             glthread->stats.num_batches, glthread->stats.num_syncs, total);
+   for (unsigned i = 0; i < glthread->NumSyncStats; i++) {
+      mesa_logi("   %8u %s", glthread->SyncStats[i].count,
+                glthread->SyncStats[i].func);
+   }
+}
+
 void
 _mesa_glthread_destroy(struct gl_context *ctx)
 {
@@ -278,6 +310,9 @@ _mesa_glthread_destroy(struct gl_context *ctx)
    _mesa_glthread_disable(ctx);
 
    if (util_queue_is_initialized(&glthread->queue)) {
+      if (glthread->SyncStatsEnabled)
+         print_sync_stats(glthread);
+
       util_queue_destroy(&glthread->queue);
 
       for (unsigned i = 0; i < MARSHAL_MAX_BATCHES; i++)
@@ -432,13 +467,38 @@ _mesa_glthread_finish(struct gl_context *ctx)
       p_atomic_inc(&glthread->stats.num_syncs);
 }
 
+static void
+count_sync(struct glthread_state *glthread, const char *func)
+{
+   /* func is always a string literal, so comparing pointers is enough;
+    * the rare duplicate literal only splits an entry.
+    */
+   for (unsigned i = 0; i < glthread->NumSyncStats; i++) {
+      if (glthread->SyncStats[i].func == func) {
+         glthread->SyncStats[i].count++;
+         return;
+      }
+   }
+
+   if (glthread->NumSyncStats < ARRAY_SIZE(glthread->SyncStats)) {
+      glthread->SyncStats[glthread->NumSyncStats].func = func;
+      glthread->SyncStats[glthread->NumSyncStats].count = 1;
+      glthread->NumSyncStats++;
+   }
+}
+
 void
 _mesa_glthread_finish_before(struct gl_context *ctx, const char *func)
 {
+   struct glthread_state *glthread = &ctx->GLThread;
+   unsigned num_syncs = glthread->stats.num_syncs;
+
    _mesa_glthread_finish(ctx);
 
-   /* Uncomment this if you want to know where glthread syncs. */
-   /*printf("fallback to sync: %s\n", func);*/
+   /* Set MESA_GLTHREAD_SYNC_STATS=1 to know where glthread syncs. */
+   if (unlikely(glthread->SyncStatsEnabled) &&
+       glthread->stats.num_syncs != num_syncs)
+      count_sync(glthread, func);
 }
 
 void
@@ -170,6 +170,16 @@ struct glthread_client_attrib {
 
    /** Whether this element of the client attrib stack contains saved state. */
    bool Valid;
+
+   /** GL_CLIENT_PIXEL_STORE_BIT state, saved if PixelStoreValid is set. */
+   struct gl_pixelstore_attrib Unpack;
+   bool PixelStoreValid;
+};
+
+/* Number of syncs caused by an entry point, for MESA_GLTHREAD_SYNC_STATS. */
+struct glthread_sync_stat {
+   const char *func;
+   unsigned count;
 };
 
 /* For glPushAttrib / glPopAttrib. */
@@ -303,6 +313,14 @@ struct glthread_state
    bool LockGlobalMutexes;
 
    struct gl_pixelstore_attrib Unpack;
+
+   /** Syncs per entry point, only counted if MESA_GLTHREAD_SYNC_STATS is set.
+    * Entries are keyed by the string pointer passed to
+    * _mesa_glthread_finish_before and are only touched by the app thread.
+    */
+   bool SyncStatsEnabled;
+   unsigned NumSyncStats;
+   struct glthread_sync_stat SyncStats[64];
 };
 
 void _mesa_glthread_init(struct gl_context *ctx);
@@ -83,6 +83,79 @@ _mesa_marshal_GetIntegerv(GLenum pname, GLint *p)
    case GL_QUERY_BUFFER_BINDING:
       *p = ctx->GLThread.CurrentQueryBufferName;
       return;
+   case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+      *p = ctx->GLThread.CurrentVAO->CurrentElementBufferName;
+      return;
+   case GL_VERTEX_ARRAY_BINDING:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         goto sync;
+      *p = ctx->GLThread.CurrentVAO->Name;
+      return;
+
+   case GL_BLEND:
+      *p = ctx->GLThread.Blend;
+      return;
+   case GL_CULL_FACE:
+      *p = ctx->GLThread.CullFace;
+      return;
+   case GL_DEBUG_OUTPUT_SYNCHRONOUS:
+      *p = ctx->GLThread.DebugOutputSynchronous;
+      return;
+   case GL_DEPTH_TEST:
+      *p = ctx->GLThread.DepthTest;
+      return;
+   case GL_LIGHTING:
+      if (!_mesa_is_desktop_gl_compat(ctx) && !_mesa_is_gles1(ctx))
+         goto sync;
+      *p = ctx->GLThread.Lighting;
+      return;
+   case GL_POLYGON_STIPPLE:
+      if (!_mesa_is_desktop_gl_compat(ctx))
+         goto sync;
+      *p = ctx->GLThread.PolygonStipple;
+      return;
+
+   /* Apps often query these to save and restore them around texture
+    * uploads.
+    */
+   case GL_UNPACK_ALIGNMENT:
+      *p = ctx->GLThread.Unpack.Alignment;
+      return;
+   case GL_UNPACK_ROW_LENGTH:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         goto sync;
+      *p = ctx->GLThread.Unpack.RowLength;
+      return;
+   case GL_UNPACK_SKIP_PIXELS:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         goto sync;
+      *p = ctx->GLThread.Unpack.SkipPixels;
+      return;
+   case GL_UNPACK_SKIP_ROWS:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         goto sync;
+      *p = ctx->GLThread.Unpack.SkipRows;
+      return;
+   case GL_UNPACK_IMAGE_HEIGHT:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         goto sync;
+      *p = ctx->GLThread.Unpack.ImageHeight;
+      return;
+   case GL_UNPACK_SKIP_IMAGES:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         goto sync;
+      *p = ctx->GLThread.Unpack.SkipImages;
+      return;
+   case GL_UNPACK_SWAP_BYTES:
+      if (!_mesa_is_desktop_gl(ctx))
+         goto sync;
+      *p = ctx->GLThread.Unpack.SwapBytes;
+      return;
+   case GL_UNPACK_LSB_FIRST:
+      if (!_mesa_is_desktop_gl(ctx))
+         goto sync;
+      *p = ctx->GLThread.Unpack.LsbFirst;
+      return;
 
    case GL_MATRIX_MODE:
       *p = ctx->GLThread.MatrixMode;
@@ -598,6 +598,21 @@ _mesa_glthread_DSAElementBuffer(struct gl_context *ctx, GLuint vaobj,
       vao->CurrentElementBufferName = buffer;
 }
 
+/* The same subset of the state that glPopClientAttrib restores. */
+static void
+copy_unpack(struct gl_pixelstore_attrib *dst,
+            const struct gl_pixelstore_attrib *src)
+{
+   dst->Alignment = src->Alignment;
+   dst->RowLength = src->RowLength;
+   dst->SkipPixels = src->SkipPixels;
+   dst->SkipRows = src->SkipRows;
+   dst->ImageHeight = src->ImageHeight;
+   dst->SkipImages = src->SkipImages;
+   dst->SwapBytes = src->SwapBytes;
+   dst->LsbFirst = src->LsbFirst;
+}
+
 void
 _mesa_glthread_PushClientAttrib(struct gl_context *ctx, GLbitfield mask,
                                 bool set_default)
@@ -622,6 +637,10 @@ _mesa_glthread_PushClientAttrib(struct gl_context *ctx, GLbitfield mask,
       top->Valid = false;
    }
 
+   top->PixelStoreValid = (mask & GL_CLIENT_PIXEL_STORE_BIT) != 0;
+   if (top->PixelStoreValid)
+      copy_unpack(&top->Unpack, &glthread->Unpack);
+
    glthread->ClientAttribStackTop++;
 
    if (set_default)
@@ -641,6 +660,9 @@ _mesa_glthread_PopClientAttrib(struct gl_context *ctx)
    struct glthread_client_attrib *top =
       &glthread->ClientAttribStack[glthread->ClientAttribStackTop];
 
+   if (top->PixelStoreValid)
+      copy_unpack(&glthread->Unpack, &top->Unpack);
+
    if (!top->Valid)
       return;
 
@@ -672,6 +694,17 @@ _mesa_glthread_ClientAttribDefault(struct gl_context *ctx, GLbitfield mask)
 {
    struct glthread_state *glthread = &ctx->GLThread;
 
+   if (mask & GL_CLIENT_PIXEL_STORE_BIT) {
+      glthread->Unpack.SwapBytes = false;
+      glthread->Unpack.LsbFirst = false;
+      glthread->Unpack.ImageHeight = 0;
+      glthread->Unpack.SkipImages = 0;
+      glthread->Unpack.RowLength = 0;
+      glthread->Unpack.SkipRows = 0;
+      glthread->Unpack.SkipPixels = 0;
+      glthread->Unpack.Alignment = 4;
+   }
+
    if (!(mask & GL_CLIENT_VERTEX_ARRAY_BIT))
       return;
 
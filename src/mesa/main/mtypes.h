@@ -79,6 +79,7 @@ struct gl_meta_state;
 struct gl_program_cache;
 struct gl_texture_object;
 struct gl_debug_state;
+struct glsl_compile_cache;
 struct gl_context;
 struct st_context;
 struct gl_uniform_storage;
@@ -1646,6 +1647,27 @@ struct gl_vertex_array_object
 
    /** The index buffer (also known as the element array buffer in OpenGL). */
    struct gl_buffer_object *IndexBufferObj;
+
+   /**
+    * Incremented whenever attrib formats, bindings, strides, divisors or
+    * enables change, i.e. everything that sets NewVertexElements for this
+    * VAO, whether it's bound or not.
+    */
+   unsigned _VertexElementsGeneration;
+
+   /**
+    * The vertex elements CSO that st/mesa created the last time this VAO
+    * was used, and the inputs it was created for. Unused for shared VAOs.
+    */
+   struct {
+      void *handle;
+      const void *cso;
+      unsigned generation;
+      unsigned cso_generation;
+      GLbitfield inputs_read;
+      GLbitfield dual_slot_inputs;
+      unsigned count;
+   } _VertexElementsCache;
 };
 
 
@@ -3644,6 +3666,12 @@ struct gl_context
 
    struct disk_cache *Cache;
 
+   /**
+    * In-memory cache of compiled GLSL shaders, keyed by preprocessed source.
+    * See _mesa_glsl_compile_shader().
+    */
+   struct glsl_compile_cache *GLSLCompileCache;
+
    /**
     * \name GL_ARB_bindless_texture
     */
@@ -234,6 +234,8 @@ _mesa_free_shader_state(struct gl_context *ctx)
    /* Extended for ARB_separate_shader_objects */
    _mesa_reference_pipeline_object(ctx, &ctx->_Shader, NULL);
 
+   _mesa_glsl_free_compile_cache(ctx);
+
    assert(ctx->Shader.RefCount == 1);
 }
 
@@ -2376,6 +2378,8 @@ _mesa_ReleaseShaderCompiler(void)
       _mesa_glsl_builtin_functions_decref();
       ctx->shader_builtin_ref = false;
    }
+
+   _mesa_glsl_release_builtin_functions();
 }
 
 
@@ -75,6 +75,7 @@
 #include "pixeltransfer.h"
 #include "util/format_rgb9e5.h"
 #include "util/format_r11g11b10f.h"
+#include "util/u_parallel.h"
 
 #include "state_tracker/st_cb_texture.h"
 
@@ -675,6 +676,62 @@ texstore_compressed(TEXSTORE_PARAMS)
                            srcFormat, srcType, srcAddr, srcPacking);
 }
 
+/* Images are converted by several threads in bands of at least this many
+ * bytes.
+ */
+#define TEXSTORE_PARALLEL_MIN_SIZE (2 * 1024 * 1024)
+
+struct texstore_image {
+   void *dst;
+   uint32_t dstFormat;
+   int dstRowStride;
+   const void *src;
+   uint32_t srcFormat;
+   int srcRowStride;
+   int width;
+   const uint8_t *rebaseSwizzle;
+};
+
+static void
+texstore_convert_band(void *data, unsigned start, unsigned count)
+{
+   const struct texstore_image *image = data;
+
+   _mesa_format_convert((uint8_t *)image->dst + (intptr_t)start * image->dstRowStride,
+                        image->dstFormat, image->dstRowStride,
+                        (uint8_t *)image->src + (intptr_t)start * image->srcRowStride,
+                        image->srcFormat, image->srcRowStride,
+                        image->width, count,
+                        (uint8_t *)image->rebaseSwizzle);
+}
+
+/**
+ * _mesa_format_convert for one image, split into bands of rows that are
+ * converted in parallel if the image is large enough.
+ */
+static void
+texstore_convert_image(void *dst, uint32_t dstFormat, int dstRowStride,
+                       const void *src, uint32_t srcFormat, int srcRowStride,
+                       int width, int height, const uint8_t *rebaseSwizzle)
+{
+   struct texstore_image image = {
+      .dst = dst,
+      .dstFormat = dstFormat,
+      .dstRowStride = dstRowStride,
+      .src = src,
+      .srcFormat = srcFormat,
+      .srcRowStride = srcRowStride,
+      .width = width,
+      .rebaseSwizzle = rebaseSwizzle,
+   };
+
+   util_parallel_for(height,
+                     DIV_ROUND_UP(TEXSTORE_PARALLEL_MIN_SIZE,
+                                  MAX2(abs(dstRowStride), 1)),
+                     texstore_convert_band, &image);
+}
+
+
 static GLboolean
 texstore_rgba(TEXSTORE_PARAMS)
 {
@@ -817,10 +874,10 @@ texstore_rgba(TEXSTORE_PARAMS)
    }
 
    for (img = 0; img < srcDepth; img++) {
-      _mesa_format_convert(dstSlices[img], dstFormat, dstRowStride,
-                           src, srcMesaFormat, srcRowStride,
-                           srcWidth, srcHeight,
-                           needRebase ? rebaseSwizzle : NULL);
+      texstore_convert_image(dstSlices[img], dstFormat, dstRowStride,
+                             src, srcMesaFormat, srcRowStride,
+                             srcWidth, srcHeight,
+                             needRebase ? rebaseSwizzle : NULL);
       src += (size_t)srcHeight * srcRowStride;
    }
 
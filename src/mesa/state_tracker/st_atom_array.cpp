@@ -449,13 +449,48 @@ st_update_array_templ(struct st_context *st,
       vbuffer = vbuffer_local;
    }
 
+   /* Without zero-stride attribs, vertex elements only depend on the VAO
+    * and the vertex shader inputs, so apps switching between a few VAOs can
+    * reuse the CSO from the last time each VAO was used instead of
+    * rebuilding and hashing the vertex elements.
+    */
+   struct gl_vertex_array_object *vao = ctx->Array._DrawVAO;
+   struct cso_context *cso = st->cso_context;
+   const bool use_velems_cache = UPDATE_VELEMS && FILL_TC_SET_VB &&
+                                 !ALLOW_ZERO_STRIDE_ATTRIBS &&
+                                 !vao->SharedAndImmutable;
+   const unsigned velems_count = vp->num_inputs +
+                                 vp_variant->key.passthrough_edgeflags;
+   bool velems_cached = false;
+
+   if (use_velems_cache) {
+      velems_cached =
+         vao->_VertexElementsCache.handle &&
+         vao->_VertexElementsCache.cso == cso &&
+         vao->_VertexElementsCache.generation ==
+            vao->_VertexElementsGeneration &&
+         vao->_VertexElementsCache.cso_generation ==
+            cso->velements_generation &&
+         vao->_VertexElementsCache.inputs_read == inputs_read &&
+         vao->_VertexElementsCache.dual_slot_inputs == dual_slot_inputs &&
+         vao->_VertexElementsCache.count == velems_count;
+   }
+
    /* ST_NEW_VERTEX_ARRAYS */
    /* Setup arrays */
-   setup_arrays<POPCNT, FILL_TC_SET_VB, USE_VAO_FAST_PATH,
-                ALLOW_ZERO_STRIDE_ATTRIBS, HAS_IDENTITY_ATTRIB_MAPPING,
-                ALLOW_USER_BUFFERS, UPDATE_VELEMS>
-      (ctx, ctx->Array._DrawVAO, dual_slot_inputs, inputs_read,
-       inputs_read & enabled_arrays, &velements, vbuffer, &num_vbuffers);
+   if (velems_cached) {
+      setup_arrays<POPCNT, FILL_TC_SET_VB, USE_VAO_FAST_PATH,
+                   ALLOW_ZERO_STRIDE_ATTRIBS, HAS_IDENTITY_ATTRIB_MAPPING,
+                   ALLOW_USER_BUFFERS, UPDATE_VELEMS_OFF>
+         (ctx, vao, dual_slot_inputs, inputs_read,
+          inputs_read & enabled_arrays, &velements, vbuffer, &num_vbuffers);
+   } else {
+      setup_arrays<POPCNT, FILL_TC_SET_VB, USE_VAO_FAST_PATH,
+                   ALLOW_ZERO_STRIDE_ATTRIBS, HAS_IDENTITY_ATTRIB_MAPPING,
+                   ALLOW_USER_BUFFERS, UPDATE_VELEMS>
+         (ctx, vao, dual_slot_inputs, inputs_read,
+          inputs_read & enabled_arrays, &velements, vbuffer, &num_vbuffers);
+   }
 
    /* _NEW_CURRENT_ATTRIB */
    /* Setup zero-stride attribs. */
@@ -471,11 +506,29 @@ st_update_array_templ(struct st_context *st,
          assert(num_vbuffers == num_vbuffers_tc);
 
    if (UPDATE_VELEMS) {
-      struct cso_context *cso = st->cso_context;
-      velements.count = vp->num_inputs + vp_variant->key.passthrough_edgeflags;
+      velements.count = velems_count;
 
       /* Set vertex buffers and elements. */
-      if (FILL_TC_SET_VB) {
+      if (use_velems_cache) {
+         void *handle;
+
+         if (velems_cached) {
+            handle = vao->_VertexElementsCache.handle;
+         } else {
+            handle = cso_get_vertex_elements_handle(cso, &velements);
+            vao->_VertexElementsCache.handle = handle;
+            vao->_VertexElementsCache.cso = cso;
+            vao->_VertexElementsCache.generation =
+               vao->_VertexElementsGeneration;
+            vao->_VertexElementsCache.cso_generation =
+               cso->velements_generation;
+            vao->_VertexElementsCache.inputs_read = inputs_read;
+            vao->_VertexElementsCache.dual_slot_inputs = dual_slot_inputs;
+            vao->_VertexElementsCache.count = velems_count;
+         }
+         tc_set_vertex_elements_for_call(st->pipe, vbuffer,
+                                         cso_vertex_elements_handle_for_bind(cso, handle));
+      } else if (FILL_TC_SET_VB) {
          void *state = cso_get_vertex_elements_for_bind(cso, &velements);
          tc_set_vertex_elements_for_call(st->pipe, vbuffer, state);
       } else {
@@ -570,9 +570,19 @@ st_ReadPixels(struct gl_context *ctx, GLint x, GLint y,
    return;
 
 fallback:
-   if (rb->TexImage && (st->allow_compute_based_texture_transfer || st->force_compute_based_texture_transfer)) {
-      if (st_GetTexSubImage_shader(ctx, x, y, 0, width, height, 1, format, type, pixels, rb->TexImage))
-         return;
+   if (st->allow_compute_based_texture_transfer || st->force_compute_based_texture_transfer) {
+      if (rb->TexImage) {
+         if (st_GetTexSubImage_shader(ctx, x, y, 0, width, height, 1, format, type, pixels, rb->TexImage))
+            return;
+      } else {
+         /* window-system and plain renderbuffers: convert on the GPU too, and
+          * write straight into the PBO without waiting for the result */
+         if (st_ReadPixels_shader(ctx, rb,
+                                  _mesa_fb_orientation(ctx->ReadBuffer) == Y_0_TOP,
+                                  x, y, width, height, format, type,
+                                  pack, pixels))
+            return;
+      }
    }
    _mesa_readpixels(ctx, x, y, width, height, format, type, pack, pixels);
 }
@@ -83,6 +83,7 @@
 #include "util/u_math.h"
 #include "util/box.h"
 #include "util/u_memory.h"
+#include "util/u_parallel.h"
 #include "cso_cache/cso_context.h"
 
 #define DBG if (0) printf
@@ -628,6 +629,92 @@ log_unmap_time_delta(const struct pipe_box *box,
              pathname, os_time_get() - start_us);
 }
 
+/* Compressed fallback images are decompressed in bands of block rows by the
+ * shared util_parallel_for() pool once they have at least this many blocks.
+ */
+#define ST_DECOMPRESS_PARALLEL_MIN_BLOCKS (8 * 1024)
+
+struct st_decompress_image {
+   mesa_format format;
+   bool bgra;
+   uint8_t *dst;
+   unsigned dst_stride;
+   const uint8_t *src;
+   unsigned src_stride;
+   unsigned width;
+   unsigned height;
+   unsigned block_height;
+};
+
+static void
+decompress_band(void *data, unsigned start, unsigned count)
+{
+   const struct st_decompress_image *image = data;
+   const unsigned y = start * image->block_height;
+   const unsigned height = MIN2(count * image->block_height, image->height - y);
+   uint8_t *dst = image->dst + (size_t)y * image->dst_stride;
+   const uint8_t *src = image->src + (size_t)start * image->src_stride;
+
+   if (image->format == MESA_FORMAT_ETC1_RGB8) {
+      _mesa_etc1_unpack_rgba8888(dst, image->dst_stride, src, image->src_stride,
+                                 image->width, height);
+   } else if (_mesa_is_format_etc2(image->format)) {
+      _mesa_unpack_etc2_format(dst, image->dst_stride, src, image->src_stride,
+                               image->width, height, image->format,
+                               image->bgra);
+   } else if (_mesa_is_format_s3tc(image->format)) {
+      _mesa_unpack_s3tc(dst, image->dst_stride, src, image->src_stride,
+                        image->width, height, image->format);
+   } else if (_mesa_is_format_rgtc(image->format) ||
+              _mesa_is_format_latc(image->format)) {
+      _mesa_unpack_rgtc(dst, image->dst_stride, src, image->src_stride,
+                        image->width, height, image->format);
+   } else if (_mesa_is_format_bptc(image->format)) {
+      _mesa_unpack_bptc(dst, image->dst_stride, src, image->src_stride,
+                        image->width, height, image->format);
+   } else {
+      UNREACHABLE("unexpected format for a compressed format fallback");
+   }
+}
+
+/**
+ * Decompress a compressed fallback image to RGBA8.
+ */
+static void
+decompress_image(uint8_t *dst, unsigned dst_stride,
+                 const uint8_t *src, unsigned src_stride,
+                 unsigned width, unsigned height,
+                 mesa_format format, bool bgra)
+{
+   /* The ASTC decoder splits large images across threads by itself. */
+   if (_mesa_is_format_astc_2d(format)) {
+      _mesa_unpack_astc_2d_ldr(dst, dst_stride, src, src_stride,
+                               width, height, format);
+      return;
+   }
+
+   GLuint bw, bh;
+   _mesa_get_format_block_size(format, &bw, &bh);
+
+   struct st_decompress_image image = {
+      .format = format,
+      .bgra = bgra,
+      .dst = dst,
+      .dst_stride = dst_stride,
+      .src = src,
+      .src_stride = src_stride,
+      .width = width,
+      .height = height,
+      .block_height = bh,
+   };
+   const unsigned x_blocks = DIV_ROUND_UP(width, bw);
+
+   util_parallel_for(DIV_ROUND_UP(height, bh),
+                     DIV_ROUND_UP(ST_DECOMPRESS_PARALLEL_MIN_BLOCKS,
+                                  MAX2(x_blocks, 1)),
+                     decompress_band, &image);
+}
+
 /**
  * Upload ASTC data but flush denorms in any void extent blocks.
  */
@@ -775,32 +862,11 @@ st_UnmapTextureImage(struct gl_context *ctx,
             void *tmp = malloc(size);
 
             /* Decompress to tmp. */
-            if (texImage->TexFormat == MESA_FORMAT_ETC1_RGB8) {
-               _mesa_etc1_unpack_rgba8888(tmp, transfer->box.width * 4,
-                                          itransfer->temp_data,
-                                          itransfer->temp_stride,
-                                          transfer->box.width,
-                                          transfer->box.height);
-            } else if (_mesa_is_format_etc2(texImage->TexFormat)) {
-               bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
-
-               _mesa_unpack_etc2_format(tmp, transfer->box.width * 4,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width,
-                                        transfer->box.height,
-                                        texImage->TexFormat,
-                                        bgra);
-            } else if (_mesa_is_format_astc_2d(texImage->TexFormat)) {
-               _mesa_unpack_astc_2d_ldr(tmp, transfer->box.width * 4,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width,
-                                        transfer->box.height,
-                                        texImage->TexFormat);
-            } else {
-               UNREACHABLE("unexpected format for a compressed format fallback");
-            }
+            decompress_image(tmp, transfer->box.width * 4,
+                             itransfer->temp_data, itransfer->temp_stride,
+                             transfer->box.width, transfer->box.height,
+                             texImage->TexFormat,
+                             texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB);
 
             /* Compress it to the target format. */
             struct gl_pixelstore_attrib pack = {0};
@@ -814,49 +880,11 @@ st_UnmapTextureImage(struct gl_context *ctx,
             free(tmp);
          } else {
             /* Decompress into an uncompressed format. */
-            if (texImage->TexFormat == MESA_FORMAT_ETC1_RGB8) {
-               _mesa_etc1_unpack_rgba8888(map, transfer->stride,
-                                          itransfer->temp_data,
-                                          itransfer->temp_stride,
-                                          transfer->box.width,
-                                          transfer->box.height);
-            } else if (_mesa_is_format_etc2(texImage->TexFormat)) {
-               bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
-
-               _mesa_unpack_etc2_format(map, transfer->stride,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width, transfer->box.height,
-                                        texImage->TexFormat,
-                                        bgra);
-            } else if (_mesa_is_format_astc_2d(texImage->TexFormat)) {
-               _mesa_unpack_astc_2d_ldr(map, transfer->stride,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width, transfer->box.height,
-                                        texImage->TexFormat);
-            } else if (_mesa_is_format_s3tc(texImage->TexFormat)) {
-               _mesa_unpack_s3tc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else if (_mesa_is_format_rgtc(texImage->TexFormat) ||
-                       _mesa_is_format_latc(texImage->TexFormat)) {
-               _mesa_unpack_rgtc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else if (_mesa_is_format_bptc(texImage->TexFormat)) {
-               _mesa_unpack_bptc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else {
-               UNREACHABLE("unexpected format for a compressed format fallback");
-            }
+            decompress_image(map, transfer->stride,
+                             itransfer->temp_data, itransfer->temp_stride,
+                             transfer->box.width, transfer->box.height,
+                             texImage->TexFormat,
+                             texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB);
          }
 
          st_texture_image_unmap(st, texImage, slice);
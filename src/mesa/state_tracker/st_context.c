@@ -805,7 +805,7 @@ st_init_driver_functions(struct pipe_screen *screen,
    functions->ProgramBinarySerializeDriverBlob =
       st_serialise_nir_program_binary;
    functions->ProgramBinaryDeserializeDriverBlob =
-      st_deserialise_nir_program;
+      st_deserialise_nir_program_binary;
 }
 
 
@@ -1220,6 +1220,7 @@ void st_init_extensions(struct pipe_screen *screen,
    consts->AllowGLSLCompatShaders = options->allow_glsl_compat_shaders;
 
    consts->ForceGLSLAbsSqrt = options->force_glsl_abs_sqrt;
+   consts->GLSLESSkipIROptimizations = options->glsl_es_skip_ir_optimizations;
 
    consts->AllowGLSLBuiltinVariableRedeclaration = options->allow_glsl_builtin_variable_redeclaration;
 
@@ -785,8 +785,10 @@ st_context_flush(struct st_context *st, unsigned flags,
 
    MESA_TRACE_FUNC();
 
-   if (flags & ST_FLUSH_END_OF_FRAME)
+   if (flags & ST_FLUSH_END_OF_FRAME) {
+      MESA_TRACE_FRAME_MARK();
       pipe_flags |= PIPE_FLUSH_END_OF_FRAME;
+   }
    if (flags & ST_FLUSH_FENCE_FD)
       pipe_flags |= PIPE_FLUSH_FENCE_FD;
 
@@ -25,6 +25,7 @@
 #define ST_PBO_H
 
 struct gl_pixelstore_attrib;
+struct gl_renderbuffer;
 
 struct st_context;
 
@@ -117,6 +118,13 @@ st_GetTexSubImage_shader(struct gl_context * ctx,
                          GLenum format, GLenum type, void * pixels,
                          struct gl_texture_image *texImage);
 
+bool
+st_ReadPixels_shader(struct gl_context *ctx, struct gl_renderbuffer *rb,
+                     bool invert_y, GLint x, GLint y,
+                     GLsizei width, GLsizei height,
+                     GLenum format, GLenum type,
+                     const struct gl_pixelstore_attrib *pack, void *pixels);
+
 enum pipe_format
 st_pbo_get_dst_format(struct gl_context *ctx, enum pipe_texture_target target,
                       enum pipe_format src_format, bool is_compressed,
@@ -371,13 +371,15 @@ get_buffer_offset(nir_builder *b, nir_def *coord, struct pbo_shader_data *sd)
                                       nir_iadd_imm(b, nir_iadd(b, bytes_per_row, sd->alignment), -1),
                                       nir_inot(b, nir_iadd_imm(b, sd->alignment, -1))));
    nir_def *bytes_per_image = nir_imul(b, bytes_per_row, nir_channel(b, sd->range, 1));
-   bytes_per_row = nir_bcsel(b, sd->invert,
-                             nir_ineg(b, bytes_per_row),
-                             bytes_per_row);
+   /* inverted images start with the last row, so count rows from the bottom */
+   nir_def *row = nir_channel(b, coord, 1);
+   row = nir_bcsel(b, sd->invert,
+                   nir_isub(b, nir_iadd_imm(b, nir_channel(b, sd->range, 1), -1), row),
+                   row);
    return nir_iadd(b,
                    nir_imul(b, nir_channel(b, coord, 0), sd->blocksize),
                    nir_iadd(b,
-                            nir_imul(b, nir_channel(b, coord, 1), bytes_per_row),
+                            nir_imul(b, row, bytes_per_row),
                             nir_imul(b, nir_channel(b, coord, 2), bytes_per_image)));
 }
 
@@ -882,7 +884,8 @@ download_texture_compute(struct st_context *st,
                          enum pipe_texture_target view_target,
                          struct pipe_resource *src,
                          enum pipe_format dst_format,
-                         enum swizzle_clamp swizzle_clamp)
+                         enum swizzle_clamp swizzle_clamp,
+                         bool invert_y, uintptr_t pbo_offset)
 {
    struct pipe_context *pipe = st->pipe;
    struct pipe_screen *screen = st->screen;
@@ -903,7 +906,7 @@ download_texture_compute(struct st_context *st,
       .width = MIN2(width, 65535),
       .height = MIN2(height, 65535),
       .depth = MIN2(depth, 65535),
-      .invert = pack->Invert,
+      .invert = pack->Invert ^ invert_y,
       .blocksize = util_format_get_blocksize(dst_format) - 1,
       .alignment = ffs(MAX2(pack->Alignment, 1)) - 1,
    };
@@ -1135,7 +1138,8 @@ download_texture_compute(struct st_context *st,
       memset(&buffer, 0, sizeof(buffer));
       if (can_copy_direct(pack) && pack->BufferObj) {
          dst = pack->BufferObj->buffer;
-         assert(pack->BufferObj->Size >= buffer_size);
+         buffer.buffer_offset = pbo_offset;
+         assert(pack->BufferObj->Size >= pbo_offset + buffer_size);
       } else {
          dst = pipe_buffer_create(screen, PIPE_BIND_SHADER_BUFFER, PIPE_USAGE_STAGING, buffer_size);
          if (!dst)
@@ -1182,7 +1186,7 @@ fail:
 
 static void
 copy_converted_buffer(struct gl_context * ctx,
-                    struct gl_pixelstore_attrib *pack,
+                    const struct gl_pixelstore_attrib *pack,
                     enum pipe_texture_target view_target,
                     struct pipe_resource *dst, enum pipe_format dst_format,
                     GLint xoffset, GLint yoffset, GLint zoffset,
@@ -1235,35 +1239,37 @@ copy_converted_buffer(struct gl_context * ctx,
    pipe_buffer_unmap(st->pipe, xfer);
 }
 
-bool
-st_GetTexSubImage_shader(struct gl_context * ctx,
-                         GLint xoffset, GLint yoffset, GLint zoffset,
-                         GLsizei width, GLsizei height, GLint depth,
-                         GLenum format, GLenum type, void * pixels,
-                         struct gl_texture_image *texImage)
+static bool
+download_shader(struct gl_context *ctx,
+                const struct gl_pixelstore_attrib *pack,
+                struct pipe_resource *src, enum pipe_format src_format,
+                mesa_format tex_format, GLenum base_format,
+                unsigned level, unsigned layer, bool invert_y,
+                GLint xoffset, GLint yoffset, GLint zoffset,
+                GLsizei width, GLsizei height, GLint depth,
+                GLenum format, GLenum type, void *pixels)
 {
    struct st_context *st = st_context(ctx);
    struct pipe_screen *screen = st->screen;
-   struct gl_texture_object *stObj = texImage->TexObject;
-   struct pipe_resource *src = texImage->pt;
    struct pipe_resource *dst = NULL;
-   enum pipe_format dst_format, src_format;
-   unsigned level = (texImage->pt != stObj->pt ? 0 : texImage->Level) + texImage->TexObject->Attrib.MinLevel;
-   unsigned layer = texImage->Face + texImage->TexObject->Attrib.MinLayer;
+   enum pipe_format dst_format;
    enum pipe_texture_target view_target;
 
-   assert(!_mesa_is_format_etc2(texImage->TexFormat) &&
-          !_mesa_is_format_astc_2d(texImage->TexFormat) &&
-          texImage->TexFormat != MESA_FORMAT_ETC1_RGB8);
-
    /* See if the texture format already matches the format and type,
     * in which case the memcpy-based fast path will be used. */
-   if (_mesa_format_matches_format_and_type(texImage->TexFormat, format,
-                                            type, ctx->Pack.SwapBytes, NULL)) {
+   if (_mesa_format_matches_format_and_type(tex_format, format,
+                                            type, pack->SwapBytes, NULL)) {
       return false;
    }
+
+   /* the shader writes straight into the PBO, which has to be bindable at
+    * the requested offset */
+   if (can_copy_direct(pack) && pack->BufferObj &&
+       (uintptr_t)pixels % MAX2(screen->caps.shader_buffer_offset_alignment, 1))
+      return false;
+
    enum swizzle_clamp swizzle_clamp = 0;
-   src_format = st_pbo_get_src_format(screen, stObj->surface_based ? stObj->surface_format : src->format, src);
+   src_format = st_pbo_get_src_format(screen, src_format, src);
    if (src_format == PIPE_FORMAT_NONE)
       return false;
 
@@ -1271,17 +1277,17 @@ st_GetTexSubImage_shader(struct gl_context * ctx,
    if (format == GL_STENCIL_INDEX && util_format_is_depth_and_stencil(src_format))
       src_format = PIPE_FORMAT_X24S8_UINT;
 
-   if (texImage->_BaseFormat != _mesa_get_format_base_format(texImage->TexFormat)) {
+   if (base_format != _mesa_get_format_base_format(tex_format)) {
       /* special handling for drivers that don't support these formats natively */
-      if (texImage->_BaseFormat == GL_LUMINANCE)
+      if (base_format == GL_LUMINANCE)
          swizzle_clamp = SWIZZLE_CLAMP_LUMINANCE;
-      else if (texImage->_BaseFormat == GL_LUMINANCE_ALPHA)
+      else if (base_format == GL_LUMINANCE_ALPHA)
          swizzle_clamp = SWIZZLE_CLAMP_LUMINANCE_ALPHA;
-      else if (texImage->_BaseFormat == GL_ALPHA)
+      else if (base_format == GL_ALPHA)
          swizzle_clamp = SWIZZLE_CLAMP_ALPHA;
-      else if (texImage->_BaseFormat == GL_INTENSITY)
+      else if (base_format == GL_INTENSITY)
          swizzle_clamp = SWIZZLE_CLAMP_INTENSITY;
-      else if (texImage->_BaseFormat == GL_RGB)
+      else if (base_format == GL_RGB)
          swizzle_clamp = SWIZZLE_CLAMP_RGBX;
    }
 
@@ -1321,14 +1327,14 @@ st_GetTexSubImage_shader(struct gl_context * ctx,
        (!util_format_is_float(src_format) && dst_format == PIPE_FORMAT_L32_FLOAT))
       return false;
 
-   dst = download_texture_compute(st, &ctx->Pack, xoffset, yoffset, zoffset, width, height, depth,
+   dst = download_texture_compute(st, pack, xoffset, yoffset, zoffset, width, height, depth,
                                   level, layer, format, type, src_format, view_target, src, dst_format,
-                                  swizzle_clamp);
+                                  swizzle_clamp, invert_y, (uintptr_t)pixels);
    if (!dst)
       return false;
 
-   if (!can_copy_direct(&ctx->Pack) || !ctx->Pack.BufferObj) {
-      copy_converted_buffer(ctx, &ctx->Pack, view_target, dst, dst_format, xoffset, yoffset, zoffset,
+   if (!can_copy_direct(pack) || !pack->BufferObj) {
+      copy_converted_buffer(ctx, pack, view_target, dst, dst_format, xoffset, yoffset, zoffset,
                           width, height, depth, format, type, pixels);
 
       pipe_resource_reference(&dst, NULL);
@@ -1337,6 +1343,53 @@ st_GetTexSubImage_shader(struct gl_context * ctx,
    return true;
 }
 
+bool
+st_GetTexSubImage_shader(struct gl_context * ctx,
+                         GLint xoffset, GLint yoffset, GLint zoffset,
+                         GLsizei width, GLsizei height, GLint depth,
+                         GLenum format, GLenum type, void * pixels,
+                         struct gl_texture_image *texImage)
+{
+   struct gl_texture_object *stObj = texImage->TexObject;
+   struct pipe_resource *src = texImage->pt;
+   unsigned level = (texImage->pt != stObj->pt ? 0 : texImage->Level) + texImage->TexObject->Attrib.MinLevel;
+   unsigned layer = texImage->Face + texImage->TexObject->Attrib.MinLayer;
+
+   assert(!_mesa_is_format_etc2(texImage->TexFormat) &&
+          !_mesa_is_format_astc_2d(texImage->TexFormat) &&
+          texImage->TexFormat != MESA_FORMAT_ETC1_RGB8);
+
+   return download_shader(ctx, &ctx->Pack, src,
+                          stObj->surface_based ? stObj->surface_format : src->format,
+                          texImage->TexFormat, texImage->_BaseFormat,
+                          level, layer, false,
+                          xoffset, yoffset, zoffset, width, height, depth,
+                          format, type, pixels);
+}
+
+bool
+st_ReadPixels_shader(struct gl_context *ctx, struct gl_renderbuffer *rb,
+                     bool invert_y, GLint x, GLint y,
+                     GLsizei width, GLsizei height,
+                     GLenum format, GLenum type,
+                     const struct gl_pixelstore_attrib *pack, void *pixels)
+{
+   struct pipe_resource *src = rb->texture;
+
+   /* the shader fetches single samples */
+   if (!src || src->nr_samples > 1)
+      return false;
+
+   if (invert_y)
+      y = rb->Height - y - height;
+
+   return download_shader(ctx, pack, src, src->format,
+                          rb->Format, rb->_BaseFormat,
+                          rb->surface.level, rb->surface.first_layer, invert_y,
+                          x, y, 0, width, height, 1,
+                          format, type, pixels);
+}
+
 void
 st_pbo_compute_deinit(struct st_context *st)
 {
@@ -141,16 +141,13 @@ read_stream_out_from_cache(struct blob_reader *blob_reader,
    }
 }
 
-void
-st_deserialise_nir_program(struct gl_context *ctx,
-                          struct gl_shader_program *shProg,
-                          struct gl_program *prog)
+static void
+deserialise_nir_program(struct gl_context *ctx,
+                        struct gl_shader_program *shProg,
+                        struct gl_program *prog,
+                        const uint8_t *buffer, size_t size)
 {
    struct st_context *st = st_context(ctx);
-   size_t size = prog->driver_cache_blob_size;
-   uint8_t *buffer = (uint8_t *) prog->driver_cache_blob;
-
-   MESA_TRACE_FUNC();
 
    st_set_prog_affected_state_flags(prog);
 
@@ -160,7 +157,7 @@ st_deserialise_nir_program(struct gl_context *ctx,
     */
    _mesa_ensure_and_associate_uniform_storage(ctx, shProg, prog, 16);
 
-   assert(prog->driver_cache_blob && prog->driver_cache_blob_size > 0);
+   assert(buffer && size > 0);
 
    struct blob_reader blob_reader;
    blob_reader_init(&blob_reader, buffer, size);
@@ -208,6 +205,18 @@ st_deserialise_nir_program(struct gl_context *ctx,
    st_finalize_program(st, prog, false);
 }
 
+void
+st_deserialise_nir_program(struct gl_context *ctx,
+                          struct gl_shader_program *shProg,
+                          struct gl_program *prog)
+{
+   MESA_TRACE_FUNC();
+
+   deserialise_nir_program(ctx, shProg, prog,
+                           (const uint8_t *)prog->driver_cache_blob,
+                           prog->driver_cache_blob_size);
+}
+
 bool
 st_load_nir_from_disk_cache(struct gl_context *ctx,
                             struct gl_shader_program *prog)
@@ -242,10 +251,85 @@ st_load_nir_from_disk_cache(struct gl_context *ctx,
    return true;
 }
 
+static bool
+is_driver_variant(struct gl_program *prog, struct st_variant *v)
+{
+   if (!v->driver_shader)
+      return false;
+
+   return prog->info.stage == MESA_SHADER_FRAGMENT ||
+          !((struct st_common_variant *)v)->key.is_draw_shader;
+}
+
+/**
+ * Program binaries carry the driver code of the variants in front of the
+ * NIR, so that the default variant doesn't have to be compiled again when
+ * the binary is loaded by the same driver build on the same GPU, which the
+ * driver sha1 in the header guarantees.
+ */
 void
 st_serialise_nir_program_binary(struct gl_context *ctx,
                                 struct gl_shader_program *shProg,
                                 struct gl_program *prog)
 {
+   struct st_context *st = st_context(ctx);
+   struct pipe_screen *screen = st->screen;
+   struct blob blob;
+
    st_serialise_nir_program(ctx, prog);
+
+   blob_init(&blob);
+
+   intptr_t size_offset = blob_reserve_uint32(&blob);
+   if (screen->get_shader_binary) {
+      for (struct st_variant *v = prog->variants; v; v = v->next) {
+         if (v->st == st && is_driver_variant(prog, v))
+            screen->get_shader_binary(screen, v->driver_shader,
+                                      prog->info.stage, &blob);
+      }
+   }
+   blob_overwrite_uint32(&blob, size_offset,
+                         blob.size - size_offset - sizeof(uint32_t));
+
+   blob_write_bytes(&blob, prog->driver_cache_blob,
+                    prog->driver_cache_blob_size);
+
+   ralloc_free(prog->driver_cache_blob);
+   copy_blob_to_driver_cache_blob(&blob, prog);
+   blob_finish(&blob);
+}
+
+void
+st_deserialise_nir_program_binary(struct gl_context *ctx,
+                                  struct gl_shader_program *shProg,
+                                  struct gl_program *prog)
+{
+   struct pipe_screen *screen = st_context(ctx)->screen;
+   struct blob_reader blob_reader;
+
+   MESA_TRACE_FUNC();
+
+   blob_reader_init(&blob_reader, prog->driver_cache_blob,
+                    prog->driver_cache_blob_size);
+
+   uint32_t driver_size = blob_read_uint32(&blob_reader);
+   const void *driver_data = blob_read_bytes(&blob_reader, driver_size);
+   if (blob_reader.overrun) {
+      assert(!"Invalid program binary!");
+      return;
+   }
+
+   /* This has to happen before the default variant is created. */
+   if (driver_size && screen->add_shader_binary)
+      screen->add_shader_binary(screen, driver_data, driver_size);
+
+   deserialise_nir_program(ctx, shProg, prog, blob_reader.current,
+                           blob_reader.end - blob_reader.current);
+
+   /* Drop the blob, so that st_serialise_nir_program starts over if the
+    * binary of this program is queried again.
+    */
+   ralloc_free(prog->driver_cache_blob);
+   prog->driver_cache_blob = NULL;
+   prog->driver_cache_blob_size = 0;
 }
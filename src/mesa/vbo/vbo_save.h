@@ -146,6 +146,13 @@ void _vbo_loopback_vertex_list(struct gl_context *ctx,
 void
 vbo_save_playback_vertex_list(struct gl_context *ctx, void *data, bool copy_to_current);
 
+bool
+vbo_save_vertex_lists_mergeable(const void *prev, const void *next);
+
+void
+vbo_save_playback_vertex_lists(struct gl_context *ctx, void *const *data,
+                               unsigned count, bool copy_to_current);
+
 void
 vbo_save_playback_vertex_list_loopback(struct gl_context *ctx, void *data);
 
@@ -192,49 +192,13 @@ enum vbo_save_status {
    USE_SLOW_PATH,
 };
 
-static enum vbo_save_status
-vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
-                                      const struct vbo_save_vertex_list *node,
-                                      bool copy_to_current)
+static void
+draw_vertex_list_gallium(struct gl_context *ctx,
+                         const struct vbo_save_vertex_list *node,
+                         gl_vertex_processing_mode vp_mode,
+                         uint32_t velem_mask)
 {
-   /* Don't use this if selection or feedback mode is enabled. st/mesa can't
-    * handle it.
-    */
-   if (!ctx->Const.HasDrawVertexState || ctx->RenderMode != GL_RENDER)
-      return USE_SLOW_PATH;
-
-   const gl_vertex_processing_mode mode = ctx->VertexProgram._VPMode;
-
-   /* This sets which vertex arrays are enabled, which determines
-    * which attribs have stride = 0 and whether edge flags are enabled.
-    */
-   const GLbitfield enabled = node->enabled_attribs[mode];
-   _mesa_set_varying_vp_inputs(ctx, enabled);
-
-   if (ctx->NewState)
-      _mesa_update_state(ctx);
-
-   /* Return precomputed GL errors such as invalid shaders. */
-   if (!ctx->ValidPrimMask) {
-      _mesa_error(ctx, ctx->DrawGLError, "glCallList");
-      return DONE;
-   }
-
-   /* Use the slow path when there are vertex inputs without vertex
-    * elements. This happens with zero-stride attribs and non-fixed-func
-    * shaders.
-    *
-    * Dual-slot inputs are also unsupported because the higher slot is
-    * always missing in vertex elements.
-    *
-    * TODO: Add support for zero-stride attribs.
-    */
-   struct gl_program *vp = ctx->VertexProgram._Current;
-
-   if ((vp->info.inputs_read & ~(uint64_t)enabled) || vp->DualSlotInputs)
-      return USE_SLOW_PATH;
-
-   struct pipe_vertex_state *state = node->state[mode];
+   struct pipe_vertex_state *state = node->state[vp_mode];
    struct pipe_draw_vertex_state_info info;
 
    info.mode = node->mode;
@@ -257,7 +221,7 @@ vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
        * possibly turn a million atomic increments into 1 add and 1 subtract
        * atomic op over the whole lifetime of an app.
        */
-      int16_t * const private_refcount = (int16_t*)&node->private_refcount[mode];
+      int16_t * const private_refcount = (int16_t*)&node->private_refcount[vp_mode];
       assert(*private_refcount >= 0);
 
       if (unlikely(*private_refcount == 0)) {
@@ -278,14 +242,7 @@ vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
       info.take_vertex_state_ownership = true;
    }
 
-   /* Set edge flags. */
-   _mesa_update_edgeflag_state_explicit(ctx, enabled & VERT_BIT_EDGEFLAG);
-
-   ST_PIPELINE_RENDER_STATE_MASK_NO_VARRAYS(mask);
-   st_prepare_draw(ctx, mask);
-
    struct pipe_context *pipe = ctx->pipe;
-   uint32_t velem_mask = ctx->VertexProgram._Current->info.inputs_read;
 
    /* Fast path using a pre-built gallium vertex buffer state. */
    if (node->modes || node->num_draws > 1) {
@@ -318,12 +275,71 @@ vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
       pipe->draw_vertex_state(pipe, state, velem_mask, info,
                               &node->start_count, 1);
    }
+}
+
+/* Draw a run of vertex lists sharing the same vertex state (see
+ * vbo_save_vertex_lists_mergeable) with a single state validation.
+ */
+static enum vbo_save_status
+vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
+                                      const struct vbo_save_vertex_list *const *nodes,
+                                      unsigned count, bool copy_to_current)
+{
+   const struct vbo_save_vertex_list *node = nodes[0];
+
+   /* Don't use this if selection or feedback mode is enabled. st/mesa can't
+    * handle it.
+    */
+   if (!ctx->Const.HasDrawVertexState || ctx->RenderMode != GL_RENDER)
+      return USE_SLOW_PATH;
+
+   const gl_vertex_processing_mode mode = ctx->VertexProgram._VPMode;
+
+   /* This sets which vertex arrays are enabled, which determines
+    * which attribs have stride = 0 and whether edge flags are enabled.
+    */
+   const GLbitfield enabled = node->enabled_attribs[mode];
+   _mesa_set_varying_vp_inputs(ctx, enabled);
+
+   if (ctx->NewState)
+      _mesa_update_state(ctx);
+
+   /* Return precomputed GL errors such as invalid shaders. */
+   if (!ctx->ValidPrimMask) {
+      _mesa_error(ctx, ctx->DrawGLError, "glCallList");
+      return DONE;
+   }
+
+   /* Use the slow path when there are vertex inputs without vertex
+    * elements. This happens with zero-stride attribs and non-fixed-func
+    * shaders.
+    *
+    * Dual-slot inputs are also unsupported because the higher slot is
+    * always missing in vertex elements.
+    *
+    * TODO: Add support for zero-stride attribs.
+    */
+   struct gl_program *vp = ctx->VertexProgram._Current;
+
+   if ((vp->info.inputs_read & ~(uint64_t)enabled) || vp->DualSlotInputs)
+      return USE_SLOW_PATH;
+
+   /* Set edge flags. */
+   _mesa_update_edgeflag_state_explicit(ctx, enabled & VERT_BIT_EDGEFLAG);
+
+   ST_PIPELINE_RENDER_STATE_MASK_NO_VARRAYS(mask);
+   st_prepare_draw(ctx, mask);
+
+   uint32_t velem_mask = ctx->VertexProgram._Current->info.inputs_read;
+
+   for (unsigned i = 0; i < count; i++)
+      draw_vertex_list_gallium(ctx, nodes[i], mode, velem_mask);
 
    /* Restore edge flag state and ctx->VertexProgram._VaryingInputs. */
    _mesa_update_edgeflag_state_vao(ctx);
 
    if (copy_to_current)
-      playback_copy_to_current(ctx, node);
+      playback_copy_to_current(ctx, nodes[count - 1]);
    return DONE;
 }
 
@@ -349,7 +365,8 @@ vbo_save_playback_vertex_list(struct gl_context *ctx, void *data, bool copy_to_c
       return;
    }
 
-   if (vbo_save_playback_vertex_list_gallium(ctx, node, copy_to_current) == DONE)
+   if (vbo_save_playback_vertex_list_gallium(ctx, &node, 1,
+                                             copy_to_current) == DONE)
       return;
 
    /* Save the Draw VAO before we override it. */
@@ -398,3 +415,59 @@ vbo_save_playback_vertex_list(struct gl_context *ctx, void *data, bool copy_to_c
    if (copy_to_current)
       playback_copy_to_current(ctx, node);
 }
+
+
+/**
+ * Whether vertex list "next" can be drawn right after "prev" without
+ * validating the state again. This is true when both use the same gallium
+ * vertex state, which is common because consecutive vertex lists share the
+ * same buffer and drivers dedup vertex states with util_vertex_state_cache.
+ */
+bool
+vbo_save_vertex_lists_mergeable(const void *prev, const void *next)
+{
+   const struct vbo_save_vertex_list *a =
+      (const struct vbo_save_vertex_list *) prev;
+   const struct vbo_save_vertex_list *b =
+      (const struct vbo_save_vertex_list *) next;
+
+   for (unsigned i = 0; i < VP_MODE_MAX; i++) {
+      if (!a->state[i] || a->state[i] != b->state[i] ||
+          a->enabled_attribs[i] != b->enabled_attribs[i])
+         return false;
+   }
+   return true;
+}
+
+
+/**
+ * Execute consecutive vertex lists that vbo_save_vertex_lists_mergeable
+ * accepted. Only the last one may update the current attribs because
+ * that would invalidate the state for the following ones.
+ */
+void
+vbo_save_playback_vertex_lists(struct gl_context *ctx, void *const *data,
+                               unsigned count, bool copy_to_current)
+{
+   const struct vbo_save_vertex_list *const *nodes =
+      (const struct vbo_save_vertex_list *const *) data;
+
+   if (count == 1 || _mesa_inside_begin_end(ctx)) {
+      for (unsigned i = 0; i < count; i++) {
+         vbo_save_playback_vertex_list(ctx, data[i],
+                                       copy_to_current && i == count - 1);
+      }
+      return;
+   }
+
+   FLUSH_FOR_DRAW(ctx);
+
+   if (vbo_save_playback_vertex_list_gallium(ctx, nodes, count,
+                                             copy_to_current) == DONE)
+      return;
+
+   for (unsigned i = 0; i < count; i++) {
+      vbo_save_playback_vertex_list(ctx, data[i],
+                                    copy_to_current && i == count - 1);
+   }
+}
@@ -207,11 +207,12 @@ eval_inst(struct mme_fermi_sim *sim, const struct mme_fermi_inst *inst)
    }
 }
 
-void
+uint32_t
 mme_fermi_sim_core(uint32_t inst_count, const struct mme_fermi_inst *insts,
                    const struct mme_sim_state_ops *state_ops,
                    void *state_handler)
 {
+   uint32_t cycles = 0;
    struct mme_fermi_sim sim = {
       .state_ops = state_ops,
       .state_handler = state_handler,
@@ -234,6 +235,7 @@ mme_fermi_sim_core(uint32_t inst_count, const struct mme_fermi_inst *insts,
       }
 
       eval_inst(&sim, inst);
+      cycles++;
 
       should_delay_branch = inst->op == MME_FERMI_OP_BRANCH && !inst->branch.no_delay;
 
@@ -255,6 +257,9 @@ mme_fermi_sim_core(uint32_t inst_count, const struct mme_fermi_inst *insts,
    // Handle delay slot at exit
    assert(sim.ip < inst_count);
    eval_inst(&sim, &insts[sim.ip]);
+   cycles++;
+
+   return cycles;
 }
 
 struct mme_fermi_state_sim {
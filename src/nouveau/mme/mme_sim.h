@@ -19,10 +19,14 @@ struct mme_sim_state_ops {
    uint32_t *(*map_dram)(void *handler, uint32_t idx);
 };
 
-void mme_sim_core(const struct nv_device_info *devinfo,
-                  size_t macro_size, const void *macro,
-                  const struct mme_sim_state_ops *state_ops,
-                  void *state_handler);
+/* Returns the number of instructions issued while running the macro.  The
+ * MME issues one instruction per cycle, so this is an estimate of the cycle
+ * count that ignores stalls on the data FIFO and the method FIFO.
+ */
+uint32_t mme_sim_core(const struct nv_device_info *devinfo,
+                      size_t macro_size, const void *macro,
+                      const struct mme_sim_state_ops *state_ops,
+                      void *state_handler);
 
 #ifdef __cplusplus
 }
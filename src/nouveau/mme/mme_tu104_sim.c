@@ -393,11 +393,12 @@ eval_out(struct mme_tu104_sim *sim,
    }
 }
 
-void
+uint32_t
 mme_tu104_sim_core(uint32_t inst_count, const struct mme_tu104_inst *insts,
                    const struct mme_sim_state_ops *state_ops,
                    void *state_handler)
 {
+   uint32_t cycles = 0;
    struct mme_tu104_sim sim = {
       .state_ops = state_ops,
       .state_handler = state_handler,
@@ -408,6 +409,7 @@ mme_tu104_sim_core(uint32_t inst_count, const struct mme_tu104_inst *insts,
       assert(sim.ip < inst_count);
       const struct mme_tu104_inst *inst = &insts[sim.ip];
       sim.next_ip = sim.ip + 1;
+      cycles++;
 
       load_params(&sim, inst);
 
@@ -438,6 +440,8 @@ mme_tu104_sim_core(uint32_t inst_count, const struct mme_tu104_inst *insts,
 
       sim.ip = sim.next_ip;
    }
+
+   return cycles;
 }
 
 struct mme_tu104_state_sim {
@@ -22,9 +22,10 @@ struct mme_tu104_sim_mem {
    size_t size;
 };
 
-void mme_tu104_sim_core(uint32_t inst_count, const struct mme_tu104_inst *insts,
-                        const struct mme_sim_state_ops *state_ops,
-                        void *state_handler);
+uint32_t mme_tu104_sim_core(uint32_t inst_count,
+                            const struct mme_tu104_inst *insts,
+                            const struct mme_sim_state_ops *state_ops,
+                            void *state_handler);
 
 void mme_tu104_sim(uint32_t inst_count, const struct mme_tu104_inst *insts,
                    uint32_t param_count, const uint32_t *params,
@@ -148,14 +148,9 @@ nvk_push_draw_state_init(struct nvk_queue *queue, struct nv_push *p)
       .engine_id = 0,
    });
 
-   for (uint32_t mme = 0, mme_pos = 0; mme < NVK_MME_COUNT; mme++) {
-      size_t size;
-      uint32_t *dw = nvk_build_mme(&pdev->info, mme, &size);
-      if (dw == NULL)
-         return vk_error(dev, VK_ERROR_OUT_OF_HOST_MEMORY);
-
-      assert(size % sizeof(uint32_t) == 0);
-      const uint32_t num_dw = size / sizeof(uint32_t);
+   const struct nvk_mme_program *mme_prog = pdev->mme;
+   for (uint32_t mme = 0; mme < NVK_MME_COUNT; mme++) {
+      const uint32_t mme_pos = mme_prog->start_dw[mme];
 
       P_MTHD(p, NV9097, LOAD_MME_START_ADDRESS_RAM_POINTER);
       P_NV9097_LOAD_MME_START_ADDRESS_RAM_POINTER(p, mme);
@@ -163,11 +158,7 @@ nvk_push_draw_state_init(struct nvk_queue *queue, struct nv_push *p)
 
       P_1INC(p, NV9097, LOAD_MME_INSTRUCTION_RAM_POINTER);
       P_NV9097_LOAD_MME_INSTRUCTION_RAM_POINTER(p, mme_pos);
-      P_INLINE_ARRAY(p, dw, num_dw);
-
-      mme_pos += num_dw;
-
-      free(dw);
+      P_INLINE_ARRAY(p, &mme_prog->dw[mme_pos], mme_prog->num_dw[mme]);
    }
 
    if (pdev->info.cls_eng3d >= TURING_A && pdev->info.cls_eng3d < BLACKWELL_A)
@@ -4123,7 +4114,8 @@ nvk_mme_build_draw_loop(struct mme_builder *b,
 
 static void
 nvk_mme_build_draw(struct mme_builder *b,
-                   struct mme_value draw_index)
+                   struct mme_value draw_index,
+                   bool check_view_mask)
 {
    /* These are in VkDrawIndirectCommand order */
    struct mme_value vertex_count = mme_load(b);
@@ -4143,33 +4135,39 @@ nvk_mme_build_draw(struct mme_builder *b,
    if (b->devinfo->cls_eng3d < TURING_A)
       nvk_mme_spill(b, DRAW_IDX, draw_index);
 
-   struct mme_value view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
-   mme_if(b, ieq, view_mask, mme_zero()) {
-      mme_free_reg(b, view_mask);
-
+   if (!check_view_mask) {
+      /* The caller already checked that multiview is disabled */
       nvk_mme_build_draw_loop(b, instance_count,
                               first_vertex, vertex_count);
-   }
+   } else {
+      struct mme_value view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+      mme_if(b, ieq, view_mask, mme_zero()) {
+         mme_free_reg(b, view_mask);
 
-   view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
-   mme_if(b, ine, view_mask, mme_zero()) {
-      mme_free_reg(b, view_mask);
+         nvk_mme_build_draw_loop(b, instance_count,
+                                 first_vertex, vertex_count);
+      }
 
-      struct mme_value view = mme_mov(b, mme_zero());
-      mme_while(b, ine, view, mme_imm(32)) {
-         view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
-         struct mme_value has_view = mme_bfe(b, view_mask, view, 1);
+      view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+      mme_if(b, ine, view_mask, mme_zero()) {
          mme_free_reg(b, view_mask);
-         mme_if(b, ine, has_view, mme_zero()) {
-            mme_free_reg(b, has_view);
-            nvk_mme_emit_view_index(b, view);
-            nvk_mme_build_draw_loop(b, instance_count,
-                                    first_vertex, vertex_count);
-         }
 
-         mme_add_to(b, view, view, mme_imm(1));
+         struct mme_value view = mme_mov(b, mme_zero());
+         mme_while(b, ine, view, mme_imm(32)) {
+            view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+            struct mme_value has_view = mme_bfe(b, view_mask, view, 1);
+            mme_free_reg(b, view_mask);
+            mme_if(b, ine, has_view, mme_zero()) {
+               mme_free_reg(b, has_view);
+               nvk_mme_emit_view_index(b, view);
+               nvk_mme_build_draw_loop(b, instance_count,
+                                       first_vertex, vertex_count);
+            }
+
+            mme_add_to(b, view, view, mme_imm(1));
+         }
+         mme_free_reg(b, view);
       }
-      mme_free_reg(b, view);
    }
 
    mme_free_reg(b, instance_count);
@@ -4184,7 +4182,7 @@ void
 nvk_mme_draw(struct mme_builder *b)
 {
    struct mme_value draw_index = mme_load(b);
-   nvk_mme_build_draw(b, draw_index);
+   nvk_mme_build_draw(b, draw_index, true);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -4268,7 +4266,8 @@ nvk_mme_build_draw_indexed_loop(struct mme_builder *b,
 
 static void
 nvk_mme_build_draw_indexed(struct mme_builder *b,
-                           struct mme_value draw_index)
+                           struct mme_value draw_index,
+                           bool check_view_mask)
 {
    /* These are in VkDrawIndexedIndirectCommand order */
    struct mme_value index_count = mme_load(b);
@@ -4291,33 +4290,39 @@ nvk_mme_build_draw_indexed(struct mme_builder *b,
    if (b->devinfo->cls_eng3d < TURING_A)
       nvk_mme_spill(b, DRAW_IDX, draw_index);
 
-   struct mme_value view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
-   mme_if(b, ieq, view_mask, mme_zero()) {
-      mme_free_reg(b, view_mask);
-
+   if (!check_view_mask) {
+      /* The caller already checked that multiview is disabled */
       nvk_mme_build_draw_indexed_loop(b, instance_count,
                                       first_index, index_count);
-   }
+   } else {
+      struct mme_value view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+      mme_if(b, ieq, view_mask, mme_zero()) {
+         mme_free_reg(b, view_mask);
 
-   view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
-   mme_if(b, ine, view_mask, mme_zero()) {
-      mme_free_reg(b, view_mask);
+         nvk_mme_build_draw_indexed_loop(b, instance_count,
+                                         first_index, index_count);
+      }
 
-      struct mme_value view = mme_mov(b, mme_zero());
-      mme_while(b, ine, view, mme_imm(32)) {
-         view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
-         struct mme_value has_view = mme_bfe(b, view_mask, view, 1);
+      view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+      mme_if(b, ine, view_mask, mme_zero()) {
          mme_free_reg(b, view_mask);
-         mme_if(b, ine, has_view, mme_zero()) {
-            mme_free_reg(b, has_view);
-            nvk_mme_emit_view_index(b, view);
-            nvk_mme_build_draw_indexed_loop(b, instance_count,
-                                            first_index, index_count);
-         }
 
-         mme_add_to(b, view, view, mme_imm(1));
+         struct mme_value view = mme_mov(b, mme_zero());
+         mme_while(b, ine, view, mme_imm(32)) {
+            view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+            struct mme_value has_view = mme_bfe(b, view_mask, view, 1);
+            mme_free_reg(b, view_mask);
+            mme_if(b, ine, has_view, mme_zero()) {
+               mme_free_reg(b, has_view);
+               nvk_mme_emit_view_index(b, view);
+               nvk_mme_build_draw_indexed_loop(b, instance_count,
+                                               first_index, index_count);
+            }
+
+            mme_add_to(b, view, view, mme_imm(1));
+         }
+         mme_free_reg(b, view);
       }
-      mme_free_reg(b, view);
    }
 
    mme_free_reg(b, instance_count);
@@ -4332,7 +4337,7 @@ void
 nvk_mme_draw_indexed(struct mme_builder *b)
 {
    struct mme_value draw_index = mme_load(b);
-   nvk_mme_build_draw_indexed(b, draw_index);
+   nvk_mme_build_draw_indexed(b, draw_index, true);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -4387,6 +4392,55 @@ nvk_CmdDrawMultiIndexedEXT(VkCommandBuffer commandBuffer,
    }
 }
 
+static void
+nvk_mme_build_draw_indirect_loop_tu104(struct mme_builder *b,
+                                       struct mme_value64 draw_addr,
+                                       struct mme_value draw_count,
+                                       struct mme_value stride,
+                                       bool indexed, bool check_view_mask)
+{
+   struct mme_value draw = mme_mov(b, mme_zero());
+   mme_while(b, ult, draw, draw_count) {
+      mme_tu104_read_fifoed(b, draw_addr, mme_imm(indexed ? 5 : 4));
+
+      if (indexed)
+         nvk_mme_build_draw_indexed(b, draw, check_view_mask);
+      else
+         nvk_mme_build_draw(b, draw, check_view_mask);
+
+      mme_add_to(b, draw, draw, mme_imm(1));
+      mme_add64_to(b, draw_addr, draw_addr, mme_value64(stride, mme_zero()));
+   }
+   mme_free_reg(b, draw);
+}
+
+static void
+nvk_mme_build_draw_indirect_tu104(struct mme_builder *b,
+                                  struct mme_value64 draw_addr,
+                                  struct mme_value draw_count,
+                                  struct mme_value stride,
+                                  bool indexed)
+{
+   /* Multiview is rare, so check the view mask once for the whole batch of
+    * draws instead of twice per draw.
+    */
+   struct mme_value view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+   mme_if(b, ieq, view_mask, mme_zero()) {
+      mme_free_reg(b, view_mask);
+
+      nvk_mme_build_draw_indirect_loop_tu104(b, draw_addr, draw_count,
+                                             stride, indexed, false);
+   }
+
+   view_mask = nvk_mme_load_scratch(b, VIEW_MASK);
+   mme_if(b, ine, view_mask, mme_zero()) {
+      mme_free_reg(b, view_mask);
+
+      nvk_mme_build_draw_indirect_loop_tu104(b, draw_addr, draw_count,
+                                             stride, indexed, true);
+   }
+}
+
 void
 nvk_mme_draw_indirect(struct mme_builder *b)
 {
@@ -4395,15 +4449,8 @@ nvk_mme_draw_indirect(struct mme_builder *b)
       struct mme_value draw_count = mme_load(b);
       struct mme_value stride = mme_load(b);
 
-      struct mme_value draw = mme_mov(b, mme_zero());
-      mme_while(b, ult, draw, draw_count) {
-         mme_tu104_read_fifoed(b, draw_addr, mme_imm(4));
-
-         nvk_mme_build_draw(b, draw);
-
-         mme_add_to(b, draw, draw, mme_imm(1));
-         mme_add64_to(b, draw_addr, draw_addr, mme_value64(stride, mme_zero()));
-      }
+      nvk_mme_build_draw_indirect_tu104(b, draw_addr, draw_count, stride,
+                                        false);
    } else {
       struct mme_value draw_count = mme_load(b);
       nvk_mme_load_to_scratch(b, DRAW_PAD_DW);
@@ -4412,7 +4459,7 @@ nvk_mme_draw_indirect(struct mme_builder *b)
       mme_while(b, ine, draw, draw_count) {
          nvk_mme_spill(b, DRAW_COUNT, draw_count);
 
-         nvk_mme_build_draw(b, draw);
+         nvk_mme_build_draw(b, draw, true);
          mme_add_to(b, draw, draw, mme_imm(1));
 
          struct mme_value pad_dw = nvk_mme_load_scratch(b, DRAW_PAD_DW);
@@ -4426,6 +4473,67 @@ nvk_mme_draw_indirect(struct mme_builder *b)
    }
 }
 
+static void
+nvk_mme_draw_indirect_test_check(const struct nv_device_info *devinfo,
+                                 const struct nvk_mme_test_case *test,
+                                 const struct nvk_mme_mthd_data *results)
+{
+   uint32_t view_mask = 0;
+   for (uint32_t i = 0; test->init[i].mthd != 0; i++) {
+      if (test->init[i].mthd == NVK_SET_MME_SCRATCH(VIEW_MASK))
+         view_mask = test->init[i].data;
+   }
+
+   const uint32_t draw_count = test->params[2];
+   const uint32_t expected_begins =
+      draw_count * MAX2(1, util_bitcount(view_mask));
+
+   uint32_t begins = 0, ends = 0;
+   for (uint32_t i = 0; results[i].mthd != 0; i++) {
+      if (results[i].mthd == NV9097_BEGIN)
+         begins++;
+      else if (results[i].mthd == NV9097_END)
+         ends++;
+   }
+   assert(begins == expected_begins);
+   assert(ends == expected_begins);
+}
+
+#define NVK_MME_DRAW_INDIRECT_TEST_INIT(view_mask)                \
+   (struct nvk_mme_mthd_data[]) {                                 \
+      { NVK_SET_MME_SCRATCH(VIEW_MASK), view_mask },              \
+      { NVK_SET_MME_SCRATCH(DRAW_BEGIN), 0x1 },                   \
+      { NVK_SET_MME_SCRATCH(CB0_FIRST_VERTEX), 0 },               \
+      { NVK_SET_MME_SCRATCH(CB0_DRAW_INDEX), 0 },                 \
+      { NVK_SET_MME_SCRATCH(CB0_VIEW_INDEX), 0 },                 \
+      { NV9097_SET_GLOBAL_BASE_INSTANCE_INDEX, 0 },               \
+      { }                                                         \
+   }
+
+const struct nvk_mme_test_case nvk_mme_draw_indirect_tests[] = {{
+   /* Four draws without multiview */
+   .min_cls_eng3d = TURING_A,
+   .init = NVK_MME_DRAW_INDIRECT_TEST_INIT(0),
+   .params = (uint32_t[]) {
+      0xff3, 0xff4ab000, 4, 16,
+      3, 1, 0, 0,
+      6, 1, 3, 0,
+      3, 2, 9, 1,
+      3, 1, 12, 3,
+   },
+   .check = nvk_mme_draw_indirect_test_check,
+}, {
+   /* Two draws with two views */
+   .min_cls_eng3d = TURING_A,
+   .init = NVK_MME_DRAW_INDIRECT_TEST_INIT(0x5),
+   .params = (uint32_t[]) {
+      0xff3, 0xff4ab000, 2, 16,
+      3, 1, 0, 0,
+      6, 1, 3, 0,
+   },
+   .check = nvk_mme_draw_indirect_test_check,
+}, {}};
+
 VKAPI_ATTR void VKAPI_CALL
 nvk_CmdDrawIndirect(VkCommandBuffer commandBuffer,
                     VkBuffer _buffer,
@@ -4495,15 +4603,8 @@ nvk_mme_draw_indexed_indirect(struct mme_builder *b)
       struct mme_value draw_count = mme_load(b);
       struct mme_value stride = mme_load(b);
 
-      struct mme_value draw = mme_mov(b, mme_zero());
-      mme_while(b, ult, draw, draw_count) {
-         mme_tu104_read_fifoed(b, draw_addr, mme_imm(5));
-
-         nvk_mme_build_draw_indexed(b, draw);
-
-         mme_add_to(b, draw, draw, mme_imm(1));
-         mme_add64_to(b, draw_addr, draw_addr, mme_value64(stride, mme_zero()));
-      }
+      nvk_mme_build_draw_indirect_tu104(b, draw_addr, draw_count, stride,
+                                        true);
    } else {
       struct mme_value draw_count = mme_load(b);
       nvk_mme_load_to_scratch(b, DRAW_PAD_DW);
@@ -4512,7 +4613,7 @@ nvk_mme_draw_indexed_indirect(struct mme_builder *b)
       mme_while(b, ine, draw, draw_count) {
          nvk_mme_spill(b, DRAW_COUNT, draw_count);
 
-         nvk_mme_build_draw_indexed(b, draw);
+         nvk_mme_build_draw_indexed(b, draw, true);
          mme_add_to(b, draw, draw, mme_imm(1));
 
          struct mme_value pad_dw = nvk_mme_load_scratch(b, DRAW_PAD_DW);
@@ -4526,6 +4627,30 @@ nvk_mme_draw_indexed_indirect(struct mme_builder *b)
    }
 }
 
+const struct nvk_mme_test_case nvk_mme_draw_indexed_indirect_tests[] = {{
+   /* Four draws without multiview */
+   .min_cls_eng3d = TURING_A,
+   .init = NVK_MME_DRAW_INDIRECT_TEST_INIT(0),
+   .params = (uint32_t[]) {
+      0xff3, 0xff4ab000, 4, 20,
+      3, 1, 0, 0, 0,
+      6, 1, 3, 0, 0,
+      3, 2, 9, 4, 1,
+      3, 1, 12, 4, 3,
+   },
+   .check = nvk_mme_draw_indirect_test_check,
+}, {
+   /* Two draws with two views */
+   .min_cls_eng3d = TURING_A,
+   .init = NVK_MME_DRAW_INDIRECT_TEST_INIT(0x5),
+   .params = (uint32_t[]) {
+      0xff3, 0xff4ab000, 2, 20,
+      3, 1, 0, 0, 0,
+      6, 1, 3, 0, 0,
+   },
+   .check = nvk_mme_draw_indirect_test_check,
+}, {}};
+
 VKAPI_ATTR void VKAPI_CALL
 nvk_CmdDrawIndexedIndirect(VkCommandBuffer commandBuffer,
                            VkBuffer _buffer,
@@ -4607,15 +4732,7 @@ nvk_mme_draw_indirect_count(struct mme_builder *b)
    }
    mme_free_reg(b, draw_count_buf);
 
-   struct mme_value draw = mme_mov(b, mme_zero());
-   mme_while(b, ult, draw, draw_max) {
-      mme_tu104_read_fifoed(b, draw_addr, mme_imm(4));
-
-      nvk_mme_build_draw(b, draw);
-
-      mme_add_to(b, draw, draw, mme_imm(1));
-      mme_add64_to(b, draw_addr, draw_addr, mme_value64(stride, mme_zero()));
-   }
+   nvk_mme_build_draw_indirect_tu104(b, draw_addr, draw_max, stride, false);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -4669,15 +4786,7 @@ nvk_mme_draw_indexed_indirect_count(struct mme_builder *b)
    }
    mme_free_reg(b, draw_count_buf);
 
-   struct mme_value draw = mme_mov(b, mme_zero());
-   mme_while(b, ult, draw, draw_max) {
-      mme_tu104_read_fifoed(b, draw_addr, mme_imm(5));
-
-      nvk_mme_build_draw_indexed(b, draw);
-
-      mme_add_to(b, draw, draw, mme_imm(1));
-      mme_add64_to(b, draw_addr, draw_addr, mme_value64(stride, mme_zero()));
-   }
+   nvk_mme_build_draw_indirect_tu104(b, draw_addr, draw_max, stride, true);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -45,6 +45,12 @@ nvk_device_init_meta(struct nvk_device *dev)
    if (result != VK_SUCCESS)
       return result;
 
+   result = vk_meta_device_init_pipeline_cache(&dev->vk, &dev->meta);
+   if (result != VK_SUCCESS) {
+      vk_meta_device_finish(&dev->vk, &dev->meta);
+      return result;
+   }
+
    dev->meta.use_gs_for_layer = pdev->info.cls_eng3d < MAXWELL_B;
    dev->meta.use_rect_list_pipeline = true;
    dev->meta.cmd_bind_map_buffer = nvk_cmd_bind_map_buffer;
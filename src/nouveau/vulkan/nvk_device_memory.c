@@ -281,8 +281,16 @@ nvk_AllocateMemory(VkDevice device,
          if (result != VK_SUCCESS)
             goto fail_mem;
 
-         /* Since we don't know when the memory will be freed, sync now */
-         result = nvk_upload_queue_sync(dev, &dev->upload);
+         /* Queue submits wait on the upload queue, so the fill only has to
+          * be done before the memory is freed.  Exported memory may be used
+          * outside of our queues, though, so sync now in that case.
+          */
+         if (not_shared) {
+            result = nvk_upload_queue_flush(dev, &dev->upload,
+                                            &mem->upload_time_point);
+         } else {
+            result = nvk_upload_queue_sync(dev, &dev->upload);
+         }
          if (result != VK_SUCCESS)
             goto fail_mem;
       }
@@ -331,6 +339,9 @@ nvk_FreeMemory(VkDevice device,
    struct nvk_memory_heap *heap = &pdev->mem_heaps[type->heapIndex];
    p_atomic_add(&heap->used, -((int64_t)mem->mem->size_B));
 
+   /* Don't let the initial fill land in memory that may get reused */
+   nvk_upload_queue_wait(dev, &dev->upload, mem->upload_time_point);
+
    nvkmd_mem_unref(mem->mem);
 
    vk_device_memory_destroy(&dev->vk, pAllocator, &mem->vk);
@@ -20,6 +20,9 @@ struct nvk_device_memory {
    struct nvk_image *dedicated_image;
 
    struct nvkmd_mem *mem;
+
+   /* Upload queue time point of the initial fill, if any */
+   uint64_t upload_time_point;
 };
 
 VK_DEFINE_NONDISP_HANDLE_CASTS(nvk_device_memory, vk.base, VkDeviceMemory,
@@ -8,6 +8,8 @@
 
 #include "mme_sim.h"
 
+#include <stdio.h>
+
 static const nvk_mme_builder_func mme_builders[NVK_MME_COUNT] = {
    [NVK_MME_SELECT_CB0]                    = nvk_mme_select_cb0,
    [NVK_MME_BIND_CBUF_DESC]                = nvk_mme_bind_cbuf_desc,
@@ -44,6 +46,8 @@ static const struct nvk_mme_test_case *mme_tests[NVK_MME_COUNT] = {
    [NVK_MME_SET_TESS_PARAMS]               = nvk_mme_set_tess_params_tests,
    [NVK_MME_SET_SHADING_RATE_CONTROL]      = nvk_mme_set_shading_rate_control_tests,
    [NVK_MME_SET_ANTI_ALIAS]                = nvk_mme_set_anti_alias_tests,
+   [NVK_MME_DRAW_INDIRECT]                 = nvk_mme_draw_indirect_tests,
+   [NVK_MME_DRAW_INDEXED_INDIRECT]         = nvk_mme_draw_indexed_indirect_tests,
 };
 
 uint32_t *
@@ -58,9 +62,53 @@ nvk_build_mme(const struct nv_device_info *devinfo,
    return mme_builder_finish(&b, size_out);
 }
 
+struct nvk_mme_program *
+nvk_mme_program_create(const struct nv_device_info *devinfo)
+{
+   struct nvk_mme_program *prog = NULL;
+   uint32_t *mme_dw[NVK_MME_COUNT] = { NULL, };
+   uint32_t mme_num_dw[NVK_MME_COUNT];
+   uint32_t num_dw = 0;
+
+   for (uint32_t mme = 0; mme < NVK_MME_COUNT; mme++) {
+      size_t size;
+      mme_dw[mme] = nvk_build_mme(devinfo, mme, &size);
+      if (mme_dw[mme] == NULL)
+         goto out;
+
+      assert(size % sizeof(uint32_t) == 0);
+      mme_num_dw[mme] = size / sizeof(uint32_t);
+      num_dw += mme_num_dw[mme];
+   }
+
+   prog = malloc(sizeof(*prog) + num_dw * sizeof(uint32_t));
+   if (prog == NULL)
+      goto out;
+
+   for (uint32_t mme = 0, mme_pos = 0; mme < NVK_MME_COUNT; mme++) {
+      prog->start_dw[mme] = mme_pos;
+      prog->num_dw[mme] = mme_num_dw[mme];
+      memcpy(&prog->dw[mme_pos], mme_dw[mme],
+             mme_num_dw[mme] * sizeof(uint32_t));
+      mme_pos += mme_num_dw[mme];
+   }
+
+out:
+   for (uint32_t mme = 0; mme < NVK_MME_COUNT; mme++)
+      free(mme_dw[mme]);
+
+   return prog;
+}
+
+void
+nvk_mme_program_destroy(struct nvk_mme_program *prog)
+{
+   free(prog);
+}
+
 struct nvk_mme_test_state {
    const struct nvk_mme_test_case *test;
-   struct nvk_mme_mthd_data results[32];
+   struct nvk_mme_mthd_data results[256];
    uint32_t pi, ei;
 };
 
@@ -76,12 +124,13 @@ nvk_mme_test_state_state(void *_ts, uint16_t addr)
 {
    struct nvk_mme_test_state *ts = _ts;
 
-   /* First, look backwards through the expected data that we've already
-    * written.  This ensures that mthd() impacts state().
+   /* First, look backwards through the data that we've already written.
+    * This ensures that mthd() impacts state().  When the test has expected
+    * data, it matches the results up to this point.
     */
    for (int32_t i = ts->ei - 1; i >= 0; i--) {
-      if (ts->test->expected[i].mthd == addr)
-         return ts->test->expected[i].data;
+      if (ts->results[i].mthd == addr)
+         return ts->results[i].data;
    }
 
    /* Now look at init.  We assume the init data is unique */
@@ -122,7 +171,7 @@ const struct mme_sim_state_ops nvk_mme_test_state_ops = {
 };
 
 void
-nvk_test_all_mmes(const struct nv_device_info *devinfo)
+nvk_test_all_mmes(const struct nv_device_info *devinfo, bool print_cycles)
 {
    for (uint32_t mme = 0; mme < NVK_MME_COUNT; mme++) {
       size_t size;
@@ -134,10 +183,19 @@ nvk_test_all_mmes(const struct nv_device_info *devinfo)
             if (mme_tests[mme][i].params == NULL)
                break;
 
+            if (devinfo->cls_eng3d < mme_tests[mme][i].min_cls_eng3d)
+               continue;
+
             struct nvk_mme_test_state ts = {
                .test = &mme_tests[mme][i],
             };
-            mme_sim_core(devinfo, size, dw, &nvk_mme_test_state_ops, &ts);
+            uint32_t cycles = mme_sim_core(devinfo, size, dw,
+                                           &nvk_mme_test_state_ops, &ts);
+            if (print_cycles) {
+               printf("3D class 0x%04x, MME %u, test %u: %zu B, "
+                      "%u cycles, %u methods\n", devinfo->cls_eng3d,
+                      mme, i, size, cycles, ts.ei);
+            }
             if (ts.test->expected != NULL)
                assert(ts.test->expected[ts.ei].mthd == 0);
             if (ts.test->check != NULL)
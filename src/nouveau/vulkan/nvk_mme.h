@@ -219,6 +219,20 @@ typedef void (*nvk_mme_builder_func)(struct mme_builder *b);
 uint32_t *nvk_build_mme(const struct nv_device_info *devinfo,
                         enum nvk_mme mme, size_t *size_out);
 
+/* All of the MMEs for a given 3D class, built once per physical device and
+ * uploaded by every queue that uses the 3D engine.
+ */
+struct nvk_mme_program {
+   uint32_t start_dw[NVK_MME_COUNT];
+   uint32_t num_dw[NVK_MME_COUNT];
+   uint32_t dw[];
+};
+
+struct nvk_mme_program *
+nvk_mme_program_create(const struct nv_device_info *devinfo);
+
+void nvk_mme_program_destroy(struct nvk_mme_program *prog);
+
 void nvk_mme_select_cb0(struct mme_builder *b);
 void nvk_mme_bind_cbuf_desc(struct mme_builder *b);
 void nvk_mme_clear(struct mme_builder *b);
@@ -261,6 +275,8 @@ struct nvk_mme_mthd_data {
 #define NVK_MME_MTHD_DATA_END ((struct nvk_mme_mthd_data) { 0, 0 })
 
 struct nvk_mme_test_case {
+   /* If non-zero, the test is skipped on older 3D classes */
+   uint16_t min_cls_eng3d;
    const struct nvk_mme_mthd_data *init;
    const uint32_t *params;
    const struct nvk_mme_mthd_data *expected;
@@ -274,7 +290,10 @@ extern const struct nvk_mme_test_case nvk_mme_bind_vb_tests[];
 extern const struct nvk_mme_test_case nvk_mme_set_tess_params_tests[];
 extern const struct nvk_mme_test_case nvk_mme_set_shading_rate_control_tests[];
 extern const struct nvk_mme_test_case nvk_mme_set_anti_alias_tests[];
+extern const struct nvk_mme_test_case nvk_mme_draw_indirect_tests[];
+extern const struct nvk_mme_test_case nvk_mme_draw_indexed_indirect_tests[];
 
-void nvk_test_all_mmes(const struct nv_device_info *devinfo);
+void nvk_test_all_mmes(const struct nv_device_info *devinfo,
+                       bool print_cycles);
 
 #endif /* NVK_MME_H */
@@ -12,6 +12,7 @@
 #include "nvk_image.h"
 #include "nvk_image_view.h"
 #include "nvk_instance.h"
+#include "nvk_mme.h"
 #include "nvk_sampler.h"
 #include "nvk_shader.h"
 #include "nvk_wsi.h"
@@ -1485,6 +1486,12 @@ nvk_create_drm_physical_device(struct vk_instance *_instance,
       goto fail_init;
    }
 
+   pdev->mme = nvk_mme_program_create(&pdev->info);
+   if (pdev->mme == NULL) {
+      result = vk_error(instance, VK_ERROR_OUT_OF_HOST_MEMORY);
+      goto fail_nak;
+   }
+
    nvk_physical_device_init_pipeline_cache(pdev);
 
    uint64_t sysmem_size_B = nvk_get_sysmem_heap_size();
@@ -1604,6 +1611,8 @@ nvk_create_drm_physical_device(struct vk_instance *_instance,
 
 fail_disk_cache:
    nvk_physical_device_free_disk_cache(pdev);
+   nvk_mme_program_destroy(pdev->mme);
+fail_nak:
    nak_compiler_destroy(pdev->nak);
 fail_init:
    vk_physical_device_finish(&pdev->vk);
@@ -1624,6 +1633,7 @@ nvk_physical_device_destroy(struct vk_physical_device *vk_pdev)
    nvk_finish_wsi(pdev);
 #endif
    nvk_physical_device_free_disk_cache(pdev);
+   nvk_mme_program_destroy(pdev->mme);
    nak_compiler_destroy(pdev->nak);
    nvkmd_pdev_destroy(pdev->nvkmd);
    vk_physical_device_finish(&pdev->vk);
@@ -19,6 +19,7 @@
 
 struct nak_compiler;
 struct nvk_instance;
+struct nvk_mme_program;
 struct nvk_physical_device;
 struct nvkmd_pdev;
 
@@ -43,6 +44,7 @@ struct nvk_physical_device {
    struct nvkmd_pdev *nvkmd;
 
    struct nak_compiler *nak;
+   struct nvk_mme_program *mme;
    struct wsi_device wsi_device;
 
    uint8_t device_uuid[VK_UUID_SIZE];
@@ -80,6 +80,7 @@ nvk_upload_queue_flush_locked(struct nvk_device *dev,
 
    nv_push_init(&queue->push, queue->push_data, ARRAY_SIZE(queue->push_data),
                 nvk_queue_subchannels_from_engines(NVKMD_ENGINE_COPY));
+   memset(&queue->last_copy, 0, sizeof(queue->last_copy));
 
    if (time_point_out != NULL)
       *time_point_out = queue->last_time_point;
@@ -131,6 +132,18 @@ nvk_upload_queue_sync(struct nvk_device *dev,
    return result;
 }
 
+VkResult
+nvk_upload_queue_wait(struct nvk_device *dev,
+                      struct nvk_upload_queue *queue,
+                      uint64_t time_point)
+{
+   if (time_point == 0)
+      return VK_SUCCESS;
+
+   return vk_sync_wait(&dev->vk, queue->stream.sync, time_point,
+                       VK_SYNC_WAIT_COMPLETE, UINT64_MAX);
+}
+
 static VkResult
 nvk_upload_queue_upload_locked(struct nvk_device *dev,
                                struct nvk_upload_queue *queue,
@@ -164,6 +177,29 @@ nvk_upload_queue_upload_locked(struct nvk_device *dev,
 
       assert(data_size <= (1 << 17));
 
+      /* Shader uploads to a heap are often back-to-back, both in the
+       * staging stream and in the heap, so they can share a single copy.
+       */
+      if (queue->last_copy.push_end == p->end &&
+          queue->last_copy.src_end == data_addr &&
+          queue->last_copy.dst_end == dst_addr &&
+          queue->last_copy.size_B + data_size <= (1 << 17)) {
+         queue->last_copy.size_B += data_size;
+         queue->last_copy.src_end += data_size;
+         queue->last_copy.dst_end += data_size;
+
+         /* PITCH_IN, PITCH_OUT and LINE_LENGTH_IN */
+         for (unsigned i = 0; i < 3; i++)
+            queue->last_copy.pitch_dw[i] = queue->last_copy.size_B;
+
+         dst_addr += data_size;
+         src += data_size;
+         size -= data_size;
+         continue;
+      }
+
+      uint32_t *copy_start = p->end;
+
       P_MTHD(p, NV90B5, OFFSET_IN_UPPER);
       P_NV90B5_OFFSET_IN_UPPER(p, data_addr >> 32);
       P_NV90B5_OFFSET_IN_LOWER(p, data_addr & 0xffffffff);
@@ -182,6 +218,15 @@ nvk_upload_queue_upload_locked(struct nvk_device *dev,
          .dst_memory_layout = DST_MEMORY_LAYOUT_PITCH,
       });
 
+      /* The method header is followed by OFFSET_IN_UPPER through
+       * LINE_COUNT, making PITCH_IN the fifth data dword.
+       */
+      queue->last_copy.push_end = p->end;
+      queue->last_copy.pitch_dw = copy_start + 5;
+      queue->last_copy.src_end = data_addr + data_size;
+      queue->last_copy.dst_end = dst_addr + data_size;
+      queue->last_copy.size_B = data_size;
+
       dst_addr += data_size;
       src += data_size;
       size -= data_size;
@@ -22,6 +22,18 @@ struct nvk_upload_queue {
 
    uint32_t push_data[4096];
    struct nv_push push;
+
+   /* The last copy in push, as long as nothing has been pushed after it.
+    * Uploads that continue it in both the staging stream and the
+    * destination are merged into it instead of launching another copy.
+    */
+   struct {
+      uint32_t *push_end;
+      uint32_t *pitch_dw;
+      uint64_t src_end;
+      uint64_t dst_end;
+      uint32_t size_B;
+   } last_copy;
 };
 
 VkResult nvk_upload_queue_init(struct nvk_device *dev,
@@ -37,6 +49,10 @@ VkResult nvk_upload_queue_flush(struct nvk_device *dev,
 VkResult nvk_upload_queue_sync(struct nvk_device *dev,
                                struct nvk_upload_queue *queue);
 
+VkResult nvk_upload_queue_wait(struct nvk_device *dev,
+                               struct nvk_upload_queue *queue,
+                               uint64_t time_point);
+
 VkResult nvk_upload_queue_upload(struct nvk_device *dev,
                                  struct nvk_upload_queue *queue,
                                  uint64_t dst_addr,
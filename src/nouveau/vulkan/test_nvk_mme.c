@@ -11,8 +11,15 @@
 #include "nv_push_clc597.h"
 #include "nv_push_clc5c0.h"
 
+#include <string.h>
+
 int main(int argc, char **argv)
 {
+   /* With --cycles, print the simulated cycle count of every test case so
+    * that MME changes can be compared without hardware.
+    */
+   const bool print_cycles = argc > 1 && !strcmp(argv[1], "--cycles");
+
 //   static const struct nv_device_info kepler = {
 //      .cls_eng3d = KEPLER_A,
 //      .cls_compute = KEPLER_COMPUTE_A,
@@ -27,8 +34,8 @@ int main(int argc, char **argv)
    };
 
 //   nvk_test_build_all_mmes(&kepler);
-   nvk_test_all_mmes(&volta);
-   nvk_test_all_mmes(&turing);
+   nvk_test_all_mmes(&volta, print_cycles);
+   nvk_test_all_mmes(&turing, print_cycles);
 
    return 0;
 }
@@ -21,17 +21,43 @@
  * SOFTWARE.
  */
 
-/* Bottom-up local scheduler to reduce register pressure */
+/* Bottom-up local scheduler to reduce register pressure.
+ *
+ * On Valhall, the thread count depends on register use: shaders using at most
+ * 32 registers run at full occupancy, others at half. Within that budget,
+ * there is nothing to gain from minimizing pressure further, so we instead
+ * schedule to hide message latency, moving loads and texture fetches away
+ * from their uses. The budget can be tuned with BIFROST_SCHED_REG_BUDGET: 0
+ * always minimizes pressure, 64 trades occupancy for latency hiding.
+ */
 
 #include "util/dag.h"
+#include "util/u_debug.h"
 #include "compiler.h"
 
+/* Registers available at full occupancy, less some slack since our pressure
+ * estimate ignores fragmentation and RA may still need to fall back to the
+ * full register file.
+ */
+#define VA_FULL_OCCUPANCY_BUDGET (32 - 4)
+
+DEBUG_GET_ONCE_NUM_OPTION(sched_reg_budget, "BIFROST_SCHED_REG_BUDGET",
+                          VA_FULL_OCCUPANCY_BUDGET)
+
+/* Rough issue-to-use latency of message instructions, in instructions */
+#define MESSAGE_LATENCY 16
+
 struct sched_ctx {
    /* Dependency graph */
    struct dag *dag;
 
    /* Live set */
    BITSET_WORD *live;
+
+   /* Number of registers we may use while scheduling for latency, or 0 to
+    * only schedule for pressure.
+    */
+   signed budget;
 };
 
 struct sched_node {
@@ -39,8 +65,26 @@ struct sched_node {
 
    /* Instruction this node represents */
    bi_instr *instr;
+
+   /* Longest latency-weighted path from the start of the block to this
+    * instruction.
+    */
+   unsigned depth;
 };
 
+static unsigned
+instr_latency(const bi_instr *I)
+{
+   switch (bi_get_opcode_props(I)->message) {
+   case BIFROST_MESSAGE_NONE:
+   case BIFROST_MESSAGE_STORE:
+   case BIFROST_MESSAGE_BARRIER:
+      return 1;
+   default:
+      return MESSAGE_LATENCY;
+   }
+}
+
 static void
 add_dep(struct sched_node *a, struct sched_node *b)
 {
@@ -168,6 +212,13 @@ create_dag(bi_context *ctx, bi_block *block, void *memctx)
            I->src[0].type == BI_INDEX_REGISTER)) {
          preload = node;
       }
+
+      /* Dependencies always precede the node in the block */
+      util_dynarray_foreach(&node->dag.edges, struct dag_edge, edge) {
+         struct sched_node *dep = (struct sched_node *)edge->child;
+         node->depth =
+            MAX2(node->depth, dep->depth + instr_latency(dep->instr));
+      }
    }
 
    free(last_write);
@@ -216,12 +267,17 @@ calculate_pressure_delta(bi_instr *I, BITSET_WORD *live)
 /*
  * Choose the next instruction, bottom-up. For now we use a simple greedy
  * heuristic: choose the instruction that has the best effect on liveness.
+ *
+ * When scheduling for latency, choose the deepest instruction instead, as
+ * long as the pressure stays within budget. Scheduling deep instructions
+ * last puts the uses of messages as far as possible from the messages.
  */
 static struct sched_node *
-choose_instr(struct sched_ctx *s)
+choose_instr(struct sched_ctx *s, signed pressure)
 {
    int32_t min_delta = INT32_MAX;
    struct sched_node *best = NULL;
+   struct sched_node *deepest = NULL;
 
    list_for_each_entry(struct sched_node, n, &s->dag->heads, dag.link) {
       int32_t delta = calculate_pressure_delta(n->instr, s->live);
@@ -230,17 +286,40 @@ choose_instr(struct sched_ctx *s)
          best = n;
          min_delta = delta;
       }
+
+      if (pressure + delta <= s->budget &&
+          (!deepest || n->depth > deepest->depth))
+         deepest = n;
    }
 
-   return best;
+   return deepest ? deepest : best;
 }
 
-static void
-pressure_schedule_block(bi_context *ctx, bi_block *block, struct sched_ctx *s)
+static unsigned
+live_registers(bi_context *ctx, const BITSET_WORD *live, const uint8_t *widths)
+{
+   unsigned count = 0;
+   int i;
+
+   BITSET_FOREACH_SET(i, live, ctx->ssa_alloc)
+      count += widths[i];
+
+   return count;
+}
+
+static bool
+pressure_schedule_block(bi_context *ctx, bi_block *block, struct sched_ctx *s,
+                        const uint8_t *widths)
 {
-   /* off by a constant, that's ok */
-   signed pressure = 0;
-   signed orig_max_pressure = 0;
+   /* Exact up to vector widths when scheduling for latency, since the budget
+    * is absolute. Otherwise off by a constant, that's ok.
+    */
+   signed live_out = 0;
+   if (s->budget)
+      live_out = live_registers(ctx, block->ssa_live_out, widths);
+
+   signed pressure = live_out;
+   signed orig_max_pressure = live_out;
    unsigned nr_ins = 0;
 
    memcpy(s->live, block->ssa_live_out, BITSET_BYTES(ctx->ssa_alloc));
@@ -254,15 +333,14 @@ pressure_schedule_block(bi_context *ctx, bi_block *block, struct sched_ctx *s)
 
    memcpy(s->live, block->ssa_live_out, BITSET_BYTES(ctx->ssa_alloc));
 
-   /* off by a constant, that's ok */
-   signed max_pressure = 0;
-   pressure = 0;
+   signed max_pressure = live_out;
+   pressure = live_out;
 
    struct sched_node **schedule = calloc(nr_ins, sizeof(struct sched_node *));
    nr_ins = 0;
 
    while (!list_is_empty(&s->dag->heads)) {
-      struct sched_node *node = choose_instr(s);
+      struct sched_node *node = choose_instr(s, pressure);
       pressure += calculate_pressure_delta(node->instr, s->live);
       max_pressure = MAX2(pressure, max_pressure);
       dag_prune_head(s->dag, &node->dag);
@@ -271,10 +349,13 @@ pressure_schedule_block(bi_context *ctx, bi_block *block, struct sched_ctx *s)
       bi_liveness_ins_update_ssa(s->live, node->instr);
    }
 
-   /* Bail if it looks like it's worse */
-   if (max_pressure >= orig_max_pressure) {
+   /* Bail if it looks like it's worse. A latency schedule that fits in the
+    * budget is fine even if it needs more registers than the original.
+    */
+   bool fits = s->budget && max_pressure <= s->budget;
+   if (max_pressure >= orig_max_pressure && !fits) {
       free(schedule);
-      return;
+      return false;
    }
 
    /* Apply the schedule */
@@ -284,6 +365,7 @@ pressure_schedule_block(bi_context *ctx, bi_block *block, struct sched_ctx *s)
    }
 
    free(schedule);
+   return true;
 }
 
 void
@@ -294,11 +376,34 @@ bi_pressure_schedule(bi_context *ctx)
    BITSET_WORD *live =
       ralloc_array(memctx, BITSET_WORD, BITSET_WORDS(ctx->ssa_alloc));
 
+   /* Occupancy only depends on register use on Valhall. Blend shaders are
+    * limited to 16 registers regardless, so keep minimizing pressure there.
+    */
+   signed budget = 0;
+   if (ctx->arch >= 9 && !ctx->inputs->is_blend)
+      budget = CLAMP(debug_get_option_sched_reg_budget(), 0, BI_MAX_REGS);
+
+   uint8_t *widths = NULL;
+   if (budget) {
+      widths = rzalloc_array(memctx, uint8_t, ctx->ssa_alloc);
+
+      bi_foreach_instr_global(ctx, I) {
+         bi_foreach_ssa_dest(I, d)
+            widths[I->dest[d].value] = bi_count_write_registers(I, d);
+      }
+   }
+
    bi_foreach_block(ctx, block) {
       struct sched_ctx sctx = {.dag = create_dag(ctx, block, memctx),
-                               .live = live};
-
-      pressure_schedule_block(ctx, block, &sctx);
+                               .live = live,
+                               .budget = budget};
+
+      /* If the latency schedule doesn't fit, fall back on pressure */
+      if (!pressure_schedule_block(ctx, block, &sctx, widths) && budget) {
+         sctx.dag = create_dag(ctx, block, memctx);
+         sctx.budget = 0;
+         pressure_schedule_block(ctx, block, &sctx, widths);
+      }
    }
 
    ralloc_free(memctx);
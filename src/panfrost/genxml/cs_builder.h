@@ -98,6 +98,17 @@ struct cs_dirty_tracker {
    BITSET_DECLARE(regs, 256);
 };
 
+/**
+ * This is used to skip MOVE instructions writing a value a register is known
+ * to already hold. Values are only recorded and reused outside of blocks, so
+ * we don't need to reason about control flow: any write inside a block just
+ * forgets the destination registers.
+ */
+struct cs_reg_value_tracker {
+   BITSET_DECLARE(known, 256);
+   uint32_t values[256];
+};
+
 enum cs_reg_perm {
    CS_REG_NO_ACCESS = 0,
    CS_REG_RD = BITFIELD_BIT(1),
@@ -133,6 +144,12 @@ struct cs_builder_conf {
 
    /* SB slot used for load/store instructions. */
    uint8_t ls_sb_slot;
+
+   /* Skip moves of immediates registers already hold. Only safe if nothing
+    * but this CS writes the registers, or if the user calls
+    * cs_forget_reg_values() when something else might have.
+    */
+   bool dedup_moves;
 };
 
 /* The CS is formed of one or more CS chunks linked with JUMP instructions.
@@ -218,6 +235,9 @@ struct cs_builder {
 
    struct cs_load_store_tracker root_ls_tracker;
 
+   /* Register values, if cs_builder_conf::dedup_moves is set. */
+   struct cs_reg_value_tracker reg_values;
+
    /* ralloc context used for cs_maybe allocations */
    void *maybe_ctx;
 
@@ -431,6 +451,13 @@ cs_dst_tuple(struct cs_builder *b, struct cs_index dst, ASSERTED unsigned count,
       }
    }
 
+   if (b->conf.dedup_moves) {
+      for (unsigned i = reg; i < reg + count; i++) {
+         if (mask & BITFIELD_BIT(i - reg))
+            BITSET_CLEAR(b->reg_values.known, i);
+      }
+   }
+
    return reg;
 }
 
@@ -903,22 +930,76 @@ cs_instr_is_asynchronous(enum mali_cs_opcode opcode, uint16_t wait_mask)
    } while (0)
 #endif
 
+/* Forget everything we know about register values. Must be called when
+ * registers might have been written behind the builder's back.
+ */
+static inline void
+cs_forget_reg_values(struct cs_builder *b)
+{
+   BITSET_ZERO(b->reg_values.known);
+}
+
+static inline bool
+cs_reg_value_known(struct cs_builder *b, unsigned reg, uint32_t value)
+{
+   return BITSET_TEST(b->reg_values.known, reg) &&
+          b->reg_values.values[reg] == value;
+}
+
+static inline void
+cs_set_reg_value(struct cs_builder *b, unsigned reg, uint32_t value)
+{
+   BITSET_SET(b->reg_values.known, reg);
+   b->reg_values.values[reg] = value;
+}
+
+/* Values written inside blocks are not known after the block, but the
+ * pending if is flushed by the next instruction, so it counts as top-level.
+ */
+static inline bool
+cs_tracks_reg_values(struct cs_builder *b)
+{
+   return b->conf.dedup_moves &&
+          (cs_cur_block(b) == NULL ||
+           (cs_cur_block(b) == &b->blocks.pending_if.block &&
+            b->blocks.pending_if.block.next == NULL));
+}
+
 static inline void
 cs_move32_to(struct cs_builder *b, struct cs_index dest, unsigned imm)
 {
+   bool track = cs_tracks_reg_values(b);
+
+   if (track && cs_reg_value_known(b, dest.reg, imm))
+      return;
+
    cs_emit(b, MOVE32, I) {
       I.destination = cs_dst32(b, dest);
       I.immediate = imm;
    }
+
+   if (track)
+      cs_set_reg_value(b, dest.reg, imm);
 }
 
 static inline void
 cs_move48_to(struct cs_builder *b, struct cs_index dest, uint64_t imm)
 {
+   bool track = cs_tracks_reg_values(b);
+
+   if (track && cs_reg_value_known(b, dest.reg, imm) &&
+       cs_reg_value_known(b, dest.reg + 1, imm >> 32))
+      return;
+
    cs_emit(b, MOVE48, I) {
       I.destination = cs_dst64(b, dest);
       I.immediate = imm;
    }
+
+   if (track) {
+      cs_set_reg_value(b, dest.reg, imm);
+      cs_set_reg_value(b, dest.reg + 1, imm >> 32);
+   }
 }
 
 static inline void
@@ -933,10 +1014,15 @@ cs_load_ip_to(struct cs_builder *b, struct cs_index dest)
       if (!cs_reserve_instrs(b, 2))
          return;
 
-      /* We make IP point to the instruction right after our MOVE. */
+      /* We make IP point to the instruction right after our MOVE, which
+       * must not be skipped.
+       */
       uint64_t ip =
          b->cur_chunk.buffer.gpu + (sizeof(uint64_t) * (b->cur_chunk.pos + 1));
-      cs_move48_to(b, dest, ip);
+      cs_emit(b, MOVE48, I) {
+         I.destination = cs_dst64(b, dest);
+         I.immediate = ip;
+      }
    } else {
       cs_move48_to(b, dest, b->blocks.last_load_ip_target);
       b->blocks.last_load_ip_target =
@@ -1976,6 +2062,9 @@ cs_call(struct cs_builder *b, struct cs_index address, struct cs_index length)
       I.address = cs_src64(b, address);
       I.length = cs_src32(b, length);
    }
+
+   /* The callee can write any register */
+   cs_forget_reg_values(b);
 }
 
 static inline void
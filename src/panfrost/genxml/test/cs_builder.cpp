@@ -401,3 +401,102 @@ TEST_F(CsBuilderTest, maybe_flush_inner_load)
    EXPECT_U64_ARRAY_EQUAL(output, expected_patched, ARRAY_SIZE(expected_patched));
 }
 
+
+TEST_F(CsBuilderTest, dedup_moves)
+{
+   b.conf.dedup_moves = true;
+
+   cs_move32_to(&b, cs_reg32(&b, 42), 0xdeadbeef);
+   cs_move32_to(&b, cs_reg32(&b, 42), 0xdeadbeef);
+   cs_move32_to(&b, cs_reg32(&b, 42), 0x1);
+   cs_move48_to(&b, cs_reg64(&b, 40), 0x1234);
+   cs_move48_to(&b, cs_reg64(&b, 40), 0x1234);
+   /* MOVE48 zero-extends, so both halves are known */
+   cs_move32_to(&b, cs_reg32(&b, 40), 0x1234);
+   cs_move32_to(&b, cs_reg32(&b, 41), 0);
+   cs_end(&b);
+
+   uint64_t expected[] = {
+      0x022a0000deadbeef, /* MOVE32 r42, #0xdeadbeef */
+      0x022a000000000001, /* MOVE32 r42, #0x1 */
+      0x0128000000001234, /* MOVE48 d40, #0x1234 */
+   };
+   EXPECT_EQ(b.root_chunk.size, ARRAY_SIZE(expected));
+   EXPECT_U64_ARRAY_EQUAL(output, expected, ARRAY_SIZE(expected));
+}
+
+/* Any other write to the register forgets its value */
+TEST_F(CsBuilderTest, dedup_moves_clobber)
+{
+   b.conf.dedup_moves = true;
+
+   cs_move32_to(&b, cs_reg32(&b, 0), 0x5);
+   cs_add32(&b, cs_reg32(&b, 0), cs_reg32(&b, 0), 0x0);
+   cs_move32_to(&b, cs_reg32(&b, 0), 0x5);
+   cs_end(&b);
+
+   uint64_t expected[] = {
+      0x0200000000000005, /* MOVE32 r0, #0x5 */
+      0x1000000000000000, /* ADD32 r0, r0, #0x0 */
+      0x0200000000000005, /* MOVE32 r0, #0x5 */
+   };
+   EXPECT_EQ(b.root_chunk.size, ARRAY_SIZE(expected));
+   EXPECT_U64_ARRAY_EQUAL(output, expected, ARRAY_SIZE(expected));
+}
+
+/* Moves inside blocks are always emitted, and forget the destination value
+ * once the block ends. Values of registers not written in the block are
+ * still known.
+ */
+TEST_F(CsBuilderTest, dedup_moves_if)
+{
+   b.conf.dedup_moves = true;
+
+   cs_move32_to(&b, cs_reg32(&b, 0), 0x5);
+   cs_move32_to(&b, cs_reg32(&b, 2), 0x3);
+   cs_move32_to(&b, cs_reg32(&b, 3), 0x3);
+   cs_if(&b, MALI_CS_CONDITION_GREATER, cs_reg32(&b, 1)) {
+      cs_move32_to(&b, cs_reg32(&b, 0), 0x6);
+      cs_move32_to(&b, cs_reg32(&b, 3), 0x3);
+   }
+   cs_move32_to(&b, cs_reg32(&b, 2), 0x3);
+   cs_move32_to(&b, cs_reg32(&b, 0), 0x5);
+   cs_move32_to(&b, cs_reg32(&b, 3), 0x3);
+   cs_end(&b);
+
+   uint64_t expected[] = {
+      0x0200000000000005, /* MOVE32 r0, #0x5 */
+      0x0202000000000003, /* MOVE32 r2, #0x3 */
+      0x0203000000000003, /* MOVE32 r3, #0x3 */
+      0x1600010000000002, /* BRANCH le, r1, #2 */
+      0x0200000000000006, /* MOVE32 r0, #0x6 */
+      0x0203000000000003, /* MOVE32 r3, #0x3 */
+      0x0200000000000005, /* MOVE32 r0, #0x5 */
+      0x0203000000000003, /* MOVE32 r3, #0x3 */
+   };
+   EXPECT_EQ(b.root_chunk.size, ARRAY_SIZE(expected));
+   EXPECT_U64_ARRAY_EQUAL(output, expected, ARRAY_SIZE(expected));
+}
+
+/* The callee of a CALL can write any register */
+TEST_F(CsBuilderTest, dedup_moves_call)
+{
+   b.conf.dedup_moves = true;
+
+   cs_move32_to(&b, cs_reg32(&b, 0), 0x5);
+   cs_move48_to(&b, cs_reg64(&b, 10), 0x1000);
+   cs_move32_to(&b, cs_reg32(&b, 12), 0x8);
+   cs_call(&b, cs_reg64(&b, 10), cs_reg32(&b, 12));
+   cs_move32_to(&b, cs_reg32(&b, 0), 0x5);
+   cs_end(&b);
+
+   uint64_t expected[] = {
+      0x0200000000000005, /* MOVE32 r0, #0x5 */
+      0x010a000000001000, /* MOVE48 d10, #0x1000 */
+      0x020c000000000008, /* MOVE32 r12, #0x8 */
+      0x20000a0c00000000, /* CALL d10, r12 */
+      0x0200000000000005, /* MOVE32 r0, #0x5 */
+   };
+   EXPECT_EQ(b.root_chunk.size, ARRAY_SIZE(expected));
+   EXPECT_U64_ARRAY_EQUAL(output, expected, ARRAY_SIZE(expected));
+}
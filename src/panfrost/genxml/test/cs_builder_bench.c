@@ -0,0 +1,191 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Micro-benchmark for the CPU cost of recording CSF draws and dispatches.
+ *
+ * The per-draw and per-dispatch sequences mirror what panvk emits: staging
+ * registers for the shader resources and fixed-function state, followed by
+ * RUN_IDVS or RUN_COMPUTE. Pipeline state changes every few draws, the draw
+ * parameters change every draw. Each sequence is recorded with and without
+ * move deduplication, and the recording time and CS size per draw are
+ * reported.
+ */
+
+#include "cs_builder.h"
+
+#include "util/os_time.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHUNK_CAPACITY (64 * 1024)
+
+/* Chunks are never executed, so a single buffer can back all of them. */
+static uint64_t chunk[CHUNK_CAPACITY];
+static unsigned chunk_count;
+
+/* Instructions emitted in the previous chunks, not counting the jumps. */
+static uint64_t chunk_instrs;
+
+static struct cs_buffer
+alloc_chunk(void *cookie)
+{
+   struct cs_builder *b = cookie;
+
+   chunk_instrs += b->cur_chunk.pos;
+   chunk_count++;
+
+   return (struct cs_buffer){
+      .cpu = chunk,
+      .gpu = 0x100000000ull + (uint64_t)chunk_count * sizeof(chunk),
+      .capacity = CHUNK_CAPACITY,
+   };
+}
+
+static void
+emit_draw(struct cs_builder *b, unsigned draw, unsigned state_period)
+{
+   uint64_t state = 0x200000000ull + (draw / state_period) * 0x1000;
+
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, VERTEX_SRT), state + 0x000);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, FRAGMENT_SRT), state + 0x040);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, VERTEX_FAU), state + 0x080);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, FRAGMENT_FAU), state + 0x0c0);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, VERTEX_POS_SPD), state + 0x100);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, VERTEX_VARY_SPD), state + 0x140);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, FRAGMENT_SPD), state + 0x180);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, TSD_0), 0x300000000ull);
+
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, BLEND_DESC), state + 0x200 | 1);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, ZSD), state + 0x240);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, SCISSOR_BOX), 0x03ff07ff00000000ull);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, LOW_DEPTH_CLAMP), 0);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, HIGH_DEPTH_CLAMP), 0x3f800000);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, TILER_FLAGS), 0x4a);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, DCD0), 0x1020);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, DCD1), 0x0);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, DCD2), 0x0);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, VARY_SIZE), 0x10);
+   cs_move64_to(b, cs_sr_reg64(b, IDVS, INDEX_BUFFER), 0x400000000ull);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, INDEX_BUFFER_SIZE), 0x10000);
+
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, GLOBAL_ATTRIBUTE_OFFSET), 0);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, INDEX_COUNT), 3 + (draw % 64) * 3);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, INSTANCE_COUNT), 1);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, INDEX_OFFSET), draw * 3);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, VERTEX_OFFSET), 0);
+   cs_move32_to(b, cs_sr_reg32(b, IDVS, INSTANCE_OFFSET), 0);
+
+   cs_run_idvs(b, 0, false, cs_shader_res_sel(0, 0, 1, 0),
+               cs_shader_res_sel(2, 2, 2, 0), cs_undef());
+}
+
+static void
+emit_dispatch(struct cs_builder *b, unsigned dispatch, unsigned state_period)
+{
+   uint64_t state = 0x200000000ull + (dispatch / state_period) * 0x1000;
+
+   cs_move64_to(b, cs_sr_reg64(b, COMPUTE, SRT_0), state + 0x000);
+   cs_move64_to(b, cs_sr_reg64(b, COMPUTE, FAU_0), state + 0x040);
+   cs_move64_to(b, cs_sr_reg64(b, COMPUTE, SPD_0), state + 0x080);
+   cs_move64_to(b, cs_sr_reg64(b, COMPUTE, TSD_0), 0x300000000ull);
+
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, GLOBAL_ATTRIBUTE_OFFSET), 0);
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, WG_SIZE), 63);
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, JOB_OFFSET_X), 0);
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, JOB_OFFSET_Y), 0);
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, JOB_OFFSET_Z), 0);
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, JOB_SIZE_X), 1 + dispatch % 32);
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, JOB_SIZE_Y), 1);
+   cs_move32_to(b, cs_sr_reg32(b, COMPUTE, JOB_SIZE_Z), 1);
+
+   cs_run_compute(b, 1, MALI_TASK_AXIS_X, cs_shader_res_sel(0, 0, 0, 0));
+}
+
+static void
+bench(const char *name,
+      void (*emit)(struct cs_builder *b, unsigned i, unsigned state_period),
+      unsigned count, unsigned iterations, unsigned state_period, bool dedup)
+{
+   struct cs_builder_conf conf = {
+      .nr_registers = 96,
+      .nr_kernel_registers = 4,
+      .alloc_buffer = alloc_chunk,
+      .ls_sb_slot = 0,
+      .dedup_moves = dedup,
+   };
+   uint64_t instrs = 0;
+   int64_t elapsed = 0;
+
+   for (unsigned it = 0; it < iterations; it++) {
+      struct cs_builder b;
+      struct cs_buffer root = {0};
+
+      conf.cookie = &b;
+      chunk_count = 0;
+      chunk_instrs = 0;
+
+      int64_t start = os_time_get_nano();
+      cs_builder_init(&b, &conf, root);
+      for (unsigned i = 0; i < count; i++)
+         emit(&b, i, state_period);
+      instrs += chunk_instrs + b.cur_chunk.pos;
+      cs_end(&b);
+      elapsed += os_time_get_nano() - start;
+
+      cs_builder_fini(&b);
+   }
+
+   double per = (double)count * iterations;
+   printf("%-10s dedup %-3s: %8.1f ns, %5.1f instrs each\n", name,
+          dedup ? "on" : "off", elapsed / per, instrs / per);
+}
+
+static void
+usage(const char *name)
+{
+   fprintf(stderr,
+           "Usage: %s [-c count] [-n iterations] [-s state period]\n", name);
+}
+
+int
+main(int argc, char **argv)
+{
+   static const struct option opts[] = {
+      { "count", required_argument, NULL, 'c' },
+      { "iterations", required_argument, NULL, 'n' },
+      { "state-period", required_argument, NULL, 's' },
+      { NULL, 0, NULL, 0 },
+   };
+   unsigned count = 10000;
+   unsigned iterations = 20;
+   unsigned state_period = 8;
+   int c;
+
+   while ((c = getopt_long(argc, argv, "c:n:s:", opts, NULL)) != -1) {
+      switch (c) {
+      case 'c':
+         count = atoi(optarg);
+         break;
+      case 'n':
+         iterations = atoi(optarg);
+         break;
+      case 's':
+         state_period = MAX2(atoi(optarg), 1);
+         break;
+      default:
+         usage(argv[0]);
+         return 1;
+      }
+   }
+
+   for (unsigned dedup = 0; dedup < 2; dedup++) {
+      bench("draw", emit_draw, count, iterations, state_period, dedup);
+      bench("dispatch", emit_dispatch, count, iterations, state_period, dedup);
+   }
+
+   return 0;
+}
@@ -799,6 +799,8 @@ init_cs_builders(struct panvk_cmd_buffer *cmdbuf)
          .alloc_buffer = alloc_cs_buffer,
          .cookie = cmdbuf,
          .ls_sb_slot = SB_ID(LS),
+         /* Only the CS and the secondaries it calls write the registers */
+         .dedup_moves = true,
       };
 
       if (PANVK_DEBUG(CS)) {
@@ -0,0 +1,414 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Measures the CPU overhead of a GL driver by running synthetic workloads on
+ * a surfaceless EGL context and reporting the time spent per operation.
+ *
+ * It is meant to be run with a no-op drm-shim preloaded, so that the GPU
+ * doesn't take part and only the driver CPU paths are timed:
+ *
+ *    LD_PRELOAD=libv3d_noop_drm_shim.so drm-shim-bench
+ *
+ * Each line of output is "<renderer>\t<workload>\t<ns per op>".
+ */
+
+#include <dlfcn.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EGL_EGL_PROTOTYPES 0
+#define GL_GLES_PROTOTYPES 0
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+
+#include "util/macros.h"
+#include "util/os_time.h"
+
+#define BENCH_SIZE 64
+#define BENCH_TEXTURES 16
+#define BENCH_FLUSH_INTERVAL 256
+
+#define EGL_FUNCS(X)                                                         \
+   X(PFNEGLGETPLATFORMDISPLAYPROC, eglGetPlatformDisplay)                    \
+   X(PFNEGLINITIALIZEPROC, eglInitialize)                                    \
+   X(PFNEGLTERMINATEPROC, eglTerminate)                                      \
+   X(PFNEGLBINDAPIPROC, eglBindAPI)                                          \
+   X(PFNEGLCREATECONTEXTPROC, eglCreateContext)                              \
+   X(PFNEGLDESTROYCONTEXTPROC, eglDestroyContext)                            \
+   X(PFNEGLMAKECURRENTPROC, eglMakeCurrent)
+
+#define GL_FUNCS(X)                                                          \
+   X(PFNGLGETSTRINGPROC, glGetString)                                        \
+   X(PFNGLGENFRAMEBUFFERSPROC, glGenFramebuffers)                            \
+   X(PFNGLBINDFRAMEBUFFERPROC, glBindFramebuffer)                            \
+   X(PFNGLGENRENDERBUFFERSPROC, glGenRenderbuffers)                          \
+   X(PFNGLBINDRENDERBUFFERPROC, glBindRenderbuffer)                          \
+   X(PFNGLRENDERBUFFERSTORAGEPROC, glRenderbufferStorage)                    \
+   X(PFNGLFRAMEBUFFERRENDERBUFFERPROC, glFramebufferRenderbuffer)            \
+   X(PFNGLCREATESHADERPROC, glCreateShader)                                  \
+   X(PFNGLSHADERSOURCEPROC, glShaderSource)                                  \
+   X(PFNGLCOMPILESHADERPROC, glCompileShader)                                \
+   X(PFNGLDELETESHADERPROC, glDeleteShader)                                  \
+   X(PFNGLCREATEPROGRAMPROC, glCreateProgram)                                \
+   X(PFNGLATTACHSHADERPROC, glAttachShader)                                  \
+   X(PFNGLLINKPROGRAMPROC, glLinkProgram)                                    \
+   X(PFNGLGETPROGRAMIVPROC, glGetProgramiv)                                  \
+   X(PFNGLUSEPROGRAMPROC, glUseProgram)                                      \
+   X(PFNGLDELETEPROGRAMPROC, glDeleteProgram)                                \
+   X(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation)                      \
+   X(PFNGLUNIFORM1IPROC, glUniform1i)                                        \
+   X(PFNGLGETUNIFORMBLOCKINDEXPROC, glGetUniformBlockIndex)                  \
+   X(PFNGLUNIFORMBLOCKBINDINGPROC, glUniformBlockBinding)                    \
+   X(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays)                            \
+   X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray)                            \
+   X(PFNGLGENBUFFERSPROC, glGenBuffers)                                      \
+   X(PFNGLBINDBUFFERPROC, glBindBuffer)                                      \
+   X(PFNGLBINDBUFFERRANGEPROC, glBindBufferRange)                            \
+   X(PFNGLBUFFERDATAPROC, glBufferData)                                      \
+   X(PFNGLGETINTEGERVPROC, glGetIntegerv)                                    \
+   X(PFNGLGENTEXTURESPROC, glGenTextures)                                    \
+   X(PFNGLBINDTEXTUREPROC, glBindTexture)                                    \
+   X(PFNGLACTIVETEXTUREPROC, glActiveTexture)                                \
+   X(PFNGLTEXSTORAGE2DPROC, glTexStorage2D)                                  \
+   X(PFNGLTEXPARAMETERIPROC, glTexParameteri)                                \
+   X(PFNGLVIEWPORTPROC, glViewport)                                          \
+   X(PFNGLENABLEPROC, glEnable)                                              \
+   X(PFNGLDISABLEPROC, glDisable)                                            \
+   X(PFNGLBLENDFUNCPROC, glBlendFunc)                                        \
+   X(PFNGLDEPTHFUNCPROC, glDepthFunc)                                        \
+   X(PFNGLCULLFACEPROC, glCullFace)                                          \
+   X(PFNGLCOLORMASKPROC, glColorMask)                                        \
+   X(PFNGLDRAWARRAYSPROC, glDrawArrays)                                      \
+   X(PFNGLFLUSHPROC, glFlush)                                                \
+   X(PFNGLFINISHPROC, glFinish)
+
+#define DECLARE_FUNC(type, name) static type p_##name;
+EGL_FUNCS(DECLARE_FUNC)
+GL_FUNCS(DECLARE_FUNC)
+#undef DECLARE_FUNC
+
+struct bench {
+   GLuint draw_program;
+   GLuint texture_program;
+   GLuint textures[BENCH_TEXTURES];
+   GLuint ubo;
+   GLint ubo_alignment;
+   /* Makes every shader source unique, so that no shader cache is hit. */
+   uint64_t nonce;
+};
+
+static const char *vs_source =
+   "#version 300 es\n"
+   "void main() {\n"
+   "   vec2 pos = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+   "   gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);\n"
+   "}\n";
+
+static bool
+load_functions(void)
+{
+   void *egl = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+   if (!egl) {
+      fprintf(stderr, "Failed to load libEGL.so.1: %s\n", dlerror());
+      return false;
+   }
+
+   PFNEGLGETPROCADDRESSPROC get_proc_address =
+      (PFNEGLGETPROCADDRESSPROC)dlsym(egl, "eglGetProcAddress");
+   if (!get_proc_address) {
+      fprintf(stderr, "libEGL.so.1 has no eglGetProcAddress\n");
+      return false;
+   }
+
+   /* Core functions are available through eglGetProcAddress thanks to
+    * EGL_KHR_get_all_proc_addresses, which Mesa always exposes.
+    */
+#define LOAD_FUNC(type, name)                                                \
+   p_##name = (type)get_proc_address(#name);                                 \
+   if (!p_##name) {                                                          \
+      fprintf(stderr, "Failed to resolve %s\n", #name);                      \
+      return false;                                                          \
+   }
+   EGL_FUNCS(LOAD_FUNC)
+   GL_FUNCS(LOAD_FUNC)
+#undef LOAD_FUNC
+
+   return true;
+}
+
+static GLuint
+compile_shader(GLenum stage, const char *source)
+{
+   GLuint shader = p_glCreateShader(stage);
+
+   p_glShaderSource(shader, 1, &source, NULL);
+   p_glCompileShader(shader);
+   return shader;
+}
+
+static GLuint
+create_program(struct bench *bench, const char *fs_body)
+{
+   char fs_source[1024];
+
+   snprintf(fs_source, sizeof(fs_source),
+            "#version 300 es\n"
+            "precision mediump float;\n"
+            "uniform sampler2D tex;\n"
+            "layout(std140) uniform block { vec4 color; };\n"
+            "out vec4 result;\n"
+            "void main() {\n"
+            "   result = %s + vec4(float(%u) * 1e-9);\n"
+            "}\n",
+            fs_body, (unsigned)(bench->nonce++ % 1000000));
+
+   GLuint vs = compile_shader(GL_VERTEX_SHADER, vs_source);
+   GLuint fs = compile_shader(GL_FRAGMENT_SHADER, fs_source);
+   GLuint program = p_glCreateProgram();
+
+   p_glAttachShader(program, vs);
+   p_glAttachShader(program, fs);
+   p_glLinkProgram(program);
+   p_glDeleteShader(vs);
+   p_glDeleteShader(fs);
+
+   GLint status = GL_FALSE;
+   p_glGetProgramiv(program, GL_LINK_STATUS, &status);
+   if (!status) {
+      p_glDeleteProgram(program);
+      return 0;
+   }
+
+   GLuint block = p_glGetUniformBlockIndex(program, "block");
+   if (block != GL_INVALID_INDEX)
+      p_glUniformBlockBinding(program, block, 0);
+
+   return program;
+}
+
+static bool
+bench_init(struct bench *bench)
+{
+   GLuint fbo, rb, vao;
+
+   bench->nonce = os_time_get_nano();
+
+   p_glGenRenderbuffers(1, &rb);
+   p_glBindRenderbuffer(GL_RENDERBUFFER, rb);
+   p_glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, BENCH_SIZE, BENCH_SIZE);
+   p_glGenFramebuffers(1, &fbo);
+   p_glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+   p_glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_RENDERBUFFER, rb);
+   p_glViewport(0, 0, BENCH_SIZE, BENCH_SIZE);
+
+   p_glGenVertexArrays(1, &vao);
+   p_glBindVertexArray(vao);
+
+   p_glGenTextures(BENCH_TEXTURES, bench->textures);
+   for (unsigned i = 0; i < BENCH_TEXTURES; i++) {
+      p_glBindTexture(GL_TEXTURE_2D, bench->textures[i]);
+      p_glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 16, 16);
+      p_glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+   }
+
+   p_glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &bench->ubo_alignment);
+   bench->ubo_alignment = MAX2(bench->ubo_alignment, 16);
+   p_glGenBuffers(1, &bench->ubo);
+   p_glBindBuffer(GL_UNIFORM_BUFFER, bench->ubo);
+   p_glBufferData(GL_UNIFORM_BUFFER, bench->ubo_alignment * BENCH_TEXTURES,
+                  NULL, GL_STATIC_DRAW);
+   p_glBindBufferRange(GL_UNIFORM_BUFFER, 0, bench->ubo, 0, 16);
+
+   bench->draw_program = create_program(bench, "color");
+   bench->texture_program = create_program(bench, "texture(tex, vec2(0.5)) * color");
+   if (!bench->draw_program || !bench->texture_program) {
+      fprintf(stderr, "Failed to link the benchmark programs\n");
+      return false;
+   }
+
+   return true;
+}
+
+static void
+draw(unsigned i)
+{
+   p_glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+   if (i % BENCH_FLUSH_INTERVAL == BENCH_FLUSH_INTERVAL - 1)
+      p_glFlush();
+}
+
+/* Back-to-back draws without any state change. */
+static void
+bench_draw(struct bench *bench, unsigned count)
+{
+   p_glUseProgram(bench->draw_program);
+   for (unsigned i = 0; i < count; i++)
+      draw(i);
+}
+
+/* Fixed function state that changes on every draw. */
+static void
+bench_state_change(struct bench *bench, unsigned count)
+{
+   p_glUseProgram(bench->draw_program);
+   p_glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+   for (unsigned i = 0; i < count; i++) {
+      bool odd = i & 1;
+
+      if (odd) {
+         p_glEnable(GL_BLEND);
+         p_glEnable(GL_DEPTH_TEST);
+      } else {
+         p_glDisable(GL_BLEND);
+         p_glDisable(GL_DEPTH_TEST);
+      }
+      p_glDepthFunc(odd ? GL_LEQUAL : GL_LESS);
+      p_glCullFace(odd ? GL_FRONT : GL_BACK);
+      p_glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, odd);
+      p_glViewport(0, 0, BENCH_SIZE - odd, BENCH_SIZE);
+      draw(i);
+   }
+}
+
+/* New texture and uniform buffer bindings on every draw. */
+static void
+bench_descriptor_update(struct bench *bench, unsigned count)
+{
+   p_glUseProgram(bench->texture_program);
+   p_glUniform1i(p_glGetUniformLocation(bench->texture_program, "tex"), 0);
+   p_glActiveTexture(GL_TEXTURE0);
+   for (unsigned i = 0; i < count; i++) {
+      unsigned slot = i % BENCH_TEXTURES;
+
+      p_glBindTexture(GL_TEXTURE_2D, bench->textures[slot]);
+      p_glBindBufferRange(GL_UNIFORM_BUFFER, 0, bench->ubo,
+                          slot * bench->ubo_alignment, 16);
+      draw(i);
+   }
+}
+
+/* Compile, link and first draw of a program that was never seen before. */
+static void
+bench_pipeline_create(struct bench *bench, unsigned count)
+{
+   for (unsigned i = 0; i < count; i++) {
+      GLuint program = create_program(bench, "color");
+
+      p_glUseProgram(program);
+      draw(i);
+      p_glUseProgram(0);
+      p_glDeleteProgram(program);
+   }
+}
+
+static const struct {
+   const char *name;
+   void (*run)(struct bench *bench, unsigned count);
+   /* Relative cost, used to scale down the iteration count. */
+   unsigned divisor;
+} workloads[] = {
+   { "draw", bench_draw, 1 },
+   { "state-change", bench_state_change, 1 },
+   { "descriptor-update", bench_descriptor_update, 1 },
+   { "pipeline-create", bench_pipeline_create, 1000 },
+};
+
+static void
+print_usage(const char *prog)
+{
+   fprintf(stderr,
+           "Usage: %s [-n <iterations>] [<workload>...]\n"
+           "\n"
+           "Runs the given workloads (all of them by default) and prints the\n"
+           "CPU time spent per operation. Workloads:",
+           prog);
+   for (unsigned i = 0; i < ARRAY_SIZE(workloads); i++)
+      fprintf(stderr, " %s", workloads[i].name);
+   fprintf(stderr, "\n");
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned iterations = 100000;
+   bool selected[ARRAY_SIZE(workloads)] = {0};
+   bool any_selected = false;
+
+   for (int i = 1; i < argc; i++) {
+      if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+         iterations = strtoul(argv[++i], NULL, 0);
+         continue;
+      }
+
+      unsigned w;
+      for (w = 0; w < ARRAY_SIZE(workloads); w++) {
+         if (!strcmp(argv[i], workloads[w].name))
+            break;
+      }
+      if (w == ARRAY_SIZE(workloads)) {
+         print_usage(argv[0]);
+         return 1;
+      }
+      selected[w] = any_selected = true;
+   }
+
+   if (!load_functions())
+      return 1;
+
+   EGLDisplay dpy = p_eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                            EGL_DEFAULT_DISPLAY, NULL);
+   if (dpy == EGL_NO_DISPLAY || !p_eglInitialize(dpy, NULL, NULL)) {
+      fprintf(stderr, "Failed to initialize a surfaceless EGL display\n");
+      return 1;
+   }
+
+   static const EGLint ctx_attribs[] = {
+      EGL_CONTEXT_MAJOR_VERSION, 3,
+      EGL_NONE,
+   };
+   p_eglBindAPI(EGL_OPENGL_ES_API);
+   EGLContext ctx = p_eglCreateContext(dpy, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT,
+                                       ctx_attribs);
+   if (ctx == EGL_NO_CONTEXT ||
+       !p_eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx)) {
+      fprintf(stderr, "Failed to create a GLES 3.0 context\n");
+      return 1;
+   }
+
+   struct bench bench = {0};
+   if (!bench_init(&bench))
+      return 1;
+
+   const char *renderer = (const char *)p_glGetString(GL_RENDERER);
+
+   for (unsigned w = 0; w < ARRAY_SIZE(workloads); w++) {
+      if (any_selected && !selected[w])
+         continue;
+
+      unsigned count = MAX2(iterations / workloads[w].divisor, 1);
+
+      /* Warm up, so that one-time state creation isn't measured. */
+      workloads[w].run(&bench, MAX2(count / 10, 1));
+      p_glFinish();
+
+      int64_t start = os_time_get_nano();
+      workloads[w].run(&bench, count);
+      p_glFinish();
+      int64_t elapsed = os_time_get_nano() - start;
+
+      printf("%s\t%s\t%.1f\n", renderer, workloads[w].name,
+             (double)elapsed / count);
+   }
+
+   p_eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+   p_eglDestroyContext(dpy, ctx);
+   p_eglTerminate(dpy);
+   return 0;
+}
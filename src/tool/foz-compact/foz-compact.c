@@ -0,0 +1,55 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Offline maintenance of the read only fossilize dbs given to
+ * MESA_DISK_CACHE_READ_ONLY_FOZ_DBS: drops duplicated and corrupt entries and
+ * writes the sorted index that lets them be loaded without parsing the index.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "util/fossilize_db.h"
+
+static void
+print_usage(const char *prog)
+{
+   fprintf(stderr,
+           "Usage: %s <cache dir> <name> <new name>\n"
+           "       %s --index-only <cache dir> <name>\n"
+           "\n"
+           "Copies the valid entries of <name>.foz into <new name>.foz and\n"
+           "writes its sorted index. With --index-only the sorted index of\n"
+           "<name>.foz is written in place instead.\n",
+           prog, prog);
+}
+
+int
+main(int argc, char **argv)
+{
+   if (argc == 4 && !strcmp(argv[1], "--index-only")) {
+      if (!foz_write_sorted_index(argv[2], argv[3])) {
+         fprintf(stderr, "Failed to write the sorted index of %s/%s\n",
+                 argv[2], argv[3]);
+         return 1;
+      }
+      return 0;
+   }
+
+   if (argc != 4 || argv[1][0] == '-') {
+      print_usage(argv[0]);
+      return 1;
+   }
+
+   unsigned num_kept = 0, num_dropped = 0;
+   if (!foz_compact(argv[1], argv[2], argv[3], &num_kept, &num_dropped)) {
+      fprintf(stderr, "Failed to compact %s/%s into %s\n",
+              argv[1], argv[2], argv[3]);
+      return 1;
+   }
+
+   printf("%u entries kept, %u dropped\n", num_kept, num_dropped);
+   return 0;
+}
@@ -22,6 +22,13 @@
 
 #define CORRELATION_TIMESTAMP_PERIOD (1000000000ull)
 
+// Period at which every counter value is sent, even unchanged ones
+#define FULL_SAMPLE_PERIOD (1000000000ull)
+
+// While no counter changes, the sampling period is doubled up to this many
+// times
+#define MAX_IDLE_SHIFT 3
+
 namespace pps
 {
 /// A data source supports one driver at a time, but if you need more
@@ -88,6 +95,7 @@ void GpuDataSource::OnStart(const StartArgs &args)
 
    state = State::Start;
    got_first_counters = false;
+   idle_shift = 0;
 
    {
       std::lock_guard<std::mutex> lock(started_m);
@@ -190,18 +198,28 @@ template <typename GpuCounterDescriptor> void add_descriptors(GpuCounterDescript
    }
 }
 
-void add_samples(perfetto::protos::pbzero::GpuCounterEvent &event, const Driver &driver)
+/// @param values Values of the enabled counters for this sample
+/// @param last_values Values sent with the previous sample, empty if none
+/// @param all Whether to add unchanged values too
+///
+/// Perfetto keeps showing the last value of a counter until a new one comes,
+/// so only the values which changed since the previous sample are added.
+void add_samples(perfetto::protos::pbzero::GpuCounterEvent &event,
+   const Driver &driver,
+   const std::vector<Counter::Value> &values,
+   const std::vector<Counter::Value> &last_values,
+   bool all)
 {
-   if (driver.enabled_counters.size() == 0) {
-      PPS_LOG_FATAL("There are no counters enabled");
-   }
+   for (size_t i = 0; i < values.size(); i++) {
+      if (!all && values[i] == last_values[i])
+         continue;
 
-   for (const auto &counter : driver.enabled_counters) {
+      const auto &counter = driver.enabled_counters[i];
       auto counter_event = event.add_counters();
 
       counter_event->set_counter_id(counter.id);
 
-      auto value = counter.get_value(driver);
+      auto &value = values[i];
       if (auto d_value = std::get_if<double>(&value)) {
          counter_event->set_double_value(*d_value);
       } else if (auto i_value = std::get_if<int64_t>(&value)) {
@@ -288,8 +306,20 @@ void GpuDataSource::trace(TraceContext &ctx)
       // be discarded.
       descriptor_gpu_timestamp = driver->gpu_timestamp();
       state->was_cleared = false;
+
+      // Values sent before this point may be lost
+      last_values.clear();
+   }
+
+   if (driver->enabled_counters.size() == 0) {
+      PPS_LOG_FATAL("There are no counters enabled");
    }
 
+   uint64_t cpu_ts = perfetto::base::GetBootTimeNs().count();
+   bool full_sample = last_values.empty() ||
+      (cpu_ts - last_full_sample_timestamp) > FULL_SAMPLE_PERIOD;
+   bool changed = false;
+
    if (driver->dump_perfcnt()) {
       while (auto gpu_timestamp = driver->next()) {
          if (gpu_timestamp <= descriptor_gpu_timestamp) {
@@ -303,6 +333,15 @@ void GpuDataSource::trace(TraceContext &ctx)
             got_first_counters = true;
          }
 
+         std::vector<Counter::Value> values;
+         values.reserve(driver->enabled_counters.size());
+         for (const auto &counter : driver->enabled_counters)
+            values.push_back(counter.get_value(*driver));
+
+         bool differs = values != last_values;
+         if (!differs && !full_sample)
+            continue;
+
          auto packet = ctx.NewTracePacket();
          packet->set_timestamp_clock_id(driver->gpu_clock_id());
          packet->set_timestamp(gpu_timestamp);
@@ -310,11 +349,24 @@ void GpuDataSource::trace(TraceContext &ctx)
          auto event = packet->set_gpu_counter_event();
          event->set_gpu_id(driver->drm_device.gpu_num);
 
-         add_samples(*event, *driver);
+         add_samples(*event, *driver, values, last_values, full_sample);
+
+         changed |= differs;
+         if (full_sample) {
+            last_full_sample_timestamp = cpu_ts;
+            full_sample = false;
+         }
+         last_values = std::move(values);
       }
    }
 
-   uint64_t cpu_ts = perfetto::base::GetBootTimeNs().count();
+   // Sample less often while the GPU is idle, and go back to the requested
+   // period as soon as a counter moves again.
+   if (changed)
+      idle_shift = 0;
+   else if (got_first_counters && idle_shift < MAX_IDLE_SHIFT)
+      idle_shift++;
+
    if ((cpu_ts - last_correlation_timestamp) > CORRELATION_TIMESTAMP_PERIOD) {
       auto packet = ctx.NewTracePacket();
       packet->set_timestamp_clock_id(perfetto::protos::pbzero::BUILTIN_CLOCK_BOOTTIME);
@@ -332,8 +384,9 @@ void GpuDataSource::trace_callback(TraceContext ctx)
    nanoseconds sleep_time = nanoseconds(0);
 
    if (auto data_source = ctx.GetDataSourceLocked()) {
-      if (data_source->time_to_sleep > data_source->time_to_trace) {
-         sleep_time = data_source->time_to_sleep - data_source->time_to_trace;
+      auto period = data_source->time_to_sleep * (1 << data_source->idle_shift);
+      if (period > data_source->time_to_trace) {
+         sleep_time = period - data_source->time_to_trace;
       }
    }
 
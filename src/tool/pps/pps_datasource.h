@@ -64,6 +64,17 @@ class GpuDataSource : public perfetto::DataSource<GpuDataSource, GpuDataSourceTr
 
    /// Used to track the first available counters
    bool got_first_counters = false;
+
+   /// Counter values sent with the last sample, empty when they have to be
+   /// sent again
+   std::vector<Counter::Value> last_values;
+
+   /// Last CPU timestamp at which all of the counter values were sent
+   uint64_t last_full_sample_timestamp = 0;
+
+   /// The sampling period is time_to_sleep << idle_shift, it grows while no
+   /// counter changes between samples
+   uint32_t idle_shift = 0;
 };
 
 } // namespace pps
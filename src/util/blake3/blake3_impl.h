@@ -220,10 +220,10 @@ void blake3_hash_many(const uint8_t *const *inputs, size_t num_inputs,
 
 size_t blake3_simd_degree(void);
 
-static size_t blake3_compress_subtree_wide(const uint8_t *input, size_t input_len,
-                                           const uint32_t key[8],
-                                           uint64_t chunk_counter, uint8_t flags,
-                                           uint8_t *out, bool use_tbb);
+size_t blake3_compress_subtree_wide(const uint8_t *input, size_t input_len,
+                                    const uint32_t key[8],
+                                    uint64_t chunk_counter, uint8_t flags,
+                                    uint8_t *out, bool use_tbb);
 
 #if defined(BLAKE3_USE_TBB)
 void blake3_compress_subtree_wide_join_tbb(
@@ -23,6 +23,10 @@
 
 #include <string.h>
 
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
+
 #include "blob.h"
 #include "u_math.h"
 
@@ -76,6 +80,87 @@ grow_to_fit(struct blob *blob, size_t additional)
    return true;
 }
 
+/* Ensure that a chunked blob has enough chunks to write \additional bytes.
+ * Unlike grow_to_fit, the data already written is never moved.
+ */
+static bool
+grow_chunks_to_fit(struct blob *blob, size_t additional)
+{
+   if (blob->out_of_memory)
+      return false;
+
+   if (blob->size + additional < blob->size) {
+      blob->out_of_memory = true;
+      return false;
+   }
+
+   while (blob->allocated < blob->size + additional) {
+      if (blob->num_chunks == blob->max_chunks) {
+         unsigned max_chunks = MAX2(blob->max_chunks * 2, 16);
+         struct blob_chunk *chunks =
+            realloc(blob->chunks, max_chunks * sizeof(*chunks));
+         if (chunks == NULL) {
+            blob->out_of_memory = true;
+            return false;
+         }
+
+         blob->chunks = chunks;
+         blob->max_chunks = max_chunks;
+      }
+
+      uint8_t *data = malloc(blob->chunk_size);
+      if (data == NULL) {
+         blob->out_of_memory = true;
+         return false;
+      }
+
+      blob->chunks[blob->num_chunks].data = data;
+      blob->chunks[blob->num_chunks].size = 0;
+      blob->num_chunks++;
+      blob->allocated += blob->chunk_size;
+   }
+
+   return true;
+}
+
+/* Copy \bytes to \offset of a chunked blob, splitting the copy at chunk
+ * boundaries. A NULL \bytes writes zeros.
+ */
+static void
+chunked_copy(struct blob *blob, size_t offset, const void *bytes,
+             size_t to_write)
+{
+   const uint8_t *src = bytes;
+
+   while (to_write > 0) {
+      struct blob_chunk *chunk = &blob->chunks[offset / blob->chunk_size];
+      size_t chunk_offset = offset % blob->chunk_size;
+      size_t len = MIN2(to_write, blob->chunk_size - chunk_offset);
+
+      if (src) {
+         memcpy(chunk->data + chunk_offset, src, len);
+         src += len;
+      } else {
+         memset(chunk->data + chunk_offset, 0, len);
+      }
+
+      offset += len;
+      to_write -= len;
+   }
+}
+
+/* Grow the size of a chunked blob, updating the size of the chunks. */
+static void
+chunked_set_size(struct blob *blob, size_t new_size)
+{
+   for (unsigned i = blob->size / blob->chunk_size;
+        i < blob->num_chunks && i * blob->chunk_size < new_size; i++)
+      blob->chunks[i].size = MIN2(blob->chunk_size,
+                                  new_size - i * blob->chunk_size);
+
+   blob->size = new_size;
+}
+
 /* Align the blob->size so that reading or writing a value at (blob->data +
  * blob->size) will result in an access aligned to a granularity of \alignment
  * bytes.
@@ -87,6 +172,15 @@ blob_align(struct blob *blob, size_t alignment)
 {
    const size_t new_size = align_uintptr(blob->size, alignment);
 
+   if (blob->chunk_size && blob->size < new_size) {
+      if (!grow_chunks_to_fit(blob, new_size - blob->size))
+         return false;
+
+      chunked_copy(blob, blob->size, NULL, new_size - blob->size);
+      chunked_set_size(blob, new_size);
+      return true;
+   }
+
    if (blob->size < new_size) {
       if (!grow_to_fit(blob, new_size - blob->size))
          return false;
@@ -113,6 +207,10 @@ blob_init(struct blob *blob)
    blob->size = 0;
    blob->fixed_allocation = false;
    blob->out_of_memory = false;
+   blob->chunk_size = 0;
+   blob->chunks = NULL;
+   blob->num_chunks = 0;
+   blob->max_chunks = 0;
 }
 
 void
@@ -123,11 +221,101 @@ blob_init_fixed(struct blob *blob, void *data, size_t size)
    blob->size = 0;
    blob->fixed_allocation = true;
    blob->out_of_memory = false;
+   blob->chunk_size = 0;
+   blob->chunks = NULL;
+   blob->num_chunks = 0;
+   blob->max_chunks = 0;
+}
+
+void
+blob_init_chunked(struct blob *blob, size_t chunk_size)
+{
+   assert(chunk_size > 0);
+
+   blob_init(blob);
+   blob->chunk_size = chunk_size;
 }
 
+void
+blob_free_chunks(struct blob *blob)
+{
+   for (unsigned i = 0; i < blob->num_chunks; i++)
+      free(blob->chunks[i].data);
+   free(blob->chunks);
+
+   blob->chunks = NULL;
+   blob->num_chunks = 0;
+   blob->max_chunks = 0;
+   blob->allocated = 0;
+}
+
+void
+blob_copy_to(const struct blob *blob, void *dst)
+{
+   if (!blob->chunk_size) {
+      if (blob->data && blob->size)
+         memcpy(dst, blob->data, blob->size);
+      return;
+   }
+
+   uint8_t *out = dst;
+   for (unsigned i = 0; i < blob->num_chunks; i++) {
+      memcpy(out, blob->chunks[i].data, blob->chunks[i].size);
+      out += blob->chunks[i].size;
+   }
+}
+
+unsigned
+blob_get_chunks(const struct blob *blob, struct blob_chunk *chunks,
+                unsigned max_chunks)
+{
+   if (!blob->chunk_size) {
+      if (max_chunks > 0) {
+         chunks[0].data = blob->data;
+         chunks[0].size = blob->size;
+      }
+      return 1;
+   }
+
+   /* Chunks are allocated ahead of the writes, skip the unused ones. */
+   unsigned num_chunks = DIV_ROUND_UP(blob->size, blob->chunk_size);
+   memcpy(chunks, blob->chunks, MIN2(num_chunks, max_chunks) * sizeof(*chunks));
+   return num_chunks;
+}
+
+#ifndef _WIN32
+unsigned
+blob_get_iovecs(const struct blob *blob, struct iovec *iov, unsigned max_iov)
+{
+   if (!blob->chunk_size) {
+      if (max_iov > 0) {
+         iov[0].iov_base = blob->data;
+         iov[0].iov_len = blob->size;
+      }
+      return 1;
+   }
+
+   unsigned num_chunks = DIV_ROUND_UP(blob->size, blob->chunk_size);
+   for (unsigned i = 0; i < MIN2(num_chunks, max_iov); i++) {
+      iov[i].iov_base = blob->chunks[i].data;
+      iov[i].iov_len = blob->chunks[i].size;
+   }
+   return num_chunks;
+}
+#endif
+
 void
 blob_finish_get_buffer(struct blob *blob, void **buffer, size_t *size)
 {
+   if (blob->chunk_size) {
+      *size = blob->size;
+      *buffer = malloc(MAX2(blob->size, 1));
+      if (*buffer)
+         blob_copy_to(blob, *buffer);
+      blob_free_chunks(blob);
+      return;
+   }
+
    *buffer = blob->data;
    *size = blob->size;
    blob->data = NULL;
@@ -148,7 +336,9 @@ blob_overwrite_bytes(struct blob *blob,
 
    VG(VALGRIND_CHECK_MEM_IS_DEFINED(bytes, to_write));
 
-   if (blob->data)
+   if (blob->chunk_size)
+      chunked_copy(blob, offset, bytes, to_write);
+   else if (blob->data)
       memcpy(blob->data + offset, bytes, to_write);
 
    return true;
@@ -157,6 +347,18 @@ blob_overwrite_bytes(struct blob *blob,
 bool
 blob_write_bytes(struct blob *blob, const void *bytes, size_t to_write)
 {
+   if (blob->chunk_size) {
+      if (!grow_chunks_to_fit(blob, to_write))
+         return false;
+
+      if (to_write > 0) {
+         VG(VALGRIND_CHECK_MEM_IS_DEFINED(bytes, to_write));
+         chunked_copy(blob, blob->size, bytes, to_write);
+      }
+      chunked_set_size(blob, blob->size + to_write);
+      return true;
+   }
+
    if (! grow_to_fit(blob, to_write))
        return false;
 
@@ -174,6 +376,15 @@ blob_reserve_bytes(struct blob *blob, size_t to_write)
 {
    intptr_t ret;
 
+   if (blob->chunk_size) {
+      if (!grow_chunks_to_fit(blob, to_write))
+         return -1;
+
+      ret = blob->size;
+      chunked_set_size(blob, blob->size + to_write);
+      return ret;
+   }
+
    if (! grow_to_fit (blob, to_write))
       return -1;
 
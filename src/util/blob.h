@@ -44,12 +44,29 @@ extern "C" {
  *
  * A blob is efficient in that it dynamically grows by doubling in size, so
  * allocation costs are logarithmic.
+ *
+ * For large serializations, a blob can instead be initialized in chunked mode
+ * with blob_init_chunked. The data is then kept in a list of fixed-size
+ * chunks which never move once allocated, so growing the blob never copies
+ * what has already been written. The chunks can be accessed directly with
+ * blob_get_chunks (or blob_get_iovecs to hand them to writev) and only need to
+ * be flattened into one buffer if the consumer requires it.
  */
 
+/** A segment of a chunked blob. \see blob_get_chunks */
+struct blob_chunk {
+   uint8_t *data;
+
+   /** The number of bytes that have actual data written to them. */
+   size_t size;
+};
+
 struct blob {
    /* The data actually written to the blob. Never read or write this directly
     * when serializing, use blob_reserve_* and blob_overwrite_* instead which
     * check for out_of_memory and handle fixed-size blobs correctly.
+    *
+    * Always NULL for chunked blobs, see \c chunks instead.
     */
    uint8_t *data;
 
@@ -70,6 +87,17 @@ struct blob {
     * allocation blob.
     */
    bool out_of_memory;
+
+   /** Size of each chunk of a chunked blob, or 0 for a contiguous blob.
+    *
+    * \see blob_init_chunked
+    */
+   size_t chunk_size;
+
+   /** The chunks of a chunked blob, only the last one may be partially used. */
+   struct blob_chunk *chunks;
+   unsigned num_chunks;
+   unsigned max_chunks;
 };
 
 /* When done reading, the caller can ensure that everything was consumed by
@@ -107,6 +135,20 @@ blob_init(struct blob *blob);
 void
 blob_init_fixed(struct blob *blob, void *data, size_t size);
 
+/**
+ * Init a new, empty chunked blob.
+ *
+ * Instead of one buffer that is reallocated as the blob grows, a chunked blob
+ * allocates chunks of \chunk_size bytes as needed. Written data may straddle
+ * chunk boundaries, so \c blob->data must never be used with a chunked blob.
+ * Use blob_get_chunks or blob_finish_get_buffer to access the contents.
+ */
+void
+blob_init_chunked(struct blob *blob, size_t chunk_size);
+
+void
+blob_free_chunks(struct blob *blob);
+
 /**
  * Finish a blob and free its memory.
  *
@@ -116,13 +158,52 @@ blob_init_fixed(struct blob *blob, void *data, size_t size);
 static inline void
 blob_finish(struct blob *blob)
 {
+   if (blob->chunks)
+      blob_free_chunks(blob);
    if (!blob->fixed_allocation)
       free(blob->data);
 }
 
+/**
+ * Finish a blob and return its contents as one malloc'ed buffer, which the
+ * caller must free.
+ *
+ * For a chunked blob, this flattens the chunks into a new buffer.
+ */
 void
 blob_finish_get_buffer(struct blob *blob, void **buffer, size_t *size);
 
+/**
+ * Fill \chunks with up to \max_chunks entries describing the contents of
+ * \blob. A contiguous blob is described by a single chunk. The entries stay
+ * valid until the blob is written to or finished.
+ *
+ * \return The number of entries needed, which may be more than \max_chunks.
+ */
+unsigned
+blob_get_chunks(const struct blob *blob, struct blob_chunk *chunks,
+                unsigned max_chunks);
+
+/**
+ * Copy the contents of \blob to \dst, which must be at least \c blob->size
+ * bytes.
+ */
+void
+blob_copy_to(const struct blob *blob, void *dst);
+
+#ifndef _WIN32
+struct iovec;
+
+/**
+ * Fill \iov with up to \max_iov entries describing the contents of \blob, so
+ * they can be written with writev without flattening the blob.
+ *
+ * \return The number of entries needed, which may be more than \max_iov.
+ */
+unsigned
+blob_get_iovecs(const struct blob *blob, struct iovec *iov, unsigned max_iov);
+#endif
+
 /**
  * Aligns the blob to the given alignment.
  *
@@ -36,8 +36,11 @@
 
 #ifdef HAVE_ZSTD
 #include "zstd.h"
+#include "zdict.h"
 #endif
 
+#include <stdlib.h>
+
 #include "util/compress.h"
 #include "util/perf/cpu_trace.h"
 #include "macros.h"
@@ -166,4 +169,164 @@ util_compress_inflate(const uint8_t *in_data, size_t in_data_size,
 #endif
 }
 
+struct util_compress_dict {
+#ifdef HAVE_ZSTD
+   ZSTD_CDict *cdict;
+   ZSTD_DDict *ddict;
+#endif
+   uint32_t id;
+};
+
+/**
+ * Train a compression dictionary from a set of samples that are stored
+ * back to back in \samples. Returns the size of the dictionary written to
+ * \dict_data, or 0 on failure or if dictionaries aren't supported.
+ */
+size_t
+util_compress_dict_train(const void *samples, const size_t *sample_sizes,
+                         unsigned num_samples, void *dict_data,
+                         size_t dict_capacity)
+{
+   MESA_TRACE_FUNC();
+#ifdef HAVE_ZSTD
+   size_t ret = ZDICT_trainFromBuffer(dict_data, dict_capacity, samples,
+                                      sample_sizes, num_samples);
+   if (ZDICT_isError(ret))
+      return 0;
+
+   return ret;
+#else
+   return 0;
+#endif
+}
+
+/**
+ * Create a dictionary object from the data produced by
+ * util_compress_dict_train(). The data isn't referenced after the call.
+ */
+struct util_compress_dict *
+util_compress_dict_create(const void *dict_data, size_t dict_size)
+{
+#ifdef HAVE_ZSTD
+   struct util_compress_dict *dict = calloc(1, sizeof(*dict));
+   if (!dict)
+      return NULL;
+
+   dict->id = ZSTD_getDictID_fromDict(dict_data, dict_size);
+   dict->cdict = ZSTD_createCDict(dict_data, dict_size,
+                                  ZSTD_COMPRESSION_LEVEL);
+   dict->ddict = ZSTD_createDDict(dict_data, dict_size);
+
+   /* Raw content dictionaries don't have an ID, which we rely on to tell
+    * the data compressed with dictionary apart.
+    */
+   if (!dict->id || !dict->cdict || !dict->ddict) {
+      util_compress_dict_destroy(dict);
+      return NULL;
+   }
+
+   return dict;
+#else
+   return NULL;
+#endif
+}
+
+void
+util_compress_dict_destroy(struct util_compress_dict *dict)
+{
+   if (!dict)
+      return;
+
+#ifdef HAVE_ZSTD
+   ZSTD_freeCDict(dict->cdict);
+   ZSTD_freeDDict(dict->ddict);
+#endif
+   free(dict);
+}
+
+uint32_t
+util_compress_dict_id(const struct util_compress_dict *dict)
+{
+   return dict ? dict->id : 0;
+}
+
+/**
+ * Returns ID of the dictionary required to decompress the data, or 0 if the
+ * data was compressed without a dictionary.
+ */
+uint32_t
+util_compress_get_dict_id(const uint8_t *in_data, size_t in_data_size)
+{
+#ifdef HAVE_ZSTD
+   return ZSTD_getDictID_fromFrame(in_data, in_data_size);
+#else
+   return 0;
+#endif
+}
+
+/* Compress data using the dictionary, falls back to the regular
+ * compression if the dictionary is NULL.
+ */
+size_t
+util_compress_deflate_dict(const struct util_compress_dict *dict,
+                           const uint8_t *in_data, size_t in_data_size,
+                           uint8_t *out_data, size_t out_buff_size)
+{
+#ifdef HAVE_ZSTD
+   if (dict) {
+      MESA_TRACE_FUNC();
+
+      ZSTD_CCtx *cctx = ZSTD_createCCtx();
+      if (!cctx)
+         return 0;
+
+      size_t ret = ZSTD_compress_usingCDict(cctx, out_data, out_buff_size,
+                                            in_data, in_data_size,
+                                            dict->cdict);
+      ZSTD_freeCCtx(cctx);
+
+      if (ZSTD_isError(ret))
+         return 0;
+
+      return ret;
+   }
+#endif
+   return util_compress_deflate(in_data, in_data_size, out_data,
+                                out_buff_size);
+}
+
+/* Decompress data using the dictionary, falls back to the regular
+ * decompression if the dictionary is NULL. Fails if the data was
+ * compressed with a different dictionary.
+ */
+bool
+util_compress_inflate_dict(const struct util_compress_dict *dict,
+                           const uint8_t *in_data, size_t in_data_size,
+                           uint8_t *out_data, size_t out_data_size)
+{
+#ifdef HAVE_ZSTD
+   uint32_t dict_id = util_compress_get_dict_id(in_data, in_data_size);
+
+   if (dict_id) {
+      MESA_TRACE_FUNC();
+
+      if (dict_id != util_compress_dict_id(dict))
+         return false;
+
+      ZSTD_DCtx *dctx = ZSTD_createDCtx();
+      if (!dctx)
+         return false;
+
+      size_t ret = ZSTD_decompress_usingDDict(dctx, out_data, out_data_size,
+                                              in_data, in_data_size,
+                                              dict->ddict);
+      ZSTD_freeDCtx(dctx);
+
+      return !ZSTD_isError(ret);
+   }
+#endif
+   return util_compress_inflate(in_data, in_data_size, out_data,
+                                out_data_size);
+}
+
 #endif
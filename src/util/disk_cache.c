@@ -46,6 +46,8 @@
 #include "util/perf/cpu_trace.h"
 #include "util/ralloc.h"
 #include "util/compiler.h"
+#include "util/os_time.h"
+#include "util/u_math.h"
 #include "util/log.h"
 
 #include "disk_cache.h"
@@ -203,6 +205,10 @@ disk_cache_type_create(const char *gpu_name,
    /* Seed our rand function */
    s_rand_xorshift128plus(cache->seed_xorshift128plus, true);
 
+   if (cache->type == DISK_CACHE_DATABASE && !cache->compression_disabled &&
+       debug_get_bool_option("MESA_DISK_CACHE_DATABASE_DICT", false))
+      disk_cache_dict_init(cache);
+
    ralloc_free(local);
 
    return cache;
@@ -321,14 +327,162 @@ disk_cache_create_custom(const char *gpu_name, const char *driver_id,
                                  DISK_CACHE_DATABASE, max_size);
 }
 
+static enum disk_cache_stats_backend
+stats_backend(const struct disk_cache *cache)
+{
+   if (cache->blob_get_cb)
+      return DISK_CACHE_STATS_CALLBACKS;
+
+   switch (cache->type) {
+   case DISK_CACHE_SINGLE_FILE:
+      return DISK_CACHE_STATS_SINGLE_FILE;
+   case DISK_CACHE_DATABASE:
+      return DISK_CACHE_STATS_DATABASE;
+   default:
+      return DISK_CACHE_STATS_MULTI_FILE;
+   }
+}
+
+static uint32_t
+sum_backends(const uint32_t *counters)
+{
+   uint32_t sum = 0;
+   for (unsigned i = 0; i < DISK_CACHE_STATS_NUM_BACKENDS; i++)
+      sum += p_atomic_read_relaxed(&counters[i]);
+   return sum;
+}
+
+static void
+update_stats_counters(struct disk_cache *cache)
+{
+   struct disk_cache_stats *counters = &cache->stats.counters;
+
+   MESA_TRACE_SET_COUNTER("disk_cache_hits", sum_backends(counters->hits));
+   MESA_TRACE_SET_COUNTER("disk_cache_misses", sum_backends(counters->misses));
+   MESA_TRACE_SET_COUNTER("disk_cache_bytes_read",
+                          p_atomic_read_relaxed(&counters->bytes_read));
+   MESA_TRACE_SET_COUNTER("disk_cache_bytes_written",
+                          p_atomic_read_relaxed(&counters->bytes_written));
+}
+
+/* Account a disk_cache_get() or disk_cache_get_batch() call. */
+static void
+record_read(struct disk_cache *cache, unsigned ro_hits, unsigned hits,
+            unsigned misses, uint64_t bytes, int64_t start)
+{
+   struct disk_cache_stats *counters = &cache->stats.counters;
+   uint64_t time_ns = os_time_get_nano() - start;
+   enum disk_cache_stats_backend backend = stats_backend(cache);
+
+   p_atomic_add(&counters->hits[DISK_CACHE_STATS_READ_ONLY_FOZ], ro_hits);
+   p_atomic_add(&counters->hits[backend], hits);
+   p_atomic_add(&counters->misses[backend], misses);
+   p_atomic_add(&counters->bytes_read, bytes);
+   p_atomic_add(&counters->read_time_ns, time_ns);
+
+   unsigned bucket = MIN2(util_logbase2_64(time_ns / 1000) + (time_ns >= 1000),
+                          DISK_CACHE_STATS_LATENCY_BUCKETS - 1);
+   p_atomic_inc(&counters->read_latency[bucket]);
+
+   update_stats_counters(cache);
+}
+
+bool
+disk_cache_get_stats(struct disk_cache *cache, struct disk_cache_stats *stats)
+{
+   if (!cache->stats.enabled)
+      return false;
+
+   const struct disk_cache_stats *counters = &cache->stats.counters;
+   for (unsigned i = 0; i < DISK_CACHE_STATS_NUM_BACKENDS; i++) {
+      stats->hits[i] = p_atomic_read(&counters->hits[i]);
+      stats->misses[i] = p_atomic_read(&counters->misses[i]);
+   }
+   stats->bytes_read = p_atomic_read(&counters->bytes_read);
+   stats->bytes_written = p_atomic_read(&counters->bytes_written);
+   stats->read_time_ns = p_atomic_read(&counters->read_time_ns);
+   stats->lock_wait_ns = 0;
+   stats->evictions = p_atomic_read(&counters->evictions);
+   for (unsigned i = 0; i < DISK_CACHE_STATS_LATENCY_BUCKETS; i++)
+      stats->read_latency[i] = p_atomic_read(&counters->read_latency[i]);
+
+   /* Locking and eviction of the single file and database caches happen in
+    * their own implementations, which keep their own counters.
+    */
+   if (cache->type == DISK_CACHE_SINGLE_FILE) {
+      stats->lock_wait_ns += p_atomic_read(&cache->foz_db.lock_wait_ns);
+   } else if (cache->type == DISK_CACHE_DATABASE && cache->cache_db.parts) {
+      for (unsigned i = 0; i < cache->cache_db.num_parts; i++) {
+         struct mesa_cache_db *part = cache->cache_db.parts[i];
+         if (part) {
+            stats->lock_wait_ns += p_atomic_read(&part->lock_wait_ns);
+            stats->evictions += p_atomic_read(&part->num_evicted);
+         }
+      }
+   }
+
+   return true;
+}
+
+static void
+print_stats(struct disk_cache *cache)
+{
+   static const char *backend_names[DISK_CACHE_STATS_NUM_BACKENDS] = {
+      [DISK_CACHE_STATS_MULTI_FILE] = "multi file",
+      [DISK_CACHE_STATS_SINGLE_FILE] = "single file",
+      [DISK_CACHE_STATS_DATABASE] = "database",
+      [DISK_CACHE_STATS_READ_ONLY_FOZ] = "read-only foz",
+      [DISK_CACHE_STATS_CALLBACKS] = "callbacks",
+   };
+   struct disk_cache_stats stats;
+   uint32_t reads = 0;
+
+   disk_cache_get_stats(cache, &stats);
+
+   for (unsigned i = 0; i < DISK_CACHE_STATS_LATENCY_BUCKETS; i++)
+      reads += stats.read_latency[i];
+
+   mesa_logi("disk shader cache:  hits = %u, misses = %u\n",
+             sum_backends(stats.hits), sum_backends(stats.misses));
+
+   for (unsigned i = 0; i < DISK_CACHE_STATS_NUM_BACKENDS; i++) {
+      if (stats.hits[i] || stats.misses[i]) {
+         mesa_logi("disk shader cache:    %s: hits = %u, misses = %u\n",
+                   backend_names[i], stats.hits[i], stats.misses[i]);
+      }
+   }
+
+   mesa_logi("disk shader cache:  read = %" PRIu64 " bytes, "
+             "written = %" PRIu64 " bytes, evictions = %u, "
+             "lock wait = %" PRIu64 " us\n",
+             stats.bytes_read, stats.bytes_written, stats.evictions,
+             stats.lock_wait_ns / 1000);
+
+   if (!reads)
+      return;
+
+   mesa_logi("disk shader cache:  average read latency = %" PRIu64 " us\n",
+             stats.read_time_ns / reads / 1000);
+
+   for (unsigned i = 0; i < DISK_CACHE_STATS_LATENCY_BUCKETS; i++) {
+      if (!stats.read_latency[i])
+         continue;
+
+      if (i == DISK_CACHE_STATS_LATENCY_BUCKETS - 1) {
+         mesa_logi("disk shader cache:    >= %u us: %u\n",
+                   1u << (i - 1), stats.read_latency[i]);
+      } else {
+         mesa_logi("disk shader cache:    < %u us: %u\n",
+                   1u << i, stats.read_latency[i]);
+      }
+   }
+}
+
 void
 disk_cache_destroy(struct disk_cache *cache)
 {
-   if (unlikely(cache && cache->stats.enabled)) {
-      mesa_logi("disk shader cache:  hits = %u, misses = %u\n",
-                cache->stats.hits,
-                cache->stats.misses);
-   }
+   if (unlikely(cache && cache->stats.enabled))
+      print_stats(cache);
 
    if (cache && util_queue_is_initialized(&cache->cache_queue)) {
       util_queue_finish(&cache->cache_queue);
@@ -344,6 +498,8 @@ disk_cache_destroy(struct disk_cache *cache)
          mesa_cache_db_multipart_close(&cache->cache_db);
 
       disk_cache_destroy_mmap(cache);
+
+      disk_cache_dict_destroy(cache);
    }
 
    ralloc_free(cache);
@@ -452,6 +608,11 @@ cache_put(void *job, void *gdata, int thread_index)
    char *filename = NULL;
    struct disk_cache_put_job *dc_job = (struct disk_cache_put_job *) job;
 
+   if (unlikely(dc_job->cache->stats.enabled)) {
+      p_atomic_add(&dc_job->cache->stats.counters.bytes_written, dc_job->size);
+      update_stats_counters(dc_job->cache);
+   }
+
    if (dc_job->cache->blob_put_cb) {
       blob_put_compressed(dc_job->cache, dc_job->key, dc_job->data, dc_job->size);
    } else if (dc_job->cache->type == DISK_CACHE_SINGLE_FILE) {
@@ -470,6 +631,9 @@ cache_put(void *job, void *gdata, int thread_index)
          i++;
       }
 
+      if (unlikely(dc_job->cache->stats.enabled))
+         p_atomic_add(&dc_job->cache->stats.counters.evictions, i);
+
       disk_cache_write_item_to_disk(dc_job, filename);
 
 done:
@@ -598,39 +762,123 @@ disk_cache_put_nocopy(struct disk_cache *cache, const cache_key key,
    }
 }
 
+static void *
+cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
+{
+   void *buf = NULL;
+
+   if (cache->blob_get_cb) {
+      buf = blob_get_compressed(cache, key, size);
+   } else if (cache->type == DISK_CACHE_SINGLE_FILE) {
+      buf = disk_cache_load_item_foz(cache, key, size);
+   } else if (cache->type == DISK_CACHE_DATABASE) {
+      buf = disk_cache_db_load_item(cache, key, size);
+   } else if (cache->type == DISK_CACHE_MULTI_FILE) {
+      char *filename = disk_cache_get_cache_filename(cache, key);
+      if (filename)
+         buf = disk_cache_load_item(cache, filename, size);
+   }
+
+   return buf;
+}
+
 void *
 disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
 {
    void *buf = NULL;
+   bool ro_hit = false;
+   int64_t start = 0;
+   size_t buf_size = 0;
+
+   if (unlikely(cache->stats.enabled))
+      start = os_time_get_nano();
+
+   if (cache->foz_ro_cache) {
+      buf = disk_cache_load_item_foz(cache->foz_ro_cache, key, &buf_size);
+      ro_hit = buf != NULL;
+   }
+
+   if (!buf)
+      buf = cache_get(cache, key, &buf_size);
 
    if (size)
-      *size = 0;
+      *size = buf_size;
 
-   if (cache->foz_ro_cache)
-      buf = disk_cache_load_item_foz(cache->foz_ro_cache, key, size);
+   if (unlikely(cache->stats.enabled))
+      record_read(cache, ro_hit, buf && !ro_hit, !buf, buf_size, start);
 
-   if (!buf) {
-      if (cache->blob_get_cb) {
-         buf = blob_get_compressed(cache, key, size);
+   return buf;
+}
+
+unsigned
+disk_cache_get_batch(struct disk_cache *cache, unsigned num_keys,
+                     const cache_key *keys, void **data, size_t *sizes)
+{
+   unsigned num_found = 0, num_ro_found = 0;
+   int64_t start = 0;
+
+   if (unlikely(cache->stats.enabled))
+      start = os_time_get_nano();
+
+   for (unsigned i = 0; i < num_keys; i++) {
+      data[i] = NULL;
+      sizes[i] = 0;
+   }
+
+   if (cache->foz_ro_cache) {
+      num_ro_found = disk_cache_load_items_foz(cache->foz_ro_cache, num_keys,
+                                               keys, data, sizes);
+      num_found += num_ro_found;
+   }
+
+   if (num_found < num_keys) {
+      if (cache->blob_get_cb || cache->type == DISK_CACHE_MULTI_FILE) {
+         /* Nothing to gain from batching, every item is a separate blob */
+         for (unsigned i = 0; i < num_keys; i++) {
+            if (data[i])
+               continue;
+
+            data[i] = cache_get(cache, keys[i], &sizes[i]);
+            if (data[i])
+               num_found++;
+         }
       } else if (cache->type == DISK_CACHE_SINGLE_FILE) {
-         buf = disk_cache_load_item_foz(cache, key, size);
+         num_found += disk_cache_load_items_foz(cache, num_keys, keys,
+                                                data, sizes);
       } else if (cache->type == DISK_CACHE_DATABASE) {
-         buf = disk_cache_db_load_item(cache, key, size);
-      } else if (cache->type == DISK_CACHE_MULTI_FILE) {
-         char *filename = disk_cache_get_cache_filename(cache, key);
-         if (filename)
-            buf = disk_cache_load_item(cache, filename, size);
+         num_found += disk_cache_db_load_items(cache, num_keys, keys,
+                                               data, sizes);
       }
    }
 
    if (unlikely(cache->stats.enabled)) {
-      if (buf)
-         p_atomic_inc(&cache->stats.hits);
-      else
-         p_atomic_inc(&cache->stats.misses);
+      uint64_t bytes = 0;
+      for (unsigned i = 0; i < num_keys; i++)
+         bytes += sizes[i];
+
+      record_read(cache, num_ro_found, num_found - num_ro_found,
+                  num_keys - num_found, bytes, start);
    }
 
-   return buf;
+   return num_found;
+}
+
+void
+disk_cache_prefetch(struct disk_cache *cache, unsigned num_keys,
+                    const cache_key *keys)
+{
+   if (cache->foz_ro_cache)
+      disk_cache_prefetch_items_foz(cache->foz_ro_cache, num_keys, keys);
+
+   if (cache->blob_get_cb)
+      return;
+
+   if (cache->type == DISK_CACHE_SINGLE_FILE)
+      disk_cache_prefetch_items_foz(cache, num_keys, keys);
+   else if (cache->type == DISK_CACHE_DATABASE)
+      disk_cache_db_prefetch_items(cache, num_keys, keys);
+   else if (cache->type == DISK_CACHE_MULTI_FILE)
+      disk_cache_prefetch_items(cache, num_keys, keys);
 }
 
 void
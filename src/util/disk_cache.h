@@ -79,6 +79,43 @@ struct cache_item_metadata {
 
 struct disk_cache;
 
+/* The storage an item was found in, or looked up from for misses. */
+enum disk_cache_stats_backend {
+   DISK_CACHE_STATS_MULTI_FILE,
+   DISK_CACHE_STATS_SINGLE_FILE,
+   DISK_CACHE_STATS_DATABASE,
+   DISK_CACHE_STATS_READ_ONLY_FOZ,
+   DISK_CACHE_STATS_CALLBACKS,
+   DISK_CACHE_STATS_NUM_BACKENDS,
+};
+
+/* Number of buckets of the read latency histogram. */
+#define DISK_CACHE_STATS_LATENCY_BUCKETS 16
+
+/* Statistics collected when MESA_SHADER_CACHE_SHOW_STATS is enabled. */
+struct disk_cache_stats {
+   uint32_t hits[DISK_CACHE_STATS_NUM_BACKENDS];
+   uint32_t misses[DISK_CACHE_STATS_NUM_BACKENDS];
+
+   /* Uncompressed size of the items read and written */
+   uint64_t bytes_read;
+   uint64_t bytes_written;
+
+   /* Time spent in reads, and in waiting for the file locks of the single
+    * file and database caches.
+    */
+   uint64_t read_time_ns;
+   uint64_t lock_wait_ns;
+
+   /* Number of items evicted to respect the cache size limit */
+   uint32_t evictions;
+
+   /* Bucket i counts the reads that took less than 2^i microseconds, the
+    * last bucket counts all slower reads.
+    */
+   uint32_t read_latency[DISK_CACHE_STATS_LATENCY_BUCKETS];
+};
+
 #ifdef HAVE_DLADDR
 static inline bool
 disk_cache_get_function_timestamp(void *ptr, uint32_t* timestamp)
@@ -234,6 +271,34 @@ disk_cache_put_nocopy(struct disk_cache *cache, const cache_key key,
 void *
 disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size);
 
+/**
+ * Retrieve multiple items previously stored in the cache.
+ *
+ * This is equivalent to calling disk_cache_get() for each of the \keys, but
+ * the lookups are done in one pass with the storage locked once and the
+ * items read in the order of their location on the disk.
+ *
+ * On return \data[i] is set to the malloc'ed item stored under \keys[i]
+ * and \sizes[i] to its size, or \data[i] is set to NULL if the item was
+ * not found.
+ *
+ * \return The number of the items found.
+ */
+unsigned
+disk_cache_get_batch(struct disk_cache *cache, unsigned num_keys,
+                     const cache_key *keys, void **data, size_t *sizes);
+
+/**
+ * Hint that the items stored under \keys will be retrieved soon.
+ *
+ * Asks the OS to start reading the items from the disk in the background,
+ * this doesn't block on I/O. Items written by other processes since the
+ * cache index was last synchronized aren't prefetched.
+ */
+void
+disk_cache_prefetch(struct disk_cache *cache, unsigned num_keys,
+                    const cache_key *keys);
+
 /**
  * Store the name \key within the cache, (without any associated data).
  *
@@ -270,6 +335,14 @@ void
 disk_cache_set_callbacks(struct disk_cache *cache, disk_cache_put_cb put,
                          disk_cache_get_cb get);
 
+/**
+ * Get the statistics of \cache.
+ *
+ * \return false if statistics are not enabled for \cache.
+ */
+bool
+disk_cache_get_stats(struct disk_cache *cache, struct disk_cache_stats *stats);
+
 #else
 
 static inline struct disk_cache *
@@ -317,6 +390,24 @@ disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
    return NULL;
 }
 
+static inline unsigned
+disk_cache_get_batch(struct disk_cache *cache, unsigned num_keys,
+                     const cache_key *keys, void **data, size_t *sizes)
+{
+   for (unsigned i = 0; i < num_keys; i++) {
+      data[i] = NULL;
+      sizes[i] = 0;
+   }
+
+   return 0;
+}
+
+static inline void
+disk_cache_prefetch(struct disk_cache *cache, unsigned num_keys,
+                    const cache_key *keys)
+{
+}
+
 static inline void
 disk_cache_put_key(struct disk_cache *cache, const cache_key key)
 {
@@ -340,6 +431,12 @@ disk_cache_set_callbacks(struct disk_cache *cache, disk_cache_put_cb put,
 {
 }
 
+static inline bool
+disk_cache_get_stats(struct disk_cache *cache, struct disk_cache_stats *stats)
+{
+   return false;
+}
+
 #endif /* ENABLE_SHADER_CACHE */
 
 #ifdef __cplusplus
@@ -100,6 +100,8 @@ disk_cache_get_function_identifier(void *ptr, struct mesa_sha1 *ctx)
 
 #include "util/blob.h"
 #include "util/crc32.h"
+#include "util/os_file.h"
+#include "util/u_atomic.h"
 #include "util/u_debug.h"
 #include "util/ralloc.h"
 #include "util/rand_xor.h"
@@ -547,6 +549,230 @@ disk_cache_evict_item(struct disk_cache *cache, char *filename)
       p_atomic_add(&cache->size->value, - (uint64_t)sb.st_blocks * 512);
 }
 
+/* Only small items are used for training, large items compress well
+ * without a dictionary.
+ */
+#define DICT_MAX_SAMPLE_SIZE (64 * 1024)
+#define DICT_MAX_SAMPLES 4096
+#define DICT_SAMPLES_BUFFER_SIZE (4 * 1024 * 1024)
+#define DICT_MAX_SIZE (64 * 1024)
+
+void
+disk_cache_dict_init(struct disk_cache *cache)
+{
+   unsigned char sha1[SHA1_DIGEST_LENGTH];
+   char sha1_str[SHA1_DIGEST_STRING_LENGTH];
+
+   /* The dictionary is specific to the driver and GPU, the items produced
+    * by different drivers have nothing in common.
+    */
+   _mesa_sha1_compute(cache->driver_keys_blob, cache->driver_keys_blob_size,
+                      sha1);
+   _mesa_sha1_format(sha1_str, sha1);
+
+   cache->dict.path = ralloc_asprintf(cache, "%s/mesa_cache_%s.dict",
+                                      cache->path, sha1_str);
+   if (!cache->dict.path)
+      return;
+
+   simple_mtx_init(&cache->dict.mtx, mtx_plain);
+   cache->dict.enabled = true;
+}
+
+void
+disk_cache_dict_destroy(struct disk_cache *cache)
+{
+   if (!cache->dict.enabled)
+      return;
+
+   util_compress_dict_destroy(cache->dict.dict);
+   free(cache->dict.samples);
+   free(cache->dict.sample_sizes);
+   simple_mtx_destroy(&cache->dict.mtx);
+}
+
+static void
+disk_cache_dict_finish_training_locked(struct disk_cache *cache,
+                                       struct util_compress_dict *dict)
+{
+   free(cache->dict.samples);
+   free(cache->dict.sample_sizes);
+   cache->dict.samples = NULL;
+   cache->dict.sample_sizes = NULL;
+   cache->dict.trained = true;
+
+   if (dict)
+      p_atomic_set(&cache->dict.dict, dict);
+}
+
+static bool
+disk_cache_dict_load_locked(struct disk_cache *cache)
+{
+   size_t size;
+   char *data = os_read_file(cache->dict.path, &size);
+   if (!data)
+      return false;
+
+   struct util_compress_dict *dict = util_compress_dict_create(data, size);
+   free(data);
+
+   if (!dict)
+      return false;
+
+   disk_cache_dict_finish_training_locked(cache, dict);
+
+   return true;
+}
+
+/* Publish the dictionary file. Multiple processes may train the dictionary
+ * at the same time, link() doesn't replace the existing file, hence all of
+ * them end up using the dictionary that was stored first.
+ */
+static bool
+disk_cache_dict_store(struct disk_cache *cache, const void *data, size_t size)
+{
+   char *tmp_path;
+   bool stored = false;
+
+   if (asprintf(&tmp_path, "%s.%u", cache->dict.path, (unsigned)getpid()) == -1)
+      return false;
+
+   int fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+   if (fd == -1)
+      goto out;
+
+   if (write_all(fd, data, size) != -1)
+      stored = link(tmp_path, cache->dict.path) == 0;
+
+   close(fd);
+   unlink(tmp_path);
+
+out:
+   free(tmp_path);
+
+   return stored;
+}
+
+static void
+disk_cache_dict_train_locked(struct disk_cache *cache)
+{
+   struct util_compress_dict *dict = NULL;
+
+   /* Another process could have trained the dictionary in the meantime */
+   if (disk_cache_dict_load_locked(cache))
+      return;
+
+   void *dict_data = malloc(DICT_MAX_SIZE);
+   if (!dict_data)
+      goto out;
+
+   size_t dict_size = util_compress_dict_train(cache->dict.samples,
+                                               cache->dict.sample_sizes,
+                                               cache->dict.num_samples,
+                                               dict_data, DICT_MAX_SIZE);
+   if (dict_size) {
+      if (disk_cache_dict_store(cache, dict_data, dict_size))
+         dict = util_compress_dict_create(dict_data, dict_size);
+      else if (disk_cache_dict_load_locked(cache))
+         goto out;
+   }
+
+   disk_cache_dict_finish_training_locked(cache, dict);
+
+out:
+   free(dict_data);
+}
+
+static void
+disk_cache_dict_add_sample_locked(struct disk_cache *cache,
+                                  const void *data, size_t size)
+{
+   if (size > DICT_MAX_SAMPLE_SIZE)
+      return;
+
+   if (!cache->dict.samples) {
+      cache->dict.samples = malloc(DICT_SAMPLES_BUFFER_SIZE);
+      cache->dict.sample_sizes =
+         malloc(DICT_MAX_SAMPLES * sizeof(*cache->dict.sample_sizes));
+
+      if (!cache->dict.samples || !cache->dict.sample_sizes) {
+         disk_cache_dict_finish_training_locked(cache, NULL);
+         return;
+      }
+   }
+
+   memcpy(cache->dict.samples + cache->dict.samples_size, data, size);
+   cache->dict.sample_sizes[cache->dict.num_samples++] = size;
+   cache->dict.samples_size += size;
+
+   if (cache->dict.num_samples == DICT_MAX_SAMPLES ||
+       cache->dict.samples_size + DICT_MAX_SAMPLE_SIZE > DICT_SAMPLES_BUFFER_SIZE)
+      disk_cache_dict_train_locked(cache);
+}
+
+/* Returns the dictionary to compress a new item with. Until the dictionary
+ * is available the items are collected for training it.
+ */
+static const struct util_compress_dict *
+disk_cache_dict_for_put(struct disk_cache *cache, const void *data,
+                        size_t size)
+{
+   struct util_compress_dict *dict;
+
+   if (!cache->dict.enabled)
+      return NULL;
+
+   dict = p_atomic_read(&cache->dict.dict);
+   if (dict)
+      return dict;
+
+   simple_mtx_lock(&cache->dict.mtx);
+
+   if (!cache->dict.trained) {
+      /* Pick up dictionary trained by another process */
+      if (!cache->dict.num_samples)
+         disk_cache_dict_load_locked(cache);
+
+      if (!cache->dict.trained)
+         disk_cache_dict_add_sample_locked(cache, data, size);
+   }
+
+   dict = cache->dict.dict;
+
+   simple_mtx_unlock(&cache->dict.mtx);
+
+   return dict;
+}
+
+/* Returns the dictionary that is required to decompress the item */
+static const struct util_compress_dict *
+disk_cache_dict_for_item(struct disk_cache *cache, const uint8_t *data,
+                         size_t size)
+{
+   struct util_compress_dict *dict;
+
+   if (!cache->dict.enabled || !util_compress_get_dict_id(data, size))
+      return NULL;
+
+   dict = p_atomic_read(&cache->dict.dict);
+   if (dict)
+      return dict;
+
+   /* The item was compressed with the dictionary trained by another process,
+    * which stores the dictionary before writing out any items using it.
+    */
+   simple_mtx_lock(&cache->dict.mtx);
+
+   if (!cache->dict.dict)
+      disk_cache_dict_load_locked(cache);
+
+   dict = cache->dict.dict;
+
+   simple_mtx_unlock(&cache->dict.mtx);
+
+   return dict;
+}
+
 static void *
 parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
                               size_t cache_item_size, size_t *size)
@@ -613,8 +839,12 @@ parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
 
       memcpy(uncompressed_data, data, cache_data_size);
    } else {
-      if (!util_compress_inflate(data, cache_data_size, uncompressed_data,
-                                 cf_data->uncompressed_size))
+      const struct util_compress_dict *dict =
+         disk_cache_dict_for_item(cache, data, cache_data_size);
+
+      if (!util_compress_inflate_dict(dict, data, cache_data_size,
+                                      uncompressed_data,
+                                      cf_data->uncompressed_size))
          goto fail;
    }
 
@@ -629,6 +859,55 @@ parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
    return NULL;
 }
 
+/* Parse the raw cache items returned by a batched read and free them.
+ * The entries which data pointer is already set are skipped.
+ */
+static unsigned
+parse_and_validate_cache_items(struct disk_cache *cache, unsigned num_keys,
+                               void **items, size_t *item_sizes,
+                               void **data, size_t *sizes)
+{
+   unsigned num_loaded = 0;
+
+   for (unsigned i = 0; i < num_keys; i++) {
+      if (data[i] || !items[i])
+         continue;
+
+      data[i] = parse_and_validate_cache_item(cache, items[i], item_sizes[i],
+                                              &sizes[i]);
+      free(items[i]);
+
+      if (data[i])
+         num_loaded++;
+   }
+
+   return num_loaded;
+}
+
+void
+disk_cache_prefetch_items(struct disk_cache *cache, unsigned num_keys,
+                          const cache_key *keys)
+{
+#ifdef HAVE_POSIX_FADVISE
+   for (unsigned i = 0; i < num_keys; i++) {
+      char *filename = disk_cache_get_cache_filename(cache, keys[i]);
+      if (!filename)
+         continue;
+
+      int fd = open(filename, O_RDONLY | O_CLOEXEC);
+      if (fd != -1) {
+         posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+         close(fd);
+      }
+
+      free(filename);
+   }
+#endif
+}
+
+/* Cache items at least this big are mapped instead of read. */
+#define DISK_CACHE_MMAP_MIN_SIZE (16 * 1024)
+
 void *
 disk_cache_load_item(struct disk_cache *cache, char *filename, size_t *size)
 {
@@ -642,6 +921,23 @@ disk_cache_load_item(struct disk_cache *cache, char *filename, size_t *size)
    if (fstat(fd, &sb) == -1)
       goto fail;
 
+   /* Map large items instead of reading them, so processes loading the same
+    * shaders share the page cache pages and skip a copy. Cache files are
+    * written to a temporary file and renamed, and eviction only unlinks them,
+    * so the mapping can't be truncated under us.
+    */
+   if (sb.st_size >= DISK_CACHE_MMAP_MIN_SIZE) {
+      void *map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (map != MAP_FAILED) {
+         uint8_t *uncompressed_data =
+            parse_and_validate_cache_item(cache, map, sb.st_size, size);
+         munmap(map, sb.st_size);
+         free(filename);
+         close(fd);
+         return uncompressed_data;
+      }
+   }
+
    data = malloc(sb.st_size);
    if (data == NULL)
       goto fail;
@@ -709,9 +1005,12 @@ create_cache_item_header_and_blob(struct disk_cache_put_job *dc_job,
       compressed_data = malloc(max_buf);
       if (compressed_data == NULL)
          return false;
+      const struct util_compress_dict *dict =
+         disk_cache_dict_for_put(dc_job->cache, dc_job->data, dc_job->size);
+
       compressed_size =
-         util_compress_deflate(dc_job->data, dc_job->size,
-                              compressed_data, max_buf);
+         util_compress_deflate_dict(dict, dc_job->data, dc_job->size,
+                                    compressed_data, max_buf);
       if (compressed_size == 0)
          goto fail;
    }
@@ -1055,6 +1354,39 @@ disk_cache_load_item_foz(struct disk_cache *cache, const cache_key key,
    return uncompressed_data;
 }
 
+unsigned
+disk_cache_load_items_foz(struct disk_cache *cache, unsigned num_keys,
+                          const cache_key *keys, void **data, size_t *sizes)
+{
+   void **items = malloc(num_keys * sizeof(*items));
+   size_t *item_sizes = malloc(num_keys * sizeof(*item_sizes));
+   unsigned num_loaded = 0;
+
+   if (!items || !item_sizes)
+      goto out;
+
+   /* Entries found by a previous lookup are skipped by the FOZ DB */
+   memcpy(items, data, num_keys * sizeof(*items));
+
+   if (foz_read_entries(&cache->foz_db, num_keys, (const uint8_t *)keys,
+                        items, item_sizes))
+      num_loaded = parse_and_validate_cache_items(cache, num_keys, items,
+                                                  item_sizes, data, sizes);
+
+out:
+   free(item_sizes);
+   free(items);
+
+   return num_loaded;
+}
+
+void
+disk_cache_prefetch_items_foz(struct disk_cache *cache, unsigned num_keys,
+                              const cache_key *keys)
+{
+   foz_prefetch_entries(&cache->foz_db, num_keys, (const uint8_t *)keys);
+}
+
 bool
 disk_cache_write_item_to_disk_foz(struct disk_cache_put_job *dc_job)
 {
@@ -1200,6 +1532,41 @@ disk_cache_db_load_item(struct disk_cache *cache, const cache_key key,
    return uncompressed_data;
 }
 
+unsigned
+disk_cache_db_load_items(struct disk_cache *cache, unsigned num_keys,
+                         const cache_key *keys, void **data, size_t *sizes)
+{
+   void **items = malloc(num_keys * sizeof(*items));
+   size_t *item_sizes = malloc(num_keys * sizeof(*item_sizes));
+   unsigned num_loaded = 0;
+
+   if (!items || !item_sizes)
+      goto out;
+
+   /* Entries found by a previous lookup are skipped by the DB */
+   memcpy(items, data, num_keys * sizeof(*items));
+
+   if (mesa_cache_db_multipart_read_entries(&cache->cache_db, num_keys,
+                                            (const uint8_t *)keys,
+                                            items, item_sizes))
+      num_loaded = parse_and_validate_cache_items(cache, num_keys, items,
+                                                  item_sizes, data, sizes);
+
+out:
+   free(item_sizes);
+   free(items);
+
+   return num_loaded;
+}
+
+void
+disk_cache_db_prefetch_items(struct disk_cache *cache, unsigned num_keys,
+                             const cache_key *keys)
+{
+   mesa_cache_db_multipart_prefetch_entries(&cache->cache_db, num_keys,
+                                            (const uint8_t *)keys);
+}
+
 bool
 disk_cache_db_write_item_to_disk(struct disk_cache_put_job *dc_job)
 {
@@ -99,12 +99,28 @@ struct disk_cache {
 
    struct {
       bool enabled;
-      unsigned hits;
-      unsigned misses;
+      struct disk_cache_stats counters;
    } stats;
 
    /* Internal RO FOZ cache for combined use of RO and RW caches. */
    struct disk_cache *foz_ro_cache;
+
+   /* Shared compression dictionary, trained from the first items put into
+    * the cache and stored next to the cache DB files.
+    */
+   struct {
+      bool enabled;
+      bool trained;
+      char *path;
+      simple_mtx_t mtx;
+      struct util_compress_dict *dict;
+
+      /* Training samples stored back to back */
+      uint8_t *samples;
+      size_t *sample_sizes;
+      size_t samples_size;
+      unsigned num_samples;
+   } dict;
 };
 
 struct cache_entry_file_data {
@@ -145,9 +161,21 @@ void *
 disk_cache_load_item_foz(struct disk_cache *cache, const cache_key key,
                          size_t *size);
 
+unsigned
+disk_cache_load_items_foz(struct disk_cache *cache, unsigned num_keys,
+                          const cache_key *keys, void **data, size_t *sizes);
+
+void
+disk_cache_prefetch_items_foz(struct disk_cache *cache, unsigned num_keys,
+                              const cache_key *keys);
+
 void *
 disk_cache_load_item(struct disk_cache *cache, char *filename, size_t *size);
 
+void
+disk_cache_prefetch_items(struct disk_cache *cache, unsigned num_keys,
+                          const cache_key *keys);
+
 char *
 disk_cache_get_cache_filename(struct disk_cache *cache, const cache_key key);
 
@@ -177,6 +205,14 @@ void *
 disk_cache_db_load_item(struct disk_cache *cache, const cache_key key,
                         size_t *size);
 
+unsigned
+disk_cache_db_load_items(struct disk_cache *cache, unsigned num_keys,
+                         const cache_key *keys, void **data, size_t *sizes);
+
+void
+disk_cache_db_prefetch_items(struct disk_cache *cache, unsigned num_keys,
+                             const cache_key *keys);
+
 bool
 disk_cache_db_write_item_to_disk(struct disk_cache_put_job *dc_job);
 
@@ -186,6 +222,12 @@ disk_cache_db_load_cache_index(void *mem_ctx, struct disk_cache *cache);
 void
 disk_cache_delete_old_cache(void);
 
+void
+disk_cache_dict_init(struct disk_cache *cache);
+
+void
+disk_cache_dict_destroy(struct disk_cache *cache);
+
 #ifdef __cplusplus
 }
 #endif
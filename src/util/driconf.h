@@ -231,6 +231,10 @@
    DRI_CONF_OPT_B(force_glsl_abs_sqrt, def,                             \
                   "Force computing the absolute value for sqrt() and inversesqrt()")
 
+#define DRI_CONF_GLSL_ES_SKIP_IR_OPTIMIZATIONS(def) \
+   DRI_CONF_OPT_B(glsl_es_skip_ir_optimizations, def, \
+                  "Skip the compile-time GLSL IR optimizations for GLSL ES shaders and leave them to NIR")
+
 #define DRI_CONF_GLSL_CORRECT_DERIVATIVES_AFTER_DISCARD(def) \
    DRI_CONF_OPT_B(glsl_correct_derivatives_after_discard, def, \
                   "Implicit and explicit derivatives after a discard behave as if the discard didn't happen")
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/format/u_format.h"
+
+#if defined(USE_SSE41) && !defined(NO_FORMAT_ASM)
+
+#include <smmintrin.h>
+#include "u_format_pack.h"
+#include "util/u_cpu_detect.h"
+
+/* Converts four RGBA8 pixels to floats, each channel divided by 255 exactly
+ * like ubyte_to_float() does.
+ */
+static inline void
+unpack_4x_rgba_8unorm_float(float *restrict dst, __m128i pixels)
+{
+   const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+   for (unsigned i = 0; i < 4; i++) {
+      __m128i channels = _mm_cvtepu8_epi32(pixels);
+      _mm_storeu_ps(dst + i * 4, _mm_mul_ps(_mm_cvtepi32_ps(channels), scale));
+      pixels = _mm_srli_si128(pixels, 4);
+   }
+}
+
+static inline __m128i
+swap_rb_4x(__m128i pixels)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7,
+                                         10, 9, 8, 11, 14, 13, 12, 15);
+
+   return _mm_shuffle_epi8(pixels, shuffle);
+}
+
+static void
+util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_sse41(uint8_t *restrict dst, const uint8_t *restrict src, unsigned width)
+{
+   while (width >= 4) {
+      __m128i pixels = _mm_loadu_si128((const __m128i *)src);
+      _mm_storeu_si128((__m128i *)dst, swap_rb_4x(pixels));
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_b8g8r8a8_unorm_unpack_rgba_8unorm(dst, src, width);
+}
+
+static void
+util_format_b8g8r8a8_unorm_unpack_rgba_float_sse41(void *restrict dst_row, const uint8_t *restrict src, unsigned width)
+{
+   float *dst = dst_row;
+
+   while (width >= 4) {
+      __m128i pixels = _mm_loadu_si128((const __m128i *)src);
+      unpack_4x_rgba_8unorm_float(dst, swap_rb_4x(pixels));
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_b8g8r8a8_unorm_unpack_rgba_float(dst, src, width);
+}
+
+static void
+util_format_r8g8b8a8_unorm_unpack_rgba_float_sse41(void *restrict dst_row, const uint8_t *restrict src, unsigned width)
+{
+   float *dst = dst_row;
+
+   while (width >= 4) {
+      __m128i pixels = _mm_loadu_si128((const __m128i *)src);
+      unpack_4x_rgba_8unorm_float(dst, pixels);
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_r8g8b8a8_unorm_unpack_rgba_float(dst, src, width);
+}
+
+static void
+util_format_r10g10b10a2_unorm_unpack_rgba_float_sse41(void *restrict dst_row, const uint8_t *restrict src, unsigned width)
+{
+   const __m128i mask = _mm_set1_epi32(0x3ff);
+   const __m128 scale_rgb = _mm_set1_ps(1.0f / 0x3ff);
+   const __m128 scale_a = _mm_set1_ps(1.0f / 0x3);
+   float *dst = dst_row;
+
+   while (width >= 4) {
+      __m128i pixels = _mm_loadu_si128((const __m128i *)src);
+      __m128 r = _mm_cvtepi32_ps(_mm_and_si128(pixels, mask));
+      __m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 10), mask));
+      __m128 b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 20), mask));
+      __m128 a = _mm_cvtepi32_ps(_mm_srli_epi32(pixels, 30));
+
+      r = _mm_mul_ps(r, scale_rgb);
+      g = _mm_mul_ps(g, scale_rgb);
+      b = _mm_mul_ps(b, scale_rgb);
+      a = _mm_mul_ps(a, scale_a);
+      _MM_TRANSPOSE4_PS(r, g, b, a);
+
+      _mm_storeu_ps(dst + 0, r);
+      _mm_storeu_ps(dst + 4, g);
+      _mm_storeu_ps(dst + 8, b);
+      _mm_storeu_ps(dst + 12, a);
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_r10g10b10a2_unorm_unpack_rgba_float(dst, src, width);
+}
+
+static const struct util_format_unpack_description util_format_unpack_descriptions_sse41[] = {
+   [PIPE_FORMAT_B8G8R8A8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_sse41,
+      .unpack_rgba = &util_format_b8g8r8a8_unorm_unpack_rgba_float_sse41,
+   },
+   [PIPE_FORMAT_R8G8B8A8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_r8g8b8a8_unorm_unpack_rgba_8unorm,
+      .unpack_rgba = &util_format_r8g8b8a8_unorm_unpack_rgba_float_sse41,
+   },
+   [PIPE_FORMAT_R10G10B10A2_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_r10g10b10a2_unorm_unpack_rgba_8unorm,
+      .unpack_rgba = &util_format_r10g10b10a2_unorm_unpack_rgba_float_sse41,
+   },
+};
+
+const struct util_format_unpack_description *
+util_format_unpack_description_sse41(enum pipe_format format)
+{
+   if (!util_get_cpu_caps()->has_ssse3 || !util_get_cpu_caps()->has_sse4_1)
+      return NULL;
+
+   if (format >= ARRAY_SIZE(util_format_unpack_descriptions_sse41))
+      return NULL;
+
+   if (!util_format_unpack_descriptions_sse41[format].unpack_rgba)
+      return NULL;
+
+   return &util_format_unpack_descriptions_sse41[format];
+}
+
+#endif /* USE_SSE41 */
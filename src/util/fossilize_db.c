@@ -33,10 +33,13 @@
 #ifdef FOZ_DB_UTIL
 
 #include <assert.h>
+#include <fcntl.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -45,6 +48,8 @@
 #include <sys/inotify.h>
 #endif
 
+#include "util/os_time.h"
+#include "util/u_atomic.h"
 #include "util/u_debug.h"
 
 #include "crc32.h"
@@ -61,6 +66,46 @@ static const uint8_t stream_reference_magic_and_version[FOZ_REF_MAGIC_SIZE] = {
    0, 0, 0, FOSSILIZE_FORMAT_VERSION, /* 4 bytes to use for versioning. */
 };
 
+/* An index entry always carries the 64bit offset of its payload, see
+ * append_foz_entry().
+ */
+static const struct foz_payload_header foz_index_payload_header = {
+   .payload_size = sizeof(uint64_t),
+   .format = FOSSILIZE_COMPRESSION_NONE,
+   .crc = 0,
+   .uncompressed_size = sizeof(uint64_t),
+};
+
+/* The sorted index (<name>_sidx.foz) is a Mesa specific sidecar of the index
+ * of a read only db. It holds the same entries sorted by hash in a layout that
+ * can be mapped and binary searched as is, so loading a large db doesn't
+ * require parsing its whole index into the hash table. It is only used while
+ * the index has the exact size it was generated from.
+ */
+static const uint8_t sorted_index_magic_and_version[FOZ_REF_MAGIC_SIZE] = {
+   0x81, 'M', 'E', 'S',
+   'A', 'F', 'O', 'Z',
+   'S', 'I', 'D', 'X',
+   0, 0, 0, 1,
+};
+
+struct foz_sorted_index_header {
+   uint8_t magic[FOZ_REF_MAGIC_SIZE];
+   uint64_t idx_size;
+   uint32_t num_entries;
+   uint32_t entry_size;
+};
+
+/* Only the part of the cache key stored in the db names is compared */
+#define FOZ_SORTED_INDEX_KEY_SIZE (FOSSILIZE_BLOB_HASH_LENGTH / 2)
+
+struct foz_sorted_index_entry {
+   uint64_t hash;
+   uint64_t offset;
+   uint8_t key[FOZ_SORTED_INDEX_KEY_SIZE];
+   uint32_t pad;
+};
+
 /* Mesa uses 160bit hashes to identify cache entries, a hash of this size
  * makes collisions virtually impossible for our use case. However the foz db
  * format uses a 64bit hash table to lookup file offsets for reading cache
@@ -113,6 +158,94 @@ create_foz_db_filenames(const char *cache_path,
    return true;
 }
 
+static bool
+create_foz_sorted_idx_filename(const char *cache_path, const char *name,
+                               char **sorted_idx_filename)
+{
+   return asprintf(sorted_idx_filename, "%s/%s_sidx.foz", cache_path,
+                   name) != -1;
+}
+
+static bool
+read_foz_magic(FILE *f)
+{
+   uint8_t magic[FOZ_REF_MAGIC_SIZE];
+   if (fread(magic, 1, FOZ_REF_MAGIC_SIZE, f) != FOZ_REF_MAGIC_SIZE)
+      return false;
+
+   if (memcmp(magic, stream_reference_magic_and_version,
+              FOZ_REF_MAGIC_SIZE - 1))
+      return false;
+
+   int version = magic[FOZ_REF_MAGIC_SIZE - 1];
+   if (version > FOSSILIZE_FORMAT_VERSION ||
+       version < FOSSILIZE_FORMAT_MIN_COMPAT_VERSION)
+      return false;
+
+   return true;
+}
+
+/* Reads the index entry at *offset, which must be the current position of
+ * db_idx. On success *offset is moved past the entry, false is returned at the
+ * end of the index or for a truncated entry.
+ */
+static bool
+read_foz_index_entry(FILE *db_idx, uint64_t *offset, uint64_t len,
+                     struct foz_db_entry *entry, uint64_t *hash)
+{
+   char bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH + sizeof(struct foz_payload_header)];
+   struct foz_payload_header *header;
+   uint64_t entry_offset = *offset;
+
+   /* Corrupt entry. Our process might have been killed before we
+    * could write all data.
+    */
+   if (entry_offset + sizeof(bytes_to_read) > len)
+      return false;
+
+   /* NAME + HEADER in one read */
+   if (fread(bytes_to_read, 1, sizeof(bytes_to_read), db_idx) !=
+       sizeof(bytes_to_read))
+      return false;
+
+   entry_offset += sizeof(bytes_to_read);
+   header = (struct foz_payload_header*)&bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH];
+
+   /* Corrupt entry. Our process might have been killed before we
+    * could write all data.
+    */
+   if (entry_offset + header->payload_size > len ||
+       header->payload_size != sizeof(uint64_t))
+      return false;
+
+   static_assert(FOSSILIZE_BLOB_HASH_LENGTH <= SHA1_DIGEST_STRING_LENGTH, "");
+   char hash_str[SHA1_DIGEST_STRING_LENGTH] = {0};
+   memcpy(hash_str, bytes_to_read, FOSSILIZE_BLOB_HASH_LENGTH);
+   /* Fill the rest of the key string with zeros. */
+   memset(hash_str + FOSSILIZE_BLOB_HASH_LENGTH, '0',
+          SHA1_DIGEST_STRING_LENGTH - 1 - FOSSILIZE_BLOB_HASH_LENGTH);
+
+   /* read cache item offset from index file */
+   uint64_t cache_offset;
+   if (fread(&cache_offset, 1, sizeof(cache_offset), db_idx) !=
+       sizeof(cache_offset))
+      return false;
+
+   *offset = entry_offset + header->payload_size;
+
+   entry->header = *header;
+   _mesa_sha1_hex_to_sha1(entry->key, hash_str);
+
+   /* Truncate the entry's hash string to a 64bit hash for use with a
+    * 64bit hash table for looking up file offsets.
+    */
+   hash_str[16] = '\0';
+   *hash = strtoull(hash_str, NULL, 16);
+
+   entry->offset = cache_offset;
+
+   return true;
+}
 
 /* This looks at stuff that was added to the index since the last time we looked at it. This is safe
  * to do without locking the file as we assume the file is append only */
@@ -122,72 +255,180 @@ update_foz_index(struct foz_db *foz_db, FILE *db_idx, unsigned file_idx)
    uint64_t offset = ftell(db_idx);
    fseek(db_idx, 0, SEEK_END);
    uint64_t len = ftell(db_idx);
-   uint64_t parsed_offset = offset;
 
    if (offset == len)
       return;
 
    fseek(db_idx, offset, SEEK_SET);
    while (offset < len) {
-      char bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH + sizeof(struct foz_payload_header)];
-      struct foz_payload_header *header;
+      struct foz_db_entry tmp;
+      uint64_t key;
 
-      /* Corrupt entry. Our process might have been killed before we
-       * could write all data.
-       */
-      if (offset + sizeof(bytes_to_read) > len)
+      if (!read_foz_index_entry(db_idx, &offset, len, &tmp, &key))
          break;
 
-      /* NAME + HEADER in one read */
-      if (fread(bytes_to_read, 1, sizeof(bytes_to_read), db_idx) !=
-          sizeof(bytes_to_read))
-         break;
+      struct foz_db_entry *entry = ralloc(foz_db->mem_ctx,
+                                          struct foz_db_entry);
+      *entry = tmp;
+      entry->file_idx = file_idx;
 
-      offset += sizeof(bytes_to_read);
-      header = (struct foz_payload_header*)&bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH];
+      _mesa_hash_table_u64_insert(foz_db->index_db, key, entry);
+   }
 
-      /* Corrupt entry. Our process might have been killed before we
-       * could write all data.
-       */
-      if (offset + header->payload_size > len ||
-          header->payload_size != sizeof(uint64_t))
-         break;
 
-      static_assert(FOSSILIZE_BLOB_HASH_LENGTH <= SHA1_DIGEST_STRING_LENGTH, "");
-      char hash_str[SHA1_DIGEST_STRING_LENGTH] = {0};
-      memcpy(hash_str, bytes_to_read, FOSSILIZE_BLOB_HASH_LENGTH);
-      /* Fill the rest of the key string with zeros. */
-      memset(hash_str + FOSSILIZE_BLOB_HASH_LENGTH, '0',
-             SHA1_DIGEST_STRING_LENGTH - 1 - FOSSILIZE_BLOB_HASH_LENGTH);
-
-      /* read cache item offset from index file */
-      uint64_t cache_offset;
-      if (fread(&cache_offset, 1, sizeof(cache_offset), db_idx) !=
-          sizeof(cache_offset))
+   fseek(db_idx, offset, SEEK_SET);
+}
+
+static int
+foz_sorted_index_entry_cmp(const void *_a, const void *_b)
+{
+   const struct foz_sorted_index_entry *a = _a;
+   const struct foz_sorted_index_entry *b = _b;
+
+   if (a->hash != b->hash)
+      return a->hash > b->hash ? 1 : -1;
+
+   int cmp = memcmp(a->key, b->key, FOZ_SORTED_INDEX_KEY_SIZE);
+   if (cmp)
+      return cmp;
+
+   if (a->offset == b->offset)
+      return 0;
+
+   return a->offset > b->offset ? 1 : -1;
+}
+
+/* Reads all the entries of an index into a malloc'ed array sorted by hash and
+ * key. Only the first entry written for a key is kept, which is the one with
+ * the lowest offset.
+ */
+static bool
+read_sorted_foz_index(FILE *db_idx, uint64_t *idx_size,
+                      struct foz_sorted_index_entry **entries_out,
+                      uint32_t *num_entries_out)
+{
+   struct foz_sorted_index_entry *entries = NULL;
+   uint32_t num_entries = 0, max_entries = 0;
+
+   fseek(db_idx, 0, SEEK_END);
+   uint64_t len = ftell(db_idx);
+   rewind(db_idx);
+
+   if (!read_foz_magic(db_idx))
+      return false;
+
+   uint64_t offset = FOZ_REF_MAGIC_SIZE;
+   while (offset < len) {
+      struct foz_db_entry entry;
+      uint64_t hash;
+
+      if (!read_foz_index_entry(db_idx, &offset, len, &entry, &hash))
          break;
 
-      offset += header->payload_size;
-      parsed_offset = offset;
+      if (num_entries == max_entries) {
+         max_entries = MAX2(max_entries * 2, 64);
+         struct foz_sorted_index_entry *grown =
+            realloc(entries, max_entries * sizeof(*entries));
+         if (!grown) {
+            free(entries);
+            return false;
+         }
+         entries = grown;
+      }
 
-      struct foz_db_entry *entry = ralloc(foz_db->mem_ctx,
-                                          struct foz_db_entry);
-      entry->header = *header;
-      entry->file_idx = file_idx;
-      _mesa_sha1_hex_to_sha1(entry->key, hash_str);
+      struct foz_sorted_index_entry *e = &entries[num_entries++];
+      memset(e, 0, sizeof(*e));
+      e->hash = hash;
+      e->offset = entry.offset;
+      memcpy(e->key, entry.key, FOZ_SORTED_INDEX_KEY_SIZE);
+   }
 
-      /* Truncate the entry's hash string to a 64bit hash for use with a
-       * 64bit hash table for looking up file offsets.
-       */
-      hash_str[16] = '\0';
-      uint64_t key = strtoull(hash_str, NULL, 16);
+   if (num_entries)
+      qsort(entries, num_entries, sizeof(*entries),
+            foz_sorted_index_entry_cmp);
 
-      entry->offset = cache_offset;
+   uint32_t num_unique = 0;
+   for (uint32_t i = 0; i < num_entries; i++) {
+      if (num_unique &&
+          !memcmp(entries[num_unique - 1].key, entries[i].key,
+                  FOZ_SORTED_INDEX_KEY_SIZE))
+         continue;
 
-      _mesa_hash_table_u64_insert(foz_db->index_db, key, entry);
+      entries[num_unique++] = entries[i];
    }
 
+   *idx_size = len;
+   *entries_out = entries;
+   *num_entries_out = num_unique;
+   return true;
+}
 
-   fseek(db_idx, parsed_offset, SEEK_SET);
+/* Maps the sorted index of a read only db if it exists and was generated from
+ * an index of idx_size bytes.
+ */
+static bool
+map_foz_sorted_index(const char *filename, uint64_t idx_size,
+                     struct foz_sorted_index *sorted_idx)
+{
+   int fd = open(filename, O_RDONLY | O_CLOEXEC);
+   if (fd < 0)
+      return false;
+
+   struct stat st;
+   if (fstat(fd, &st) == -1 ||
+       st.st_size < sizeof(struct foz_sorted_index_header)) {
+      close(fd);
+      return false;
+   }
+
+   void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED)
+      return false;
+
+   const struct foz_sorted_index_header *header = map;
+   if (memcmp(header->magic, sorted_index_magic_and_version,
+              FOZ_REF_MAGIC_SIZE) ||
+       header->idx_size != idx_size ||
+       header->entry_size != sizeof(struct foz_sorted_index_entry) ||
+       sizeof(*header) + (uint64_t)header->num_entries * header->entry_size !=
+       st.st_size) {
+      munmap(map, st.st_size);
+      return false;
+   }
+
+   sorted_idx->map = map;
+   sorted_idx->map_size = st.st_size;
+   sorted_idx->entries = (const struct foz_sorted_index_entry *)(header + 1);
+   sorted_idx->num_entries = header->num_entries;
+   return true;
+}
+
+static bool
+foz_sorted_index_lookup(const struct foz_sorted_index *sorted_idx,
+                        const uint8_t *cache_key_160bit, uint64_t hash,
+                        uint64_t *offset)
+{
+   uint32_t lo = 0, hi = sorted_idx->num_entries;
+
+   while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (sorted_idx->entries[mid].hash < hash)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   for (; lo < sorted_idx->num_entries &&
+          sorted_idx->entries[lo].hash == hash; lo++) {
+      if (!memcmp(sorted_idx->entries[lo].key, cache_key_160bit,
+                  FOZ_SORTED_INDEX_KEY_SIZE)) {
+         *offset = sorted_idx->entries[lo].offset;
+         return true;
+      }
+   }
+
+   return false;
 }
 
 /* exclusive flock with timeout. timeout is in nanoseconds */
@@ -208,9 +449,12 @@ static int lock_file_with_timeout(FILE *f, int64_t timeout)
    return err;
 }
 
+/* sorted_idx_filename is only given for read only dbs, the sorted index is
+ * used instead of parsing the index when it is up to date.
+ */
 static bool
 load_foz_dbs(struct foz_db *foz_db, FILE *db_idx, uint8_t file_idx,
-             bool read_only)
+             const char *sorted_idx_filename)
 {
    /* Scan through the archive and get the list of cache entries. */
    fseek(db_idx, 0, SEEK_END);
@@ -232,17 +476,7 @@ load_foz_dbs(struct foz_db *foz_db, FILE *db_idx, uint8_t file_idx,
    }
 
    if (len != 0) {
-      uint8_t magic[FOZ_REF_MAGIC_SIZE];
-      if (fread(magic, 1, FOZ_REF_MAGIC_SIZE, db_idx) != FOZ_REF_MAGIC_SIZE)
-         goto fail;
-
-      if (memcmp(magic, stream_reference_magic_and_version,
-                 FOZ_REF_MAGIC_SIZE - 1))
-         goto fail;
-
-      int version = magic[FOZ_REF_MAGIC_SIZE - 1];
-      if (version > FOSSILIZE_FORMAT_VERSION ||
-          version < FOSSILIZE_FORMAT_MIN_COMPAT_VERSION)
+      if (!read_foz_magic(db_idx))
          goto fail;
 
    } else {
@@ -263,15 +497,25 @@ load_foz_dbs(struct foz_db *foz_db, FILE *db_idx, uint8_t file_idx,
 
    flock(fileno(foz_db->file[file_idx]), LOCK_UN);
 
+   struct foz_sorted_index sorted_idx = {0};
+   bool sorted = sorted_idx_filename &&
+                 map_foz_sorted_index(sorted_idx_filename, len, &sorted_idx);
+
    if (foz_db->updater.thrd) {
    /* If MESA_DISK_CACHE_READ_ONLY_FOZ_DBS_DYNAMIC_LIST is enabled, access to
     * the foz_db hash table requires locking to prevent racing between this
     * updated thread loading DBs at runtime and cache entry read/writes. */
       simple_mtx_lock(&foz_db->mtx);
-      update_foz_index(foz_db, db_idx, file_idx);
+      if (sorted)
+         foz_db->sorted_idx[file_idx] = sorted_idx;
+      else
+         update_foz_index(foz_db, db_idx, file_idx);
       simple_mtx_unlock(&foz_db->mtx);
    } else {
-      update_foz_index(foz_db, db_idx, file_idx);
+      if (sorted)
+         foz_db->sorted_idx[file_idx] = sorted_idx;
+      else
+         update_foz_index(foz_db, db_idx, file_idx);
    }
 
    foz_db->alive = true;
@@ -288,6 +532,7 @@ load_foz_dbs_ro(struct foz_db *foz_db, const char *foz_dbs_ro)
    uint8_t file_idx = 1;
    char *filename = NULL;
    char *idx_filename = NULL;
+   char *sorted_idx_filename = NULL;
 
    for (unsigned n; n = strcspn(foz_dbs_ro, ","), *foz_dbs_ro;
         foz_dbs_ro += MAX2(1, n)) {
@@ -300,6 +545,9 @@ load_foz_dbs_ro(struct foz_db *foz_db, const char *foz_dbs_ro)
          free(foz_db_filename);
          continue; /* Ignore invalid user provided filename and continue */
       }
+      if (!create_foz_sorted_idx_filename(foz_db->cache_path, foz_db_filename,
+                                          &sorted_idx_filename))
+         sorted_idx_filename = NULL;
       free(foz_db_filename);
 
       /* Open files as read only */
@@ -312,11 +560,16 @@ load_foz_dbs_ro(struct foz_db *foz_db, const char *foz_dbs_ro)
       if (!check_files_opened_successfully(foz_db->file[file_idx], db_idx)) {
          /* Prevent foz_destroy from destroying it a second time. */
          foz_db->file[file_idx] = NULL;
+         free(sorted_idx_filename);
 
          continue; /* Ignore invalid user provided filename and continue */
       }
 
-      if (!load_foz_dbs(foz_db, db_idx, file_idx, true)) {
+      bool loaded = load_foz_dbs(foz_db, db_idx, file_idx,
+                                 sorted_idx_filename);
+      free(sorted_idx_filename);
+
+      if (!loaded) {
          fclose(db_idx);
          fclose(foz_db->file[file_idx]);
          foz_db->file[file_idx] = NULL;
@@ -379,6 +632,7 @@ load_from_list_file(struct foz_db *foz_db, const char *foz_dbs_list_filename)
    while (fgets(list_entry, sizeof(list_entry), foz_dbs_list_file)) {
       char *db_filename = NULL;
       char *idx_filename = NULL;
+      char *sorted_idx_filename = NULL;
       FILE *db_file = NULL;
       FILE *idx_file = NULL;
 
@@ -407,7 +661,15 @@ load_from_list_file(struct foz_db *foz_db, const char *foz_dbs_list_filename)
       /* Must be set before calling load_foz_dbs() */
       foz_db->file[file_idx] = db_file;
 
-      if (!load_foz_dbs(foz_db, idx_file, file_idx, true)) {
+      if (!create_foz_sorted_idx_filename(foz_db->cache_path, list_entry,
+                                          &sorted_idx_filename))
+         sorted_idx_filename = NULL;
+
+      bool loaded = load_foz_dbs(foz_db, idx_file, file_idx,
+                                 sorted_idx_filename);
+      free(sorted_idx_filename);
+
+      if (!loaded) {
          fclose(db_file);
          fclose(idx_file);
          foz_db->file[file_idx] = NULL;
@@ -526,7 +788,7 @@ foz_prepare(struct foz_db *foz_db, char *cache_path)
       if (foz_db->file[0] == NULL || foz_db->db_idx == NULL)
          goto fail;
 
-      if (!load_foz_dbs(foz_db, foz_db->db_idx, 0, false))
+      if (!load_foz_dbs(foz_db, foz_db->db_idx, 0, NULL))
          goto fail;
    }
 
@@ -569,6 +831,8 @@ foz_destroy(struct foz_db *foz_db)
    for (unsigned i = 0; i < FOZ_MAX_DBS; i++) {
       if (foz_db->file[i])
          fclose(foz_db->file[i]);
+      if (foz_db->sorted_idx[i].map)
+         munmap(foz_db->sorted_idx[i].map, foz_db->sorted_idx[i].map_size);
    }
 
    if (foz_db->mem_ctx) {
@@ -581,33 +845,13 @@ foz_destroy(struct foz_db *foz_db)
    memset(foz_db, 0, sizeof(*foz_db));
 }
 
-/* Here we lookup a cache entry in the index hash table. If an entry is found
- * we use the retrieved offset to read the cache entry from disk.
- */
-void *
-foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
-               size_t *size)
+/* Read the payload of the db entry, must be called with the mutex held */
+static void *
+foz_read_entry_locked(struct foz_db *foz_db, struct foz_db_entry *entry,
+                      const uint8_t *cache_key_160bit, size_t *size)
 {
-   uint64_t hash = truncate_hash_to_64bits(cache_key_160bit);
-
    void *data = NULL;
 
-   if (!foz_db->alive)
-      return NULL;
-
-   simple_mtx_lock(&foz_db->mtx);
-
-   struct foz_db_entry *entry =
-      _mesa_hash_table_u64_search(foz_db->index_db, hash);
-   if (!entry && foz_db->db_idx) {
-      update_foz_index(foz_db, foz_db->db_idx, 0);
-      entry = _mesa_hash_table_u64_search(foz_db->index_db, hash);
-   }
-   if (!entry) {
-      simple_mtx_unlock(&foz_db->mtx);
-      return NULL;
-   }
-
    uint8_t file_idx = entry->file_idx;
    if (fseek(foz_db->file[file_idx], entry->offset, SEEK_SET) < 0)
       goto fail;
@@ -636,8 +880,6 @@ foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
          goto fail;
    }
 
-   simple_mtx_unlock(&foz_db->mtx);
-
    if (size)
       *size = data_sz;
 
@@ -646,10 +888,245 @@ foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
 fail:
    free(data);
 
-   /* reading db entry failed. reset the file offset */
+   return NULL;
+}
+
+/* Looks up a cache entry in the index hash table and then in the sorted
+ * indices of the read only dbs, must be called with the mutex held.
+ */
+static bool
+foz_lookup_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
+                 struct foz_db_entry *entry)
+{
+   uint64_t hash = truncate_hash_to_64bits(cache_key_160bit);
+
+   struct foz_db_entry *found =
+      _mesa_hash_table_u64_search(foz_db->index_db, hash);
+   if (found) {
+      *entry = *found;
+      return true;
+   }
+
+   for (unsigned i = 0; i < FOZ_MAX_DBS; i++) {
+      if (!foz_db->sorted_idx[i].entries)
+         continue;
+
+      if (foz_sorted_index_lookup(&foz_db->sorted_idx[i], cache_key_160bit,
+                                  hash, &entry->offset)) {
+         entry->file_idx = i;
+         memcpy(entry->key, cache_key_160bit, SHA1_DIGEST_LENGTH);
+         entry->header = foz_index_payload_header;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/* Here we lookup a cache entry in the index. If an entry is found we use the
+ * retrieved offset to read the cache entry from disk.
+ */
+void *
+foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
+               size_t *size)
+{
+   void *data = NULL;
+
+   if (!foz_db->alive)
+      return NULL;
+
+   simple_mtx_lock(&foz_db->mtx);
+
+   struct foz_db_entry entry;
+   bool found = foz_lookup_entry(foz_db, cache_key_160bit, &entry);
+   if (!found && foz_db->db_idx) {
+      update_foz_index(foz_db, foz_db->db_idx, 0);
+      found = foz_lookup_entry(foz_db, cache_key_160bit, &entry);
+   }
+
+   if (found)
+      data = foz_read_entry_locked(foz_db, &entry, cache_key_160bit, size);
+
    simple_mtx_unlock(&foz_db->mtx);
 
-   return NULL;
+   return data;
+}
+
+struct foz_batch_entry {
+   struct foz_db_entry entry;
+   unsigned key_idx;
+};
+
+static int
+foz_batch_entry_sort_offset(const void *_a, const void *_b)
+{
+   const struct foz_batch_entry *a = _a;
+   const struct foz_batch_entry *b = _b;
+
+   if (a->entry.file_idx != b->entry.file_idx)
+      return a->entry.file_idx > b->entry.file_idx ? 1 : -1;
+
+   if (a->entry.offset == b->entry.offset)
+      return 0;
+
+   return a->entry.offset > b->entry.offset ? 1 : -1;
+}
+
+static unsigned
+foz_lookup_batch(struct foz_db *foz_db, unsigned num_keys,
+                 const uint8_t *cache_keys_160bit, void **data,
+                 struct foz_batch_entry *batch, bool *missing)
+{
+   unsigned num_batch = 0;
+
+   *missing = false;
+
+   for (unsigned i = 0; i < num_keys; i++) {
+      const uint8_t *key = cache_keys_160bit + i * SHA1_DIGEST_LENGTH;
+
+      if (data[i])
+         continue;
+
+      batch[num_batch].key_idx = i;
+
+      if (foz_lookup_entry(foz_db, key, &batch[num_batch].entry))
+         num_batch++;
+      else
+         *missing = true;
+   }
+
+   return num_batch;
+}
+
+/* Lookup a batch of cache entries. The entries which data pointer is
+ * already set are skipped. All the entries are read with a single lock
+ * acquisition, in the order of their offsets within the db files.
+ *
+ * Returns number of the entries that were read.
+ */
+unsigned
+foz_read_entries(struct foz_db *foz_db, unsigned num_keys,
+                 const uint8_t *cache_keys_160bit,
+                 void **data, size_t *sizes)
+{
+   unsigned num_batch, num_read = 0;
+   bool missing;
+
+   if (!foz_db->alive)
+      return 0;
+
+   struct foz_batch_entry *batch = malloc(num_keys * sizeof(*batch));
+   if (!batch)
+      return 0;
+
+   simple_mtx_lock(&foz_db->mtx);
+
+   num_batch = foz_lookup_batch(foz_db, num_keys, cache_keys_160bit, data,
+                                batch, &missing);
+
+   /* Sync the index once for the whole batch */
+   if (missing && foz_db->db_idx) {
+      update_foz_index(foz_db, foz_db->db_idx, 0);
+      num_batch = foz_lookup_batch(foz_db, num_keys, cache_keys_160bit, data,
+                                   batch, &missing);
+   }
+
+   qsort(batch, num_batch, sizeof(*batch), foz_batch_entry_sort_offset);
+
+   for (unsigned i = 0; i < num_batch; i++) {
+      unsigned idx = batch[i].key_idx;
+      const uint8_t *key = cache_keys_160bit + idx * SHA1_DIGEST_LENGTH;
+
+      data[idx] = foz_read_entry_locked(foz_db, &batch[i].entry, key,
+                                        &sizes[idx]);
+      if (data[idx])
+         num_read++;
+   }
+
+   simple_mtx_unlock(&foz_db->mtx);
+
+   free(batch);
+
+   return num_read;
+}
+
+/* Hint the kernel to start reading the payload of the given entries.
+ * Only entries already present in the index are prefetched.
+ */
+void
+foz_prefetch_entries(struct foz_db *foz_db, unsigned num_keys,
+                     const uint8_t *cache_keys_160bit)
+{
+#ifdef HAVE_POSIX_FADVISE
+   if (!foz_db->alive)
+      return;
+
+   simple_mtx_lock(&foz_db->mtx);
+
+   for (unsigned i = 0; i < num_keys; i++) {
+      const uint8_t *key = cache_keys_160bit + i * SHA1_DIGEST_LENGTH;
+      struct foz_db_entry entry;
+      if (!foz_lookup_entry(foz_db, key, &entry))
+         continue;
+
+      posix_fadvise(fileno(foz_db->file[entry.file_idx]), entry.offset,
+                    sizeof(struct foz_payload_header) +
+                    entry.header.payload_size,
+                    POSIX_FADV_WILLNEED);
+   }
+
+   simple_mtx_unlock(&foz_db->mtx);
+#endif
+}
+
+/* Appends an entry to a db and its offset to the matching index. The db is
+ * flushed first so that the index doesn't point past its end if we get killed
+ * in between.
+ */
+static bool
+append_foz_entry(FILE *db, FILE *db_idx, const char *hash_str,
+                 const struct foz_payload_header *header, const void *blob,
+                 uint64_t *offset_out)
+{
+   fseek(db, 0, SEEK_END);
+
+   /* Write hash header to db */
+   if (fwrite(hash_str, 1, FOSSILIZE_BLOB_HASH_LENGTH, db) !=
+       FOSSILIZE_BLOB_HASH_LENGTH)
+      return false;
+
+   uint64_t offset = ftell(db);
+
+   /* Write db entry header */
+   if (fwrite(header, 1, sizeof(*header), db) != sizeof(*header))
+      return false;
+
+   /* Now write the db entry blob */
+   if (fwrite(blob, 1, header->payload_size, db) != header->payload_size)
+      return false;
+
+   /* Flush everything to file to reduce chance of cache corruption */
+   fflush(db);
+
+   /* Write hash header to index db */
+   if (fwrite(hash_str, 1, FOSSILIZE_BLOB_HASH_LENGTH, db_idx) !=
+       FOSSILIZE_BLOB_HASH_LENGTH)
+      return false;
+
+   if (fwrite(&foz_index_payload_header, 1, sizeof(foz_index_payload_header),
+              db_idx) != sizeof(foz_index_payload_header))
+      return false;
+
+   if (fwrite(&offset, 1, sizeof(uint64_t), db_idx) != sizeof(uint64_t))
+      return false;
+
+   /* Flush everything to file to reduce chance of cache corruption */
+   fflush(db_idx);
+
+   if (offset_out)
+      *offset_out = offset;
+
+   return true;
 }
 
 /* Here we write the cache entry to disk and store its offset in the index db.
@@ -666,11 +1143,13 @@ foz_write_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
    /* The flock is per-fd, not per thread, we do it outside of the main mutex to avoid having to
     * wait in the mutex potentially blocking reads. We use the secondary flock_mtx to stop race
     * conditions between the write threads sharing the same file descriptor. */
+   int64_t lock_start = os_time_get_nano();
    simple_mtx_lock(&foz_db->flock_mtx);
 
    /* Wait for 1 second. This is done outside of the main mutex as I believe there is more potential
     * for file contention than mtx contention of significant length. */
    int err = lock_file_with_timeout(foz_db->file[0], 1000000000);
+   p_atomic_add(&foz_db->lock_wait_ns, os_time_get_nano() - lock_start);
    if (err == -1)
       goto fail_file;
 
@@ -678,9 +1157,8 @@ foz_write_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
 
    update_foz_index(foz_db, foz_db->db_idx, 0);
 
-   struct foz_db_entry *entry =
-      _mesa_hash_table_u64_search(foz_db->index_db, hash);
-   if (entry) {
+   struct foz_db_entry existing;
+   if (foz_lookup_entry(foz_db, cache_key_160bit, &existing)) {
       simple_mtx_unlock(&foz_db->mtx);
       flock(fileno(foz_db->file[0]), LOCK_UN);
       simple_mtx_unlock(&foz_db->flock_mtx);
@@ -694,51 +1172,16 @@ foz_write_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
    header.payload_size = blob_size;
    header.crc = util_hash_crc32(blob, blob_size);
 
-   fseek(foz_db->file[0], 0, SEEK_END);
-
-   /* Write hash header to db */
    char hash_str[SHA1_DIGEST_STRING_LENGTH];
    _mesa_sha1_format(hash_str, cache_key_160bit);
-   if (fwrite(hash_str, 1, FOSSILIZE_BLOB_HASH_LENGTH, foz_db->file[0]) !=
-       FOSSILIZE_BLOB_HASH_LENGTH)
-      goto fail;
-
-   uint64_t offset = ftell(foz_db->file[0]);
-
-   /* Write db entry header */
-   if (fwrite(&header, 1, sizeof(header), foz_db->file[0]) != sizeof(header))
-      goto fail;
-
-   /* Now write the db entry blob */
-   if (fwrite(blob, 1, blob_size, foz_db->file[0]) != blob_size)
-      goto fail;
-
-   /* Flush everything to file to reduce chance of cache corruption */
-   fflush(foz_db->file[0]);
-
-   /* Write hash header to index db */
-   if (fwrite(hash_str, 1, FOSSILIZE_BLOB_HASH_LENGTH, foz_db->db_idx) !=
-       FOSSILIZE_BLOB_HASH_LENGTH)
-      goto fail;
-
-   header.uncompressed_size = sizeof(uint64_t);
-   header.format = FOSSILIZE_COMPRESSION_NONE;
-   header.payload_size = sizeof(uint64_t);
-   header.crc = 0;
 
-   if (fwrite(&header, 1, sizeof(header), foz_db->db_idx) !=
-       sizeof(header))
+   uint64_t offset;
+   if (!append_foz_entry(foz_db->file[0], foz_db->db_idx, hash_str, &header,
+                         blob, &offset))
       goto fail;
 
-   if (fwrite(&offset, 1, sizeof(uint64_t), foz_db->db_idx) !=
-       sizeof(uint64_t))
-      goto fail;
-
-   /* Flush everything to file to reduce chance of cache corruption */
-   fflush(foz_db->db_idx);
-
-   entry = ralloc(foz_db->mem_ctx, struct foz_db_entry);
-   entry->header = header;
+   struct foz_db_entry *entry = ralloc(foz_db->mem_ctx, struct foz_db_entry);
+   entry->header = foz_index_payload_header;
    entry->offset = offset;
    entry->file_idx = 0;
    _mesa_sha1_hex_to_sha1(entry->key, hash_str);
@@ -757,6 +1200,228 @@ fail_file:
    simple_mtx_unlock(&foz_db->flock_mtx);
    return false;
 }
+
+/* Writes the sorted index of a db that isn't written to anymore, such as the
+ * ones given in MESA_DISK_CACHE_READ_ONLY_FOZ_DBS. It is written to a
+ * temporary file first so that processes loading the db at the same time
+ * never see a partial one.
+ */
+bool
+foz_write_sorted_index(const char *cache_path, const char *name)
+{
+   char *filename = NULL;
+   char *idx_filename = NULL;
+   char *sorted_idx_filename = NULL;
+   char *tmp_filename = NULL;
+   struct foz_sorted_index_entry *entries = NULL;
+   FILE *out = NULL;
+   bool ret = false;
+
+   if (!create_foz_db_filenames(cache_path, name, &filename, &idx_filename))
+      return false;
+   free(filename);
+
+   if (!create_foz_sorted_idx_filename(cache_path, name,
+                                       &sorted_idx_filename)) {
+      free(idx_filename);
+      return false;
+   }
+
+   FILE *db_idx = fopen(idx_filename, "rb");
+   if (!db_idx)
+      goto out;
+
+   struct foz_sorted_index_header header = {0};
+   bool read = read_sorted_foz_index(db_idx, &header.idx_size, &entries,
+                                     &header.num_entries);
+   fclose(db_idx);
+   if (!read)
+      goto out;
+
+   memcpy(header.magic, sorted_index_magic_and_version, FOZ_REF_MAGIC_SIZE);
+   header.entry_size = sizeof(struct foz_sorted_index_entry);
+
+   if (asprintf(&tmp_filename, "%s.tmp", sorted_idx_filename) == -1) {
+      tmp_filename = NULL;
+      goto out;
+   }
+
+   out = fopen(tmp_filename, "wb");
+   if (!out)
+      goto out;
+
+   if (fwrite(&header, 1, sizeof(header), out) != sizeof(header) ||
+       fwrite(entries, sizeof(*entries), header.num_entries, out) !=
+       header.num_entries) {
+      fclose(out);
+      unlink(tmp_filename);
+      goto out;
+   }
+
+   if (fclose(out) != 0 || rename(tmp_filename, sorted_idx_filename) != 0) {
+      unlink(tmp_filename);
+      goto out;
+   }
+
+   ret = true;
+
+out:
+   free(entries);
+   free(tmp_filename);
+   free(sorted_idx_filename);
+   free(idx_filename);
+   return ret;
+}
+
+static int
+foz_sorted_index_entry_sort_offset(const void *_a, const void *_b)
+{
+   const struct foz_sorted_index_entry *a = _a;
+   const struct foz_sorted_index_entry *b = _b;
+
+   if (a->offset == b->offset)
+      return 0;
+
+   return a->offset > b->offset ? 1 : -1;
+}
+
+/* Copies the entries of a db to a new db, dropping duplicated keys as well as
+ * entries whose payload is truncated, fails its checksum or doesn't match the
+ * name the index gave it. The sorted index of the new db is written as well.
+ */
+bool
+foz_compact(const char *cache_path, const char *name, const char *new_name,
+            unsigned *num_kept, unsigned *num_dropped)
+{
+   char *filename = NULL, *idx_filename = NULL;
+   char *new_filename = NULL, *new_idx_filename = NULL;
+   FILE *db = NULL, *db_idx = NULL, *new_db = NULL, *new_db_idx = NULL;
+   struct foz_sorted_index_entry *entries = NULL;
+   uint32_t num_entries = 0;
+   void *payload = NULL;
+   uint32_t payload_alloc = 0;
+   unsigned kept = 0, dropped = 0;
+   bool ret = false;
+
+   if (!strcmp(name, new_name))
+      return false;
+
+   if (!create_foz_db_filenames(cache_path, name, &filename, &idx_filename))
+      return false;
+
+   if (!create_foz_db_filenames(cache_path, new_name, &new_filename,
+                                &new_idx_filename))
+      goto out;
+
+   db = fopen(filename, "rb");
+   db_idx = fopen(idx_filename, "rb");
+   if (!check_files_opened_successfully(db, db_idx)) {
+      db = db_idx = NULL;
+      goto out;
+   }
+
+   uint64_t idx_size;
+   if (!read_foz_magic(db) ||
+       !read_sorted_foz_index(db_idx, &idx_size, &entries, &num_entries))
+      goto out;
+
+   fseek(db, 0, SEEK_END);
+   uint64_t db_size = ftell(db);
+
+   /* Read the payloads in the order they were written */
+   if (num_entries)
+      qsort(entries, num_entries, sizeof(*entries),
+            foz_sorted_index_entry_sort_offset);
+
+   new_db = fopen(new_filename, "wb");
+   new_db_idx = fopen(new_idx_filename, "wb");
+   if (!check_files_opened_successfully(new_db, new_db_idx)) {
+      new_db = new_db_idx = NULL;
+      goto out;
+   }
+
+   if (fwrite(stream_reference_magic_and_version, 1,
+              sizeof(stream_reference_magic_and_version), new_db) !=
+       sizeof(stream_reference_magic_and_version) ||
+       fwrite(stream_reference_magic_and_version, 1,
+              sizeof(stream_reference_magic_and_version), new_db_idx) !=
+       sizeof(stream_reference_magic_and_version))
+      goto out;
+
+   for (uint32_t i = 0; i < num_entries; i++) {
+      const struct foz_sorted_index_entry *e = &entries[i];
+      uint8_t key[SHA1_DIGEST_LENGTH] = {0};
+      char hash_str[SHA1_DIGEST_STRING_LENGTH];
+      char db_hash_str[FOSSILIZE_BLOB_HASH_LENGTH];
+      struct foz_payload_header header;
+
+      memcpy(key, e->key, FOZ_SORTED_INDEX_KEY_SIZE);
+      _mesa_sha1_format(hash_str, key);
+
+      if (e->offset < FOZ_REF_MAGIC_SIZE + FOSSILIZE_BLOB_HASH_LENGTH ||
+          e->offset + sizeof(header) > db_size ||
+          fseek(db, e->offset - FOSSILIZE_BLOB_HASH_LENGTH, SEEK_SET) < 0 ||
+          fread(db_hash_str, 1, sizeof(db_hash_str), db) !=
+          sizeof(db_hash_str) ||
+          strncasecmp(db_hash_str, hash_str, FOSSILIZE_BLOB_HASH_LENGTH) ||
+          fread(&header, 1, sizeof(header), db) != sizeof(header) ||
+          e->offset + sizeof(header) + header.payload_size > db_size) {
+         dropped++;
+         continue;
+      }
+
+      if (header.payload_size > payload_alloc) {
+         void *grown = realloc(payload, header.payload_size);
+         if (!grown)
+            goto out;
+         payload = grown;
+         payload_alloc = header.payload_size;
+      }
+
+      if (fread(payload, 1, header.payload_size, db) != header.payload_size ||
+          (header.crc != 0 &&
+           util_hash_crc32(payload, header.payload_size) != header.crc)) {
+         dropped++;
+         continue;
+      }
+
+      if (!append_foz_entry(new_db, new_db_idx, hash_str, &header, payload,
+                            NULL))
+         goto out;
+
+      kept++;
+   }
+
+   int err = fclose(new_db);
+   err |= fclose(new_db_idx);
+   new_db = new_db_idx = NULL;
+   if (err)
+      goto out;
+
+   ret = foz_write_sorted_index(cache_path, new_name);
+
+   if (num_kept)
+      *num_kept = kept;
+   if (num_dropped)
+      *num_dropped = dropped;
+
+out:
+   if (new_db)
+      fclose(new_db);
+   if (new_db_idx)
+      fclose(new_db_idx);
+   if (db)
+      fclose(db);
+   if (db_idx)
+      fclose(db_idx);
+   free(payload);
+   free(entries);
+   free(new_idx_filename);
+   free(new_filename);
+   free(idx_filename);
+   free(filename);
+   return ret;
+}
 #else
 
 bool
@@ -780,6 +1445,20 @@ foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
    return false;
 }
 
+unsigned
+foz_read_entries(struct foz_db *foz_db, unsigned num_keys,
+                 const uint8_t *cache_keys_160bit,
+                 void **data, size_t *sizes)
+{
+   return 0;
+}
+
+void
+foz_prefetch_entries(struct foz_db *foz_db, unsigned num_keys,
+                     const uint8_t *cache_keys_160bit)
+{
+}
+
 bool
 foz_write_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
                 const void *blob, size_t size)
@@ -787,4 +1466,17 @@ foz_write_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
    return false;
 }
 
+bool
+foz_write_sorted_index(const char *cache_path, const char *name)
+{
+   return false;
+}
+
+bool
+foz_compact(const char *cache_path, const char *name, const char *new_name,
+            unsigned *num_kept, unsigned *num_dropped)
+{
+   return false;
+}
+
 #endif
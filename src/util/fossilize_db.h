@@ -48,6 +48,10 @@
 #include "sha1/sha1.h"
 #include "simple_mtx.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Max number of DBs our implementation can read from at once */
 #define FOZ_MAX_DBS 9 /* Default DB + 8 Read only DBs */
 
@@ -84,8 +88,21 @@ struct foz_dbs_list_updater {
    thrd_t thrd;
 };
 
+struct foz_sorted_index_entry;
+
+/* A mapped <name>_sidx.foz, see foz_write_sorted_index() */
+struct foz_sorted_index {
+   void *map;
+   size_t map_size;
+   const struct foz_sorted_index_entry *entries;
+   uint32_t num_entries;
+};
+
 struct foz_db {
    FILE *file[FOZ_MAX_DBS];          /* An array of all foz dbs */
+   struct foz_sorted_index sorted_idx[FOZ_MAX_DBS]; /* Used instead of index_db
+                                                     * for read only dbs that
+                                                     * have one */
    FILE *db_idx;                     /* The default writable foz db idx */
    simple_mtx_t mtx;                 /* Mutex for file/hash table read/writes */
    simple_mtx_t flock_mtx;           /* Mutex for flocking the file for writes */
@@ -94,6 +111,7 @@ struct foz_db {
    bool alive;
    const char *cache_path;
    struct foz_dbs_list_updater updater;
+   uint64_t lock_wait_ns;            /* Time spent waiting for the write locks */
 };
 
 bool
@@ -106,8 +124,28 @@ void *
 foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
                size_t *size);
 
+unsigned
+foz_read_entries(struct foz_db *foz_db, unsigned num_keys,
+                 const uint8_t *cache_keys_160bit,
+                 void **data, size_t *sizes);
+
+void
+foz_prefetch_entries(struct foz_db *foz_db, unsigned num_keys,
+                     const uint8_t *cache_keys_160bit);
+
 bool
 foz_write_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
                 const void *blob, size_t size);
 
+bool
+foz_write_sorted_index(const char *cache_path, const char *name);
+
+bool
+foz_compact(const char *cache_path, const char *name, const char *new_name,
+            unsigned *num_kept, unsigned *num_dropped);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* FOSSILIZE_DB_H */
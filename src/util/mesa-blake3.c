@@ -23,7 +23,10 @@
 #include <string.h>
 #include <inttypes.h>
 #include "mesa-blake3.h"
+#include "blake3/blake3_impl.h"
+#include "c11/threads.h"
 #include "hex.h"
+#include "u_parallel.h"
 
 void _mesa_blake3_format(char *buf, const unsigned char *blake3)
 {
@@ -39,10 +42,183 @@ void _mesa_blake3_compute(const void *data, size_t size, blake3_hash result)
 {
   struct mesa_blake3 ctx;
   _mesa_blake3_init(&ctx);
-  _mesa_blake3_update(&ctx, data, size);
+  _mesa_blake3_update_parallel(&ctx, data, size);
   _mesa_blake3_final(&ctx, result);
 }
 
+/* Inputs of at least this size are hashed by several threads. */
+#define MESA_BLAKE3_PARALLEL_MIN_SIZE (1024 * 1024)
+
+/* Subtrees are split until they are at most this size, each of them is then
+ * hashed by a single thread with SIMD.
+ */
+#define MESA_BLAKE3_PARALLEL_SUBTREE_SIZE (128 * 1024)
+
+void
+_mesa_blake3_update_parallel(struct mesa_blake3 *ctx, const void *data,
+                             size_t size)
+{
+   if (size >= MESA_BLAKE3_PARALLEL_MIN_SIZE)
+      blake3_hasher_update_tbb(ctx, data, size);
+   else
+      blake3_hasher_update(ctx, data, size);
+}
+
+struct blake3_subtree {
+   const uint8_t *input;
+   size_t input_len;
+   uint64_t chunk_counter;
+   size_t num_cvs;
+   uint8_t cvs[MAX_SIMD_DEGREE_OR_2 * BLAKE3_OUT_LEN];
+};
+
+/* The subtrees of the update being hashed by the calling thread, in the
+ * order blake3_compress_subtree_wide() visits them.
+ */
+struct blake3_parallel_state {
+   const uint32_t *key;
+   uint8_t flags;
+   struct blake3_subtree *subtrees;
+   unsigned num_subtrees;
+   unsigned next_subtree;
+};
+
+static thread_local struct blake3_parallel_state *blake3_parallel;
+
+/* Same split as blake3_compress_subtree_wide() */
+static size_t
+blake3_left_subtree_len(size_t input_len)
+{
+   size_t full_chunks = (input_len - 1) / BLAKE3_CHUNK_LEN;
+   return round_down_to_power_of_2(full_chunks) * BLAKE3_CHUNK_LEN;
+}
+
+static unsigned
+blake3_count_subtrees(size_t input_len)
+{
+   if (input_len <= MESA_BLAKE3_PARALLEL_SUBTREE_SIZE)
+      return 1;
+
+   size_t left_len = blake3_left_subtree_len(input_len);
+   return blake3_count_subtrees(left_len) +
+          blake3_count_subtrees(input_len - left_len);
+}
+
+static void
+blake3_collect_subtrees(struct blake3_parallel_state *state,
+                        const uint8_t *input, size_t input_len,
+                        uint64_t chunk_counter)
+{
+   if (input_len <= MESA_BLAKE3_PARALLEL_SUBTREE_SIZE) {
+      struct blake3_subtree *subtree = &state->subtrees[state->num_subtrees++];
+      subtree->input = input;
+      subtree->input_len = input_len;
+      subtree->chunk_counter = chunk_counter;
+      return;
+   }
+
+   size_t left_len = blake3_left_subtree_len(input_len);
+   blake3_collect_subtrees(state, input, left_len, chunk_counter);
+   blake3_collect_subtrees(state, input + left_len, input_len - left_len,
+                           chunk_counter + left_len / BLAKE3_CHUNK_LEN);
+}
+
+static void
+blake3_hash_subtrees(void *data, unsigned start, unsigned count)
+{
+   struct blake3_parallel_state *state = data;
+
+   for (unsigned i = start; i < start + count; i++) {
+      struct blake3_subtree *subtree = &state->subtrees[i];
+      subtree->num_cvs =
+         blake3_compress_subtree_wide(subtree->input, subtree->input_len,
+                                      state->key, subtree->chunk_counter,
+                                      state->flags, subtree->cvs, false);
+   }
+}
+
+static size_t
+blake3_join_side(const uint32_t key[8], uint8_t flags, const uint8_t *input,
+                 size_t input_len, uint64_t chunk_counter, uint8_t *cvs)
+{
+   struct blake3_parallel_state *state = blake3_parallel;
+
+   if (state->next_subtree < state->num_subtrees) {
+      struct blake3_subtree *subtree = &state->subtrees[state->next_subtree];
+      if (subtree->input == input && subtree->input_len == input_len) {
+         state->next_subtree++;
+         memcpy(cvs, subtree->cvs, subtree->num_cvs * BLAKE3_OUT_LEN);
+         return subtree->num_cvs;
+      }
+   }
+
+   /* Above the precomputed subtrees, this recurses back into the join. */
+   return blake3_compress_subtree_wide(input, input_len, key, chunk_counter,
+                                       flags, cvs, true);
+}
+
+/* Called by blake3_compress_subtree_wide() for both halves of every subtree
+ * larger than the SIMD degree. The first call of a large multithreaded update
+ * splits its input the same way in subtrees small enough to be hashed with
+ * SIMD alone and hashes them in parallel. The recursion then carries on as
+ * usual on the calling thread, with the precomputed subtrees standing in for
+ * the leaves, so that the parent nodes are compressed exactly as in the
+ * single threaded case.
+ */
+void
+blake3_compress_subtree_wide_join_tbb(const uint32_t key[8], uint8_t flags,
+                                      bool use_tbb, const uint8_t *l_input,
+                                      size_t l_input_len,
+                                      uint64_t l_chunk_counter, uint8_t *l_cvs,
+                                      size_t *l_n, const uint8_t *r_input,
+                                      size_t r_input_len,
+                                      uint64_t r_chunk_counter, uint8_t *r_cvs,
+                                      size_t *r_n)
+{
+   if (use_tbb && !blake3_parallel &&
+       l_input_len + r_input_len >= MESA_BLAKE3_PARALLEL_MIN_SIZE) {
+      struct blake3_parallel_state state = {
+         .key = key,
+         .flags = flags,
+      };
+      unsigned count = blake3_count_subtrees(l_input_len) +
+                       blake3_count_subtrees(r_input_len);
+
+      state.subtrees = malloc(count * sizeof(*state.subtrees));
+      if (state.subtrees) {
+         blake3_collect_subtrees(&state, l_input, l_input_len,
+                                 l_chunk_counter);
+         blake3_collect_subtrees(&state, r_input, r_input_len,
+                                 r_chunk_counter);
+         util_parallel_for(state.num_subtrees, 1, blake3_hash_subtrees,
+                           &state);
+
+         blake3_parallel = &state;
+         *l_n = blake3_join_side(key, flags, l_input, l_input_len,
+                                 l_chunk_counter, l_cvs);
+         *r_n = blake3_join_side(key, flags, r_input, r_input_len,
+                                 r_chunk_counter, r_cvs);
+         blake3_parallel = NULL;
+
+         free(state.subtrees);
+         return;
+      }
+   }
+
+   if (use_tbb && blake3_parallel) {
+      *l_n = blake3_join_side(key, flags, l_input, l_input_len,
+                              l_chunk_counter, l_cvs);
+      *r_n = blake3_join_side(key, flags, r_input, r_input_len,
+                              r_chunk_counter, r_cvs);
+      return;
+   }
+
+   *l_n = blake3_compress_subtree_wide(l_input, l_input_len, key,
+                                       l_chunk_counter, flags, l_cvs, false);
+   *r_n = blake3_compress_subtree_wide(r_input, r_input_len, key,
+                                       r_chunk_counter, flags, r_cvs, false);
+}
+
 static void
 blake3_to_uint32(const blake3_hash blake3,
                  uint32_t out[BLAKE3_OUT_LEN32])
@@ -63,6 +63,13 @@ _mesa_blake3_format(char *buf, const unsigned char *blake3);
 void
 _mesa_blake3_hex_to_blake3(unsigned char *buf, const char *hex);
 
+/* Same as _mesa_blake3_update(), except that large inputs are hashed by
+ * several threads.
+ */
+void
+_mesa_blake3_update_parallel(struct mesa_blake3 *ctx, const void *data,
+                             size_t size);
+
 void
 _mesa_blake3_compute(const void *data, size_t size, blake3_hash result);
 
@@ -16,6 +16,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "crc32.h"
@@ -25,6 +27,7 @@
 #include "mesa_cache_db.h"
 #include "os_time.h"
 #include "ralloc.h"
+#include "u_atomic.h"
 #include "u_debug.h"
 #include "u_qsort.h"
 
@@ -56,6 +59,7 @@ struct mesa_index_db_hash_entry {
    uint64_t last_access_time;
    uint32_t size;
    bool evicted;
+   bool access_pending;
 };
 
 static inline bool mesa_db_seek_end(FILE *file)
@@ -97,20 +101,28 @@ static void
 mesa_db_close_file(struct mesa_cache_db_file *db_file);
 
 static int
-mesa_db_flock(FILE *file, int op)
+mesa_db_flock_fd(int fd, int op)
 {
    int ret;
 
    do {
-      ret = flock(fileno(file), op);
+      ret = flock(fd, op);
    } while (ret < 0 && errno == EINTR);
 
    return ret;
 }
 
+static int
+mesa_db_flock(FILE *file, int op)
+{
+   return mesa_db_flock_fd(fileno(file), op);
+}
+
 static bool
 mesa_db_lock(struct mesa_cache_db *db)
 {
+   int64_t start = os_time_get_nano();
+
    simple_mtx_lock(&db->flock_mtx);
 
    if (!mesa_db_reopen_file(&db->index) ||
@@ -123,6 +135,8 @@ mesa_db_lock(struct mesa_cache_db *db)
    if (mesa_db_flock(db->index.file, LOCK_EX) < 0)
       goto unlock_cache;
 
+   p_atomic_add(&db->lock_wait_ns, os_time_get_nano() - start);
+
    return true;
 
 unlock_cache:
@@ -263,7 +277,7 @@ mesa_db_zap(struct mesa_cache_db *db)
 }
 
 static bool
-mesa_db_index_entry_valid(struct mesa_index_db_file_entry *entry)
+mesa_db_index_entry_valid(const struct mesa_index_db_file_entry *entry)
 {
    return entry->size && entry->hash &&
           (int64_t)entry->cache_db_file_offset >= sizeof(struct mesa_db_file_header);
@@ -275,16 +289,44 @@ mesa_db_cache_entry_valid(struct mesa_cache_db_file_entry *entry)
    return entry->size && entry->crc;
 }
 
+static void
+mesa_db_insert_index_entries(struct mesa_cache_db *db,
+                             const struct mesa_index_db_file_entry *index_entries,
+                             size_t num_entries)
+{
+   const struct mesa_index_db_file_entry *index_entry;
+   struct mesa_index_db_hash_entry *hash_entry;
+   size_t i;
+
+   for (i = 0, index_entry = index_entries; i < num_entries; i++, index_entry++) {
+      /* Check whether the index entry looks valid or we have a corrupted DB */
+      if (!mesa_db_index_entry_valid(index_entry))
+         break;
+
+      hash_entry = ralloc(db->mem_ctx, struct mesa_index_db_hash_entry);
+      if (!hash_entry)
+         break;
+
+      hash_entry->cache_db_file_offset = index_entry->cache_db_file_offset;
+      hash_entry->index_db_file_offset = db->index.offset;
+      hash_entry->last_access_time = index_entry->last_access_time;
+      hash_entry->size = index_entry->size;
+      hash_entry->access_pending = false;
+
+      _mesa_hash_table_u64_insert(db->index_db, index_entry->hash, hash_entry);
+
+      db->index.offset += sizeof(*index_entry);
+   }
+}
+
 static bool
 mesa_db_update_index(struct mesa_cache_db *db)
 {
-   struct mesa_index_db_hash_entry *hash_entry;
-   struct mesa_index_db_file_entry *index_entries, *index_entry;
+   struct mesa_index_db_file_entry *index_entries;
    size_t file_length;
    size_t old_entries, new_entries;
    size_t new_index_size;
    bool ret = false;
-   int i;
 
    if (!mesa_db_seek_end(db->index.file))
       return false;
@@ -305,24 +347,7 @@ mesa_db_update_index(struct mesa_cache_db *db)
    if (!mesa_db_read_data(db->index.file, index_entries, new_index_size))
       goto error;
 
-   for (i = 0, index_entry = index_entries; i < new_entries; i++, index_entry++) {
-      /* Check whether the index entry looks valid or we have a corrupted DB */
-      if (!mesa_db_index_entry_valid(index_entry))
-         break;
-
-      hash_entry = ralloc(db->mem_ctx, struct mesa_index_db_hash_entry);
-      if (!hash_entry)
-         break;
-
-      hash_entry->cache_db_file_offset = index_entry->cache_db_file_offset;
-      hash_entry->index_db_file_offset = db->index.offset;
-      hash_entry->last_access_time = index_entry->last_access_time;
-      hash_entry->size = index_entry->size;
-
-      _mesa_hash_table_u64_insert(db->index_db, index_entry->hash, hash_entry);
-
-      db->index.offset += sizeof(*index_entry);
-   }
+   mesa_db_insert_index_entries(db, index_entries, new_entries);
 
    if (mesa_db_seek(db->index.file, db->index.offset) &&
        db->index.offset == file_length)
@@ -339,6 +364,49 @@ mesa_db_hash_table_reset(struct mesa_cache_db *db)
    _mesa_hash_table_u64_clear(db->index_db);
    ralloc_free(db->mem_ctx);
    db->mem_ctx = ralloc_context(NULL);
+   db->num_pending_access_times = 0;
+}
+
+/* Write out the last access times of the entries that were read through
+ * the mmap read path. These readers don't take the exclusive lock, hence
+ * the index file update is deferred until the next locked DB operation.
+ * Must be called with the lock held and with an up-to-date index.
+ */
+static bool
+mesa_db_flush_access_times(struct mesa_cache_db *db)
+{
+   struct mesa_index_db_file_entry index_entry;
+
+   if (!db->num_pending_access_times)
+      return true;
+
+   hash_table_foreach(&db->index_db->table, entry) {
+      struct mesa_index_db_hash_entry *hash_entry = entry->data;
+
+      if (!hash_entry->access_pending)
+         continue;
+
+      hash_entry->access_pending = false;
+
+      if (!mesa_db_seek(db->index.file, hash_entry->index_db_file_offset) ||
+          !mesa_db_read(db->index.file, &index_entry) ||
+          !mesa_db_index_entry_valid(&index_entry) ||
+          index_entry.cache_db_file_offset != hash_entry->cache_db_file_offset ||
+          index_entry.size != hash_entry->size)
+         return false;
+
+      index_entry.last_access_time = hash_entry->last_access_time;
+
+      if (!mesa_db_seek(db->index.file, hash_entry->index_db_file_offset) ||
+          !mesa_db_write(db->index.file, &index_entry))
+         return false;
+   }
+
+   db->num_pending_access_times = 0;
+
+   fflush(db->index.file);
+
+   return true;
 }
 
 static bool
@@ -468,6 +536,67 @@ mesa_db_close_file(struct mesa_cache_db_file *db_file)
    }
 }
 
+static bool
+mesa_db_map_open(struct mesa_cache_db_file *db_file)
+{
+   if (db_file->map_fd >= 0)
+      return true;
+
+   db_file->map_fd = open(db_file->path, O_RDONLY | O_CLOEXEC);
+
+   return db_file->map_fd >= 0;
+}
+
+static bool
+mesa_db_map_file(struct mesa_cache_db_file *db_file, size_t size)
+{
+   void *map;
+
+   /* The mapping only grows, the accessible range is bounded by the
+    * file size sampled under the lock.
+    */
+   if (size <= db_file->map_size)
+      return true;
+
+   map = mmap(NULL, size, PROT_READ, MAP_SHARED, db_file->map_fd, 0);
+   if (map == MAP_FAILED)
+      return false;
+
+   if (db_file->map)
+      munmap(db_file->map, db_file->map_size);
+
+   db_file->map = map;
+   db_file->map_size = size;
+
+   return true;
+}
+
+static void
+mesa_db_unmap_file(struct mesa_cache_db_file *db_file)
+{
+   if (db_file->map)
+      munmap(db_file->map, db_file->map_size);
+
+   if (db_file->map_fd >= 0)
+      close(db_file->map_fd);
+
+   db_file->map_fd = -1;
+   db_file->map = NULL;
+   db_file->map_size = 0;
+}
+
+/* Returns size of the mapped file or 0 if file was unlinked */
+static size_t
+mesa_db_mapped_file_size(struct mesa_cache_db_file *db_file)
+{
+   struct stat st;
+
+   if (fstat(db_file->map_fd, &st) < 0 || !st.st_nlink)
+      return 0;
+
+   return st.st_size;
+}
+
 static void
 mesa_db_free_file(struct mesa_cache_db_file *db_file)
 {
@@ -535,9 +664,13 @@ mesa_db_compact(struct mesa_cache_db *db, int64_t blob_size,
    struct mesa_index_db_file_entry index_entry;
    struct mesa_index_db_hash_entry **entries;
    bool success = false, compact = false;
+   unsigned int num_evicted = 0;
    void *buffer = NULL;
    unsigned int i = 0;
 
+   if (!mesa_db_flush_access_times(db))
+      return false;
+
    /* reload index to sync the last access times */
    if (!remove_entry && !mesa_db_reload(db))
       return false;
@@ -615,6 +748,7 @@ mesa_db_compact(struct mesa_cache_db *db, int64_t blob_size,
             goto cleanup;
 
          compact = true;
+         num_evicted++;
          continue;
       }
 
@@ -665,6 +799,7 @@ mesa_db_compact(struct mesa_cache_db *db, int64_t blob_size,
        !mesa_db_write_header(&db->index, db->uuid, false))
       goto cleanup;
 
+   p_atomic_add(&db->num_evicted, num_evicted);
    success = true;
 
 cleanup:
@@ -685,6 +820,11 @@ cleanup:
 bool
 mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
 {
+   db->cache.map_fd = -1;
+   db->index.map_fd = -1;
+   db->mmap_reads = debug_get_bool_option("MESA_DISK_CACHE_DATABASE_MMAP",
+                                          false);
+
    if (!mesa_db_open_file(&db->cache, cache_path, "mesa_cache.db"))
       return false;
 
@@ -739,6 +879,17 @@ mesa_db_wipe_path(const char *cache_path)
 void
 mesa_cache_db_close(struct mesa_cache_db *db)
 {
+   /* Write out the access times deferred by the mmap read path */
+   if (db->num_pending_access_times && mesa_db_lock(db)) {
+      if (db->alive && !mesa_db_uuid_changed(db))
+         mesa_db_flush_access_times(db);
+
+      mesa_db_unlock(db);
+   }
+
+   mesa_db_unmap_file(&db->index);
+   mesa_db_unmap_file(&db->cache);
+
    _mesa_hash_table_u64_destroy(db->index_db);
    simple_mtx_destroy(&db->flock_mtx);
    ralloc_free(db->mem_ctx);
@@ -760,47 +911,164 @@ mesa_cache_db_file_entry_size(void)
    return sizeof(struct mesa_cache_db_file_entry);
 }
 
-void *
-mesa_cache_db_read_entry(struct mesa_cache_db *db,
-                         const uint8_t *cache_key_160bit,
-                         size_t *size)
+/* Look up entry using the read-only shared mappings of the DB files.
+ *
+ * Readers hold only a shared lock of the index file, hence cache hits from
+ * multiple processes don't serialize on the exclusive lock and don't do
+ * any file reads. The shared lock is still required because compaction
+ * truncates the files, and touching the truncated part of a mapping raises
+ * SIGBUS. The header UUID serves as the DB generation counter, it changes
+ * whenever the files are compacted or re-created, which makes the in-memory
+ * index stale. The last access time isn't written to the index file here,
+ * it's written out by the next locked DB operation.
+ *
+ * Returns false if the lookup needs to be retried using the locked path.
+ */
+static bool
+mesa_db_mmap_read_entry(struct mesa_cache_db *db,
+                        const uint8_t *cache_key_160bit,
+                        void **data, size_t *size)
 {
    uint64_t hash = to_mesa_cache_db_hash(cache_key_160bit);
+   const struct mesa_db_file_header *cache_header, *index_header;
    struct mesa_cache_db_file_entry cache_entry;
-   struct mesa_index_db_file_entry index_entry;
    struct mesa_index_db_hash_entry *hash_entry;
-   void *data = NULL;
+   size_t cache_size, index_size, num_entries;
+   const uint8_t *blob;
+   bool stale = false;
+   bool ret = false;
 
-   if (!mesa_db_lock(db))
-      return NULL;
+   if (!mesa_db_map_open(&db->cache) ||
+       !mesa_db_map_open(&db->index))
+      return false;
 
-   if (!db->alive)
-      goto fail;
+   if (mesa_db_flock_fd(db->index.map_fd, LOCK_SH) < 0)
+      return false;
 
-   if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
-      goto fail_fatal;
+   cache_size = mesa_db_mapped_file_size(&db->cache);
+   index_size = mesa_db_mapped_file_size(&db->index);
 
-   if (!mesa_db_update_index(db))
-      goto fail_fatal;
+   /* Files were wiped out or zapped by other process */
+   if (cache_size < sizeof(*cache_header) ||
+       index_size < sizeof(*index_header) ||
+       index_size < db->index.offset) {
+      stale = true;
+      goto unlock;
+   }
+
+   if (!mesa_db_map_file(&db->cache, cache_size) ||
+       !mesa_db_map_file(&db->index, index_size))
+      goto unlock;
+
+   cache_header = db->cache.map;
+   index_header = db->index.map;
+
+   if (cache_header->uuid != db->uuid ||
+       index_header->uuid != db->uuid) {
+      stale = true;
+      goto unlock;
+   }
+
+   /* Pick up entries appended by other processes */
+   num_entries = (index_size - db->index.offset) /
+                 sizeof(struct mesa_index_db_file_entry);
+   if (num_entries) {
+      _mesa_hash_table_reserve(&db->index_db->table,
+                               _mesa_hash_table_num_entries(&db->index_db->table) +
+                               num_entries);
+
+      mesa_db_insert_index_entries(db,
+                                   (const void *)((const uint8_t *)db->index.map +
+                                                  db->index.offset),
+                                   num_entries);
+   }
+
+   /* Let the locked path deal with the corrupted index */
+   if (db->index.offset != index_size)
+      goto unlock;
 
    hash_entry = _mesa_hash_table_u64_search(db->index_db, hash);
-   if (!hash_entry)
-      goto fail;
+   if (!hash_entry) {
+      ret = true;
+      goto unlock;
+   }
+
+   if (hash_entry->cache_db_file_offset +
+       blob_file_size(hash_entry->size) > cache_size)
+      goto unlock;
+
+   blob = (const uint8_t *)db->cache.map + hash_entry->cache_db_file_offset;
+   memcpy(&cache_entry, blob, sizeof(cache_entry));
+   blob += sizeof(cache_entry);
+
+   if (!mesa_db_cache_entry_valid(&cache_entry) ||
+       cache_entry.size != hash_entry->size)
+      goto unlock;
+
+   if (memcmp(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key))) {
+      ret = true;
+      goto unlock;
+   }
+
+   if (util_hash_crc32(blob, cache_entry.size) != cache_entry.crc)
+      goto unlock;
+
+   *data = malloc(cache_entry.size);
+   if (*data) {
+      memcpy(*data, blob, cache_entry.size);
+      *size = cache_entry.size;
+
+      hash_entry->last_access_time = os_time_get_nano();
+
+      if (!hash_entry->access_pending) {
+         hash_entry->access_pending = true;
+         db->num_pending_access_times++;
+      }
+   }
+
+   ret = true;
+
+unlock:
+   mesa_db_flock_fd(db->index.map_fd, LOCK_UN);
+
+   /* Files were replaced, re-open them on the next lookup */
+   if (stale) {
+      mesa_db_unmap_file(&db->index);
+      mesa_db_unmap_file(&db->cache);
+   }
+
+   return ret;
+}
+
+/* Read cache entry referenced by the hash entry, must be called with the
+ * lock held. Returns false if DB is corrupted, the *data is set to NULL if
+ * entry isn't present.
+ */
+static bool
+mesa_db_read_entry_locked(struct mesa_cache_db *db,
+                          struct mesa_index_db_hash_entry *hash_entry,
+                          const uint8_t *cache_key_160bit,
+                          void **data, size_t *size)
+{
+   struct mesa_cache_db_file_entry cache_entry;
+   struct mesa_index_db_file_entry index_entry;
+
+   *data = NULL;
 
    if (!mesa_db_seek(db->cache.file, hash_entry->cache_db_file_offset) ||
        !mesa_db_read(db->cache.file, &cache_entry) ||
        !mesa_db_cache_entry_valid(&cache_entry))
-      goto fail_fatal;
+      return false;
 
    if (memcmp(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key)))
-      goto fail;
+      return true;
 
-   data = malloc(cache_entry.size);
-   if (!data)
-      goto fail;
+   *data = malloc(cache_entry.size);
+   if (!*data)
+      return true;
 
-   if (!mesa_db_read_data(db->cache.file, data, cache_entry.size) ||
-       util_hash_crc32(data, cache_entry.size) != cache_entry.crc)
+   if (!mesa_db_read_data(db->cache.file, *data, cache_entry.size) ||
+       util_hash_crc32(*data, cache_entry.size) != cache_entry.crc)
       goto fail_fatal;
 
    if (!mesa_db_seek(db->index.file, hash_entry->index_db_file_offset) ||
@@ -817,24 +1085,218 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
        !mesa_db_write(db->index.file, &index_entry))
       goto fail_fatal;
 
+   *size = cache_entry.size;
+
+   return true;
+
+fail_fatal:
+   free(*data);
+   *data = NULL;
+
+   return false;
+}
+
+void *
+mesa_cache_db_read_entry(struct mesa_cache_db *db,
+                         const uint8_t *cache_key_160bit,
+                         size_t *size)
+{
+   uint64_t hash = to_mesa_cache_db_hash(cache_key_160bit);
+   struct mesa_index_db_hash_entry *hash_entry;
+   void *data = NULL;
+
+   if (db->mmap_reads) {
+      bool done;
+
+      simple_mtx_lock(&db->flock_mtx);
+      done = !db->alive ||
+             mesa_db_mmap_read_entry(db, cache_key_160bit, &data, size);
+      simple_mtx_unlock(&db->flock_mtx);
+
+      if (done)
+         return data;
+   }
+
+   if (!mesa_db_lock(db))
+      return NULL;
+
+   if (!db->alive)
+      goto fail;
+
+   if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
+      goto fail_fatal;
+
+   if (!mesa_db_update_index(db))
+      goto fail_fatal;
+
+   hash_entry = _mesa_hash_table_u64_search(db->index_db, hash);
+   if (!hash_entry)
+      goto fail;
+
+   if (!mesa_db_read_entry_locked(db, hash_entry, cache_key_160bit,
+                                  &data, size))
+      goto fail_fatal;
+
    fflush(db->index.file);
 
    mesa_db_unlock(db);
 
-   *size = cache_entry.size;
-
    return data;
 
 fail_fatal:
    mesa_db_zap(db);
 fail:
-   free(data);
-
    mesa_db_unlock(db);
 
    return NULL;
 }
 
+struct mesa_db_batch_entry {
+   struct mesa_index_db_hash_entry *hash_entry;
+   unsigned int key_idx;
+};
+
+static int
+batch_entry_sort_offset(const void *_a, const void *_b)
+{
+   const struct mesa_db_batch_entry *a = _a;
+   const struct mesa_db_batch_entry *b = _b;
+
+   if (a->hash_entry->cache_db_file_offset ==
+       b->hash_entry->cache_db_file_offset)
+      return 0;
+
+   return a->hash_entry->cache_db_file_offset >
+          b->hash_entry->cache_db_file_offset ? 1 : -1;
+}
+
+unsigned int
+mesa_cache_db_read_entries(struct mesa_cache_db *db,
+                           unsigned int num_keys,
+                           const uint8_t *cache_keys_160bit,
+                           void **data, size_t *sizes)
+{
+   struct mesa_db_batch_entry *batch = NULL;
+   unsigned int i, num_batch = 0, num_read = 0;
+
+   /* The mmap path doesn't do file I/O, no gain from ordering the reads */
+   if (db->mmap_reads) {
+      for (i = 0; i < num_keys; i++) {
+         if (data[i])
+            continue;
+
+         data[i] = mesa_cache_db_read_entry(db,
+                                            cache_keys_160bit + i * sizeof(cache_key),
+                                            &sizes[i]);
+         if (data[i])
+            num_read++;
+      }
+
+      return num_read;
+   }
+
+   if (!mesa_db_lock(db))
+      return 0;
+
+   if (!db->alive)
+      goto unlock;
+
+   if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
+      goto fail_fatal;
+
+   if (!mesa_db_update_index(db))
+      goto fail_fatal;
+
+   batch = malloc(num_keys * sizeof(*batch));
+   if (!batch)
+      goto unlock;
+
+   for (i = 0; i < num_keys; i++) {
+      const uint8_t *key = cache_keys_160bit + i * sizeof(cache_key);
+
+      if (data[i])
+         continue;
+
+      batch[num_batch].hash_entry =
+         _mesa_hash_table_u64_search(db->index_db, to_mesa_cache_db_hash(key));
+      batch[num_batch].key_idx = i;
+
+      if (batch[num_batch].hash_entry)
+         num_batch++;
+   }
+
+   /* Read the entries in the file order to make the I/O sequential */
+   qsort(batch, num_batch, sizeof(*batch), batch_entry_sort_offset);
+
+   for (i = 0; i < num_batch; i++) {
+      unsigned int idx = batch[i].key_idx;
+
+      if (!mesa_db_read_entry_locked(db, batch[i].hash_entry,
+                                     cache_keys_160bit + idx * sizeof(cache_key),
+                                     &data[idx], &sizes[idx]))
+         goto fail_fatal;
+
+      if (data[idx])
+         num_read++;
+   }
+
+   fflush(db->index.file);
+
+   goto unlock;
+
+fail_fatal:
+   mesa_db_zap(db);
+unlock:
+   mesa_db_unlock(db);
+
+   free(batch);
+
+   return num_read;
+}
+
+static void
+mesa_db_prefetch_range(int fd, uint64_t offset, uint32_t size)
+{
+#ifdef HAVE_POSIX_FADVISE
+   posix_fadvise(fd, offset, size, POSIX_FADV_WILLNEED);
+#endif
+}
+
+void
+mesa_cache_db_prefetch_entries(struct mesa_cache_db *db,
+                               unsigned int num_keys,
+                               const uint8_t *cache_keys_160bit)
+{
+   int fd;
+
+   simple_mtx_lock(&db->flock_mtx);
+
+   if (!db->alive)
+      goto unlock;
+
+   /* This is only a hint, hence the index isn't synced with the file
+    * and entries written by other processes are skipped.
+    */
+   fd = open(db->cache.path, O_RDONLY | O_CLOEXEC);
+   if (fd < 0)
+      goto unlock;
+
+   for (unsigned int i = 0; i < num_keys; i++) {
+      const uint8_t *key = cache_keys_160bit + i * sizeof(cache_key);
+      struct mesa_index_db_hash_entry *hash_entry =
+         _mesa_hash_table_u64_search(db->index_db, to_mesa_cache_db_hash(key));
+
+      if (hash_entry)
+         mesa_db_prefetch_range(fd, hash_entry->cache_db_file_offset,
+                                blob_file_size(hash_entry->size));
+   }
+
+   close(fd);
+
+unlock:
+   simple_mtx_unlock(&db->flock_mtx);
+}
+
 static bool
 mesa_cache_db_has_space_locked(struct mesa_cache_db *db, size_t blob_size)
 {
@@ -867,6 +1329,9 @@ mesa_cache_db_entry_write(struct mesa_cache_db *db,
    if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
       goto fail_fatal;
 
+   if (!mesa_db_flush_access_times(db))
+      goto fail_fatal;
+
    if (!mesa_db_seek_end(db->cache.file))
       goto fail_fatal;
 
@@ -906,6 +1371,7 @@ mesa_cache_db_entry_write(struct mesa_cache_db *db,
    hash_entry->index_db_file_offset = ftell(db->index.file);
    hash_entry->last_access_time = index_entry.last_access_time;
    hash_entry->size = index_entry.size;
+   hash_entry->access_pending = false;
 
    if (!mesa_db_write(db->cache.file, &cache_entry) ||
        !mesa_db_write_data(db->cache.file, blob, blob_size) ||
@@ -1033,6 +1499,9 @@ mesa_cache_db_eviction_score(struct mesa_cache_db *db)
    if (!db->alive)
       goto fail;
 
+   if (!mesa_db_uuid_changed(db) && !mesa_db_flush_access_times(db))
+      goto fail_fatal;
+
    if (!mesa_db_reload(db))
       goto fail_fatal;
 
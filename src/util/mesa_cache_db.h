@@ -26,6 +26,11 @@ struct mesa_cache_db_file {
    char *path;
    off_t offset;
    uint64_t uuid;
+
+   /* Read-only shared mapping used by the mmap read path */
+   int map_fd;
+   void *map;
+   size_t map_size;
 };
 
 struct mesa_cache_db {
@@ -36,6 +41,13 @@ struct mesa_cache_db {
    simple_mtx_t flock_mtx;
    void *mem_ctx;
    uint64_t uuid;
+   unsigned int num_pending_access_times;
+
+   /* Statistics, see struct disk_cache_stats */
+   uint64_t lock_wait_ns;
+   unsigned int num_evicted;
+
+   bool mmap_reads;
    bool alive;
 };
 
@@ -58,6 +70,17 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
                          const uint8_t *cache_key_160bit,
                          size_t *size);
 
+unsigned int
+mesa_cache_db_read_entries(struct mesa_cache_db *db,
+                           unsigned int num_keys,
+                           const uint8_t *cache_keys_160bit,
+                           void **data, size_t *sizes);
+
+void
+mesa_cache_db_prefetch_entries(struct mesa_cache_db *db,
+                               unsigned int num_keys,
+                               const uint8_t *cache_keys_160bit);
+
 bool
 mesa_cache_db_entry_write(struct mesa_cache_db *db,
                           const uint8_t *cache_key_160bit,
@@ -107,6 +130,22 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    return NULL;
 }
 
+static inline unsigned int
+mesa_cache_db_read_entries(struct mesa_cache_db *db,
+                           unsigned int num_keys,
+                           const uint8_t *cache_keys_160bit,
+                           void **data, size_t *sizes)
+{
+   return 0;
+}
+
+static inline void
+mesa_cache_db_prefetch_entries(struct mesa_cache_db *db,
+                               unsigned int num_keys,
+                               const uint8_t *cache_keys_160bit)
+{
+}
+
 static inline bool
 mesa_cache_db_entry_write(struct mesa_cache_db *db,
                           const uint8_t *cache_key_160bit,
@@ -148,6 +148,47 @@ mesa_cache_db_multipart_read_entry(struct mesa_cache_db_multipart *db,
    return NULL;
 }
 
+unsigned int
+mesa_cache_db_multipart_read_entries(struct mesa_cache_db_multipart *db,
+                                     unsigned int num_keys,
+                                     const uint8_t *cache_keys_160bit,
+                                     void **data, size_t *sizes)
+{
+   unsigned last_read_part = db->last_read_part;
+   unsigned int num_read = 0;
+
+   for (unsigned int i = 0; i < db->num_parts && num_read < num_keys; i++) {
+      unsigned int part = (last_read_part + i) % db->num_parts;
+      unsigned int part_read;
+
+      if (!mesa_cache_db_multipart_init_part(db, part))
+         break;
+
+      part_read = mesa_cache_db_read_entries(db->parts[part], num_keys,
+                                             cache_keys_160bit, data, sizes);
+      if (part_read)
+         db->last_read_part = part;
+
+      num_read += part_read;
+   }
+
+   return num_read;
+}
+
+void
+mesa_cache_db_multipart_prefetch_entries(struct mesa_cache_db_multipart *db,
+                                         unsigned int num_keys,
+                                         const uint8_t *cache_keys_160bit)
+{
+   for (unsigned int i = 0; i < db->num_parts; i++) {
+      if (!mesa_cache_db_multipart_init_part(db, i))
+         break;
+
+      mesa_cache_db_prefetch_entries(db->parts[i], num_keys,
+                                     cache_keys_160bit);
+   }
+}
+
 static unsigned
 mesa_cache_db_multipart_select_victim_part(struct mesa_cache_db_multipart *db)
 {
@@ -36,6 +36,17 @@ mesa_cache_db_multipart_read_entry(struct mesa_cache_db_multipart *db,
                                    const uint8_t *cache_key_160bit,
                                    size_t *size);
 
+unsigned int
+mesa_cache_db_multipart_read_entries(struct mesa_cache_db_multipart *db,
+                                     unsigned int num_keys,
+                                     const uint8_t *cache_keys_160bit,
+                                     void **data, size_t *sizes);
+
+void
+mesa_cache_db_multipart_prefetch_entries(struct mesa_cache_db_multipart *db,
+                                         unsigned int num_keys,
+                                         const uint8_t *cache_keys_160bit);
+
 bool
 mesa_cache_db_multipart_entry_write(struct mesa_cache_db_multipart *db,
                                     const uint8_t *cache_key_160bit,
@@ -60,6 +60,12 @@ struct mesa_trace_flow {
          util_perfetto_trace_full_end(name, track_id, clock, timestamp);            \
    } while (0)
 
+#define _MESA_TRACE_FRAME_MARK()                                             \
+   do {                                                                      \
+      if (unlikely(util_perfetto_is_tracing_enabled()))                      \
+         util_perfetto_frame_mark();                                         \
+   } while (0)
+
 /* NOTE: for now disable atrace for C++ to workaround a ndk bug with ordering
  * between stdatomic.h and atomic.h.  See:
  *
@@ -77,6 +83,7 @@ struct mesa_trace_flow {
 #define _MESA_TRACE_SET_COUNTER(name, value)
 #define _MESA_TRACE_TIMESTAMP_BEGIN(name, track_id, flow_id, clock, timestamp)
 #define _MESA_TRACE_TIMESTAMP_END(name, track_id, clock, timestamp)
+#define _MESA_TRACE_FRAME_MARK()
 #else
 
 #define _MESA_TRACE_BEGIN(name)
@@ -85,6 +92,7 @@ struct mesa_trace_flow {
 #define _MESA_TRACE_SET_COUNTER(name, value)
 #define _MESA_TRACE_TIMESTAMP_BEGIN(name, track_id, flow_id, clock, timestamp)
 #define _MESA_TRACE_TIMESTAMP_END(name, track_id, clock, timestamp)
+#define _MESA_TRACE_FRAME_MARK()
 
 #endif /* HAVE_PERFETTO */
 
@@ -214,6 +222,8 @@ _mesa_trace_scope_end(UNUSED void **scope)
    _MESA_TRACE_TIMESTAMP_BEGIN(name, track_id, flow_id, clock, timestamp)
 #define MESA_TRACE_TIMESTAMP_END(name, track_id, clock, timestamp) \
    _MESA_TRACE_TIMESTAMP_END(name, track_id, clock, timestamp)
+/* Marks a present/swapbuffers on the process-wide "Frames" track */
+#define MESA_TRACE_FRAME_MARK() _MESA_TRACE_FRAME_MARK()
 
 static inline void
 util_cpu_trace_init()
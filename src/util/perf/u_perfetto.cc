@@ -29,9 +29,13 @@
 #include <perfetto/tracing.h>
 #endif
 
+#include <inttypes.h>
+#include <stdio.h>
+
 #include "c11/threads.h"
 #include "util/u_call_once.h"
 #include "util/macros.h"
+#include "util/simple_mtx.h"
 #include "util/timespec.h"
 
 /* perfetto requires string literals */
@@ -163,6 +167,50 @@ util_perfetto_trace_full_end(const char *name, uint64_t track_id, perfetto_clock
    util_perfetto_update_tracing_state();
 }
 
+/* State of the "Frames" track, shared by every API in the process. */
+static simple_mtx_t util_perfetto_frame_mutex = SIMPLE_MTX_INITIALIZER;
+static uint64_t util_perfetto_frame_track;
+static uint64_t util_perfetto_frame_nr;
+static uint64_t util_perfetto_frame_start;
+
+/* Called on present/swapbuffers: ends the current frame slice and starts the
+ * next one, so the slices cover the CPU time between two presents.  The
+ * frame time is also emitted as a counter.
+ */
+void
+util_perfetto_frame_mark(void)
+{
+   perfetto::TraceTimestamp now =
+      util_perfetto_now(util_perfetto_get_default_clock());
+
+   simple_mtx_lock(&util_perfetto_frame_mutex);
+
+   if (!util_perfetto_frame_track)
+      util_perfetto_frame_track = util_perfetto_new_track("Frames");
+   auto track = perfetto::Track(util_perfetto_frame_track);
+
+   if (util_perfetto_frame_start) {
+      TRACE_EVENT_END(UTIL_PERFETTO_CATEGORY_DEFAULT_STR, track, now);
+      TRACE_COUNTER(UTIL_PERFETTO_CATEGORY_DEFAULT_STR,
+                    perfetto::DynamicString("Frame time (ms)"), now,
+                    (now.value - util_perfetto_frame_start) / 1000000.0);
+   }
+
+   uint64_t frame_nr = util_perfetto_frame_nr++;
+   TRACE_EVENT_BEGIN(
+      UTIL_PERFETTO_CATEGORY_DEFAULT_STR, nullptr, track, now,
+      [&](perfetto::EventContext ctx) {
+         char name[32];
+         snprintf(name, sizeof(name), "Frame %" PRIu64, frame_nr);
+         ctx.event()->set_name(name);
+      });
+   util_perfetto_frame_start = now.value;
+
+   simple_mtx_unlock(&util_perfetto_frame_mutex);
+
+   util_perfetto_update_tracing_state();
+}
+
 void
 util_perfetto_counter_set(const char *name, double value)
 {
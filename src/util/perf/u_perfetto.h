@@ -70,6 +70,8 @@ uint64_t util_perfetto_next_id(void);
 
 uint64_t util_perfetto_new_track(const char *name);
 
+void util_perfetto_frame_mark(void);
+
 #else /* HAVE_PERFETTO */
 
 static inline void
@@ -126,6 +128,10 @@ static inline uint64_t util_perfetto_new_track(const char *name)
    return 0;
 }
 
+static inline void util_perfetto_frame_mark(void)
+{
+}
+
 #endif /* HAVE_PERFETTO */
 
 #ifdef __cplusplus
@@ -34,6 +34,9 @@
 #include "util/ralloc.h"
 #include "util/set.h"
 
+/* Default period between two clock snapshots, see MaybeEmitClockSync() */
+#define MESA_RENDERPASS_CLOCK_SYNC_PERIOD_NS 1000000000ull
+
 /**
  * Struct tracking state during a perfetto packet sequence
  *
@@ -147,6 +150,36 @@ class MesaRenderpassDataSource
       }
    }
 
+   /* Emits a clock sync if period_ns has elapsed since the previous one, so
+    * that every driver paces them the same way.  Setting next_clock_sync_ns
+    * to 0 forces a sync on the next call, e.g. after incremental state was
+    * cleared.
+    *
+    * read_clocks(cpu_ts, gpu_ts) is only called when a sync is due, since
+    * reading the GPU timestamp usually costs an ioctl.
+    */
+   template <typename ReadClocks>
+   static bool MaybeEmitClockSync(TraceContext &ctx,
+                                  uint64_t &next_clock_sync_ns,
+                                  uint64_t period_ns,
+                                  uint32_t cpu_clock_id,
+                                  uint32_t gpu_clock_id,
+                                  ReadClocks read_clocks)
+   {
+      uint64_t now = perfetto::base::GetBootTimeNs().count();
+      if (now < next_clock_sync_ns)
+         return false;
+
+      uint64_t cpu_ts, gpu_ts;
+      read_clocks(cpu_ts, gpu_ts);
+
+      PERFETTO_LOG("sending clocks gpu=0x%08x", gpu_clock_id);
+
+      next_clock_sync_ns = now + period_ns;
+      EmitClockSync(ctx, cpu_ts, gpu_ts, cpu_clock_id, gpu_clock_id);
+      return true;
+   }
+
    /* Returns a stage iid to use for a command stream or queue annotation.
     *
     * Using a new stage lets the annotation string show up right on the track
@@ -36,6 +36,7 @@
 #define PAYLOAD_BUFFER_SIZE 0x100
 #define TIMESTAMP_BUF_SIZE 0x1000
 #define TRACES_PER_CHUNK (TIMESTAMP_BUF_SIZE / sizeof(uint64_t))
+#define MAX_FREE_CHUNKS 32
 
 struct u_trace_state {
    util_once_flag once;
@@ -73,11 +74,16 @@ struct u_trace_event {
  * A "chunk" of trace-events and corresponding timestamp buffer.  As
  * trace events are emitted, additional trace chucks will be allocated
  * as needed.  When u_trace_flush() is called, they are transferred
- * from the u_trace to the u_trace_context queue.
+ * from the u_trace to the u_trace_context queue.  Once processed, they
+ * go back to the u_trace_context free_chunks stack to be reused along
+ * with their buffers.
  */
 struct u_trace_chunk {
    struct list_head node;
 
+   /* next chunk in u_trace_context::free_chunks */
+   struct u_trace_chunk *next_free;
+
    struct u_trace_context *utctx;
 
    /* The number of traces this chunk contains so far: */
@@ -102,8 +108,6 @@ struct u_trace_chunk {
    /* Current payload buffer being written. */
    struct u_trace_payload_buf *payload;
 
-   struct util_queue_fence fence;
-
    bool has_indirect;
    bool last; /* this chunk is last in batch */
    bool eof;  /* this chunk is last in frame, unless frame_nr is set */
@@ -118,6 +122,16 @@ struct u_trace_chunk {
    bool free_flush_data;
 };
 
+/**
+ * The chunks of a u_trace_context_process() call, processed by a single
+ * queue job.
+ */
+struct u_trace_process_job {
+   struct list_head chunks;
+
+   struct util_queue_fence fence;
+};
+
 struct u_trace_printer {
    void (*start)(struct u_trace_context *utctx);
    void (*end)(struct u_trace_context *utctx);
@@ -347,10 +361,8 @@ u_trace_payload_buf_unref(struct u_trace_payload_buf *payload)
 }
 
 static void
-free_chunk(void *ptr)
+destroy_chunk(struct u_trace_chunk *chunk)
 {
-   struct u_trace_chunk *chunk = ptr;
-
    chunk->utctx->delete_buffer(chunk->utctx, chunk->timestamps);
    if (chunk->indirects)
       chunk->utctx->delete_buffer(chunk->utctx, chunk->indirects);
@@ -361,10 +373,90 @@ free_chunk(void *ptr)
       u_trace_payload_buf_unref(*payload);
    u_vector_finish(&chunk->payloads);
 
-   list_del(&chunk->node);
    free(chunk);
 }
 
+/* Pushing is lock-free and safe from any thread. */
+static void
+push_free_chunks(struct u_trace_context *utctx,
+                 struct u_trace_chunk *first,
+                 struct u_trace_chunk *last)
+{
+   struct u_trace_chunk *head = p_atomic_read(&utctx->free_chunks);
+   struct u_trace_chunk *old;
+
+   do {
+      old = head;
+      last->next_free = old;
+      head = p_atomic_cmpxchg_ptr(&utctx->free_chunks, old, first);
+   } while (head != old);
+}
+
+static struct u_trace_chunk *
+take_free_chunks(struct u_trace_context *utctx)
+{
+   struct u_trace_chunk *head = p_atomic_read(&utctx->free_chunks);
+   struct u_trace_chunk *old;
+
+   do {
+      old = head;
+      if (!old)
+         return NULL;
+      head = p_atomic_cmpxchg_ptr(&utctx->free_chunks, old, NULL);
+   } while (head != old);
+
+   return head;
+}
+
+/* Popping a single entry of a lock-free stack is prone to ABA issues when
+ * there are several consumers, so take the whole stack, keep the top chunk
+ * and push the rest back.  The stack is capped at MAX_FREE_CHUNKS.
+ */
+static struct u_trace_chunk *
+pop_free_chunk(struct u_trace_context *utctx)
+{
+   struct u_trace_chunk *chunk = take_free_chunks(utctx);
+   if (!chunk)
+      return NULL;
+
+   p_atomic_dec(&utctx->num_free_chunks);
+
+   if (chunk->next_free) {
+      struct u_trace_chunk *last = chunk->next_free;
+      while (last->next_free)
+         last = last->next_free;
+      push_free_chunks(utctx, chunk->next_free, last);
+   }
+
+   return chunk;
+}
+
+/* Returns a chunk which is no longer used to the free_chunks stack, or
+ * destroys it if the stack is full.
+ */
+static void
+free_chunk(void *ptr)
+{
+   struct u_trace_chunk *chunk = ptr;
+   struct u_trace_context *utctx = chunk->utctx;
+
+   list_del(&chunk->node);
+
+   if (p_atomic_inc_return(&utctx->num_free_chunks) > MAX_FREE_CHUNKS) {
+      p_atomic_dec(&utctx->num_free_chunks);
+      destroy_chunk(chunk);
+      return;
+   }
+
+   /* Unref payloads attached to this chunk, keeping the vector storage. */
+   struct u_trace_payload_buf **payload;
+   while ((payload = u_vector_remove(&chunk->payloads)))
+      u_trace_payload_buf_unref(*payload);
+   chunk->payload = NULL;
+
+   push_free_chunks(utctx, chunk, chunk);
+}
+
 static void
 free_chunks(struct list_head *chunks)
 {
@@ -411,21 +503,32 @@ get_chunk(struct u_trace *ut, size_t payload_size)
       chunk->last = false;
    }
 
-   /* .. if not, then create a new one: */
-   chunk = calloc(1, sizeof(*chunk));
+   /* .. if not, then reuse a processed one or create a new one: */
+   chunk = pop_free_chunk(ut->utctx);
+   if (chunk) {
+      chunk->num_traces = 0;
+      chunk->has_indirect = false;
+      chunk->eof = false;
+      chunk->frame_nr = 0;
+      chunk->flush_data = NULL;
+      chunk->free_flush_data = false;
+   } else {
+      chunk = calloc(1, sizeof(*chunk));
+
+      chunk->utctx = ut->utctx;
+      chunk->timestamps =
+         ut->utctx->create_buffer(ut->utctx,
+                                  chunk->utctx->timestamp_size_bytes * TIMESTAMP_BUF_SIZE);
+      u_vector_init(&chunk->payloads, 4, sizeof(struct u_trace_payload_buf *));
+   }
 
-   chunk->utctx = ut->utctx;
-   chunk->timestamps =
-      ut->utctx->create_buffer(ut->utctx,
-                               chunk->utctx->timestamp_size_bytes * TIMESTAMP_BUF_SIZE);
-   if (chunk->utctx->max_indirect_size_bytes &&
+   if (!chunk->indirects && chunk->utctx->max_indirect_size_bytes &&
        (chunk->utctx->enabled_traces & U_TRACE_TYPE_INDIRECTS)) {
       chunk->indirects =
          ut->utctx->create_buffer(ut->utctx,
                                   chunk->utctx->max_indirect_size_bytes * TIMESTAMP_BUF_SIZE);
    }
    chunk->last = true;
-   u_vector_init(&chunk->payloads, 4, sizeof(struct u_trace_payload_buf *));
    if (payload_size > 0) {
       struct u_trace_payload_buf **buf = u_vector_add(&chunk->payloads);
       *buf = u_trace_payload_buf_create();
@@ -546,6 +649,8 @@ u_trace_context_init(struct u_trace_context *utctx,
    utctx->dummy_indirect_data = calloc(1, max_indirect_size_bytes);
 
    list_inithead(&utctx->flushed_trace_chunks);
+   utctx->free_chunks = NULL;
+   utctx->num_free_chunks = 0;
 
    if (utctx->enabled_traces & U_TRACE_TYPE_PRINT) {
       utctx->out = u_trace_state.trace_file;
@@ -604,11 +709,18 @@ u_trace_context_fini(struct u_trace_context *utctx)
 
    free (utctx->dummy_indirect_data);
 
-   if (!utctx->queue.jobs)
-      return;
-   util_queue_finish(&utctx->queue);
-   util_queue_destroy(&utctx->queue);
+   if (utctx->queue.jobs) {
+      util_queue_finish(&utctx->queue);
+      util_queue_destroy(&utctx->queue);
+   }
    free_chunks(&utctx->flushed_trace_chunks);
+
+   struct u_trace_chunk *chunk = take_free_chunks(utctx);
+   while (chunk) {
+      struct u_trace_chunk *next = chunk->next_free;
+      destroy_chunk(chunk);
+      chunk = next;
+   }
 }
 
 #ifdef HAVE_PERFETTO
@@ -647,9 +759,8 @@ u_trace_perfetto_stop(void)
 #endif
 
 static void
-process_chunk(void *job, void *gdata, int thread_index)
+process_chunk(struct u_trace_chunk *chunk)
 {
-   struct u_trace_chunk *chunk = job;
    struct u_trace_context *utctx = chunk->utctx;
 
    if (chunk->frame_nr != U_TRACE_FRAME_UNKNOWN &&
@@ -754,9 +865,22 @@ process_chunk(void *job, void *gdata, int thread_index)
 }
 
 static void
-cleanup_chunk(void *job, void *gdata, int thread_index)
+process_chunks(void *data, void *gdata, int thread_index)
+{
+   struct u_trace_process_job *job = data;
+
+   list_for_each_entry (struct u_trace_chunk, chunk, &job->chunks, node)
+      process_chunk(chunk);
+}
+
+static void
+cleanup_chunks(void *data, void *gdata, int thread_index)
 {
-   free_chunk(job);
+   struct u_trace_process_job *job = data;
+
+   free_chunks(&job->chunks);
+   util_queue_fence_destroy(&job->fence);
+   free(job);
 }
 
 void
@@ -771,18 +895,18 @@ u_trace_context_process(struct u_trace_context *utctx, bool eof)
       list_last_entry(chunks, struct u_trace_chunk, node);
    last_chunk->eof = eof;
 
-   while (!list_is_empty(chunks)) {
-      struct u_trace_chunk *chunk =
-         list_first_entry(chunks, struct u_trace_chunk, node);
-
-      /* remove from list before enqueuing, because chunk is freed
-       * once it is processed by the queue:
-       */
-      list_delinit(&chunk->node);
-
-      util_queue_add_job(&utctx->queue, chunk, &chunk->fence, process_chunk,
-                         cleanup_chunk, TIMESTAMP_BUF_SIZE);
-   }
+   /* All of the flushed chunks are processed by a single job, so the
+    * timestamps of many batches are read back with one wakeup of the queue
+    * thread instead of one per chunk.
+    */
+   struct u_trace_process_job *job = calloc(1, sizeof(*job));
+   util_queue_fence_init(&job->fence);
+   list_replace(chunks, &job->chunks);
+   list_inithead(chunks);
+
+   util_queue_add_job(&utctx->queue, job, &job->fence, process_chunks,
+                      cleanup_chunks,
+                      TIMESTAMP_BUF_SIZE * list_length(&job->chunks));
 }
 
 void
@@ -256,6 +256,12 @@ struct u_trace_context {
 
    /* list of unprocessed trace chunks in fifo order: */
    struct list_head flushed_trace_chunks;
+
+   /* Processed trace chunks kept for reuse along with their buffers, as a
+    * lock-free stack linked through u_trace_chunk::next_free.
+    */
+   struct u_trace_chunk *free_chunks;
+   uint32_t num_free_chunks;
 };
 
 /**
@@ -28,8 +28,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "c11/threads.h"
 #include "util/list.h"
 #include "util/macros.h"
+#include "util/simple_mtx.h"
 #include "util/u_math.h"
 #include "util/u_printf.h"
 
@@ -664,6 +666,10 @@ struct gc_ctx {
 
    uint8_t current_gen;
    void *rubbish;
+
+   /* Only initialized while thread_safe is set. */
+   bool thread_safe;
+   simple_mtx_t lock;
 };
 
 static gc_block_header *
@@ -839,6 +845,27 @@ create_slab(gc_ctx *ctx, unsigned bucket)
    return slab;
 }
 
+static gc_block_header *
+gc_alloc_header(gc_ctx *ctx, size_t size)
+{
+   gc_block_header *header;
+   if (size <= MAX_FREELIST_SIZE) {
+      uint32_t bucket = gc_bucket_for_size((uint32_t)size);
+      if (list_is_empty(&ctx->slabs[bucket].free_slabs) && !create_slab(ctx, bucket))
+         return NULL;
+      gc_slab *slab = list_first_entry(&ctx->slabs[bucket].free_slabs, gc_slab, free_link);
+      header = alloc_from_slab(slab, bucket);
+   } else {
+      header = ralloc_size(ctx, size);
+      if (unlikely(!header))
+         return NULL;
+      /* Mark the header as allocated directly, so we know to actually free it. */
+      header->bucket = NUM_FREELIST_BUCKETS;
+   }
+
+   return header;
+}
+
 void *
 gc_alloc_size(gc_ctx *ctx, size_t size, size_t alignment)
 {
@@ -859,20 +886,16 @@ gc_alloc_size(gc_ctx *ctx, size_t size, size_t alignment)
    size = align64(size, alignment);
    size += header_size;
 
-   gc_block_header *header = NULL;
-   if (size <= MAX_FREELIST_SIZE) {
-      uint32_t bucket = gc_bucket_for_size((uint32_t)size);
-      if (list_is_empty(&ctx->slabs[bucket].free_slabs) && !create_slab(ctx, bucket))
-         return NULL;
-      gc_slab *slab = list_first_entry(&ctx->slabs[bucket].free_slabs, gc_slab, free_link);
-      header = alloc_from_slab(slab, bucket);
-   } else {
-      header = ralloc_size(ctx, size);
-      if (unlikely(!header))
-         return NULL;
-      /* Mark the header as allocated directly, so we know to actually free it. */
-      header->bucket = NUM_FREELIST_BUCKETS;
-   }
+   if (unlikely(ctx->thread_safe))
+      simple_mtx_lock(&ctx->lock);
+
+   gc_block_header *header = gc_alloc_header(ctx, size);
+
+   if (unlikely(ctx->thread_safe))
+      simple_mtx_unlock(&ctx->lock);
+
+   if (unlikely(!header))
+      return NULL;
 
    header->flags = ctx->current_gen | IS_USED;
 #ifndef NDEBUG
@@ -905,12 +928,20 @@ gc_free(void *ptr)
       return;
 
    gc_block_header *header = get_gc_header(ptr);
+   gc_ctx *ctx = gc_get_context(ptr);
+
+   if (unlikely(ctx->thread_safe))
+      simple_mtx_lock(&ctx->lock);
+
    header->flags &= ~IS_USED;
 
    if (header->bucket < NUM_FREELIST_BUCKETS)
       free_from_slab(header, true);
    else
       ralloc_free(header);
+
+   if (unlikely(ctx->thread_safe))
+      simple_mtx_unlock(&ctx->lock);
 }
 
 gc_ctx *gc_get_context(void *ptr)
@@ -923,6 +954,20 @@ gc_ctx *gc_get_context(void *ptr)
       return ralloc_parent(header);
 }
 
+void
+gc_set_thread_safe(gc_ctx *ctx, bool thread_safe)
+{
+   if (ctx->thread_safe == thread_safe)
+      return;
+
+   if (thread_safe)
+      simple_mtx_init(&ctx->lock, mtx_plain);
+   else
+      simple_mtx_destroy(&ctx->lock);
+
+   ctx->thread_safe = thread_safe;
+}
+
 void
 gc_sweep_start(gc_ctx *ctx)
 {
@@ -1017,10 +1062,137 @@ struct linear_ctx {
    unsigned offset;  /* points to the first unused byte in the latest buffer */
    unsigned size;    /* size of the latest buffer */
    void *latest;     /* the only buffer that has free space */
+
+   bool arena;
+   struct linear_arena_buffer *arena_buffers; /* extra buffers in arena mode */
 };
 
 typedef struct linear_ctx linear_ctx;
 
+/* In arena mode the extra buffers aren't ralloc children of the linear
+ * context. They are malloc'ed with this small header instead, chained in
+ * the context and moved to a per-thread cache when the context is freed,
+ * so that the next context on the same thread doesn't have to malloc them.
+ */
+#define LINEAR_ARENA_MAX_BUFFER_SIZE (256 * 1024)
+#define LINEAR_ARENA_CACHE_SIZE (2 * 1024 * 1024)
+
+struct linear_arena_buffer {
+   alignas(HEADER_ALIGN)
+   struct linear_arena_buffer *next;
+   unsigned size;    /* size of the buffer without this header */
+};
+
+struct linear_arena_cache {
+   struct linear_arena_buffer *buffers;
+   unsigned size;
+};
+
+static once_flag linear_arena_once_flag = ONCE_FLAG_INIT;
+static tss_t linear_arena_cache_key;
+static bool linear_arena_cache_key_valid;
+
+static void
+linear_arena_cache_destroy(void *data)
+{
+   struct linear_arena_cache *cache = data;
+
+   while (cache->buffers) {
+      struct linear_arena_buffer *next = cache->buffers->next;
+      free(cache->buffers);
+      cache->buffers = next;
+   }
+   free(cache);
+}
+
+static void
+linear_arena_init_once(void)
+{
+   linear_arena_cache_key_valid =
+      tss_create(&linear_arena_cache_key, linear_arena_cache_destroy) == thrd_success;
+}
+
+static struct linear_arena_cache *
+linear_arena_get_cache(bool create)
+{
+   call_once(&linear_arena_once_flag, linear_arena_init_once);
+   if (!linear_arena_cache_key_valid)
+      return NULL;
+
+   struct linear_arena_cache *cache = tss_get(linear_arena_cache_key);
+   if (!cache && create) {
+      cache = calloc(1, sizeof(*cache));
+      if (cache && tss_set(linear_arena_cache_key, cache) != thrd_success) {
+         free(cache);
+         cache = NULL;
+      }
+   }
+
+   return cache;
+}
+
+/* Return a buffer of at least *size bytes and update *size to its actual
+ * size.
+ */
+static void *
+linear_arena_alloc_buffer(linear_ctx *ctx, unsigned *size)
+{
+   struct linear_arena_cache *cache = linear_arena_get_cache(false);
+   struct linear_arena_buffer *buffer = NULL;
+
+   if (cache) {
+      /* Pick the smallest cached buffer that is large enough. */
+      struct linear_arena_buffer **best = NULL;
+
+      for (struct linear_arena_buffer **iter = &cache->buffers; *iter;
+           iter = &(*iter)->next) {
+         if ((*iter)->size >= *size && (!best || (*iter)->size < (*best)->size))
+            best = iter;
+      }
+
+      if (best) {
+         buffer = *best;
+         *best = buffer->next;
+         cache->size -= buffer->size;
+      }
+   }
+
+   if (!buffer) {
+      buffer = malloc(sizeof(struct linear_arena_buffer) + *size);
+      if (unlikely(!buffer))
+         return NULL;
+
+      buffer->size = *size;
+   }
+
+   buffer->next = ctx->arena_buffers;
+   ctx->arena_buffers = buffer;
+
+   *size = buffer->size;
+   return &buffer[1];
+}
+
+static void
+linear_arena_destructor(void *ptr)
+{
+   linear_ctx *ctx = ptr;
+   struct linear_arena_cache *cache =
+      ctx->arena_buffers ? linear_arena_get_cache(true) : NULL;
+
+   while (ctx->arena_buffers) {
+      struct linear_arena_buffer *buffer = ctx->arena_buffers;
+      ctx->arena_buffers = buffer->next;
+
+      if (cache && cache->size + buffer->size <= LINEAR_ARENA_CACHE_SIZE) {
+         buffer->next = cache->buffers;
+         cache->buffers = buffer;
+         cache->size += buffer->size;
+      } else {
+         free(buffer);
+      }
+   }
+}
+
 #ifndef NDEBUG
 struct linear_node_canary {
    alignas(HEADER_ALIGN)
@@ -1063,12 +1235,26 @@ linear_alloc_child(linear_ctx *ctx, unsigned size)
          node_size = ctx->min_buffer_size;
 
       const unsigned canary_size = get_node_canary_size();
-      const unsigned full_size = canary_size + node_size;
-
-      /* linear context is also a ralloc context */
-      char *ptr = ralloc_size(ctx, full_size);
-      if (unlikely(!ptr))
-         return NULL;
+      unsigned full_size = canary_size + node_size;
+      char *ptr;
+
+      if (ctx->arena) {
+         ptr = linear_arena_alloc_buffer(ctx, &full_size);
+         if (unlikely(!ptr))
+            return NULL;
+
+         /* A recycled buffer can be larger than requested. */
+         node_size = full_size - canary_size;
+
+         if (ctx->min_buffer_size < LINEAR_ARENA_MAX_BUFFER_SIZE)
+            ctx->min_buffer_size = MIN2(ctx->min_buffer_size * 2,
+                                        LINEAR_ARENA_MAX_BUFFER_SIZE);
+      } else {
+         /* linear context is also a ralloc context */
+         ptr = ralloc_size(ctx, full_size);
+         if (unlikely(!ptr))
+            return NULL;
+      }
 
 #ifndef NDEBUG
       linear_node_canary *canary = (void *) ptr;
@@ -1137,6 +1323,11 @@ linear_context_with_opts(void *ralloc_ctx, const linear_opts *opts)
 
    ctx->min_buffer_size = min_buffer_size;
 
+   ctx->arena = opts->arena;
+   ctx->arena_buffers = NULL;
+   if (ctx->arena)
+      ralloc_set_destructor(ctx, linear_arena_destructor);
+
    ctx->offset = 0;
    ctx->size = size;
    ctx->latest = (char *)&ctx[1] + canary_size;
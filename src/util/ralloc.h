@@ -518,6 +518,14 @@ void *gc_zalloc_size(gc_ctx *ctx, size_t size, size_t alignment) MALLOCLIKE;
 void gc_free(void *ptr);
 gc_ctx *gc_get_context(void *ptr);
 
+/**
+ * Make gc_alloc*() and gc_free() safe to call from several threads at once,
+ * e.g. while passes run on different functions of a shader in parallel. This
+ * takes a lock for every allocation and free, so it should only be enabled
+ * as long as it's needed. The mark-and-sweep interface is never thread-safe.
+ */
+void gc_set_thread_safe(gc_ctx *ctx, bool thread_safe);
+
 void gc_sweep_start(gc_ctx *ctx);
 void gc_mark_live(gc_ctx *ctx, const void *mem);
 void gc_sweep_end(gc_ctx *ctx);
@@ -612,6 +620,13 @@ void *linear_alloc_child(linear_ctx *ctx, unsigned size);
 
 typedef struct {
    unsigned min_buffer_size;
+
+   /* Allocate the extra buffers without ralloc, grow their size
+    * geometrically and recycle them through a per-thread cache when the
+    * context is freed. Meant for short-lived contexts with many
+    * allocations, e.g. the ones used for a single shader compilation.
+    */
+   bool arena;
 } linear_opts;
 
 /**
@@ -58,6 +58,35 @@ uint32_t
 range_minimum_query(struct range_minimum_query_table *const table,
                     uint32_t left_idx, uint32_t right_idx);
 
+/**
+ * Find the lowest common ancestor of two nodes of a tree, such as a dominance
+ * tree, in constant time.
+ *
+ * The nodes must be numbered densely in preorder starting at 0 for the root,
+ * and the first row of the table must hold the preorder index of each node's
+ * parent, with 0 for the root itself, before it is preprocessed.
+ *
+ * For a < b, the nodes in (a, b] all lie in the subtree of the LCA and the
+ * path from the LCA to b enters that range through a child of the LCA, so
+ * the smallest parent index in the range is the LCA. Unlike an Euler tour
+ * this needs only one entry per node.
+ */
+static inline uint32_t
+range_minimum_query_tree_lca(struct range_minimum_query_table *const table,
+                             uint32_t a, uint32_t b)
+{
+   if (a == b)
+      return a;
+
+   if (a > b) {
+      uint32_t tmp = a;
+      a = b;
+      b = tmp;
+   }
+
+   return range_minimum_query(table, a + 1, b + 1);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -609,6 +609,8 @@ ra_realloc_interference_graph(struct ra_graph *g, unsigned int alloc)
    g->tmp.reg_assigned = reralloc(g, g->tmp.reg_assigned, BITSET_WORD,
                                   bitset_count);
    g->tmp.pq_test = reralloc(g, g->tmp.pq_test, BITSET_WORD, bitset_count);
+   g->tmp.pq_words = reralloc(g, g->tmp.pq_words, BITSET_WORD,
+                              BITSET_WORDS(bitset_count));
    g->tmp.min_q_total = reralloc(g, g->tmp.min_q_total, unsigned int,
                                  bitset_count);
    g->tmp.min_q_node = reralloc(g, g->tmp.min_q_node, unsigned int,
@@ -701,6 +703,7 @@ update_pq_info(struct ra_graph *g, unsigned int n)
    int n_class = g->nodes[n].class;
    if (g->nodes[n].tmp.q_total < g->regs->classes[n_class]->p) {
       BITSET_SET(g->tmp.pq_test, n);
+      BITSET_SET(g->tmp.pq_words, i);
    } else if (g->tmp.min_q_total[i] != UINT_MAX) {
       /* Only update min_q_total and min_q_node if min_q_total != UINT_MAX so
        * that we don't update while we have stale data and accidentally mark
@@ -745,6 +748,96 @@ add_node_to_stack(struct ra_graph *g, unsigned int n)
    g->tmp.min_q_total[n / BITSET_WORDBITS] = UINT_MAX;
 }
 
+/**
+ * Returns the highest node below \p limit that passed the pq test and isn't
+ * in the stack or pre-assigned, or UINT_MAX if there is none.
+ */
+static unsigned int
+ra_find_pq_node_below(struct ra_graph *g, unsigned int limit)
+{
+   if (limit == 0)
+      return UINT_MAX;
+
+   const unsigned int last = limit - 1;
+   int w = last / BITSET_WORDBITS;
+   int sw = w / BITSET_WORDBITS;
+   BITSET_WORD sw_mask = ~(BITSET_WORD)0 >> (31 - w % BITSET_WORDBITS);
+
+   for (; sw >= 0; sw--, sw_mask = ~(BITSET_WORD)0) {
+      BITSET_WORD words = g->tmp.pq_words[sw] & sw_mask;
+
+      while (words) {
+         int i = sw * BITSET_WORDBITS + util_last_bit(words) - 1;
+         BITSET_WORD pq = g->tmp.pq_test[i] &
+                          ~(g->tmp.in_stack[i] | g->tmp.reg_assigned[i]);
+         BITSET_WORD mask = ~(BITSET_WORD)0;
+
+         if (i == w)
+            mask >>= 31 - last % BITSET_WORDBITS;
+
+         if (pq & mask)
+            return i * BITSET_WORDBITS + util_last_bit(pq & mask) - 1;
+
+         /* Nothing left to push from this word, drop it from the search. */
+         if (!pq)
+            BITSET_CLEAR(g->tmp.pq_words, i);
+
+         words &= ~BITSET_BIT(i % BITSET_WORDBITS);
+      }
+   }
+
+   return UINT_MAX;
+}
+
+/**
+ * Returns the node not in the stack or pre-assigned with the lowest q total,
+ * preferring the highest node index on ties, or UINT_MAX if there is none.
+ */
+static unsigned int
+ra_find_optimistic_node(struct ra_graph *g)
+{
+   unsigned int min_q_total = UINT_MAX;
+   unsigned int min_q_node = UINT_MAX;
+
+   /* Figure out the high bit and bit mask for the first iteration of a loop
+    * over BITSET_WORDs.
+    */
+   const unsigned int top_word_high_bit = (g->count - 1) % BITSET_WORDBITS;
+
+   for (int i = BITSET_WORDS(g->count) - 1, high_bit = top_word_high_bit;
+        i >= 0; i--, high_bit = BITSET_WORDBITS - 1) {
+      BITSET_WORD mask = ~(BITSET_WORD)0 >> (31 - high_bit);
+
+      BITSET_WORD skip = g->tmp.in_stack[i] | g->tmp.reg_assigned[i];
+      if (skip == mask)
+         continue;
+
+      if (g->tmp.min_q_total[i] == UINT_MAX) {
+         /* The min_q_total and min_q_node are dirty because we added
+          * one of these nodes to the stack.  It needs to be
+          * recalculated.
+          */
+         for (int j = high_bit; j >= 0; j--) {
+            if (skip & BITSET_BIT(j))
+               continue;
+
+            unsigned int n = i * BITSET_WORDBITS + j;
+            assert(n < g->count);
+            if (g->nodes[n].tmp.q_total < g->tmp.min_q_total[i]) {
+               g->tmp.min_q_total[i] = g->nodes[n].tmp.q_total;
+               g->tmp.min_q_node[i] = n;
+            }
+         }
+      }
+      if (g->tmp.min_q_total[i] < min_q_total) {
+         min_q_node = g->tmp.min_q_node[i];
+         min_q_total = g->tmp.min_q_total[i];
+      }
+   }
+
+   return min_q_node;
+}
+
 /**
  * Simplifies the interference graph by pushing all
  * trivially-colorable nodes into a stack of nodes to be colored,
@@ -758,7 +851,6 @@ add_node_to_stack(struct ra_graph *g, unsigned int n)
 static void
 ra_simplify(struct ra_graph *g)
 {
-   bool progress = true;
    unsigned int stack_optimistic_start = UINT_MAX;
 
    /* Figure out the high bit and bit mask for the first iteration of a loop
@@ -768,6 +860,8 @@ ra_simplify(struct ra_graph *g)
 
    /* Do a quick pre-pass to set things up */
    g->tmp.stack_count = 0;
+   memset(g->tmp.pq_words, 0,
+          BITSET_BYTES(BITSET_WORDS(g->count)));
    for (int i = BITSET_WORDS(g->count) - 1, high_bit = top_word_high_bit;
         i >= 0; i--, high_bit = BITSET_WORDBITS - 1) {
       g->tmp.in_stack[i] = 0;
@@ -785,72 +879,38 @@ ra_simplify(struct ra_graph *g)
       }
    }
 
-   while (progress) {
-      unsigned int min_q_total = UINT_MAX;
-      unsigned int min_q_node = UINT_MAX;
-
-      progress = false;
-
-      for (int i = BITSET_WORDS(g->count) - 1, high_bit = top_word_high_bit;
-           i >= 0; i--, high_bit = BITSET_WORDBITS - 1) {
-         BITSET_WORD mask = ~(BITSET_WORD)0 >> (31 - high_bit);
-
-         BITSET_WORD skip = g->tmp.in_stack[i] | g->tmp.reg_assigned[i];
-         if (skip == mask)
-            continue;
-
-         BITSET_WORD pq = g->tmp.pq_test[i] & ~skip;
-         if (pq) {
-            /* In this case, we have stuff we can immediately take off the
-             * stack.  This also means that we're guaranteed to make progress
-             * and we don't need to bother updating lowest_q_total because we
-             * know we're going to loop again before attempting to do anything
-             * optimistic.
-             */
-            for (int j = high_bit; j >= 0; j--) {
-               if (pq & BITSET_BIT(j)) {
-                  unsigned int n = i * BITSET_WORDBITS + j;
-                  assert(n < g->count);
-                  add_node_to_stack(g, n);
-                  /* add_node_to_stack() may update pq_test for this word so
-                   * we need to update our local copy.
-                   */
-                  pq = g->tmp.pq_test[i] & ~skip;
-                  progress = true;
-               }
-            }
-         } else if (!progress) {
-            if (g->tmp.min_q_total[i] == UINT_MAX) {
-               /* The min_q_total and min_q_node are dirty because we added
-                * one of these nodes to the stack.  It needs to be
-                * recalculated.
-                */
-               for (int j = high_bit; j >= 0; j--) {
-                  if (skip & BITSET_BIT(j))
-                     continue;
-
-                  unsigned int n = i * BITSET_WORDBITS + j;
-                  assert(n < g->count);
-                  if (g->nodes[n].tmp.q_total < g->tmp.min_q_total[i]) {
-                     g->tmp.min_q_total[i] = g->nodes[n].tmp.q_total;
-                     g->tmp.min_q_node[i] = n;
-                  }
-               }
-            }
-            if (g->tmp.min_q_total[i] < min_q_total) {
-               min_q_node = g->tmp.min_q_node[i];
-               min_q_total = g->tmp.min_q_total[i];
-            }
-         }
+   /* Trivially colorable nodes are pushed in sweeps going from the highest
+    * node index down.  Nodes that become trivially colorable behind the
+    * current position are picked up by the next sweep, and only once a whole
+    * sweep finds nothing do we fall back to an optimistic choice.
+    *
+    * pq_words lets each step jump straight to the next word with candidates
+    * instead of rescanning the whole graph for every node pushed.
+    */
+   unsigned int limit = g->count;
+   while (true) {
+      unsigned int n = ra_find_pq_node_below(g, limit);
+
+      if (n == UINT_MAX && limit != g->count) {
+         /* Start a new sweep from the top. */
+         limit = g->count;
+         continue;
       }
 
-      if (!progress && min_q_total != UINT_MAX) {
+      if (n == UINT_MAX) {
+         n = ra_find_optimistic_node(g);
+         if (n == UINT_MAX)
+            break;
+
          if (stack_optimistic_start == UINT_MAX)
             stack_optimistic_start = g->tmp.stack_count;
 
-         add_node_to_stack(g, min_q_node);
-         progress = true;
+         add_node_to_stack(g, n);
+         continue;
       }
+
+      add_node_to_stack(g, n);
+      limit = n;
    }
 
    g->tmp.stack_optimistic_start = stack_optimistic_start;
@@ -167,6 +167,12 @@ struct ra_graph {
       /** Bit-set indicating, for each register, the value of the pq test */
       BITSET_WORD *pq_test;
 
+      /**
+       * Bit-set indicating, for each BITSET_WORD of pq_test, if it may have
+       * nodes that passed the pq test and aren't in the stack yet.
+       */
+      BITSET_WORD *pq_words;
+
       /** For each BITSET_WORD, the minimum q value or ~0 if unknown */
       unsigned int *min_q_total;
 
@@ -31,6 +31,9 @@
 #define SLAB_MAGIC_ALLOCATED 0xcafe4321
 #define SLAB_MAGIC_FREE 0x7ee01234
 
+/* Maximum number of elements of other pools held by a child pool. */
+#define SLAB_MAX_FOREIGN 32
+
 #ifndef NDEBUG
 #define SET_MAGIC(element, value)   (element)->magic = (value)
 #define CHECK_MAGIC(element, value) assert((element)->magic == (value))
@@ -95,6 +98,45 @@ slab_free_orphaned(struct slab_element_header *elt)
       free(page);
 }
 
+/* Return the elements of other pools that were freed with this pool to
+ * their owners.
+ */
+static void
+slab_flush_foreign(struct slab_child_pool *pool)
+{
+   struct slab_element_header *orphaned = NULL;
+
+   simple_mtx_lock(&pool->parent->mutex);
+
+   while (pool->foreign) {
+      struct slab_element_header *elt = pool->foreign;
+      pool->foreign = elt->next;
+
+      /* Note: we _must_ read elt->owner under the mutex because the owning
+       * child pool may be destroyed by another thread in the meantime.
+       */
+      intptr_t owner_int = p_atomic_read(&elt->owner);
+
+      if (!(owner_int & 1)) {
+         struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
+         elt->next = owner->migrated;
+         owner->migrated = elt;
+      } else {
+         elt->next = orphaned;
+         orphaned = elt;
+      }
+   }
+   pool->num_foreign = 0;
+
+   simple_mtx_unlock(&pool->parent->mutex);
+
+   while (orphaned) {
+      struct slab_element_header *elt = orphaned;
+      orphaned = elt->next;
+      slab_free_orphaned(elt);
+   }
+}
+
 /**
  * Create a parent pool for the allocation of same-sized objects.
  *
@@ -129,6 +171,8 @@ void slab_create_child(struct slab_child_pool *pool,
    pool->pages = NULL;
    pool->free = NULL;
    pool->migrated = NULL;
+   pool->foreign = NULL;
+   pool->num_foreign = 0;
 }
 
 /**
@@ -142,6 +186,9 @@ void slab_destroy_child(struct slab_child_pool *pool)
    if (!pool->parent)
       return; /* the slab probably wasn't even created */
 
+   if (pool->foreign)
+      slab_flush_foreign(pool);
+
    simple_mtx_lock(&pool->parent->mutex);
 
    while (pool->pages) {
@@ -209,6 +256,12 @@ slab_alloc(struct slab_child_pool *pool)
    struct slab_element_header *elt;
 
    if (!pool->free) {
+      /* Give the elements of other pools back, so that their owners can
+       * reuse them instead of allocating new pages.
+       */
+      if (pool->foreign)
+         slab_flush_foreign(pool);
+
       /* First, collect elements that belong to us but were freed from a
        * different child pool.
        */
@@ -250,7 +303,8 @@ slab_zalloc(struct slab_child_pool *pool)
  *
  * Freeing an object in a different child pool from the one where it was
  * allocated is allowed, as long the pool belong to the same parent. No
- * additional locking is required in this case.
+ * additional locking is required in this case. Such objects are returned
+ * to their owner in batches of SLAB_MAX_FOREIGN.
  */
 void slab_free(struct slab_child_pool *pool, void *ptr)
 {
@@ -270,26 +324,27 @@ void slab_free(struct slab_child_pool *pool, void *ptr)
    }
 
    /* The slow case: migration or an orphaned page. */
-   if (pool->parent)
-      simple_mtx_lock(&pool->parent->mutex);
-
-   /* Note: we _must_ re-read elt->owner here because the owning child pool
-    * may have been destroyed by another thread in the meantime.
-    */
    owner_int = p_atomic_read(&elt->owner);
 
-   if (!(owner_int & 1)) {
-      struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
-      elt->next = owner->migrated;
-      owner->migrated = elt;
-      if (pool->parent)
-         simple_mtx_unlock(&pool->parent->mutex);
-   } else {
-      if (pool->parent)
-         simple_mtx_unlock(&pool->parent->mutex);
-
+   /* Orphaned pages never get an owner again, so no lock is needed. */
+   if (owner_int & 1) {
       slab_free_orphaned(elt);
+      return;
    }
+
+   if (pool->parent) {
+      elt->next = pool->foreign;
+      pool->foreign = elt;
+
+      if (++pool->num_foreign >= SLAB_MAX_FOREIGN)
+         slab_flush_foreign(pool);
+      return;
+   }
+
+   /* The pool has been destroyed, so there is no mutex to lock. */
+   struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
+   elt->next = owner->migrated;
+   owner->migrated = elt;
 }
 
 /**
@@ -72,6 +72,14 @@ struct slab_child_pool {
     * This list is protected by the parent mutex.
     */
    struct slab_element_header *migrated;
+
+   /* Elements owned by other pools that were freed with this pool as the
+    * argument to slab_free. They are moved to the migrated lists of their
+    * owners in batches, so that the parent mutex isn't locked for every
+    * single one.
+    */
+   struct slab_element_header *foreign;
+   unsigned num_foreign;
 };
 
 void slab_create_parent(struct slab_parent_pool *parent,
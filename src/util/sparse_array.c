@@ -91,6 +91,7 @@ util_sparse_array_finish(struct util_sparse_array *arr)
 {
    if (arr->root)
       _util_sparse_array_node_finish(arr, arr->root);
+   free(arr->flat_leaves);
 }
 
 static inline uintptr_t
@@ -128,8 +129,32 @@ _util_sparse_array_set_or_free_node(uintptr_t *node_ptr,
    }
 }
 
+static void
+_util_sparse_array_set_flat_leaf(struct util_sparse_array *arr,
+                                 uint64_t leaf_idx, void *leaf)
+{
+   void **flat_leaves = p_atomic_read(&arr->flat_leaves);
+   if (unlikely(!flat_leaves)) {
+      void **new_leaves = calloc(UTIL_SPARSE_ARRAY_FLAT_LEAVES,
+                                 sizeof(*new_leaves));
+      if (!new_leaves)
+         return;
+
+      flat_leaves = p_atomic_cmpxchg_ptr(&arr->flat_leaves, NULL, new_leaves);
+      if (flat_leaves) {
+         /* We lost the race, use the table that is already there. */
+         free(new_leaves);
+      } else {
+         flat_leaves = new_leaves;
+      }
+   }
+
+   /* A given leaf never moves, so racing threads all store the same value. */
+   p_atomic_set(&flat_leaves[leaf_idx], leaf);
+}
+
 void *
-util_sparse_array_get(struct util_sparse_array *arr, uint64_t idx)
+_util_sparse_array_get_slow(struct util_sparse_array *arr, uint64_t idx)
 {
    const unsigned node_size_log2 = arr->node_size_log2;
    uintptr_t root = p_atomic_read(&arr->root);
@@ -187,10 +212,38 @@ util_sparse_array_get(struct util_sparse_array *arr, uint64_t idx)
       node_level = _util_sparse_array_node_level(child);
    }
 
+   uint64_t leaf_idx = idx >> node_size_log2;
+   if (leaf_idx < UTIL_SPARSE_ARRAY_FLAT_LEAVES)
+      _util_sparse_array_set_flat_leaf(arr, leaf_idx, node_data);
+
    uint64_t elem_idx = idx & ((1ull << node_size_log2) - 1);
    return (void *)((char *)node_data + (elem_idx * arr->elem_size));
 }
 
+void
+util_sparse_array_get_many(struct util_sparse_array *arr,
+                           const uint32_t *idx, unsigned count,
+                           void **elems)
+{
+   const unsigned node_size_log2 = arr->node_size_log2;
+   const uint64_t elem_mask = (1ull << node_size_log2) - 1;
+   uint64_t last_leaf_idx = UINT64_MAX;
+   char *leaf = NULL;
+
+   for (unsigned i = 0; i < count; i++) {
+      uint64_t leaf_idx = idx[i] >> node_size_log2;
+      uint64_t elem_idx = idx[i] & elem_mask;
+
+      if (leaf_idx != last_leaf_idx) {
+         char *elem = util_sparse_array_get(arr, idx[i]);
+         leaf = elem - elem_idx * arr->elem_size;
+         last_leaf_idx = leaf_idx;
+      }
+
+      elems[i] = leaf + elem_idx * arr->elem_size;
+   }
+}
+
 static void
 validate_node_level(struct util_sparse_array *arr,
                     uintptr_t node, unsigned level)
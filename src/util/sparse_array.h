@@ -70,14 +70,52 @@ struct util_sparse_array {
    unsigned node_size_log2;
 
    uintptr_t root;
+
+   /** Table of the first UTIL_SPARSE_ARRAY_FLAT_LEAVES leaf nodes
+    *
+    * Small indices are by far the most common (GEM handles, GL names, ...)
+    * so their leaf nodes are also recorded here as they get looked up,
+    * letting util_sparse_array_get() skip the walk down the tree.  It is
+    * allocated along with the first of those leaves.
+    */
+   void **flat_leaves;
 };
 
+#define UTIL_SPARSE_ARRAY_FLAT_LEAVES 64
+
 void util_sparse_array_init(struct util_sparse_array *arr,
                             size_t elem_size, size_t node_size);
 
 void util_sparse_array_finish(struct util_sparse_array *arr);
 
-void *util_sparse_array_get(struct util_sparse_array *arr, uint64_t idx);
+void *_util_sparse_array_get_slow(struct util_sparse_array *arr, uint64_t idx);
+
+static inline void *
+util_sparse_array_get(struct util_sparse_array *arr, uint64_t idx)
+{
+   const uint64_t leaf_idx = idx >> arr->node_size_log2;
+   void **flat_leaves = (void **)p_atomic_read(&arr->flat_leaves);
+
+   if (likely(leaf_idx < UTIL_SPARSE_ARRAY_FLAT_LEAVES && flat_leaves)) {
+      char *leaf = (char *)p_atomic_read(&flat_leaves[leaf_idx]);
+      if (likely(leaf)) {
+         uint64_t elem_idx = idx & ((1ull << arr->node_size_log2) - 1);
+         return leaf + elem_idx * arr->elem_size;
+      }
+   }
+
+   return _util_sparse_array_get_slow(arr, idx);
+}
+
+/** Looks up count elements at once
+ *
+ * This is equivalent to calling util_sparse_array_get() for each index but
+ * consecutive indices landing in the same leaf node, as runs of handles
+ * typically do, only find the node once.
+ */
+void util_sparse_array_get_many(struct util_sparse_array *arr,
+                                const uint32_t *idx, unsigned count,
+                                void **elems);
 
 void util_sparse_array_validate(struct util_sparse_array *arr);
 
@@ -0,0 +1,485 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <assert.h>
+
+#include "swiss_table.h"
+#include "bitscan.h"
+#include "detect_arch.h"
+#include "macros.h"
+#include "ralloc.h"
+
+#if defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || DETECT_ARCH_X86_64
+#include <emmintrin.h>
+#define SWISS_TABLE_SSE2 1
+#elif DETECT_ARCH_AARCH64 && (defined(__ARM_NEON) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define SWISS_TABLE_NEON 1
+#endif
+
+/* Full slots store the low 7 bits of the mixed hash, so they never have the
+ * top bit set.
+ */
+#define CTRL_EMPTY   ((uint8_t)0x80)
+#define CTRL_DELETED ((uint8_t)0xfe)
+
+static inline bool
+ctrl_is_full(uint8_t ctrl)
+{
+   return !(ctrl & 0x80);
+}
+
+/* The table is indexed by the low bits of the hash and the control bytes are
+ * compared with other bits of it. Many of the hash functions used in Mesa
+ * are weak (e.g. the identity for integer keys), so mix the bits first.
+ */
+static inline uint32_t
+mix_hash(uint32_t hash)
+{
+   hash ^= hash >> 16;
+   hash *= 0x85ebca6b;
+   hash ^= hash >> 13;
+   hash *= 0xc2b2ae35;
+   hash ^= hash >> 16;
+   return hash;
+}
+
+static inline uint8_t
+hash_h2(uint32_t mixed)
+{
+   return mixed & 0x7f;
+}
+
+static inline uint32_t
+hash_h1(uint32_t mixed)
+{
+   return mixed >> 7;
+}
+
+/* Returns a mask of the slots in the group whose control byte is "value". */
+static inline unsigned
+group_match(const uint8_t *ctrl, uint8_t value)
+{
+#if defined(SWISS_TABLE_SSE2)
+   __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+#elif defined(SWISS_TABLE_NEON)
+   static const uint8_t bits[16] = {
+      1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128,
+   };
+   uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(value));
+   uint8x16_t masked = vandq_u8(eq, vld1q_u8(bits));
+   return vaddv_u8(vget_low_u8(masked)) |
+          (vaddv_u8(vget_high_u8(masked)) << 8);
+#else
+   unsigned mask = 0;
+   for (unsigned i = 0; i < SWISS_TABLE_GROUP_SIZE; i++)
+      mask |= (unsigned)(ctrl[i] == value) << i;
+   return mask;
+#endif
+}
+
+/* Returns a mask of the empty and deleted slots in the group. */
+static inline unsigned
+group_match_available(const uint8_t *ctrl)
+{
+#if defined(SWISS_TABLE_SSE2)
+   return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#elif defined(SWISS_TABLE_NEON)
+   static const uint8_t bits[16] = {
+      1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128,
+   };
+   uint8x16_t masked = vandq_u8(vtstq_u8(vld1q_u8(ctrl), vdupq_n_u8(0x80)),
+                                vld1q_u8(bits));
+   return vaddv_u8(vget_low_u8(masked)) |
+          (vaddv_u8(vget_high_u8(masked)) << 8);
+#else
+   unsigned mask = 0;
+   for (unsigned i = 0; i < SWISS_TABLE_GROUP_SIZE; i++)
+      mask |= (unsigned)!ctrl_is_full(ctrl[i]) << i;
+   return mask;
+#endif
+}
+
+static inline uint32_t
+capacity(const struct swiss_table *st)
+{
+   return st->num_groups * SWISS_TABLE_GROUP_SIZE;
+}
+
+void
+_mesa_swiss_table_init(struct swiss_table *st,
+                       void *mem_ctx,
+                       uint32_t (*key_hash_function)(const void *key),
+                       bool (*key_equals_function)(const void *a,
+                                                   const void *b))
+{
+   memset(st, 0, sizeof(*st));
+   st->mem_ctx = mem_ctx;
+   st->key_hash_function = key_hash_function;
+   st->key_equals_function = key_equals_function;
+}
+
+struct swiss_table *
+_mesa_swiss_table_create(void *mem_ctx,
+                         uint32_t (*key_hash_function)(const void *key),
+                         bool (*key_equals_function)(const void *a,
+                                                     const void *b))
+{
+   struct swiss_table *st;
+
+   st = ralloc(mem_ctx, struct swiss_table);
+   if (st == NULL)
+      return NULL;
+
+   _mesa_swiss_table_init(st, st, key_hash_function, key_equals_function);
+   return st;
+}
+
+void
+_mesa_swiss_table_fini(struct swiss_table *st,
+                       void (*delete_function)(struct hash_entry *entry))
+{
+   if (delete_function) {
+      swiss_table_foreach(st, entry) {
+         delete_function(entry);
+      }
+   }
+
+   ralloc_free(st->ctrl);
+   ralloc_free(st->table);
+   st->ctrl = NULL;
+   st->table = NULL;
+   st->num_groups = 0;
+   st->max_entries = 0;
+   st->entries = 0;
+   st->deleted_entries = 0;
+}
+
+void
+_mesa_swiss_table_destroy(struct swiss_table *st,
+                          void (*delete_function)(struct hash_entry *entry))
+{
+   if (!st)
+      return;
+
+   _mesa_swiss_table_fini(st, delete_function);
+   ralloc_free(st);
+}
+
+void
+_mesa_swiss_table_clear(struct swiss_table *st,
+                        void (*delete_function)(struct hash_entry *entry))
+{
+   if (!st)
+      return;
+
+   if (delete_function) {
+      swiss_table_foreach(st, entry) {
+         delete_function(entry);
+      }
+   }
+
+   if (st->ctrl)
+      memset(st->ctrl, CTRL_EMPTY, capacity(st));
+   st->entries = 0;
+   st->deleted_entries = 0;
+}
+
+static struct hash_entry *
+swiss_table_search(const struct swiss_table *st, uint32_t hash,
+                   const void *key)
+{
+   if (!st->entries)
+      return NULL;
+
+   uint32_t mixed = mix_hash(hash);
+   uint8_t h2 = hash_h2(mixed);
+   uint32_t group_mask = st->num_groups - 1;
+   uint32_t group = hash_h1(mixed) & group_mask;
+
+   /* Triangular probing visits every group once for power of two sizes. */
+   for (uint32_t i = 1; i <= st->num_groups; i++) {
+      const uint8_t *ctrl = st->ctrl + group * SWISS_TABLE_GROUP_SIZE;
+      unsigned match = group_match(ctrl, h2);
+
+      while (match) {
+         unsigned slot = group * SWISS_TABLE_GROUP_SIZE + u_bit_scan(&match);
+         struct hash_entry *entry = &st->table[slot];
+
+         if (entry->hash == hash && st->key_equals_function(key, entry->key))
+            return entry;
+      }
+
+      /* The key would have been inserted into the first empty slot. */
+      if (group_match(ctrl, CTRL_EMPTY))
+         return NULL;
+
+      group = (group + i) & group_mask;
+   }
+
+   return NULL;
+}
+
+struct hash_entry *
+_mesa_swiss_table_search(const struct swiss_table *st, const void *key)
+{
+   assert(st->key_hash_function);
+   return swiss_table_search(st, st->key_hash_function(key), key);
+}
+
+struct hash_entry *
+_mesa_swiss_table_search_pre_hashed(const struct swiss_table *st,
+                                    uint32_t hash, const void *key)
+{
+   assert(st->key_hash_function == NULL || hash == st->key_hash_function(key));
+   return swiss_table_search(st, hash, key);
+}
+
+/* Insert into a table without deleted entries that is known not to contain
+ * the key.
+ */
+static void
+swiss_table_insert_rehash(struct swiss_table *st, const struct hash_entry *src)
+{
+   uint32_t mixed = mix_hash(src->hash);
+   uint32_t group_mask = st->num_groups - 1;
+   uint32_t group = hash_h1(mixed) & group_mask;
+
+   for (uint32_t i = 1;; i++) {
+      uint8_t *ctrl = st->ctrl + group * SWISS_TABLE_GROUP_SIZE;
+      unsigned match = group_match(ctrl, CTRL_EMPTY);
+
+      if (likely(match)) {
+         unsigned slot = u_bit_scan(&match);
+
+         ctrl[slot] = hash_h2(mixed);
+         st->table[group * SWISS_TABLE_GROUP_SIZE + slot] = *src;
+         return;
+      }
+
+      group = (group + i) & group_mask;
+   }
+}
+
+static bool
+swiss_table_rehash(struct swiss_table *st, uint32_t num_groups)
+{
+   struct swiss_table old_st = *st;
+
+   assert(util_is_power_of_two_nonzero(num_groups));
+
+   st->ctrl = ralloc_array(st->mem_ctx, uint8_t,
+                           num_groups * SWISS_TABLE_GROUP_SIZE);
+   st->table = ralloc_array(st->mem_ctx, struct hash_entry,
+                            num_groups * SWISS_TABLE_GROUP_SIZE);
+   if (!st->ctrl || !st->table) {
+      ralloc_free(st->ctrl);
+      ralloc_free(st->table);
+      *st = old_st;
+      return false;
+   }
+
+   memset(st->ctrl, CTRL_EMPTY, num_groups * SWISS_TABLE_GROUP_SIZE);
+   st->num_groups = num_groups;
+   /* Keep the load factor at 7/8 at most. */
+   st->max_entries = capacity(st) - capacity(st) / 8;
+   st->deleted_entries = 0;
+
+   swiss_table_foreach(&old_st, entry) {
+      swiss_table_insert_rehash(st, entry);
+   }
+
+   ralloc_free(old_st.ctrl);
+   ralloc_free(old_st.table);
+   return true;
+}
+
+static struct hash_entry *
+swiss_table_get_entry(struct swiss_table *st, uint32_t hash, const void *key)
+{
+   if (st->entries >= st->max_entries) {
+      if (!swiss_table_rehash(st, MAX2(st->num_groups * 2, 1)))
+         return NULL;
+   } else if (st->entries + st->deleted_entries >= st->max_entries) {
+      if (!swiss_table_rehash(st, st->num_groups))
+         return NULL;
+   }
+
+   uint32_t mixed = mix_hash(hash);
+   uint8_t h2 = hash_h2(mixed);
+   uint32_t group_mask = st->num_groups - 1;
+   uint32_t group = hash_h1(mixed) & group_mask;
+   int available_slot = -1;
+
+   for (uint32_t i = 1; i <= st->num_groups; i++) {
+      const uint8_t *ctrl = st->ctrl + group * SWISS_TABLE_GROUP_SIZE;
+      unsigned match = group_match(ctrl, h2);
+
+      /* Replace the entry if the key is already present, see
+       * hash_table_get_entry.
+       */
+      while (match) {
+         unsigned slot = group * SWISS_TABLE_GROUP_SIZE + u_bit_scan(&match);
+         struct hash_entry *entry = &st->table[slot];
+
+         if (entry->hash == hash && st->key_equals_function(key, entry->key))
+            return entry;
+      }
+
+      /* Stash the first available slot we find */
+      unsigned available = group_match_available(ctrl);
+      if (available_slot < 0 && available)
+         available_slot = group * SWISS_TABLE_GROUP_SIZE + ffs(available) - 1;
+
+      if (group_match(ctrl, CTRL_EMPTY))
+         break;
+
+      group = (group + i) & group_mask;
+   }
+
+   /* The load factor guarantees an empty slot. */
+   assert(available_slot >= 0);
+
+   if (st->ctrl[available_slot] == CTRL_DELETED)
+      st->deleted_entries--;
+   st->ctrl[available_slot] = h2;
+   st->entries++;
+
+   struct hash_entry *entry = &st->table[available_slot];
+   entry->hash = hash;
+   return entry;
+}
+
+static struct hash_entry *
+swiss_table_insert(struct swiss_table *st, uint32_t hash,
+                   const void *key, void *data)
+{
+   struct hash_entry *entry = swiss_table_get_entry(st, hash, key);
+
+   if (entry) {
+      entry->key = key;
+      entry->data = data;
+   }
+
+   return entry;
+}
+
+/**
+ * Inserts the key into the table, replacing the entry with the same key.
+ *
+ * Note that insertion may rearrange the table on a resize or rehash,
+ * so previously found hash_entries are no longer valid after this function.
+ */
+struct hash_entry *
+_mesa_swiss_table_insert(struct swiss_table *st, const void *key, void *data)
+{
+   assert(st->key_hash_function);
+   return swiss_table_insert(st, st->key_hash_function(key), key, data);
+}
+
+struct hash_entry *
+_mesa_swiss_table_insert_pre_hashed(struct swiss_table *st, uint32_t hash,
+                                    const void *key, void *data)
+{
+   assert(st->key_hash_function == NULL || hash == st->key_hash_function(key));
+   return swiss_table_insert(st, hash, key, data);
+}
+
+/**
+ * This function deletes the given hash table entry.
+ *
+ * Note that deletion doesn't otherwise modify the table, so an iteration over
+ * the table deleting entries is safe.
+ */
+void
+_mesa_swiss_table_remove(struct swiss_table *st, struct hash_entry *entry)
+{
+   if (!entry)
+      return;
+
+   uint32_t slot = entry - st->table;
+   uint8_t *group_ctrl = st->ctrl + (slot & ~(SWISS_TABLE_GROUP_SIZE - 1));
+
+   /* Probing stops at the first group with an empty slot, so no probe
+    * sequence continues past this group if it has one. The slot can then be
+    * marked as empty instead of leaving a tombstone.
+    */
+   if (group_match(group_ctrl, CTRL_EMPTY)) {
+      st->ctrl[slot] = CTRL_EMPTY;
+   } else {
+      st->ctrl[slot] = CTRL_DELETED;
+      st->deleted_entries++;
+   }
+   st->entries--;
+}
+
+/**
+ * Removes the entry with the corresponding key, if exists.
+ */
+void
+_mesa_swiss_table_remove_key(struct swiss_table *st, const void *key)
+{
+   _mesa_swiss_table_remove(st, _mesa_swiss_table_search(st, key));
+}
+
+/**
+ * This function is an iterator over the table.
+ *
+ * Pass in NULL for the first entry, as in the start of a for loop. Note that
+ * an iteration over the table is O(table_size) not O(entries).
+ */
+struct hash_entry *
+_mesa_swiss_table_next_entry(const struct swiss_table *st,
+                             struct hash_entry *entry)
+{
+   uint32_t slot = entry ? entry - st->table + 1 : 0;
+
+   for (; slot < capacity(st); slot++) {
+      if (ctrl_is_full(st->ctrl[slot]))
+         return &st->table[slot];
+   }
+
+   return NULL;
+}
+
+/**
+ * Grows the table so that "size" entries can be inserted without rehashing.
+ */
+bool
+_mesa_swiss_table_reserve(struct swiss_table *st, unsigned size)
+{
+   if (size <= st->max_entries)
+      return true;
+
+   uint32_t num_groups = MAX2(st->num_groups, 1);
+   while (num_groups * SWISS_TABLE_GROUP_SIZE -
+          num_groups * SWISS_TABLE_GROUP_SIZE / 8 < size)
+      num_groups *= 2;
+
+   return swiss_table_rehash(st, num_groups);
+}
+
+struct swiss_table *
+_mesa_pointer_swiss_table_create(void *mem_ctx)
+{
+   return _mesa_swiss_table_create(mem_ctx, _mesa_hash_pointer,
+                                   _mesa_key_pointer_equal);
+}
+
+void
+_mesa_pointer_swiss_table_init(struct swiss_table *st, void *mem_ctx)
+{
+   _mesa_swiss_table_init(st, mem_ctx, _mesa_hash_pointer,
+                          _mesa_key_pointer_equal);
+}
+
+struct swiss_table *
+_mesa_string_swiss_table_create(void *mem_ctx)
+{
+   return _mesa_swiss_table_create(mem_ctx, _mesa_hash_string,
+                                   _mesa_key_string_equal);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Open addressing hash table in the style of the "Swiss tables".
+ *
+ * The slots are split into groups of 16. Every slot has a control byte that
+ * is either empty, deleted or holds 7 bits of the hash of the key. A lookup
+ * compares the control bytes of a whole group with one SIMD comparison and
+ * only touches the entries whose control byte matches, which keeps the
+ * number of key comparisons and touched cache lines low even at a high load
+ * factor.
+ *
+ * The API follows the _mesa_hash_table_* API and uses the same struct
+ * hash_entry, so switching between both tables is mostly a rename. Unlike
+ * struct hash_table, there are no reserved key values, NULL is a valid key.
+ */
+
+#ifndef _SWISS_TABLE_H
+#define _SWISS_TABLE_H
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include "hash_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SWISS_TABLE_GROUP_SIZE 16
+
+struct swiss_table {
+   void *mem_ctx;
+   uint8_t *ctrl;
+   struct hash_entry *table;
+   uint32_t (*key_hash_function)(const void *key);
+   bool (*key_equals_function)(const void *a, const void *b);
+   uint32_t num_groups; /* always a power of two, or 0 before the first insert */
+   uint32_t max_entries;
+   uint32_t entries;
+   uint32_t deleted_entries;
+};
+
+struct swiss_table *
+_mesa_swiss_table_create(void *mem_ctx,
+                         uint32_t (*key_hash_function)(const void *key),
+                         bool (*key_equals_function)(const void *a,
+                                                     const void *b));
+
+void
+_mesa_swiss_table_init(struct swiss_table *st,
+                       void *mem_ctx,
+                       uint32_t (*key_hash_function)(const void *key),
+                       bool (*key_equals_function)(const void *a,
+                                                   const void *b));
+
+void
+_mesa_swiss_table_fini(struct swiss_table *st,
+                       void (*delete_function)(struct hash_entry *entry));
+
+void _mesa_swiss_table_destroy(struct swiss_table *st,
+                               void (*delete_function)(struct hash_entry *entry));
+void _mesa_swiss_table_clear(struct swiss_table *st,
+                             void (*delete_function)(struct hash_entry *entry));
+
+static inline uint32_t _mesa_swiss_table_num_entries(const struct swiss_table *st)
+{
+   return st->entries;
+}
+
+struct hash_entry *
+_mesa_swiss_table_insert(struct swiss_table *st, const void *key, void *data);
+struct hash_entry *
+_mesa_swiss_table_insert_pre_hashed(struct swiss_table *st, uint32_t hash,
+                                    const void *key, void *data);
+struct hash_entry *
+_mesa_swiss_table_search(const struct swiss_table *st, const void *key);
+struct hash_entry *
+_mesa_swiss_table_search_pre_hashed(const struct swiss_table *st,
+                                    uint32_t hash, const void *key);
+void _mesa_swiss_table_remove(struct swiss_table *st,
+                              struct hash_entry *entry);
+void _mesa_swiss_table_remove_key(struct swiss_table *st,
+                                  const void *key);
+
+struct hash_entry *_mesa_swiss_table_next_entry(const struct swiss_table *st,
+                                                struct hash_entry *entry);
+
+bool
+_mesa_swiss_table_reserve(struct swiss_table *st, unsigned size);
+
+struct swiss_table *
+_mesa_pointer_swiss_table_create(void *mem_ctx);
+
+void
+_mesa_pointer_swiss_table_init(struct swiss_table *st, void *mem_ctx);
+
+struct swiss_table *
+_mesa_string_swiss_table_create(void *mem_ctx);
+
+/**
+ * This foreach function is safe against deletion (which just marks
+ * an entry as deleted) but not against insertion (which may rehash
+ * the table, making entry a dangling pointer).
+ */
+#define swiss_table_foreach(st, entry)                                     \
+   for (struct hash_entry *entry = _mesa_swiss_table_next_entry(st, NULL); \
+        entry != NULL;                                                     \
+        entry = _mesa_swiss_table_next_entry(st, entry))
+
+#ifdef __cplusplus
+} /* extern C */
+#endif
+
+#endif /* _SWISS_TABLE_H */
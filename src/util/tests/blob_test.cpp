@@ -31,6 +31,7 @@
 typedef SSIZE_T ssize_t;
 #endif
 
+#include "util/macros.h"
 #include "util/ralloc.h"
 #include "blob.h"
 
@@ -237,3 +238,64 @@ TEST(BlobTest, BigObjects)
    blob_finish(&blob);
    ralloc_free(ctx);
 }
+
+// Test that a chunked blob holds the same data as a contiguous one, with
+// writes, reservations and overwrites straddling chunk boundaries.
+TEST(BlobTest, Chunked)
+{
+   struct blob blob, chunked;
+   struct blob_chunk chunks[64];
+   size_t uint_offset, chunked_uint_offset;
+   void *flat;
+   size_t flat_size;
+
+   blob_init(&blob);
+   blob_init_chunked(&chunked, 7);
+
+   for (struct blob *b : {&blob, &chunked}) {
+      blob_write_bytes(b, bytes_test_str, sizeof(bytes_test_str));
+      ssize_t reserved = blob_reserve_bytes(b, sizeof(reserve_test_str));
+      blob_overwrite_bytes(b, reserved, reserve_test_str, sizeof(reserve_test_str));
+      blob_write_uint8(b, 1);
+      blob_write_uint64(b, uint64_test);
+      blob_write_uint32(b, uint32_placeholder);
+      blob_write_string(b, string_test_str);
+   }
+
+   uint_offset = blob_reserve_uint32(&blob);
+   chunked_uint_offset = blob_reserve_uint32(&chunked);
+   EXPECT_EQ(uint_offset, chunked_uint_offset);
+   blob_overwrite_uint32(&blob, uint_offset, uint32_overwrite);
+   blob_overwrite_uint32(&chunked, chunked_uint_offset, uint32_overwrite);
+
+   ASSERT_EQ(blob.size, chunked.size);
+   EXPECT_EQ(NULL, chunked.data);
+   EXPECT_FALSE(chunked.out_of_memory);
+
+   // Only the last chunk may be partially filled.
+   unsigned num_chunks = blob_get_chunks(&chunked, chunks, ARRAY_SIZE(chunks));
+   ASSERT_EQ((chunked.size + 6) / 7, num_chunks);
+   size_t total = 0;
+   for (unsigned i = 0; i < num_chunks; i++) {
+      if (i + 1 < num_chunks)
+         EXPECT_EQ(7u, chunks[i].size);
+      EXPECT_U8_ARRAY_EQUAL(blob.data + total, chunks[i].data, chunks[i].size);
+      total += chunks[i].size;
+   }
+   EXPECT_EQ(blob.size, total);
+
+   // A contiguous blob is a single chunk.
+   EXPECT_EQ(1u, blob_get_chunks(&blob, chunks, ARRAY_SIZE(chunks)));
+   EXPECT_EQ(blob.data, chunks[0].data);
+   EXPECT_EQ(blob.size, chunks[0].size);
+
+   blob_finish_get_buffer(&chunked, &flat, &flat_size);
+   ASSERT_EQ(blob.size, flat_size);
+   EXPECT_U8_ARRAY_EQUAL(blob.data, (const uint8_t *) flat, flat_size);
+
+   // Overwriting past the end must fail like for a contiguous blob.
+   EXPECT_FALSE(blob_overwrite_uint32(&blob, blob.size, 0));
+
+   free(flat);
+   blob_finish(&blob);
+}
@@ -502,10 +502,208 @@ test_put_key_and_get_key(const char *driver_id)
    disk_cache_destroy(cache);
 }
 
+static void
+test_put_and_get_batch(const char *driver_id)
+{
+   const unsigned num_items = 16;
+   cache_key keys[num_items + 1];
+   char blobs[num_items][32];
+   void *data[num_items + 1];
+   size_t sizes[num_items + 1];
+   unsigned num_found;
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   os_set_option("MESA_SHADER_CACHE_DISABLE", "false", true);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   struct disk_cache *cache1 = disk_cache_create("test_batch", driver_id, 0);
+   struct disk_cache *cache2 = disk_cache_create("test_batch", driver_id, 0);
+
+   for (unsigned i = 0; i < num_items; i++) {
+      snprintf(blobs[i], sizeof(blobs[i]), "batched blob number %u", i);
+      disk_cache_compute_key(cache1, blobs[i], sizeof(blobs[i]), keys[i]);
+   }
+
+   /* The extra key is never put into the cache */
+   disk_cache_compute_key(cache1, "missing", sizeof("missing"),
+                          keys[num_items]);
+
+   num_found = disk_cache_get_batch(cache1, num_items + 1, keys, data, sizes);
+   EXPECT_EQ(num_found, 0) << "disk_cache_get_batch with non-existent items";
+
+   /* Put the items in reverse order, so the batch is read out of order */
+   for (int i = num_items - 1; i >= 0; i--)
+      disk_cache_put(cache1, keys[i], blobs[i], sizeof(blobs[i]), NULL);
+
+   disk_cache_wait_for_idle(cache1);
+
+   disk_cache_prefetch(cache2, num_items + 1, keys);
+
+   num_found = disk_cache_get_batch(cache2, num_items + 1, keys, data, sizes);
+   EXPECT_EQ(num_found, num_items) << "disk_cache_get_batch of existing items";
+
+   for (unsigned i = 0; i < num_items; i++) {
+      EXPECT_STREQ((char *) data[i], blobs[i]) << "disk_cache_get_batch item " << i;
+      EXPECT_EQ(sizes[i], sizeof(blobs[i])) << "disk_cache_get_batch size " << i;
+      free(data[i]);
+   }
+
+   EXPECT_EQ(data[num_items], nullptr) << "disk_cache_get_batch of missing item";
+   EXPECT_EQ(sizes[num_items], 0) << "disk_cache_get_batch size of missing item";
+
+   disk_cache_destroy(cache1);
+   disk_cache_destroy(cache2);
+}
+
+static void
+test_put_and_get_large(const char *driver_id)
+{
+   /* Big enough to be mapped instead of read */
+   const size_t size = 256 * 1024;
+   uint8_t *blob = (uint8_t *) malloc(size);
+   cache_key key;
+   size_t got_size = 0;
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   os_set_option("MESA_SHADER_CACHE_DISABLE", "false", true);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   /* Incompressible data, so the file stays big */
+   uint32_t seed = 0x1234567;
+   for (size_t i = 0; i < size; i++) {
+      seed = seed * 1103515245 + 12345;
+      blob[i] = seed >> 24;
+   }
+
+   struct disk_cache *cache1 = disk_cache_create("test_large", driver_id, 0);
+   struct disk_cache *cache2 = disk_cache_create("test_large", driver_id, 0);
+
+   disk_cache_compute_key(cache1, blob, size, key);
+   disk_cache_put(cache1, key, blob, size, NULL);
+   disk_cache_wait_for_idle(cache1);
+
+   void *result = disk_cache_get(cache2, key, &got_size);
+   EXPECT_NE(result, nullptr) << "disk_cache_get of a large item";
+   EXPECT_EQ(got_size, size) << "disk_cache_get size of a large item";
+   if (result)
+      EXPECT_EQ(memcmp(result, blob, size), 0) << "disk_cache_get data of a large item";
+
+   free(result);
+   free(blob);
+   disk_cache_destroy(cache1);
+   disk_cache_destroy(cache2);
+}
+
+static void
+test_put_and_get_with_dict(const char *driver_id)
+{
+   const unsigned num_items = 4096 + 64;
+   char blob[512];
+   cache_key key;
+   size_t size;
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   os_set_option("MESA_SHADER_CACHE_DISABLE", "false", true);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   /* Make sure nothing gets evicted */
+   os_set_option("MESA_SHADER_CACHE_MAX_SIZE", "16M", true);
+
+   struct disk_cache *cache1 = disk_cache_create("test_dict", driver_id, 0);
+
+   /* The dictionary is trained from the first items put into the cache and
+    * then used for compressing the following items.
+    */
+   for (unsigned i = 0; i < num_items; i++) {
+      for (unsigned j = 0; j < sizeof(blob); j++)
+         blob[j] = "shader_binary"[(i * j) % 13] ^ (j % 7 == 0 ? i : 0);
+
+      disk_cache_compute_key(cache1, blob, sizeof(blob), key);
+      disk_cache_put(cache1, key, blob, sizeof(blob), NULL);
+   }
+
+   disk_cache_wait_for_idle(cache1);
+
+   EXPECT_NE(p_atomic_read(&cache1->dict.dict), nullptr)
+      << "compression dictionary trained";
+
+   /* The second instance has to load the dictionary stored by the first */
+   struct disk_cache *cache2 = disk_cache_create("test_dict", driver_id, 0);
+
+   for (unsigned i = 0; i < num_items; i++) {
+      for (unsigned j = 0; j < sizeof(blob); j++)
+         blob[j] = "shader_binary"[(i * j) % 13] ^ (j % 7 == 0 ? i : 0);
+
+      disk_cache_compute_key(cache2, blob, sizeof(blob), key);
+
+      char *result = (char *) disk_cache_get(cache2, key, &size);
+      EXPECT_NE(result, nullptr) << "disk_cache_get of item " << i;
+      if (!result)
+         break;
+
+      EXPECT_EQ(size, sizeof(blob)) << "disk_cache_get size of item " << i;
+      EXPECT_EQ(memcmp(result, blob, sizeof(blob)), 0)
+         << "disk_cache_get data of item " << i;
+      free(result);
+   }
+
+   disk_cache_destroy(cache1);
+   disk_cache_destroy(cache2);
+}
+
 /* To make sure we are not just using the inmemory cache index for the single
  * file cache we test adding and retriving cache items between two different
  * cache instances.
  */
+static void
+test_put_and_get_stats(const char *driver_id)
+{
+   struct disk_cache_stats stats;
+   const char blob[] = "This is a blob for the stats";
+   cache_key key;
+   size_t size;
+   void *result;
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   os_set_option("MESA_SHADER_CACHE_DISABLE", "false", true);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   struct disk_cache *cache = disk_cache_create("test_stats", driver_id, 0);
+   EXPECT_FALSE(disk_cache_get_stats(cache, &stats))
+      << "disk_cache_get_stats without MESA_SHADER_CACHE_SHOW_STATS";
+   disk_cache_destroy(cache);
+
+   os_set_option("MESA_SHADER_CACHE_SHOW_STATS", "true", true);
+   cache = disk_cache_create("test_stats", driver_id, 0);
+
+   disk_cache_compute_key(cache, blob, sizeof(blob), key);
+
+   result = disk_cache_get(cache, key, &size);
+   EXPECT_EQ(result, nullptr) << "disk_cache_get with non-existent item";
+
+   disk_cache_put(cache, key, blob, sizeof(blob), NULL);
+   disk_cache_wait_for_idle(cache);
+
+   result = disk_cache_get(cache, key, &size);
+   EXPECT_STREQ((char *) result, blob) << "disk_cache_get of existing item";
+   free(result);
+
+   ASSERT_TRUE(disk_cache_get_stats(cache, &stats));
+   EXPECT_EQ(stats.hits[DISK_CACHE_STATS_DATABASE], 1);
+   EXPECT_EQ(stats.misses[DISK_CACHE_STATS_DATABASE], 1);
+   EXPECT_EQ(stats.bytes_read, sizeof(blob));
+   EXPECT_EQ(stats.bytes_written, sizeof(blob));
+   EXPECT_GT(stats.lock_wait_ns, 0);
+
+   uint32_t num_reads = 0;
+   for (unsigned i = 0; i < DISK_CACHE_STATS_LATENCY_BUCKETS; i++)
+      num_reads += stats.read_latency[i];
+   EXPECT_EQ(num_reads, 2) << "read latency histogram";
+
+   disk_cache_destroy(cache);
+   os_unset_option("MESA_SHADER_CACHE_SHOW_STATS");
+}
+
 static void
 test_put_and_get_between_instances(const char *driver_id)
 {
@@ -761,6 +959,10 @@ run_tests:
 
    test_put_key_and_get_key(driver_id);
 
+   test_put_and_get_batch(driver_id);
+
+   test_put_and_get_large(driver_id);
+
    os_set_option("MESA_DISK_CACHE_MULTI_FILE", "false", true);
 
    int err = rmrf_local(CACHE_TEST_TMP);
@@ -799,6 +1001,8 @@ run_tests:
 
    test_put_key_and_get_key(driver_id);
 
+   test_put_and_get_batch(driver_id);
+
    test_put_and_get_between_instances(driver_id);
 
    os_set_option("MESA_DISK_CACHE_SINGLE_FILE", "false", true);
@@ -842,6 +1046,8 @@ TEST_F(Cache, Database)
 
    test_put_key_and_get_key(driver_id);
 
+   test_put_and_get_batch(driver_id);
+
    test_put_and_get_between_instances(driver_id);
 
    test_put_and_get_between_instances_with_eviction(driver_id);
@@ -856,6 +1062,91 @@ TEST_F(Cache, Database)
 #endif
 }
 
+TEST_F(Cache, DatabaseMmap)
+{
+   const char *driver_id = "make_check_uncompressed";
+
+#ifndef ENABLE_SHADER_CACHE
+   GTEST_SKIP() << "ENABLE_SHADER_CACHE not defined.";
+#else
+   os_set_option("MESA_DISK_CACHE_MULTI_FILE", "false", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE_NUM_PARTS", "1", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE_MMAP", "true", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE", "true", true);
+
+   test_disk_cache_create(mem_ctx, CACHE_DIR_NAME_DB, driver_id);
+
+   test_put_and_get(true, driver_id);
+
+   test_put_key_and_get_key(driver_id);
+
+   test_put_and_get_batch(driver_id);
+
+   test_put_and_get_between_instances(driver_id);
+
+   test_put_and_get_between_instances_with_eviction(driver_id);
+
+   test_put_big_sized_entry_to_empty_cache(driver_id);
+
+   os_set_option("MESA_DISK_CACHE_DATABASE", "false", true);
+   os_unset_option("MESA_DISK_CACHE_DATABASE_MMAP");
+   os_unset_option("MESA_DISK_CACHE_DATABASE_NUM_PARTS");
+
+   int err = rmrf_local(CACHE_TEST_TMP);
+   EXPECT_EQ(err, 0) << "Removing " CACHE_TEST_TMP " again";
+#endif
+}
+
+TEST_F(Cache, DatabaseDict)
+{
+   const char *driver_id = "make_check";
+
+#ifndef ENABLE_SHADER_CACHE
+   GTEST_SKIP() << "ENABLE_SHADER_CACHE not defined.";
+#elif !defined(HAVE_ZSTD)
+   GTEST_SKIP() << "Compression dictionaries require zstd.";
+#else
+   os_set_option("MESA_DISK_CACHE_MULTI_FILE", "false", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE_NUM_PARTS", "1", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE_DICT", "true", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE", "true", true);
+
+   test_disk_cache_create(mem_ctx, CACHE_DIR_NAME_DB, driver_id);
+
+   test_put_and_get_with_dict(driver_id);
+
+   os_set_option("MESA_DISK_CACHE_DATABASE", "false", true);
+   os_unset_option("MESA_DISK_CACHE_DATABASE_DICT");
+   os_unset_option("MESA_DISK_CACHE_DATABASE_NUM_PARTS");
+
+   int err = rmrf_local(CACHE_TEST_TMP);
+   EXPECT_EQ(err, 0) << "Removing " CACHE_TEST_TMP " again";
+#endif
+}
+
+TEST_F(Cache, DatabaseStats)
+{
+   const char *driver_id = "make_check";
+
+#ifndef ENABLE_SHADER_CACHE
+   GTEST_SKIP() << "ENABLE_SHADER_CACHE not defined.";
+#else
+   os_set_option("MESA_DISK_CACHE_MULTI_FILE", "false", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE_NUM_PARTS", "1", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE", "true", true);
+
+   test_disk_cache_create(mem_ctx, CACHE_DIR_NAME_DB, driver_id);
+
+   test_put_and_get_stats(driver_id);
+
+   os_set_option("MESA_DISK_CACHE_DATABASE", "false", true);
+   os_unset_option("MESA_DISK_CACHE_DATABASE_NUM_PARTS");
+
+   int err = rmrf_local(CACHE_TEST_TMP);
+   EXPECT_EQ(err, 0) << "Removing " CACHE_TEST_TMP " again";
+#endif
+}
+
 TEST_F(Cache, Combined)
 {
    const char *driver_id = "make_check";
@@ -1084,6 +1375,122 @@ TEST_F(Cache, Combined)
 #endif
 }
 
+TEST_F(Cache, SortedIndex)
+{
+   const char *driver_id = "make_check";
+   char blobs[3][32] = {
+      "This is the first RO blob",
+      "This is the second RO blob",
+      "This is the third RO blob",
+   };
+   uint8_t blob_keys[3][SHA1_DIGEST_LENGTH];
+   uint8_t dummy_key[SHA1_DIGEST_LENGTH] = { 0 };
+   char foz_rw_idx_file[1024];
+   char foz_rw_file[1024];
+   char foz_ro_idx_file[1024];
+   char foz_ro_file[1024];
+   char foz_compact_idx_file[1024];
+   unsigned num_kept, num_dropped;
+   char *result;
+   size_t size;
+
+#ifndef ENABLE_SHADER_CACHE
+   GTEST_SKIP() << "ENABLE_SHADER_CACHE not defined.";
+#else
+   os_set_option("MESA_DISK_CACHE_SINGLE_FILE", "true", true);
+   os_set_option("MESA_DISK_CACHE_MULTI_FILE", "false", true);
+   os_set_option("MESA_DISK_CACHE_DATABASE", "false", true);
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   os_set_option("MESA_SHADER_CACHE_DISABLE", "false", true);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   test_disk_cache_create(mem_ctx, CACHE_DIR_NAME_SF, driver_id);
+
+   struct disk_cache *cache = disk_cache_create("sorted_index_test",
+                                                driver_id, 0);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(blobs); i++) {
+      disk_cache_compute_key(cache, blobs[i], sizeof(blobs[i]), blob_keys[i]);
+      disk_cache_put(cache, blob_keys[i], blobs[i], sizeof(blobs[i]), NULL);
+   }
+   disk_cache_wait_for_idle(cache);
+
+   sprintf(foz_rw_file, "%s/foz_cache.foz", cache->path);
+   sprintf(foz_ro_file, "%s/ro_cache.foz", cache->path);
+   EXPECT_EQ(rename(foz_rw_file, foz_ro_file), 0) << "foz_cache.foz renaming failed";
+
+   sprintf(foz_rw_idx_file, "%s/foz_cache_idx.foz", cache->path);
+   sprintf(foz_ro_idx_file, "%s/ro_cache_idx.foz", cache->path);
+   EXPECT_EQ(rename(foz_rw_idx_file, foz_ro_idx_file), 0) << "foz_cache_idx.foz renaming failed";
+
+   /* Compacting copies every valid entry and writes the sorted index of the
+    * new db.
+    */
+   EXPECT_TRUE(foz_compact(cache->path, "ro_cache", "ro_compact",
+                           &num_kept, &num_dropped));
+   EXPECT_EQ(num_kept, ARRAY_SIZE(blobs));
+   EXPECT_EQ(num_dropped, 0);
+
+   sprintf(foz_compact_idx_file, "%s/ro_compact_idx.foz", cache->path);
+
+   disk_cache_destroy(cache);
+
+   /* Clear the entries of the compacted index without changing its size, the
+    * entries must still be found through the sorted index.
+    */
+   FILE *idx = fopen(foz_compact_idx_file, "r+b");
+   ASSERT_NE(idx, nullptr);
+   fseek(idx, 0, SEEK_END);
+   long idx_size = ftell(idx);
+   fseek(idx, 16, SEEK_SET);
+   for (long i = 16; i < idx_size; i++)
+      fputc(0, idx);
+   fclose(idx);
+
+   os_set_option("MESA_DISK_CACHE_READ_ONLY_FOZ_DBS", "ro_compact", true);
+
+   cache = disk_cache_create("sorted_index_test", driver_id, 0);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(blobs); i++) {
+      result = (char *) disk_cache_get(cache, blob_keys[i], &size);
+      EXPECT_STREQ(blobs[i], result) << "disk_cache_get of existing item (pointer)";
+      EXPECT_EQ(size, sizeof(blobs[i])) << "disk_cache_get of existing item (size)";
+      free(result);
+   }
+
+   result = (char *) disk_cache_get(cache, dummy_key, &size);
+   EXPECT_EQ(result, nullptr) << "disk_cache_get with non-existent item (pointer)";
+   EXPECT_EQ(size, 0) << "disk_cache_get with non-existent item (size)";
+
+   disk_cache_destroy(cache);
+
+   /* Once the index changed size the sorted index is stale and the cleared
+    * index is parsed instead.
+    */
+   idx = fopen(foz_compact_idx_file, "ab");
+   ASSERT_NE(idx, nullptr);
+   fputc(0, idx);
+   fclose(idx);
+
+   cache = disk_cache_create("sorted_index_test", driver_id, 0);
+
+   result = (char *) disk_cache_get(cache, blob_keys[0], &size);
+   EXPECT_EQ(result, nullptr) << "disk_cache_get with stale sorted index (pointer)";
+   EXPECT_EQ(size, 0) << "disk_cache_get with stale sorted index (size)";
+
+   disk_cache_destroy(cache);
+
+   os_unset_option("MESA_DISK_CACHE_READ_ONLY_FOZ_DBS");
+   os_unset_option("MESA_DISK_CACHE_SINGLE_FILE");
+   os_unset_option("MESA_DISK_CACHE_MULTI_FILE");
+   os_unset_option("MESA_DISK_CACHE_DATABASE");
+
+   int err = rmrf_local(CACHE_TEST_TMP);
+   EXPECT_EQ(err, 0) << "Removing " CACHE_TEST_TMP " again";
+#endif
+}
+
 TEST_F(Cache, List)
 {
    const char *driver_id = "make_check";
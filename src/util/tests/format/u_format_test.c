@@ -778,6 +778,54 @@ test_format_metadata(const struct util_format_description *format_desc,
    return success;
 }
 
+/* Unpacks a whole row with the CPU-specific functions, if the format has
+ * any, and compares it with the generic ones. The single-block tests above
+ * only ever reach the scalar tails of the vector loops.
+ */
+static bool
+test_format_unpack_row(const struct util_format_description *format_desc)
+{
+   const struct util_format_unpack_description *unpack =
+      util_format_unpack_description(format_desc->format);
+   const struct util_format_unpack_description *generic =
+      util_format_unpack_description_generic(format_desc->format);
+   enum { width = 37 };
+   uint8_t packed[width * UTIL_FORMAT_MAX_PACKED_BYTES];
+   bool success = true;
+
+   if (unpack == generic ||
+       format_desc->block.width != 1 || format_desc->block.height != 1)
+      return true;
+
+   for (unsigned i = 0; i < sizeof packed; i++)
+      packed[i] = i * 37 + 11;
+
+   if (generic->unpack_rgba) {
+      float obtained[width][4], expected[width][4];
+
+      unpack->unpack_rgba(obtained, packed, width);
+      generic->unpack_rgba(expected, packed, width);
+      if (memcmp(obtained, expected, sizeof obtained)) {
+         printf("FAILED: %s unpack_rgba row\n", format_desc->short_name);
+         success = false;
+      }
+   }
+
+   if (generic->unpack_rgba_8unorm) {
+      uint8_t obtained[width][4], expected[width][4];
+
+      unpack->unpack_rgba_8unorm(&obtained[0][0], packed, width);
+      generic->unpack_rgba_8unorm(&expected[0][0], packed, width);
+      if (memcmp(obtained, expected, sizeof obtained)) {
+         printf("FAILED: %s unpack_rgba_8unorm row\n", format_desc->short_name);
+         success = false;
+      }
+   }
+
+   return success;
+}
+
+
 static bool
 test_all(void)
 {
@@ -857,6 +905,9 @@ test_all(void)
 
       TEST_FORMAT_METADATA(norm_flags);
 
+      if (!test_format_unpack_row(format_desc))
+         success = false;
+
 #     undef TEST_ONE_FUNC
 #     undef TEST_ONE_FORMAT
    }
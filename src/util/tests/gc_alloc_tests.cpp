@@ -23,6 +23,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 #include "util/ralloc.h"
 
 #if defined(__LP64__) || defined(_WIN64)
@@ -46,3 +48,32 @@ TEST(gc_alloc, align)
       }
    }
 }
+
+TEST(gc_alloc, thread_safe)
+{
+   gc_ctx *ctx = gc_context(NULL);
+   gc_set_thread_safe(ctx, true);
+
+   /* Objects of all threads share the same slabs. */
+   void *objs[4][256] = {};
+
+   std::vector<std::thread> threads;
+   for (unsigned t = 0; t < 4; t++) {
+      threads.emplace_back([&, t]() {
+         for (unsigned iter = 0; iter < 64; iter++) {
+            for (unsigned i = 0; i < 256; i++) {
+               objs[t][i] = gc_zalloc_size(ctx, 8 + (i % 8) * 16, 8);
+               EXPECT_NE(objs[t][i], nullptr);
+            }
+            for (unsigned i = 0; i < 256; i++)
+               gc_free(objs[t][i]);
+         }
+      });
+   }
+
+   for (std::thread &thread : threads)
+      thread.join();
+
+   gc_set_thread_safe(ctx, false);
+   ralloc_free(ctx);
+}
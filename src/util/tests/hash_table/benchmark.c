@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Compares struct hash_table and struct swiss_table with pointer keys,
+ * which is what most users (e.g. NIR passes) use.
+ *
+ * Usage: hash_table_benchmark [num_keys] [iterations]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "util/hash_table.h"
+#include "util/os_time.h"
+#include "util/swiss_table.h"
+
+static int64_t
+now(void)
+{
+   return os_time_get_nano();
+}
+
+static void
+bench_hash_table(void **keys, unsigned num_keys, unsigned iterations,
+                 int64_t times[4], uintptr_t *sum)
+{
+   for (unsigned it = 0; it < iterations; it++) {
+      struct hash_table ht;
+      int64_t t0 = now();
+
+      _mesa_pointer_hash_table_init(&ht, NULL);
+      for (unsigned i = 0; i < num_keys; i++)
+         _mesa_hash_table_insert(&ht, keys[i], keys[i]);
+
+      int64_t t1 = now();
+
+      for (unsigned i = 0; i < num_keys; i++)
+         *sum += (uintptr_t)_mesa_hash_table_search(&ht, keys[i])->data;
+
+      int64_t t2 = now();
+
+      /* Keys that aren't in the table. */
+      for (unsigned i = 0; i < num_keys; i++)
+         *sum += _mesa_hash_table_search(&ht, (char *)keys[i] + 1) != NULL;
+
+      int64_t t3 = now();
+
+      for (unsigned i = 0; i < num_keys; i++)
+         _mesa_hash_table_remove_key(&ht, keys[i]);
+
+      int64_t t4 = now();
+
+      _mesa_hash_table_fini(&ht, NULL);
+
+      times[0] += t1 - t0;
+      times[1] += t2 - t1;
+      times[2] += t3 - t2;
+      times[3] += t4 - t3;
+   }
+}
+
+static void
+bench_swiss_table(void **keys, unsigned num_keys, unsigned iterations,
+                  int64_t times[4], uintptr_t *sum)
+{
+   for (unsigned it = 0; it < iterations; it++) {
+      struct swiss_table st;
+      int64_t t0 = now();
+
+      _mesa_pointer_swiss_table_init(&st, NULL);
+      for (unsigned i = 0; i < num_keys; i++)
+         _mesa_swiss_table_insert(&st, keys[i], keys[i]);
+
+      int64_t t1 = now();
+
+      for (unsigned i = 0; i < num_keys; i++)
+         *sum += (uintptr_t)_mesa_swiss_table_search(&st, keys[i])->data;
+
+      int64_t t2 = now();
+
+      /* Keys that aren't in the table. */
+      for (unsigned i = 0; i < num_keys; i++)
+         *sum += _mesa_swiss_table_search(&st, (char *)keys[i] + 1) != NULL;
+
+      int64_t t3 = now();
+
+      for (unsigned i = 0; i < num_keys; i++)
+         _mesa_swiss_table_remove_key(&st, keys[i]);
+
+      int64_t t4 = now();
+
+      _mesa_swiss_table_fini(&st, NULL);
+
+      times[0] += t1 - t0;
+      times[1] += t2 - t1;
+      times[2] += t3 - t2;
+      times[3] += t4 - t3;
+   }
+}
+
+static void
+print_times(const char *name, const int64_t times[4], unsigned num_ops)
+{
+   printf("%-12s insert %6.2f  hit %6.2f  miss %6.2f  remove %6.2f ns/op\n",
+          name, (double)times[0] / num_ops, (double)times[1] / num_ops,
+          (double)times[2] / num_ops, (double)times[3] / num_ops);
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned num_keys = argc > 1 ? atoi(argv[1]) : 1000;
+   unsigned iterations = argc > 2 ? atoi(argv[2]) : 1000;
+   int64_t ht_times[4] = {0}, st_times[4] = {0};
+   uintptr_t sum = 0;
+
+   /* Allocate the keys separately, like the NIR instructions that are
+    * usually used as keys.
+    */
+   void **keys = malloc(num_keys * sizeof(void *));
+   for (unsigned i = 0; i < num_keys; i++)
+      keys[i] = malloc(48);
+
+   bench_hash_table(keys, num_keys, iterations, ht_times, &sum);
+   bench_swiss_table(keys, num_keys, iterations, st_times, &sum);
+
+   printf("%u keys, %u iterations\n", num_keys, iterations);
+   print_times("hash_table", ht_times, num_keys * iterations);
+   print_times("swiss_table", st_times, num_keys * iterations);
+
+   for (unsigned i = 0; i < num_keys; i++)
+      free(keys[i]);
+   free(keys);
+
+   /* Use the results so that the lookups can't be optimized out. */
+   return sum == 0;
+}
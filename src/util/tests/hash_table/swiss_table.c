@@ -0,0 +1,115 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "util/swiss_table.h"
+
+#define SIZE 10000
+
+static uint32_t
+key_value(const void *key)
+{
+   return *(const uint32_t *)key;
+}
+
+static bool
+uint32_t_key_equals(const void *a, const void *b)
+{
+   return key_value(a) == key_value(b);
+}
+
+static unsigned delete_count;
+
+static void
+delete_callback(struct hash_entry *entry)
+{
+   delete_count++;
+}
+
+int
+main(int argc, char **argv)
+{
+   struct swiss_table *st;
+   struct hash_entry *entry;
+   static uint32_t keys[SIZE];
+   uint32_t i;
+
+   (void) argc;
+   (void) argv;
+
+   st = _mesa_swiss_table_create(NULL, key_value, uint32_t_key_equals);
+
+   assert(_mesa_swiss_table_search(st, keys) == NULL);
+
+   for (i = 0; i < SIZE; i++) {
+      keys[i] = i;
+
+      _mesa_swiss_table_insert(st, keys + i, NULL);
+   }
+
+   for (i = 0; i < SIZE; i++) {
+      entry = _mesa_swiss_table_search(st, keys + i);
+      assert(entry);
+      assert(key_value(entry->key) == i);
+   }
+   assert(_mesa_swiss_table_num_entries(st) == SIZE);
+
+   /* Replacement */
+   entry = _mesa_swiss_table_insert(st, keys + 5, keys);
+   assert(entry->data == keys);
+   assert(_mesa_swiss_table_num_entries(st) == SIZE);
+
+   /* Deletion while iterating */
+   swiss_table_foreach(st, entry) {
+      if (key_value(entry->key) % 2)
+         _mesa_swiss_table_remove(st, entry);
+   }
+   assert(_mesa_swiss_table_num_entries(st) == SIZE / 2);
+
+   for (i = 0; i < SIZE; i++) {
+      entry = _mesa_swiss_table_search(st, keys + i);
+      assert((entry != NULL) == (i % 2 == 0));
+   }
+
+   unsigned count = 0;
+   swiss_table_foreach(st, entry) {
+      assert(key_value(entry->key) % 2 == 0);
+      count++;
+   }
+   assert(count == SIZE / 2);
+
+   /* Reinsertion reuses the deleted slots */
+   for (i = 1; i < SIZE; i += 2)
+      _mesa_swiss_table_insert(st, keys + i, NULL);
+   assert(_mesa_swiss_table_num_entries(st) == SIZE);
+
+   for (i = 0; i < SIZE; i++)
+      assert(_mesa_swiss_table_search(st, keys + i));
+
+   _mesa_swiss_table_remove_key(st, keys + 7);
+   assert(!_mesa_swiss_table_search(st, keys + 7));
+
+   _mesa_swiss_table_clear(st, delete_callback);
+   assert(delete_count == SIZE - 1);
+   assert(_mesa_swiss_table_num_entries(st) == 0);
+   assert(!_mesa_swiss_table_search(st, keys));
+
+   _mesa_swiss_table_destroy(st, NULL);
+
+   /* NULL is a valid key */
+   st = _mesa_pointer_swiss_table_create(NULL);
+   assert(_mesa_swiss_table_reserve(st, SIZE));
+   _mesa_swiss_table_insert(st, NULL, keys);
+   entry = _mesa_swiss_table_search(st, NULL);
+   assert(entry && entry->data == keys);
+   _mesa_swiss_table_destroy(st, NULL);
+
+   return 0;
+}
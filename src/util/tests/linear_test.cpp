@@ -89,3 +89,40 @@ TEST(LinearAlloc, Options)
 
    ralloc_free(ctx);
 }
+
+TEST(LinearAlloc, Arena)
+{
+   void *ctx = ralloc_context(NULL);
+
+   linear_opts opts = {};
+   opts.arena = true;
+
+   for (int iter = 0; iter < 3; iter++) {
+      /* The buffers of the previous iterations are recycled. */
+      linear_ctx *lin_ctx = linear_context_with_opts(ctx, &opts);
+      EXPECT_EQ(ralloc_parent_of_linear_context(lin_ctx), ctx);
+
+      int *ptrs[1000];
+      for (int i = 0; i < 1000; i++) {
+         ptrs[i] = (int *)linear_alloc_child(lin_ctx, 100 + i);
+         ASSERT_NE(ptrs[i], nullptr);
+         ptrs[i][0] = i;
+      }
+
+      /* Larger than any buffer. */
+      char *large = (char *)linear_zalloc_child(lin_ctx, 1024 * 1024);
+      ASSERT_NE(large, nullptr);
+      EXPECT_EQ(large[1024 * 1024 - 1], 0);
+
+      for (int i = 0; i < 1000; i++)
+         EXPECT_EQ(ptrs[i][0], i);
+
+      if (iter == 2)
+         break;
+
+      linear_free_context(lin_ctx);
+   }
+
+   /* Freeing the parent also frees the last linear context. */
+   ralloc_free(ctx);
+}
@@ -4,6 +4,7 @@
  */
 
 #include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -52,3 +53,54 @@ TEST(range_minimum_query_test, range_minimum_query_test)
 
    ralloc_free(context);
 }
+
+static uint32_t
+tree_lca_naive(const std::vector<uint32_t> &parent, uint32_t a, uint32_t b)
+{
+   /* Parents always have a smaller preorder index */
+   while (a != b) {
+      if (a > b)
+         a = parent[a];
+      else
+         b = parent[b];
+   }
+   return a;
+}
+
+TEST(range_minimum_query_test, tree_lca_test)
+{
+   void* context = ralloc_context(nullptr);
+
+   std::mt19937 gen(1337);
+
+   struct range_minimum_query_table table;
+   range_minimum_query_table_init(&table);
+
+   for (uint32_t num_nodes = 1; num_nodes < 128; num_nodes++) {
+      /* Build a random tree numbered in preorder: the parent of each new node
+       * is somewhere on the path from the root to the previous node.
+       */
+      std::vector<uint32_t> parent(num_nodes, 0);
+      std::vector<uint32_t> path = { 0 };
+      for (uint32_t i = 1; i < num_nodes; i++) {
+         std::uniform_int_distribution<> distrib(1, path.size());
+         path.resize(distrib(gen));
+         parent[i] = path.back();
+         path.push_back(i);
+      }
+
+      range_minimum_query_table_resize(&table, context, num_nodes);
+      for (uint32_t i = 0; i < num_nodes; i++)
+         table.table[i] = parent[i];
+      range_minimum_query_table_preprocess(&table);
+
+      for (uint32_t a = 0; a < num_nodes; a++) {
+         for (uint32_t b = 0; b < num_nodes; b++) {
+            EXPECT_EQ(range_minimum_query_tree_lca(&table, a, b),
+                      tree_lca_naive(parent, a, b));
+         }
+      }
+   }
+
+   ralloc_free(context);
+}
@@ -279,3 +279,46 @@ TEST_F(ra_test, serialization_roundtrip)
    blob_finish(&blob);
 }
 
+
+/* A long chain of nodes where only the bottom end is trivially colorable:
+ * every node pushed on the stack makes the next higher one colorable, which
+ * takes a new simplification sweep each time.
+ */
+TEST_F(ra_test, large_chain)
+{
+   const unsigned num_regs = 4;
+   const unsigned num_nodes = 20000;
+   const unsigned window = num_regs - 1;
+
+   struct ra_regs *regs = ra_alloc_reg_set(mem_ctx, num_regs, true);
+   struct ra_class *c = ra_alloc_contig_reg_class(regs, 1);
+   for (unsigned i = 0; i < num_regs; i++)
+      ra_class_add_reg(c, i);
+   ra_set_finalize(regs, NULL);
+
+   struct ra_graph *g = ra_alloc_interference_graph(regs, num_nodes);
+   ralloc_steal(mem_ctx, g);
+
+   for (unsigned i = 0; i < num_nodes; i++)
+      ra_set_node_class(g, i, c);
+
+   /* Each node interferes with the next few, like back-to-back live ranges. */
+   for (unsigned i = 0; i < num_nodes; i++) {
+      for (unsigned j = i + 1; j < num_nodes && j <= i + window; j++)
+         ra_add_node_interference(g, i, j);
+   }
+
+   /* Pre-assigning the top of the chain keeps it from being simplified. */
+   for (unsigned i = 0; i < window; i++)
+      ra_set_node_reg(g, num_nodes - 1 - i, i);
+
+   ASSERT_TRUE(ra_allocate(g));
+
+   for (unsigned i = 0; i < num_nodes; i++) {
+      unsigned reg = ra_get_node_reg(g, i);
+      ASSERT_LT(reg, num_regs);
+
+      for (unsigned j = i + 1; j < num_nodes && j <= i + window; j++)
+         ASSERT_NE(reg, ra_get_node_reg(g, j));
+   }
+}
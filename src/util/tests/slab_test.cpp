@@ -0,0 +1,165 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Testing slab.h
+ */
+
+#include <stdio.h>
+#include <gtest/gtest.h>
+
+#include "c11/threads.h"
+#include "util/os_time.h"
+#include "util/slab.h"
+#include "util/u_atomic.h"
+
+#define NUM_ITEMS 100000
+#define BATCH_SIZE 256
+
+struct item {
+   unsigned value;
+};
+
+TEST(Slab, AllocFree)
+{
+   struct slab_mempool pool;
+   struct item *items[1000];
+
+   slab_create(&pool, sizeof(struct item), 64);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(items); i++) {
+      items[i] = (struct item *)slab_alloc_st(&pool);
+      ASSERT_NE(items[i], nullptr);
+      items[i]->value = i;
+   }
+
+   for (unsigned i = 0; i < ARRAY_SIZE(items); i++)
+      EXPECT_EQ(items[i]->value, i);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(items); i++)
+      slab_free_st(&pool, items[i]);
+
+   slab_destroy(&pool);
+}
+
+TEST(Slab, ForeignFree)
+{
+   struct slab_parent_pool parent;
+   struct slab_child_pool a, b;
+   struct item *items[1000];
+
+   slab_create_parent(&parent, sizeof(struct item), 64);
+   slab_create_child(&a, &parent);
+   slab_create_child(&b, &parent);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(items); i++)
+      items[i] = (struct item *)slab_alloc(&a);
+
+   /* Free everything with the other pool, then reallocate from the owner.
+    */
+   for (unsigned round = 0; round < 4; round++) {
+      for (unsigned i = 0; i < ARRAY_SIZE(items); i++)
+         slab_free(&b, items[i]);
+
+      /* Returns the remaining elements of "a" held by "b". */
+      (void)slab_alloc(&b);
+
+      for (unsigned i = 0; i < ARRAY_SIZE(items); i++) {
+         items[i] = (struct item *)slab_alloc(&a);
+         ASSERT_NE(items[i], nullptr);
+      }
+   }
+
+   /* Destroy the owner first, the orphaned elements are freed through the
+    * other pool.
+    */
+   slab_destroy_child(&a);
+   for (unsigned i = 0; i < ARRAY_SIZE(items); i++)
+      slab_free(&b, items[i]);
+   slab_destroy_child(&b);
+   slab_destroy_parent(&parent);
+}
+
+struct cross_thread_state {
+   struct slab_parent_pool *parent;
+   struct item **items;
+   unsigned num_produced; /* atomic */
+   unsigned num_consumed; /* atomic */
+};
+
+/* Free the items allocated by the main thread with a different pool. */
+static int
+consumer_thread(void *data)
+{
+   struct cross_thread_state *state = (struct cross_thread_state *)data;
+   struct slab_child_pool pool;
+
+   slab_create_child(&pool, state->parent);
+
+   for (unsigned i = 0; i < NUM_ITEMS; i++) {
+      while (p_atomic_read(&state->num_produced) <= i)
+         thrd_yield();
+
+      EXPECT_EQ(state->items[i]->value, i);
+      slab_free(&pool, state->items[i]);
+      p_atomic_inc(&state->num_consumed);
+   }
+
+   slab_destroy_child(&pool);
+   return 0;
+}
+
+static int64_t
+run_cross_thread_free()
+{
+   struct slab_parent_pool parent;
+   struct slab_child_pool pool;
+   struct cross_thread_state state = {};
+   thrd_t thread;
+
+   slab_create_parent(&parent, sizeof(struct item), 64);
+   slab_create_child(&pool, &parent);
+
+   state.parent = &parent;
+   state.items = (struct item **)calloc(NUM_ITEMS, sizeof(struct item *));
+
+   int64_t start = os_time_get_nano();
+   thrd_create(&thread, consumer_thread, &state);
+
+   for (unsigned i = 0; i < NUM_ITEMS; i++) {
+      /* Don't get too far ahead of the consumer. */
+      while (i - p_atomic_read(&state.num_consumed) > BATCH_SIZE)
+         thrd_yield();
+
+      struct item *item = (struct item *)slab_alloc(&pool);
+      item->value = i;
+      state.items[i] = item;
+      p_atomic_inc(&state.num_produced);
+   }
+
+   thrd_join(thread, NULL);
+   int64_t time = os_time_get_nano() - start;
+
+   slab_destroy_child(&pool);
+   slab_destroy_parent(&parent);
+   free(state.items);
+
+   return time;
+}
+
+TEST(Slab, CrossThreadFree)
+{
+   run_cross_thread_free();
+}
+
+/* Run with --gtest_also_run_disabled_tests. */
+TEST(Slab, DISABLED_BenchmarkCrossThreadFree)
+{
+   int64_t time = 0;
+
+   for (unsigned i = 0; i < 10; i++)
+      time += run_cross_thread_free();
+
+   printf("cross-thread alloc+free: %.2f ns/item\n",
+          (double)time / (10.0 * NUM_ITEMS));
+}
@@ -27,6 +27,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #define NUM_SETS_PER_THREAD (1 << 10)
 #define MAX_ARR_SIZE (1 << 20)
 
@@ -76,3 +78,39 @@ TEST(SparseArrayTest, Multithread)
       util_sparse_array_finish(&arr);
    }
 }
+
+TEST(SparseArrayTest, GetMany)
+{
+   for (size_t node_size = 4; node_size <= 1024; node_size *= 4) {
+      struct util_sparse_array arr;
+      util_sparse_array_init(&arr, sizeof(uint64_t), node_size);
+
+      /* Runs of consecutive indices on both sides of the flat range with a
+       * few random ones mixed in.
+       */
+      const uint32_t flat_end = UTIL_SPARSE_ARRAY_FLAT_LEAVES * node_size;
+      std::vector<uint32_t> idx;
+      for (uint32_t i = 0; i < 3 * node_size; i++)
+         idx.push_back(flat_end - node_size + i);
+      for (uint32_t i = 0; i < 64; i++)
+         idx.push_back(rand() % MAX_ARR_SIZE);
+      for (uint32_t i = 0; i < 2 * node_size; i++)
+         idx.push_back(i);
+
+      std::vector<void *> elems(idx.size());
+      util_sparse_array_get_many(&arr, idx.data(), idx.size(), elems.data());
+
+      for (unsigned i = 0; i < idx.size(); i++) {
+         ASSERT_EQ(elems[i], util_sparse_array_get(&arr, idx[i]))
+            << "Element " << i << " (index " << idx[i] << ") doesn't match";
+         *(uint64_t *)elems[i] = idx[i];
+      }
+
+      util_sparse_array_validate(&arr);
+
+      for (unsigned i = 0; i < idx.size(); i++)
+         ASSERT_EQ(*(uint64_t *)util_sparse_array_get(&arr, idx[i]), idx[i]);
+
+      util_sparse_array_finish(&arr);
+   }
+}
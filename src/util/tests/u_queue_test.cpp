@@ -0,0 +1,250 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ *
+ * Testing u_queue.h
+ */
+
+#include <gtest/gtest.h>
+
+#include "util/u_atomic.h"
+#include "util/u_queue.h"
+
+#define NUM_JOBS 4096
+
+struct test_job {
+   struct util_queue_fence fence;
+   unsigned value;
+   int *sum;
+};
+
+static void
+test_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct test_job *job = (struct test_job *)data;
+
+   p_atomic_add(job->sum, job->value);
+}
+
+static void
+test_jobs(unsigned num_threads, unsigned flags)
+{
+   struct util_queue queue;
+   struct test_job *jobs = new test_job[NUM_JOBS];
+   int sum = 0;
+   int expected = 0;
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 8, num_threads, flags, NULL));
+
+   for (unsigned i = 0; i < NUM_JOBS; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      jobs[i].value = i;
+      jobs[i].sum = &sum;
+      expected += i;
+
+      util_queue_add_job(&queue, &jobs[i], &jobs[i].fence, test_job_execute,
+                         NULL, 0);
+   }
+
+   for (unsigned i = 0; i < NUM_JOBS; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+
+   EXPECT_EQ(p_atomic_read(&sum), expected);
+
+   util_queue_destroy(&queue);
+   delete[] jobs;
+}
+
+static void
+test_finish(unsigned num_threads, unsigned flags)
+{
+   struct util_queue queue;
+   struct test_job *jobs = new test_job[NUM_JOBS];
+   int sum = 0;
+   int expected = 0;
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 8, num_threads, flags, NULL));
+
+   for (unsigned i = 0; i < NUM_JOBS; i++) {
+      jobs[i].value = i;
+      jobs[i].sum = &sum;
+      expected += i;
+
+      util_queue_add_job(&queue, &jobs[i], NULL, test_job_execute, NULL, 0);
+
+      if (i % 512 == 0)
+         util_queue_finish(&queue);
+   }
+
+   util_queue_finish(&queue);
+   EXPECT_EQ(p_atomic_read(&sum), expected);
+
+   util_queue_destroy(&queue);
+   delete[] jobs;
+}
+
+static void
+test_drop_job(unsigned num_threads, unsigned flags)
+{
+   struct util_queue queue;
+   struct test_job *jobs = new test_job[NUM_JOBS];
+   int sum = 0;
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", NUM_JOBS, num_threads, flags,
+                               NULL));
+
+   for (unsigned i = 0; i < NUM_JOBS; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      jobs[i].value = 1;
+      jobs[i].sum = &sum;
+
+      util_queue_add_job(&queue, &jobs[i], &jobs[i].fence, test_job_execute,
+                         NULL, 0);
+   }
+
+   /* Every job is either executed or dropped, but the fence is signalled
+    * in both cases.
+    */
+   for (unsigned i = 0; i < NUM_JOBS; i += 2)
+      util_queue_drop_job(&queue, &jobs[i].fence);
+
+   for (unsigned i = 0; i < NUM_JOBS; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+
+   EXPECT_GE(p_atomic_read(&sum), NUM_JOBS / 2);
+   EXPECT_LE(p_atomic_read(&sum), NUM_JOBS);
+
+   util_queue_destroy(&queue);
+   delete[] jobs;
+}
+
+struct order_job {
+   struct util_queue_fence fence;
+   unsigned id;
+   unsigned *order;
+   unsigned *num_executed;
+};
+
+static void
+gate_job_execute(void *data, void *gdata, int thread_index)
+{
+   util_queue_fence_wait((struct util_queue_fence *)data);
+}
+
+static void
+order_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct order_job *job = (struct order_job *)data;
+
+   job->order[(*job->num_executed)++] = job->id;
+}
+
+static void
+test_priority(unsigned flags)
+{
+   struct util_queue queue;
+   struct util_queue_fence gate, gate_done;
+   struct order_job jobs[6];
+   unsigned order[6];
+   unsigned num_executed = 0;
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 8, 1, flags, NULL));
+
+   /* Block the only thread until all jobs are queued. */
+   util_queue_fence_init(&gate);
+   util_queue_fence_init(&gate_done);
+   util_queue_fence_reset(&gate);
+   util_queue_add_job(&queue, &gate, &gate_done, gate_job_execute, NULL, 0);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(jobs); i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      jobs[i].id = i;
+      jobs[i].order = order;
+      jobs[i].num_executed = &num_executed;
+   }
+
+   util_queue_add_job(&queue, &jobs[0], &jobs[0].fence, order_job_execute,
+                      NULL, 0);
+   util_queue_add_job(&queue, &jobs[1], &jobs[1].fence, order_job_execute,
+                      NULL, 0);
+   util_queue_add_job(&queue, &jobs[2], &jobs[2].fence, order_job_execute,
+                      NULL, 0);
+   util_queue_add_job_with_priority(&queue, &jobs[3], &jobs[3].fence,
+                                    order_job_execute, NULL, 0,
+                                    UTIL_QUEUE_PRIORITY_HIGH);
+   util_queue_add_job_with_priority(&queue, &jobs[4], &jobs[4].fence,
+                                    order_job_execute, NULL, 0,
+                                    UTIL_QUEUE_PRIORITY_HIGH);
+   util_queue_add_job(&queue, &jobs[5], &jobs[5].fence, order_job_execute,
+                      NULL, 0);
+
+   /* Bumped jobs go after the high priority jobs that are already queued. */
+   util_queue_prioritize_job(&queue, &jobs[2].fence);
+
+   util_queue_fence_signal(&gate);
+   util_queue_finish(&queue);
+
+   const unsigned expected[] = { 3, 4, 2, 0, 1, 5 };
+   ASSERT_EQ(num_executed, ARRAY_SIZE(expected));
+   for (unsigned i = 0; i < ARRAY_SIZE(expected); i++)
+      EXPECT_EQ(order[i], expected[i]) << "job " << i;
+
+   for (unsigned i = 0; i < ARRAY_SIZE(jobs); i++)
+      util_queue_fence_destroy(&jobs[i].fence);
+   util_queue_fence_destroy(&gate_done);
+   util_queue_fence_destroy(&gate);
+   util_queue_destroy(&queue);
+}
+
+TEST(UtilQueue, Jobs)
+{
+   test_jobs(1, 0);
+   test_jobs(8, 0);
+   test_jobs(8, UTIL_QUEUE_INIT_RESIZE_IF_FULL);
+}
+
+TEST(UtilQueue, Finish)
+{
+   test_finish(1, 0);
+   test_finish(8, 0);
+}
+
+TEST(UtilQueue, DropJob)
+{
+   test_drop_job(1, 0);
+   test_drop_job(8, 0);
+}
+
+TEST(UtilQueue, Priority)
+{
+   test_priority(0);
+}
+
+TEST(UtilQueue, WorkStealingJobs)
+{
+   test_jobs(1, UTIL_QUEUE_INIT_WORK_STEALING);
+   test_jobs(8, UTIL_QUEUE_INIT_WORK_STEALING);
+   test_jobs(8, UTIL_QUEUE_INIT_WORK_STEALING |
+                UTIL_QUEUE_INIT_RESIZE_IF_FULL);
+}
+
+TEST(UtilQueue, WorkStealingFinish)
+{
+   test_finish(1, UTIL_QUEUE_INIT_WORK_STEALING);
+   test_finish(8, UTIL_QUEUE_INIT_WORK_STEALING);
+}
+
+TEST(UtilQueue, WorkStealingDropJob)
+{
+   test_drop_job(1, UTIL_QUEUE_INIT_WORK_STEALING);
+   test_drop_job(8, UTIL_QUEUE_INIT_WORK_STEALING);
+}
+
+TEST(UtilQueue, WorkStealingPriority)
+{
+   test_priority(UTIL_QUEUE_INIT_WORK_STEALING);
+}
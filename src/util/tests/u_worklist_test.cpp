@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "util/u_worklist.h"
+
+struct entry {
+   unsigned index;
+};
+
+TEST(u_priority_worklist, pop_order)
+{
+   const unsigned num_entries = 200;
+   std::vector<entry> entries(num_entries);
+   for (unsigned i = 0; i < num_entries; i++)
+      entries[i].index = i;
+
+   u_priority_worklist w;
+   u_priority_worklist_init(&w, num_entries, NULL);
+
+   static const unsigned pushed[] = { 150, 3, 64, 199, 31, 32, 3, 0, 150 };
+   for (unsigned i : pushed)
+      u_priority_worklist_push(&w, &entries[i], index);
+
+   /* Duplicates are only present once */
+   EXPECT_EQ(w.count, 7);
+
+   EXPECT_EQ(u_priority_worklist_pop_first(&w, entry, index), &entries[0]);
+   EXPECT_EQ(u_priority_worklist_pop_last(&w, entry, index), &entries[199]);
+   EXPECT_EQ(u_priority_worklist_pop_first(&w, entry, index), &entries[3]);
+
+   /* Pushing below the current minimum must be seen by the next pop */
+   u_priority_worklist_push(&w, &entries[1], index);
+   EXPECT_EQ(u_priority_worklist_pop_first(&w, entry, index), &entries[1]);
+
+   /* So must pushing above the current maximum */
+   u_priority_worklist_push(&w, &entries[198], index);
+   EXPECT_EQ(u_priority_worklist_pop_last(&w, entry, index), &entries[198]);
+
+   EXPECT_EQ(u_priority_worklist_pop_last(&w, entry, index), &entries[150]);
+   EXPECT_EQ(u_priority_worklist_pop_last(&w, entry, index), &entries[64]);
+   EXPECT_EQ(u_priority_worklist_pop_first(&w, entry, index), &entries[31]);
+   EXPECT_EQ(u_priority_worklist_pop_first(&w, entry, index), &entries[32]);
+   EXPECT_TRUE(u_priority_worklist_is_empty(&w));
+
+   /* A popped entry can be pushed again */
+   u_priority_worklist_push(&w, &entries[31], index);
+   EXPECT_EQ(u_priority_worklist_pop_last(&w, entry, index), &entries[31]);
+   EXPECT_TRUE(u_priority_worklist_is_empty(&w));
+
+   u_priority_worklist_fini(&w);
+}
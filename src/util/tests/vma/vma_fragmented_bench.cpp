@@ -0,0 +1,117 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Times util_vma_heap operations on a heap fragmented into many small holes,
+ * which is what long running processes with lots of buffers end up with.
+ */
+
+/* it is a test after all */
+#undef NDEBUG
+
+#include <cassert>
+#include <cinttypes>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "util/os_time.h"
+#include "util/vma.h"
+
+static const uint64_t PAGE_SIZE = 4096;
+static const uint64_t HEAP_START = 1ull << 20;
+
+static void
+report(const char *name, unsigned count, int64_t start_ns)
+{
+   int64_t ns = os_time_get_nano() - start_ns;
+   printf("%-24s %8u ops %10.1f ns/op\n", name, count, (double)ns / count);
+}
+
+static void
+bench(unsigned count, bool alloc_high)
+{
+   struct util_vma_heap heap;
+
+   /* Leave enough room for as many two-page allocations as single pages. */
+   const uint64_t heap_size = 4 * count * PAGE_SIZE;
+   util_vma_heap_init(&heap, HEAP_START, heap_size);
+   heap.alloc_high = alloc_high;
+
+   printf("%s:\n", alloc_high ? "alloc_high" : "alloc_low");
+
+   std::vector<uint64_t> pages(count);
+   int64_t start = os_time_get_nano();
+   for (unsigned i = 0; i < count; i++) {
+      pages[i] = util_vma_heap_alloc(&heap, PAGE_SIZE, PAGE_SIZE);
+      assert(pages[i] != 0);
+   }
+   report("alloc 1 page", count, start);
+
+   /* Free every other page, leaving count / 2 single page holes behind. */
+   start = os_time_get_nano();
+   for (unsigned i = 0; i < count; i += 2)
+      util_vma_heap_free(&heap, pages[i], PAGE_SIZE);
+   report("free", (count + 1) / 2, start);
+
+   /* None of the holes fit, so these all come from the remaining space. */
+   std::vector<uint64_t> pairs(count / 2);
+   start = os_time_get_nano();
+   for (unsigned i = 0; i < count / 2; i++) {
+      pairs[i] = util_vma_heap_alloc(&heap, 2 * PAGE_SIZE, PAGE_SIZE);
+      assert(pairs[i] != 0);
+   }
+   report("alloc 2 pages", count / 2, start);
+
+   uint64_t max_free = 0;
+   start = os_time_get_nano();
+   for (unsigned i = 0; i < count / 2; i++)
+      max_free += util_vma_heap_get_max_free_continuous_size(&heap);
+   report("max_free_size", count / 2, start);
+   assert(max_free > 0);
+
+   /* Fill the holes again at fixed addresses. */
+   start = os_time_get_nano();
+   for (unsigned i = 0; i < count; i += 2) {
+      bool ok = util_vma_heap_alloc_addr(&heap, pages[i], PAGE_SIZE);
+      assert(ok);
+   }
+   report("alloc_addr", (count + 1) / 2, start);
+
+   for (unsigned i = 0; i < count; i++)
+      util_vma_heap_free(&heap, pages[i], PAGE_SIZE);
+   for (unsigned i = 0; i < count / 2; i++)
+      util_vma_heap_free(&heap, pairs[i], 2 * PAGE_SIZE);
+
+   /* Everything should have been merged back into a single hole. */
+   assert(heap.free_size == heap_size);
+   assert(util_vma_heap_get_max_free_continuous_size(&heap) == heap_size);
+
+   util_vma_heap_finish(&heap);
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned long count = 10000;
+
+   if (argc == 2) {
+      char *arg_end = NULL;
+      count = strtoul(argv[1], &arg_end, 0);
+      if (!arg_end || *arg_end || count == 0 || count > UINT_MAX / 4) {
+         fprintf(stderr, "invalid count \"%s\"\n", argv[1]);
+         return 1;
+      }
+   } else if (argc != 1) {
+      fprintf(stderr, "USAGE: %s [count]\n", argv[0]);
+      return 1;
+   }
+
+   bench(count, true);
+   bench(count, false);
+
+   return 0;
+}
@@ -36,6 +36,7 @@
 #include "texcompress_astc.h"
 #include "macros.h"
 #include "util/half_float.h"
+#include "util/u_parallel.h"
 #include <stdio.h>
 #include <cstdlib>  // for abort() on windows
 #include <stdarg.h>
@@ -1626,6 +1627,23 @@ void Block::write_decoded(const Decoder &decoder, uint16_t *output)
 
    int small_block = (decoder.block_w * decoder.block_h * decoder.block_d) < 31;
 
+   /* Expand the endpoints of each partition to 16 bits. */
+   uint16_t c0s[4][4], c1s[4][4];
+   for (int p = 0; p < num_parts; ++p) {
+      uint8x4_t e0 = endpoints_decoded[0][p];
+      uint8x4_t e1 = endpoints_decoded[1][p];
+
+      for (int i = 0; i < 4; ++i) {
+         if (decoder.srgb) {
+            c0s[p][i] = (uint16_t)((e0.v[i] << 8) | 0x80);
+            c1s[p][i] = (uint16_t)((e1.v[i] << 8) | 0x80);
+         } else {
+            c0s[p][i] = (uint16_t)((e0.v[i] << 8) | e0.v[i]);
+            c1s[p][i] = (uint16_t)((e1.v[i] << 8) | e1.v[i]);
+         }
+      }
+   }
+
    int idx = 0;
    for (int z = 0; z < decoder.block_d; ++z) {
       for (int y = 0; y < decoder.block_h; ++y) {
@@ -1641,32 +1659,8 @@ void Block::write_decoded(const Decoder &decoder, uint16_t *output)
 
             /* TODO: HDR */
 
-            uint8x4_t e0 = endpoints_decoded[0][partition];
-            uint8x4_t e1 = endpoints_decoded[1][partition];
-            uint16_t c0[4], c1[4];
-
-            /* Expand to 16 bits. */
-            if (decoder.srgb) {
-               c0[0] = (uint16_t)((e0.v[0] << 8) | 0x80);
-               c0[1] = (uint16_t)((e0.v[1] << 8) | 0x80);
-               c0[2] = (uint16_t)((e0.v[2] << 8) | 0x80);
-               c0[3] = (uint16_t)((e0.v[3] << 8) | 0x80);
-
-               c1[0] = (uint16_t)((e1.v[0] << 8) | 0x80);
-               c1[1] = (uint16_t)((e1.v[1] << 8) | 0x80);
-               c1[2] = (uint16_t)((e1.v[2] << 8) | 0x80);
-               c1[3] = (uint16_t)((e1.v[3] << 8) | 0x80);
-            } else {
-               c0[0] = (uint16_t)((e0.v[0] << 8) | e0.v[0]);
-               c0[1] = (uint16_t)((e0.v[1] << 8) | e0.v[1]);
-               c0[2] = (uint16_t)((e0.v[2] << 8) | e0.v[2]);
-               c0[3] = (uint16_t)((e0.v[3] << 8) | e0.v[3]);
-
-               c1[0] = (uint16_t)((e1.v[0] << 8) | e1.v[0]);
-               c1[1] = (uint16_t)((e1.v[1] << 8) | e1.v[1]);
-               c1[2] = (uint16_t)((e1.v[2] << 8) | e1.v[2]);
-               c1[3] = (uint16_t)((e1.v[3] << 8) | e1.v[3]);
-            }
+            const uint16_t *c0 = c0s[partition];
+            const uint16_t *c1 = c1s[partition];
 
             int w[4];
             if (dual_plane) {
@@ -1797,36 +1791,36 @@ decode_error::type Block::calculate_colour_endpoints_size()
    return decode_error::invalid_colour_endpoints_size;
 }
 
-/**
- * Decode ASTC 2D LDR texture data.
- *
- * \param src_width in pixels
- * \param src_height in pixels
- * \param dst_stride in bytes
+/* Images are decoded by several threads in bands of at least this many
+ * blocks.
  */
-extern "C" void
-_mesa_unpack_astc_2d_ldr(uint8_t *dst_row,
-                         unsigned dst_stride,
-                         const uint8_t *src_row,
-                         unsigned src_stride,
-                         unsigned src_width,
-                         unsigned src_height,
-                         enum pipe_format format)
-{
-   const struct util_format_description *desc =
-      util_format_description(format);
-   assert(desc && desc->layout == UTIL_FORMAT_LAYOUT_ASTC &&
-          desc->block.depth == 1);
-   bool srgb = util_format_is_srgb(format);
+#define ASTC_PARALLEL_MIN_BLOCKS (8 * 1024)
+
+struct astc_image {
+   const Decoder *dec;
+   uint8_t *dst_row;
+   unsigned dst_stride;
+   const uint8_t *src_row;
+   unsigned src_stride;
+   unsigned src_width;
+   unsigned src_height;
+};
 
-   unsigned blk_w = desc->block.width, blk_h = desc->block.height;
+static void
+unpack_astc_rows(const Decoder &dec,
+                 uint8_t *dst_row,
+                 unsigned dst_stride,
+                 const uint8_t *src_row,
+                 unsigned src_stride,
+                 unsigned src_width,
+                 unsigned src_height)
+{
+   unsigned blk_w = dec.block_w, blk_h = dec.block_h;
 
    const unsigned block_size = 16;
    unsigned x_blocks = (src_width + blk_w - 1) / blk_w;
    unsigned y_blocks = (src_height + blk_h - 1) / blk_h;
 
-   Decoder dec(blk_w, blk_h, 1, srgb, true);
-
    for (unsigned y = 0; y < y_blocks; ++y) {
       for (unsigned x = 0; x < x_blocks; ++x) {
          /* Same size as the largest block. */
@@ -1855,3 +1849,58 @@ _mesa_unpack_astc_2d_ldr(uint8_t *dst_row,
       dst_row += dst_stride * blk_h;
    }
 }
+
+static void
+unpack_astc_band(void *data, unsigned start, unsigned count)
+{
+   const struct astc_image *image = (const struct astc_image *)data;
+   unsigned blk_h = image->dec->block_h;
+   unsigned y = start * blk_h;
+
+   unpack_astc_rows(*image->dec, image->dst_row + (size_t)y * image->dst_stride,
+                    image->dst_stride,
+                    image->src_row + (size_t)start * image->src_stride,
+                    image->src_stride, image->src_width,
+                    MIN2(count * blk_h, image->src_height - y));
+}
+
+/**
+ * Decode ASTC 2D LDR texture data.
+ *
+ * Large images are split into bands of block rows that are decoded in
+ * parallel.
+ *
+ * \param src_width in pixels
+ * \param src_height in pixels
+ * \param dst_stride in bytes
+ */
+extern "C" void
+_mesa_unpack_astc_2d_ldr(uint8_t *dst_row,
+                         unsigned dst_stride,
+                         const uint8_t *src_row,
+                         unsigned src_stride,
+                         unsigned src_width,
+                         unsigned src_height,
+                         enum pipe_format format)
+{
+   const struct util_format_description *desc =
+      util_format_description(format);
+   assert(desc && desc->layout == UTIL_FORMAT_LAYOUT_ASTC &&
+          desc->block.depth == 1);
+   bool srgb = util_format_is_srgb(format);
+
+   unsigned blk_w = desc->block.width, blk_h = desc->block.height;
+
+   unsigned x_blocks = (src_width + blk_w - 1) / blk_w;
+   unsigned y_blocks = (src_height + blk_h - 1) / blk_h;
+
+   /* The decoder holds no state of its own, so the bands can share it. */
+   Decoder dec(blk_w, blk_h, 1, srgb, true);
+
+   struct astc_image image = {
+      &dec, dst_row, dst_stride, src_row, src_stride, src_width, src_height,
+   };
+
+   util_parallel_for(y_blocks, DIV_ROUND_UP(ASTC_PARALLEL_MIN_BLOCKS, MAX2(x_blocks, 1)),
+                     unpack_astc_band, &image);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "u_parallel.h"
+
+#include "u_call_once.h"
+#include "u_cpu_detect.h"
+#include "u_math.h"
+#include "u_queue.h"
+
+#define UTIL_PARALLEL_MAX_THREADS 8
+
+struct util_parallel_job {
+   struct util_queue_fence fence;
+   util_parallel_range_func func;
+   void *data;
+   unsigned start;
+   unsigned count;
+};
+
+static struct util_queue parallel_queue;
+static bool parallel_queue_ready;
+
+static void
+parallel_queue_init(void)
+{
+   int threads = MIN2(util_get_cpu_caps()->nr_cpus - 1,
+                      UTIL_PARALLEL_MAX_THREADS - 1);
+
+   /* The callers wait for the results, so don't lower the priority. */
+   if (threads > 0) {
+      parallel_queue_ready =
+         util_queue_init(&parallel_queue, "parallel", UTIL_PARALLEL_MAX_THREADS,
+                         threads, UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL);
+   }
+}
+
+static void
+parallel_job_execute(void *job, void *gdata, int thread_index)
+{
+   struct util_parallel_job *pjob = job;
+
+   pjob->func(pjob->data, pjob->start, pjob->count);
+}
+
+void
+util_parallel_for(unsigned count, unsigned min_count,
+                  util_parallel_range_func func, void *data)
+{
+   static util_once_flag once = UTIL_ONCE_FLAG_INIT;
+   unsigned num_jobs = 1;
+
+   min_count = MAX2(min_count, 1);
+
+   if (count / 2 >= min_count) {
+      util_call_once(&once, parallel_queue_init);
+      if (parallel_queue_ready)
+         num_jobs = MIN2(parallel_queue.num_threads + 1, count / min_count);
+   }
+
+   if (num_jobs <= 1) {
+      if (count)
+         func(data, 0, count);
+      return;
+   }
+
+   struct util_parallel_job jobs[UTIL_PARALLEL_MAX_THREADS];
+   unsigned per_job = DIV_ROUND_UP(count, num_jobs);
+
+   num_jobs = DIV_ROUND_UP(count, per_job);
+   for (unsigned i = 0; i < num_jobs; i++) {
+      jobs[i].func = func;
+      jobs[i].data = data;
+      jobs[i].start = i * per_job;
+      jobs[i].count = MIN2(per_job, count - jobs[i].start);
+   }
+
+   /* The last range is processed by this thread. */
+   for (unsigned i = 0; i < num_jobs - 1; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      util_queue_add_job(&parallel_queue, &jobs[i], &jobs[i].fence,
+                         parallel_job_execute, NULL, 0);
+   }
+
+   parallel_job_execute(&jobs[num_jobs - 1], NULL, 0);
+
+   for (unsigned i = 0; i < num_jobs - 1; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+}
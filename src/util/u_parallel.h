@@ -0,0 +1,32 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef U_PARALLEL_H
+#define U_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*util_parallel_range_func)(void *data, unsigned start,
+                                         unsigned count);
+
+/**
+ * Calls func on contiguous ranges covering [0, count), in parallel on a
+ * process-wide pool of worker threads and the calling thread, and returns
+ * once all of them are done.
+ *
+ * Ranges hold at least min_count items, so that small amounts of work stay
+ * on the calling thread. func must not call util_parallel_for() itself.
+ */
+void
+util_parallel_for(unsigned count, unsigned min_count,
+                  util_parallel_range_func func, void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
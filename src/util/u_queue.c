@@ -231,6 +231,296 @@ struct thread_input {
    int thread_index;
 };
 
+/* Move the job at position "from" (relative to read_idx) of a ring to
+ * position "to", shifting the jobs in between back by one.
+ */
+static void
+util_queue_ring_move_job(struct util_queue_job *jobs, unsigned max_jobs,
+                         unsigned read_idx, unsigned from, unsigned to)
+{
+   struct util_queue_job job = jobs[(read_idx + from) % max_jobs];
+
+   assert(to <= from);
+
+   for (unsigned i = from; i > to; i--)
+      jobs[(read_idx + i) % max_jobs] = jobs[(read_idx + i - 1) % max_jobs];
+
+   jobs[(read_idx + to) % max_jobs] = job;
+}
+
+/****************************************************************************
+ * Work-stealing mode
+ *
+ * Every thread owns a ring of jobs protected by its own lock. Producers
+ * spread the jobs over the rings and threads that run out of jobs steal
+ * from the rings of the other threads, so the queue lock is only taken to
+ * sleep and to wake up threads.
+ *
+ * Jobs are always taken from the front of a ring, which keeps the order of
+ * the jobs in each ring. The barrier jobs of util_queue_finish are pinned to
+ * the ring of their thread and never stolen, because every thread must
+ * execute exactly one of them.
+ */
+
+static void
+util_queue_finish_execute(void *data, void *gdata, int num_thread);
+
+static inline bool
+util_queue_job_is_pinned(const struct util_queue_job *job)
+{
+   return job->execute == util_queue_finish_execute;
+}
+
+static void
+util_queue_deque_push(struct util_queue_deque *deque,
+                      const struct util_queue_job *job,
+                      enum util_queue_priority priority)
+{
+   simple_mtx_lock(&deque->lock);
+
+   if (deque->num_queued == deque->max_jobs) {
+      unsigned new_max_jobs = MAX2(deque->max_jobs * 2, 8);
+      struct util_queue_job *jobs =
+         (struct util_queue_job*)calloc(new_max_jobs,
+                                        sizeof(struct util_queue_job));
+      assert(jobs);
+
+      for (unsigned i = 0; i < deque->num_queued; i++)
+         jobs[i] = deque->jobs[(deque->read_idx + i) % deque->max_jobs];
+
+      free(deque->jobs);
+      deque->jobs = jobs;
+      deque->read_idx = 0;
+      deque->max_jobs = new_max_jobs;
+   }
+
+   deque->jobs[(deque->read_idx + deque->num_queued) % deque->max_jobs] = *job;
+   p_atomic_inc(&deque->num_queued);
+
+   if (priority == UTIL_QUEUE_PRIORITY_HIGH) {
+      util_queue_ring_move_job(deque->jobs, deque->max_jobs, deque->read_idx,
+                               deque->num_queued - 1,
+                               deque->num_high_priority);
+      deque->num_high_priority++;
+   }
+
+   simple_mtx_unlock(&deque->lock);
+}
+
+static bool
+util_queue_deque_pop(struct util_queue_deque *deque,
+                     struct util_queue_job *job, bool steal)
+{
+   if (!p_atomic_read(&deque->num_queued))
+      return false;
+
+   simple_mtx_lock(&deque->lock);
+
+   if (!deque->num_queued ||
+       (steal && util_queue_job_is_pinned(&deque->jobs[deque->read_idx]))) {
+      simple_mtx_unlock(&deque->lock);
+      return false;
+   }
+
+   *job = deque->jobs[deque->read_idx];
+   memset(&deque->jobs[deque->read_idx], 0, sizeof(struct util_queue_job));
+   deque->read_idx = (deque->read_idx + 1) % deque->max_jobs;
+   p_atomic_dec(&deque->num_queued);
+   if (deque->num_high_priority)
+      deque->num_high_priority--;
+
+   simple_mtx_unlock(&deque->lock);
+
+   return true;
+}
+
+static bool
+util_queue_get_job_ws(struct util_queue *queue, int thread_index,
+                      struct util_queue_job *job)
+{
+   if (util_queue_deque_pop(&queue->deques[thread_index], job, false))
+      return true;
+
+   for (unsigned i = 1; i < queue->max_threads; i++) {
+      unsigned victim = (thread_index + i) % queue->max_threads;
+
+      if (util_queue_deque_pop(&queue->deques[victim], job, true))
+         return true;
+   }
+
+   return false;
+}
+
+static bool
+util_queue_has_job_ws(struct util_queue *queue, int thread_index)
+{
+   return p_atomic_read(&queue->deques[thread_index].num_queued) ||
+          p_atomic_read(&queue->num_queued) > p_atomic_read(&queue->num_pinned);
+}
+
+static void
+util_queue_signal_remaining_jobs_ws(struct util_queue *queue)
+{
+   for (unsigned i = 0; i < queue->max_threads; i++) {
+      struct util_queue_deque *deque = &queue->deques[i];
+
+      simple_mtx_lock(&deque->lock);
+      for (unsigned j = 0; j < deque->num_queued; j++) {
+         struct util_queue_job *job =
+            &deque->jobs[(deque->read_idx + j) % deque->max_jobs];
+
+         if (job->job && job->fence)
+            util_queue_fence_signal(job->fence);
+         memset(job, 0, sizeof(*job));
+      }
+      deque->read_idx = 0;
+      deque->num_high_priority = 0;
+      p_atomic_set(&deque->num_queued, 0);
+      simple_mtx_unlock(&deque->lock);
+   }
+
+   p_atomic_set(&queue->num_queued, 0);
+   p_atomic_set(&queue->num_pinned, 0);
+}
+
+static void
+util_queue_thread_loop_ws(struct util_queue *queue, int thread_index)
+{
+   while (1) {
+      struct util_queue_job job;
+
+      /* only kill threads that are above "num_threads" */
+      if (thread_index >= (int)p_atomic_read(&queue->num_threads))
+         break;
+
+      if (!util_queue_get_job_ws(queue, thread_index, &job)) {
+         /* Producers check num_sleeping after adding a job, and we check
+          * for jobs after incrementing it, so no wake-up can be missed.
+          */
+         mtx_lock(&queue->lock);
+         p_atomic_inc(&queue->num_sleeping);
+         while (thread_index < queue->num_threads &&
+                !util_queue_has_job_ws(queue, thread_index))
+            cnd_wait(&queue->has_queued_cond, &queue->lock);
+         p_atomic_dec(&queue->num_sleeping);
+         mtx_unlock(&queue->lock);
+         continue;
+      }
+
+      if (util_queue_job_is_pinned(&job))
+         p_atomic_dec(&queue->num_pinned);
+      p_atomic_dec(&queue->num_queued);
+      if (job.job)
+         p_atomic_add(&queue->total_jobs_size, -(int64_t)job.job_size);
+
+      if (p_atomic_read(&queue->num_space_waiters)) {
+         mtx_lock(&queue->lock);
+         cnd_broadcast(&queue->has_space_cond);
+         mtx_unlock(&queue->lock);
+      }
+
+      if (job.job) {
+         job.execute(job.job, job.global_data, thread_index);
+         if (job.fence)
+            util_queue_fence_signal(job.fence);
+         if (job.cleanup)
+            job.cleanup(job.job, job.global_data, thread_index);
+      }
+   }
+
+   /* signal remaining jobs if all threads are being terminated */
+   mtx_lock(&queue->lock);
+   if (queue->num_threads == 0)
+      util_queue_signal_remaining_jobs_ws(queue);
+   mtx_unlock(&queue->lock);
+}
+
+/* Add a job to the ring of the given thread, or spread the jobs over all
+ * threads if thread_index is negative.
+ */
+static void
+util_queue_add_job_ws(struct util_queue *queue,
+                      void *job,
+                      struct util_queue_fence *fence,
+                      util_queue_execute_func execute,
+                      util_queue_execute_func cleanup,
+                      const size_t job_size,
+                      enum util_queue_priority priority,
+                      int thread_index,
+                      bool locked)
+{
+   unsigned num_threads = p_atomic_read(&queue->num_threads);
+
+   if (num_threads == 0) {
+      /* well no good option here, but any leaks will be
+       * short-lived as things are shutting down..
+       */
+      return;
+   }
+
+   if (fence)
+      util_queue_fence_reset(fence);
+
+   /* Scale the number of threads up if there's already one job waiting. */
+   if (p_atomic_read(&queue->num_queued) > 0 &&
+       queue->create_threads_on_demand &&
+       execute != util_queue_finish_execute &&
+       num_threads < queue->max_threads) {
+      if (!locked)
+         mtx_lock(&queue->lock);
+      util_queue_adjust_num_threads(queue, queue->num_threads + 1, true);
+      num_threads = queue->num_threads;
+      if (!locked)
+         mtx_unlock(&queue->lock);
+   }
+
+   if (p_atomic_read(&queue->num_queued) >= queue->max_jobs &&
+       !(queue->flags & UTIL_QUEUE_INIT_RESIZE_IF_FULL &&
+         p_atomic_read(&queue->total_jobs_size) + job_size < S_256MB)) {
+      /* Wait until there is a free slot. */
+      if (!locked)
+         mtx_lock(&queue->lock);
+      p_atomic_inc(&queue->num_space_waiters);
+      while (p_atomic_read(&queue->num_queued) >= queue->max_jobs)
+         cnd_wait(&queue->has_space_cond, &queue->lock);
+      p_atomic_dec(&queue->num_space_waiters);
+      if (!locked)
+         mtx_unlock(&queue->lock);
+   }
+
+   struct util_queue_job new_job = {
+      .job = job,
+      .global_data = queue->global_data,
+      .job_size = job_size,
+      .fence = fence,
+      .execute = execute,
+      .cleanup = cleanup,
+   };
+   bool pinned = util_queue_job_is_pinned(&new_job);
+
+   if (thread_index < 0)
+      thread_index = p_atomic_inc_return(&queue->next_deque) % num_threads;
+
+   util_queue_deque_push(&queue->deques[thread_index], &new_job, priority);
+
+   if (pinned)
+      p_atomic_inc(&queue->num_pinned);
+   p_atomic_add(&queue->total_jobs_size, job_size);
+   p_atomic_inc(&queue->num_queued);
+
+   if (p_atomic_read(&queue->num_sleeping)) {
+      if (!locked)
+         mtx_lock(&queue->lock);
+      /* A pinned job can only be executed by its own thread. */
+      if (pinned)
+         cnd_broadcast(&queue->has_queued_cond);
+      else
+         cnd_signal(&queue->has_queued_cond);
+      if (!locked)
+         mtx_unlock(&queue->lock);
+   }
+}
+
 static int
 util_queue_thread_func(void *input)
 {
@@ -264,6 +554,11 @@ util_queue_thread_func(void *input)
       u_thread_setname(name);
    }
 
+   if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      util_queue_thread_loop_ws(queue, thread_index);
+      return 0;
+   }
+
    while (1) {
       struct util_queue_job job;
 
@@ -283,6 +578,8 @@ util_queue_thread_func(void *input)
       job = queue->jobs[queue->read_idx];
       memset(&queue->jobs[queue->read_idx], 0, sizeof(struct util_queue_job));
       queue->read_idx = (queue->read_idx + 1) % queue->max_jobs;
+      if (queue->num_high_priority)
+         queue->num_high_priority--;
 
       queue->num_queued--;
       cnd_signal(&queue->has_space_cond);
@@ -312,6 +609,7 @@ util_queue_thread_func(void *input)
       }
       queue->read_idx = queue->write_idx;
       queue->num_queued = 0;
+      queue->num_high_priority = 0;
    }
    mtx_unlock(&queue->lock);
    return 0;
@@ -449,6 +747,16 @@ util_queue_init(struct util_queue *queue,
    if (!queue->threads)
       goto fail;
 
+   if (flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      queue->deques = (struct util_queue_deque*)
+                      calloc(queue->max_threads, sizeof(struct util_queue_deque));
+      if (!queue->deques)
+         goto fail;
+
+      for (i = 0; i < queue->max_threads; i++)
+         simple_mtx_init(&queue->deques[i].lock, mtx_plain);
+   }
+
    /* start threads */
    for (i = 0; i < queue->num_threads; i++) {
       if (!util_queue_create_thread(queue, i)) {
@@ -468,6 +776,7 @@ util_queue_init(struct util_queue *queue,
 
 fail:
    free(queue->threads);
+   free(queue->deques);
 
    if (queue->jobs) {
       cnd_destroy(&queue->has_space_cond);
@@ -537,6 +846,14 @@ util_queue_destroy(struct util_queue *queue)
    mtx_destroy(&queue->lock);
    free(queue->jobs);
    free(queue->threads);
+
+   if (queue->deques) {
+      for (unsigned i = 0; i < queue->max_threads; i++) {
+         simple_mtx_destroy(&queue->deques[i].lock);
+         free(queue->deques[i].jobs);
+      }
+      free(queue->deques);
+   }
 }
 
 static void
@@ -546,10 +863,17 @@ util_queue_add_job_locked(struct util_queue *queue,
                           util_queue_execute_func execute,
                           util_queue_execute_func cleanup,
                           const size_t job_size,
+                          enum util_queue_priority priority,
                           bool locked)
 {
    struct util_queue_job *ptr;
 
+   if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      util_queue_add_job_ws(queue, job, fence, execute, cleanup, job_size,
+                            priority, -1, locked);
+      return;
+   }
+
    if (!locked)
       mtx_lock(&queue->lock);
    if (queue->num_threads == 0) {
@@ -622,6 +946,14 @@ util_queue_add_job_locked(struct util_queue *queue,
    queue->total_jobs_size += ptr->job_size;
 
    queue->num_queued++;
+
+   if (priority == UTIL_QUEUE_PRIORITY_HIGH) {
+      util_queue_ring_move_job(queue->jobs, queue->max_jobs, queue->read_idx,
+                               queue->num_queued - 1,
+                               queue->num_high_priority);
+      queue->num_high_priority++;
+   }
+
    cnd_signal(&queue->has_queued_cond);
    if (!locked)
       mtx_unlock(&queue->lock);
@@ -636,7 +968,20 @@ util_queue_add_job(struct util_queue *queue,
                    const size_t job_size)
 {
    util_queue_add_job_locked(queue, job, fence, execute, cleanup, job_size,
-                             false);
+                             UTIL_QUEUE_PRIORITY_NORMAL, false);
+}
+
+void
+util_queue_add_job_with_priority(struct util_queue *queue,
+                                 void *job,
+                                 struct util_queue_fence *fence,
+                                 util_queue_execute_func execute,
+                                 util_queue_execute_func cleanup,
+                                 const size_t job_size,
+                                 enum util_queue_priority priority)
+{
+   util_queue_add_job_locked(queue, job, fence, execute, cleanup, job_size,
+                             priority, false);
 }
 
 /**
@@ -657,6 +1002,35 @@ util_queue_drop_job(struct util_queue *queue, struct util_queue_fence *fence)
    if (util_queue_fence_is_signalled(fence))
       return;
 
+   if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      for (unsigned i = 0; i < queue->max_threads && !removed; i++) {
+         struct util_queue_deque *deque = &queue->deques[i];
+
+         simple_mtx_lock(&deque->lock);
+         for (unsigned j = 0; j < deque->num_queued; j++) {
+            struct util_queue_job *job =
+               &deque->jobs[(deque->read_idx + j) % deque->max_jobs];
+
+            if (job->fence == fence) {
+               if (job->cleanup)
+                  job->cleanup(job->job, queue->global_data, -1);
+
+               /* Just clear it. The threads will treat as a no-op job. */
+               memset(job, 0, sizeof(*job));
+               removed = true;
+               break;
+            }
+         }
+         simple_mtx_unlock(&deque->lock);
+      }
+
+      if (removed)
+         util_queue_fence_signal(fence);
+      else
+         util_queue_fence_wait(fence);
+      return;
+   }
+
    mtx_lock(&queue->lock);
    for (unsigned i = queue->read_idx; i != queue->write_idx;
         i = (i + 1) % queue->max_jobs) {
@@ -678,6 +1052,52 @@ util_queue_drop_job(struct util_queue *queue, struct util_queue_fence *fence)
       util_queue_fence_wait(fence);
 }
 
+/**
+ * Move a queued job in front of all normal priority jobs. This does nothing
+ * if the job has already started execution.
+ */
+void
+util_queue_prioritize_job(struct util_queue *queue,
+                          struct util_queue_fence *fence)
+{
+   if (util_queue_fence_is_signalled(fence))
+      return;
+
+   if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      bool found = false;
+
+      for (unsigned i = 0; i < queue->max_threads && !found; i++) {
+         struct util_queue_deque *deque = &queue->deques[i];
+
+         simple_mtx_lock(&deque->lock);
+         for (unsigned j = deque->num_high_priority; j < deque->num_queued; j++) {
+            if (deque->jobs[(deque->read_idx + j) % deque->max_jobs].fence == fence) {
+               util_queue_ring_move_job(deque->jobs, deque->max_jobs,
+                                        deque->read_idx, j,
+                                        deque->num_high_priority);
+               deque->num_high_priority++;
+               found = true;
+               break;
+            }
+         }
+         simple_mtx_unlock(&deque->lock);
+      }
+      return;
+   }
+
+   mtx_lock(&queue->lock);
+   for (int i = queue->num_high_priority; i < queue->num_queued; i++) {
+      if (queue->jobs[(queue->read_idx + i) % queue->max_jobs].fence == fence) {
+         util_queue_ring_move_job(queue->jobs, queue->max_jobs,
+                                  queue->read_idx, i,
+                                  queue->num_high_priority);
+         queue->num_high_priority++;
+         break;
+      }
+   }
+   mtx_unlock(&queue->lock);
+}
+
 /**
  * Wait until all previously added jobs have completed.
  */
@@ -713,8 +1133,15 @@ util_queue_finish(struct util_queue *queue)
 
    for (unsigned i = 0; i < queue->num_threads; ++i) {
       util_queue_fence_init(&fences[i]);
-      util_queue_add_job_locked(queue, &barrier, &fences[i],
-                                util_queue_finish_execute, NULL, 0, true);
+      if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+         util_queue_add_job_ws(queue, &barrier, &fences[i],
+                               util_queue_finish_execute, NULL, 0,
+                               UTIL_QUEUE_PRIORITY_NORMAL, i, true);
+      } else {
+         util_queue_add_job_locked(queue, &barrier, &fences[i],
+                                   util_queue_finish_execute, NULL, 0,
+                                   UTIL_QUEUE_PRIORITY_NORMAL, true);
+      }
    }
    queue->create_threads_on_demand = true;
    mtx_unlock(&queue->lock);
@@ -51,6 +51,7 @@ extern "C" {
 #define UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY      (1 << 0)
 #define UTIL_QUEUE_INIT_RESIZE_IF_FULL            (1 << 1)
 #define UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY  (1 << 2)
+#define UTIL_QUEUE_INIT_WORK_STEALING             (1 << 3)
 
 #if UTIL_FUTEX_SUPPORTED
 #define UTIL_QUEUE_FENCE_FUTEX
@@ -211,6 +212,14 @@ util_queue_fence_wait_timeout(struct util_queue_fence *fence,
 
 typedef void (*util_queue_execute_func)(void *job, void *gdata, int thread_index);
 
+enum util_queue_priority {
+   UTIL_QUEUE_PRIORITY_NORMAL,
+   /* Executed before all normal priority jobs, e.g. a job that is about to
+    * be waited for.
+    */
+   UTIL_QUEUE_PRIORITY_HIGH,
+};
+
 struct util_queue_job {
    void *job;
    void *global_data;
@@ -221,6 +230,16 @@ struct util_queue_job {
 };
 
 /* Put this into your context. */
+/* Job ring owned by one thread of a work-stealing queue. */
+struct util_queue_deque {
+   simple_mtx_t lock;
+   unsigned max_jobs;
+   unsigned read_idx;
+   unsigned num_queued; /* can be read without the lock */
+   unsigned num_high_priority; /* high priority jobs are at the front */
+   struct util_queue_job *jobs;
+};
+
 struct util_queue {
    char name[14]; /* 13 characters = the thread name without the index */
    mtx_t lock;
@@ -234,10 +253,21 @@ struct util_queue {
    unsigned num_threads; /* decreasing this number will terminate threads */
    int max_jobs;
    int write_idx, read_idx; /* ring buffer pointers */
+   int num_high_priority;   /* high priority jobs are at the front */
    size_t total_jobs_size;  /* memory use of all jobs in the queue */
    struct util_queue_job *jobs;
    void *global_data;
 
+   /* UTIL_QUEUE_INIT_WORK_STEALING: one ring per thread, "jobs" is unused.
+    * num_queued and total_jobs_size are updated atomically without holding
+    * the lock, which only protects sleeping and waking up threads.
+    */
+   struct util_queue_deque *deques;
+   unsigned next_deque;
+   unsigned num_sleeping;
+   unsigned num_space_waiters;
+   int num_pinned;
+
    /* for cleanup at exit(), protected by exit_mutex */
    struct list_head head;
 };
@@ -257,8 +287,29 @@ void util_queue_add_job(struct util_queue *queue,
                         util_queue_execute_func execute,
                         util_queue_execute_func cleanup,
                         const size_t job_size);
+void util_queue_add_job_with_priority(struct util_queue *queue,
+                                      void *job,
+                                      struct util_queue_fence *fence,
+                                      util_queue_execute_func execute,
+                                      util_queue_execute_func cleanup,
+                                      const size_t job_size,
+                                      enum util_queue_priority priority);
 void util_queue_drop_job(struct util_queue *queue,
                          struct util_queue_fence *fence);
+void util_queue_prioritize_job(struct util_queue *queue,
+                               struct util_queue_fence *fence);
+
+/* Wait for a job of the queue, moving it in front of the normal priority
+ * jobs if it hasn't started yet.
+ */
+static inline void
+util_queue_job_wait(struct util_queue *queue, struct util_queue_fence *fence)
+{
+   if (unlikely(!util_queue_fence_is_signalled(fence))) {
+      util_queue_prioritize_job(queue, fence);
+      _util_queue_fence_wait(fence);
+   }
+}
 
 void util_queue_finish(struct util_queue *queue);
 
@@ -124,3 +124,80 @@ u_worklist_pop_tail_index(u_worklist *w)
    BITSET_CLEAR(w->present, *(w->entries[tail]));
    return w->entries[tail];
 }
+
+void
+u_priority_worklist_init(u_priority_worklist *w, unsigned num_entries,
+                         void *mem_ctx)
+{
+   w->size = num_entries;
+   w->count = 0;
+   w->min_word = BITSET_WORDS(num_entries);
+   w->max_word = 0;
+
+   w->present = rzalloc_array(mem_ctx, BITSET_WORD, BITSET_WORDS(num_entries));
+   w->entries = rzalloc_array(mem_ctx, unsigned *, num_entries);
+}
+
+void
+u_priority_worklist_fini(u_priority_worklist *w)
+{
+   ralloc_free(w->present);
+   ralloc_free(w->entries);
+}
+
+void
+u_priority_worklist_push_index(u_priority_worklist *w, unsigned *index)
+{
+   /* Pushing an entry we already have is a no-op */
+   if (BITSET_TEST(w->present, *index))
+      return;
+
+   assert(*index < w->size);
+
+   unsigned word = BITSET_BITWORD(*index);
+   w->min_word = MIN2(w->min_word, word);
+   w->max_word = MAX2(w->max_word, word);
+
+   w->count++;
+
+   w->entries[*index] = index;
+   BITSET_SET(w->present, *index);
+}
+
+unsigned *
+u_priority_worklist_pop_first_index(u_priority_worklist *w)
+{
+   assert(w->count > 0);
+
+   unsigned word = w->min_word;
+   while (!w->present[word])
+      word++;
+
+   assert(word <= w->max_word);
+   w->min_word = word;
+
+   unsigned i = word * BITSET_WORDBITS + ffs(w->present[word]) - 1;
+   w->count--;
+
+   BITSET_CLEAR(w->present, i);
+   return w->entries[i];
+}
+
+unsigned *
+u_priority_worklist_pop_last_index(u_priority_worklist *w)
+{
+   assert(w->count > 0);
+
+   unsigned word = w->max_word;
+   while (!w->present[word])
+      word--;
+
+   assert(word >= w->min_word);
+   w->max_word = word;
+
+   unsigned i = word * BITSET_WORDBITS + util_last_bit(w->present[word]) - 1;
+   w->count--;
+
+   BITSET_CLEAR(w->present, i);
+   return w->entries[i];
+}
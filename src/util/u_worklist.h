@@ -100,6 +100,64 @@ unsigned *u_worklist_pop_tail_index(u_worklist *w);
 #define u_worklist_peek_tail(w, entry_t, index) \
    container_of(u_worklist_peek_tail_index(w), entry_t, index)
 
+/** Represents a set of unique entries which are popped in order of their
+ * index rather than in the order they were pushed. The same index rules as
+ * for u_worklist apply.
+ *
+ * This is meant for dataflow analyses over blocks that are indexed in reverse
+ * postorder: forward problems always pop the lowest index and backward
+ * problems the highest, so every block sees all of the updates from its
+ * (forward-edge) predecessors or successors before it is processed. This
+ * usually reaches the fixed point in far fewer iterations than a FIFO.
+ *
+ * The bitset of present entries doubles as the queue, so pushing is O(1) and
+ * popping scans for the next set bit, starting from the word it last stopped
+ * at.
+ */
+typedef struct {
+   /* The total size of the worklist */
+   unsigned size;
+
+   /* The number of entries currently in the worklist */
+   unsigned count;
+
+   /* No bit is set in a word below min_word or above max_word */
+   unsigned min_word;
+   unsigned max_word;
+
+   /* A bitset of all of the entries currently present in the worklist */
+   BITSET_WORD *present;
+
+   /* The index pointer of each present entry, indexed by entry index */
+   unsigned **entries;
+} u_priority_worklist;
+
+void u_priority_worklist_init(u_priority_worklist *w, unsigned num_entries,
+                              void *mem_ctx);
+
+void u_priority_worklist_fini(u_priority_worklist *w);
+
+static inline bool
+u_priority_worklist_is_empty(const u_priority_worklist *w)
+{
+   return w->count == 0;
+}
+
+void u_priority_worklist_push_index(u_priority_worklist *w, unsigned *index);
+
+unsigned *u_priority_worklist_pop_first_index(u_priority_worklist *w);
+
+unsigned *u_priority_worklist_pop_last_index(u_priority_worklist *w);
+
+#define u_priority_worklist_push(w, block, index) \
+   u_priority_worklist_push_index(w, &((block)->index))
+
+#define u_priority_worklist_pop_first(w, entry_t, index) \
+   container_of(u_priority_worklist_pop_first_index(w), entry_t, index)
+
+#define u_priority_worklist_pop_last(w, entry_t, index) \
+   container_of(u_priority_worklist_pop_last_index(w), entry_t, index)
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -29,25 +29,171 @@
 #include "util/vma.h"
 
 struct util_vma_hole {
-   struct list_head link;
+   struct rb_node node;
    uint64_t offset;
    uint64_t size;
+
+   /** Size of the largest hole in this node's subtree */
+   uint64_t max_size;
 };
 
+#define util_vma_hole(_node) \
+   rb_node_data(struct util_vma_hole, _node, node)
+
 #define util_vma_foreach_hole(_hole, _heap) \
-   list_for_each_entry(struct util_vma_hole, _hole, &(_heap)->holes, link)
+   rb_tree_foreach_rev(struct util_vma_hole, _hole, &(_heap)->holes, node)
+
+/* Iterates over the holes with at least _size bytes, from the top of the heap
+ * down if _top_down is set and from the bottom up otherwise.  The loop must
+ * be left once the current hole is modified.
+ */
+#define util_vma_foreach_fitting_hole(_hole, _heap, _size, _top_down) \
+   for (struct util_vma_hole *_hole = \
+           util_vma_subtree_find_fit((_heap)->holes.root, _size, _top_down); \
+        _hole != NULL; \
+        _hole = util_vma_hole_find_next_fit(_hole, _size, _top_down))
+
+static int
+util_vma_hole_cmp(const struct rb_node *_a, const struct rb_node *_b)
+{
+   const struct util_vma_hole *a = util_vma_hole(_a);
+   const struct util_vma_hole *b = util_vma_hole(_b);
+
+   /* Lower offsets go to the left. */
+   if (a->offset > b->offset)
+      return -1;
+   else if (a->offset < b->offset)
+      return 1;
+   else
+      return 0;
+}
+
+static void
+util_vma_hole_update_max(struct rb_node *node)
+{
+   struct util_vma_hole *hole = util_vma_hole(node);
+
+   hole->max_size = hole->size;
+   if (node->left)
+      hole->max_size = MAX2(hole->max_size, util_vma_hole(node->left)->max_size);
+   if (node->right)
+      hole->max_size = MAX2(hole->max_size, util_vma_hole(node->right)->max_size);
+}
+
+/* Must be called after resizing a hole in place to fix up max_size. */
+static void
+util_vma_hole_resized(struct util_vma_hole *hole)
+{
+   for (struct rb_node *node = &hole->node; node; node = rb_node_parent(node))
+      util_vma_hole_update_max(node);
+}
+
+static void
+util_vma_heap_add_hole(struct util_vma_heap *heap,
+                       uint64_t offset, uint64_t size)
+{
+   struct util_vma_hole *hole = calloc(1, sizeof(*hole));
+
+   hole->offset = offset;
+   hole->size = size;
+
+   rb_augmented_tree_insert(&heap->holes, &hole->node, util_vma_hole_cmp,
+                            util_vma_hole_update_max);
+}
+
+static void
+util_vma_heap_remove_hole(struct util_vma_heap *heap,
+                          struct util_vma_hole *hole)
+{
+   rb_augmented_tree_remove(&heap->holes, &hole->node,
+                            util_vma_hole_update_max);
+   free(hole);
+}
+
+/* Returns the highest (if top_down) or lowest hole with at least size bytes
+ * in the subtree rooted at node.
+ */
+static struct util_vma_hole *
+util_vma_subtree_find_fit(struct rb_node *node, uint64_t size, bool top_down)
+{
+   while (node) {
+      struct rb_node *first = top_down ? node->right : node->left;
+      struct rb_node *last = top_down ? node->left : node->right;
+
+      if (first && util_vma_hole(first)->max_size >= size)
+         node = first;
+      else if (util_vma_hole(node)->size >= size)
+         return util_vma_hole(node);
+      else if (last && util_vma_hole(last)->max_size >= size)
+         node = last;
+      else
+         return NULL;
+   }
+
+   return NULL;
+}
+
+/* Returns the next hole with at least size bytes after hole, going down in
+ * the address space if top_down and up otherwise.
+ */
+static struct util_vma_hole *
+util_vma_hole_find_next_fit(struct util_vma_hole *hole, uint64_t size,
+                            bool top_down)
+{
+   struct rb_node *node = &hole->node;
+   struct util_vma_hole *next =
+      util_vma_subtree_find_fit(top_down ? node->left : node->right,
+                                size, top_down);
+   if (next)
+      return next;
+
+   while (true) {
+      /* Crawl up until we find an ancestor past the subtree we searched. */
+      struct rb_node *p = rb_node_parent(node);
+      while (p && node == (top_down ? p->left : p->right)) {
+         node = p;
+         p = rb_node_parent(node);
+      }
 
-#define util_vma_foreach_hole_safe(_hole, _heap) \
-   list_for_each_entry_safe(struct util_vma_hole, _hole, &(_heap)->holes, link)
+      if (!p)
+         return NULL;
 
-#define util_vma_foreach_hole_safe_rev(_hole, _heap) \
-   list_for_each_entry_safe_rev(struct util_vma_hole, _hole, &(_heap)->holes, link)
+      if (util_vma_hole(p)->size >= size)
+         return util_vma_hole(p);
+
+      next = util_vma_subtree_find_fit(top_down ? p->left : p->right,
+                                       size, top_down);
+      if (next)
+         return next;
+
+      node = p;
+   }
+}
+
+/* Returns the highest hole starting at or below offset, if any. */
+static struct util_vma_hole *
+util_vma_heap_find_hole_below(struct util_vma_heap *heap, uint64_t offset)
+{
+   struct util_vma_hole *found = NULL;
+   struct rb_node *node = heap->holes.root;
+
+   while (node) {
+      if (util_vma_hole(node)->offset <= offset) {
+         found = util_vma_hole(node);
+         node = node->right;
+      } else {
+         node = node->left;
+      }
+   }
+
+   return found;
+}
 
 void
 util_vma_heap_init(struct util_vma_heap *heap,
                    uint64_t start, uint64_t size)
 {
-   list_inithead(&heap->holes);
+   rb_tree_init(&heap->holes);
    heap->free_size = 0;
    if (size > 0)
       util_vma_heap_free(heap, start, size);
@@ -59,11 +205,22 @@ util_vma_heap_init(struct util_vma_heap *heap,
    heap->nospan_shift = 0;
 }
 
+static void
+util_vma_free_subtree(struct rb_node *node)
+{
+   while (node) {
+      struct rb_node *left = node->left;
+
+      util_vma_free_subtree(node->right);
+      free(util_vma_hole(node));
+      node = left;
+   }
+}
+
 void
 util_vma_heap_finish(struct util_vma_heap *heap)
 {
-   util_vma_foreach_hole_safe(hole, heap)
-      free(hole);
+   util_vma_free_subtree(heap->holes.root);
 }
 
 #ifndef NDEBUG
@@ -72,13 +229,23 @@ util_vma_heap_validate(struct util_vma_heap *heap)
 {
    uint64_t free_size = 0;
    uint64_t prev_offset = 0;
+   unsigned hole_count = 0;
    util_vma_foreach_hole(hole, heap) {
       assert(hole->offset > 0);
       assert(hole->size > 0);
 
       free_size += hole->size;
 
-      if (&hole->link == heap->holes.next) {
+      hole_count++;
+
+      uint64_t max_size = hole->size;
+      if (hole->node.left)
+         max_size = MAX2(max_size, util_vma_hole(hole->node.left)->max_size);
+      if (hole->node.right)
+         max_size = MAX2(max_size, util_vma_hole(hole->node.right)->max_size);
+      assert(hole->max_size == max_size);
+
+      if (hole_count == 1) {
          /* This must be the top-most hole.  Assert that, if it overflows, it
           * overflows to 0, i.e. 2^64.
           */
@@ -112,8 +279,7 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
 
    if (offset == hole->offset && size == hole->size) {
       /* Just get rid of the hole. */
-      list_del(&hole->link);
-      free(hole);
+      util_vma_heap_remove_hole(heap, hole);
       goto done;
    }
 
@@ -122,6 +288,7 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
    if (waste == 0) {
       /* We allocated at the top.  Shrink the hole down. */
       hole->size -= size;
+      util_vma_hole_resized(hole);
       goto done;
    }
 
@@ -129,25 +296,20 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
       /* We allocated at the bottom. Shrink the hole up. */
       hole->offset += size;
       hole->size -= size;
+      util_vma_hole_resized(hole);
       goto done;
    }
 
    /* We allocated in the middle.  We need to split the old hole into two
     * holes, one high and one low.
-    */
-   struct util_vma_hole *high_hole = calloc(1, sizeof(*hole));
-   high_hole->offset = offset + size;
-   high_hole->size = waste;
-
-   /* Adjust the hole to be the amount of space left at he bottom of the
+    *
+    * Adjust the hole to be the amount of space left at he bottom of the
     * original hole.
     */
    hole->size = offset - hole->offset;
+   util_vma_hole_resized(hole);
 
-   /* Place the new hole before the old hole so that the list is in order
-    * from high to low.
-    */
-   list_addtail(&high_hole->link, &hole->link);
+   util_vma_heap_add_hole(heap, offset + size, waste);
 
  done:
    heap->free_size -= size;
@@ -172,10 +334,7 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
    }
 
    if (heap->alloc_high) {
-      util_vma_foreach_hole_safe(hole, heap) {
-         if (size > hole->size)
-            continue;
-
+      util_vma_foreach_fitting_hole(hole, heap, size, true) {
          /* Compute the offset as the highest address where a chunk of the
           * given size can be without going over the top of the hole.
           *
@@ -209,10 +368,7 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
          return offset;
       }
    } else {
-      util_vma_foreach_hole_safe_rev(hole, heap) {
-         if (size > hole->size)
-            continue;
-
+      util_vma_foreach_fitting_hole(hole, heap, size, false) {
          uint64_t offset = hole->offset;
 
          /* Align the offset */
@@ -262,25 +418,16 @@ util_vma_heap_alloc_addr(struct util_vma_heap *heap,
     */
    assert(offset + size == 0 || offset + size > offset);
 
-   /* Find the hole if one exists. */
-   util_vma_foreach_hole_safe(hole, heap) {
-      if (hole->offset > offset)
-         continue;
-
-      /* Holes are ordered high-to-low so the first hole we find with
-       * hole->offset <= is our hole.  If it's not big enough to contain the
-       * requested range, then the allocation fails.
-       */
-      assert(hole->offset <= offset);
-      if (hole->size < offset - hole->offset + size)
-         return false;
-
-      util_vma_hole_alloc(heap, hole, offset, size);
-      return true;
-   }
+   /* Find the hole if one exists.  If the highest hole with
+    * hole->offset <= offset is not big enough to contain the requested range,
+    * then the allocation fails.
+    */
+   struct util_vma_hole *hole = util_vma_heap_find_hole_below(heap, offset);
+   if (!hole || hole->size < offset - hole->offset + size)
+      return false;
 
-   /* We didn't find a suitable hole */
-   return false;
+   util_vma_hole_alloc(heap, hole, offset, size);
+   return true;
 }
 
 void
@@ -303,14 +450,10 @@ util_vma_heap_free(struct util_vma_heap *heap,
    util_vma_heap_validate(heap);
 
    /* Find immediately higher and lower holes if they exist. */
-   struct util_vma_hole *high_hole = NULL, *low_hole = NULL;
-   util_vma_foreach_hole(hole, heap) {
-      if (hole->offset <= offset) {
-         low_hole = hole;
-         break;
-      }
-      high_hole = hole;
-   }
+   struct util_vma_hole *low_hole = util_vma_heap_find_hole_below(heap, offset);
+   struct rb_node *high_node = low_hole ? rb_node_next(&low_hole->node) :
+                                          rb_tree_first(&heap->holes);
+   struct util_vma_hole *high_hole = high_node ? util_vma_hole(high_node) : NULL;
 
    if (high_hole)
       assert(offset + size <= high_hole->offset);
@@ -324,28 +467,22 @@ util_vma_heap_free(struct util_vma_heap *heap,
 
    if (low_adjacent && high_adjacent) {
       /* Merge the two holes */
-      low_hole->size += size + high_hole->size;
-      list_del(&high_hole->link);
-      free(high_hole);
+      uint64_t high_size = high_hole->size;
+      util_vma_heap_remove_hole(heap, high_hole);
+      low_hole->size += size + high_size;
+      util_vma_hole_resized(low_hole);
    } else if (low_adjacent) {
       /* Merge into the low hole */
       low_hole->size += size;
+      util_vma_hole_resized(low_hole);
    } else if (high_adjacent) {
       /* Merge into the high hole */
       high_hole->offset = offset;
       high_hole->size += size;
+      util_vma_hole_resized(high_hole);
    } else {
       /* Neither hole is adjacent; make a new one */
-      struct util_vma_hole *hole = calloc(1, sizeof(*hole));
-
-      hole->offset = offset;
-      hole->size = size;
-
-      /* Add it after the high hole so we maintain high-to-low ordering */
-      if (high_hole)
-         list_add(&hole->link, &high_hole->link);
-      else
-         list_add(&hole->link, &heap->holes);
+      util_vma_heap_add_hole(heap, offset, size);
    }
 
    heap->free_size += size;
@@ -355,12 +492,10 @@ util_vma_heap_free(struct util_vma_heap *heap,
 uint64_t
 util_vma_heap_get_max_free_continuous_size(struct util_vma_heap *heap)
 {
-   uint64_t max_size = 0;
-   util_vma_foreach_hole_safe(hole, heap) {
-      max_size = MAX2(max_size, hole->size);
-   }
+   if (!heap->holes.root)
+      return 0;
 
-   return max_size;
+   return util_vma_hole(heap->holes.root)->max_size;
 }
 
 void
@@ -27,14 +27,17 @@
 #include <stdint.h>
 #include <stdio.h>
 
-#include "list.h"
+#include "rb_tree.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct util_vma_heap {
-   struct list_head holes;
+   /** Free holes, sorted by offset with the size of the largest hole in
+    * each subtree, so that any allocation strategy is O(log n).
+    */
+   struct rb_tree holes;
 
    /** Total size of free memory. */
    uint64_t free_size;
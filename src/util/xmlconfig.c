@@ -1228,6 +1228,81 @@ driInjectExecName(const char *exec)
    execname = exec;
 }
 
+#if WITH_XMLCONFIG
+static void
+hashConfigFileStamp(struct mesa_sha1 *ctx, const char *filename)
+{
+   struct stat st;
+
+   _mesa_sha1_update(ctx, filename, strlen(filename) + 1);
+   if (stat(filename, &st) != 0)
+      return;
+
+   _mesa_sha1_update(ctx, &st.st_size, sizeof(st.st_size));
+   _mesa_sha1_update(ctx, &st.st_mtime, sizeof(st.st_mtime));
+}
+
+static void
+hashConfigDirStamp(struct mesa_sha1 *ctx, const char *dirname)
+{
+   struct dirent **entries = NULL;
+   int count;
+
+   /* The directory's own mtime changes when files are added or removed. */
+   hashConfigFileStamp(ctx, dirname);
+
+   count = scandir(dirname, &entries, scandir_filter, alphasort);
+   if (count < 0)
+      return;
+
+   for (int i = 0; i < count; i++) {
+      char filename[PATH_MAX];
+
+      snprintf(filename, PATH_MAX, "%s/%s", dirname, entries[i]->d_name);
+      free(entries[i]);
+      hashConfigFileStamp(ctx, filename);
+   }
+
+   free(entries);
+}
+#endif /* WITH_XMLCONFIG */
+
+void
+driComputeConfigFilesSha1(unsigned char *sha1)
+{
+   struct mesa_sha1 ctx;
+
+   if (!execname)
+      execname = os_get_option("MESA_DRICONF_EXECUTABLE_OVERRIDE");
+   if (!execname)
+      execname = util_get_process_name();
+
+   _mesa_sha1_init(&ctx);
+   if (execname)
+      _mesa_sha1_update(&ctx, execname, strlen(execname) + 1);
+
+#if WITH_XMLCONFIG
+   const char *configdir;
+   const char *home;
+
+   if ((configdir = os_get_option("DRIRC_CONFIGDIR")))
+      hashConfigDirStamp(&ctx, configdir);
+   else {
+      hashConfigDirStamp(&ctx, DATADIR "/drirc.d");
+      hashConfigFileStamp(&ctx, SYSCONFDIR "/drirc");
+   }
+
+   if ((home = os_get_option("HOME"))) {
+      char filename[PATH_MAX];
+
+      snprintf(filename, PATH_MAX, "%s/.drirc", home);
+      hashConfigFileStamp(&ctx, filename);
+   }
+#endif /* WITH_XMLCONFIG */
+
+   _mesa_sha1_final(&ctx, sha1);
+}
+
 void
 driParseConfigFiles(driOptionCache *cache, const driOptionCache *info,
                     int screenNum, const char *driverName,
@@ -165,6 +165,14 @@ char *driQueryOptionstr(const driOptionCache *cache, const char *name);
 /* Overrides for the unit tests to control drirc parsing. */
 void driInjectExecName(const char *exec);
 
+/**
+ * Returns a hash identifying the drirc files driParseConfigFiles() would
+ * read (their paths, sizes and modification times) and the executable name
+ * they are matched against, so that results derived from them can be
+ * cached across processes.
+ */
+void driComputeConfigFilesSha1(unsigned char *sha1);
+
 /**
  * Returns a hash of the options for this application.
  */
@@ -27,7 +27,7 @@
 
 #define VTEST_DEFAULT_SOCKET_NAME "/tmp/.virgl_test"
 
-#define VTEST_PROTOCOL_VERSION 4
+#define VTEST_PROTOCOL_VERSION 5
 
 /* 32-bit length field */
 /* 32-bit cmd field */
@@ -94,6 +94,9 @@
 #define VCMD_DRM_SYNC_TRANSFER 37
 #define VCMD_RESOURCE_EXPORT_FD 38
 
+/* since protocol version 5 */
+#define VCMD_CMD_RING_CREATE 39
+
 #define VCMD_RES_CREATE_SIZE 10
 #define VCMD_RES_CREATE_RES_HANDLE 0 /* must be 0 since protocol version 3 */
 #define VCMD_RES_CREATE_TARGET 1
@@ -349,4 +352,29 @@ struct vcmd_submit_cmd2_batch {
 #define VCMD_RESOURCE_EXPORT_FD_RES_HANDLE 0
 /* rsp fd */
 
+/* The client may ask for a shared-memory ring to write VCMD_SUBMIT_CMD and
+ * VCMD_SUBMIT_CMD2 commands into instead of the socket.  The ring holds
+ * complete commands, header included.  HEAD and TAIL are free-running byte
+ * counters, HEAD written by the server and TAIL by the client, and the
+ * buffer size must be a power of two.
+ *
+ * Before processing any command received on the socket, the server consumes
+ * the ring up to the current TAIL, which keeps both channels ordered.  When
+ * the ring is empty, the server sets VCMD_CMD_RING_STATUS_IDLE, checks TAIL
+ * once more and then waits on the doorbell eventfd.  The client writes the
+ * doorbell only after publishing TAIL while IDLE is set.
+ */
+#define VCMD_CMD_RING_CREATE_SIZE 1
+#define VCMD_CMD_RING_CREATE_BUFFER_SIZE 0
+/* resp 0 on success, followed by the ring memfd and the doorbell eventfd */
+
+#define VCMD_CMD_RING_HEAD_OFFSET 0
+#define VCMD_CMD_RING_TAIL_OFFSET 64
+#define VCMD_CMD_RING_STATUS_OFFSET 128
+#define VCMD_CMD_RING_BUFFER_OFFSET 192
+
+enum vcmd_cmd_ring_status {
+   VCMD_CMD_RING_STATUS_IDLE = 1 << 0,
+};
+
 #endif /* VTEST_PROTOCOL */
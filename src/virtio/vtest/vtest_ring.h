@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef VTEST_RING_H
+#define VTEST_RING_H
+
+#include <assert.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "util/macros.h"
+
+#include "vtest_protocol.h"
+
+#define VTEST_RING_BUFFER_SIZE (1u << 20)
+
+/* Client side of the VCMD_CMD_RING_CREATE command ring. */
+struct vtest_ring {
+   void *map;
+   size_t map_size;
+   int doorbell_fd;
+
+   atomic_uint *head;
+   atomic_uint *tail;
+   atomic_uint *status;
+   uint8_t *buffer;
+   uint32_t buffer_size;
+
+   /* TAIL as seen by the client, published by vtest_ring_submit */
+   uint32_t cur;
+};
+
+static inline bool
+vtest_ring_init(struct vtest_ring *ring, int ring_fd, int doorbell_fd,
+                uint32_t buffer_size)
+{
+   const size_t map_size = VCMD_CMD_RING_BUFFER_OFFSET + buffer_size;
+   void *map =
+      mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring_fd, 0);
+   close(ring_fd);
+   if (map == MAP_FAILED) {
+      close(doorbell_fd);
+      return false;
+   }
+
+   ring->map = map;
+   ring->map_size = map_size;
+   ring->doorbell_fd = doorbell_fd;
+   ring->head = (atomic_uint *)((uint8_t *)map + VCMD_CMD_RING_HEAD_OFFSET);
+   ring->tail = (atomic_uint *)((uint8_t *)map + VCMD_CMD_RING_TAIL_OFFSET);
+   ring->status =
+      (atomic_uint *)((uint8_t *)map + VCMD_CMD_RING_STATUS_OFFSET);
+   ring->buffer = (uint8_t *)map + VCMD_CMD_RING_BUFFER_OFFSET;
+   ring->buffer_size = buffer_size;
+   ring->cur = atomic_load_explicit(ring->tail, memory_order_relaxed);
+
+   return true;
+}
+
+static inline void
+vtest_ring_fini(struct vtest_ring *ring)
+{
+   if (!ring->map)
+      return;
+
+   munmap(ring->map, ring->map_size);
+   close(ring->doorbell_fd);
+   ring->map = NULL;
+}
+
+/* Waits until there is room for size bytes.  Returns false when the command
+ * can never fit, in which case it must go through the socket instead.
+ */
+static inline bool
+vtest_ring_reserve(struct vtest_ring *ring, uint32_t size)
+{
+   if (size > ring->buffer_size)
+      return false;
+
+   while (ring->cur + size -
+             atomic_load_explicit(ring->head, memory_order_acquire) >
+          ring->buffer_size)
+      sched_yield();
+
+   return true;
+}
+
+static inline void
+vtest_ring_write(struct vtest_ring *ring, const void *data, uint32_t size)
+{
+   const uint32_t offset = ring->cur & (ring->buffer_size - 1);
+   const uint32_t first = MIN2(size, ring->buffer_size - offset);
+
+   memcpy(ring->buffer + offset, data, first);
+   memcpy(ring->buffer, (const uint8_t *)data + first, size - first);
+   ring->cur += size;
+}
+
+static inline void
+vtest_ring_submit(struct vtest_ring *ring)
+{
+   atomic_store_explicit(ring->tail, ring->cur, memory_order_release);
+
+   /* pairs with the server setting IDLE before re-checking TAIL */
+   atomic_thread_fence(memory_order_seq_cst);
+   if (atomic_load_explicit(ring->status, memory_order_relaxed) &
+       VCMD_CMD_RING_STATUS_IDLE) {
+      const uint64_t val = 1;
+      ASSERTED ssize_t ret = write(ring->doorbell_fd, &val, sizeof(val));
+      assert(ret == sizeof(val));
+   }
+}
+
+#endif /* VTEST_RING_H */
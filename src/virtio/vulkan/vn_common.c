@@ -35,6 +35,7 @@ static const struct debug_control vn_debug_options[] = {
    { "no_second_queue", VN_DEBUG_NO_SECOND_QUEUE },
    { "no_ray_tracing", VN_DEBUG_NO_RAY_TRACING },
    { "mem_budget", VN_DEBUG_MEM_BUDGET },
+   { "roundtrip", VN_DEBUG_ROUNDTRIP },
    { NULL, 0 },
    /* clang-format on */
 };
@@ -411,3 +412,119 @@ vn_tls_get(void)
 
    return tls;
 }
+
+struct vn_query_cache_entry {
+   uint8_t key[SHA1_DIGEST_LENGTH];
+   struct list_head head;
+   uint8_t data[];
+};
+
+void
+vn_query_cache_init(struct vn_query_cache *cache,
+                    const char *name,
+                    uint32_t data_size,
+                    uint32_t max_entries,
+                    const VkAllocationCallbacks *alloc)
+{
+   assert(max_entries);
+
+   memset(cache, 0, sizeof(*cache));
+   cache->alloc = alloc;
+   cache->name = name;
+   cache->data_size = data_size;
+   cache->max_entries = max_entries;
+
+   cache->ht = _mesa_hash_table_create(NULL, vn_cache_key_hash_function,
+                                       vn_cache_key_equal_function);
+   if (!cache->ht)
+      return;
+
+   simple_mtx_init(&cache->mutex, mtx_plain);
+   list_inithead(&cache->lru);
+}
+
+void
+vn_query_cache_fini(struct vn_query_cache *cache)
+{
+   if (!cache->ht)
+      return;
+
+   list_for_each_entry_safe(struct vn_query_cache_entry, entry, &cache->lru,
+                            head)
+      vk_free(cache->alloc, entry);
+
+   _mesa_hash_table_destroy(cache->ht, NULL);
+   cache->ht = NULL;
+
+   simple_mtx_destroy(&cache->mutex);
+
+   if (VN_DEBUG(CACHE)) {
+      vn_log(NULL, "dumping %s cache statistics", cache->name);
+      vn_log(NULL, "  hit %u\n", cache->debug.cache_hit_count);
+      vn_log(NULL, "  miss %u\n", cache->debug.cache_miss_count);
+      vn_log(NULL, "  skip %u\n", cache->debug.cache_skip_count);
+   }
+}
+
+bool
+vn_query_cache_get(struct vn_query_cache *cache,
+                   const uint8_t *key,
+                   void *data)
+{
+   assert(cache->ht);
+
+   simple_mtx_lock(&cache->mutex);
+   struct hash_entry *hash_entry = _mesa_hash_table_search(cache->ht, key);
+   if (hash_entry) {
+      struct vn_query_cache_entry *entry = hash_entry->data;
+      memcpy(data, entry->data, cache->data_size);
+      list_move_to(&entry->head, &cache->lru);
+      p_atomic_inc(&cache->debug.cache_hit_count);
+   } else {
+      p_atomic_inc(&cache->debug.cache_miss_count);
+   }
+   simple_mtx_unlock(&cache->mutex);
+
+   return !!hash_entry;
+}
+
+void
+vn_query_cache_put(struct vn_query_cache *cache,
+                   const uint8_t *key,
+                   const void *data)
+{
+   struct vn_query_cache_entry *entry;
+
+   assert(cache->ht);
+
+   simple_mtx_lock(&cache->mutex);
+
+   /* Check if entry was added before lock */
+   if (_mesa_hash_table_search(cache->ht, key)) {
+      simple_mtx_unlock(&cache->mutex);
+      return;
+   }
+
+   if (_mesa_hash_table_num_entries(cache->ht) == cache->max_entries) {
+      /* Evict/use the last entry in the lru list for this new entry */
+      entry = list_last_entry(&cache->lru, struct vn_query_cache_entry, head);
+
+      _mesa_hash_table_remove_key(cache->ht, entry->key);
+      list_del(&entry->head);
+   } else {
+      entry = vk_zalloc(cache->alloc, sizeof(*entry) + cache->data_size,
+                        VN_DEFAULT_ALIGN, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (!entry) {
+         simple_mtx_unlock(&cache->mutex);
+         return;
+      }
+   }
+
+   memcpy(entry->key, key, SHA1_DIGEST_LENGTH);
+   memcpy(entry->data, data, cache->data_size);
+
+   _mesa_hash_table_insert(cache->ht, entry->key, entry);
+   list_add(&entry->head, &cache->lru);
+
+   simple_mtx_unlock(&cache->mutex);
+}
@@ -26,8 +26,10 @@
 #include "util/bitset.h"
 #include "util/compiler.h"
 #include "util/detect_os.h"
+#include "util/hash_table.h"
 #include "util/list.h"
 #include "util/macros.h"
+#include "util/mesa-sha1.h"
 #include "util/os_time.h"
 #include "util/perf/cpu_trace.h"
 #include "util/simple_mtx.h"
@@ -127,6 +129,7 @@ enum vn_debug {
    VN_DEBUG_NO_SECOND_QUEUE = 1ull << 9,
    VN_DEBUG_NO_RAY_TRACING = 1ull << 10,
    VN_DEBUG_MEM_BUDGET = 1ull << 11,
+   VN_DEBUG_ROUNDTRIP = 1ull << 12,
 };
 
 enum vn_perf {
@@ -315,6 +318,32 @@ struct vn_cached_storage {
    void *data;
 };
 
+/* A bounded LRU cache for results of idempotent renderer queries, so that
+ * repeated queries can skip the ring roundtrip. Entries are keyed by a SHA1
+ * of the query input and hold a fixed-size copy of the result. The cache is
+ * disabled when init fails, and lookups then always miss.
+ *
+ * The current users are:
+ * - image memory requirements
+ * - image format properties
+ */
+struct vn_query_cache {
+   const VkAllocationCallbacks *alloc;
+   const char *name;
+   uint32_t data_size;
+   uint32_t max_entries;
+
+   struct hash_table *ht;
+   struct list_head lru;
+   simple_mtx_t mutex;
+
+   struct {
+      uint32_t cache_hit_count;
+      uint32_t cache_miss_count;
+      uint32_t cache_skip_count;
+   } debug;
+};
+
 void
 vn_env_init(void);
 
@@ -672,6 +701,38 @@ vn_cache_key_equal_function(const void *key1, const void *key2)
    return memcmp(key1, key2, SHA1_DIGEST_LENGTH) == 0;
 }
 
+void
+vn_query_cache_init(struct vn_query_cache *cache,
+                    const char *name,
+                    uint32_t data_size,
+                    uint32_t max_entries,
+                    const VkAllocationCallbacks *alloc);
+
+void
+vn_query_cache_fini(struct vn_query_cache *cache);
+
+bool
+vn_query_cache_get(struct vn_query_cache *cache,
+                   const uint8_t *key,
+                   void *data);
+
+void
+vn_query_cache_put(struct vn_query_cache *cache,
+                   const uint8_t *key,
+                   const void *data);
+
+static inline bool
+vn_query_cache_is_enabled(const struct vn_query_cache *cache)
+{
+   return cache->ht;
+}
+
+static inline void
+vn_query_cache_skip(struct vn_query_cache *cache)
+{
+   p_atomic_inc(&cache->debug.cache_skip_count);
+}
+
 static inline void
 vn_cached_storage_init(struct vn_cached_storage *storage,
                        const VkAllocationCallbacks *alloc)
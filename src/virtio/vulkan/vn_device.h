@@ -43,7 +43,7 @@ struct vn_device {
    uint32_t queue_count;
 
    struct vn_buffer_reqs_cache buffer_reqs_cache;
-   struct vn_image_reqs_cache image_reqs_cache;
+   struct vn_query_cache image_reqs_cache;
 
    bool has_sync2;
 
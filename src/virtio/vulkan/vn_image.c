@@ -78,15 +78,6 @@ vn_image_fill_reqs(const struct vn_image_memory_requirements *req,
    }
 }
 
-static void
-vn_image_cache_debug_dump(struct vn_image_reqs_cache *cache)
-{
-   vn_log(NULL, "dumping image reqs cache statistics");
-   vn_log(NULL, "  hit %u\n", cache->debug.cache_hit_count);
-   vn_log(NULL, "  miss %u\n", cache->debug.cache_miss_count);
-   vn_log(NULL, "  skip %u\n", cache->debug.cache_skip_count);
-}
-
 static bool
 vn_image_get_image_reqs_key(struct vn_device *dev,
                             const VkImageCreateInfo *create_info,
@@ -94,7 +85,7 @@ vn_image_get_image_reqs_key(struct vn_device *dev,
 {
    struct mesa_sha1 sha1_ctx;
 
-   if (!dev->image_reqs_cache.ht)
+   if (!vn_query_cache_is_enabled(&dev->image_reqs_cache))
       return false;
 
    /* Strip the alias bit as the memory requirements are identical.
@@ -159,7 +150,7 @@ vn_image_get_image_reqs_key(struct vn_device *dev,
       }
       default:
          /* Skip cache for unsupported pNext */
-         dev->image_reqs_cache.debug.cache_skip_count++;
+         vn_query_cache_skip(&dev->image_reqs_cache);
          return false;
       }
    }
@@ -197,42 +188,18 @@ vn_image_get_image_reqs_key(struct vn_device *dev,
 void
 vn_image_reqs_cache_init(struct vn_device *dev)
 {
-   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
-
    if (VN_PERF(NO_ASYNC_IMAGE_CREATE))
       return;
 
-   cache->ht = _mesa_hash_table_create(NULL, vn_cache_key_hash_function,
-                                       vn_cache_key_equal_function);
-   if (!cache->ht)
-      return;
-
-   simple_mtx_init(&cache->mutex, mtx_plain);
-   list_inithead(&dev->image_reqs_cache.lru);
+   vn_query_cache_init(&dev->image_reqs_cache, "image reqs",
+                       sizeof(struct vn_image_reqs_cache_data),
+                       IMAGE_REQS_CACHE_MAX_ENTRIES, &dev->base.vk.alloc);
 }
 
 void
 vn_image_reqs_cache_fini(struct vn_device *dev)
 {
-   const VkAllocationCallbacks *alloc = &dev->base.vk.alloc;
-   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
-
-   if (!cache->ht)
-      return;
-
-   hash_table_foreach(cache->ht, hash_entry) {
-      struct vn_image_reqs_cache_entry *cache_entry = hash_entry->data;
-      list_del(&cache_entry->head);
-      vk_free(alloc, cache_entry);
-   }
-   assert(list_is_empty(&dev->image_reqs_cache.lru));
-
-   _mesa_hash_table_destroy(cache->ht, NULL);
-
-   simple_mtx_destroy(&cache->mutex);
-
-   if (VN_DEBUG(CACHE))
-      vn_image_cache_debug_dump(cache);
+   vn_query_cache_fini(&dev->image_reqs_cache);
 }
 
 static bool
@@ -240,49 +207,30 @@ vn_image_init_reqs_from_cache(struct vn_device *dev,
                               struct vn_image *img,
                               uint8_t *key)
 {
-   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
-
-   assert(cache->ht);
-
-   simple_mtx_lock(&cache->mutex);
-   struct hash_entry *hash_entry = _mesa_hash_table_search(cache->ht, key);
-   if (hash_entry) {
-      struct vn_image_reqs_cache_entry *cache_entry = hash_entry->data;
-      for (uint32_t i = 0; i < cache_entry->plane_count; i++)
-         img->requirements[i] = cache_entry->requirements[i];
-      list_move_to(&cache_entry->head, &dev->image_reqs_cache.lru);
-      p_atomic_inc(&cache->debug.cache_hit_count);
-   } else {
-      p_atomic_inc(&cache->debug.cache_miss_count);
-   }
-   simple_mtx_unlock(&cache->mutex);
+   struct vn_image_reqs_cache_data data;
+
+   if (!vn_query_cache_get(&dev->image_reqs_cache, key, &data))
+      return false;
 
-   return !!hash_entry;
+   for (uint32_t i = 0; i < data.plane_count; i++)
+      img->requirements[i] = data.requirements[i];
+
+   return true;
 }
 
-static struct vn_image_memory_requirements *
+static bool
 vn_image_get_reqs_from_cache(struct vn_device *dev,
                              uint8_t *key,
-                             uint32_t plane)
+                             uint32_t plane,
+                             struct vn_image_memory_requirements *out)
 {
-   struct vn_image_memory_requirements *requirements = NULL;
-   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
-
-   assert(cache->ht);
-
-   simple_mtx_lock(&cache->mutex);
-   struct hash_entry *hash_entry = _mesa_hash_table_search(cache->ht, key);
-   if (hash_entry) {
-      struct vn_image_reqs_cache_entry *cache_entry = hash_entry->data;
-      requirements = &cache_entry->requirements[plane];
-      list_move_to(&cache_entry->head, &dev->image_reqs_cache.lru);
-      p_atomic_inc(&cache->debug.cache_hit_count);
-   } else {
-      p_atomic_inc(&cache->debug.cache_miss_count);
-   }
-   simple_mtx_unlock(&cache->mutex);
+   struct vn_image_reqs_cache_data data;
+
+   if (!vn_query_cache_get(&dev->image_reqs_cache, key, &data))
+      return false;
 
-   return requirements;
+   *out = data.requirements[plane];
+   return true;
 }
 
 static void
@@ -291,48 +239,14 @@ vn_image_store_reqs_in_cache(struct vn_device *dev,
                              uint32_t plane_count,
                              struct vn_image_memory_requirements *requirements)
 {
-   const VkAllocationCallbacks *alloc = &dev->base.vk.alloc;
-   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
-   struct vn_image_reqs_cache_entry *cache_entry;
-
-   assert(cache->ht);
-
-   simple_mtx_lock(&cache->mutex);
-
-   /* Check if entry was added before lock */
-   if (_mesa_hash_table_search(cache->ht, key)) {
-      simple_mtx_unlock(&cache->mutex);
-      return;
-   }
-
-   if (_mesa_hash_table_num_entries(cache->ht) ==
-       IMAGE_REQS_CACHE_MAX_ENTRIES) {
-      /* Evict/use the last entry in the lru list for this new entry */
-      cache_entry =
-         list_last_entry(&cache->lru, struct vn_image_reqs_cache_entry, head);
-
-      _mesa_hash_table_remove_key(cache->ht, cache_entry->key);
-      list_del(&cache_entry->head);
-   } else {
-      cache_entry = vk_zalloc(alloc, sizeof(*cache_entry), VN_DEFAULT_ALIGN,
-                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-      if (!cache_entry) {
-         simple_mtx_unlock(&cache->mutex);
-         return;
-      }
-   }
+   struct vn_image_reqs_cache_data data = {
+      .plane_count = plane_count,
+   };
 
    for (uint32_t i = 0; i < plane_count; i++)
-      cache_entry->requirements[i] = requirements[i];
-
-   memcpy(cache_entry->key, key, SHA1_DIGEST_LENGTH);
-   cache_entry->plane_count = plane_count;
-
-   _mesa_hash_table_insert(dev->image_reqs_cache.ht, cache_entry->key,
-                           cache_entry);
-   list_add(&cache_entry->head, &cache->lru);
+      data.requirements[i] = requirements[i];
 
-   simple_mtx_unlock(&cache->mutex);
+   vn_query_cache_put(&dev->image_reqs_cache, key, &data);
 }
 
 static void
@@ -1101,10 +1015,9 @@ vn_GetDeviceImageMemoryRequirements(
       if (pInfo->pCreateInfo->flags & VK_IMAGE_CREATE_DISJOINT_BIT)
          plane = vn_image_get_plane(pInfo->planeAspect);
 
-      const struct vn_image_memory_requirements *cached_reqs =
-         vn_image_get_reqs_from_cache(dev, key, plane);
-      if (cached_reqs) {
-         vn_image_fill_reqs(cached_reqs, pMemoryRequirements);
+      struct vn_image_memory_requirements cached_reqs;
+      if (vn_image_get_reqs_from_cache(dev, key, plane, &cached_reqs)) {
+         vn_image_fill_reqs(&cached_reqs, pMemoryRequirements);
          return;
       }
 
@@ -23,23 +23,9 @@ struct vn_image_memory_requirements {
    VkMemoryDedicatedRequirements dedicated;
 };
 
-struct vn_image_reqs_cache_entry {
+struct vn_image_reqs_cache_data {
    struct vn_image_memory_requirements requirements[4];
    uint8_t plane_count;
-   uint8_t key[SHA1_DIGEST_LENGTH];
-   struct list_head head;
-};
-
-struct vn_image_reqs_cache {
-   struct hash_table *ht;
-   struct list_head lru;
-   simple_mtx_t mutex;
-
-   struct {
-      uint32_t cache_hit_count;
-      uint32_t cache_miss_count;
-      uint32_t cache_skip_count;
-   } debug;
 };
 
 struct vn_image_create_deferred_info {
@@ -52,6 +52,15 @@ struct vn_instance {
       struct vn_watchdog watchdog;
    } ring;
 
+   /* ring traffic counted for VN_DEBUG=roundtrip and reset on each report */
+   struct {
+      uint32_t sync_calls;
+      uint32_t roundtrips;
+      uint32_t notifies;
+      uint32_t frames;
+      int64_t last_report;
+   } ring_stats;
+
    /* Between the driver and the app, VN_MAX_API_VERSION is what we advertise
     * and base.base.app_info.api_version is what the app requests.
     *
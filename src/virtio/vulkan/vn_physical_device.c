@@ -1598,58 +1598,22 @@ vn_physical_device_init_renderer_version(
    return VK_SUCCESS;
 }
 
-static void
-vn_image_format_cache_debug_dump(
-   struct vn_image_format_properties_cache *cache)
-{
-   vn_log(NULL, "dumping image format cache statistics");
-   vn_log(NULL, "  hit %u\n", cache->debug.cache_hit_count);
-   vn_log(NULL, "  miss %u\n", cache->debug.cache_miss_count);
-   vn_log(NULL, "  skip %u\n", cache->debug.cache_skip_count);
-}
-
 static void
 vn_image_format_cache_init(struct vn_physical_device *physical_dev)
 {
-   struct vn_image_format_properties_cache *cache =
-      &physical_dev->image_format_cache;
-
    if (VN_PERF(NO_ASYNC_IMAGE_FORMAT))
       return;
 
-   cache->ht = _mesa_hash_table_create(NULL, vn_cache_key_hash_function,
-                                       vn_cache_key_equal_function);
-   if (!cache->ht)
-      return;
-
-   simple_mtx_init(&cache->mutex, mtx_plain);
-   list_inithead(&cache->lru);
+   vn_query_cache_init(&physical_dev->image_format_cache, "image format",
+                       sizeof(struct vn_image_format_properties),
+                       IMAGE_FORMAT_CACHE_MAX_ENTRIES,
+                       &physical_dev->base.vk.instance->alloc);
 }
 
 static void
 vn_image_format_cache_fini(struct vn_physical_device *physical_dev)
 {
-   const VkAllocationCallbacks *alloc =
-      &physical_dev->base.vk.instance->alloc;
-   struct vn_image_format_properties_cache *cache =
-      &physical_dev->image_format_cache;
-
-   if (!cache->ht)
-      return;
-
-   hash_table_foreach(cache->ht, hash_entry) {
-      struct vn_image_format_cache_entry *cache_entry = hash_entry->data;
-      list_del(&cache_entry->head);
-      vk_free(alloc, cache_entry);
-   }
-   assert(list_is_empty(&cache->lru));
-
-   _mesa_hash_table_destroy(cache->ht, NULL);
-
-   simple_mtx_destroy(&cache->mutex);
-
-   if (VN_DEBUG(CACHE))
-      vn_image_format_cache_debug_dump(cache);
+   vn_query_cache_fini(&physical_dev->image_format_cache);
 }
 
 static void
@@ -2363,7 +2327,7 @@ vn_image_get_image_format_key(
 {
    struct mesa_sha1 sha1_ctx;
 
-   if (!physical_dev->image_format_cache.ht)
+   if (!vn_query_cache_is_enabled(&physical_dev->image_format_cache))
       return false;
 
    _mesa_sha1_init(&sha1_ctx);
@@ -2436,7 +2400,7 @@ vn_image_get_image_format_key(
             break;
          }
          default:
-            physical_dev->image_format_cache.debug.cache_skip_count++;
+            vn_query_cache_skip(&physical_dev->image_format_cache);
             return false;
          }
       }
@@ -2472,7 +2436,7 @@ vn_image_get_image_format_key(
                               sizeof(VkStructureType));
             break;
          default:
-            physical_dev->image_format_cache.debug.cache_skip_count++;
+            vn_query_cache_skip(&physical_dev->image_format_cache);
             return false;
          }
       }
@@ -2496,86 +2460,72 @@ vn_image_init_format_from_cache(
    VkResult *cached_result,
    uint8_t *key)
 {
-   struct vn_image_format_properties_cache *cache =
-      &physical_dev->image_format_cache;
+   struct vn_image_format_properties properties;
 
-   assert(cache->ht);
+   if (!vn_query_cache_get(&physical_dev->image_format_cache, key,
+                           &properties))
+      return false;
 
-   simple_mtx_lock(&cache->mutex);
-   struct hash_entry *hash_entry = _mesa_hash_table_search(cache->ht, key);
-   if (hash_entry) {
-      struct vn_image_format_cache_entry *cache_entry = hash_entry->data;
+   /* Copy the properties even if the cached_result is not supported.
+    * Per spec 1.3.275 "If the combination of parameters to
+    * vkGetPhysicalDeviceImageFormatProperties2 is not supported by the
+    * implementation for use in vkCreateImage, then all members of
+    * imageFormatProperties will be filled with zero."
+    */
+   pImageFormatProperties->imageFormatProperties =
+      properties.format.imageFormatProperties;
+   *cached_result = properties.cached_result;
 
-      /* Copy the properties even if the cached_result is not supported.
-       * Per spec 1.3.275 "If the combination of parameters to
-       * vkGetPhysicalDeviceImageFormatProperties2 is not supported by the
-       * implementation for use in vkCreateImage, then all members of
-       * imageFormatProperties will be filled with zero."
-       */
-      pImageFormatProperties->imageFormatProperties =
-         cache_entry->properties.format.imageFormatProperties;
-      *cached_result = cache_entry->properties.cached_result;
-
-      if (pImageFormatProperties->pNext) {
-         vk_foreach_struct_const(src, pImageFormatProperties->pNext) {
-            switch (src->sType) {
-            case VK_STRUCTURE_TYPE_EXTERNAL_IMAGE_FORMAT_PROPERTIES: {
-               VkExternalImageFormatProperties *ext_image =
-                  (VkExternalImageFormatProperties *)src;
-               ext_image->externalMemoryProperties =
-                  cache_entry->properties.ext_image.externalMemoryProperties;
-               break;
-            }
-            case VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY: {
-               VkHostImageCopyDevicePerformanceQuery *host_copy =
-                  (VkHostImageCopyDevicePerformanceQuery *)src;
-               host_copy->optimalDeviceAccess =
-                  cache_entry->properties.host_copy.optimalDeviceAccess;
-               host_copy->identicalMemoryLayout =
-                  cache_entry->properties.host_copy.identicalMemoryLayout;
-               break;
-            }
-            case VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_PROPERTIES_EXT: {
-               VkImageCompressionPropertiesEXT *compression =
-                  (VkImageCompressionPropertiesEXT *)src;
-               compression->imageCompressionFlags =
-                  cache_entry->properties.compression.imageCompressionFlags;
-               compression->imageCompressionFixedRateFlags =
-                  cache_entry->properties.compression
-                     .imageCompressionFixedRateFlags;
-               break;
-            }
-            case VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_IMAGE_FORMAT_PROPERTIES: {
-               VkSamplerYcbcrConversionImageFormatProperties *ycbcr_conversion =
-                  (VkSamplerYcbcrConversionImageFormatProperties *)src;
-               ycbcr_conversion->combinedImageSamplerDescriptorCount =
-                  cache_entry->properties.ycbcr_conversion
-                     .combinedImageSamplerDescriptorCount;
-               break;
-            }
-            case VK_STRUCTURE_TYPE_FILTER_CUBIC_IMAGE_VIEW_IMAGE_FORMAT_PROPERTIES_EXT: {
-               VkFilterCubicImageViewImageFormatPropertiesEXT *filter_cubic =
-                  (VkFilterCubicImageViewImageFormatPropertiesEXT *)src;
-               filter_cubic->filterCubic =
-                  cache_entry->properties.filter_cubic.filterCubic;
-               filter_cubic->filterCubicMinmax =
-                  cache_entry->properties.filter_cubic.filterCubicMinmax;
-               break;
-            }
-            default:
-               UNREACHABLE("unexpected format props pNext");
-            }
+   if (pImageFormatProperties->pNext) {
+      vk_foreach_struct_const(src, pImageFormatProperties->pNext) {
+         switch (src->sType) {
+         case VK_STRUCTURE_TYPE_EXTERNAL_IMAGE_FORMAT_PROPERTIES: {
+            VkExternalImageFormatProperties *ext_image =
+               (VkExternalImageFormatProperties *)src;
+            ext_image->externalMemoryProperties =
+               properties.ext_image.externalMemoryProperties;
+            break;
+         }
+         case VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY: {
+            VkHostImageCopyDevicePerformanceQuery *host_copy =
+               (VkHostImageCopyDevicePerformanceQuery *)src;
+            host_copy->optimalDeviceAccess =
+               properties.host_copy.optimalDeviceAccess;
+            host_copy->identicalMemoryLayout =
+               properties.host_copy.identicalMemoryLayout;
+            break;
+         }
+         case VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_PROPERTIES_EXT: {
+            VkImageCompressionPropertiesEXT *compression =
+               (VkImageCompressionPropertiesEXT *)src;
+            compression->imageCompressionFlags =
+               properties.compression.imageCompressionFlags;
+            compression->imageCompressionFixedRateFlags =
+               properties.compression.imageCompressionFixedRateFlags;
+            break;
+         }
+         case VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_IMAGE_FORMAT_PROPERTIES: {
+            VkSamplerYcbcrConversionImageFormatProperties *ycbcr_conversion =
+               (VkSamplerYcbcrConversionImageFormatProperties *)src;
+            ycbcr_conversion->combinedImageSamplerDescriptorCount =
+               properties.ycbcr_conversion.combinedImageSamplerDescriptorCount;
+            break;
+         }
+         case VK_STRUCTURE_TYPE_FILTER_CUBIC_IMAGE_VIEW_IMAGE_FORMAT_PROPERTIES_EXT: {
+            VkFilterCubicImageViewImageFormatPropertiesEXT *filter_cubic =
+               (VkFilterCubicImageViewImageFormatPropertiesEXT *)src;
+            filter_cubic->filterCubic = properties.filter_cubic.filterCubic;
+            filter_cubic->filterCubicMinmax =
+               properties.filter_cubic.filterCubicMinmax;
+            break;
+         }
+         default:
+            UNREACHABLE("unexpected format props pNext");
          }
       }
-
-      list_move_to(&cache_entry->head, &cache->lru);
-      p_atomic_inc(&cache->debug.cache_hit_count);
-   } else {
-      p_atomic_inc(&cache->debug.cache_miss_count);
    }
-   simple_mtx_unlock(&cache->mutex);
 
-   return !!hash_entry;
+   return true;
 }
 
 static void
@@ -2585,64 +2535,33 @@ vn_image_store_format_in_cache(
    VkImageFormatProperties2 *pImageFormatProperties,
    VkResult cached_result)
 {
-   const VkAllocationCallbacks *alloc =
-      &physical_dev->base.vk.instance->alloc;
-   struct vn_image_format_properties_cache *cache =
-      &physical_dev->image_format_cache;
-   struct vn_image_format_cache_entry *cache_entry = NULL;
-
-   assert(cache->ht);
-
-   simple_mtx_lock(&cache->mutex);
-
-   /* Check if entry was added before lock */
-   if (_mesa_hash_table_search(cache->ht, key)) {
-      simple_mtx_unlock(&cache->mutex);
-      return;
-   }
-
-   if (_mesa_hash_table_num_entries(cache->ht) ==
-       IMAGE_FORMAT_CACHE_MAX_ENTRIES) {
-      /* Evict/use the last entry in the lru list for this new entry */
-      cache_entry = list_last_entry(&cache->lru,
-                                    struct vn_image_format_cache_entry, head);
-
-      _mesa_hash_table_remove_key(cache->ht, cache_entry->key);
-      list_del(&cache_entry->head);
-   } else {
-      cache_entry = vk_zalloc(alloc, sizeof(*cache_entry), VN_DEFAULT_ALIGN,
-                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-      if (!cache_entry) {
-         simple_mtx_unlock(&cache->mutex);
-         return;
-      }
-   }
+   struct vn_image_format_properties properties = { 0 };
 
    if (pImageFormatProperties->pNext) {
       vk_foreach_struct_const(src, pImageFormatProperties->pNext) {
          switch (src->sType) {
          case VK_STRUCTURE_TYPE_EXTERNAL_IMAGE_FORMAT_PROPERTIES: {
-            cache_entry->properties.ext_image =
+            properties.ext_image =
                *((VkExternalImageFormatProperties *)src);
             break;
          }
          case VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY: {
-            cache_entry->properties.host_copy =
+            properties.host_copy =
                *((VkHostImageCopyDevicePerformanceQuery *)src);
             break;
          }
          case VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_PROPERTIES_EXT: {
-            cache_entry->properties.compression =
+            properties.compression =
                *((VkImageCompressionPropertiesEXT *)src);
             break;
          }
          case VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_IMAGE_FORMAT_PROPERTIES: {
-            cache_entry->properties.ycbcr_conversion =
+            properties.ycbcr_conversion =
                *((VkSamplerYcbcrConversionImageFormatProperties *)src);
             break;
          }
          case VK_STRUCTURE_TYPE_FILTER_CUBIC_IMAGE_VIEW_IMAGE_FORMAT_PROPERTIES_EXT: {
-            cache_entry->properties.filter_cubic =
+            properties.filter_cubic =
                *((VkFilterCubicImageViewImageFormatPropertiesEXT *)src);
             break;
          }
@@ -2652,15 +2571,10 @@ vn_image_store_format_in_cache(
       }
    }
 
-   cache_entry->properties.format = *pImageFormatProperties;
-   cache_entry->properties.cached_result = cached_result;
-
-   memcpy(cache_entry->key, key, SHA1_DIGEST_LENGTH);
-
-   _mesa_hash_table_insert(cache->ht, cache_entry->key, cache_entry);
-   list_add(&cache_entry->head, &cache->lru);
+   properties.format = *pImageFormatProperties;
+   properties.cached_result = cached_result;
 
-   simple_mtx_unlock(&cache->mutex);
+   vn_query_cache_put(&physical_dev->image_format_cache, key, &properties);
 }
 
 static inline void
@@ -35,24 +35,6 @@ struct vn_image_format_properties {
    VkFilterCubicImageViewImageFormatPropertiesEXT filter_cubic;
 };
 
-struct vn_image_format_cache_entry {
-   struct vn_image_format_properties properties;
-   uint8_t key[SHA1_DIGEST_LENGTH];
-   struct list_head head;
-};
-
-struct vn_image_format_properties_cache {
-   struct hash_table *ht;
-   struct list_head lru;
-   simple_mtx_t mutex;
-
-   struct {
-      uint32_t cache_hit_count;
-      uint32_t cache_miss_count;
-      uint32_t cache_skip_count;
-   } debug;
-};
-
 struct vn_layered_api_properties {
    VkPhysicalDeviceLayeredApiPropertiesKHR api;
    VkPhysicalDeviceLayeredApiVulkanPropertiesKHR vk;
@@ -132,7 +114,7 @@ struct vn_physical_device {
    simple_mtx_t format_update_mutex;
    struct util_sparse_array format_properties;
 
-   struct vn_image_format_properties_cache image_format_cache;
+   struct vn_query_cache image_format_cache;
 };
 VK_DEFINE_HANDLE_CASTS(vn_physical_device,
                        base.vk.base,
@@ -20,8 +20,10 @@
 #include "util/os_file.h"
 #include "util/os_misc.h"
 #include "util/sparse_array.h"
+#include "util/u_debug.h"
 #include "util/u_process.h"
 #include "vtest/vtest_protocol.h"
+#include "vtest/vtest_ring.h"
 
 #include "vn_renderer_internal.h"
 
@@ -54,6 +56,9 @@ struct vtest {
    mtx_t sock_mutex;
    int sock_fd;
 
+   /* submissions bypass the socket when the server supports it */
+   struct vtest_ring ring;
+
    uint32_t protocol_version;
    uint32_t max_timeline_count;
 
@@ -311,6 +316,32 @@ vtest_vcmd_context_init(struct vtest *vtest, uint32_t capset_id)
    vtest_write(vtest, vcmd_context_init, sizeof(vcmd_context_init));
 }
 
+static bool
+vtest_vcmd_cmd_ring_create(struct vtest *vtest, uint32_t buffer_size)
+{
+   uint32_t vtest_hdr[VTEST_HDR_SIZE];
+   uint32_t vcmd_ring_create[VCMD_CMD_RING_CREATE_SIZE];
+   vtest_hdr[VTEST_CMD_LEN] = VCMD_CMD_RING_CREATE_SIZE;
+   vtest_hdr[VTEST_CMD_ID] = VCMD_CMD_RING_CREATE;
+   vcmd_ring_create[VCMD_CMD_RING_CREATE_BUFFER_SIZE] = buffer_size;
+
+   vtest_write(vtest, vtest_hdr, sizeof(vtest_hdr));
+   vtest_write(vtest, vcmd_ring_create, sizeof(vcmd_ring_create));
+
+   uint32_t result;
+   vtest_read(vtest, vtest_hdr, sizeof(vtest_hdr));
+   assert(vtest_hdr[VTEST_CMD_LEN] == 1);
+   assert(vtest_hdr[VTEST_CMD_ID] == VCMD_CMD_RING_CREATE);
+   vtest_read(vtest, &result, sizeof(result));
+   if (result)
+      return false;
+
+   const int ring_fd = vtest_receive_fd(vtest);
+   const int doorbell_fd = vtest_receive_fd(vtest);
+
+   return vtest_ring_init(&vtest->ring, ring_fd, doorbell_fd, buffer_size);
+}
+
 static uint32_t
 vtest_vcmd_resource_create_blob(struct vtest *vtest,
                                 enum vcmd_blob_type type,
@@ -510,6 +541,18 @@ submit_cmd2_sizes(const struct vn_renderer_submit *submit,
    assert(*sync_size % sizeof(uint32_t) == 0);
 }
 
+static void
+vtest_submit_write(struct vtest *vtest,
+                   bool use_ring,
+                   const void *buf,
+                   size_t size)
+{
+   if (use_ring)
+      vtest_ring_write(&vtest->ring, buf, size);
+   else
+      vtest_write(vtest, buf, size);
+}
+
 static void
 vtest_vcmd_submit_cmd2(struct vtest *vtest,
                        const struct vn_renderer_submit *submit)
@@ -525,13 +568,18 @@ vtest_vcmd_submit_cmd2(struct vtest *vtest,
    uint32_t vtest_hdr[VTEST_HDR_SIZE];
    vtest_hdr[VTEST_CMD_LEN] = total_size / sizeof(uint32_t);
    vtest_hdr[VTEST_CMD_ID] = VCMD_SUBMIT_CMD2;
-   vtest_write(vtest, vtest_hdr, sizeof(vtest_hdr));
+
+   /* too large submissions still go through the socket */
+   const bool use_ring =
+      vtest->ring.map &&
+      vtest_ring_reserve(&vtest->ring, sizeof(vtest_hdr) + total_size);
+   vtest_submit_write(vtest, use_ring, vtest_hdr, sizeof(vtest_hdr));
 
    /* write batch count and batch headers */
    const uint32_t batch_count = submit->batch_count;
    size_t cs_offset = header_size;
    size_t sync_offset = cs_offset + cs_size;
-   vtest_write(vtest, &batch_count, sizeof(batch_count));
+   vtest_submit_write(vtest, use_ring, &batch_count, sizeof(batch_count));
    for (uint32_t i = 0; i < submit->batch_count; i++) {
       const struct vn_renderer_submit_batch *batch = &submit->batches[i];
       struct vcmd_submit_cmd2_batch dst = {
@@ -542,7 +590,7 @@ vtest_vcmd_submit_cmd2(struct vtest *vtest,
          .sync_count = batch->sync_count,
          .ring_idx = batch->ring_idx,
       };
-      vtest_write(vtest, &dst, sizeof(dst));
+      vtest_submit_write(vtest, use_ring, &dst, sizeof(dst));
 
       cs_offset += batch->cs_size;
       sync_offset +=
@@ -554,7 +602,8 @@ vtest_vcmd_submit_cmd2(struct vtest *vtest,
       for (uint32_t i = 0; i < submit->batch_count; i++) {
          const struct vn_renderer_submit_batch *batch = &submit->batches[i];
          if (batch->cs_size)
-            vtest_write(vtest, batch->cs_data, batch->cs_size);
+            vtest_submit_write(vtest, use_ring, batch->cs_data,
+                               batch->cs_size);
       }
    }
 
@@ -569,9 +618,12 @@ vtest_vcmd_submit_cmd2(struct vtest *vtest,
             (uint32_t)val,
             (uint32_t)(val >> 32),
          };
-         vtest_write(vtest, sync, sizeof(sync));
+         vtest_submit_write(vtest, use_ring, sync, sizeof(sync));
       }
    }
+
+   if (use_ring)
+      vtest_ring_submit(&vtest->ring);
 }
 
 static VkResult
@@ -963,6 +1015,8 @@ vtest_destroy(struct vn_renderer *renderer,
 
    vn_renderer_shmem_cache_fini(&vtest->shmem_cache);
 
+   vtest_ring_fini(&vtest->ring);
+
    if (vtest->sock_fd >= 0) {
       shutdown(vtest->sock_fd, SHUT_RDWR);
       close(vtest->sock_fd);
@@ -1059,6 +1113,11 @@ vtest_init(struct vtest *vtest)
 
    vtest_vcmd_context_init(vtest, vtest->capset.id);
 
+   if (vtest->protocol_version >= 5 &&
+       debug_get_bool_option("VTEST_SHM_RING", true) &&
+       !vtest_vcmd_cmd_ring_create(vtest, VTEST_RING_BUFFER_SIZE))
+      vn_log(vtest->instance, "failed to create command ring");
+
    vtest_init_renderer_info(vtest);
 
    vtest->base.ops.destroy = vtest_destroy;
@@ -641,6 +641,9 @@ vn_ring_submit_locked(struct vn_ring *ring,
    const bool notify =
       vn_ring_submit_internal(ring, submit.submit, submit.cs, &seqno);
    if (notify) {
+      if (VN_DEBUG(ROUNDTRIP))
+         p_atomic_inc(&ring->instance->ring_stats.notifies);
+
       uint32_t notify_ring_data[8];
       struct vn_cs_encoder local_enc = VN_CS_ENCODER_INITIALIZER_LOCAL(
          notify_ring_data, sizeof(notify_ring_data));
@@ -721,6 +724,9 @@ vn_ring_submit_command(struct vn_ring *ring,
 
    if (submit->reply_size) {
       if (likely(submit->ring_seqno_valid)) {
+         if (VN_DEBUG(ROUNDTRIP))
+            p_atomic_inc(&ring->instance->ring_stats.sync_calls);
+
          void *reply_ptr = submit->reply_shmem->mmap_ptr + reply_offset;
          submit->reply =
             VN_CS_DECODER_INITIALIZER(reply_ptr, submit->reply_size);
@@ -748,6 +754,9 @@ vn_ring_submit_roundtrip(struct vn_ring *ring, uint64_t *roundtrip_seqno)
    struct vn_cs_encoder local_enc =
       VN_CS_ENCODER_INITIALIZER_LOCAL(local_data, sizeof(local_data));
 
+   if (VN_DEBUG(ROUNDTRIP))
+      p_atomic_inc(&ring->instance->ring_stats.roundtrips);
+
    mtx_lock(&ring->roundtrip_mutex);
    const uint64_t seqno = ring->roundtrip_next++;
    vn_encode_vkSubmitVirtqueueSeqnoMESA(&local_enc, 0, ring->id, seqno);
@@ -765,3 +774,34 @@ vn_ring_wait_roundtrip(struct vn_ring *ring, uint64_t roundtrip_seqno)
 {
    vn_async_vkWaitVirtqueueSeqnoMESA(ring, roundtrip_seqno);
 }
+
+void
+vn_ring_report_frame(struct vn_instance *instance)
+{
+   const uint32_t frames = p_atomic_inc_return(&instance->ring_stats.frames);
+   const int64_t now = os_time_get_nano();
+   const int64_t last_report = instance->ring_stats.last_report;
+
+   if (!last_report) {
+      instance->ring_stats.last_report = now;
+      return;
+   }
+
+   /* report about once a second, averaged over the frames since then */
+   if (now - last_report < 1000ll * 1000 * 1000 ||
+       p_atomic_cmpxchg(&instance->ring_stats.frames, frames, 0) != frames)
+      return;
+
+   const uint32_t sync_calls =
+      p_atomic_xchg(&instance->ring_stats.sync_calls, 0);
+   const uint32_t roundtrips =
+      p_atomic_xchg(&instance->ring_stats.roundtrips, 0);
+   const uint32_t notifies = p_atomic_xchg(&instance->ring_stats.notifies, 0);
+   instance->ring_stats.last_report = now;
+
+   vn_log(instance,
+          "%u frames: %.1f sync calls, %.1f roundtrips, %.1f ring notifies "
+          "per frame",
+          frames, (double)sync_calls / frames, (double)roundtrips / frames,
+          (double)notifies / frames);
+}
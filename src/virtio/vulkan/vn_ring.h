@@ -130,6 +130,9 @@ vn_ring_submit_roundtrip(struct vn_ring *ring, uint64_t *roundtrip_seqno);
 void
 vn_ring_wait_roundtrip(struct vn_ring *ring, uint64_t roundtrip_seqno);
 
+void
+vn_ring_report_frame(struct vn_instance *instance);
+
 static inline void
 vn_ring_roundtrip(struct vn_ring *ring)
 {
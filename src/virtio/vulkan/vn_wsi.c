@@ -18,6 +18,7 @@
 #include "vn_instance.h"
 #include "vn_physical_device.h"
 #include "vn_queue.h"
+#include "vn_ring.h"
 
 #ifndef DRM_FORMAT_MOD_LINEAR
 #define DRM_FORMAT_MOD_LINEAR 0
@@ -799,6 +800,9 @@ vn_QueuePresentKHR(VkQueue _queue, const VkPresentInfoKHR *pPresentInfo)
    VK_FROM_HANDLE(vk_queue, queue_vk, _queue);
    struct vn_device *dev = vn_device_from_vk(queue_vk->base.device);
 
+   if (VN_DEBUG(ROUNDTRIP))
+      vn_ring_report_frame(dev->instance);
+
    if (!dev->renderer->info.has_implicit_fencing &&
        !VN_PERF(NO_ASYNC_PRESENT)) {
       struct vn_queue *queue = vn_queue_from_handle(_queue);
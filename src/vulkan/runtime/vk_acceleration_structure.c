@@ -39,6 +39,8 @@
 #include "radix_sort/common/vk/barrier.h"
 #include "radix_sort/shaders/push.h"
 
+#include "util/log.h"
+#include "util/u_debug.h"
 #include "util/u_string.h"
 
 static const uint32_t leaf_spv[] = {
@@ -118,6 +120,72 @@ vk_common_GetAccelerationStructureDeviceAddressKHR(
 #define KEY_ID_PAIR_SIZE 8
 #define MORTON_BIT_SIZE  24
 
+DEBUG_GET_ONCE_OPTION(bvh_builder, "MESA_VK_BVH_BUILDER", NULL)
+DEBUG_GET_ONCE_BOOL_OPTION(bvh_stats, "MESA_VK_BVH_STATS", false)
+
+static const char *
+vk_internal_build_type_name(enum vk_internal_build_type type)
+{
+   switch (type) {
+   case VK_INTERNAL_BUILD_TYPE_LBVH:
+      return "lbvh";
+   case VK_INTERNAL_BUILD_TYPE_PLOC:
+      return "ploc";
+   case VK_INTERNAL_BUILD_TYPE_HPLOC:
+      return "hploc";
+   case VK_INTERNAL_BUILD_TYPE_UPDATE:
+      return "update";
+   }
+   UNREACHABLE("Unknown internal_build_type");
+}
+
+/* MESA_VK_BVH_BUILDER=lbvh|ploc|hploc overrides the builder chosen by the
+ * runtime and driver heuristics, which is useful for comparing the builders
+ * on a given workload.  Updates and tiny BVHs keep their builder.
+ */
+static void
+vk_acceleration_structure_apply_builder_override(struct vk_acceleration_structure_build_state *state)
+{
+   const char *builder = debug_get_option_bvh_builder();
+   if (builder == NULL || state->leaf_node_count <= 4 ||
+       state->config.internal_type == VK_INTERNAL_BUILD_TYPE_UPDATE)
+      return;
+
+   if (!strcmp(builder, "lbvh"))
+      state->config.internal_type = VK_INTERNAL_BUILD_TYPE_LBVH;
+   else if (!strcmp(builder, "ploc"))
+      state->config.internal_type = VK_INTERNAL_BUILD_TYPE_PLOC;
+   else if (!strcmp(builder, "hploc"))
+      state->config.internal_type = VK_INTERNAL_BUILD_TYPE_HPLOC;
+}
+
+static void
+vk_acceleration_structure_log_build(const struct vk_acceleration_structure_build_state *state,
+                                    uint32_t leaf_count)
+{
+   const char *type =
+      state->build_info->type == VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR ? "tlas" : "blas";
+   const char *geometry;
+   switch (vk_get_as_geometry_type(state->build_info)) {
+   case VK_GEOMETRY_TYPE_TRIANGLES_KHR:
+      geometry = "triangles";
+      break;
+   case VK_GEOMETRY_TYPE_AABBS_KHR:
+      geometry = "aabbs";
+      break;
+   default:
+      geometry = "instances";
+      break;
+   }
+
+   mesa_logi("bvh build: %s %s, %u leaves (bucket 2^%u), %u internal nodes, "
+             "builder %s, flags 0x%x, scratch %u B",
+             type, geometry, leaf_count, util_logbase2_ceil(MAX2(leaf_count, 1)),
+             MAX2(leaf_count, 2) - 1,
+             vk_internal_build_type_name(state->config.internal_type),
+             state->build_info->flags, state->scratch.size);
+}
+
 static void
 vk_acceleration_structure_build_state_init(struct vk_acceleration_structure_build_state *state,
                                            struct vk_device *device, uint32_t leaf_count,
@@ -150,6 +218,8 @@ vk_acceleration_structure_build_state_init(struct vk_acceleration_structure_buil
    if (device->as_build_ops->get_build_config)
       device->as_build_ops->get_build_config(vk_device_to_handle(device), state);
 
+   vk_acceleration_structure_apply_builder_override(state);
+
    uint32_t internal_count = MAX2(leaf_count, 2) - 1;
 
    radix_sort_vk_memory_requirements_t requirements = {
@@ -464,8 +534,9 @@ vk_accel_struct_cmd_begin_debug_marker(VkCommandBuffer commandBuffer,
    char name[256];
    switch (marker->step) {
    case VK_ACCELERATION_STRUCTURE_BUILD_STEP_TOP:
-      snprintf(name, sizeof(name), "vkCmdBuildAccelerationStructuresKHR(blas_count=%u, tlas_count=%u)",
-               marker->top.blas_count, marker->top.tlas_count);
+      snprintf(name, sizeof(name),
+               "vkCmdBuildAccelerationStructuresKHR(blas_count=%u, tlas_count=%u, primitive_count=%u)",
+               marker->top.blas_count, marker->top.tlas_count, marker->top.primitive_count);
       break;
    case VK_ACCELERATION_STRUCTURE_BUILD_STEP_BUILD_LEAVES:
       snprintf(name, sizeof(name), "build_leaves");
@@ -482,6 +553,9 @@ vk_accel_struct_cmd_begin_debug_marker(VkCommandBuffer commandBuffer,
    case VK_ACCELERATION_STRUCTURE_BUILD_STEP_PLOC_BUILD_INTERNAL:
       snprintf(name, sizeof(name), "ploc_build_internal");
       break;
+   case VK_ACCELERATION_STRUCTURE_BUILD_STEP_HPLOC_BUILD_INTERNAL:
+      snprintf(name, sizeof(name), "hploc_build_internal");
+      break;
    case VK_ACCELERATION_STRUCTURE_BUILD_STEP_ENCODE:
    case VK_ACCELERATION_STRUCTURE_BUILD_STEP_UPDATE: {
       const char *type = marker->step == VK_ACCELERATION_STRUCTURE_BUILD_STEP_ENCODE ? "encode" : "update";
@@ -699,6 +773,12 @@ morton_sort(VkCommandBuffer commandBuffer, struct vk_device *device,
     *
     * Note that the `partitions` buffer can be zeroed anytime before the first
     * scatter.
+    *
+    * This is already the single-sweep ("Onesweep") form of the sort: one
+    * HISTOGRAM dispatch computes the digit histograms of all passes, and each
+    * SCATTER resolves its global offsets with a decoupled lookback over the
+    * `partitions` instead of separate upsweep/downsweep dispatches.  With
+    * MORTON_BIT_SIZE bit keys, that is 3 + passes dispatches per batch.
     */
 
    /* How many passes? */
@@ -1177,6 +1257,9 @@ vk_cmd_build_acceleration_structures(VkCommandBuffer commandBuffer,
          default:
             break;
          }
+
+         for (uint32_t j = 0; j < pInfos[i].geometryCount; ++j)
+            top_marker.top.primitive_count += ppBuildRangeInfos[i][j].primitiveCount;
       }
       ops->begin_debug_marker(commandBuffer, &top_marker);
    }
@@ -1190,6 +1273,9 @@ vk_cmd_build_acceleration_structures(VkCommandBuffer commandBuffer,
       vk_acceleration_structure_build_state_init(&bvh_states[i].vk, cmd_buffer->base.device, leaf_node_count,
                                                  pInfos + i, args);
 
+      if (unlikely(debug_get_option_bvh_stats()))
+         vk_acceleration_structure_log_build(&bvh_states[i].vk, leaf_node_count);
+
       bvh_states[i].vk.build_range_infos = ppBuildRangeInfos[i];
       /* The leaf node dispatch code uses leaf_node_count as a base index. */
       bvh_states[i].vk.leaf_node_count = 0;
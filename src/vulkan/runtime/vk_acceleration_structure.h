@@ -54,6 +54,7 @@ struct vk_acceleration_structure_build_marker {
       struct {
          uint32_t blas_count;
          uint32_t tlas_count;
+         uint32_t primitive_count;
       } top; /* Used for VK_ACCELERATION_STRUCTURE_BUILD_STEP_TOP */
       struct {
          uint32_t pass;
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "vk_cmd_arena.h"
+
+#include "vk_alloc.h"
+#include "vk_command_pool.h"
+
+#include "util/u_math.h"
+
+/* Size of the chunks which are recycled through the pool, including the
+ * header.  Bigger allocations get a chunk of their own.
+ */
+#define VK_CMD_ARENA_CHUNK_SIZE (16 * 1024)
+
+struct vk_cmd_arena_chunk {
+   struct list_head link;
+   size_t size;
+   uint64_t data[];
+};
+
+#define VK_CMD_ARENA_CHUNK_DATA_SIZE \
+   (VK_CMD_ARENA_CHUNK_SIZE - sizeof(struct vk_cmd_arena_chunk))
+
+static struct vk_cmd_arena_chunk *
+vk_cmd_arena_chunk_alloc(struct vk_command_pool *pool, size_t size)
+{
+   struct vk_cmd_arena_chunk *chunk =
+      vk_alloc(&pool->alloc, sizeof(*chunk) + size, 8,
+               VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   if (chunk != NULL)
+      chunk->size = size;
+
+   return chunk;
+}
+
+static void *
+vk_cmd_arena_alloc_large(struct vk_cmd_arena *arena, size_t size, size_t align)
+{
+   struct vk_cmd_arena_chunk *chunk =
+      vk_cmd_arena_chunk_alloc(arena->pool, size + align);
+   if (chunk == NULL)
+      return NULL;
+
+   /* Keep allocating from the current chunk after this. */
+   list_addtail(&chunk->link, &arena->chunks);
+
+   return (void *)align_uintptr((uintptr_t)chunk->data, align);
+}
+
+static void *VKAPI_PTR
+vk_cmd_arena_alloc(void *user_data, size_t size, size_t align,
+                   VkSystemAllocationScope scope)
+{
+   struct vk_cmd_arena *arena = user_data;
+
+   assert(util_is_power_of_two_nonzero_uintptr(align));
+
+   char *ptr = (char *)align_uintptr((uintptr_t)arena->next, align);
+   if (arena->next != NULL && size <= (size_t)(arena->end - ptr)) {
+      arena->next = ptr + size;
+      return ptr;
+   }
+
+   if (size + align > VK_CMD_ARENA_CHUNK_DATA_SIZE / 4)
+      return vk_cmd_arena_alloc_large(arena, size, align);
+
+   struct vk_cmd_arena_chunk *chunk;
+   if (!list_is_empty(&arena->pool->free_cmd_arena_chunks)) {
+      chunk = list_first_entry(&arena->pool->free_cmd_arena_chunks,
+                               struct vk_cmd_arena_chunk, link);
+      list_del(&chunk->link);
+   } else {
+      chunk = vk_cmd_arena_chunk_alloc(arena->pool,
+                                       VK_CMD_ARENA_CHUNK_DATA_SIZE);
+      if (chunk == NULL)
+         return NULL;
+   }
+
+   list_add(&chunk->link, &arena->chunks);
+
+   ptr = (char *)align_uintptr((uintptr_t)chunk->data, align);
+   arena->next = ptr + size;
+   arena->end = (char *)chunk->data + chunk->size;
+
+   return ptr;
+}
+
+static void *VKAPI_PTR
+vk_cmd_arena_realloc(void *user_data, void *original, size_t size,
+                     size_t align, VkSystemAllocationScope scope)
+{
+   /* The command queue never reallocates and the arena doesn't track the
+    * size of its allocations.
+    */
+   UNREACHABLE("vk_cmd_arena doesn't support reallocation");
+}
+
+static void VKAPI_PTR
+vk_cmd_arena_free(void *user_data, void *memory)
+{
+   /* Everything is freed by vk_cmd_arena_reset() */
+}
+
+void
+vk_cmd_arena_init(struct vk_cmd_arena *arena, struct vk_command_pool *pool)
+{
+   arena->alloc = (VkAllocationCallbacks) {
+      .pUserData = arena,
+      .pfnAllocation = vk_cmd_arena_alloc,
+      .pfnReallocation = vk_cmd_arena_realloc,
+      .pfnFree = vk_cmd_arena_free,
+   };
+   arena->pool = pool;
+   list_inithead(&arena->chunks);
+   arena->next = NULL;
+   arena->end = NULL;
+}
+
+void
+vk_cmd_arena_reset(struct vk_cmd_arena *arena)
+{
+   list_for_each_entry_safe(struct vk_cmd_arena_chunk, chunk,
+                            &arena->chunks, link) {
+      if (chunk->size == VK_CMD_ARENA_CHUNK_DATA_SIZE) {
+         list_del(&chunk->link);
+         list_add(&chunk->link, &arena->pool->free_cmd_arena_chunks);
+      } else {
+         vk_free(&arena->pool->alloc, chunk);
+      }
+   }
+   list_inithead(&arena->chunks);
+   arena->next = NULL;
+   arena->end = NULL;
+}
+
+void
+vk_cmd_arena_pool_trim(struct vk_command_pool *pool)
+{
+   list_for_each_entry_safe(struct vk_cmd_arena_chunk, chunk,
+                            &pool->free_cmd_arena_chunks, link)
+      vk_free(&pool->alloc, chunk);
+   list_inithead(&pool->free_cmd_arena_chunks);
+}
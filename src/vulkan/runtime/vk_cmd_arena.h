@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024 Mesa contributors
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef VK_CMD_ARENA_H
+#define VK_CMD_ARENA_H
+
+#include <vulkan/vulkan_core.h>
+
+#include "util/list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct vk_command_pool;
+
+/** Chunked allocator for the vk_cmd_queue of a command buffer
+ *
+ * The entries of a vk_cmd_queue are all freed together when the command
+ * buffer is reset or destroyed, so there is no need to allocate each of them
+ * separately.  The arena hands out memory from chunks which are taken from
+ * the command pool, and gives the chunks back to the pool on reset.  The
+ * pool keeps them for the next recording until vkTrimCommandPool() or the
+ * pool is destroyed.
+ */
+struct vk_cmd_arena {
+   /** Callbacks allocating from this arena, freeing is a no-op */
+   VkAllocationCallbacks alloc;
+
+   struct vk_command_pool *pool;
+
+   /** Chunks owned by this arena, the one allocated from comes first */
+   struct list_head chunks;
+
+   char *next;
+   char *end;
+};
+
+void vk_cmd_arena_init(struct vk_cmd_arena *arena,
+                       struct vk_command_pool *pool);
+
+/** Returns all memory of the arena to the pool */
+void vk_cmd_arena_reset(struct vk_cmd_arena *arena);
+
+static inline void
+vk_cmd_arena_finish(struct vk_cmd_arena *arena)
+{
+   vk_cmd_arena_reset(arena);
+}
+
+/** Frees the chunks the pool keeps for its command buffers */
+void vk_cmd_arena_pool_trim(struct vk_command_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VK_CMD_ARENA_H */
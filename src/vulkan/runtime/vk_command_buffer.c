@@ -44,7 +44,9 @@ vk_command_buffer_init(struct vk_command_pool *pool,
    vk_dynamic_graphics_state_init(&command_buffer->dynamic_graphics_state);
    command_buffer->state = MESA_VK_COMMAND_BUFFER_STATE_INITIAL;
    command_buffer->record_result = VK_SUCCESS;
-   vk_cmd_queue_init(&command_buffer->cmd_queue, &pool->alloc);
+   vk_cmd_arena_init(&command_buffer->cmd_arena, pool);
+   vk_cmd_queue_init(&command_buffer->cmd_queue,
+                     &command_buffer->cmd_arena.alloc);
    vk_meta_object_list_init(&command_buffer->meta_objects);
    command_buffer->labels = UTIL_DYNARRAY_INIT;
    command_buffer->region_begin = true;
@@ -62,6 +64,7 @@ vk_command_buffer_reset(struct vk_command_buffer *command_buffer)
    command_buffer->record_result = VK_SUCCESS;
    vk_command_buffer_reset_render_pass(command_buffer);
    vk_cmd_queue_reset(&command_buffer->cmd_queue);
+   vk_cmd_arena_reset(&command_buffer->cmd_arena);
    vk_meta_object_list_reset(command_buffer->base.device,
                              &command_buffer->meta_objects);
    util_dynarray_foreach (&command_buffer->labels, VkDebugUtilsLabelEXT, label)
@@ -100,6 +103,7 @@ vk_command_buffer_finish(struct vk_command_buffer *command_buffer)
    list_del(&command_buffer->pool_link);
    vk_command_buffer_reset_render_pass(command_buffer);
    vk_cmd_queue_finish(&command_buffer->cmd_queue);
+   vk_cmd_arena_finish(&command_buffer->cmd_arena);
    util_dynarray_foreach (&command_buffer->labels, VkDebugUtilsLabelEXT, label)
       vk_free(&command_buffer->base.device->alloc, (void *)label->pLabelName);
    util_dynarray_fini(&command_buffer->labels);
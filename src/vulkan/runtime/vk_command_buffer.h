@@ -24,6 +24,7 @@
 #ifndef VK_COMMAND_BUFFER_H
 #define VK_COMMAND_BUFFER_H
 
+#include "vk_cmd_arena.h"
 #include "vk_cmd_queue.h"
 #include "vk_graphics_state.h"
 #include "vk_log.h"
@@ -133,6 +134,9 @@ struct vk_command_buffer {
    /** Command list for emulated secondary command buffers */
    struct vk_cmd_queue cmd_queue;
 
+   /** Memory of the cmd_queue entries */
+   struct vk_cmd_arena cmd_arena;
+
    /** Object list for meta objects */
    struct vk_meta_object_list meta_objects;
 
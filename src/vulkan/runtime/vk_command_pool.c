@@ -25,6 +25,7 @@
 #include "vk_command_pool.h"
 
 #include "vk_alloc.h"
+#include "vk_cmd_arena.h"
 #include "vk_command_buffer.h"
 #include "vk_common_entrypoints.h"
 #include "vk_device.h"
@@ -79,6 +80,8 @@ vk_command_pool_init(struct vk_device *device,
    for (uint32_t i = 0; i < ARRAY_SIZE(pool->free_command_buffers); i++)
       list_inithead(&pool->free_command_buffers[i]);
 
+   list_inithead(&pool->free_cmd_arena_chunks);
+
    return VK_SUCCESS;
 }
 
@@ -92,6 +95,7 @@ vk_command_pool_finish(struct vk_command_pool *pool)
    assert(list_is_empty(&pool->command_buffers));
 
    destroy_free_command_buffers(pool);
+   vk_cmd_arena_pool_trim(pool);
 
    vk_object_base_finish(&pool->base);
 }
@@ -261,6 +265,7 @@ vk_command_pool_trim(struct vk_command_pool *pool,
                      VkCommandPoolTrimFlags flags)
 {
    destroy_free_command_buffers(pool);
+   vk_cmd_arena_pool_trim(pool);
 }
 
 VKAPI_ATTR void VKAPI_CALL
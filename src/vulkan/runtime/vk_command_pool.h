@@ -55,6 +55,9 @@ struct vk_command_pool {
 
    /** List of freed command buffers for trimming. */
    struct list_head free_command_buffers[2];
+
+   /** Chunks kept for the vk_cmd_arena of the command buffers */
+   struct list_head free_cmd_arena_chunks;
 };
 
 VK_DEFINE_NONDISP_HANDLE_CASTS(vk_command_pool, base, VkCommandPool,
@@ -29,6 +29,41 @@
 #include "vk_device.h"
 #include "vk_log.h"
 
+/* Tries to append the descriptors of next to entry.  This is the case if
+ * next writes the array elements of the same binding right after the ones
+ * written by entry, from user data which continues with the same stride.
+ * Applications commonly split a range of descriptors in several template
+ * entries, and coalescing them saves the drivers from doing the per-entry
+ * work on every update.
+ */
+static bool
+vk_descriptor_template_entry_coalesce(struct vk_descriptor_template_entry *entry,
+                                      const struct vk_descriptor_template_entry *next)
+{
+   if (next->type != entry->type || next->binding != entry->binding ||
+       next->array_element != entry->array_element + entry->array_count)
+      return false;
+
+   /* For inline uniform blocks, the array element and count are bytes and
+    * the stride is ignored.
+    */
+   if (entry->type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK) {
+      if (next->offset != entry->offset + entry->array_count)
+         return false;
+   } else {
+      size_t stride = entry->array_count > 1 ? entry->stride : next->stride;
+      if (next->array_count > 1 && next->stride != stride)
+         return false;
+      if (next->offset != entry->offset + entry->array_count * stride)
+         return false;
+
+      entry->stride = stride;
+   }
+
+   entry->array_count += next->array_count;
+   return true;
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
    const VkDescriptorUpdateTemplateCreateInfo *pCreateInfo,
@@ -66,7 +101,6 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
       template->set = pCreateInfo->set;
 
    uint32_t entry_idx = 0;
-   template->entry_count = entry_count;
    for (uint32_t i = 0; i < pCreateInfo->descriptorUpdateEntryCount; i++) {
       const VkDescriptorUpdateTemplateEntry *pEntry =
          &pCreateInfo->pDescriptorUpdateEntries[i];
@@ -74,7 +108,7 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
       if (pEntry->descriptorCount == 0)
          continue;
 
-      template->entries[entry_idx++] = (struct vk_descriptor_template_entry) {
+      const struct vk_descriptor_template_entry entry = {
          .type = pEntry->descriptorType,
          .binding = pEntry->dstBinding,
          .array_element = pEntry->dstArrayElement,
@@ -82,8 +116,16 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
          .offset = pEntry->offset,
          .stride = pEntry->stride,
       };
+
+      if (entry_idx > 0 &&
+          vk_descriptor_template_entry_coalesce(&template->entries[entry_idx - 1],
+                                                &entry))
+         continue;
+
+      template->entries[entry_idx++] = entry;
    }
-   assert(entry_idx == entry_count);
+   assert(entry_idx <= entry_count);
+   template->entry_count = entry_idx;
 
    *pDescriptorUpdateTemplate =
       vk_descriptor_update_template_to_handle(template);
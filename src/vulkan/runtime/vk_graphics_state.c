@@ -2305,6 +2305,31 @@ vk_cmd_set_dynamic_graphics_state(struct vk_command_buffer *cmd,
    vk_dynamic_graphics_state_copy(&cmd->dynamic_graphics_state, state);
 }
 
+static bool
+vk_vertex_input_state_equal(const struct vk_vertex_input_state *a,
+                            const struct vk_vertex_input_state *b)
+{
+   if (a->bindings_valid != b->bindings_valid ||
+       a->attributes_valid != b->attributes_valid)
+      return false;
+
+   u_foreach_bit(b_idx, a->bindings_valid) {
+      if (a->bindings[b_idx].stride != b->bindings[b_idx].stride ||
+          a->bindings[b_idx].input_rate != b->bindings[b_idx].input_rate ||
+          a->bindings[b_idx].divisor != b->bindings[b_idx].divisor)
+         return false;
+   }
+
+   u_foreach_bit(a_idx, a->attributes_valid) {
+      if (a->attributes[a_idx].binding != b->attributes[a_idx].binding ||
+          a->attributes[a_idx].format != b->attributes[a_idx].format ||
+          a->attributes[a_idx].offset != b->attributes[a_idx].offset)
+         return false;
+   }
+
+   return true;
+}
+
 VKAPI_ATTR void VKAPI_CALL
 vk_common_CmdSetVertexInputEXT(VkCommandBuffer commandBuffer,
    uint32_t vertexBindingDescriptionCount,
@@ -2315,7 +2340,11 @@ vk_common_CmdSetVertexInputEXT(VkCommandBuffer commandBuffer,
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
 
-   uint32_t bindings_valid = 0;
+   /* Translation layers tend to set the same vertex input state over and
+    * over, so build it on the side and only dirty it if it changed.
+    */
+   struct vk_vertex_input_state vi;
+   vi.bindings_valid = 0;
    for (uint32_t i = 0; i < vertexBindingDescriptionCount; i++) {
       const VkVertexInputBindingDescription2EXT *desc =
          &pVertexBindingDescriptions[i];
@@ -2325,39 +2354,49 @@ vk_common_CmdSetVertexInputEXT(VkCommandBuffer commandBuffer,
       assert(desc->inputRate <= UINT8_MAX);
 
       const uint32_t b = desc->binding;
-      bindings_valid |= BITFIELD_BIT(b);
-      dyn->vi->bindings[b].stride = desc->stride;
-      dyn->vi->bindings[b].input_rate = desc->inputRate;
-      dyn->vi->bindings[b].divisor = desc->divisor;
+      vi.bindings_valid |= BITFIELD_BIT(b);
+      vi.bindings[b].stride = desc->stride;
+      vi.bindings[b].input_rate = desc->inputRate;
+      vi.bindings[b].divisor = desc->divisor;
 
       /* Also set bindings_strides in case a driver is keying off that */
-      dyn->vi_binding_strides[b] = desc->stride;
+      SET_DYN_VALUE(dyn, VI_BINDING_STRIDES, vi_binding_strides[b],
+                    desc->stride);
    }
+   BITSET_SET(dyn->set, MESA_VK_DYNAMIC_VI_BINDING_STRIDES);
 
-   dyn->vi->bindings_valid = bindings_valid;
-   SET_DYN_VALUE(dyn, VI_BINDINGS_VALID, vi_bindings_valid, bindings_valid);
+   SET_DYN_VALUE(dyn, VI_BINDINGS_VALID, vi_bindings_valid, vi.bindings_valid);
 
-   uint32_t attributes_valid = 0;
+   vi.attributes_valid = 0;
    for (uint32_t i = 0; i < vertexAttributeDescriptionCount; i++) {
       const VkVertexInputAttributeDescription2EXT *desc =
          &pVertexAttributeDescriptions[i];
 
       assert(desc->location < MESA_VK_MAX_VERTEX_ATTRIBUTES);
       assert(desc->binding < MESA_VK_MAX_VERTEX_BINDINGS);
-      assert(bindings_valid & BITFIELD_BIT(desc->binding));
+      assert(vi.bindings_valid & BITFIELD_BIT(desc->binding));
 
       const uint32_t a = desc->location;
-      attributes_valid |= BITFIELD_BIT(a);
-      dyn->vi->attributes[a].binding = desc->binding;
-      dyn->vi->attributes[a].format = desc->format;
-      dyn->vi->attributes[a].offset = desc->offset;
+      vi.attributes_valid |= BITFIELD_BIT(a);
+      vi.attributes[a].binding = desc->binding;
+      vi.attributes[a].format = desc->format;
+      vi.attributes[a].offset = desc->offset;
    }
-   dyn->vi->attributes_valid = attributes_valid;
+
+   if (BITSET_TEST(dyn->set, MESA_VK_DYNAMIC_VI) &&
+       vk_vertex_input_state_equal(dyn->vi, &vi))
+      return;
+
+   dyn->vi->bindings_valid = vi.bindings_valid;
+   u_foreach_bit(b, vi.bindings_valid)
+      dyn->vi->bindings[b] = vi.bindings[b];
+
+   dyn->vi->attributes_valid = vi.attributes_valid;
+   u_foreach_bit(a, vi.attributes_valid)
+      dyn->vi->attributes[a] = vi.attributes[a];
 
    BITSET_SET(dyn->set, MESA_VK_DYNAMIC_VI);
-   BITSET_SET(dyn->set, MESA_VK_DYNAMIC_VI_BINDING_STRIDES);
    BITSET_SET(dyn->dirty, MESA_VK_DYNAMIC_VI);
-   BITSET_SET(dyn->dirty, MESA_VK_DYNAMIC_VI_BINDING_STRIDES);
 }
 
 void
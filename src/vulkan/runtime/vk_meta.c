@@ -29,6 +29,7 @@
 #include "vk_device.h"
 #include "vk_format.h"
 #include "vk_pipeline.h"
+#include "vk_pipeline_cache.h"
 #include "vk_util.h"
 
 #include "nir.h"
@@ -105,6 +106,35 @@ vk_meta_device_finish(struct vk_device *device,
    }
    _mesa_hash_table_destroy(meta->cache, NULL);
    simple_mtx_destroy(&meta->cache_mtx);
+
+   if (meta->owns_pipeline_cache) {
+      VK_FROM_HANDLE(vk_pipeline_cache, cache, meta->pipeline_cache);
+      vk_pipeline_cache_destroy(cache, NULL);
+   }
+}
+
+VkResult
+vk_meta_device_init_pipeline_cache(struct vk_device *device,
+                                   struct vk_meta_device *meta)
+{
+   assert(meta->pipeline_cache == VK_NULL_HANDLE);
+
+   const VkPipelineCacheCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+   };
+   struct vk_pipeline_cache_create_info info = {
+      .pCreateInfo = &create_info,
+      .skip_disk_cache = device->disable_internal_cache,
+   };
+   struct vk_pipeline_cache *cache =
+      vk_pipeline_cache_create(device, &info, NULL);
+   if (cache == NULL)
+      return vk_error(device, VK_ERROR_OUT_OF_HOST_MEMORY);
+
+   meta->pipeline_cache = vk_pipeline_cache_to_handle(cache);
+   meta->owns_pipeline_cache = true;
+
+   return VK_SUCCESS;
 }
 
 uint64_t
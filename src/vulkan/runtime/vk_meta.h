@@ -108,6 +108,11 @@ struct vk_meta_device {
 
    VkPipelineCache pipeline_cache;
 
+   /* Set if pipeline_cache was created by
+    * vk_meta_device_init_pipeline_cache() and is destroyed with the device.
+    */
+   bool owns_pipeline_cache;
+
    uint32_t max_bind_map_buffer_size_B;
    bool use_layered_rendering;
    bool use_gs_for_layer;
@@ -159,6 +164,17 @@ VkResult vk_meta_device_init(struct vk_device *device,
 void vk_meta_device_finish(struct vk_device *device,
                            struct vk_meta_device *meta);
 
+/** Creates a pipeline cache for meta pipelines
+ *
+ * This is for drivers which implement VkPipelineCache with vk_pipeline_cache.
+ * Unlike the weak-ref vk_device::mem_cache, the meta cache keeps the meta
+ * shaders alive for the lifetime of the device, and it is backed by the disk
+ * cache so meta pipelines don't have to be recompiled by every new device.
+ * Must be called after vk_meta_device_init().
+ */
+VkResult vk_meta_device_init_pipeline_cache(struct vk_device *device,
+                                            struct vk_meta_device *meta);
+
 /** Keys should start with one of these to ensure uniqueness */
 enum vk_meta_object_key_type {
    VK_META_OBJECT_KEY_TYPE_INVALID = 0,
@@ -188,11 +188,15 @@ vk_pipeline_shader_stage_to_nir(struct vk_device *device,
       return VK_SUCCESS;
    }
 
+   struct spirv_to_nir_options spirv_options_local = *spirv_options;
    const uint32_t *spirv_data;
    uint32_t spirv_size;
    if (module != NULL) {
       spirv_data = (uint32_t *)module->data;
       spirv_size = module->size;
+
+      /* The module was hashed when it was created */
+      spirv_options_local.source_blake3 = module->hash;
    } else {
       const VkShaderModuleCreateInfo *minfo =
          vk_find_struct_const(info->pNext, SHADER_MODULE_CREATE_INFO);
@@ -207,7 +211,7 @@ vk_pipeline_shader_stage_to_nir(struct vk_device *device,
    nir_shader *nir = vk_spirv_to_nir(device, spirv_data, spirv_size, stage,
                                      info->pName,
                                      info->pSpecializationInfo,
-                                     spirv_options, nir_options,
+                                     &spirv_options_local, nir_options,
                                      false /* internal */,
                                      mem_ctx);
    if (nir == NULL)
@@ -274,7 +278,7 @@ vk_pipeline_hash_shader_stage_blake3(VkPipelineCreateFlags2KHR pipeline_flags,
    if (module) {
       _mesa_blake3_update(&ctx, module->hash, sizeof(module->hash));
    } else if (minfo) {
-      _mesa_blake3_update(&ctx, minfo->pCode, minfo->codeSize);
+      _mesa_blake3_update_parallel(&ctx, minfo->pCode, minfo->codeSize);
    } else {
       /* It is legal to pass in arbitrary identifiers as long as they don't exceed
        * the limit. Shaders with bogus identifiers are more or less guaranteed to fail. */
@@ -32,6 +32,7 @@
 #include "compiler/nir/nir_serialize.h"
 
 #include "util/blob.h"
+#include "util/log.h"
 #include "util/u_debug.h"
 #include "util/disk_cache.h"
 #include "util/hash_table.h"
@@ -143,35 +144,60 @@ object_key_hash(const void *void_object)
    return _mesa_hash_data(object->key_data, object->key_size);
 }
 
+DEBUG_GET_ONCE_BOOL_OPTION(pipeline_cache_stats, "VK_PIPELINE_CACHE_STATS", false)
+DEBUG_GET_ONCE_BOOL_OPTION(pipeline_cache_lazy_import, "VK_PIPELINE_CACHE_LAZY_IMPORT", true)
+
+static inline bool
+vk_pipeline_cache_has_objects(const struct vk_pipeline_cache *cache)
+{
+   return cache->shards[0].objects != NULL;
+}
+
+static inline struct vk_pipeline_cache_shard *
+vk_pipeline_cache_get_shard(struct vk_pipeline_cache *cache, uint32_t hash)
+{
+   /* Take the top bits, so that the shard index doesn't correlate with the
+    * slot that the set picks for the same hash.
+    */
+   return &cache->shards[(hash >> 24) % VK_PIPELINE_CACHE_SHARD_COUNT];
+}
+
 static void
-vk_pipeline_cache_lock(struct vk_pipeline_cache *cache)
+vk_pipeline_cache_lock(struct vk_pipeline_cache *cache,
+                       struct vk_pipeline_cache_shard *shard)
 {
+   if (cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT)
+      return;
 
-   if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_lock(&cache->lock);
+   if (!simple_mtx_trylock(&shard->lock)) {
+      p_atomic_inc(&cache->lock_contention);
+      simple_mtx_lock(&shard->lock);
+   }
 }
 
 static void
-vk_pipeline_cache_unlock(struct vk_pipeline_cache *cache)
+vk_pipeline_cache_unlock(struct vk_pipeline_cache *cache,
+                         struct vk_pipeline_cache_shard *shard)
 {
    if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_unlock(&cache->lock);
+      simple_mtx_unlock(&shard->lock);
 }
 
-/* cache->lock must be held when calling */
+/* shard->lock must be held when calling */
 static void
 vk_pipeline_cache_remove_object(struct vk_pipeline_cache *cache,
+                                struct vk_pipeline_cache_shard *shard,
                                 uint32_t hash,
                                 struct vk_pipeline_cache_object *object)
 {
    struct set_entry *entry =
-      _mesa_set_search_pre_hashed(cache->object_cache, hash, object);
+      _mesa_set_search_pre_hashed(shard->objects, hash, object);
    if (entry && entry->key == (const void *)object) {
       /* Drop the reference owned by the cache */
       if (!cache->weak_ref)
          vk_pipeline_cache_object_unref(cache->base.device, object);
 
-      _mesa_set_remove(cache->object_cache, entry);
+      _mesa_set_remove(shard->objects, entry);
    }
 }
 
@@ -194,13 +220,15 @@ vk_pipeline_cache_object_unref(struct vk_device *device, struct vk_pipeline_cach
       if (p_atomic_dec_zero(&object->ref_cnt))
          object->ops->destroy(device, object);
    } else {
-      vk_pipeline_cache_lock(weak_owner);
+      uint32_t hash = object_key_hash(object);
+      struct vk_pipeline_cache_shard *shard =
+         vk_pipeline_cache_get_shard(weak_owner, hash);
+
+      vk_pipeline_cache_lock(weak_owner, shard);
       bool destroy = p_atomic_dec_zero(&object->ref_cnt);
-      if (destroy) {
-         uint32_t hash = object_key_hash(object);
-         vk_pipeline_cache_remove_object(weak_owner, hash, object);
-      }
-      vk_pipeline_cache_unlock(weak_owner);
+      if (destroy)
+         vk_pipeline_cache_remove_object(weak_owner, shard, hash, object);
+      vk_pipeline_cache_unlock(weak_owner, shard);
       if (destroy)
          object->ops->destroy(device, object);
    }
@@ -293,15 +321,17 @@ vk_pipeline_cache_insert_object(struct vk_pipeline_cache *cache,
 {
    assert(object->ops != NULL);
 
-   if (cache->object_cache == NULL)
+   if (!vk_pipeline_cache_has_objects(cache))
       return object;
 
    uint32_t hash = object_key_hash(object);
+   struct vk_pipeline_cache_shard *shard =
+      vk_pipeline_cache_get_shard(cache, hash);
 
-   vk_pipeline_cache_lock(cache);
+   vk_pipeline_cache_lock(cache, shard);
    bool found = false;
    struct set_entry *entry = _mesa_set_search_or_add_pre_hashed(
-       cache->object_cache, hash, object, &found);
+       shard->objects, hash, object, &found);
 
    struct vk_pipeline_cache_object *result = NULL;
    /* add reference to either the found or inserted object */
@@ -324,7 +354,7 @@ vk_pipeline_cache_insert_object(struct vk_pipeline_cache *cache,
       else
          vk_pipeline_cache_object_weak_ref(cache, result);
    }
-   vk_pipeline_cache_unlock(cache);
+   vk_pipeline_cache_unlock(cache, shard);
 
    if (found) {
       vk_pipeline_cache_object_unref(cache->base.device, object);
@@ -352,21 +382,25 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
 
    struct vk_pipeline_cache_object *object = NULL;
 
-   if (cache != NULL && cache->object_cache != NULL) {
-      vk_pipeline_cache_lock(cache);
+   if (cache != NULL && vk_pipeline_cache_has_objects(cache)) {
+      struct vk_pipeline_cache_shard *shard =
+         vk_pipeline_cache_get_shard(cache, hash);
+
+      vk_pipeline_cache_lock(cache, shard);
       struct set_entry *entry =
-         _mesa_set_search_pre_hashed(cache->object_cache, hash, &key);
+         _mesa_set_search_pre_hashed(shard->objects, hash, &key);
       if (entry) {
          object = vk_pipeline_cache_object_ref((void *)entry->key);
          if (cache_hit != NULL)
             *cache_hit = true;
       }
-      vk_pipeline_cache_unlock(cache);
+      vk_pipeline_cache_unlock(cache, shard);
    }
 
    if (object == NULL) {
       struct disk_cache *disk_cache = get_disk_cache(cache);
-      if (!cache->skip_disk_cache && disk_cache && cache->object_cache) {
+      if (!cache->skip_disk_cache && disk_cache &&
+          vk_pipeline_cache_has_objects(cache)) {
          cache_key cache_key;
          disk_cache_compute_key(disk_cache, key_data, key_size, cache_key);
 
@@ -406,9 +440,11 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
          vk_pipeline_cache_log(cache,
                                "Deserializing pipeline cache object failed");
 
-         vk_pipeline_cache_lock(cache);
-         vk_pipeline_cache_remove_object(cache, hash, object);
-         vk_pipeline_cache_unlock(cache);
+         struct vk_pipeline_cache_shard *shard =
+            vk_pipeline_cache_get_shard(cache, hash);
+         vk_pipeline_cache_lock(cache, shard);
+         vk_pipeline_cache_remove_object(cache, shard, hash, object);
+         vk_pipeline_cache_unlock(cache, shard);
          vk_pipeline_cache_object_unref(cache->base.device, object);
          return NULL;
       }
@@ -507,6 +543,31 @@ vk_pipeline_cache_lookup_nir(struct vk_pipeline_cache *cache,
    return nir;
 }
 
+bool
+vk_pipeline_cache_lookup_nir_info(struct vk_pipeline_cache *cache,
+                                  const void *key_data, size_t key_size,
+                                  struct shader_info *info,
+                                  bool *cache_hit, void *mem_ctx)
+{
+   struct vk_pipeline_cache_object *object =
+      vk_pipeline_cache_lookup_object(cache, key_data, key_size,
+                                      &vk_raw_data_cache_object_ops,
+                                      cache_hit);
+   if (object == NULL)
+      return false;
+
+   struct vk_raw_data_cache_object *data_obj =
+      container_of(object, struct vk_raw_data_cache_object, base);
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, data_obj->data, data_obj->data_size);
+
+   bool found = nir_deserialize_info(mem_ctx, &blob, info);
+   vk_pipeline_cache_object_unref(cache->base.device, object);
+
+   return found;
+}
+
 void
 vk_pipeline_cache_add_nir(struct vk_pipeline_cache *cache,
                           const void *key_data, size_t key_size,
@@ -584,6 +645,16 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
    if (memcmp(&header, &cache->header, sizeof(header)) != 0)
       return;
 
+   /* Deserializing every object up front can take a long time for a big
+    * cache, while an application typically only looks up a part of it.  So
+    * only copy the data into raw objects here.  A lookup with the real ops
+    * deserializes the object on its first hit and replaces the raw object in
+    * the cache, see vk_pipeline_cache_lookup_object().
+    *
+    * Weak reference mode caches don't support this kind of replacement.
+    */
+   const bool lazy = !cache->weak_ref && debug_get_option_pipeline_cache_lazy_import();
+
    for (uint32_t i = 0; i < count; i++) {
       int32_t type = blob_read_uint32(&blob);
       uint32_t key_size = blob_read_uint32(&blob);
@@ -594,7 +665,8 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
       if (blob.overrun)
          break;
 
-      const struct vk_pipeline_cache_object_ops *ops =
+      const struct vk_pipeline_cache_object_ops *ops = lazy && data_size > 0 ?
+         &vk_raw_data_cache_object_ops :
          find_ops_for_type(cache->base.device->physical, type);
 
       struct vk_pipeline_cache_object *object =
@@ -651,15 +723,23 @@ vk_pipeline_cache_create(struct vk_device *device,
    };
    memcpy(cache->header.uuid, pdevice_props.pipelineCacheUUID, VK_UUID_SIZE);
 
-   simple_mtx_init(&cache->lock, mtx_plain);
+   for (unsigned i = 0; i < VK_PIPELINE_CACHE_SHARD_COUNT; i++)
+      simple_mtx_init(&cache->shards[i].lock, mtx_plain);
 
    if (info->force_enable ||
        debug_get_bool_option("VK_ENABLE_PIPELINE_CACHE", true)) {
-      cache->object_cache = _mesa_set_create(NULL, object_key_hash,
-                                             object_keys_equal);
+      for (unsigned i = 0; i < VK_PIPELINE_CACHE_SHARD_COUNT; i++) {
+         cache->shards[i].objects = _mesa_set_create(NULL, object_key_hash,
+                                                     object_keys_equal);
+         if (cache->shards[i].objects == NULL) {
+            vk_pipeline_cache_destroy(cache, pAllocator);
+            return NULL;
+         }
+      }
    }
 
-   if (cache->object_cache && pCreateInfo->initialDataSize > 0) {
+   if (vk_pipeline_cache_has_objects(cache) &&
+       pCreateInfo->initialDataSize > 0) {
       vk_pipeline_cache_load(cache, pCreateInfo->pInitialData,
                              pCreateInfo->initialDataSize);
    }
@@ -671,17 +751,26 @@ void
 vk_pipeline_cache_destroy(struct vk_pipeline_cache *cache,
                           const VkAllocationCallbacks *pAllocator)
 {
-   if (cache->object_cache) {
-      if (!cache->weak_ref) {
-         set_foreach(cache->object_cache, entry) {
-            vk_pipeline_cache_object_unref(cache->base.device, (void *)entry->key);
+   if (vk_pipeline_cache_has_objects(cache) && debug_get_option_pipeline_cache_stats()) {
+      mesa_logi("pipeline cache %p: %u contended shard locks",
+                (void *)cache, cache->lock_contention);
+   }
+
+   for (unsigned i = 0; i < VK_PIPELINE_CACHE_SHARD_COUNT; i++) {
+      struct vk_pipeline_cache_shard *shard = &cache->shards[i];
+
+      if (shard->objects) {
+         if (!cache->weak_ref) {
+            set_foreach(shard->objects, entry) {
+               vk_pipeline_cache_object_unref(cache->base.device, (void *)entry->key);
+            }
+         } else {
+            assert(shard->objects->entries == 0);
          }
-      } else {
-         assert(cache->object_cache->entries == 0);
+         _mesa_set_destroy(shard->objects, NULL);
       }
-      _mesa_set_destroy(cache->object_cache, NULL);
+      simple_mtx_destroy(&shard->lock);
    }
-   simple_mtx_destroy(&cache->lock);
    vk_object_free(cache->base.device, pAllocator, cache);
 }
 
@@ -747,11 +836,17 @@ vk_common_GetPipelineCacheData(VkDevice _device,
       return VK_INCOMPLETE;
    }
 
-   vk_pipeline_cache_lock(cache);
-
    VkResult result = VK_SUCCESS;
-   if (cache->object_cache != NULL) {
-      set_foreach(cache->object_cache, entry) {
+   for (unsigned i = 0; i < VK_PIPELINE_CACHE_SHARD_COUNT &&
+                        result == VK_SUCCESS; i++) {
+      struct vk_pipeline_cache_shard *shard = &cache->shards[i];
+
+      if (shard->objects == NULL)
+         break;
+
+      vk_pipeline_cache_lock(cache, shard);
+
+      set_foreach(shard->objects, entry) {
          struct vk_pipeline_cache_object *object = (void *)entry->key;
 
          if (object->ops->serialize == NULL)
@@ -791,9 +886,9 @@ vk_common_GetPipelineCacheData(VkDevice _device,
 
          count++;
       }
-   }
 
-   vk_pipeline_cache_unlock(cache);
+      vk_pipeline_cache_unlock(cache, shard);
+   }
 
    blob_overwrite_uint32(&blob, count_offset, count);
 
@@ -804,6 +899,37 @@ vk_common_GetPipelineCacheData(VkDevice _device,
    return result;
 }
 
+/* Both shard locks must be held when calling */
+static void
+vk_pipeline_cache_merge_shard(struct vk_device *device,
+                              struct vk_pipeline_cache_shard *dst,
+                              struct vk_pipeline_cache_shard *src)
+{
+   set_foreach(src->objects, src_entry) {
+      struct vk_pipeline_cache_object *src_object = (void *)src_entry->key;
+
+      bool found_in_dst = false;
+      struct set_entry *dst_entry =
+         _mesa_set_search_or_add_pre_hashed(dst->objects, src_entry->hash,
+                                            src_object, &found_in_dst);
+      if (found_in_dst) {
+         struct vk_pipeline_cache_object *dst_object = (void *)dst_entry->key;
+         if (dst_object->ops == &vk_raw_data_cache_object_ops &&
+             src_object->ops != &vk_raw_data_cache_object_ops) {
+            /* Even though dst has the object, it only has the blob version
+             * which isn't as useful.  Replace it with the real object.
+             */
+            vk_pipeline_cache_object_unref(device, dst_object);
+            dst_entry->key = vk_pipeline_cache_object_ref(src_object);
+         }
+      } else {
+         /* We inserted src_object in dst so it needs a reference */
+         assert(dst_entry->key == (const void *)src_object);
+         vk_pipeline_cache_object_ref(src_object);
+      }
+   }
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 vk_common_MergePipelineCaches(VkDevice _device,
                               VkPipelineCache dstCache,
@@ -815,53 +941,37 @@ vk_common_MergePipelineCaches(VkDevice _device,
    assert(dst->base.device == device);
    assert(!dst->weak_ref);
 
-   if (!dst->object_cache)
+   if (!vk_pipeline_cache_has_objects(dst))
       return VK_SUCCESS;
 
-   vk_pipeline_cache_lock(dst);
+   /* An object is in the shard with the same index in every cache, so the
+    * shards can be merged one at a time.
+    */
+   for (unsigned s = 0; s < VK_PIPELINE_CACHE_SHARD_COUNT; s++) {
+      struct vk_pipeline_cache_shard *dst_shard = &dst->shards[s];
 
-   for (uint32_t i = 0; i < srcCacheCount; i++) {
-      VK_FROM_HANDLE(vk_pipeline_cache, src, pSrcCaches[i]);
-      assert(src->base.device == device);
+      vk_pipeline_cache_lock(dst, dst_shard);
 
-      if (!src->object_cache)
-         continue;
+      for (uint32_t i = 0; i < srcCacheCount; i++) {
+         VK_FROM_HANDLE(vk_pipeline_cache, src, pSrcCaches[i]);
+         assert(src->base.device == device);
 
-      assert(src != dst);
-      if (src == dst)
-         continue;
+         if (!vk_pipeline_cache_has_objects(src))
+            continue;
 
-      vk_pipeline_cache_lock(src);
-
-      set_foreach(src->object_cache, src_entry) {
-         struct vk_pipeline_cache_object *src_object = (void *)src_entry->key;
-
-         bool found_in_dst = false;
-         struct set_entry *dst_entry =
-            _mesa_set_search_or_add_pre_hashed(dst->object_cache,
-                                               src_entry->hash,
-                                               src_object, &found_in_dst);
-         if (found_in_dst) {
-            struct vk_pipeline_cache_object *dst_object = (void *)dst_entry->key;
-            if (dst_object->ops == &vk_raw_data_cache_object_ops &&
-                src_object->ops != &vk_raw_data_cache_object_ops) {
-               /* Even though dst has the object, it only has the blob version
-                * which isn't as useful.  Replace it with the real object.
-                */
-               vk_pipeline_cache_object_unref(device, dst_object);
-               dst_entry->key = vk_pipeline_cache_object_ref(src_object);
-            }
-         } else {
-            /* We inserted src_object in dst so it needs a reference */
-            assert(dst_entry->key == (const void *)src_object);
-            vk_pipeline_cache_object_ref(src_object);
-         }
+         assert(src != dst);
+         if (src == dst)
+            continue;
+
+         struct vk_pipeline_cache_shard *src_shard = &src->shards[s];
+
+         vk_pipeline_cache_lock(src, src_shard);
+         vk_pipeline_cache_merge_shard(device, dst_shard, src_shard);
+         vk_pipeline_cache_unlock(src, src_shard);
       }
 
-      vk_pipeline_cache_unlock(src);
+      vk_pipeline_cache_unlock(dst, dst_shard);
    }
 
-   vk_pipeline_cache_unlock(dst);
-
    return VK_SUCCESS;
 }
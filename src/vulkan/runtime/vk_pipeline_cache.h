@@ -43,11 +43,17 @@ struct set;
 struct nir_shader;
 struct nir_shader_compiler_options;
 
+/* #include "compiler/shader_info.h" */
+struct shader_info;
+
 struct vk_pipeline_cache;
 struct vk_pipeline_cache_object;
 
 #define VK_PIPELINE_CACHE_BLOB_ALIGN 8
 
+/** Number of independently locked parts of the object table */
+#define VK_PIPELINE_CACHE_SHARD_COUNT 16
+
 struct vk_pipeline_cache_object_ops {
    /** Writes this cache object to the given blob
     *
@@ -147,6 +153,18 @@ void
 vk_pipeline_cache_object_unref(struct vk_device *device,
                                struct vk_pipeline_cache_object *object);
 
+/** One part of the object table of a vk_pipeline_cache
+ *
+ * Objects are assigned to a shard by their key hash, so that threads looking
+ * up or adding different objects rarely wait for each other.
+ */
+struct vk_pipeline_cache_shard {
+   /** Protects objects */
+   simple_mtx_t lock;
+
+   struct set *objects;
+};
+
 /** A generic implementation of VkPipelineCache */
 struct vk_pipeline_cache {
    struct vk_object_base base;
@@ -159,10 +177,13 @@ struct vk_pipeline_cache {
 
    struct vk_pipeline_cache_header header;
 
-   /** Protects object_cache */
-   simple_mtx_t lock;
+   /** The object table, NULL sets if the cache is disabled */
+   struct vk_pipeline_cache_shard shards[VK_PIPELINE_CACHE_SHARD_COUNT];
 
-   struct set *object_cache;
+   /** Number of times a shard lock was already held by another thread,
+    * reported on destruction with VK_PIPELINE_CACHE_STATS=true
+    */
+   uint32_t lock_contention;
 };
 
 VK_DEFINE_NONDISP_HANDLE_CASTS(vk_pipeline_cache, base, VkPipelineCache,
@@ -287,6 +308,15 @@ vk_pipeline_cache_lookup_nir(struct vk_pipeline_cache *cache,
                              const void *key_data, size_t key_size,
                              const struct nir_shader_compiler_options *nir_options,
                              bool *cache_hit, void *mem_ctx);
+
+/** Looks up a NIR shader added with vk_pipeline_cache_add_nir() but only
+ * reads its shader_info, without deserializing the shader itself.
+ */
+bool
+vk_pipeline_cache_lookup_nir_info(struct vk_pipeline_cache *cache,
+                                  const void *key_data, size_t key_size,
+                                  struct shader_info *info,
+                                  bool *cache_hit, void *mem_ctx);
 void
 vk_pipeline_cache_add_nir(struct vk_pipeline_cache *cache,
                           const void *key_data, size_t key_size,
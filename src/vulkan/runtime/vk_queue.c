@@ -705,6 +705,55 @@ done:
    return result;
 }
 
+/* Upper bound on how many queued submits are combined into one driver
+ * submit, which bounds the cost of the repeated merge copies.
+ */
+#define VK_QUEUE_MAX_COALESCED_SUBMITS 32
+
+/* Merges the submits which follow the first one in the queue into it, so the
+ * driver can handle several vkQueueSubmit calls with one kernel submission.
+ * Returns the new first submit.
+ *
+ * queue->submit.mutex must be held when calling.
+ */
+static struct vk_queue_submit *
+vk_queue_coalesce_submits(struct vk_queue *queue)
+{
+   struct vk_queue_submit *submit =
+      list_first_entry(&queue->submit.submits, struct vk_queue_submit, link);
+
+   for (unsigned i = 1; i < VK_QUEUE_MAX_COALESCED_SUBMITS; i++) {
+      if (submit->link.next == &queue->submit.submits)
+         break;
+
+      struct vk_queue_submit *next =
+         list_entry(submit->link.next, struct vk_queue_submit, link);
+
+      /* The merged submit waits for everything before executing any of its
+       * work.  If the next submit has waits of its own, that could hold back
+       * work which is ready, so leave it for the next round.
+       */
+      if (next->wait_count > 0)
+         break;
+
+      list_del(&next->link);
+      list_del(&submit->link);
+
+      struct vk_queue_submit *merged =
+         vk_queue_submits_merge(queue, submit, next);
+      if (merged == NULL) {
+         list_add(&next->link, &queue->submit.submits);
+         list_add(&submit->link, &queue->submit.submits);
+         break;
+      }
+
+      list_add(&merged->link, &queue->submit.submits);
+      submit = merged;
+   }
+
+   return submit;
+}
+
 static int
 vk_queue_submit_thread_func(void *_data)
 {
@@ -724,9 +773,7 @@ vk_queue_submit_thread_func(void *_data)
          continue;
       }
 
-      struct vk_queue_submit *submit =
-         list_first_entry(&queue->submit.submits,
-                          struct vk_queue_submit, link);
+      struct vk_queue_submit *submit = vk_queue_coalesce_submits(queue);
 
       /* Drop the lock while we wait */
       mtx_unlock(&queue->submit.mutex);
@@ -57,6 +57,7 @@ static const struct debug_control debug_control[] = {
    { "linear",       WSI_DEBUG_LINEAR },
    { "dxgi",         WSI_DEBUG_DXGI },
    { "nowlts",       WSI_DEBUG_NOWLTS },
+   { "nodamage",     WSI_DEBUG_NODAMAGE },
    { NULL, },
 };
 
@@ -494,9 +495,11 @@ wsi_swapchain_init(const struct wsi_device *wsi,
       if (!chain->cmd_pools)
          return VK_ERROR_OUT_OF_HOST_MEMORY;
 
+      /* The damage blits are re-recorded at present time */
       const VkCommandPoolCreateFlags cmd_pool_flags =
-         (pCreateInfo->flags & VK_SWAPCHAIN_CREATE_PROTECTED_BIT_KHR) ?
-         VK_COMMAND_POOL_CREATE_PROTECTED_BIT : 0;
+         VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
+         ((pCreateInfo->flags & VK_SWAPCHAIN_CREATE_PROTECTED_BIT_KHR) ?
+          VK_COMMAND_POOL_CREATE_PROTECTED_BIT : 0);
       for (uint32_t i = 0; i < cmd_pools_count; i++) {
          int queue_family_index = i;
 
@@ -846,8 +849,13 @@ wsi_destroy_image(const struct wsi_swapchain *chain,
             continue;
          wsi->FreeCommandBuffers(chain->device, chain->cmd_pools[i],
                                  1, &image->blit.cmd_buffers[i]);
+         if (image->blit.damage_cmd_buffers) {
+            wsi->FreeCommandBuffers(chain->device, chain->cmd_pools[i],
+                                    1, &image->blit.damage_cmd_buffers[i]);
+         }
       }
       vk_free(&chain->alloc, image->blit.cmd_buffers);
+      vk_free(&chain->alloc, image->blit.damage_cmd_buffers);
    }
 
    wsi->FreeMemory(chain->device, image->memory, &chain->alloc);
@@ -1442,6 +1450,12 @@ wsi_image_signal_info_add_fence(struct wsi_image_signal_info *info,
    info->fences[info->fence_count++] = fence;
 }
 
+static VkCommandBuffer
+wsi_swapchain_get_blit_cmd_buffer(struct wsi_swapchain *chain,
+                                  struct wsi_image *image,
+                                  uint32_t pool_idx,
+                                  const VkPresentRegionKHR *region);
+
 VkResult
 wsi_common_queue_present(const struct wsi_device *wsi,
                          struct vk_queue *queue,
@@ -1451,6 +1465,8 @@ wsi_common_queue_present(const struct wsi_device *wsi,
    uint32_t current_frame = p_atomic_fetch_add(&dev->current_frame, 1);
    VkResult final_result = handle_trace(queue, dev, current_frame);
 
+   MESA_TRACE_FRAME_MARK();
+
    STACK_ARRAY(VkResult, results, pPresentInfo->swapchainCount);
    for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++)
       results[i] = VK_SUCCESS;
@@ -1485,6 +1501,35 @@ wsi_common_queue_present(const struct wsi_device *wsi,
       }
    }
 
+   const VkPresentRegionsKHR *regions =
+      vk_find_struct_const(pPresentInfo->pNext, PRESENT_REGIONS_KHR);
+
+   /* Pick the blit command buffers.  The throttle wait above guarantees that
+    * the previous blit of each image is done, so its damage blit can be
+    * re-recorded.
+    */
+   STACK_ARRAY(VkCommandBuffer, blit_cmd_buffers, pPresentInfo->swapchainCount);
+   for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++) {
+      VK_FROM_HANDLE(wsi_swapchain, swapchain, pPresentInfo->pSwapchains[i]);
+      uint32_t image_index = pPresentInfo->pImageIndices[i];
+      struct wsi_image *image =
+         swapchain->get_wsi_image(swapchain, image_index);
+
+      blit_cmd_buffers[i] = VK_NULL_HANDLE;
+      if (results[i] != VK_SUCCESS ||
+          swapchain->blit.type == WSI_SWAPCHAIN_NO_BLIT)
+         continue;
+
+      const VkPresentRegionKHR *region = NULL;
+      if (regions && regions->pRegions)
+         region = &regions->pRegions[i];
+
+      uint32_t pool_idx =
+         swapchain->blit.queue != NULL ? 0 : queue->queue_family_index;
+      blit_cmd_buffers[i] =
+         wsi_swapchain_get_blit_cmd_buffer(swapchain, image, pool_idx, region);
+   }
+
    /* Gather up all the semaphores we need to wait on */
    STACK_ARRAY(VkSemaphoreSubmitInfo, semaphore_wait_infos,
                pPresentInfo->waitSemaphoreCount);
@@ -1609,8 +1654,6 @@ wsi_common_queue_present(const struct wsi_device *wsi,
       for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++) {
          VK_FROM_HANDLE(wsi_swapchain, swapchain, pPresentInfo->pSwapchains[i]);
          uint32_t image_index = pPresentInfo->pImageIndices[i];
-         struct wsi_image *image =
-            swapchain->get_wsi_image(swapchain, image_index);
 
          if (results[i] != VK_SUCCESS)
             continue;
@@ -1646,8 +1689,7 @@ wsi_common_queue_present(const struct wsi_device *wsi,
          if (swapchain->blit.type != WSI_SWAPCHAIN_NO_BLIT) {
             blit_command_buffer_infos[blit_count++] = (VkCommandBufferSubmitInfo) {
                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-               .commandBuffer =
-                  image->blit.cmd_buffers[queue->queue_family_index],
+               .commandBuffer = blit_cmd_buffers[i],
             };
          }
 
@@ -1687,8 +1729,6 @@ wsi_common_queue_present(const struct wsi_device *wsi,
    for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++) {
       VK_FROM_HANDLE(wsi_swapchain, swapchain, pPresentInfo->pSwapchains[i]);
       uint32_t image_index = pPresentInfo->pImageIndices[i];
-      struct wsi_image *image =
-         swapchain->get_wsi_image(swapchain, image_index);
 
       if (results[i] != VK_SUCCESS)
          continue;
@@ -1705,7 +1745,7 @@ wsi_common_queue_present(const struct wsi_device *wsi,
 
       const VkCommandBufferSubmitInfo blit_command_buffer_info = {
          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-         .commandBuffer = image->blit.cmd_buffers[0],
+         .commandBuffer = blit_cmd_buffers[i],
       };
 
       const VkSubmitInfo2 submit_info = {
@@ -1724,8 +1764,6 @@ wsi_common_queue_present(const struct wsi_device *wsi,
    }
 
    /* Finally, we can present */
-   const VkPresentRegionsKHR *regions =
-      vk_find_struct_const(pPresentInfo->pNext, PRESENT_REGIONS_KHR);
    const VkSwapchainPresentModeInfoKHR *present_mode_info =
       vk_find_struct_const(pPresentInfo->pNext, SWAPCHAIN_PRESENT_MODE_INFO_KHR);
 
@@ -1799,6 +1837,7 @@ wsi_common_queue_present(const struct wsi_device *wsi,
 
    STACK_ARRAY_FINISH(image_signal_infos);
    STACK_ARRAY_FINISH(semaphore_wait_infos);
+   STACK_ARRAY_FINISH(blit_cmd_buffers);
    STACK_ARRAY_FINISH(results);
 
    return final_result;
@@ -2103,12 +2142,14 @@ wsi_label_cmd_buffer(const struct wsi_device *wsi, VkDevice device, VkCommandBuf
    wsi->SetDebugUtilsObjectNameEXT(device, &name_info);
 }
 
+/* Records the blit of rect, or of the whole image if rect is NULL */
 static void
 wsi_cmd_blit_image_to_buffer(VkCommandBuffer cmd_buffer,
                              const struct wsi_device *wsi,
                              const struct wsi_image_info *info,
                              struct wsi_image *image,
-                             uint32_t qfi)
+                             uint32_t qfi,
+                             const VkRect2D *rect)
 {
    assert(info->image_type == WSI_IMAGE_TYPE_CPU ||
           info->image_type == WSI_IMAGE_TYPE_DRM);
@@ -2139,10 +2180,10 @@ wsi_cmd_blit_image_to_buffer(VkCommandBuffer cmd_buffer,
                            0, NULL,
                            1, &img_mem_barrier);
 
+   const uint32_t block_size = vk_format_get_blocksize(info->create.format);
    struct VkBufferImageCopy buffer_image_copy = {
       .bufferOffset = 0,
-      .bufferRowLength = info->linear_stride /
-                         vk_format_get_blocksize(info->create.format),
+      .bufferRowLength = info->linear_stride / block_size,
       .bufferImageHeight = 0,
       .imageSubresource = {
          .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -2153,11 +2194,25 @@ wsi_cmd_blit_image_to_buffer(VkCommandBuffer cmd_buffer,
       .imageOffset = { .x = 0, .y = 0, .z = 0 },
       .imageExtent = info->create.extent,
    };
-   wsi->CmdCopyImageToBuffer(cmd_buffer,
-                             image->image,
-                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                             image->blit.buffer,
-                             1, &buffer_image_copy);
+   if (rect != NULL) {
+      /* The buffer is addressed relative to the copied region */
+      buffer_image_copy.bufferOffset =
+         (VkDeviceSize)rect->offset.y * info->linear_stride +
+         (VkDeviceSize)rect->offset.x * block_size;
+      buffer_image_copy.imageOffset.x = rect->offset.x;
+      buffer_image_copy.imageOffset.y = rect->offset.y;
+      buffer_image_copy.imageExtent.width = rect->extent.width;
+      buffer_image_copy.imageExtent.height = rect->extent.height;
+   }
+
+   if (buffer_image_copy.imageExtent.width > 0 &&
+       buffer_image_copy.imageExtent.height > 0) {
+      wsi->CmdCopyImageToBuffer(cmd_buffer,
+                                image->image,
+                                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                image->blit.buffer,
+                                1, &buffer_image_copy);
+   }
 
    img_mem_barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
    img_mem_barrier.dstAccessMask = 0;
@@ -2299,6 +2354,15 @@ wsi_finish_create_blit_context(const struct wsi_swapchain *chain,
    if (!image->blit.cmd_buffers)
       return VK_ERROR_OUT_OF_HOST_MEMORY;
 
+   if (chain->blit.type == WSI_SWAPCHAIN_BUFFER_BLIT) {
+      image->blit.damage_cmd_buffers =
+         vk_zalloc(&chain->alloc,
+                   sizeof(VkCommandBuffer) * cmd_buffer_count, 8,
+                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (!image->blit.damage_cmd_buffers)
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
    for (uint32_t i = 0; i < cmd_buffer_count; i++) {
       if (!chain->cmd_pools[i])
          continue;
@@ -2329,7 +2393,8 @@ wsi_finish_create_blit_context(const struct wsi_swapchain *chain,
       case WSI_SWAPCHAIN_BUFFER_BLIT: {
          wsi_cmd_blit_image_to_buffer(
             cmd_buffer, wsi, info, image,
-            chain->blit.queue ? chain->blit.queue->queue_family_index : i);
+            chain->blit.queue ? chain->blit.queue->queue_family_index : i,
+            NULL);
          break;
       }
       case WSI_SWAPCHAIN_IMAGE_BLIT:
@@ -2342,11 +2407,152 @@ wsi_finish_create_blit_context(const struct wsi_swapchain *chain,
       result = wsi->EndCommandBuffer(cmd_buffer);
       if (result != VK_SUCCESS)
          return result;
+
+      if (image->blit.damage_cmd_buffers) {
+         result = wsi->AllocateCommandBuffers(chain->device, &cmd_buffer_info,
+                                              &image->blit.damage_cmd_buffers[i]);
+         if (result != VK_SUCCESS)
+            return result;
+
+         wsi_label_cmd_buffer(wsi, chain->device,
+                              image->blit.damage_cmd_buffers[i],
+                              "wsi damage blit");
+      }
    }
 
    return VK_SUCCESS;
 }
 
+/* Returns the bounding box of the damage of a present, clamped to the
+ * image.  Without rectangles, the whole image is damaged.
+ */
+static VkRect2D
+wsi_present_region_bounding_box(const VkExtent3D *extent,
+                                const VkPresentRegionKHR *region)
+{
+   if (region == NULL || region->rectangleCount == 0 ||
+       region->pRectangles == NULL) {
+      return (VkRect2D) {
+         .extent = { extent->width, extent->height },
+      };
+   }
+
+   int64_t x0 = INT64_MAX, y0 = INT64_MAX, x1 = 0, y1 = 0;
+   for (uint32_t i = 0; i < region->rectangleCount; i++) {
+      const VkRectLayerKHR *rect = &region->pRectangles[i];
+      if (rect->extent.width == 0 || rect->extent.height == 0)
+         continue;
+
+      x0 = MIN2(x0, rect->offset.x);
+      y0 = MIN2(y0, rect->offset.y);
+      x1 = MAX2(x1, (int64_t)rect->offset.x + rect->extent.width);
+      y1 = MAX2(y1, (int64_t)rect->offset.y + rect->extent.height);
+   }
+
+   x0 = CLAMP(x0, 0, extent->width);
+   y0 = CLAMP(y0, 0, extent->height);
+   x1 = CLAMP(x1, 0, extent->width);
+   y1 = CLAMP(y1, 0, extent->height);
+   if (x1 <= x0 || y1 <= y0)
+      return (VkRect2D) { 0 };
+
+   return (VkRect2D) {
+      .offset = { x0, y0 },
+      .extent = { x1 - x0, y1 - y0 },
+   };
+}
+
+static VkRect2D
+wsi_rect_union(VkRect2D a, VkRect2D b)
+{
+   if (a.extent.width == 0 || a.extent.height == 0)
+      return b;
+   if (b.extent.width == 0 || b.extent.height == 0)
+      return a;
+
+   int32_t x0 = MIN2(a.offset.x, b.offset.x);
+   int32_t y0 = MIN2(a.offset.y, b.offset.y);
+   int32_t x1 = MAX2(a.offset.x + (int32_t)a.extent.width,
+                     b.offset.x + (int32_t)b.extent.width);
+   int32_t y1 = MAX2(a.offset.y + (int32_t)a.extent.height,
+                     b.offset.y + (int32_t)b.extent.height);
+
+   return (VkRect2D) {
+      .offset = { x0, y0 },
+      .extent = { x1 - x0, y1 - y0 },
+   };
+}
+
+/* Returns the number of presents since the blit destination of the image
+ * was written, counting the present in flight, or 0 if it never was.
+ */
+static uint64_t
+wsi_image_get_buffer_age(const struct wsi_swapchain *chain,
+                         const struct wsi_image *image)
+{
+   if (image->present_serial == 0)
+      return 0;
+
+   return chain->present_serial + 1 - image->present_serial;
+}
+
+/* Returns the command buffer blitting the image for the present in flight.
+ *
+ * The blit destination of a buffer blit still holds the image as it was
+ * presented buffer-age presents ago.  If the application provided damage
+ * rectangles for all of the presents since, only their bounding box has to
+ * be copied.
+ */
+static VkCommandBuffer
+wsi_swapchain_get_blit_cmd_buffer(struct wsi_swapchain *chain,
+                                  struct wsi_image *image,
+                                  uint32_t pool_idx,
+                                  const VkPresentRegionKHR *region)
+{
+   const struct wsi_device *wsi = chain->wsi;
+   const VkExtent3D *extent = &chain->image_info.create.extent;
+   const uint64_t serial = chain->present_serial + 1;
+   VkCommandBuffer full_cmd_buffer = image->blit.cmd_buffers[pool_idx];
+
+   chain->blit.damage[serial % WSI_DAMAGE_HISTORY] =
+      wsi_present_region_bounding_box(extent, region);
+
+   if (image->blit.damage_cmd_buffers == NULL ||
+       (WSI_DEBUG & WSI_DEBUG_NODAMAGE))
+      return full_cmd_buffer;
+
+   const uint64_t age = wsi_image_get_buffer_age(chain, image);
+   if (age == 0 || age > WSI_DAMAGE_HISTORY)
+      return full_cmd_buffer;
+
+   VkRect2D damage = { 0 };
+   for (uint64_t s = serial - age + 1; s <= serial; s++)
+      damage = wsi_rect_union(damage, chain->blit.damage[s % WSI_DAMAGE_HISTORY]);
+
+   if (damage.extent.width == extent->width &&
+       damage.extent.height == extent->height)
+      return full_cmd_buffer;
+
+   VkCommandBuffer cmd_buffer = image->blit.damage_cmd_buffers[pool_idx];
+   const VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+   };
+   if (wsi->BeginCommandBuffer(cmd_buffer, &begin_info) != VK_SUCCESS)
+      return full_cmd_buffer;
+
+   wsi_cmd_blit_image_to_buffer(cmd_buffer, wsi, &chain->image_info, image,
+                                chain->blit.queue ?
+                                chain->blit.queue->queue_family_index :
+                                pool_idx,
+                                &damage);
+
+   if (wsi->EndCommandBuffer(cmd_buffer) != VK_SUCCESS)
+      return full_cmd_buffer;
+
+   return cmd_buffer;
+}
+
 void
 wsi_configure_buffer_image(UNUSED const struct wsi_swapchain *chain,
                            const VkSwapchainCreateInfoKHR *pCreateInfo,
@@ -41,6 +41,7 @@ struct wsi_swapchain;
 #define WSI_DEBUG_LINEAR      (1ull << 3)
 #define WSI_DEBUG_DXGI        (1ull << 4)
 #define WSI_DEBUG_NOWLTS      (1ull << 5)
+#define WSI_DEBUG_NODAMAGE    (1ull << 6)
 
 extern uint64_t WSI_DEBUG;
 
@@ -155,6 +156,11 @@ enum wsi_swapchain_blit_type {
    WSI_SWAPCHAIN_IMAGE_BLIT,
 };
 
+/* Number of presents for which swapchains with buffer blits remember the
+ * damage.  Images with an older blit destination are blitted in full.
+ */
+#define WSI_DAMAGE_HISTORY 8
+
 struct wsi_image {
    VkImage image;
    VkDeviceMemory memory;
@@ -164,6 +170,11 @@ struct wsi_image {
       VkImage image;
       VkDeviceMemory memory;
       VkCommandBuffer *cmd_buffers;
+      /* Buffer blits which only copy the area damaged since the blit
+       * destination was last written.  They are re-recorded by the presents
+       * which use them.
+       */
+      VkCommandBuffer *damage_cmd_buffers;
       /* Whether the backing memory of the blit dst buffer is shared directly
        * with the compositor instead of being mapped via vkMapMemory locally.
        */
@@ -235,6 +246,12 @@ struct wsi_swapchain {
        * buffer blit instead of using the present queue.
        */
       struct vk_queue *queue;
+
+      /* Bounding box of the VK_KHR_incremental_present damage of the last
+       * presents, indexed by present_serial % WSI_DAMAGE_HISTORY.  Presents
+       * without damage rectangles damage the whole image.
+       */
+      VkRect2D damage[WSI_DAMAGE_HISTORY];
    } blit;
 
    bool capture_key_pressed;